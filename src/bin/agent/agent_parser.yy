@@ -56,6 +56,7 @@ using namespace std;
   CONTROL_AGENT "Control-agent"
   HTTP_HOST "http-host"
   HTTP_PORT "http-port"
+  HTTP_THREADS "http-threads"
 
   USER_CONTEXT "user-context"
   COMMENT "comment"
@@ -291,6 +292,7 @@ global_params: global_param
 // Dhcp6.
 global_param: http_host
             | http_port
+            | http_threads
             | trust_anchor
             | cert_file
             | key_file
@@ -319,6 +321,12 @@ http_port: HTTP_PORT COLON INTEGER {
     ctx.stack_.back()->set("http-port", prf);
 };
 
+http_threads: HTTP_THREADS COLON INTEGER {
+    ctx.unique("http-threads", ctx.loc2pos(@1));
+    ElementPtr threads(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("http-threads", threads);
+};
+
 trust_anchor: TRUST_ANCHOR {
     ctx.unique("trust-anchor", ctx.loc2pos(@1));
     ctx.enter(ctx.NO_KEYWORDS);
@@ -23,13 +23,14 @@ namespace isc {
 namespace agent {
 
 CtrlAgentCfgContext::CtrlAgentCfgContext()
-    : http_host_(""), http_port_(0),
+    : http_host_(""), http_port_(0), http_threads_(0),
       trust_anchor_(""), cert_file_(""), key_file_(""), cert_required_(true) {
 }
 
 CtrlAgentCfgContext::CtrlAgentCfgContext(const CtrlAgentCfgContext& orig)
     : ConfigBase(), ctrl_sockets_(orig.ctrl_sockets_),
       http_host_(orig.http_host_), http_port_(orig.http_port_),
+      http_threads_(orig.http_threads_),
       trust_anchor_(orig.trust_anchor_), cert_file_(orig.cert_file_),
       key_file_(orig.key_file_), cert_required_(orig.cert_required_),
       hooks_config_(orig.hooks_config_), auth_config_(orig.auth_config_) {
@@ -51,6 +52,9 @@ CtrlAgentCfgMgr::getConfigSummary(const uint32_t /*selection*/) {
     std::ostringstream s;
     s << "listening on " << ctx->getHttpHost() << ", port "
       << ctx->getHttpPort();
+    if (ctx->getHttpThreads() > 0) {
+        s << ", " << ctx->getHttpThreads() << " thread(s)";
+    }
 
     // When TLS is setup print its config.
     if (!ctx->getTrustAnchor().empty()) {
@@ -186,6 +190,8 @@ CtrlAgentCfgContext::toElement() const {
     ca->set("http-host", Element::create(http_host_));
     // Set http-port
     ca->set("http-port", Element::create(static_cast<int64_t>(http_port_)));
+    // Set http-threads
+    ca->set("http-threads", Element::create(static_cast<int64_t>(http_threads_)));
     // Set TLS setup when enabled
     if (!trust_anchor_.empty()) {
         ca->set("trust-anchor", Element::create(trust_anchor_));
@@ -99,6 +99,22 @@ public:
         return (http_port_);
     }
 
+    /// @brief Sets http-threads parameter
+    ///
+    /// @param threads Number of threads handling the HTTP requests, 0
+    /// to handle them in the main thread.
+    void setHttpThreads(const uint16_t threads) {
+        http_threads_ = threads;
+    }
+
+    /// @brief Returns http-threads parameter
+    ///
+    /// @return Number of threads handling the HTTP requests, 0 when
+    /// they are handled in the main thread.
+    uint16_t getHttpThreads() const {
+        return (http_threads_);
+    }
+
     /// @brief Sets HTTP authentication configuration.
     ///
     /// @note Only the basic HTTP authentication is supported.
@@ -225,6 +241,9 @@ private:
     /// TCP port the CA should listen on.
     uint16_t http_port_;
 
+    /// Number of threads handling the HTTP requests.
+    uint16_t http_threads_;
+
     /// Trust anchor aka Certificate Authority (can be a file name or
     /// a directory path).
     std::string trust_anchor_;
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -20,7 +20,10 @@
 #include <config/client_connection.h>
 #include <config/timeouts.h>
 #include <boost/pointer_cast.hpp>
+#include <functional>
 #include <iterator>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -31,6 +34,34 @@ using namespace isc::data;
 using namespace isc::hooks;
 using namespace isc::process;
 
+namespace {
+
+/// @brief Connections to the servers kept open by a thread.
+///
+/// Each thread forwarding commands has its own IO service and keeps one
+/// connection open per control socket, so a connection is never used by
+/// two threads at the same time.
+struct ForwardingConnections {
+    /// @brief Constructor.
+    ForwardingConnections() : io_service_(new IOService()), connections_() {
+    }
+
+    /// @brief IO service driving the connections of the thread.
+    IOServicePtr io_service_;
+
+    /// @brief Connections by control socket name.
+    std::map<std::string, ClientConnectionPtr> connections_;
+};
+
+/// @brief Returns the connections kept open by the current thread.
+ForwardingConnections&
+getForwardingConnections() {
+    static thread_local ForwardingConnections connections;
+    return (connections);
+}
+
+} // end of anonymous namespace
+
 namespace isc {
 namespace agent {
 
@@ -41,7 +72,36 @@ CtrlAgentCommandMgr::instance() {
 }
 
 CtrlAgentCommandMgr::CtrlAgentCommandMgr()
-    : HookedCommandMgr() {
+    : HookedCommandMgr(), mutex_(), owner_() {
+}
+
+CtrlAgentCommandMgr::CommandLock::CommandLock() {
+    CtrlAgentCommandMgr& mgr = CtrlAgentCommandMgr::instance();
+    mgr.mutex_.lock();
+    mgr.owner_ = std::this_thread::get_id();
+}
+
+CtrlAgentCommandMgr::CommandLock::~CommandLock() {
+    CtrlAgentCommandMgr& mgr = CtrlAgentCommandMgr::instance();
+    mgr.owner_ = std::thread::id();
+    mgr.mutex_.unlock();
+}
+
+CtrlAgentCommandMgr::CommandUnlock::CommandUnlock() : unlocked_(false) {
+    CtrlAgentCommandMgr& mgr = CtrlAgentCommandMgr::instance();
+    if (mgr.owner_ == std::this_thread::get_id()) {
+        mgr.owner_ = std::thread::id();
+        mgr.mutex_.unlock();
+        unlocked_ = true;
+    }
+}
+
+CtrlAgentCommandMgr::CommandUnlock::~CommandUnlock() {
+    if (unlocked_) {
+        CtrlAgentCommandMgr& mgr = CtrlAgentCommandMgr::instance();
+        mgr.mutex_.lock();
+        mgr.owner_ = std::this_thread::get_id();
+    }
 }
 
 isc::data::ConstElementPtr
@@ -65,15 +125,16 @@ CtrlAgentCommandMgr::handleCommand(const std::string& cmd_name,
                                    const isc::data::ConstElementPtr& params,
                                    const isc::data::ConstElementPtr& original_cmd) {
 
+    std::string remote_addr;
     ConstElementPtr raddr_ptr = original_cmd->get("remote-address");
     if (raddr_ptr && (raddr_ptr->getType() == Element::string)) {
-        remote_addr_ = raddr_ptr->stringValue();
+        remote_addr = raddr_ptr->stringValue();
     } else {
-        remote_addr_ = "(unknown)";
+        remote_addr = "(unknown)";
     }
     LOG_INFO(agent_logger, CTRL_AGENT_COMMAND_RECEIVED)
         .arg(cmd_name)
-        .arg(remote_addr_);
+        .arg(remote_addr);
 
     ConstElementPtr services = Element::createList();
 
@@ -155,36 +216,140 @@ CtrlAgentCommandMgr::handleCommand(const std::string& cmd_name,
     //  answer list, so let's be safe and re-create the answer_list.
     answer_list = Element::createList();
 
-    // For each value within 'service' we have to try forwarding the command.
-    for (unsigned i = 0; i < services->size(); ++i) {
-        if (original_cmd) {
-            ConstElementPtr answer;
-            try {
-                LOG_DEBUG(agent_logger, isc::log::DBGLVL_COMMAND,
-                          CTRL_AGENT_COMMAND_FORWARD_BEGIN)
-                    .arg(cmd_name).arg(services->get(i)->stringValue());
+    // Forward the command to all servers listed in 'service' at once.
+    if (original_cmd) {
+        answer_list = forwardCommands(services, cmd_name, original_cmd,
+                                      remote_addr);
+    }
 
-                answer = forwardCommand(services->get(i)->stringValue(),
-                                        cmd_name, original_cmd);
+    return (answer_list);
+}
+
+ElementPtr
+CtrlAgentCommandMgr::forwardCommands(const isc::data::ConstElementPtr& services,
+                                     const std::string& cmd_name,
+                                     const isc::data::ConstElementPtr& command,
+                                     const std::string& remote_addr) {
+    // The outcome of forwarding the command to a single service.
+    struct Forwarding {
+        std::string service_;
+        std::string socket_name_;
+        ClientConnectionPtr conn_;
+        bool reused_;
+        boost::system::error_code received_ec_;
+        ConstJSONFeedPtr received_feed_;
+        ConstElementPtr answer_;
+    };
+    std::vector<Forwarding> forwardings(services->size());
+
+    // All connections share the same IO service so the command is sent to
+    // all servers at the same time and the total time is bounded by the
+    // slowest server rather than by the sum of the times of all servers.
+    // The connections are kept open to forward the next commands.
+    ForwardingConnections& pool = getForwardingConnections();
+    IOServicePtr io_service = pool.io_service_;
+
+    // Ask the servers to keep the connections open.
+    ElementPtr forwarded = isc::data::copy(command, 0);
+    forwarded->set(CONTROL_KEEP_ALIVE, Element::create(true));
+    const std::string wire = forwarded->toWire();
+    size_t pending = 0;
+
+    std::function<void(Forwarding&)> send;
+    send = [&send, &wire, &pending](Forwarding& forwarding) {
+        forwarding.conn_->start(ClientConnection::SocketPath(forwarding.socket_name_),
+                                ClientConnection::ControlCommand(wire),
+                                [&send, &forwarding, &pending]
+                                (const boost::system::error_code& ec,
+                                 ConstJSONFeedPtr feed) {
+            // The server may have closed a connection kept open, e.g. when
+            // it was idle for too long or the server was restarted. Send
+            // the command again over a new connection.
+            if (ec && forwarding.reused_ &&
+                (ec.value() != boost::asio::error::timed_out)) {
+                forwarding.reused_ = false;
+                send(forwarding);
+                return;
+            }
+            // Capture error code and parsed data.
+            forwarding.received_ec_ = ec;
+            forwarding.received_feed_ = feed;
+            --pending;
+        }, ClientConnection::Timeout(TIMEOUT_AGENT_FORWARD_COMMAND));
+    };
+
+    // Names of the sockets whose kept open connection is in use.
+    std::set<std::string> used;
+
+    for (size_t i = 0; i < services->size(); ++i) {
+        Forwarding& forwarding = forwardings[i];
+        forwarding.service_ = services->get(i)->stringValue();
+
+        LOG_DEBUG(agent_logger, isc::log::DBGLVL_COMMAND,
+                  CTRL_AGENT_COMMAND_FORWARD_BEGIN)
+            .arg(cmd_name).arg(forwarding.service_);
+
+        try {
+            forwarding.socket_name_ = getSocketName(forwarding.service_);
+
+        } catch (const CommandForwardingError& ex) {
+            LOG_DEBUG(agent_logger, isc::log::DBGLVL_COMMAND,
+                      CTRL_AGENT_COMMAND_FORWARD_FAILED)
+                .arg(cmd_name).arg(ex.what());
+            forwarding.answer_ = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+            continue;
+        }
+
+        // A service listed twice gets a connection of its own.
+        if (used.insert(forwarding.socket_name_).second) {
+            ClientConnectionPtr& conn = pool.connections_[forwarding.socket_name_];
+            if (!conn) {
+                conn.reset(new ClientConnection(*io_service, true));
+            }
+            forwarding.conn_ = conn;
+        } else {
+            forwarding.conn_.reset(new ClientConnection(*io_service));
+        }
+        forwarding.reused_ = forwarding.conn_->isOpen();
+        ++pending;
+        send(forwarding);
+    }
+
+    if (pending > 0) {
+        // Let the other requests be handled while waiting for the servers.
+        CommandUnlock unlock;
+        while (pending > 0) {
+            io_service->run_one();
+        }
+        // Invoke the handlers of the cancelled timers.
+        io_service->poll();
+    }
+
+    ElementPtr answer_list = Element::createList();
+    for (auto& forwarding : forwardings) {
+        if (!forwarding.answer_) {
+            try {
+                forwarding.answer_ = parseForwardedAnswer(forwarding.service_,
+                                                          cmd_name,
+                                                          forwarding.received_ec_,
+                                                          forwarding.received_feed_,
+                                                          remote_addr);
 
             } catch (const CommandForwardingError& ex) {
                 LOG_DEBUG(agent_logger, isc::log::DBGLVL_COMMAND,
                           CTRL_AGENT_COMMAND_FORWARD_FAILED)
                     .arg(cmd_name).arg(ex.what());
-                answer = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+                forwarding.answer_ = createAnswer(CONTROL_RESULT_ERROR, ex.what());
             }
-
-            answer_list->add(boost::const_pointer_cast<Element>(answer));
         }
+        answer_list->add(boost::const_pointer_cast<Element>(forwarding.answer_));
     }
 
     return (answer_list);
 }
 
-ConstElementPtr
-CtrlAgentCommandMgr::forwardCommand(const std::string& service,
-                                    const std::string& cmd_name,
-                                    const isc::data::ConstElementPtr& command) {
+std::string
+CtrlAgentCommandMgr::getSocketName(const std::string& service) const {
     // Context will hold the server configuration.
     CtrlAgentCfgContextPtr ctx;
 
@@ -222,26 +387,15 @@ CtrlAgentCommandMgr::forwardCommand(const std::string& service,
 
     // If the configuration does its job properly the socket-name must be
     // specified and must be a string value.
-    std::string socket_name = socket_info->get("socket-name")->stringValue();
-
-    // Forward command and receive reply.
-    IOServicePtr io_service(new IOService());;
-    ClientConnection conn(*io_service);
-    boost::system::error_code received_ec;
-    ConstJSONFeedPtr received_feed;
-    conn.start(ClientConnection::SocketPath(socket_name),
-               ClientConnection::ControlCommand(command->toWire()),
-               [&io_service, &received_ec, &received_feed]
-               (const boost::system::error_code& ec, ConstJSONFeedPtr feed) {
-                   // Capture error code and parsed data.
-                   received_ec = ec;
-                   received_feed = feed;
-                   // Got the IO service so stop IO service. This causes to
-                   // stop IO service when all handlers have been invoked.
-                   io_service->stopWork();
-               }, ClientConnection::Timeout(TIMEOUT_AGENT_FORWARD_COMMAND));
-    io_service->run();
+    return (socket_info->get("socket-name")->stringValue());
+}
 
+ConstElementPtr
+CtrlAgentCommandMgr::parseForwardedAnswer(const std::string& service,
+                                          const std::string& cmd_name,
+                                          const boost::system::error_code& received_ec,
+                                          const ConstJSONFeedPtr& received_feed,
+                                          const std::string& remote_addr) const {
     if (received_ec) {
         isc_throw(CommandForwardingError, "unable to forward command to the "
                   << service << " service: " << received_ec.message()
@@ -263,7 +417,7 @@ CtrlAgentCommandMgr::forwardCommand(const std::string& service,
         LOG_INFO(agent_logger, CTRL_AGENT_COMMAND_FORWARDED)
             .arg(cmd_name)
             .arg(service)
-            .arg(remote_addr_);
+            .arg(remote_addr);
 
     } catch (const std::exception& ex) {
         isc_throw(CommandForwardingError, "internal server error: unable to parse"
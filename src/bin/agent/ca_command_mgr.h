@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,10 +7,15 @@
 #ifndef CTRL_AGENT_COMMAND_MGR_H
 #define CTRL_AGENT_COMMAND_MGR_H
 
+#include <cc/json_feed.h>
 #include <config/hooked_command_mgr.h>
 #include <exceptions/exceptions.h>
 #include <boost/noncopyable.hpp>
+#include <boost/system/error_code.hpp>
 #include <boost/shared_ptr.hpp>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace isc {
 namespace agent {
@@ -34,6 +39,12 @@ public:
 /// are registered using @c CtrlAgentCommandMgr::instance().registerCommand().
 /// The @ref CtrlAgentResponseCreator uses the sole instance of the Command
 /// Manager to handle incoming commands.
+///
+/// The HTTP listener may handle the requests in several threads. The
+/// hooked command manager, the hook callouts and the configuration are not
+/// thread safe so they are accessed with the @ref CommandLock held. The
+/// lock is released while a command is forwarded to the servers, so the
+/// requests forwarded to the servers are processed in parallel.
 class CtrlAgentCommandMgr : public config::HookedCommandMgr,
                             public boost::noncopyable {
 public:
@@ -41,6 +52,25 @@ public:
     /// @brief Returns sole instance of the Command Manager.
     static CtrlAgentCommandMgr& instance();
 
+    /// @brief RAII lock serializing the handling of commands.
+    ///
+    /// It is taken by the HTTP response creator for the whole handling
+    /// of a request and by the main thread before it changes the
+    /// configuration or the listeners.
+    class CommandLock : public boost::noncopyable {
+    public:
+
+        /// @brief Constructor.
+        ///
+        /// Locks the mutex of the Command Manager.
+        CommandLock();
+
+        /// @brief Destructor.
+        ///
+        /// Unlocks the mutex of the Command Manager.
+        ~CommandLock();
+    };
+
     /// @brief Triggers command processing.
     ///
     /// This method overrides the @c BaseCommandMgr::processCommand to ensure
@@ -88,18 +118,78 @@ public:
 
 private:
 
-    /// @brief Tries to forward received control command to a specified server.
+    /// @brief Forwards received control command to the specified servers.
+    ///
+    /// The command is sent to all the servers concurrently, over distinct
+    /// unix domain socket connections driven by a common IO service, so
+    /// forwarding a command to several servers takes about as long as
+    /// forwarding it to the slowest of them. An error forwarding the command
+    /// to a server does not affect the other servers.
     ///
-    /// @param service Contains name of the service where the command should be
-    /// forwarded.
+    /// The command asks the servers to keep the connections open, and each
+    /// thread keeps one connection open per control socket to forward the
+    /// next commands. When a server has closed a connection kept open, the
+    /// command is sent again over a new connection.
+    ///
+    /// The @ref CommandLock held by the calling thread is released while
+    /// waiting for the responses.
+    ///
+    /// @param services List of names of the services where the command
+    /// should be forwarded.
     /// @param cmd_name Command name.
     /// @param command Pointer to the object representing the forwarded command.
+    /// @param remote_addr Remote address of the HTTP endpoint.
+    ///
+    /// @return List of responses to the forwarded command, in the order of
+    /// the services. The error responses are built for the servers to which
+    /// the command could not be forwarded.
+    isc::data::ElementPtr
+    forwardCommands(const isc::data::ConstElementPtr& services,
+                    const std::string& cmd_name,
+                    const isc::data::ConstElementPtr& command,
+                    const std::string& remote_addr);
+
+    /// @brief Returns the name of the control socket of a server.
+    ///
+    /// @param service Name of the service.
+    /// @return Name of the unix domain socket.
+    /// @throw CommandForwardingError when the socket is not configured.
+    std::string getSocketName(const std::string& service) const;
+
+    /// @brief Returns the response to a command forwarded to a server.
+    ///
+    /// @param service Name of the service where the command was forwarded.
+    /// @param cmd_name Command name.
+    /// @param received_ec Error code of the transaction.
+    /// @param received_feed Feed holding the response.
+    /// @param remote_addr Remote address of the HTTP endpoint.
     ///
     /// @return Response to forwarded command.
     /// @throw CommandForwardingError when an error occurred during forwarding.
     isc::data::ConstElementPtr
-    forwardCommand(const std::string& service, const std::string& cmd_name,
-                   const isc::data::ConstElementPtr& command);
+    parseForwardedAnswer(const std::string& service, const std::string& cmd_name,
+                         const boost::system::error_code& received_ec,
+                         const config::ConstJSONFeedPtr& received_feed,
+                         const std::string& remote_addr) const;
+
+    /// @brief RAII object releasing the @ref CommandLock.
+    ///
+    /// The lock is released only when it is held by the current thread,
+    /// and taken again by the destructor.
+    class CommandUnlock : public boost::noncopyable {
+    public:
+
+        /// @brief Constructor.
+        CommandUnlock();
+
+        /// @brief Destructor.
+        ~CommandUnlock();
+
+    private:
+
+        /// @brief True when the lock was released.
+        bool unlocked_;
+    };
 
     /// @brief Private constructor.
     ///
@@ -107,8 +197,11 @@ private:
     /// thus the constructor is private.
     CtrlAgentCommandMgr();
 
-    /// @brief Remote address of HTTP endpoint.
-    std::string remote_addr_;
+    /// @brief Mutex serializing the handling of commands.
+    std::mutex mutex_;
+
+    /// @brief Thread holding the mutex.
+    std::atomic<std::thread::id> owner_;
 
 };
 
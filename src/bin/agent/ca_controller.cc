@@ -94,6 +94,12 @@ CtrlAgentController::deregisterCommands() {
     CtrlAgentCommandMgr::instance().deregisterCommand(VERSION_GET_COMMAND);
 }
 
+void
+CtrlAgentController::processSignal(int signum) {
+    CtrlAgentCommandMgr::CommandLock lock;
+    DControllerBase::processSignal(signum);
+}
+
 CtrlAgentController::CtrlAgentController()
     : DControllerBase(agent_app_name_, agent_bin_name_) {
 }
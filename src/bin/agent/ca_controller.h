@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -57,6 +57,17 @@ public:
     /// @brief Deregister commands.
     void deregisterCommands();
 
+protected:
+
+    /// @brief Application-level signal processing method.
+    ///
+    /// Processes the signal with the @ref CtrlAgentCommandMgr::CommandLock
+    /// held, so the configuration is not reloaded while a request is
+    /// handled by one of the HTTP listener threads.
+    ///
+    /// @param signum signal number to process.
+    virtual void processSignal(int signum);
+
 private:
 
     /// @brief Creates an instance of the Control Agent application
@@ -7,6 +7,7 @@
 #include <config.h>
 #include <asiolink/asio_wrapper.h>
 #include <agent/ca_process.h>
+#include <agent/ca_command_mgr.h>
 #include <agent/ca_controller.h>
 #include <agent/ca_response_creator_factory.h>
 #include <agent/ca_log.h>
@@ -33,6 +34,12 @@ CtrlAgentProcess::CtrlAgentProcess(const char* name,
 }
 
 CtrlAgentProcess::~CtrlAgentProcess() {
+    // Stop the listener threads before the listeners are destroyed.
+    for (auto const& listener : http_listeners_) {
+        if (listener.thread_pool_) {
+            listener.thread_pool_->stop();
+        }
+    }
 }
 
 void
@@ -48,7 +55,11 @@ CtrlAgentProcess::run() {
         CtrlAgentControllerPtr controller =
             boost::dynamic_pointer_cast<CtrlAgentController>(
                 CtrlAgentController::instance());
-        controller->registerCommands();
+        {
+            // The commands may already be received by the listener threads.
+            CtrlAgentCommandMgr::CommandLock lock;
+            controller->registerCommands();
+        }
 
         // Let's process incoming data or expiring timers in a loop until
         // shutdown condition is detected.
@@ -98,6 +109,9 @@ CtrlAgentProcess::runIO() {
 isc::data::ConstElementPtr
 CtrlAgentProcess::shutdown(isc::data::ConstElementPtr /*args*/) {
     setShutdownFlag(true);
+    // Wake up the main loop when the command was received by a listener
+    // thread.
+    getIoService()->post([]() {});
     return (isc::config::createAnswer(CONTROL_RESULT_SUCCESS,
                                       "Control Agent is shutting down"));
 }
@@ -137,12 +151,13 @@ CtrlAgentProcess::configure(isc::data::ConstElementPtr config_set,
         }
 
         uint16_t server_port = ctx->getHttpPort();
+        uint16_t http_threads = ctx->getHttpThreads();
         bool use_https = false;
 
         // Only open a new listener if the configuration has changed.
         if (http_listeners_.empty() ||
-            (http_listeners_.back()->getLocalAddress() != server_address) ||
-            (http_listeners_.back()->getLocalPort() != server_port)) {
+            (http_listeners_.back().http_listener_->getLocalAddress() != server_address) ||
+            (http_listeners_.back().http_listener_->getLocalPort() != server_port)) {
             // Create a TLS context.
             TlsContextPtr tls_context;
             // When TLS is enabled configure it.
@@ -161,22 +176,41 @@ CtrlAgentProcess::configure(isc::data::ConstElementPtr config_set,
             // used to generate answer to specific request.
             HttpResponseCreatorFactoryPtr rcf(new CtrlAgentResponseCreatorFactory());
 
+            // A multi-threaded listener runs on its own IO service.
+            IOServicePtr io_service = getIoService();
+            if (http_threads > 0) {
+                io_service.reset(new IOService());
+            }
+
             // Create http listener. It will open up a TCP socket and be
             // prepared to accept incoming connection.
-            HttpListenerPtr http_listener
-                (new HttpListener(*getIoService(), server_address,
+            Listener listener;
+            listener.http_listener_.reset
+                (new HttpListener(*io_service, server_address,
                                   server_port, tls_context, rcf,
                                   HttpListener::RequestTimeout(TIMEOUT_AGENT_RECEIVE_COMMAND),
                                   HttpListener::IdleTimeout(TIMEOUT_AGENT_IDLE_CONNECTION_TIMEOUT)));
 
             // Instruct the http listener to actually open socket, install
             // callback and start listening.
-            http_listener->start();
+            listener.http_listener_->start();
+
+            // Start the threads running the listener.
+            if (http_threads > 0) {
+                listener.thread_pool_.reset(new IoServiceThreadPool(io_service,
+                                                                    http_threads));
+            }
 
             // The new listener is running so add it to the collection of
             // active listeners. The next step will be to remove all other
             // active listeners, but we do it inside the main process loop.
-            http_listeners_.push_back(http_listener);
+            http_listeners_.push_back(listener);
+
+            // Wake up the main loop when the configuration was received by
+            // a listener thread.
+            if (http_listeners_.size() > 1) {
+                getIoService()->post([]() {});
+            }
         }
 
         // Ok, seems we're good to go.
@@ -198,21 +232,40 @@ void
 CtrlAgentProcess::garbageCollectListeners(size_t leaving) {
     // We expect only one active listener. If there are more (most likely 2),
     // it means we have just reconfigured the server and need to shut down all
-    // listeners except the most recently added.
-    if (http_listeners_.size() > leaving) {
-        // Stop no longer used listeners.
-        for (auto l = http_listeners_.begin();
-             l != http_listeners_.end() - leaving;
-             ++l) {
-            (*l)->stop();
+    // listeners except the most recently added. The listeners are added by
+    // a new configuration, which may be received by a listener thread.
+    std::vector<Listener> listeners;
+    {
+        CtrlAgentCommandMgr::CommandLock lock;
+        if (http_listeners_.size() > leaving) {
+            listeners.assign(http_listeners_.begin(),
+                             http_listeners_.end() - leaving);
+            http_listeners_.erase(http_listeners_.begin(),
+                                  http_listeners_.end() - leaving);
         }
-        // We have stopped listeners but there may be some pending handlers
-        // related to these listeners. Need to invoke these handlers.
-        getIoService()->get_io_service().poll();
-        // Finally, we're ready to remove no longer used listeners.
-        http_listeners_.erase(http_listeners_.begin(),
-                              http_listeners_.end() - leaving);
     }
+    if (listeners.empty()) {
+        return;
+    }
+
+    // Stop no longer used listeners. The threads of a listener are stopped
+    // first, without the lock which they may wait for.
+    for (auto const& listener : listeners) {
+        if (listener.thread_pool_) {
+            listener.thread_pool_->stop();
+        }
+        listener.http_listener_->stop();
+        if (listener.thread_pool_) {
+            // Invoke the pending handlers of the listener.
+            IOServicePtr io_service = listener.thread_pool_->getIOService();
+            io_service->restart();
+            io_service->poll();
+        }
+    }
+
+    // We have stopped listeners but there may be some pending handlers
+    // related to these listeners. Need to invoke these handlers.
+    getIoService()->get_io_service().poll();
 }
 
 
@@ -223,9 +276,10 @@ CtrlAgentProcess::getCtrlAgentCfgMgr() {
 
 ConstHttpListenerPtr
 CtrlAgentProcess::getHttpListener() const {
+    CtrlAgentCommandMgr::CommandLock lock;
     // Return the most recent listener or null.
     return (http_listeners_.empty() ? ConstHttpListenerPtr() :
-            http_listeners_.back());
+            http_listeners_.back().http_listener_);
 }
 
 bool
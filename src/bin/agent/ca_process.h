@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define CTRL_AGENT_PROCESS_H
 
 #include <agent/ca_cfg_mgr.h>
+#include <asiolink/io_service_thread_pool.h>
 #include <http/listener.h>
 #include <process/d_process.h>
 #include <vector>
@@ -97,6 +98,12 @@ public:
     /// CtrlAgentProcess::garbageCollectListeners is invoked, which
     /// removes any listeners which are no longer used.
     ///
+    /// When the http-threads parameter is not 0 the new listener runs on
+    /// its own IO service in a pool of http-threads threads. As the
+    /// listener is not replaced when only the other parameters change,
+    /// a new number of threads is applied only with a new listening
+    /// address or port.
+    ///
     /// @param config_set a new configuration (JSON) for the process
     /// @param check_only true if configuration is to be verified only, not applied
     /// @return an Element that contains the results of configuration composed
@@ -131,6 +138,8 @@ private:
     // a result of the reconfiguration). If there are no listeners additional
     /// to the one that is currently in use, the method has no effect.
     /// This method is reused to remove all listeners at shutdown time.
+    /// The threads running a listener are stopped before the listener.
+    /// It must be called by the main thread.
     ///
     /// @param leaving The number of listener to leave (default one).
     void garbageCollectListeners(size_t leaving = 1);
@@ -141,8 +150,18 @@ private:
     /// @return Number of executed handlers.
     size_t runIO();
 
-    /// @brief Holds a list of pointers to the active listeners.
-    std::vector<http::HttpListenerPtr> http_listeners_;
+    /// @brief HTTP listener with the threads running it.
+    struct Listener {
+        /// @brief Pool of threads running the listener, null when the
+        /// listener runs in the main thread.
+        asiolink::IoServiceThreadPoolPtr thread_pool_;
+
+        /// @brief Pointer to the listener.
+        http::HttpListenerPtr http_listener_;
+    };
+
+    /// @brief Holds a list of the active listeners.
+    std::vector<Listener> http_listeners_;
 
 };
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -87,6 +87,11 @@ createStockHttpResponseInternal(const HttpRequestPtr& request,
 HttpResponsePtr
 CtrlAgentResponseCreator::
 createDynamicHttpResponse(HttpRequestPtr request) {
+    // The request may be handled by one of the listener threads: serialize
+    // the accesses to the configuration, the hooks and the commands. The
+    // lock is released while the command is forwarded to the servers.
+    CtrlAgentCommandMgr::CommandLock lock;
+
     // First check authentication.
     HttpResponseJsonPtr http_response;
 
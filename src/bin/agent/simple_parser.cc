@@ -39,6 +39,7 @@ namespace agent {
 const SimpleDefaults AgentSimpleParser::AGENT_DEFAULTS = {
     { "http-host",      Element::string,   "127.0.0.1" },
     { "http-port",      Element::integer,  "8000" },
+    { "http-threads",   Element::integer,  "0" },
     { "trust-anchor",   Element::string,   "" },
     { "cert-file",      Element::string,   "" },
     { "key-file",       Element::string,   "" },
@@ -136,6 +137,7 @@ AgentSimpleParser::parse(const CtrlAgentCfgContextPtr& ctx,
     // Let's get the HTTP parameters first.
     ctx->setHttpHost(SimpleParser::getString(config, "http-host"));
     ctx->setHttpPort(SimpleParser::getIntType<uint16_t>(config, "http-port"));
+    ctx->setHttpThreads(SimpleParser::getIntType<uint16_t>(config, "http-threads"));
 
     // TLS parameter are second.
     ctx->setTrustAnchor(SimpleParser::getString(config, "trust-anchor"));
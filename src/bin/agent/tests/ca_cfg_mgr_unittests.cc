@@ -66,6 +66,10 @@ TEST(CtrlAgentCfgMgr, contextHttpParams) {
 
     ctx.setHttpHost("alnitak");
     EXPECT_EQ("alnitak", ctx.getHttpHost());
+
+    EXPECT_EQ(0, ctx.getHttpThreads());
+    ctx.setHttpThreads(4);
+    EXPECT_EQ(4, ctx.getHttpThreads());
 }
 
 // Tests if context can store and retrieve TLS parameters.
@@ -145,6 +149,7 @@ TEST(CtrlAgentCfgMgr, contextSocketInfoCopy) {
 
     EXPECT_NO_THROW(ctx.setHttpPort(12345));
     EXPECT_NO_THROW(ctx.setHttpHost("bellatrix"));
+    EXPECT_NO_THROW(ctx.setHttpThreads(4));
 
     HooksConfig& libs = ctx.getHooksConfig();
     string exp_name("testlib1.so");
@@ -164,6 +169,7 @@ TEST(CtrlAgentCfgMgr, contextSocketInfoCopy) {
     // Now check the values returned
     EXPECT_EQ(12345, copy->getHttpPort());
     EXPECT_EQ("bellatrix", copy->getHttpHost());
+    EXPECT_EQ(4, copy->getHttpThreads());
 
     // Check socket info
     ASSERT_TRUE(copy->getControlSocketInfo("d2"));
@@ -255,7 +261,8 @@ const char* AGENT_CONFIGS[] = {
 
     // Configuration 1: http parameters only (no control sockets, not hooks)
     "{   \"http-host\": \"betelgeuse\",\n"
-    "    \"http-port\": 8001\n"
+    "    \"http-port\": 8001,\n"
+    "    \"http-threads\": 4\n"
     "}",
 
     // Configuration 2: http and 1 socket
@@ -468,6 +475,7 @@ TEST_F(AgentParserTest, configParseHttpOnly) {
     ASSERT_TRUE(ctx);
     EXPECT_EQ("betelgeuse", ctx->getHttpHost());
     EXPECT_EQ(8001, ctx->getHttpPort());
+    EXPECT_EQ(4, ctx->getHttpThreads());
 }
 
 // Tests if a single socket can be configured. BTW this test also checks
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -19,10 +19,15 @@
 #include <boost/pointer_cast.hpp>
 #include <gtest/gtest.h>
 #include <testutils/sandbox.h>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <vector>
 #include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 using namespace isc::agent;
 using namespace isc::asiolink;
@@ -34,6 +39,83 @@ namespace {
 /// @brief Test timeout in ms.
 const long TEST_TIMEOUT = 10000;
 
+/// @brief Unix domain socket server answering a command after a delay.
+///
+/// The server runs in its own thread, accepts a single connection, reads
+/// the command, waits for the delay and then sends the response.
+class SlowServer {
+public:
+    /// @brief Constructor.
+    ///
+    /// Binds the socket and starts the thread of the server.
+    ///
+    /// @param socket_path Path of the unix domain socket.
+    /// @param delay Delay of the response in milliseconds.
+    SlowServer(const std::string& socket_path, const long delay)
+        : socket_path_(socket_path), delay_(delay), fd_(-1) {
+        static_cast<void>(remove(socket_path_.c_str()));
+        fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd_ < 0) {
+            ADD_FAILURE() << "unable to open the socket";
+            return;
+        }
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+        if ((bind(fd_, reinterpret_cast<struct sockaddr*>(&addr),
+                  sizeof(addr)) < 0) || (listen(fd_, 1) < 0)) {
+            ADD_FAILURE() << "unable to bind the socket " << socket_path_;
+            return;
+        }
+        thread_ = std::thread(std::bind(&SlowServer::run, this));
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Wakes up and waits for the thread of the server.
+    ~SlowServer() {
+        if (fd_ >= 0) {
+            static_cast<void>(shutdown(fd_, SHUT_RDWR));
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (fd_ >= 0) {
+            static_cast<void>(close(fd_));
+        }
+        static_cast<void>(remove(socket_path_.c_str()));
+    }
+
+private:
+    /// @brief Answers the command received over a single connection.
+    void run() {
+        int conn = accept(fd_, 0, 0);
+        if (conn < 0) {
+            return;
+        }
+        char buf[1024];
+        if (read(conn, buf, sizeof(buf)) > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_));
+            const std::string response = "{ \"result\": 0 }";
+            static_cast<void>(write(conn, response.c_str(), response.size()));
+        }
+        static_cast<void>(close(conn));
+    }
+
+    /// @brief Path of the unix domain socket.
+    std::string socket_path_;
+
+    /// @brief Delay of the response in milliseconds.
+    long delay_;
+
+    /// @brief Descriptor of the listening socket.
+    int fd_;
+
+    /// @brief Thread of the server.
+    std::thread thread_;
+};
+
 /// @brief Test fixture class for @ref CtrlAgentCommandMgr.
 ///
 /// @todo Add tests for various commands, including the cases when the
@@ -152,14 +234,18 @@ public:
     /// @brief Adds configuration of the control socket.
     ///
     /// @param service Service for which socket configuration is to be added.
+    /// @param socket_path Path of the socket, the socket file path when empty.
     void
-    configureControlSocket(const std::string& service) {
+    configureControlSocket(const std::string& service,
+                           const std::string& socket_path = "") {
         CtrlAgentCfgContextPtr ctx = getCtrlAgentCfgContext();
         ASSERT_TRUE(ctx);
 
         ElementPtr control_socket = Element::createMap();
         control_socket->set("socket-name",
-                            Element::create(unixSocketFilePath()));
+                            Element::create(socket_path.empty() ?
+                                            unixSocketFilePath() :
+                                            socket_path));
         ctx->setControlSocketInfo(control_socket, service);
     }
 
@@ -324,6 +410,67 @@ TEST_F(CtrlAgentCommandMgrTest, forwardToAllServers) {
                 isc::config::CONTROL_RESULT_SUCCESS, 3);
 }
 
+/// Check that a command forwarded to two slow servers takes about as long
+/// as the slowest server takes to respond, not the sum of their times.
+TEST_F(CtrlAgentCommandMgrTest, forwardToSlowServers) {
+    const std::string socket_path4 = unixSocketFilePath() + "4";
+    const std::string socket_path6 = unixSocketFilePath() + "6";
+    configureControlSocket("dhcp4", socket_path4);
+    configureControlSocket("dhcp6", socket_path6);
+
+    ConstElementPtr answer;
+    std::chrono::steady_clock::duration elapsed;
+    {
+        SlowServer server4(socket_path4, 1000);
+        SlowServer server6(socket_path6, 1500);
+
+        ConstElementPtr command = createCommand("foo", "dhcp4,dhcp6");
+        auto start = std::chrono::steady_clock::now();
+        answer = mgr_.processCommand(command);
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    checkAnswer(answer, isc::config::CONTROL_RESULT_SUCCESS,
+                isc::config::CONTROL_RESULT_SUCCESS);
+    long elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    EXPECT_GE(elapsed_ms, 1500);
+    EXPECT_LT(elapsed_ms, 2500);
+}
+
+/// Check that the command lock is released while a command is forwarded,
+/// so another thread may handle a request meanwhile.
+TEST_F(CtrlAgentCommandMgrTest, forwardReleasesCommandLock) {
+    const std::string socket_path = unixSocketFilePath() + "4";
+    configureControlSocket("dhcp4", socket_path);
+
+    ConstElementPtr answer;
+    long locked_ms = 0;
+    {
+        SlowServer server(socket_path, 1000);
+
+        // Forward the command from another thread holding the lock, as
+        // the HTTP response creator does.
+        std::thread forwarder([this, &answer]() {
+            CtrlAgentCommandMgr::CommandLock lock;
+            answer = mgr_.processCommand(createCommand("foo", "dhcp4"));
+        });
+
+        // The lock is available while the server delays its response.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto start = std::chrono::steady_clock::now();
+        {
+            CtrlAgentCommandMgr::CommandLock lock;
+            locked_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                (std::chrono::steady_clock::now() - start).count();
+        }
+        forwarder.join();
+    }
+
+    checkAnswer(answer, isc::config::CONTROL_RESULT_SUCCESS);
+    EXPECT_LT(locked_ms, 500);
+}
+
 /// Check that the command may forwarded to the second server even if
 /// forwarding to a first server fails.
 TEST_F(CtrlAgentCommandMgrTest, failForwardToServer) {
@@ -332,6 +479,17 @@ TEST_F(CtrlAgentCommandMgrTest, failForwardToServer) {
                 isc::config::CONTROL_RESULT_SUCCESS);
 }
 
+/// Check that the responses of the servers to which the command is forwarded
+/// concurrently are returned in the order of the services, even if forwarding
+/// to one of them fails.
+TEST_F(CtrlAgentCommandMgrTest, failForwardToOneOfServers) {
+    configureControlSocket("d2");
+
+    testForward("dhcp4", "dhcp4,dhcp6,d2", isc::config::CONTROL_RESULT_SUCCESS,
+                isc::config::CONTROL_RESULT_ERROR,
+                isc::config::CONTROL_RESULT_SUCCESS, 2);
+}
+
 /// Check that control command is not forwarded if the service is not specified.
 TEST_F(CtrlAgentCommandMgrTest, noService) {
     testForward("dhcp6", "",
@@ -422,4 +580,57 @@ TEST_F(CtrlAgentCommandMgrTest, forwardListCommands) {
     checkAnswer(answer, 3);
 }
 
+// Check that the commands forwarded to a server are sent over a connection
+// kept open, and that a command is sent over a new connection when the
+// server has closed the connection kept open.
+TEST_F(CtrlAgentCommandMgrTest, forwardKeepAlive) {
+    // Configure client side socket.
+    configureControlSocket("dhcp4");
+    // Create server side socket.
+    bindServerSocket("{ \"result\" : 0 }", true);
+
+    // Run the server in a thread.
+    std::thread th(std::bind(&IOService::run, getIOService().get()));
+    server_socket_->waitForRunning();
+
+    // Forward two commands.
+    ConstElementPtr answer0 = mgr_.processCommand(createCommand("foo", "dhcp4"));
+    ConstElementPtr answer1 = mgr_.processCommand(createCommand("foo", "dhcp4"));
+
+    // Stop the server. This closes its end of the connection.
+    getIOService()->stop();
+    th.join();
+    server_socket_->stopServer();
+    getIOService()->get_io_service().reset();
+    getIOService()->poll();
+
+    checkAnswer(answer0, isc::config::CONTROL_RESULT_SUCCESS);
+    checkAnswer(answer1, isc::config::CONTROL_RESULT_SUCCESS);
+
+    // Both commands were sent over the same connection.
+    EXPECT_EQ(2, server_socket_->getResponseNum());
+    EXPECT_EQ(1, server_socket_->getConnectionNum());
+
+    // Start a new server.
+    server_socket_.reset();
+    removeUnixSocketFile();
+    bindServerSocket("{ \"result\" : 0 }", true);
+    std::thread th2(std::bind(&IOService::run, getIOService().get()));
+    server_socket_->waitForRunning();
+
+    // The connection kept open was closed by the previous server so the
+    // command is sent over a new connection.
+    ConstElementPtr answer2 = mgr_.processCommand(createCommand("foo", "dhcp4"));
+
+    getIOService()->stop();
+    th2.join();
+    server_socket_->stopServer();
+    getIOService()->get_io_service().reset();
+    getIOService()->poll();
+
+    checkAnswer(answer2, isc::config::CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(1, server_socket_->getResponseNum());
+    EXPECT_EQ(1, server_socket_->getConnectionNum());
+}
+
 }
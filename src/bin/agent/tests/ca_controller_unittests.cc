@@ -1,4 +1,4 @@
-// Copyright (C) 2016-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,7 +14,10 @@
 #include <cc/command_interpreter.h>
 #include <process/testutils/d_test_stubs.h>
 #include <boost/pointer_cast.hpp>
+#include <arpa/inet.h>
+#include <cstring>
 #include <sstream>
+#include <sys/socket.h>
 #include <unistd.h>
 
 using namespace isc::asiolink::test;
@@ -133,6 +136,56 @@ public:
         }
     }
 
+    /// @brief Sends a command over HTTP and waits for the response.
+    ///
+    /// The request is sent over a blocking socket from the calling thread,
+    /// so the response is received only when the request is handled by
+    /// another thread.
+    ///
+    /// @param port Port of the HTTP listener on the loopback address.
+    /// @param command Command to send.
+    /// @return The received data, empty when nothing was received within
+    /// two seconds.
+    std::string sendHttpCommand(uint16_t port, const std::string& command) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            ADD_FAILURE() << "unable to open the socket";
+            return ("");
+        }
+        struct timeval timeout = { 2, 0 };
+        static_cast<void>(setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO,
+                                     &timeout, sizeof(timeout)));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        std::string received;
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                    sizeof(addr)) < 0) {
+            ADD_FAILURE() << "unable to connect to port " << port;
+        } else {
+            std::ostringstream request;
+            request << "POST / HTTP/1.1\r\n"
+                    << "Content-Type: application/json\r\n"
+                    << "Content-Length: " << command.size() << "\r\n\r\n"
+                    << command;
+            const std::string& wire = request.str();
+            if (write(fd, wire.c_str(), wire.size()) !=
+                static_cast<ssize_t>(wire.size())) {
+                ADD_FAILURE() << "unable to send the request";
+            }
+            char buf[4096];
+            ssize_t len;
+            while ((received.find("\"result\"") == std::string::npos) &&
+                   ((len = read(fd, buf, sizeof(buf))) > 0)) {
+                received.append(buf, len);
+            }
+        }
+        static_cast<void>(close(fd));
+        return (received);
+    }
+
     /// @brief Checks whether specified command is registered
     ///
     /// @param name name of the command to be checked
@@ -330,6 +383,96 @@ TEST_F(CtrlAgentControllerTest, successfulConfigUpdate) {
     EXPECT_FALSE(process->isListening());
 }
 
+// Tests that the requests are handled by the listener threads when
+// http-threads is not 0, while the main thread is busy.
+TEST_F(CtrlAgentControllerTest, multiThreadedListener) {
+    const char* config =
+        "{"
+        "  \"http-host\": \"127.0.0.1\","
+        "  \"http-port\": 8081,"
+        "  \"http-threads\": 2"
+        "}";
+
+    // This check callback is called by the main thread before the shutdown.
+    std::string response;
+    auto check_callback = [&] {
+        CtrlAgentProcessPtr process = getCtrlAgentProcess();
+        ASSERT_TRUE(process);
+        EXPECT_TRUE(process->isListening());
+
+        // The main thread waits for the response so the request must be
+        // handled by a listener thread.
+        response = sendHttpCommand(8081, "{ \"command\": \"version-get\" }");
+    };
+
+    // Start the server.
+    time_duration elapsed_time;
+    runWithConfig(config, 200,
+                  static_cast<const TestCallback&>(check_callback),
+                  elapsed_time);
+
+    EXPECT_NE(std::string::npos, response.find("200 OK")) << response;
+    EXPECT_NE(std::string::npos, response.find("\"result\": 0")) << response;
+
+    CtrlAgentCfgContextPtr ctx = getCtrlAgentCfgContext();
+    ASSERT_TRUE(ctx);
+    EXPECT_EQ(2, ctx->getHttpThreads());
+
+    // After the shutdown the HTTP listener no longer exists.
+    CtrlAgentProcessPtr process = getCtrlAgentProcess();
+    ASSERT_TRUE(process);
+    EXPECT_FALSE(process->isListening());
+}
+
+// Tests that a multi-threaded listener is replaced by a new listener on
+// another port.
+TEST_F(CtrlAgentControllerTest, multiThreadedListenerUpdate) {
+    const char* config =
+        "{"
+        "  \"http-host\": \"127.0.0.1\","
+        "  \"http-port\": 8081,"
+        "  \"http-threads\": 2"
+        "}";
+    const char* second_config =
+        "{"
+        "  \"http-host\": \"127.0.0.1\","
+        "  \"http-port\": 8080,"
+        "  \"http-threads\": 2"
+        "}";
+
+    // This check callback is called before the shutdown.
+    std::string response;
+    auto check_callback = [&] {
+        CtrlAgentProcessPtr process = getCtrlAgentProcess();
+        ASSERT_TRUE(process);
+
+        // The listener should have been reconfigured to use the new port.
+        ConstHttpListenerPtr listener = process->getHttpListener();
+        ASSERT_TRUE(listener);
+        EXPECT_EQ(8080, listener->getLocalPort());
+
+        response = sendHttpCommand(8080, "{ \"command\": \"version-get\" }");
+    };
+
+    // Schedule reconfiguration.
+    scheduleTimedWrite(second_config, 100);
+    // Schedule SIGHUP signal to trigger reconfiguration.
+    TimedSignal sighup(*getIOService(), SIGHUP, 200);
+
+    // Start the server.
+    time_duration elapsed_time;
+    runWithConfig(config, 500,
+                  static_cast<const TestCallback&>(check_callback),
+                  elapsed_time);
+
+    EXPECT_NE(std::string::npos, response.find("\"result\": 0")) << response;
+
+    // After the shutdown the HTTP listener no longer exists.
+    CtrlAgentProcessPtr process = getCtrlAgentProcess();
+    ASSERT_TRUE(process);
+    EXPECT_FALSE(process->isListening());
+}
+
 // Tests that the server continues to use an old configuration when the listener
 // reconfiguration is unsuccessful.
 TEST_F(CtrlAgentControllerTest, unsuccessfulConfigUpdate) {
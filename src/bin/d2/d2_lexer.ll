@@ -233,9 +233,64 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"max-transactions\" {
+    switch(driver.ctx_) {
+    case isc::d2::D2ParserContext::DHCPDDNS:
+        return isc::d2::D2Parser::make_MAX_TRANSACTIONS(driver.loc_);
+    default:
+        return isc::d2::D2Parser::make_STRING("max-transactions", driver.loc_);
+    }
+}
+
+\"thread-pool-size\" {
+    switch(driver.ctx_) {
+    case isc::d2::D2ParserContext::DHCPDDNS:
+        return isc::d2::D2Parser::make_THREAD_POOL_SIZE(driver.loc_);
+    default:
+        return isc::d2::D2Parser::make_STRING("thread-pool-size", driver.loc_);
+    }
+}
+
+\"update-batch-size\" {
+    switch(driver.ctx_) {
+    case isc::d2::D2ParserContext::DHCPDDNS:
+        return isc::d2::D2Parser::make_UPDATE_BATCH_SIZE(driver.loc_);
+    default:
+        return isc::d2::D2Parser::make_STRING("update-batch-size", driver.loc_);
+    }
+}
+
+\"update-batch-delay\" {
+    switch(driver.ctx_) {
+    case isc::d2::D2ParserContext::DHCPDDNS:
+        return isc::d2::D2Parser::make_UPDATE_BATCH_DELAY(driver.loc_);
+    default:
+        return isc::d2::D2Parser::make_STRING("update-batch-delay", driver.loc_);
+    }
+}
+
+\"dns-protocol\" {
+    switch(driver.ctx_) {
+    case isc::d2::D2ParserContext::DHCPDDNS:
+        return isc::d2::D2Parser::make_DNS_PROTOCOL(driver.loc_);
+    default:
+        return isc::d2::D2Parser::make_STRING("dns-protocol", driver.loc_);
+    }
+}
+
+\"dns-persistent-connections\" {
+    switch(driver.ctx_) {
+    case isc::d2::D2ParserContext::DHCPDDNS:
+        return isc::d2::D2Parser::make_DNS_PERSISTENT_CONNECTIONS(driver.loc_);
+    default:
+        return isc::d2::D2Parser::make_STRING("dns-persistent-connections", driver.loc_);
+    }
+}
+
 (?i:\"UDP\") {
     /* dhcp-ddns value keywords are case insensitive */
-    if (driver.ctx_ == isc::d2::D2ParserContext::NCR_PROTOCOL) {
+    if ((driver.ctx_ == isc::d2::D2ParserContext::NCR_PROTOCOL) ||
+        (driver.ctx_ == isc::d2::D2ParserContext::DNS_PROTOCOL)) {
         return isc::d2::D2Parser::make_UDP(driver.loc_);
     }
     std::string tmp(yytext+1);
@@ -245,7 +300,8 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
 
 (?i:\"TCP\") {
     /* dhcp-ddns value keywords are case insensitive */
-    if (driver.ctx_ == isc::d2::D2ParserContext::NCR_PROTOCOL) {
+    if ((driver.ctx_ == isc::d2::D2ParserContext::NCR_PROTOCOL) ||
+        (driver.ctx_ == isc::d2::D2ParserContext::DNS_PROTOCOL)) {
         return isc::d2::D2Parser::make_TCP(driver.loc_);
     }
     std::string tmp(yytext+1);
@@ -263,6 +319,16 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     return isc::d2::D2Parser::make_STRING(tmp, driver.loc_);
 }
 
+(?i:\"BINARY\") {
+    /* dhcp-ddns value keywords are case insensitive */
+    if (driver.ctx_ == isc::d2::D2ParserContext::NCR_FORMAT) {
+        return isc::d2::D2Parser::make_BINARY(driver.loc_);
+    }
+    std::string tmp(yytext+1);
+    tmp.resize(tmp.size() - 1);
+    return isc::d2::D2Parser::make_STRING(tmp, driver.loc_);
+}
+
 \"user-context\" {
     switch(driver.ctx_) {
     case isc::d2::D2ParserContext::DHCPDDNS:
@@ -63,6 +63,13 @@ using namespace std;
   TCP "TCP"
   NCR_FORMAT "ncr-format"
   JSON "JSON"
+  BINARY "BINARY"
+  MAX_TRANSACTIONS "max-transactions"
+  THREAD_POOL_SIZE "thread-pool-size"
+  UPDATE_BATCH_SIZE "update-batch-size"
+  UPDATE_BATCH_DELAY "update-batch-delay"
+  DNS_PROTOCOL "dns-protocol"
+  DNS_PERSISTENT_CONNECTIONS "dns-persistent-connections"
   USER_CONTEXT "user-context"
   COMMENT "comment"
   FORWARD_DDNS "forward-ddns"
@@ -117,6 +124,7 @@ using namespace std;
 %type <ElementPtr> value
 %type <ElementPtr> map_value
 %type <ElementPtr> ncr_protocol_value
+%type <ElementPtr> ncr_format_value
 
 %printer { yyoutput << $$; } <*>;
 
@@ -281,6 +289,12 @@ dhcpddns_param: ip_address
               | dns_server_timeout
               | ncr_protocol
               | ncr_format
+              | max_transactions
+              | thread_pool_size
+              | update_batch_size
+              | update_batch_delay
+              | dns_protocol
+              | dns_persistent_connections
               | forward_ddns
               | reverse_ddns
               | tsig_keys
@@ -336,12 +350,70 @@ ncr_protocol_value:
 ncr_format: NCR_FORMAT {
     ctx.unique("ncr-format", ctx.loc2pos(@1));
     ctx.enter(ctx.NCR_FORMAT);
-} COLON JSON {
-    ElementPtr json(new StringElement("JSON", ctx.loc2pos(@4)));
-    ctx.stack_.back()->set("ncr-format", json);
+} COLON ncr_format_value {
+    ctx.stack_.back()->set("ncr-format", $4);
     ctx.leave();
 };
 
+ncr_format_value:
+    JSON { $$ = ElementPtr(new StringElement("JSON", ctx.loc2pos(@1))); }
+  | BINARY { $$ = ElementPtr(new StringElement("BINARY", ctx.loc2pos(@1))); }
+  ;
+
+max_transactions: MAX_TRANSACTIONS COLON INTEGER {
+    ctx.unique("max-transactions", ctx.loc2pos(@1));
+    if ($3 <= 0) {
+        error(@3, "max-transactions must be greater than zero");
+    } else {
+        ElementPtr i(new IntElement($3, ctx.loc2pos(@3)));
+        ctx.stack_.back()->set("max-transactions", i);
+    }
+};
+
+thread_pool_size: THREAD_POOL_SIZE COLON INTEGER {
+    ctx.unique("thread-pool-size", ctx.loc2pos(@1));
+    if ($3 < 0 || $3 > 256) {
+        error(@3, "thread-pool-size must not be negative or larger than 256");
+    } else {
+        ElementPtr i(new IntElement($3, ctx.loc2pos(@3)));
+        ctx.stack_.back()->set("thread-pool-size", i);
+    }
+};
+
+update_batch_size: UPDATE_BATCH_SIZE COLON INTEGER {
+    ctx.unique("update-batch-size", ctx.loc2pos(@1));
+    if ($3 <= 0) {
+        error(@3, "update-batch-size must be greater than zero");
+    } else {
+        ElementPtr i(new IntElement($3, ctx.loc2pos(@3)));
+        ctx.stack_.back()->set("update-batch-size", i);
+    }
+};
+
+update_batch_delay: UPDATE_BATCH_DELAY COLON INTEGER {
+    ctx.unique("update-batch-delay", ctx.loc2pos(@1));
+    if ($3 < 0) {
+        error(@3, "update-batch-delay must not be negative");
+    } else {
+        ElementPtr i(new IntElement($3, ctx.loc2pos(@3)));
+        ctx.stack_.back()->set("update-batch-delay", i);
+    }
+};
+
+dns_protocol: DNS_PROTOCOL {
+    ctx.unique("dns-protocol", ctx.loc2pos(@1));
+    ctx.enter(ctx.DNS_PROTOCOL);
+} COLON ncr_protocol_value {
+    ctx.stack_.back()->set("dns-protocol", $4);
+    ctx.leave();
+};
+
+dns_persistent_connections: DNS_PERSISTENT_CONNECTIONS COLON BOOLEAN {
+    ctx.unique("dns-persistent-connections", ctx.loc2pos(@1));
+    ElementPtr b(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("dns-persistent-connections", b);
+};
+
 user_context: USER_CONTEXT {
     ctx.enter(ctx.NO_KEYWORD);
 } COLON map_value {
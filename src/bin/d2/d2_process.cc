@@ -16,10 +16,12 @@
 #include <d2srv/d2_tsig_key.h>
 #include <hooks/hooks.h>
 #include <hooks/hooks_manager.h>
+#include <util/multi_threading_mgr.h>
 
 using namespace isc::config;
 using namespace isc::hooks;
 using namespace isc::process;
+using namespace isc::util;
 
 namespace {
 
@@ -242,6 +244,10 @@ D2Process::configure(isc::data::ConstElementPtr config_set, bool check_only) {
         .arg(check_only ? "check" : "update")
         .arg(getD2CfgMgr()->redactConfig(config_set)->str());
 
+    // Transactions run by the IO threads read the configuration, so they
+    // must be paused while it is replaced.
+    MultiThreadingCriticalSection cs;
+
     isc::data::ConstElementPtr answer;
     answer = getCfgMgr()->simpleParseConfig(config_set, check_only,
                 std::bind(&D2Process::reconfigureCommandChannel, this));
@@ -303,6 +309,16 @@ D2Process::configure(isc::data::ConstElementPtr config_set, bool check_only) {
         }
     }
 
+    // Apply the new concurrency settings. The update manager defers the
+    // change until the transactions in progress have finished.
+    D2ParamsPtr params = getD2CfgMgr()->getD2Params();
+    update_mgr_->setConcurrency(params->getMaxTransactions(),
+                                params->getThreadPoolSize());
+    update_mgr_->setDnsTransport(params->getDnsProtocol(),
+                                 params->getDnsPersistentConnections());
+    update_mgr_->setUpdateBatching(params->getUpdateBatchSize(),
+                                   params->getUpdateBatchDelay());
+
     // If we are here, configuration was valid, at least it parsed correctly
     // and therefore contained no invalid values.
     // Return the success answer from above.
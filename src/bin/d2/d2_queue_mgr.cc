@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #include <d2/d2_queue_mgr.h>
 #include <d2srv/d2_log.h>
 #include <dhcp_ddns/ncr_udp.h>
+#include <stats/stats_mgr.h>
 
 namespace isc {
 namespace d2 {
@@ -222,6 +223,8 @@ D2QueueMgr::dequeueAt(const size_t index) {
 
     RequestQueue::iterator pos = ncr_queue_.begin() + index;
     ncr_queue_.erase(pos);
+    updateQueueWaitTime(enqueue_times_.at(index));
+    enqueue_times_.erase(enqueue_times_.begin() + index);
 }
 
 
@@ -233,16 +236,31 @@ D2QueueMgr::dequeue() {
     }
 
     ncr_queue_.pop_front();
+    updateQueueWaitTime(enqueue_times_.front());
+    enqueue_times_.pop_front();
 }
 
 void
 D2QueueMgr::enqueue(dhcp_ddns::NameChangeRequestPtr& ncr) {
     ncr_queue_.push_back(ncr);
+    enqueue_times_.push_back(std::chrono::steady_clock::now());
 }
 
 void
 D2QueueMgr::clearQueue() {
     ncr_queue_.clear();
+    enqueue_times_.clear();
+}
+
+void
+D2QueueMgr::updateQueueWaitTime(const std::chrono::steady_clock::time_point&
+                                enqueue_time) {
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now() - enqueue_time);
+    isc::stats::StatsMgr& stats_mgr = isc::stats::StatsMgr::instance();
+    stats_mgr.addValue("ncr-queue-wait-time",
+                       static_cast<int64_t>(waited.count()));
+    stats_mgr.addValue("ncr-queue-wait-count", static_cast<int64_t>(1));
 }
 
 void
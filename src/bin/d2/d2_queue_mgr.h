@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015,2017,2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2015,2017,2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,7 @@
 #include <dhcp_ddns/ncr_io.h>
 
 #include <boost/noncopyable.hpp>
+#include <chrono>
 #include <deque>
 
 namespace isc {
@@ -293,6 +294,10 @@ public:
 
     /// @brief Removes the entry at a given position in the queue.
     ///
+    /// The time the entry spent in the queue is added to the
+    /// ncr-queue-wait-time statistic and ncr-queue-wait-count is
+    /// incremented.
+    ///
     /// @param index the index of the entry in the queue to remove.
     /// Valid values are 0 (front of the queue) to (queue size - 1).
     ///
@@ -302,6 +307,10 @@ public:
 
     /// @brief Removes the entry at the front of the queue.
     ///
+    /// The time the entry spent in the queue is added to the
+    /// ncr-queue-wait-time statistic and ncr-queue-wait-count is
+    /// incremented.
+    ///
     /// @throw D2QueueMgrQueueEmpty if there are no entries in the queue.
     void dequeue();
 
@@ -320,6 +329,15 @@ public:
     /// state and logs that the manager is stopped.
     void updateStopState();
 
+    /// @brief Records the time a request spent in the queue.
+    ///
+    /// Statistics are cumulative so that the average wait time can be
+    /// computed from ncr-queue-wait-time and ncr-queue-wait-count.
+    ///
+    /// @param enqueue_time time at which the request was queued.
+    void updateQueueWaitTime(const std::chrono::steady_clock::time_point&
+                             enqueue_time);
+
     /// @brief IOService that our listener should use for IO management.
     asiolink::IOServicePtr io_service_;
 
@@ -329,6 +347,11 @@ public:
     /// @brief Queue of received NameChangeRequests.
     RequestQueue ncr_queue_;
 
+    /// @brief Times at which the queued requests were received.
+    ///
+    /// Entries are kept in the same order as the entries of ncr_queue_.
+    std::deque<std::chrono::steady_clock::time_point> enqueue_times_;
+
     /// @brief Listener instance from which requests are received.
     boost::shared_ptr<dhcp_ddns::NameChangeListener> listener_;
 
@@ -11,11 +11,17 @@
 #include <d2/nc_remove.h>
 #include <d2/simple_add.h>
 #include <d2/simple_remove.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/functional/hash.hpp>
 
 #include <sstream>
 #include <iostream>
 #include <vector>
 
+using namespace isc::asiolink;
+using namespace isc::util;
+
 namespace isc {
 namespace d2 {
 
@@ -24,7 +30,12 @@ const size_t D2UpdateMgr::MAX_TRANSACTIONS_DEFAULT;
 D2UpdateMgr::D2UpdateMgr(D2QueueMgrPtr& queue_mgr, D2CfgMgrPtr& cfg_mgr,
                          asiolink::IOServicePtr& io_service,
                          const size_t max_transactions)
-    :queue_mgr_(queue_mgr), cfg_mgr_(cfg_mgr), io_service_(io_service) {
+    :queue_mgr_(queue_mgr), cfg_mgr_(cfg_mgr), io_service_(io_service),
+     concurrency_pending_(false), pending_max_transactions_(0),
+     pending_thread_pool_size_(0), update_batcher_(),
+     dns_protocol_(DNSClient::UDP), connection_pool_(),
+     transport_pending_(false), pending_dns_protocol_(DNSClient::UDP),
+     pending_persistent_(false) {
     if (!queue_mgr_) {
         isc_throw(D2UpdateMgrError, "D2UpdateMgr queue manager cannot be null");
     }
@@ -43,13 +54,55 @@ D2UpdateMgr::D2UpdateMgr(D2QueueMgrPtr& queue_mgr, D2CfgMgrPtr& cfg_mgr,
 }
 
 D2UpdateMgr::~D2UpdateMgr() {
+    stopThreadPool();
     transaction_list_.clear();
+    if (connection_pool_) {
+        connection_pool_->clear();
+    }
 }
 
 void D2UpdateMgr::sweep() {
     // cleanup finished transactions;
     checkFinishedTransactions();
 
+    // Concurrency and transport changes wait until all transactions have
+    // finished.
+    if (concurrency_pending_ || transport_pending_) {
+        if (getTransactionCount() > 0) {
+            return;
+        }
+
+        if (concurrency_pending_) {
+            setConcurrency(pending_max_transactions_,
+                           pending_thread_pool_size_);
+        }
+
+        if (transport_pending_) {
+            setDnsTransport(pending_dns_protocol_, pending_persistent_);
+        }
+    }
+
+    // With IO threads each new transaction is handed off immediately, and
+    // with batching the updates of the transactions started together are
+    // combined, so fill all the free slots.
+    if (!thread_pools_.empty() || update_batcher_) {
+        while (getQueueCount() > 0) {
+            if (getTransactionCount() >= max_transactions_) {
+                LOG_DEBUG(dhcp_to_d2_logger,
+                          isc::log::DBGLVL_TRACE_DETAIL_DATA,
+                          DHCP_DDNS_AT_MAX_TRANSACTIONS).arg(getQueueCount())
+                          .arg(getMaxTransactions());
+                return;
+            }
+
+            if (!pickNextJob()) {
+                return;
+            }
+        }
+
+        return;
+    }
+
     // if the queue isn't empty, find the next suitable job and
     // start a transaction for it.
     // @todo - Do we want to queue max transactions? The logic here will only
@@ -86,6 +139,12 @@ D2UpdateMgr::checkFinishedTransactions() {
         if (trans->isModelDone()) {
             // @todo  Additional actions based on NCR status could be
             // performed here.
+            if (!thread_pools_.empty()) {
+                // The IO thread may still be unwinding the handler which
+                // finished the transaction, so let that thread release
+                // the last reference.
+                selectIOService(trans->getNcr())->post([trans]() {});
+            }
             transaction_list_.erase(it++);
         } else {
             ++it;
@@ -93,7 +152,7 @@ D2UpdateMgr::checkFinishedTransactions() {
     }
 }
 
-void D2UpdateMgr::pickNextJob() {
+bool D2UpdateMgr::pickNextJob() {
     // Start at the front of the queue, looking for the first entry for
     // which no transaction is in progress.  If we find an eligible entry
     // remove it from the queue and  make a transaction for it.
@@ -106,7 +165,7 @@ void D2UpdateMgr::pickNextJob() {
         if (!hasTransaction(found_ncr->getDhcid())) {
             queue_mgr_->dequeueAt(index);
             makeTransaction(found_ncr);
-            return;
+            return (true);
         }
     }
 
@@ -115,6 +174,7 @@ void D2UpdateMgr::pickNextJob() {
     LOG_DEBUG(dhcp_to_d2_logger, isc::log::DBGLVL_TRACE_DETAIL_DATA,
               DHCP_DDNS_NO_ELIGIBLE_JOBS)
         .arg(getQueueCount()).arg(getTransactionCount());
+    return (false);
 }
 
 void
@@ -193,38 +253,64 @@ D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
     }
 
     // We matched to the required servers, so construct the transaction.
-    // @todo If multi-threading is implemented, one would pass in an
-    // empty IOServicePtr, rather than our instance value.  This would cause
-    // the transaction to instantiate its own, separate IOService to handle
-    // the transaction's IO.
+    // Its IO is carried out either by the primary IOService or by the IO
+    // thread the FQDN hashes to.
+    IOServicePtr io_service = selectIOService(next_ncr);
     NameChangeTransactionPtr trans;
     if (next_ncr->getChangeType() == dhcp_ddns::CHG_ADD) {
         if (next_ncr->useConflictResolution()) {
-            trans.reset(new NameAddTransaction(io_service_, next_ncr,
+            trans.reset(new NameAddTransaction(io_service, next_ncr,
                                                forward_domain, reverse_domain,
                                                cfg_mgr_));
         } else {
-            trans.reset(new SimpleAddTransaction(io_service_, next_ncr,
+            trans.reset(new SimpleAddTransaction(io_service, next_ncr,
                                                  forward_domain, reverse_domain,
                                                  cfg_mgr_));
         }
     } else {
         if (next_ncr->useConflictResolution()) {
-            trans.reset(new NameRemoveTransaction(io_service_, next_ncr,
+            trans.reset(new NameRemoveTransaction(io_service, next_ncr,
                                                   forward_domain, reverse_domain,
                                                   cfg_mgr_));
         } else {
-            trans.reset(new SimpleRemoveTransaction(io_service_, next_ncr,
+            trans.reset(new SimpleRemoveTransaction(io_service, next_ncr,
                                                     forward_domain, reverse_domain,
                                                     cfg_mgr_));
         }
     }
 
+    // Let the transaction combine its updates with the others.
+    trans->setUpdateBatcher(update_batcher_);
+    trans->setDnsTransport(dns_protocol_, connection_pool_);
+
     // Add the new transaction to the list.
     transaction_list_[key] = trans;
 
-    // Start it.
-    trans->startTransaction();
+    if (thread_pools_.empty()) {
+        // Start it.
+        trans->startTransaction();
+        return;
+    }
+
+    // Wake up the primary IOService when the transaction finishes so the
+    // upper layer calls sweep, then start it on its IO thread.
+    IOServicePtr main_io_service = io_service_;
+    trans->setCompletionHandler([main_io_service]() {
+        main_io_service->post([]() {});
+    });
+    io_service->post([trans]() { trans->startTransaction(); });
+}
+
+IOServicePtr
+D2UpdateMgr::selectIOService(const dhcp_ddns::NameChangeRequestPtr& ncr) const {
+    if (thread_pools_.empty()) {
+        return (io_service_);
+    }
+
+    // Updates for the same name always go to the same thread.
+    boost::hash<std::string> hasher;
+    size_t index = hasher(ncr->getFqdn()) % thread_pools_.size();
+    return (thread_pools_[index]->getIOService());
 }
 
 TransactionList::iterator
@@ -280,6 +366,173 @@ D2UpdateMgr::setMaxTransactions(const size_t new_trans_max) {
     max_transactions_ = new_trans_max;
 }
 
+void
+D2UpdateMgr::setThreadPoolSize(const size_t thread_pool_size) {
+    if (getTransactionCount() > 0) {
+        isc_throw(D2UpdateMgrError, "D2UpdateMgr thread pool size cannot be"
+                  " changed while transactions are in progress: "
+                  << getTransactionCount());
+    }
+
+    if (thread_pool_size == thread_pools_.size()) {
+        return;
+    }
+
+    stopThreadPool();
+
+    if (thread_pool_size == 0) {
+        return;
+    }
+
+    MultiThreadingMgr::instance().setMode(true);
+    for (size_t i = 0; i < thread_pool_size; ++i) {
+        IOServicePtr io_service(new IOService());
+        thread_pools_.push_back(IoServiceThreadPoolPtr(
+            new IoServiceThreadPool(io_service, 1)));
+    }
+
+    MultiThreadingMgr::instance().addCriticalSectionCallbacks("D2_UPDATE_MGR",
+        std::bind(&D2UpdateMgr::checkPausePermissions, this),
+        std::bind(&D2UpdateMgr::pauseThreadPool, this),
+        std::bind(&D2UpdateMgr::resumeThreadPool, this));
+}
+
+void
+D2UpdateMgr::setConcurrency(const size_t max_transactions,
+                            const size_t thread_pool_size) {
+    if (max_transactions < 1) {
+        isc_throw(D2UpdateMgrError, "D2UpdateMgr"
+                  " maximum transactions limit must be greater than zero");
+    }
+
+    if (getTransactionCount() > 0) {
+        concurrency_pending_ = true;
+        pending_max_transactions_ = max_transactions;
+        pending_thread_pool_size_ = thread_pool_size;
+        return;
+    }
+
+    concurrency_pending_ = false;
+    bool changed = ((max_transactions != max_transactions_) ||
+                    (thread_pool_size != thread_pools_.size()));
+    setMaxTransactions(max_transactions);
+    setThreadPoolSize(thread_pool_size);
+    if (changed) {
+        LOG_INFO(dhcp_to_d2_logger, DHCP_DDNS_TRANSACTION_CONCURRENCY)
+                 .arg(thread_pool_size).arg(max_transactions);
+    }
+}
+
+void
+D2UpdateMgr::setUpdateBatching(const size_t max_batch_size, const long delay) {
+    if (max_batch_size <= 1) {
+        update_batcher_.reset();
+        return;
+    }
+
+    if (update_batcher_ && (update_batcher_->getMaxBatchSize() == max_batch_size)
+        && (update_batcher_->getDelay() == delay)
+        && (update_batcher_->getProtocol() == dns_protocol_)
+        && (update_batcher_->getConnectionPool() == connection_pool_)) {
+        return;
+    }
+
+    update_batcher_.reset(new DNSUpdateBatcher(max_batch_size, delay,
+                                               dns_protocol_,
+                                               connection_pool_));
+}
+
+void
+D2UpdateMgr::setDnsTransport(const DNSClient::Protocol proto,
+                             const bool persistent) {
+    if (getTransactionCount() > 0) {
+        transport_pending_ = true;
+        pending_dns_protocol_ = proto;
+        pending_persistent_ = persistent;
+        return;
+    }
+
+    transport_pending_ = false;
+    dns_protocol_ = proto;
+    DNSConnectionPool::Protocol pool_proto = (proto == DNSClient::TCP ?
+                                              DNSConnectionPool::TCP :
+                                              DNSConnectionPool::UDP);
+    if (!persistent || (connection_pool_ &&
+                        (connection_pool_->getProtocol() != pool_proto))) {
+        if (connection_pool_) {
+            connection_pool_->clear();
+            connection_pool_.reset();
+        }
+    }
+
+    if (persistent && !connection_pool_) {
+        connection_pool_.reset(new DNSConnectionPool(pool_proto));
+    }
+
+    // The batcher sends its batches with the new transport.
+    if (update_batcher_) {
+        setUpdateBatching(update_batcher_->getMaxBatchSize(),
+                          update_batcher_->getDelay());
+    }
+}
+
+void
+D2UpdateMgr::checkPausePermissions() {
+    // The MultiThreadingInvalidOperation must be propagated to the scope
+    // of the MultiThreadingCriticalSection constructor.
+    for (auto const& pool : thread_pools_) {
+        pool->checkPausePermissions();
+    }
+}
+
+void
+D2UpdateMgr::pauseThreadPool() {
+    // Since this function is used as CS callback all exceptions must be
+    // suppressed.
+    try {
+        for (auto const& pool : thread_pools_) {
+            pool->pause();
+        }
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcp_to_d2_logger, DHCP_DDNS_THREAD_POOL_PAUSE_FAILED)
+                  .arg(ex.what());
+    }
+}
+
+void
+D2UpdateMgr::resumeThreadPool() {
+    // Since this function is used as CS callback all exceptions must be
+    // suppressed.
+    try {
+        for (auto const& pool : thread_pools_) {
+            pool->run();
+        }
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcp_to_d2_logger, DHCP_DDNS_THREAD_POOL_RESUME_FAILED)
+                  .arg(ex.what());
+    }
+}
+
+void
+D2UpdateMgr::stopThreadPool() {
+    if (thread_pools_.empty()) {
+        return;
+    }
+
+    MultiThreadingMgr::instance().removeCriticalSectionCallbacks("D2_UPDATE_MGR");
+    for (auto const& pool : thread_pools_) {
+        pool->stop();
+    }
+
+    // The persistent connections must not outlive their IOService.
+    if (connection_pool_) {
+        connection_pool_->clear();
+    }
+
+    thread_pools_.clear();
+    MultiThreadingMgr::instance().setMode(false);
+}
+
 size_t
 D2UpdateMgr::getQueueCount() const {
     return (queue_mgr_->getQueueSize());
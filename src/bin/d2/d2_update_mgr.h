@@ -10,15 +10,18 @@
 /// @file d2_update_mgr.h This file defines the class D2UpdateMgr.
 
 #include <asiolink/io_service.h>
+#include <asiolink/io_service_thread_pool.h>
 #include <d2/d2_queue_mgr.h>
 #include <d2srv/nc_trans.h>
 #include <d2srv/d2_cfg_mgr.h>
 #include <d2srv/d2_log.h>
+#include <d2srv/dns_update_batcher.h>
 #include <exceptions/exceptions.h>
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 #include <map>
+#include <vector>
 
 namespace isc {
 namespace d2 {
@@ -62,6 +65,18 @@ typedef std::map<TransactionKey, NameChangeTransactionPtr> TransactionList;
 /// The upper layer(s) are responsible for calling sweep in a timely and cyclic
 /// manner.
 ///
+/// By default all transactions share the primary IOService. When a thread
+/// pool size greater than zero is set, D2UpdateMgr creates that many IO
+/// threads, each driving its own IOService, and transactions are sharded
+/// across them by FQDN.  The transaction list itself is only accessed from
+/// the thread calling sweep(); worker threads notify it of transaction
+/// completion by posting an empty handler to the primary IOService.
+///
+/// When update batching is enabled, transactions send their DNS updates
+/// without prerequisites through a shared @ref DNSUpdateBatcher which
+/// combines the updates for the same zone and server into a single
+/// DNS UPDATE message.
+///
 class D2UpdateMgr : public boost::noncopyable {
 public:
     /// @brief Maximum number of concurrent transactions
@@ -100,6 +115,13 @@ public:
     ///
     /// - If a request was selected, start a new transaction for it and
     /// add the transaction to the list of transactions.
+    ///
+    /// When the thread pool or update batching is enabled, requests are
+    /// selected until either
+    /// the maximum number of transactions is reached or no eligible request
+    /// remains.  A pending concurrency change (see @ref setConcurrency) is
+    /// applied once the transaction list has drained; no new transactions
+    /// are started until then.
     void sweep();
 
 protected:
@@ -123,7 +145,9 @@ protected:
     /// It is possible that no such request exists, though this is likely to be
     /// rather rare unless a system is frequently seeing requests for the same
     /// clients in quick succession.
-    void pickNextJob();
+    ///
+    /// @return true if a request was dequeued, false otherwise.
+    bool pickNextJob();
 
     /// @brief Create a new transaction for the given request.
     ///
@@ -175,6 +199,79 @@ public:
     /// queue.
     void setMaxTransactions(const size_t max_transactions);
 
+    /// @brief Returns the number of IO threads used by transactions.
+    ///
+    /// @return the number of threads, zero means transactions run on the
+    /// primary IOService.
+    size_t getThreadPoolSize() const {
+        return (thread_pools_.size());
+    }
+
+    /// @brief Sets the number of IO threads used by transactions.
+    ///
+    /// Stops any existing threads and, if the new size is greater than zero,
+    /// starts the new ones and enables multi-threading mode.
+    ///
+    /// @param thread_pool_size is the new number of threads
+    ///
+    /// @throw D2UpdateMgrError if there are transactions in progress.
+    void setThreadPoolSize(const size_t thread_pool_size);
+
+    /// @brief Requests a change of the concurrency parameters.
+    ///
+    /// The new values are applied immediately if there are no transactions
+    /// in progress, otherwise they are applied by @ref sweep once all the
+    /// current transactions have finished.
+    ///
+    /// @param max_transactions is the new maximum number of transactions
+    /// @param thread_pool_size is the new number of IO threads
+    ///
+    /// @throw D2UpdateMgrError if max transactions is zero.
+    void setConcurrency(const size_t max_transactions,
+                        const size_t thread_pool_size);
+
+    /// @brief Sets the batching of DNS updates.
+    ///
+    /// Takes effect for the transactions created afterward, the others keep
+    /// the batcher they were given.
+    ///
+    /// @param max_batch_size maximum number of updates combined in a single
+    /// DNS update, a value of 0 or 1 disables batching
+    /// @param delay maximum time in milliseconds an update waits for others
+    /// to be combined with
+    void setUpdateBatching(const size_t max_batch_size, const long delay);
+
+    /// @brief Returns the DNS update batcher.
+    ///
+    /// @return the batcher, empty when batching is disabled.
+    const DNSUpdateBatcherPtr& getUpdateBatcher() const {
+        return (update_batcher_);
+    }
+
+    /// @brief Sets the transport used to send DNS updates.
+    ///
+    /// When transactions are in progress the change is deferred until they
+    /// have all finished.
+    ///
+    /// @param proto the transport protocol
+    /// @param persistent if true DNS updates are sent over persistent
+    /// connections to the DNS servers, otherwise each update is sent using
+    /// a new socket
+    void setDnsTransport(const DNSClient::Protocol proto,
+                         const bool persistent);
+
+    /// @brief Returns the transport protocol used to send DNS updates.
+    DNSClient::Protocol getDnsProtocol() const {
+        return (dns_protocol_);
+    }
+
+    /// @brief Returns the pool of persistent connections.
+    ///
+    /// @return the pool, empty when persistent connections are disabled.
+    const DNSConnectionPoolPtr& getConnectionPool() const {
+        return (connection_pool_);
+    }
+
     /// @brief Search the transaction list for the given key.
     ///
     /// @param key the transaction key value for which to search.
@@ -218,6 +315,33 @@ public:
     size_t getTransactionCount() const;
 
 private:
+    /// @brief Selects the IOService which will run a transaction.
+    ///
+    /// @param ncr the request for which the transaction is made.
+    ///
+    /// @return the primary IOService if the thread pool is disabled,
+    /// otherwise the IOService of the thread selected by the FQDN hash.
+    asiolink::IOServicePtr selectIOService(
+        const dhcp_ddns::NameChangeRequestPtr& ncr) const;
+
+    /// @brief Checks that the IO threads may be paused.
+    ///
+    /// Used as the check callback of the critical section.
+    void checkPausePermissions();
+
+    /// @brief Pauses the IO threads.
+    ///
+    /// Used as the entry callback of the critical section.
+    void pauseThreadPool();
+
+    /// @brief Resumes the IO threads.
+    ///
+    /// Used as the exit callback of the critical section.
+    void resumeThreadPool();
+
+    /// @brief Stops and discards the IO threads.
+    void stopThreadPool();
+
     /// @brief Pointer to the queue manager.
     D2QueueMgrPtr queue_mgr_;
 
@@ -227,14 +351,44 @@ private:
     /// @brief Primary IOService instance.
     /// This is the IOService that the upper layer(s) use for IO events, such
     /// as shutdown and configuration commands.  It is the IOService that is
-    /// passed into transactions to manager their IO events.
-    /// (For future reference, multi-threaded transactions would each use their
-    /// own IOService instance.)
+    /// passed into transactions to manager their IO events, unless the
+    /// thread pool is enabled in which case it is only woken up as
+    /// transactions complete.
     asiolink::IOServicePtr io_service_;
 
     /// @brief Maximum number of concurrent transactions.
     size_t max_transactions_;
 
+    /// @brief IO threads running transactions, one IOService per thread.
+    std::vector<asiolink::IoServiceThreadPoolPtr> thread_pools_;
+
+    /// @brief True if a concurrency change waits for transactions to finish.
+    bool concurrency_pending_;
+
+    /// @brief Pending maximum number of transactions.
+    size_t pending_max_transactions_;
+
+    /// @brief Pending number of IO threads.
+    size_t pending_thread_pool_size_;
+
+    /// @brief Batcher combining DNS updates (if enabled).
+    DNSUpdateBatcherPtr update_batcher_;
+
+    /// @brief Transport protocol used to send DNS updates.
+    DNSClient::Protocol dns_protocol_;
+
+    /// @brief Pool of persistent connections (if enabled).
+    DNSConnectionPoolPtr connection_pool_;
+
+    /// @brief True if a transport change waits for transactions to finish.
+    bool transport_pending_;
+
+    /// @brief Pending transport protocol.
+    DNSClient::Protocol pending_dns_protocol_;
+
+    /// @brief Pending persistent connections flag.
+    bool pending_persistent_;
+
     /// @brief List of transactions.
     TransactionList transaction_list_;
 };
@@ -196,6 +196,8 @@ D2ParserContext::contextName()
         return ("ncr-protocol");
     case NCR_FORMAT:
         return ("ncr-format");
+    case DNS_PROTOCOL:
+        return ("dns-protocol");
     case HOOKS_LIBRARIES:
         return ("hooks-libraries");
     default:
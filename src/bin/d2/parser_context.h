@@ -269,6 +269,9 @@ public:
         /// Used while parsing DhcpDdns/ncr-format
         NCR_FORMAT,
 
+        /// Used while parsing DhcpDdns/dns-protocol
+        DNS_PROTOCOL,
+
         /// Used while parsing DhcpDdns/hooks-libraries.
         HOOKS_LIBRARIES
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -255,6 +255,11 @@ TEST_F(D2CfgMgrTest, validParamsEntry) {
     // Verify the configuration summary.
     EXPECT_EQ("listening on 3001::5, port 777, using UDP",
               d2_params_->getConfigSummary());
+
+    // Verify that the binary format is supported.
+    config = makeParamsConfigString ("127.0.0.1", 777, 333, "UDP", "BINARY");
+    RUN_CONFIG_OK(config);
+    EXPECT_EQ(dhcp_ddns::FMT_BINARY, d2_params_->getNcrFormat());
 }
 
 /// @brief Tests default values for D2Params.
@@ -403,6 +408,7 @@ TEST_F(D2CfgMgrTest, unsupportedTopLevelItems) {
 /// -# dns_server_timeout cannot be 0
 /// -# ncr_protocol must be valid
 /// -# ncr_format must be valid
+/// -# thread_pool_size cannot be larger than 256
 TEST_F(D2CfgMgrTest, invalidEntry) {
     // Cannot use IPv4 ANY address
     std::string config = makeParamsConfigString ("0.0.0.0", 777, 333,
@@ -435,7 +441,16 @@ TEST_F(D2CfgMgrTest, invalidEntry) {
     // Invalid format
     config = makeParamsConfigString ("127.0.0.1", 777, 333, "UDP", "BOGUS");
     SYNTAX_ERROR(config, "<string>:1.115-121: syntax error,"
-                         " unexpected constant string, expecting JSON");
+                         " unexpected constant string, expecting JSON or BINARY");
+
+    // Thread pool size is bounded
+    config = "{ \"thread-pool-size\": 1000, "
+             " \"tsig-keys\": [], "
+             " \"forward-ddns\" : {}, "
+             " \"reverse-ddns\" : {} "
+             "}";
+    SYNTAX_ERROR(config, "<string>:1.23-26: thread-pool-size must not be"
+                         " negative or larger than 256");
 }
 
 // Control socket tests in d2_process_unittests.cc
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -389,7 +389,8 @@ TEST_F (QueueMgrUDPTest, liveFeed) {
     StatMap stats_ncr = {
         { "ncr-received", 3},
         { "ncr-invalid", 0},
-        { "ncr-error", 0}
+        { "ncr-error", 0},
+        { "ncr-queue-wait-count", 3}
     };
     checkStats(stats_ncr);
 
@@ -409,7 +410,8 @@ TEST_F (QueueMgrUDPTest, liveFeed) {
     StatMap stats_ncr_new = {
         { "ncr-received", 6},
         { "ncr-invalid", 0},
-        { "ncr-error", 0}
+        { "ncr-error", 0},
+        { "ncr-queue-wait-count", 3}
     };
     checkStats(stats_ncr_new);
 
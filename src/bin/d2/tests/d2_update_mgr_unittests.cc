@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,7 @@
 #include <d2/simple_add.h>
 #include <d2/simple_remove.h>
 #include <process/testutils/d_test_stubs.h>
+#include <util/multi_threading_mgr.h>
 #include <util/time_utilities.h>
 
 #include <gtest/gtest.h>
@@ -238,6 +239,41 @@ public:
         }
     }
 
+
+    /// @brief Process events until all requests have been completed when
+    /// transactions are run by IO threads or send batched updates.
+    ///
+    /// This method iteratively calls D2UpdateMgr::sweep and runs the primary
+    /// IOService, which is woken up by the IO threads as transactions
+    /// complete, until both the request queue and transaction list are
+    /// empty.  Unlike processAll it does not depend on the transactions
+    /// waiting for IO.  As with processAll the number of passes is limited.
+    void processAllThreaded(size_t max_passes = 100) {
+        size_t passes = 0;
+        size_t timeout = cfg_mgr_->getD2Params()->getDnsServerTimeout() + 100;
+        while (update_mgr_->getQueueCount() ||
+               update_mgr_->getTransactionCount()) {
+            ++passes;
+            update_mgr_->sweep();
+
+            // The sweep may have removed the last transactions: there is
+            // then nothing left to wait for.
+            if (!update_mgr_->getQueueCount() &&
+                !update_mgr_->getTransactionCount()) {
+                break;
+            }
+
+            if (runTimedIO(timeout) == 0) {
+                // The timer stopped the service, restart it for next pass.
+                io_service_->restart();
+            }
+
+            if (passes > max_passes) {
+                FAIL() << "processAllThreaded failed, too many passes: "
+                       << passes;
+            }
+        }
+    }
 };
 
 /// @brief Tests the D2UpdateMgr construction.
@@ -870,6 +906,158 @@ TEST_F(D2UpdateMgrTest, multiTransactionTimeout) {
     }
 }
 
+/// @brief Tests deferred concurrency changes.
+/// This test verifies that:
+/// 1. Concurrency settings are applied at once when no transactions exist.
+/// 2. With IO threads a single sweep fills all the free transaction slots.
+/// 3. The thread pool size cannot be changed while transactions exist.
+/// 4. A concurrency change requested while transactions exist is applied
+/// by sweep once they have all finished.
+TEST_F(D2UpdateMgrTest, setConcurrency) {
+    // Max transactions cannot be zero.
+    EXPECT_THROW(update_mgr_->setConcurrency(0, 2), D2UpdateMgrError);
+
+    // No transactions, so the change is applied immediately.
+    ASSERT_NO_THROW(update_mgr_->setConcurrency(10, 2));
+    EXPECT_EQ(10, update_mgr_->getMaxTransactions());
+    EXPECT_EQ(2, update_mgr_->getThreadPoolSize());
+    EXPECT_TRUE(MultiThreadingMgr::instance().getMode());
+
+    for (int i = 0; i < canned_count_; i++) {
+        canned_ncrs_[i]->setReverseChange(true);
+        ASSERT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[i]));
+    }
+
+    // A single sweep should start all of the transactions.
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(0, update_mgr_->getQueueCount());
+    EXPECT_EQ(canned_count_, update_mgr_->getTransactionCount());
+
+    // The pool cannot be resized while transactions are in progress.
+    EXPECT_THROW(update_mgr_->setThreadPoolSize(0), D2UpdateMgrError);
+
+    // Request a change, it must wait for the transactions to finish.
+    ASSERT_NO_THROW(update_mgr_->setConcurrency(5, 0));
+    EXPECT_EQ(10, update_mgr_->getMaxTransactions());
+    EXPECT_EQ(2, update_mgr_->getThreadPoolSize());
+
+    // Let the transactions complete against a server run by the main thread.
+    asiolink::IOAddress server_ip("127.0.0.1");
+    FauxServer server(*io_service_, server_ip, 5301);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::NOERROR());
+    processAllThreaded();
+
+    for (int i = 0; i < canned_count_; i++) {
+        EXPECT_EQ(dhcp_ddns::ST_COMPLETED, canned_ncrs_[i]->getStatus());
+    }
+
+    // The pending change should now have been applied.
+    EXPECT_EQ(5, update_mgr_->getMaxTransactions());
+    EXPECT_EQ(0, update_mgr_->getThreadPoolSize());
+    EXPECT_FALSE(MultiThreadingMgr::instance().getMode());
+}
+
+/// @brief Tests processing of multiple transactions by IO threads.
+/// This test verifies that update manager can carry out transactions
+/// on IO threads.  It uses a fake server, run by the main thread, that
+/// responds to all requests sent with NOERROR.
+TEST_F(D2UpdateMgrTest, multiTransactionThreaded) {
+    ASSERT_NO_THROW(update_mgr_->setThreadPoolSize(3));
+
+    // Give each request its own name so they are spread over the threads.
+    const char* fqdns[] = { "one.example.com.", "two.example.com.",
+                            "three.example.com.", "four.example.com." };
+    int test_count = canned_count_;
+    for (int i = 0; i < test_count; i++) {
+        canned_ncrs_[i]->setFqdn(fqdns[i]);
+        canned_ncrs_[i]->setReverseChange(true);
+        ASSERT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[i]));
+    }
+
+    asiolink::IOAddress server_ip("127.0.0.1");
+    FauxServer server(*io_service_, server_ip, 5301);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::NOERROR());
+
+    processAllThreaded();
+
+    for (int i = 0; i < test_count; i++) {
+        EXPECT_EQ(dhcp_ddns::ST_COMPLETED, canned_ncrs_[i]->getStatus());
+    }
+}
+
+/// @brief Tests processing of multiple transactions with update batching.
+/// This test verifies that update manager can carry out transactions
+/// whose DNS updates are combined by the update batcher.  It uses a fake
+/// server that responds to all requests sent with NOERROR.
+TEST_F(D2UpdateMgrTest, multiTransactionBatched) {
+    ASSERT_NO_THROW(update_mgr_->setUpdateBatching(8, 0));
+    ASSERT_TRUE(update_mgr_->getUpdateBatcher());
+
+    // Batching applies to updates without prerequisites, i.e. to the
+    // transactions not using conflict resolution.
+    const char* fqdns[] = { "one.example.com.", "two.example.com.",
+                            "three.example.com.", "four.example.com." };
+    int test_count = canned_count_;
+    for (int i = 0; i < test_count; i++) {
+        canned_ncrs_[i]->setFqdn(fqdns[i]);
+        canned_ncrs_[i]->setReverseChange(true);
+        canned_ncrs_[i]->setConflictResolution(false);
+        ASSERT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[i]));
+    }
+
+    asiolink::IOAddress server_ip("127.0.0.1");
+    FauxServer server(*io_service_, server_ip, 5301);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::NOERROR());
+
+    processAllThreaded();
+
+    for (int i = 0; i < test_count; i++) {
+        EXPECT_EQ(dhcp_ddns::ST_COMPLETED, canned_ncrs_[i]->getStatus());
+    }
+
+    // Disabling batching drops the batcher.
+    ASSERT_NO_THROW(update_mgr_->setUpdateBatching(1, 0));
+    EXPECT_FALSE(update_mgr_->getUpdateBatcher());
+}
+
+/// @brief Tests processing of multiple transactions over persistent
+/// connections.
+/// This test verifies that update manager can carry out transactions
+/// whose DNS updates are sent over a single socket to the server, and
+/// that transport changes are deferred while transactions are in progress.
+TEST_F(D2UpdateMgrTest, multiTransactionPersistent) {
+    EXPECT_EQ(DNSClient::UDP, update_mgr_->getDnsProtocol());
+    EXPECT_FALSE(update_mgr_->getConnectionPool());
+    ASSERT_NO_THROW(update_mgr_->setDnsTransport(DNSClient::UDP, true));
+    DNSConnectionPoolPtr pool = update_mgr_->getConnectionPool();
+    ASSERT_TRUE(pool);
+
+    int test_count = canned_count_;
+    for (int i = 0; i < test_count; i++) {
+        ASSERT_NO_THROW(queue_mgr_->enqueue(canned_ncrs_[i]));
+    }
+
+    asiolink::IOAddress server_ip("127.0.0.1");
+    FauxServer server(*io_service_, server_ip, 5301);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::NOERROR());
+
+    // Start the first transaction, then ask for the transport change.
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    ASSERT_EQ(1, update_mgr_->getTransactionCount());
+    ASSERT_NO_THROW(update_mgr_->setDnsTransport(DNSClient::UDP, false));
+    EXPECT_EQ(pool, update_mgr_->getConnectionPool());
+
+    processAll();
+
+    for (int i = 0; i < test_count; i++) {
+        EXPECT_EQ(dhcp_ddns::ST_COMPLETED, canned_ncrs_[i]->getStatus());
+    }
+
+    // The change was applied once the first transaction had finished.
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_FALSE(update_mgr_->getConnectionPool());
+}
+
 /// @brief Tests integration of SimpleAddTransaction
 /// This test verifies that update manager can create and manage a
 /// SimpleAddTransaction from start to finish.  It utilizes a fake server
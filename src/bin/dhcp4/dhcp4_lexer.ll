@@ -499,6 +499,33 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"write-behind\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser4Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp4Parser::make_WRITE_BEHIND(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp4Parser::make_STRING("write-behind", driver.loc_);
+    }
+}
+
+\"write-behind-interval\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser4Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp4Parser::make_WRITE_BEHIND_INTERVAL(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp4Parser::make_STRING("write-behind-interval", driver.loc_);
+    }
+}
+
+\"write-behind-sync\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser4Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp4Parser::make_WRITE_BEHIND_SYNC(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp4Parser::make_STRING("write-behind-sync", driver.loc_);
+    }
+}
+
 \"connect-timeout\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser4Context::LEASE_DATABASE:
@@ -1641,6 +1668,15 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"client-affinity\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser4Context::DHCP_MULTI_THREADING:
+        return isc::dhcp::Dhcp4Parser::make_CLIENT_AFFINITY(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp4Parser::make_STRING("client-affinity", driver.loc_);
+    }
+}
+
 \"control-socket\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser4Context::DHCP4:
@@ -1884,6 +1920,16 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     return isc::dhcp::Dhcp4Parser::make_STRING(tmp, driver.loc_);
 }
 
+(?i:\"BINARY\") {
+    /* dhcp-ddns value keywords are case insensitive */
+    if (driver.ctx_ == isc::dhcp::Parser4Context::NCR_FORMAT) {
+        return isc::dhcp::Dhcp4Parser::make_BINARY(driver.loc_);
+    }
+    std::string tmp(yytext+1);
+    tmp.resize(tmp.size() - 1);
+    return isc::dhcp::Dhcp4Parser::make_STRING(tmp, driver.loc_);
+}
+
 (?i:\"when-present\") {
     /* dhcp-ddns value keywords are case insensitive */
     if (driver.ctx_ == isc::dhcp::Parser4Context::REPLACE_CLIENT_NAME) {
@@ -2068,6 +2114,24 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"host-cache-max-entries\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser4Context::DHCP4:
+        return isc::dhcp::Dhcp4Parser::make_HOST_CACHE_MAX_ENTRIES(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp4Parser::make_STRING("host-cache-max-entries", driver.loc_);
+    }
+}
+
+\"host-cache-ttl\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser4Context::DHCP4:
+        return isc::dhcp::Dhcp4Parser::make_HOST_CACHE_TTL(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp4Parser::make_STRING("host-cache-ttl", driver.loc_);
+    }
+}
+
 \"compatibility\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser4Context::DHCP4:
@@ -47,6 +47,7 @@
 #include <hooks/hooks_log.h>
 #include <hooks/hooks_manager.h>
 #include <stats/stats_mgr.h>
+#include <util/memory_pool.h>
 #include <util/strutil.h>
 #include <log/logger.h>
 #include <cryptolink/cryptolink.h>
@@ -62,6 +63,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/pointer_cast.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -140,6 +142,103 @@ std::set<std::string> dhcp4_statistics = {
     "v4-lease-reuses",
 };
 
+/// @brief Resolves the options to return to a client.
+///
+/// Walks the configured option list to add the persistent options to the
+/// requested options, and to collect the cancelled options. Then for each
+/// requested and not cancelled option code gets the first instance of the
+/// option to be returned to the client.
+///
+/// @param co_list The configured option list.
+/// @param prl The option codes requested by the client.
+/// @return The resolved options.
+ConstResolvedOptionsPtr
+resolveRequestedOptions(const CfgOptionList& co_list,
+                        const std::vector<uint16_t>& prl) {
+    boost::shared_ptr<ResolvedOptions> resolved(new ResolvedOptions());
+    resolved->cfg_option_list_ = co_list;
+    std::set<uint16_t>& requested_opts = resolved->requested_;
+    std::set<uint16_t>& cancelled_opts = resolved->cancelled_;
+    requested_opts.insert(prl.cbegin(), prl.cend());
+
+    // Iterate on the configured option list to add persistent and
+    // cancelled options.
+    for (auto const& copts : co_list) {
+        const OptionContainerPtr& opts = copts->getAll(DHCP4_OPTION_SPACE);
+        if (!opts) {
+            continue;
+        }
+        // Get persistent options.
+        const OptionContainerPersistIndex& pidx = opts->get<2>();
+        const OptionContainerPersistRange& prange = pidx.equal_range(true);
+        for (OptionContainerPersistIndex::const_iterator desc = prange.first;
+             desc != prange.second; ++desc) {
+            // Add the persistent option code to requested options.
+            if (desc->option_) {
+                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
+                static_cast<void>(requested_opts.insert(code));
+            }
+        }
+        // Get cancelled options.
+        const OptionContainerCancelIndex& cidx = opts->get<5>();
+        const OptionContainerCancelRange& crange = cidx.equal_range(true);
+        for (OptionContainerCancelIndex::const_iterator desc = crange.first;
+             desc != crange.second; ++desc) {
+            // Add the cancelled option code to cancelled options.
+            if (desc->option_) {
+                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
+                static_cast<void>(cancelled_opts.insert(code));
+            }
+        }
+    }
+
+    // For each requested option code get the first instance of the option
+    // to be returned to the client.
+    for (uint16_t opt : requested_opts) {
+        if (cancelled_opts.count(opt) > 0) {
+            continue;
+        }
+        // Skip special cases: DHO_VIVSO_SUBOPTIONS.
+        if (opt == DHO_VIVSO_SUBOPTIONS) {
+            continue;
+        }
+        // Iterate on the configured option list
+        for (auto const& copts : co_list) {
+            OptionDescriptor desc = copts->get(DHCP4_OPTION_SPACE, opt);
+            // Got it: add it and jump to the outer loop
+            if (desc.option_) {
+                resolved->options_.push_back(desc.option_);
+                break;
+            }
+        }
+    }
+
+    return (resolved);
+}
+
+/// @brief Returns the option codes requested by a client.
+///
+/// @param query The query from the client.
+/// @return The codes of the Parameter Request List option, if any.
+std::vector<uint16_t>
+getRequestedOptionCodes(const Pkt4Ptr& query) {
+    std::vector<uint16_t> prl;
+
+    // try to get the 'Parameter Request List' option which holds the
+    // codes of requested options.
+    OptionUint8ArrayPtr option_prl = boost::dynamic_pointer_cast<
+        OptionUint8Array>(query->getOption(DHO_DHCP_PARAMETER_REQUEST_LIST));
+
+    // Get the list of options that client requested.
+    if (option_prl) {
+        for (uint16_t code : option_prl->getValues()) {
+            prl.push_back(code);
+        }
+    }
+
+    return (prl);
+}
+
 } // end of anonymous namespace
 
 // Declare a Hooks object. As this is outside any function or method, it
@@ -285,7 +384,7 @@ Dhcpv4Exchange::initResponse() {
     }
     // Only create a response if one is required.
     if (resp_type > 0) {
-        resp_.reset(new Pkt4(resp_type, getQuery()->getTransid()));
+        resp_ = makePooled<Pkt4>(resp_type, getQuery()->getTransid());
         copyDefaultFields();
         copyDefaultOptions();
 
@@ -1100,7 +1199,8 @@ Dhcpv4Srv::run_one() {
             boost::shared_ptr<CallBack> call_back =
                 boost::make_shared<CallBack>(std::bind(&Dhcpv4Srv::processPacketAndSendResponseNoThrow,
                                                        this, query));
-            if (!MultiThreadingMgr::instance().getThreadPool().add(call_back)) {
+            if (!MultiThreadingMgr::instance().getThreadPool().add(call_back,
+                                                                   getClientAffinityKey(query))) {
                 LOG_DEBUG(dhcp4_logger, DBG_DHCP4_BASIC, DHCP4_PACKET_QUEUE_FULL);
             }
         } else {
@@ -1109,6 +1209,23 @@ Dhcpv4Srv::run_one() {
     }
 }
 
+size_t
+Dhcpv4Srv::getClientAffinityKey(const Pkt4Ptr& query) {
+    const OptionBuffer& data = query->data_;
+    // Use the hardware address from the fixed header: unlike the client
+    // identifier it is carried by all the queries of a client.
+    static const size_t CHADDR_OFFSET = 28;
+    if (data.size() < CHADDR_OFFSET + Pkt4::MAX_CHADDR_LEN) {
+        return (0);
+    }
+    size_t hlen = data[2];
+    if (hlen > Pkt4::MAX_CHADDR_LEN) {
+        hlen = Pkt4::MAX_CHADDR_LEN;
+    }
+    return (boost::hash_range(data.cbegin() + CHADDR_OFFSET,
+                              data.cbegin() + CHADDR_OFFSET + hlen));
+}
+
 void
 Dhcpv4Srv::processPacketAndSendResponseNoThrow(Pkt4Ptr& query) {
     try {
@@ -1334,7 +1451,10 @@ Dhcpv4Srv::processDhcp4Query(Pkt4Ptr& query, Pkt4Ptr& rsp,
     ClientHandler client_handler;
 
     // Check for lease modifier queries from the same client being processed.
+    // In client affinity mode they are processed in sequence by the thread
+    // selected by the hardware address so there is nothing to check.
     if (MultiThreadingMgr::instance().getMode() &&
+        !MultiThreadingMgr::instance().getClientAffinity() &&
         ((query->getType() == DHCPDISCOVER) ||
          (query->getType() == DHCPREQUEST) ||
          (query->getType() == DHCPRELEASE) ||
@@ -1744,25 +1864,52 @@ Dhcpv4Srv::buildCfgOptionList(Dhcpv4Exchange& ex) {
         return;
     }
 
-    // Firstly, host specific options.
+    // Firstly, host specific options. They are specific to the client so
+    // the list is not cached.
     const ConstHostPtr& host = ex.getContext()->currentHost();
+    bool cacheable = true;
     if (host && !host->getCfgOption4()->empty()) {
         co_list.push_back(host->getCfgOption4());
+        cacheable = false;
     }
 
-    // Secondly, pool specific options.
+    // Get the pool, only needed for its options.
     Pkt4Ptr resp = ex.getResponse();
     IOAddress addr = IOAddress::IPV4_ZERO_ADDRESS();
     if (resp) {
         addr = resp->getYiaddr();
     }
+    PoolPtr pool;
     if (!addr.isV4Zero()) {
-        PoolPtr pool = subnet->getPool(Lease::TYPE_V4, addr, false);
-        if (pool && !pool->getCfgOption()->empty()) {
-            co_list.push_back(pool->getCfgOption());
+        pool = subnet->getPool(Lease::TYPE_V4, addr, false);
+        if (pool && pool->getCfgOption()->empty()) {
+            pool.reset();
         }
     }
 
+    // The rest of the list only depends on the subnet, the pool and the
+    // classes: get it from the cache with the options resolved for the
+    // requested codes.
+    OptionListCachePtr cache =
+        CfgMgr::instance().getCurrentCfg()->getOptionListCache();
+    const ClientClasses& classes = ex.getQuery()->getClasses();
+    std::vector<uint16_t> prl;
+    if (cacheable) {
+        prl = getRequestedOptionCodes(ex.getQuery());
+        ConstResolvedOptionsPtr resolved =
+            cache->get(subnet->getID(), pool.get(), classes, prl);
+        if (resolved) {
+            co_list = resolved->cfg_option_list_;
+            ex.setResolvedOptions(resolved);
+            return;
+        }
+    }
+
+    // Secondly, pool specific options.
+    if (pool) {
+        co_list.push_back(pool->getCfgOption());
+    }
+
     // Thirdly, subnet configured options.
     if (!subnet->getCfgOption()->empty()) {
         co_list.push_back(subnet->getCfgOption());
@@ -1776,7 +1923,6 @@ Dhcpv4Srv::buildCfgOptionList(Dhcpv4Exchange& ex) {
     }
 
     // Each class in the incoming packet
-    const ClientClasses& classes = ex.getQuery()->getClasses();
     for (ClientClasses::const_iterator cclass = classes.cbegin();
          cclass != classes.cend(); ++cclass) {
         // Find the client class definition for this class
@@ -1805,6 +1951,12 @@ Dhcpv4Srv::buildCfgOptionList(Dhcpv4Exchange& ex) {
     if (!CfgMgr::instance().getCurrentCfg()->getCfgOption()->empty()) {
         co_list.push_back(CfgMgr::instance().getCurrentCfg()->getCfgOption());
     }
+
+    if (cacheable) {
+        ConstResolvedOptionsPtr resolved = resolveRequestedOptions(co_list, prl);
+        cache->put(subnet->getID(), pool.get(), classes, prl, resolved);
+        ex.setResolvedOptions(resolved);
+    }
 }
 
 void
@@ -1828,74 +1980,20 @@ Dhcpv4Srv::appendRequestedOptions(Dhcpv4Exchange& ex) {
 
     Pkt4Ptr query = ex.getQuery();
     Pkt4Ptr resp = ex.getResponse();
-    set<uint8_t> requested_opts;
-
-    // try to get the 'Parameter Request List' option which holds the
-    // codes of requested options.
-    OptionUint8ArrayPtr option_prl = boost::dynamic_pointer_cast<
-        OptionUint8Array>(query->getOption(DHO_DHCP_PARAMETER_REQUEST_LIST));
 
-    // Get the list of options that client requested.
-    if (option_prl) {
-        for (uint16_t code : option_prl->getValues()) {
-            static_cast<void>(requested_opts.insert(code));
-        }
+    // Get the options resolved with the list, or resolve them.
+    ConstResolvedOptionsPtr resolved = ex.getResolvedOptions();
+    if (!resolved) {
+        resolved = resolveRequestedOptions(co_list,
+                                           getRequestedOptionCodes(query));
     }
+    const std::set<uint16_t>& requested_opts = resolved->requested_;
+    const std::set<uint16_t>& cancelled_opts = resolved->cancelled_;
 
-    std::set<uint8_t> cancelled_opts;
-
-    // Iterate on the configured option list to add persistent and
-    // cancelled options.
-    for (auto const& copts : co_list) {
-        const OptionContainerPtr& opts = copts->getAll(DHCP4_OPTION_SPACE);
-        if (!opts) {
-            continue;
-        }
-        // Get persistent options.
-        const OptionContainerPersistIndex& pidx = opts->get<2>();
-        const OptionContainerPersistRange& prange = pidx.equal_range(true);
-        for (OptionContainerPersistIndex::const_iterator desc = prange.first;
-             desc != prange.second; ++desc) {
-            // Add the persistent option code to requested options.
-            if (desc->option_) {
-                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
-                static_cast<void>(requested_opts.insert(code));
-            }
-        }
-        // Get cancelled options.
-        const OptionContainerCancelIndex& cidx = opts->get<5>();
-        const OptionContainerCancelRange& crange = cidx.equal_range(true);
-        for (OptionContainerCancelIndex::const_iterator desc = crange.first;
-             desc != crange.second; ++desc) {
-            // Add the cancelled option code to cancelled options.
-            if (desc->option_) {
-                uint8_t code = static_cast<uint8_t>(desc->option_->getType());
-                static_cast<void>(cancelled_opts.insert(code));
-            }
-        }
-    }
-
-    // For each requested option code get the first instance of the option
-    // to be returned to the client.
-    for (uint8_t opt : requested_opts) {
-        if (cancelled_opts.count(opt) > 0) {
-            continue;
-        }
-        // Skip special cases: DHO_VIVSO_SUBOPTIONS.
-        if (opt == DHO_VIVSO_SUBOPTIONS) {
-            continue;
-        }
+    for (auto const& opt : resolved->options_) {
         // Add nothing when it is already there.
-        if (!resp->getOption(opt)) {
-            // Iterate on the configured option list
-            for (auto const& copts : co_list) {
-                OptionDescriptor desc = copts->get(DHCP4_OPTION_SPACE, opt);
-                // Got it: add it and jump to the outer loop
-                if (desc.option_) {
-                    resp->addOption(desc.option_);
-                    break;
-                }
-            }
+        if (!resp->getOption(opt->getType())) {
+            resp->addOption(opt);
         }
     }
 
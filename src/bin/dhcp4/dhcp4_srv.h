@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,6 +21,7 @@
 #include <dhcpsrv/cfg_option.h>
 #include <dhcpsrv/d2_client_mgr.h>
 #include <dhcpsrv/network_state.h>
+#include <dhcpsrv/option_list_cache.h>
 #include <dhcpsrv/subnet.h>
 #include <hooks/callout_handle.h>
 #include <process/daemon.h>
@@ -124,6 +125,20 @@ public:
         return (cfg_option_list_);
     }
 
+    /// @brief Returns the options resolved with the configured option list.
+    ///
+    /// @return The resolved options or null when they are not resolved yet.
+    ConstResolvedOptionsPtr getResolvedOptions() const {
+        return (resolved_options_);
+    }
+
+    /// @brief Sets the options resolved with the configured option list.
+    ///
+    /// @param resolved_options The resolved options.
+    void setResolvedOptions(const ConstResolvedOptionsPtr& resolved_options) {
+        resolved_options_ = resolved_options;
+    }
+
     /// @brief Sets reserved values of siaddr, sname and file in the
     /// server's response.
     void setReservedMessageFields();
@@ -232,6 +247,9 @@ private:
     /// @note The configured option list is an *ordered* list of
     /// @c CfgOption objects used to append options to the response.
     CfgOptionList cfg_option_list_;
+
+    /// @brief Options resolved with the configured option list.
+    ConstResolvedOptionsPtr resolved_options_;
 };
 
 /// @brief Type representing the pointer to the @c Dhcpv4Exchange.
@@ -643,6 +661,10 @@ protected:
     /// @note The configured option list is an *ordered* list of
     /// @c CfgOption objects used to append options to the response.
     ///
+    /// The list and the options resolved for the requested option codes
+    /// are taken from the option list cache of the configuration when
+    /// the client has no host reservation options.
+    ///
     /// @param ex The exchange where the configured option list is cached
     void buildCfgOptionList(Dhcpv4Exchange& ex);
 
@@ -1158,6 +1180,19 @@ public:
     /// @param response packet transmitted
     static void processStatsSent(const Pkt4Ptr& response);
 
+    /// @brief Returns the key selecting the thread processing a query in
+    /// client affinity mode.
+    ///
+    /// The key is a hash of the hardware address, computed from the wire
+    /// data as the query is not unpacked yet. All the queries of a client
+    /// get the same key so the @c ClientHandler is not used in client
+    /// affinity mode. A client using the same client identifier from two
+    /// hardware addresses may have its queries processed in parallel.
+    ///
+    /// @param query packet received
+    /// @return the client affinity key
+    static size_t getClientAffinityKey(const Pkt4Ptr& query);
+
     /// @brief Returns the index for "buffer4_receive" hook point
     /// @return the index for "buffer4_receive" hook point
     static int getHookIndexBuffer4Receive();
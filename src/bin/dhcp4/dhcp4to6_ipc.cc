@@ -19,10 +19,16 @@
 #include <hooks/callout_handle.h>
 #include <hooks/hooks_log.h>
 #include <hooks/hooks_manager.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/make_shared.hpp>
+
+#include <functional>
 
 using namespace std;
 using namespace isc::dhcp;
 using namespace isc::hooks;
+using namespace isc::util;
 
 namespace isc {
 namespace dhcp {
@@ -101,6 +107,27 @@ void Dhcp4to6Ipc::handler(int /* fd */) {
     // Extract the DHCPv4 packet with DHCPv6 packet attached
     Pkt4Ptr query(new Pkt4o6(msg->getData(), pkt));
 
+    // In client affinity mode the packets of a client must be processed
+    // by the thread selected for the client.
+    if (MultiThreadingMgr::instance().getMode() &&
+        MultiThreadingMgr::instance().getClientAffinity()) {
+        typedef function<void()> CallBack;
+        boost::shared_ptr<CallBack> call_back =
+            boost::make_shared<CallBack>(std::bind(&Dhcp4to6Ipc::process,
+                                                   query));
+        if (!MultiThreadingMgr::instance().getThreadPool().add(call_back,
+                Dhcpv4Srv::getClientAffinityKey(query))) {
+            LOG_DEBUG(dhcp4_logger, DBG_DHCP4_BASIC, DHCP4_PACKET_QUEUE_FULL);
+        }
+        return;
+    }
+
+    process(query);
+}
+
+void Dhcp4to6Ipc::process(Pkt4Ptr query) {
+    Dhcp4to6Ipc& ipc = Dhcp4to6Ipc::instance();
+
     // From Dhcpv4Srv::run_one() processing and after
     Pkt4Ptr rsp;
 
@@ -48,6 +48,15 @@ public:
     /// The handler processes the DHCPv4-query DHCPv6 packet and
     /// sends the DHCPv4-response DHCPv6 packet back to the DHCPv6 server
     static void handler(int /* fd */);
+
+    /// @brief Processes a DHCPv4-over-DHCPv6 query
+    ///
+    /// Processes the DHCPv4 packet and sends the response back to the
+    /// DHCPv6 server. In client affinity mode it is called by the thread
+    /// selected for the client.
+    ///
+    /// @param query the DHCPv4 packet with the DHCPv6 packet attached
+    static void process(Pkt4Ptr query);
 };
 
 } // namespace isc
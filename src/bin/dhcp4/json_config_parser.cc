@@ -89,6 +89,8 @@ public:
     /// - decline-probation-period
     /// - dhcp4o6-port
     /// - user-context
+    /// - host-cache-max-entries
+    /// - host-cache-ttl
     ///
     /// @throw DhcpConfigError if parameters are missing or
     /// or having incorrect values.
@@ -117,6 +119,16 @@ public:
         // Set the server's logical name
         std::string server_tag = getString(global, "server-tag");
         cfg->setServerTag(server_tag);
+
+        // Set the built-in host cache parameters.
+        if (global->contains("host-cache-max-entries")) {
+            uint32_t max_entries = getUint32(global, "host-cache-max-entries");
+            cfg->getCfgDbAccess()->setHostCacheMaxEntries(max_entries);
+        }
+        if (global->contains("host-cache-ttl")) {
+            uint32_t ttl = getUint32(global, "host-cache-ttl");
+            cfg->getCfgDbAccess()->setHostCacheTtl(ttl);
+        }
     }
 
     /// @brief Sets global parameters before other parameters are parsed.
@@ -693,6 +705,8 @@ processDhcp4Config(isc::data::ConstElementPtr config_set) {
                  (config_pair.first == "statistic-default-sample-age") ||
                  (config_pair.first == "early-global-reservations-lookup") ||
                  (config_pair.first == "ip-reservations-unique") ||
+                 (config_pair.first == "host-cache-max-entries") ||
+                 (config_pair.first == "host-cache-ttl") ||
                  (config_pair.first == "reservations-lookup-first") ||
                  (config_pair.first == "parked-packet-limit") ||
                  (config_pair.first == "allocator") ||
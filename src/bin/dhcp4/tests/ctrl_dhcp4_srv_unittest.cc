@@ -1835,6 +1835,93 @@ TEST_F(CtrlChannelDhcpv4SrvTest, concurrentConnections) {
     ASSERT_NO_THROW(getIOService()->poll());
 }
 
+// This test verifies that the server keeps the connection open after the
+// response to a command with the "keep-alive" parameter set to true.
+TEST_F(CtrlChannelDhcpv4SrvTest, keepAlive) {
+    createUnixChannelServer();
+
+    boost::scoped_ptr<UnixControlClient> client(new UnixControlClient());
+    ASSERT_TRUE(client);
+
+    ASSERT_TRUE(client->connectToServer(socket_path_));
+    ASSERT_NO_THROW(getIOService()->poll());
+
+    // Send two commands over the connection kept open.
+    std::string response;
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(client->sendCommand("{ \"command\": \"list-commands\", "
+                                        "\"keep-alive\": true }"));
+        ASSERT_NO_THROW(getIOService()->poll());
+        ASSERT_TRUE(client->getResponse(response));
+        EXPECT_TRUE(response.find("\"result\": 0") != std::string::npos);
+        ASSERT_NO_THROW(getIOService()->poll());
+    }
+
+    // Without the "keep-alive" parameter the connection is closed after
+    // the response.
+    ASSERT_TRUE(client->sendCommand("{ \"command\": \"list-commands\" }"));
+    ASSERT_NO_THROW(getIOService()->poll());
+    ASSERT_TRUE(client->getResponse(response));
+    EXPECT_TRUE(response.find("\"result\": 0") != std::string::npos);
+    ASSERT_NO_THROW(getIOService()->poll());
+    ASSERT_TRUE(client->getResponse(response));
+    EXPECT_TRUE(response.empty());
+
+    client->disconnectFromServer();
+    ASSERT_NO_THROW(getIOService()->poll());
+}
+
+// This test verifies that the server closes a connection kept open when
+// no command is received over it for too long.
+TEST_F(CtrlChannelDhcpv4SrvTest, keepAliveIdleTimeout) {
+    createUnixChannelServer();
+
+    // Set connection timeout to 2s to prevent long waiting time for the
+    // timeout during this test.
+    const unsigned short timeout = 2000;
+    CommandMgr::instance().setConnectionTimeout(timeout);
+
+    // Server's responses will be assigned to these variables.
+    std::string response;
+    std::string closed("not closed");
+
+    // It is useful to create a thread and run the server and the client
+    // at the same time and independently.
+    std::thread th([this, &response, &closed]() {
+
+        // IO service will be stopped automatically when this object goes
+        // out of scope and is destroyed.
+        IOServiceWork work(getIOService());
+
+        // Create the client and connect it to the server.
+        boost::scoped_ptr<UnixControlClient> client(new UnixControlClient());
+        ASSERT_TRUE(client);
+        ASSERT_TRUE(client->connectToServer(socket_path_));
+
+        // Send a command asking to keep the connection open.
+        ASSERT_TRUE(client->sendCommand("{ \"command\": \"list-commands\", "
+                                        "\"keep-alive\": true }"));
+        const unsigned int timeout = 15;
+        ASSERT_TRUE(client->getResponse(response, timeout));
+
+        // Having sent nothing more, the server closes the connection
+        // without a response.
+        ASSERT_TRUE(client->getResponse(closed, timeout));
+
+        // Explicitly close the client's connection.
+        client->disconnectFromServer();
+    });
+
+    // Run the server until stopped.
+    getIOService()->run();
+
+    // Wait for the thread to return.
+    th.join();
+
+    EXPECT_TRUE(response.find("\"result\": 0") != std::string::npos);
+    EXPECT_TRUE(closed.empty()) << closed;
+}
+
 // This test verifies that the server can receive and process a large command.
 TEST_F(CtrlChannelDhcpv4SrvTest, longCommand) {
 
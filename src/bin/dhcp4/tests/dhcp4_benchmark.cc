@@ -0,0 +1,368 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file dhcp4_benchmark.cc
+///
+/// In-process benchmark of the DHCPv4 server packet processing. The server
+/// runs on the fake interfaces of the @c IfaceMgrTestConfig so no socket is
+/// opened: the pre-generated DISCOVER, REQUEST and RENEW streams are handed
+/// to @c Dhcpv4Srv::processPacket directly (or through the thread pool when
+/// multi-threading is enabled) and the leases are stored in memfile.
+/// Build and run it with "make benchmark".
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <cc/data.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option4_addrlst.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/tests/iface_mgr_test_config.h>
+#include <dhcp4/dhcp4_srv.h>
+#include <dhcp4/json_config_parser.h>
+#include <dhcpsrv/cfg_multi_threading.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <log/logger_support.h>
+#include <testutils/benchmark_utils.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/make_shared.hpp>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+using namespace isc::test;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Base of the subnets, away from the fake interfaces addresses.
+const uint32_t SUBNETS_BASE = 0x0a800000; // 10.128.0.0
+
+/// @brief Address of the fake interface the packets are received on.
+const IOAddress SERVER_ADDRESS("10.0.0.1");
+
+/// @brief Describes the addressing of the simulated subnets.
+///
+/// Each subnet is split in two halves: the lower one holds the relay
+/// address and the dynamic pool, the upper one the reserved addresses.
+struct Layout {
+    /// @brief Constructor.
+    ///
+    /// @param params benchmark parameters.
+    explicit Layout(const BenchmarkParams& params) : bits_(8) {
+        uint32_t per_subnet = (params.clients_ + params.leases_ +
+                               params.subnets_ - 1) / params.subnets_;
+        while ((1ULL << bits_) < 4ULL * per_subnet) {
+            ++bits_;
+        }
+        if ((static_cast<uint64_t>(params.subnets_) << bits_) > (1ULL << 23)) {
+            isc_throw(BadValue, "too many subnets or clients for the 10.128.0.0/9"
+                      " benchmark address space");
+        }
+    }
+
+    /// @brief Returns the first address of a subnet.
+    uint32_t base(uint32_t subnet) const {
+        return (SUBNETS_BASE + (subnet << bits_));
+    }
+
+    /// @brief Returns the relay address of a subnet.
+    uint32_t relay(uint32_t subnet) const {
+        return (base(subnet) + 1);
+    }
+
+    /// @brief Returns the first address of the pool.
+    uint32_t poolStart(uint32_t subnet) const {
+        return (base(subnet) + 2);
+    }
+
+    /// @brief Returns the last address of the pool.
+    uint32_t poolEnd(uint32_t subnet) const {
+        return (base(subnet) + (1U << (bits_ - 1)) - 1);
+    }
+
+    /// @brief Returns the reserved address of the nth client of a subnet.
+    uint32_t reserved(uint32_t subnet, uint32_t nth) const {
+        return (base(subnet) + (1U << (bits_ - 1)) + nth);
+    }
+
+    /// @brief Number of host bits of the subnets.
+    unsigned bits_;
+};
+
+/// @brief Returns the MAC address of a client.
+///
+/// @param client client index.
+/// @param prefix first byte, distinguishing the simulated clients from
+/// the owners of the pre-existing leases.
+HWAddrPtr
+makeHWAddr(uint32_t client, uint8_t prefix = 0x0a) {
+    vector<uint8_t> mac = { prefix, 0x00,
+                            static_cast<uint8_t>(client >> 24),
+                            static_cast<uint8_t>(client >> 16),
+                            static_cast<uint8_t>(client >> 8),
+                            static_cast<uint8_t>(client) };
+    return (boost::make_shared<HWAddr>(mac, HTYPE_ETHER));
+}
+
+/// @brief Returns the server configuration.
+///
+/// @param params benchmark parameters.
+/// @param layout subnets addressing.
+ElementPtr
+makeConfig(const BenchmarkParams& params, const Layout& layout) {
+    ostringstream s;
+    s << "{"
+      << " \"interfaces-config\": { \"interfaces\": [ \"*\" ], \"re-detect\": false },"
+      << " \"lease-database\": { \"type\": \"memfile\", \"persist\": false },"
+      << " \"host-reservation-identifiers\": [ \"hw-address\" ],"
+      << " \"valid-lifetime\": 4000,"
+      << " \"allocator\": \"" << params.allocator_ << "\","
+      << " \"multi-threading\": {"
+      << "   \"enable-multi-threading\": " << (params.threads_ ? "true" : "false") << ","
+      << "   \"thread-pool-size\": " << params.threads_ << ","
+      << "   \"packet-queue-size\": 0 },"
+      << " \"subnet4\": [";
+    for (uint32_t subnet = 0; subnet < params.subnets_; ++subnet) {
+        s << (subnet ? "," : "")
+          << " { \"id\": " << subnet + 1 << ","
+          << " \"subnet\": \"" << IOAddress(layout.base(subnet)) << "/"
+          << 32 - layout.bits_ << "\","
+          << " \"pools\": [ { \"pool\": \"" << IOAddress(layout.poolStart(subnet))
+          << " - " << IOAddress(layout.poolEnd(subnet)) << "\" } ],"
+          << " \"reservations\": [";
+        bool first = true;
+        for (uint32_t client = subnet; client < params.reservations_;
+             client += params.subnets_) {
+            s << (first ? "" : ",")
+              << " { \"hw-address\": \"" << makeHWAddr(client)->toText(false) << "\","
+              << " \"ip-address\": \""
+              << IOAddress(layout.reserved(subnet, client / params.subnets_))
+              << "\" }";
+            first = false;
+        }
+        s << " ] }";
+    }
+    s << " ] }";
+    return (Element::fromJSON(s.str()));
+}
+
+/// @brief Stores the leases of other clients from the top of the pools.
+///
+/// @param params benchmark parameters.
+/// @param layout subnets addressing.
+void
+addLeases(const BenchmarkParams& params, const Layout& layout) {
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    for (uint32_t i = 0; i < params.leases_; ++i) {
+        uint32_t subnet = i % params.subnets_;
+        IOAddress address(layout.poolEnd(subnet) - i / params.subnets_);
+        Lease4Ptr lease(new Lease4(address, makeHWAddr(i, 0x0b), ClientIdPtr(),
+                                   4000, time(0), subnet + 1));
+        lease_mgr.addLease(lease);
+    }
+}
+
+/// @brief Converts a query to wire data and parses it back as received.
+///
+/// @param query the query to convert.
+/// @param remote remote address of the received packet.
+/// @return the received packet, not yet unpacked.
+Pkt4Ptr
+toWire(const Pkt4Ptr& query, const IOAddress& remote) {
+    query->pack();
+    Pkt4Ptr received(new Pkt4(static_cast<const uint8_t*>(query->getBuffer().getData()),
+                              query->getBuffer().getLength()));
+    received->setRemoteAddr(remote);
+    received->setLocalAddr(SERVER_ADDRESS);
+    received->setIface("eth0");
+    received->setIndex(ETH0_INDEX);
+    return (received);
+}
+
+/// @brief Creates a relayed query of a client.
+///
+/// @param type message type.
+/// @param client client index.
+/// @param params benchmark parameters.
+/// @param layout subnets addressing.
+Pkt4Ptr
+makeRelayedQuery(uint8_t type, uint32_t client, const BenchmarkParams& params,
+                 const Layout& layout) {
+    Pkt4Ptr query(new Pkt4(type, client + 1));
+    query->setHWAddr(makeHWAddr(client));
+    IOAddress relay(layout.relay(client % params.subnets_));
+    query->setGiaddr(relay);
+    query->setHops(1);
+    return (query);
+}
+
+/// @brief Runs a phase processing one query per client.
+///
+/// @param srv the server.
+/// @param phase the phase recording the latencies.
+/// @param queries queries to process.
+/// @param responses responses of the queries.
+void
+runPhase(Dhcpv4Srv& srv, BenchmarkPhase& phase, vector<Pkt4Ptr>& queries,
+         vector<Pkt4Ptr>& responses) {
+    responses.assign(queries.size(), Pkt4Ptr());
+    auto process = [&srv, &phase, &queries, &responses](size_t i) {
+        auto start = BenchmarkPhase::Clock::now();
+        Pkt4Ptr rsp;
+        try {
+            srv.processPacket(queries[i], rsp, false);
+        } catch (...) {
+            // Missing responses are reported.
+        }
+        phase.record(i, BenchmarkPhase::Clock::now() - start);
+        responses[i] = rsp;
+    };
+    phase.start();
+    if (MultiThreadingMgr::instance().getMode()) {
+        typedef function<void()> CallBack;
+        auto& thread_pool = MultiThreadingMgr::instance().getThreadPool();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            thread_pool.add(boost::make_shared<CallBack>(std::bind(process, i)), i);
+        }
+        thread_pool.wait();
+    } else {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            process(i);
+        }
+    }
+    phase.stop();
+}
+
+/// @brief Counts the responses of the expected type.
+///
+/// @param responses responses of a phase.
+/// @param type expected message type.
+size_t
+countResponses(const vector<Pkt4Ptr>& responses, uint8_t type) {
+    size_t count = 0;
+    for (auto const& rsp : responses) {
+        if (rsp && (rsp->getType() == type)) {
+            ++count;
+        }
+    }
+    return (count);
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    BenchmarkParams params;
+    if (!parseBenchmarkParams("dhcp4_benchmark", argc, argv, params)) {
+        return (EXIT_FAILURE);
+    }
+    isc::log::initLogger("dhcp4_benchmark", isc::log::WARN);
+
+    try {
+        Layout layout(params);
+        IfaceMgrTestConfig iface_config(true);
+        Dhcpv4Srv srv(0);
+
+        ConstElementPtr answer = configureDhcp4Server(srv, makeConfig(params, layout));
+        int rcode;
+        ConstElementPtr comment = config::parseAnswer(rcode, answer);
+        if (rcode != 0) {
+            isc_throw(Unexpected, "configuration failed: " << comment->str());
+        }
+        auto cfg_db = CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+        cfg_db->setAppendedParameters("universe=4");
+        cfg_db->createManagers();
+        addLeases(params, layout);
+        CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->initAllocatorsAfterConfigure();
+        CfgMultiThreading::apply(CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading());
+        CfgMgr::instance().commit();
+
+        printBenchmarkParams(cout, params);
+
+        vector<Pkt4Ptr> queries(params.clients_);
+        vector<Pkt4Ptr> offers;
+        vector<Pkt4Ptr> acks;
+        vector<Pkt4Ptr> renew_acks;
+        int status = EXIT_SUCCESS;
+
+        // DISCOVER phase.
+        for (uint32_t client = 0; client < params.clients_; ++client) {
+            auto query = makeRelayedQuery(DHCPDISCOVER, client, params, layout);
+            queries[client] = toWire(query, query->getGiaddr());
+        }
+        BenchmarkPhase discover("DISCOVER", params.clients_);
+        runPhase(srv, discover, queries, offers);
+        discover.report(cout);
+
+        // REQUEST phase selecting the offered addresses.
+        for (uint32_t client = 0; client < params.clients_; ++client) {
+            auto query = makeRelayedQuery(DHCPREQUEST, client, params, layout);
+            auto const& offer = offers[client];
+            if (offer && (offer->getType() == DHCPOFFER)) {
+                query->addOption(OptionPtr(new Option4AddrLst(DHO_DHCP_REQUESTED_ADDRESS,
+                                                              offer->getYiaddr())));
+                OptionPtr server_id = offer->getOption(DHO_DHCP_SERVER_IDENTIFIER);
+                if (server_id) {
+                    query->addOption(server_id);
+                }
+            }
+            queries[client] = toWire(query, query->getGiaddr());
+        }
+        BenchmarkPhase request("REQUEST", params.clients_);
+        runPhase(srv, request, queries, acks);
+        request.report(cout);
+
+        // RENEW phase unicast by the clients.
+        for (uint32_t client = 0; client < params.clients_; ++client) {
+            Pkt4Ptr query(new Pkt4(DHCPREQUEST, client + 1));
+            query->setHWAddr(makeHWAddr(client));
+            IOAddress ciaddr = IOAddress::IPV4_ZERO_ADDRESS();
+            if (acks[client] && (acks[client]->getType() == DHCPACK)) {
+                ciaddr = acks[client]->getYiaddr();
+            }
+            query->setCiaddr(ciaddr);
+            queries[client] = toWire(query, ciaddr);
+        }
+        BenchmarkPhase renew("RENEW", params.clients_);
+        runPhase(srv, renew, queries, renew_acks);
+        renew.report(cout);
+
+        size_t count = countResponses(offers, DHCPOFFER);
+        if (count != params.clients_) {
+            cout << "missing OFFERs: " << params.clients_ - count << endl;
+            status = EXIT_FAILURE;
+        }
+        count = countResponses(acks, DHCPACK);
+        if (count != params.clients_) {
+            cout << "missing ACKs: " << params.clients_ - count << endl;
+            status = EXIT_FAILURE;
+        }
+        count = countResponses(renew_acks, DHCPACK);
+        if (count != params.clients_) {
+            cout << "missing RENEW ACKs: " << params.clients_ - count << endl;
+            status = EXIT_FAILURE;
+        }
+
+        MultiThreadingMgr::instance().apply(false, 0, 0);
+        LeaseMgrFactory::destroy();
+        return (status);
+
+    } catch (const exception& ex) {
+        MultiThreadingMgr::instance().apply(false, 0, 0);
+        cerr << "benchmark failed: " << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+}
@@ -10,6 +10,7 @@
 #include <cc/command_interpreter.h>
 #include <config/command_mgr.h>
 #include <config_backend/base_config_backend.h>
+#include <dhcp4/client_handler.h>
 #include <dhcp4/dhcp4_log.h>
 #include <dhcp4/dhcp4_srv.h>
 #include <dhcp4/json_config_parser.h>
@@ -35,6 +36,7 @@
 #include <stats/stats_mgr.h>
 #include <testutils/gtest_utils.h>
 #include <util/encode/hex.h>
+#include <util/multi_threading_mgr.h>
 
 #ifdef HAVE_MYSQL
 #include <mysql/testutils/mysql_schema.h>
@@ -2457,6 +2459,107 @@ TEST_F(Dhcpv4SrvTest, buildCfgOptionsList) {
         // Server id should be global value as lease is from subnet2's second pool.
         buildCfgOptionTest(IOAddress("10.0.0.254"), query, IOAddress("192.0.2.201"), IOAddress("10.0.0.254"));
     }
+
+    {
+        SCOPED_TRACE("Cached pool value");
+
+        // The lists built so far are cached: the pool one is reused.
+        OptionListCachePtr cache =
+            CfgMgr::instance().getCurrentCfg()->getOptionListCache();
+        size_t cached = cache->size();
+        EXPECT_LT(0, cached);
+        buildCfgOptionTest(IOAddress("192.0.2.254"), query, IOAddress("192.0.2.101"), IOAddress("192.0.2.254"));
+        EXPECT_EQ(cached, cache->size());
+    }
+}
+
+// Verifies that the client affinity key is computed from the hardware
+// address only.
+TEST_F(Dhcpv4SrvTest, getClientAffinityKey) {
+    // Returns the query as received from the wire.
+    auto received = [](uint8_t type, const OptionPtr& clientid,
+                       const HWAddrPtr& hwaddr) {
+        Pkt4Ptr query(new Pkt4(type, 1234));
+        if (clientid) {
+            query->addOption(clientid);
+        }
+        query->setHWAddr(hwaddr);
+        query->pack();
+        const OutputBuffer& buf = query->getBuffer();
+        return (Pkt4Ptr(new Pkt4(static_cast<const uint8_t*>(buf.getData()),
+                                 buf.getLength())));
+    };
+
+    OptionPtr clientid1(new Option(Option::V4, DHO_DHCP_CLIENT_IDENTIFIER,
+                                   OptionBuffer(8, 1)));
+    OptionPtr clientid2(new Option(Option::V4, DHO_DHCP_CLIENT_IDENTIFIER,
+                                   OptionBuffer(8, 2)));
+    HWAddrPtr hwaddr1(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+    HWAddrPtr hwaddr2(new HWAddr(std::vector<uint8_t>(6, 2), HTYPE_ETHER));
+
+    // The queries of a client get the same key with or without client
+    // identifier.
+    size_t key = Dhcpv4Srv::getClientAffinityKey(received(DHCPDISCOVER,
+                                                          OptionPtr(), hwaddr1));
+    EXPECT_EQ(key, Dhcpv4Srv::getClientAffinityKey(received(DHCPREQUEST,
+                                                            clientid1, hwaddr1)));
+    EXPECT_EQ(key, Dhcpv4Srv::getClientAffinityKey(received(DHCPREQUEST,
+                                                            clientid2, hwaddr1)));
+
+    // Another hardware address gets another key even with the same client
+    // identifier.
+    EXPECT_NE(key, Dhcpv4Srv::getClientAffinityKey(received(DHCPDISCOVER,
+                                                            OptionPtr(),
+                                                            hwaddr2)));
+    EXPECT_NE(key, Dhcpv4Srv::getClientAffinityKey(received(DHCPREQUEST,
+                                                            clientid1, hwaddr2)));
+}
+
+// Verifies that in client affinity mode a query is not postponed while
+// another query of the same client is processed, as the queries of a
+// client are processed in sequence by the same thread.
+TEST_F(Dhcpv4SrvTest, clientAffinityNoDuplicateCheck) {
+    IfaceMgrTestConfig test_config(true);
+    IfaceMgr::instance().openSockets4();
+    NakedDhcpv4Srv srv(0);
+
+    // Returns a relayed discover of the client as received from the wire.
+    auto received = []() {
+        Pkt4Ptr query(new Pkt4(DHCPDISCOVER, 1234));
+        HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+        query->setHWAddr(hwaddr);
+        query->setGiaddr(IOAddress("192.0.2.10"));
+        query->setHops(1);
+        query->pack();
+        const OutputBuffer& buf = query->getBuffer();
+        Pkt4Ptr pkt(new Pkt4(static_cast<const uint8_t*>(buf.getData()),
+                             buf.getLength()));
+        pkt->setRemoteAddr(IOAddress("192.0.2.10"));
+        pkt->setIface("eth0");
+        pkt->setIndex(ETH0_INDEX);
+        return (pkt);
+    };
+    Pkt4Ptr first = received();
+    Pkt4Ptr second = received();
+    ASSERT_NO_THROW(first->unpack());
+    ASSERT_NO_THROW(second->unpack());
+
+    // The first query is being processed.
+    ClientHandler client_handler;
+    MultiThreadingMgr::instance().apply(true, 1, 0);
+    ASSERT_TRUE(client_handler.tryLock(first));
+
+    // Without client affinity the second query is postponed.
+    Pkt4Ptr rsp;
+    srv.processDhcp4Query(second, rsp, false);
+    EXPECT_FALSE(rsp);
+    MultiThreadingMgr::instance().apply(false, 0, 0);
+
+    // In client affinity mode it is answered.
+    MultiThreadingMgr::instance().apply(true, 1, 0, true);
+    srv.processDhcp4Query(second, rsp, false);
+    EXPECT_TRUE(rsp);
+    MultiThreadingMgr::instance().apply(false, 0, 0);
 }
 
 // This test verifies that the logic which matches server identifier in the
@@ -359,6 +359,16 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     return isc::dhcp::Dhcp6Parser::make_STRING(tmp, driver.loc_);
 }
 
+(?i:\"BINARY\") {
+    /* dhcp-ddns value keywords are case insensitive */
+    if (driver.ctx_ == isc::dhcp::Parser6Context::NCR_FORMAT) {
+        return isc::dhcp::Dhcp6Parser::make_BINARY(driver.loc_);
+    }
+    std::string tmp(yytext+1);
+    tmp.resize(tmp.size() - 1);
+    return isc::dhcp::Dhcp6Parser::make_STRING(tmp, driver.loc_);
+}
+
 (?i:\"when-present\") {
     /* dhcp-ddns value keywords are case insensitive */
     if (driver.ctx_ == isc::dhcp::Parser6Context::REPLACE_CLIENT_NAME) {
@@ -697,6 +707,33 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"write-behind\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_WRITE_BEHIND(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("write-behind", driver.loc_);
+    }
+}
+
+\"write-behind-interval\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_WRITE_BEHIND_INTERVAL(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("write-behind-interval", driver.loc_);
+    }
+}
+
+\"write-behind-sync\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::LEASE_DATABASE:
+        return isc::dhcp::Dhcp6Parser::make_WRITE_BEHIND_SYNC(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("write-behind-sync", driver.loc_);
+    }
+}
+
 \"connect-timeout\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::LEASE_DATABASE:
@@ -2044,6 +2081,15 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"client-affinity\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DHCP_MULTI_THREADING:
+        return isc::dhcp::Dhcp6Parser::make_CLIENT_AFFINITY(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("client-affinity", driver.loc_);
+    }
+}
+
 \"control-socket\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::DHCP6:
@@ -2143,6 +2189,24 @@ ControlCharacterFill            [^"\\]|\\["\\/bfnrtu]
     }
 }
 
+\"host-cache-max-entries\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DHCP6:
+        return isc::dhcp::Dhcp6Parser::make_HOST_CACHE_MAX_ENTRIES(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("host-cache-max-entries", driver.loc_);
+    }
+}
+
+\"host-cache-ttl\" {
+    switch(driver.ctx_) {
+    case isc::dhcp::Parser6Context::DHCP6:
+        return isc::dhcp::Dhcp6Parser::make_HOST_CACHE_TTL(driver.loc_);
+    default:
+        return isc::dhcp::Dhcp6Parser::make_STRING("host-cache-ttl", driver.loc_);
+    }
+}
+
 \"compatibility\" {
     switch(driver.ctx_) {
     case isc::dhcp::Parser6Context::DHCP6:
@@ -81,6 +81,9 @@ using namespace std;
   PORT "port"
   PERSIST "persist"
   LFC_INTERVAL "lfc-interval"
+  WRITE_BEHIND "write-behind"
+  WRITE_BEHIND_INTERVAL "write-behind-interval"
+  WRITE_BEHIND_SYNC "write-behind-sync"
   READONLY "readonly"
   CONNECT_TIMEOUT "connect-timeout"
   READ_TIMEOUT "read-timeout"
@@ -222,6 +225,7 @@ using namespace std;
   ENABLE_MULTI_THREADING "enable-multi-threading"
   THREAD_POOL_SIZE "thread-pool-size"
   PACKET_QUEUE_SIZE "packet-queue-size"
+  CLIENT_AFFINITY "client-affinity"
 
   CONTROL_SOCKET "control-socket"
   SOCKET_TYPE "socket-type"
@@ -249,6 +253,7 @@ using namespace std;
   UDP "UDP"
   TCP "TCP"
   JSON "JSON"
+  BINARY "BINARY"
   WHEN_PRESENT "when-present"
   NEVER "never"
   ALWAYS "always"
@@ -258,6 +263,8 @@ using namespace std;
   EARLY_GLOBAL_RESERVATIONS_LOOKUP "early-global-reservations-lookup"
   IP_RESERVATIONS_UNIQUE "ip-reservations-unique"
   RESERVATIONS_LOOKUP_FIRST "reservations-lookup-first"
+  HOST_CACHE_MAX_ENTRIES "host-cache-max-entries"
+  HOST_CACHE_TTL "host-cache-ttl"
 
   LOGGERS "loggers"
   OUTPUT_OPTIONS "output_options"
@@ -302,6 +309,7 @@ using namespace std;
 %type <ElementPtr> hr_mode
 %type <ElementPtr> duid_type
 %type <ElementPtr> ncr_protocol_value
+%type <ElementPtr> ncr_format_value
 %type <ElementPtr> ddns_replace_client_name_value
 
 %printer { yyoutput << $$; } <*>;
@@ -564,6 +572,8 @@ global_param: data_directory
             | early_global_reservations_lookup
             | ip_reservations_unique
             | reservations_lookup_first
+            | host_cache_max_entries
+            | host_cache_ttl
             | compatibility
             | parked_packet_limit
             | allocator
@@ -832,6 +842,18 @@ reservations_lookup_first: RESERVATIONS_LOOKUP_FIRST COLON BOOLEAN {
     ctx.stack_.back()->set("reservations-lookup-first", first);
 };
 
+host_cache_max_entries: HOST_CACHE_MAX_ENTRIES COLON INTEGER {
+    ctx.unique("host-cache-max-entries", ctx.loc2pos(@1));
+    ElementPtr max(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("host-cache-max-entries", max);
+};
+
+host_cache_ttl: HOST_CACHE_TTL COLON INTEGER {
+    ctx.unique("host-cache-ttl", ctx.loc2pos(@1));
+    ElementPtr ttl(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("host-cache-ttl", ttl);
+};
+
 interfaces_config: INTERFACES_CONFIG {
     ctx.unique("interfaces-config", ctx.loc2pos(@1));
     ElementPtr i(new MapElement(ctx.loc2pos(@1)));
@@ -978,6 +1000,9 @@ database_map_param: database_type
                   | name
                   | persist
                   | lfc_interval
+                  | write_behind
+                  | write_behind_interval
+                  | write_behind_sync
                   | readonly
                   | connect_timeout
                   | read_timeout
@@ -1061,6 +1086,24 @@ lfc_interval: LFC_INTERVAL COLON INTEGER {
     ctx.stack_.back()->set("lfc-interval", n);
 };
 
+write_behind: WRITE_BEHIND COLON BOOLEAN {
+    ctx.unique("write-behind", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-behind", n);
+};
+
+write_behind_interval: WRITE_BEHIND_INTERVAL COLON INTEGER {
+    ctx.unique("write-behind-interval", ctx.loc2pos(@1));
+    ElementPtr n(new IntElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-behind-interval", n);
+};
+
+write_behind_sync: WRITE_BEHIND_SYNC COLON BOOLEAN {
+    ctx.unique("write-behind-sync", ctx.loc2pos(@1));
+    ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("write-behind-sync", n);
+};
+
 readonly: READONLY COLON BOOLEAN {
     ctx.unique("readonly", ctx.loc2pos(@1));
     ElementPtr n(new BoolElement($3, ctx.loc2pos(@3)));
@@ -1321,6 +1364,7 @@ multi_threading_params: multi_threading_param
 multi_threading_param: enable_multi_threading
                      | thread_pool_size
                      | packet_queue_size
+                     | client_affinity
                      | user_context
                      | comment
                      | unknown_map_entry
@@ -1344,6 +1388,12 @@ packet_queue_size: PACKET_QUEUE_SIZE COLON INTEGER {
     ctx.stack_.back()->set("packet-queue-size", prf);
 };
 
+client_affinity: CLIENT_AFFINITY COLON BOOLEAN {
+    ctx.unique("client-affinity", ctx.loc2pos(@1));
+    ElementPtr b(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("client-affinity", b);
+};
+
 hooks_libraries: HOOKS_LIBRARIES {
     ctx.unique("hooks-libraries", ctx.loc2pos(@1));
     ElementPtr l(new ListElement(ctx.loc2pos(@1)));
@@ -2829,12 +2879,16 @@ ncr_protocol_value:
 ncr_format: NCR_FORMAT {
     ctx.unique("ncr-format", ctx.loc2pos(@1));
     ctx.enter(ctx.NCR_FORMAT);
-} COLON JSON {
-    ElementPtr json(new StringElement("JSON", ctx.loc2pos(@4)));
-    ctx.stack_.back()->set("ncr-format", json);
+} COLON ncr_format_value {
+    ctx.stack_.back()->set("ncr-format", $4);
     ctx.leave();
 };
 
+ncr_format_value:
+    JSON { $$ = ElementPtr(new StringElement("JSON", ctx.loc2pos(@1))); }
+  | BINARY { $$ = ElementPtr(new StringElement("BINARY", ctx.loc2pos(@1))); }
+  ;
+
 // Deprecated, moved to global/network scopes. Eventually it should be removed.
 dep_override_no_update: OVERRIDE_NO_UPDATE COLON BOOLEAN {
     ctx.unique("override-no-update", ctx.loc2pos(@1));
@@ -49,6 +49,7 @@
 #include <stats/stats_mgr.h>
 #include <util/encode/hex.h>
 #include <util/io_utilities.h>
+#include <util/memory_pool.h>
 #include <util/pointer_util.h>
 #include <util/range_utilities.h>
 #include <log/logger.h>
@@ -64,6 +65,7 @@
 #include <dhcpsrv/memfile_lease_mgr.h>
 
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string/erase.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -693,7 +695,8 @@ void Dhcpv6Srv::run_one() {
             boost::shared_ptr<CallBack> call_back =
                 boost::make_shared<CallBack>(std::bind(&Dhcpv6Srv::processPacketAndSendResponseNoThrow,
                                                        this, query));
-            if (!MultiThreadingMgr::instance().getThreadPool().add(call_back)) {
+            if (!MultiThreadingMgr::instance().getThreadPool().add(call_back,
+                                                                   getClientAffinityKey(query))) {
                 LOG_DEBUG(dhcp6_logger, DBG_DHCP6_BASIC, DHCP6_PACKET_QUEUE_FULL);
             }
         } else {
@@ -702,6 +705,43 @@ void Dhcpv6Srv::run_one() {
     }
 }
 
+size_t
+Dhcpv6Srv::getClientAffinityKey(const Pkt6Ptr& query) {
+    const OptionBuffer& data = query->data_;
+    size_t offset = 0;
+    size_t end = data.size();
+    while (offset < end) {
+        // Search the client identifier in the options of the message or
+        // the relayed message in the options of a relay-forward message.
+        bool relay = (data[offset] == DHCPV6_RELAY_FORW);
+        offset += (relay ? Pkt6::DHCPV6_RELAY_HDR_LEN : Pkt6::DHCPV6_PKT_HDR_LEN);
+        bool relayed = false;
+        while (offset + 4 <= end) {
+            uint16_t code = readUint16(&data[offset], 2);
+            size_t len = readUint16(&data[offset + 2], 2);
+            offset += 4;
+            if (offset + len > end) {
+                break;
+            }
+            if (relay && (code == D6O_RELAY_MSG)) {
+                end = offset + len;
+                relayed = true;
+                break;
+            }
+            if (!relay && (code == D6O_CLIENTID) && (len > 0)) {
+                return (boost::hash_range(data.cbegin() + offset,
+                                          data.cbegin() + offset + len));
+            }
+            offset += len;
+        }
+        if (!relayed) {
+            break;
+        }
+    }
+    // No client identifier: spread the query.
+    return (boost::hash_range(data.cbegin(), data.cend()));
+}
+
 void
 Dhcpv6Srv::processPacketAndSendResponseNoThrow(Pkt6Ptr& query) {
     try {
@@ -929,7 +969,10 @@ Dhcpv6Srv::processDhcp6Query(Pkt6Ptr& query, Pkt6Ptr& rsp) {
     ClientHandler client_handler;
 
     // Check for lease modifier queries from the same client being processed.
+    // In client affinity mode they are processed in sequence by the same
+    // thread so there is nothing to check.
     if (MultiThreadingMgr::instance().getMode() &&
+        !MultiThreadingMgr::instance().getClientAffinity() &&
         ((query->getType() == DHCPV6_SOLICIT) ||
          (query->getType() == DHCPV6_REQUEST) ||
          (query->getType() == DHCPV6_RENEW) ||
@@ -3472,7 +3515,7 @@ Pkt6Ptr
 Dhcpv6Srv::processSolicit(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr solicit = ctx.query_;
-    Pkt6Ptr response(new Pkt6(DHCPV6_ADVERTISE, solicit->getTransid()));
+    Pkt6Ptr response = makePooled<Pkt6>(DHCPV6_ADVERTISE, solicit->getTransid());
 
     // Handle Rapid Commit option, if present.
     if (ctx.subnet_ && ctx.subnet_->getRapidCommit()) {
@@ -3538,7 +3581,7 @@ Pkt6Ptr
 Dhcpv6Srv::processRequest(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr request = ctx.query_;
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, request->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, request->getTransid());
 
     processClientFqdn(request, reply, ctx);
 
@@ -3572,7 +3615,7 @@ Pkt6Ptr
 Dhcpv6Srv::processRenew(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr renew = ctx.query_;
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, renew->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, renew->getTransid());
 
     processClientFqdn(renew, reply, ctx);
 
@@ -3606,7 +3649,7 @@ Pkt6Ptr
 Dhcpv6Srv::processRebind(AllocEngine::ClientContext6& ctx) {
 
     Pkt6Ptr rebind = ctx.query_;
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, rebind->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, rebind->getTransid());
 
     processClientFqdn(rebind, reply, ctx);
 
@@ -3651,7 +3694,7 @@ Dhcpv6Srv::processConfirm(AllocEngine::ClientContext6& ctx) {
     }
 
     // The server sends Reply message in response to Confirm.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, confirm->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, confirm->getTransid());
     // Make sure that the necessary options are included.
     copyClientOptions(confirm, reply);
     CfgOptionList co_list;
@@ -3734,7 +3777,7 @@ Dhcpv6Srv::processRelease(AllocEngine::ClientContext6& ctx) {
     requiredClassify(release, ctx);
 
     // Create an empty Reply message.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, release->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, release->getTransid());
 
     // Copy client options (client-id, also relay information if present)
     copyClientOptions(release, reply);
@@ -3760,7 +3803,7 @@ Dhcpv6Srv::processDecline(AllocEngine::ClientContext6& ctx) {
     requiredClassify(decline, ctx);
 
     // Create an empty Reply message.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, decline->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, decline->getTransid());
 
     // Copy client options (client-id, also relay information if present)
     copyClientOptions(decline, reply);
@@ -4065,7 +4108,7 @@ Dhcpv6Srv::processInfRequest(AllocEngine::ClientContext6& ctx) {
     requiredClassify(inf_request, ctx);
 
     // Create a Reply packet, with the same trans-id as the client's.
-    Pkt6Ptr reply(new Pkt6(DHCPV6_REPLY, inf_request->getTransid()));
+    Pkt6Ptr reply = makePooled<Pkt6>(DHCPV6_REPLY, inf_request->getTransid());
 
     // Copy client options (client-id, also relay information if present)
     copyClientOptions(inf_request, reply);
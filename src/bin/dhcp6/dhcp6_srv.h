@@ -1140,6 +1140,17 @@ public:
     /// @param response packet transmitted
     static void processStatsSent(const Pkt6Ptr& response);
 
+    /// @brief Returns the key selecting the thread processing a query in
+    /// client affinity mode.
+    ///
+    /// The key is a hash of the client identifier found in the innermost
+    /// relayed message. It is computed from the wire data as the query is
+    /// not unpacked yet.
+    ///
+    /// @param query packet received
+    /// @return the client affinity key
+    static size_t getClientAffinityKey(const Pkt6Ptr& query);
+
     /// @brief Returns the index of the buffer6_send hook
     /// @return the index of the buffer6_send hook
     static int getHookIndexBuffer6Send();
@@ -0,0 +1,407 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file dhcp6_benchmark.cc
+///
+/// In-process benchmark of the DHCPv6 server packet processing. The server
+/// runs on the fake interfaces of the @c IfaceMgrTestConfig so no socket is
+/// opened: the pre-generated relayed SOLICIT, REQUEST and RENEW streams are
+/// handed to @c Dhcpv6Srv::processPacket directly (or through the thread
+/// pool when multi-threading is enabled) and the leases are stored in
+/// memfile. Build and run it with "make benchmark".
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <cc/data.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/duid.h>
+#include <dhcp/option6_ia.h>
+#include <dhcp/option6_iaaddr.h>
+#include <dhcp/pkt6.h>
+#include <dhcp/tests/iface_mgr_test_config.h>
+#include <dhcp6/dhcp6_srv.h>
+#include <dhcp6/json_config_parser.h>
+#include <dhcpsrv/cfg_multi_threading.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <log/logger_support.h>
+#include <testutils/benchmark_utils.h>
+#include <util/multi_threading_mgr.h>
+
+#include <boost/make_shared.hpp>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+using namespace isc::test;
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Address of the fake interface the packets are received on.
+const IOAddress SERVER_ADDRESS("fe80::3a60:77ff:fed5:cdef");
+
+/// @brief IAID used by all clients.
+const uint32_t IAID = 1;
+
+/// @brief Describes the addressing of the simulated subnets.
+///
+/// The subnets are 3000:0:0:<subnet>::/64. The relay uses the first
+/// address, the pool starts at ::1:0:0 and the reserved addresses at
+/// ::2:0:0 so they are outside of the pool.
+struct Layout {
+    /// @brief Constructor.
+    ///
+    /// @param params benchmark parameters.
+    explicit Layout(const BenchmarkParams& params) : bits_(8) {
+        if (params.subnets_ > 0xffff) {
+            isc_throw(BadValue, "too many subnets, the maximum is 65535");
+        }
+        uint32_t per_subnet = (params.clients_ + params.leases_ +
+                               params.subnets_ - 1) / params.subnets_;
+        while ((1ULL << bits_) < 4ULL * per_subnet) {
+            ++bits_;
+        }
+        if (bits_ > 32) {
+            isc_throw(BadValue, "too many clients per subnet");
+        }
+    }
+
+    /// @brief Returns an address of a subnet.
+    ///
+    /// @param subnet subnet index.
+    /// @param low the interface identifier.
+    static IOAddress address(uint32_t subnet, uint64_t low) {
+        uint8_t bytes[V6ADDRESS_LEN] = { 0x30, 0x00, 0, 0, 0, 0,
+                                         static_cast<uint8_t>(subnet >> 8),
+                                         static_cast<uint8_t>(subnet) };
+        for (int i = V6ADDRESS_LEN - 1; i >= 8; --i) {
+            bytes[i] = static_cast<uint8_t>(low);
+            low >>= 8;
+        }
+        return (IOAddress::fromBytes(AF_INET6, bytes));
+    }
+
+    /// @brief Returns the relay link address of a subnet.
+    IOAddress relay(uint32_t subnet) const {
+        return (address(subnet, 1));
+    }
+
+    /// @brief Returns the first address of the pool.
+    IOAddress poolStart(uint32_t subnet) const {
+        return (address(subnet, 1ULL << 32));
+    }
+
+    /// @brief Returns the nth address from the end of the pool.
+    IOAddress poolEnd(uint32_t subnet, uint32_t nth = 0) const {
+        return (address(subnet, (1ULL << 32) + (1ULL << bits_) - 1 - nth));
+    }
+
+    /// @brief Returns the reserved address of the nth client of a subnet.
+    IOAddress reserved(uint32_t subnet, uint32_t nth) const {
+        return (address(subnet, (2ULL << 32) + nth));
+    }
+
+    /// @brief Number of addresses of the pool as a power of two.
+    unsigned bits_;
+};
+
+/// @brief Returns the DUID of a client.
+///
+/// The DUIDs are DUID-LL built from a MAC address.
+///
+/// @param client client index.
+/// @param prefix first byte of the MAC address, distinguishing the
+/// simulated clients from the owners of the pre-existing leases.
+DuidPtr
+makeDuid(uint32_t client, uint8_t prefix = 0x0a) {
+    vector<uint8_t> duid = { 0x00, 0x03, 0x00, 0x01, prefix, 0x00,
+                             static_cast<uint8_t>(client >> 24),
+                             static_cast<uint8_t>(client >> 16),
+                             static_cast<uint8_t>(client >> 8),
+                             static_cast<uint8_t>(client) };
+    return (boost::make_shared<DUID>(duid));
+}
+
+/// @brief Returns the server configuration.
+///
+/// @param params benchmark parameters.
+/// @param layout subnets addressing.
+ElementPtr
+makeConfig(const BenchmarkParams& params, const Layout& layout) {
+    ostringstream s;
+    s << "{"
+      << " \"interfaces-config\": { \"interfaces\": [ \"*\" ], \"re-detect\": false },"
+      << " \"lease-database\": { \"type\": \"memfile\", \"persist\": false },"
+      << " \"host-reservation-identifiers\": [ \"duid\" ],"
+      << " \"preferred-lifetime\": 3000,"
+      << " \"valid-lifetime\": 4000,"
+      << " \"allocator\": \"" << params.allocator_ << "\","
+      << " \"multi-threading\": {"
+      << "   \"enable-multi-threading\": " << (params.threads_ ? "true" : "false") << ","
+      << "   \"thread-pool-size\": " << params.threads_ << ","
+      << "   \"packet-queue-size\": 0 },"
+      << " \"subnet6\": [";
+    for (uint32_t subnet = 0; subnet < params.subnets_; ++subnet) {
+        s << (subnet ? "," : "")
+          << " { \"id\": " << subnet + 1 << ","
+          << " \"subnet\": \"" << Layout::address(subnet, 0) << "/64\","
+          << " \"pools\": [ { \"pool\": \"" << layout.poolStart(subnet)
+          << "/" << 128 - layout.bits_ << "\" } ],"
+          << " \"reservations\": [";
+        bool first = true;
+        for (uint32_t client = subnet; client < params.reservations_;
+             client += params.subnets_) {
+            s << (first ? "" : ",")
+              << " { \"duid\": \"" << makeDuid(client)->toText() << "\","
+              << " \"ip-addresses\": [ \""
+              << layout.reserved(subnet, client / params.subnets_)
+              << "\" ] }";
+            first = false;
+        }
+        s << " ] }";
+    }
+    s << " ] }";
+    return (Element::fromJSON(s.str()));
+}
+
+/// @brief Stores the leases of other clients from the end of the pools.
+///
+/// @param params benchmark parameters.
+/// @param layout subnets addressing.
+void
+addLeases(const BenchmarkParams& params, const Layout& layout) {
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    for (uint32_t i = 0; i < params.leases_; ++i) {
+        uint32_t subnet = i % params.subnets_;
+        Lease6Ptr lease(new Lease6(Lease::TYPE_NA,
+                                   layout.poolEnd(subnet, i / params.subnets_),
+                                   makeDuid(i, 0x0b), IAID, 3000, 4000,
+                                   subnet + 1));
+        lease_mgr.addLease(lease);
+    }
+}
+
+/// @brief Creates a relayed query of a client.
+///
+/// @param type message type.
+/// @param client client index.
+/// @param address address to put in the IA_NA, ignored when it is zero.
+/// @param server_id server identifier, ignored when null.
+/// @param params benchmark parameters.
+/// @param layout subnets addressing.
+/// @return the received packet, not yet unpacked.
+Pkt6Ptr
+makeRelayedQuery(uint8_t type, uint32_t client, const IOAddress& address,
+                 const OptionPtr& server_id, const BenchmarkParams& params,
+                 const Layout& layout) {
+    Pkt6Ptr query(new Pkt6(type, client + 1));
+    query->addOption(OptionPtr(new Option(Option::V6, D6O_CLIENTID,
+                                          makeDuid(client)->getDuid())));
+    if (server_id) {
+        query->addOption(server_id);
+    }
+    Option6IAPtr ia(new Option6IA(D6O_IA_NA, IAID));
+    if (!address.isV6Zero()) {
+        ia->addOption(OptionPtr(new Option6IAAddr(D6O_IAADDR, address, 0, 0)));
+    }
+    query->addOption(ia);
+
+    Pkt6::RelayInfo relay;
+    relay.msg_type_ = DHCPV6_RELAY_FORW;
+    relay.linkaddr_ = layout.relay(client % params.subnets_);
+    relay.peeraddr_ = IOAddress("fe80::1");
+    relay.hop_count_ = 0;
+    query->relay_info_.push_back(relay);
+
+    // Convert to wire data and parse it back as received.
+    query->pack();
+    Pkt6Ptr received(new Pkt6(static_cast<const uint8_t*>(query->getBuffer().getData()),
+                              query->getBuffer().getLength()));
+    received->setRemoteAddr(relay.linkaddr_);
+    received->setLocalAddr(SERVER_ADDRESS);
+    received->setIface("eth0");
+    received->setIndex(ETH0_INDEX);
+    return (received);
+}
+
+/// @brief Returns the address assigned in a response.
+///
+/// @param rsp the response.
+/// @return the assigned address or :: when none.
+IOAddress
+getAssignedAddress(const Pkt6Ptr& rsp) {
+    if (rsp) {
+        auto ia = boost::dynamic_pointer_cast<Option6IA>(rsp->getOption(D6O_IA_NA));
+        if (ia) {
+            auto iaaddr = boost::dynamic_pointer_cast<Option6IAAddr>(ia->getOption(D6O_IAADDR));
+            if (iaaddr && iaaddr->getValid()) {
+                return (iaaddr->getAddress());
+            }
+        }
+    }
+    return (IOAddress::IPV6_ZERO_ADDRESS());
+}
+
+/// @brief Runs a phase processing one query per client.
+///
+/// @param srv the server.
+/// @param phase the phase recording the latencies.
+/// @param queries queries to process.
+/// @param responses responses of the queries.
+void
+runPhase(Dhcpv6Srv& srv, BenchmarkPhase& phase, vector<Pkt6Ptr>& queries,
+         vector<Pkt6Ptr>& responses) {
+    responses.assign(queries.size(), Pkt6Ptr());
+    auto process = [&srv, &phase, &queries, &responses](size_t i) {
+        auto start = BenchmarkPhase::Clock::now();
+        Pkt6Ptr rsp;
+        try {
+            srv.processPacket(queries[i], rsp);
+        } catch (...) {
+            // Missing responses are reported.
+        }
+        phase.record(i, BenchmarkPhase::Clock::now() - start);
+        responses[i] = rsp;
+    };
+    phase.start();
+    if (MultiThreadingMgr::instance().getMode()) {
+        typedef function<void()> CallBack;
+        auto& thread_pool = MultiThreadingMgr::instance().getThreadPool();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            thread_pool.add(boost::make_shared<CallBack>(std::bind(process, i)), i);
+        }
+        thread_pool.wait();
+    } else {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            process(i);
+        }
+    }
+    phase.stop();
+}
+
+/// @brief Counts the responses of the expected type assigning an address.
+///
+/// @param responses responses of a phase.
+/// @param type expected message type.
+size_t
+countResponses(const vector<Pkt6Ptr>& responses, uint8_t type) {
+    size_t count = 0;
+    for (auto const& rsp : responses) {
+        if (rsp && (rsp->getType() == type) &&
+            !getAssignedAddress(rsp).isV6Zero()) {
+            ++count;
+        }
+    }
+    return (count);
+}
+
+} // end of anonymous namespace
+
+int
+main(int argc, char* argv[]) {
+    BenchmarkParams params;
+    if (!parseBenchmarkParams("dhcp6_benchmark", argc, argv, params)) {
+        return (EXIT_FAILURE);
+    }
+    isc::log::initLogger("dhcp6_benchmark", isc::log::WARN);
+
+    try {
+        Layout layout(params);
+        CfgMgr::instance().setFamily(AF_INET6);
+        IfaceMgrTestConfig iface_config(true);
+        Dhcpv6Srv srv(0);
+
+        ConstElementPtr answer = configureDhcp6Server(srv, makeConfig(params, layout));
+        int rcode;
+        ConstElementPtr comment = config::parseAnswer(rcode, answer);
+        if (rcode != 0) {
+            isc_throw(Unexpected, "configuration failed: " << comment->str());
+        }
+        auto cfg_db = CfgMgr::instance().getStagingCfg()->getCfgDbAccess();
+        cfg_db->setAppendedParameters("universe=6");
+        cfg_db->createManagers();
+        addLeases(params, layout);
+        CfgMgr::instance().getStagingCfg()->getCfgSubnets6()->initAllocatorsAfterConfigure();
+        CfgMultiThreading::apply(CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading());
+        CfgMgr::instance().commit();
+
+        printBenchmarkParams(cout, params);
+
+        vector<Pkt6Ptr> queries(params.clients_);
+        vector<Pkt6Ptr> advertises;
+        vector<Pkt6Ptr> replies;
+        vector<Pkt6Ptr> renew_replies;
+        int status = EXIT_SUCCESS;
+
+        // SOLICIT phase.
+        for (uint32_t client = 0; client < params.clients_; ++client) {
+            queries[client] = makeRelayedQuery(DHCPV6_SOLICIT, client,
+                                               IOAddress::IPV6_ZERO_ADDRESS(),
+                                               OptionPtr(), params, layout);
+        }
+        BenchmarkPhase solicit("SOLICIT", params.clients_);
+        runPhase(srv, solicit, queries, advertises);
+        solicit.report(cout);
+
+        // REQUEST phase for the advertised addresses.
+        for (uint32_t client = 0; client < params.clients_; ++client) {
+            auto const& advertise = advertises[client];
+            queries[client] = makeRelayedQuery(DHCPV6_REQUEST, client,
+                                               getAssignedAddress(advertise),
+                                               advertise ? advertise->getOption(D6O_SERVERID) :
+                                               OptionPtr(), params, layout);
+        }
+        BenchmarkPhase request("REQUEST", params.clients_);
+        runPhase(srv, request, queries, replies);
+        request.report(cout);
+
+        // RENEW phase.
+        for (uint32_t client = 0; client < params.clients_; ++client) {
+            auto const& reply = replies[client];
+            queries[client] = makeRelayedQuery(DHCPV6_RENEW, client,
+                                               getAssignedAddress(reply),
+                                               reply ? reply->getOption(D6O_SERVERID) :
+                                               OptionPtr(), params, layout);
+        }
+        BenchmarkPhase renew("RENEW", params.clients_);
+        runPhase(srv, renew, queries, renew_replies);
+        renew.report(cout);
+
+        size_t count = countResponses(advertises, DHCPV6_ADVERTISE);
+        if (count != params.clients_) {
+            cout << "missing ADVERTISEs: " << params.clients_ - count << endl;
+            status = EXIT_FAILURE;
+        }
+        count = countResponses(replies, DHCPV6_REPLY);
+        if (count != params.clients_) {
+            cout << "missing REPLYs: " << params.clients_ - count << endl;
+            status = EXIT_FAILURE;
+        }
+        count = countResponses(renew_replies, DHCPV6_REPLY);
+        if (count != params.clients_) {
+            cout << "missing RENEW REPLYs: " << params.clients_ - count << endl;
+            status = EXIT_FAILURE;
+        }
+
+        MultiThreadingMgr::instance().apply(false, 0, 0);
+        LeaseMgrFactory::destroy();
+        return (status);
+
+    } catch (const exception& ex) {
+        MultiThreadingMgr::instance().apply(false, 0, 0);
+        cerr << "benchmark failed: " << ex.what() << endl;
+        return (EXIT_FAILURE);
+    }
+}
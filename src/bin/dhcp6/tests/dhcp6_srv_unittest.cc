@@ -605,6 +605,44 @@ TEST_F(Dhcpv6SrvTest, DUID) {
     }
 }
 
+// Verifies that the client affinity key is computed from the client
+// identifier, including in relayed messages.
+TEST_F(Dhcpv6SrvTest, getClientAffinityKey) {
+    // Returns the query as received from the wire.
+    auto received = [](uint8_t type, const OptionPtr& clientid, bool relayed) {
+        Pkt6Ptr query(new Pkt6(type, 1234));
+        query->addOption(clientid);
+        if (relayed) {
+            Pkt6::RelayInfo relay;
+            relay.msg_type_ = DHCPV6_RELAY_FORW;
+            relay.linkaddr_ = IOAddress("2001:db8:1::1");
+            relay.peeraddr_ = IOAddress("fe80::1");
+            OptionPtr interface_id(new Option(Option::V6, D6O_INTERFACE_ID,
+                                              OptionBuffer(4, 1)));
+            relay.options_.insert(make_pair(D6O_INTERFACE_ID, interface_id));
+            query->addRelayInfo(relay);
+        }
+        query->pack();
+        const OutputBuffer& buf = query->getBuffer();
+        return (Pkt6Ptr(new Pkt6(static_cast<const uint8_t*>(buf.getData()),
+                                 buf.getLength())));
+    };
+
+    OptionPtr clientid1(new Option(Option::V6, D6O_CLIENTID,
+                                   OptionBuffer(10, 1)));
+    OptionPtr clientid2(new Option(Option::V6, D6O_CLIENTID,
+                                   OptionBuffer(10, 2)));
+
+    size_t key = Dhcpv6Srv::getClientAffinityKey(received(DHCPV6_SOLICIT,
+                                                          clientid1, false));
+    EXPECT_EQ(key, Dhcpv6Srv::getClientAffinityKey(received(DHCPV6_REQUEST,
+                                                            clientid1, false)));
+    EXPECT_EQ(key, Dhcpv6Srv::getClientAffinityKey(received(DHCPV6_RENEW,
+                                                            clientid1, true)));
+    EXPECT_NE(key, Dhcpv6Srv::getClientAffinityKey(received(DHCPV6_SOLICIT,
+                                                            clientid2, true)));
+}
+
 // This test checks if Option Request Option (ORO) is parsed correctly
 // and the requested options are actually assigned.
 TEST_F(Dhcpv6SrvTest, advertiseOptions) {
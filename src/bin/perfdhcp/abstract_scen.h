@@ -1,4 +1,4 @@
-// Copyright (C) 2019,2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -47,6 +47,11 @@ public:
     /// \brief Trivial virtual destructor.
     virtual ~AbstractScen() {};
 
+    /// \brief Return the object controlling the test.
+    ///
+    /// \return reference to the test control.
+    TestControl& getTestControl() { return (tc_); }
+
 protected:
     CommandOptions& options_; ///< Reference to commandline options.
     TestControl tc_;  ///< Object for controlling sending and receiving packets.
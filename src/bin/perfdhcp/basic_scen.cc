@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,8 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <thread>
+
 using namespace std;
 using namespace boost::posix_time;
 using namespace isc;
@@ -121,23 +123,20 @@ BasicScen::checkExitConditions() {
     return (false);
 }
 
-int
-BasicScen::run() {
+void
+BasicScen::runLoop() {
     StatsMgr& stats_mgr(tc_.getStatsMgr());
 
-    // Preload server with the number of packets.
-    if (options_.getPreload() > 0) {
-        tc_.sendPackets(options_.getPreload(), true);
-    }
-
-    // Fork and run command specified with -w<wrapped-command>
-    if (!options_.getWrapped().empty()) {
-        tc_.runWrapped();
-    }
+    for (;;) {
+        // Let the threads reading the statistics take the lock.
+        while (readers_ > 0) {
+            std::this_thread::yield();
+        }
 
-    tc_.start();
+        // The statistics are updated under the lock, which is released
+        // at the end of each iteration.
+        std::unique_lock<std::mutex> lock(mutex_);
 
-    for (;;) {
         // Calculate number of packets to be sent to stay
         // catch up with rate.
         uint64_t packets_due =
@@ -156,7 +155,9 @@ BasicScen::run() {
         if (options_.getRate() < 10000 && packets_due == 0 && pkt_count == 0) {
             /// @todo: need to implement adaptive time here, so the sleep time
             /// is not fixed, but adjusts to current situation.
+            lock.unlock();
             usleep(1);
+            lock.lock();
         }
 
         // If test period finished, maximum number of packet drops
@@ -211,6 +212,49 @@ BasicScen::run() {
         // searches in the long list of Reply packets increases CPU utilization.
         tc_.cleanCachedPackets();
     }
+}
+
+void
+BasicScen::mergeStats(StatsMgr& stats_mgr) {
+    ++readers_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    --readers_;
+    StatsMgr& own_stats_mgr(tc_.getStatsMgr());
+    stats_mgr.merge(own_stats_mgr);
+    own_stats_mgr.resetIntervalLatency();
+}
+
+void
+BasicScen::runThread() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (options_.getPreload() > 0) {
+            tc_.sendPackets(options_.getPreload(), true);
+        }
+    }
+
+    tc_.start();
+    runLoop();
+    tc_.stop();
+}
+
+int
+BasicScen::run() {
+    StatsMgr& stats_mgr(tc_.getStatsMgr());
+
+    // Preload server with the number of packets.
+    if (options_.getPreload() > 0) {
+        tc_.sendPackets(options_.getPreload(), true);
+    }
+
+    // Fork and run command specified with -w<wrapped-command>
+    if (!options_.getWrapped().empty()) {
+        tc_.runWrapped();
+    }
+
+    tc_.start();
+
+    runLoop();
 
     tc_.stop();
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,9 @@
 
 #include <perfdhcp/abstract_scen.h>
 
+#include <atomic>
+#include <mutex>
+
 
 namespace isc {
 namespace perfdhcp {
@@ -27,7 +30,7 @@ public:
     /// \param options reference to command options,
     /// \param socket reference to a socket.
     BasicScen(CommandOptions& options, BasePerfSocket &socket):
-        AbstractScen(options, socket)
+        AbstractScen(options, socket), readers_(0)
     {
         basic_rate_control_.setRate(options_.getRate());
         renew_rate_control_.setRate(options_.getRenewRate());
@@ -45,6 +48,25 @@ public:
     /// \return execution status.
     int run() override;
 
+    /// \brief Run the traffic of a traffic thread.
+    ///
+    /// Method sends the preload packets and runs the main loop of the
+    /// test until an exit condition is fulfilled. Unlike \ref run it
+    /// does not print anything: the statistics of the traffic threads
+    /// are aggregated and printed by \ref ParallelScen.
+    void runThread();
+
+    /// \brief Add the statistics of the test to other statistics.
+    ///
+    /// The method can be called from another thread while the main
+    /// loop is running: the main loop releases the lock protecting the
+    /// statistics at the end of each iteration and lets the waiting
+    /// readers take it. The interval latency of the test is restarted.
+    ///
+    /// \param stats_mgr the statistics manager the statistics of the
+    /// test are added to.
+    void mergeStats(StatsMgr& stats_mgr);
+
 protected:
     /// \brief A rate control class for Discover and Solicit messages.
     RateControl basic_rate_control_;
@@ -64,6 +86,18 @@ protected:
     ///
     /// \return true if any of the exit conditions is fulfilled.
     bool checkExitConditions();
+
+    /// \brief Run the main loop of the test.
+    ///
+    /// Method sends and receives packets until an exit condition is
+    /// fulfilled.
+    void runLoop();
+
+    /// \brief Mutex protecting the statistics.
+    std::mutex mutex_;
+
+    /// \brief Number of threads waiting to read the statistics.
+    std::atomic<uint32_t> readers_;
 };
 
 }
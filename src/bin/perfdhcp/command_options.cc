@@ -18,6 +18,7 @@
 
 #include <boost/lexical_cast.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -116,6 +117,8 @@ CommandOptions::reset() {
     report_delay_ = 0;
     clean_report_ = false;
     clean_report_separator_ = "";
+    latency_csv_file_.clear();
+    latency_json_file_.clear();
     clients_num_ = 0;
     mac_template_.assign(mac, mac + 6);
     duid_template_.clear();
@@ -163,6 +166,14 @@ CommandOptions::reset() {
         single_thread_mode_ = false;
     }
     scenario_ = Scenario::BASIC;
+    lease_time_min_ = 0;
+    lease_time_max_ = 0;
+    churn_ = 0.;
+    reboot_ = 0.;
+    decline_ = 0.;
+    threads_num_ = 1;
+    thread_index_ = 0;
+    clients_offset_ = 0;
 }
 
 bool
@@ -212,6 +223,13 @@ CommandOptions::parse(int argc, char** const argv, bool print_cmd_line) {
 }
 
 const int LONG_OPT_SCENARIO = 300;
+const int LONG_OPT_LATENCY_CSV = 301;
+const int LONG_OPT_LATENCY_JSON = 302;
+const int LONG_OPT_THREADS = 303;
+const int LONG_OPT_LEASE_TIME = 304;
+const int LONG_OPT_CHURN = 305;
+const int LONG_OPT_REBOOT = 306;
+const int LONG_OPT_DECLINE = 307;
 
 bool
 CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
@@ -232,6 +250,13 @@ CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
 
     struct option long_options[] = {
         {"scenario", required_argument, 0, LONG_OPT_SCENARIO},
+        {"latency-csv", required_argument, 0, LONG_OPT_LATENCY_CSV},
+        {"latency-json", required_argument, 0, LONG_OPT_LATENCY_JSON},
+        {"threads", required_argument, 0, LONG_OPT_THREADS},
+        {"lease-time", required_argument, 0, LONG_OPT_LEASE_TIME},
+        {"churn", required_argument, 0, LONG_OPT_CHURN},
+        {"reboot", required_argument, 0, LONG_OPT_REBOOT},
+        {"decline", required_argument, 0, LONG_OPT_DECLINE},
         {0,          0,                 0, 0}
     };
 
@@ -588,11 +613,50 @@ CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
                 scenario_ = Scenario::BASIC;
             } else if (optarg_text == "avalanche") {
                 scenario_ = Scenario::AVALANCHE;
+            } else if (optarg_text == "lifecycle") {
+                scenario_ = Scenario::LIFECYCLE;
             } else {
-                isc_throw(InvalidParameter, "scenario value '" << optarg << "' is wrong - should be 'basic' or 'avalanche'");
+                isc_throw(InvalidParameter, "scenario value '" << optarg << "' is wrong - should be 'basic', 'avalanche' or 'lifecycle'");
             }
             break;
         }
+        case LONG_OPT_LATENCY_CSV:
+            latency_csv_file_ = nonEmptyString("file name for latency"
+                                               " export: --latency-csv<file>"
+                                               " must not be empty");
+            break;
+
+        case LONG_OPT_LATENCY_JSON:
+            latency_json_file_ = nonEmptyString("file name for latency"
+                                                " export: --latency-json<file>"
+                                                " must not be empty");
+            break;
+
+        case LONG_OPT_THREADS:
+            threads_num_ = positiveInteger("number of traffic threads:"
+                                           " --threads<value> must be a"
+                                           " positive integer");
+            break;
+
+        case LONG_OPT_LEASE_TIME:
+            initLeaseTime();
+            break;
+
+        case LONG_OPT_CHURN:
+            churn_ = percentage("value of churn: --churn<value>"
+                                " must be 0..100");
+            break;
+
+        case LONG_OPT_REBOOT:
+            reboot_ = percentage("value of reboots: --reboot<value>"
+                                 " must be 0..100");
+            break;
+
+        case LONG_OPT_DECLINE:
+            decline_ = percentage("value of declines: --decline<value>"
+                                  " must be 0..100");
+            break;
+
         default:
             isc_throw(isc::InvalidParameter, "wrong command line option");
         }
@@ -647,6 +711,8 @@ CommandOptions::initialize(int argc, char** argv, bool print_cmd_line) {
             std::cout << "Scenario: basic." << std::endl;
         } else if (scenario_ == Scenario::AVALANCHE) {
             std::cout << "Scenario: avalanche." << std::endl;
+        } else if (scenario_ == Scenario::LIFECYCLE) {
+            std::cout << "Scenario: lifecycle." << std::endl;
         }
 
         if (!isSingleThreaded()) {
@@ -696,6 +762,29 @@ CommandOptions::initClientsNum() {
     }
 }
 
+void
+CommandOptions::initLeaseTime() {
+    const std::string errmsg =
+        "value of --lease-time <value> must be a positive integer or"
+        " a range of positive integers given as min-max";
+
+    const std::string arg(optarg);
+    const size_t dash = arg.find('-');
+    try {
+        long long min_time = boost::lexical_cast<long long>(arg.substr(0, dash));
+        long long max_time = min_time;
+        if (dash != std::string::npos) {
+            max_time = boost::lexical_cast<long long>(arg.substr(dash + 1));
+        }
+        check((min_time <= 0) || (max_time < min_time) ||
+              (max_time > std::numeric_limits<uint32_t>::max()), errmsg);
+        lease_time_min_ = static_cast<uint32_t>(min_time);
+        lease_time_max_ = static_cast<uint32_t>(max_time);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(isc::InvalidParameter, errmsg);
+    }
+}
+
 void
 CommandOptions::initIsInterface() {
     is_interface_ = false;
@@ -989,6 +1078,50 @@ CommandOptions::validate() {
                   << "WARNING: To switch use -g multi option." << std::endl;
     }
 
+    if (getThreadsNum() > 1) {
+        check(scenario_ != Scenario::BASIC,
+              "--threads<value> is only supported by the basic scenario");
+        check(!getTemplateFiles().empty(),
+              "-T<template-file> is not compatible with --threads<value>");
+        check((getIpVersion() == 6) && !isUseRelayedV6(),
+              "-A<encapsulation-level> must be set to use --threads<value>"
+              " with IPv6");
+        check((getRate() != 0) &&
+              (getRate() < static_cast<int>(getThreadsNum())),
+              "value of rate: -r<value> must not be lower than the number"
+              " of traffic threads");
+        check((getClientsNum() > 1) && (getClientsNum() < getThreadsNum()),
+              "number of clients: -R<value> must not be lower than the"
+              " number of traffic threads");
+        check(getLocalPort() + getThreadsNum() - 1 >
+              std::numeric_limits<uint16_t>::max(),
+              "local ports of the traffic threads must be lower than " +
+              boost::lexical_cast<std::string>(std::numeric_limits<uint16_t>::max()));
+    }
+
+    if (scenario_ == Scenario::LIFECYCLE) {
+        check(getClientsNum() <= 0,
+              "in case of lifecycle scenario number\nof clients must be specified"
+              " using -R option explicitly");
+        check(getExchangeMode() != DORA_SARR,
+              "-i<only-initial> is not compatible with lifecycle scenario");
+        check(!getTemplateFiles().empty(),
+              "-T<template-file> is not compatible with lifecycle scenario");
+        check((getRenewRate() != 0) || (getReleaseRate() != 0),
+              "-f<renew-rate> and -F<release-rate> are not compatible with"
+              " lifecycle scenario, use --lease-time and --churn instead");
+        check(getPreload() != 0,
+              "-P<preload> is not compatible with lifecycle scenario");
+        check(getChurn() + getReboot() > 100.,
+              "sum of --churn<value> and --reboot<value> must not be greater"
+              " than 100");
+    } else {
+        check((getLeaseTimeMax() != 0) || (getChurn() > 0.) ||
+              (getReboot() > 0.) || (getDecline() > 0.),
+              "--lease-time, --churn, --reboot and --decline are only"
+              " supported by the lifecycle scenario");
+    }
+
     if (scenario_ == Scenario::AVALANCHE) {
         check(getClientsNum() <= 0,
               "in case of avalanche scenario number\nof clients must be specified"
@@ -1003,6 +1136,56 @@ CommandOptions::validate() {
     }
 }
 
+namespace {
+
+/// \brief Return the share of a value given to a traffic thread.
+///
+/// The remainder of the division is spread over the first threads.
+///
+/// \param value value to divide.
+/// \param index index of the thread.
+/// \param threads number of threads.
+/// \return share of the thread.
+uint32_t
+threadShare(uint32_t value, uint32_t index, uint32_t threads) {
+    return (value / threads + (index < value % threads ? 1 : 0));
+}
+
+}
+
+CommandOptions
+CommandOptions::getThreadOptions(uint32_t index) const {
+    if (index >= threads_num_) {
+        isc_throw(isc::BadValue, "traffic thread index " << index
+                  << " is out of range 0.." << threads_num_ - 1);
+    }
+    CommandOptions options(*this);
+    options.thread_index_ = index;
+    options.rate_ = threadShare(rate_, index, threads_num_);
+    options.renew_rate_ = threadShare(renew_rate_, index, threads_num_);
+    options.release_rate_ = threadShare(release_rate_, index, threads_num_);
+    options.preload_ = threadShare(preload_, index, threads_num_);
+    for (size_t i = 0; i < num_request_.size(); ++i) {
+        options.num_request_[i] = threadShare(num_request_[i], index,
+                                              threads_num_);
+    }
+    // A thread must not give up before it has seen any drop.
+    for (size_t i = 0; i < max_drop_.size(); ++i) {
+        options.max_drop_[i] = std::max(threadShare(max_drop_[i], index,
+                                                    threads_num_), 1u);
+    }
+    if (clients_num_ > 1) {
+        options.clients_num_ = threadShare(clients_num_, index, threads_num_);
+        options.clients_offset_ = index * (clients_num_ / threads_num_) +
+            std::min(index, clients_num_ % threads_num_);
+    }
+    // The traffic threads always receive in their own thread, the
+    // reports are printed by the main thread.
+    options.single_thread_mode_ = false;
+    options.report_delay_ = 0;
+    return (options);
+}
+
 void
 CommandOptions::check(bool condition, const std::string& errmsg) const {
     // The same could have been done with macro or just if statement but
@@ -1036,6 +1219,17 @@ CommandOptions::nonNegativeInteger(const std::string& errmsg) const {
     }
 }
 
+double
+CommandOptions::percentage(const std::string& errmsg) const {
+    try {
+        double value = boost::lexical_cast<double>(optarg);
+        check((value < 0.) || (value > 100.), errmsg);
+        return (value);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(InvalidParameter, errmsg);
+    }
+}
+
 std::string
 CommandOptions::nonEmptyString(const std::string& errmsg) const {
     std::string sarg = optarg;
@@ -1074,6 +1268,12 @@ CommandOptions::printCommandLine() const {
     if (report_delay_ != 0) {
         std::cout << "report[s]=" << report_delay_ << std::endl;
     }
+    if (!latency_csv_file_.empty()) {
+        std::cout << "latency-csv=" << latency_csv_file_ << std::endl;
+    }
+    if (!latency_json_file_.empty()) {
+        std::cout << "latency-json=" << latency_json_file_ << std::endl;
+    }
     if (clients_num_ != 0) {
         std::cout << "clients=" << clients_num_ << std::endl;
     }
@@ -1158,20 +1358,42 @@ CommandOptions::printCommandLine() const {
     } else {
         std::cout << "multi-thread-mode" << std::endl;
     }
+    if (threads_num_ > 1) {
+        std::cout << "threads=" << threads_num_ << std::endl;
+    }
+    if (lease_time_max_ != 0) {
+        std::cout << "lease-time[s]=" << lease_time_min_;
+        if (lease_time_max_ != lease_time_min_) {
+            std::cout << "-" << lease_time_max_;
+        }
+        std::cout << std::endl;
+    }
+    if (churn_ > 0.) {
+        std::cout << "churn[%]=" << churn_ << std::endl;
+    }
+    if (reboot_ > 0.) {
+        std::cout << "reboot[%]=" << reboot_ << std::endl;
+    }
+    if (decline_ > 0.) {
+        std::cout << "decline[%]=" << decline_ << std::endl;
+    }
 }
 
 void
 CommandOptions::usage() {
     std::cout <<
 R"(perfdhcp [-1] [-4 | -6] [-A encapsulation-level] [-b base] [-B] [-c]
-         [-C separator] [-d drop-time] [-D max-drop] [-e lease-type]
-         [-E time-offset] [-f renew-rate] [-F release-rate] [-g thread-mode]
-         [-h] [-i] [-I ip-offset] [-J remote-address-list-file]
+         [-C separator] [--churn percent] [-d drop-time] [-D max-drop]
+         [--decline percent] [-e lease-type] [-E time-offset] [-f renew-rate]
+         [-F release-rate] [-g thread-mode] [-h] [-i] [-I ip-offset]
+         [-J remote-address-list-file] [--latency-csv file]
+         [--latency-json file] [--lease-time seconds]
          [-l local-address|interface] [-L local-port] [-M mac-list-file]
          [-n num-request] [-N remote-port] [-O random-offset]
          [-o code,hexstring] [-p test-period] [-P preload] [-r rate]
-         [-R num-clients] [-s seed] [-S srvid-offset] [--scenario name]
-         [-t report] [-T template-file] [-u] [-v] [-W exit-wait-time]
+         [-R num-clients] [--reboot percent] [-s seed] [-S srvid-offset]
+         [--scenario name] [-t report] [-T template-file]
+         [--threads num-threads] [-u] [-v] [-W exit-wait-time]
          [-w script_name] [-x diagnostic-selector] [-X xid-offset] [server]
 
 The [server] argument is the name/address of the DHCP server to
@@ -1195,6 +1417,13 @@ The other scenario is an avalanche which is selected by
 messages as request in -R option then back off mechanism is used for
 each simulated client until all requests are answered. At the end
 time of whole scenario is reported.
+The lifecycle scenario, selected by --scenario lifecycle, simulates
+a population of -R clients joining at the -r rate. Each client gets
+a lease, renews it at T1, rebinds at T2 if the renewal is not answered
+and starts again when the lease expires or the server refuses it.
+Clients may leave (--churn), reboot (--reboot) or decline their
+lease (--decline). The test runs for the test period (-p) or until
+it is interrupted.
 
 Options:
 -1: Take the server-ID option from the first received message.
@@ -1204,9 +1433,15 @@ Options:
     clients.  This can be specified multiple times, each instance is
     in the <type>=<value> form, for instance:
     (and default) mac=00:0c:01:02:03:04.
+--churn <percent>: Percentage of the renewals replaced by the client
+    leaving in the lifecycle scenario. The client releases its lease and
+    is replaced by a new client with another identifier.
 -d<drop-time>: Specify the time after which a request is treated as
     having been lost.  The value is given in seconds and may contain a
     fractional component.  The default is 1 second.
+--decline <percent>: Percentage of the leases assigned in the lifecycle
+    scenario which are declined by the client. The client then requests
+    a new lease.
 -e<lease-type>: A type of lease being requested from the server. It
     may be one of the following: address-only, prefix-only or
     address-and-prefix. The address-only indicates that the regular
@@ -1240,6 +1475,17 @@ Options:
 -J<remote-address-list-file>: Text file that include multiple addresses.
     If provided perfdhcp will choose randomly one of addresses for each
     exchange.
+--latency-csv <file>: Write the minimum, 50th, 90th, 99th and 99.9th
+    percentiles and maximum of the delays of each exchange to <file>
+    in CSV format at the end of the test. The delays are given in
+    microseconds for each report interval (see -t) and for the whole
+    test.
+--latency-json <file>: Same as --latency-csv but in JSON format.
+--lease-time <seconds>: Lease time used by the clients of the lifecycle
+    scenario instead of the one given by the server. The clients renew
+    at half of it and rebind at 7/8 of it. A range given as min-max
+    makes each lease time random in this range. This allows to simulate
+    long leases in a short test.
 -l<local-addr|interface>: For DHCPv4 operation, specify the local
     hostname/address to use when communicating with the server.  By
     default, the interface address through which traffic would
@@ -1267,11 +1513,25 @@ Options:
 -R<range>: Specify how many different clients are used. With 1
     (the default), all requests seem to come from the same client.
 -s<seed>: Specify the seed for randomization, making it repeatable.
---scenario <name>: where name is 'basic' (default) or 'avalanche'.
+--reboot <percent>: Percentage of the renewals replaced by a reboot of
+    the client in the lifecycle scenario. A rebooting DHCPv4 client sends
+    a REQUEST in INIT-REBOOT state, a DHCPv6 client sends a Confirm or a
+    Rebind when it has delegated prefixes.
+--scenario <name>: where name is 'basic' (default), 'avalanche' or
+    'lifecycle'.
 -S<srvid-offset>: Offset of the server-ID option in the
     (second/request) template.
 -T<template-file>: The name of a file containing the template to use
     as a stream of hexadecimal digits.
+--threads <num-threads>: Generate the traffic of the basic scenario with
+    <num-threads> pairs of sender and receiver threads. Each pair uses
+    its own socket bound to the local port (see -L) plus the index of
+    the pair, its own range of the simulated clients (see -R) and its
+    share of the rates and limits (-r, -f, -F, -n, -D and -P). The
+    relay port option (RFC 8357) is added to the messages so the server
+    answers to the port of the pair which sent the request. The DHCPv6
+    traffic must be relayed (-A). The statistics of the pairs are added
+    together in the reports.
 -u: Enable checking address uniqueness. Lease valid lifetime should not be
     shorter than test duration and clients should not request address more than
     once without releasing it first.
@@ -1324,7 +1584,9 @@ The remaining options are typically used in conjunction with -r:
     specified in the same manner as -d.  This can be used as an
     alternative to -n, or both options can be given, in which case the
     testing is completed when either limit is reached.
--t<report>: Delay in seconds between two periodic reports.
+-t<report>: Delay in seconds between two periodic reports. Each report
+    also shows the 99th percentile of the delays since the previous one,
+    except in the reports reduced by -C.
 -C<separator>: Output reduced, an argument is a separator for periodic
     (-t) reports generated in easy parsable mode. Data output won't be
     changed, remain identical as in -t option.
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,7 +9,6 @@
 
 #include <dhcp/option.h>
 
-#include <boost/noncopyable.hpp>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -19,15 +18,17 @@ namespace perfdhcp {
 
 enum class Scenario {
     BASIC,
-    AVALANCHE
+    AVALANCHE,
+    LIFECYCLE
 };
 
 /// \brief Command Options.
 ///
 /// This class is responsible for parsing the command-line and storing the
-/// specified options.
+/// specified options. The options are copied to give each traffic thread
+/// its share of the test, see \ref getThreadOptions.
 ///
-class CommandOptions : public boost::noncopyable {
+class CommandOptions {
 public:
 
     /// \brief Default Constructor.
@@ -183,6 +184,16 @@ public:
     /// \return returns string which is used as separator for report..
     std::string getCleanReportSeparator() const { return clean_report_separator_; }
 
+    /// \brief Returns file where latency percentiles are exported in CSV.
+    ///
+    /// \return file name or empty string if CSV export is disabled.
+    std::string getLatencyCsvFile() const { return latency_csv_file_; }
+
+    /// \brief Returns file where latency percentiles are exported in JSON.
+    ///
+    /// \return file name or empty string if JSON export is disabled.
+    std::string getLatencyJsonFile() const { return latency_json_file_; }
+
     /// \brief Returns number of simulated clients.
     ///
     /// \return number of simulated clients.
@@ -382,6 +393,63 @@ public:
     /// \return true if single-threaded mode is enabled.
     bool isSingleThreaded() const { return single_thread_mode_; }
 
+    /// \brief Returns number of traffic threads.
+    ///
+    /// \return number of sender and receiver thread pairs.
+    uint32_t getThreadsNum() const { return threads_num_; }
+
+    /// \brief Returns index of the traffic thread using the options.
+    ///
+    /// \return index of the thread, 0 for the options parsed from
+    /// the command line.
+    uint32_t getThreadIndex() const { return thread_index_; }
+
+    /// \brief Returns offset of the first client simulated with the options.
+    ///
+    /// \return offset added to the randomized part of the MAC address
+    /// and DUID, 0 for the options parsed from the command line.
+    uint32_t getClientsOffset() const { return clients_offset_; }
+
+    /// \brief Returns the options of a traffic thread.
+    ///
+    /// The returned options are a copy of these options where the
+    /// exchange, renew and release rates, the numbers of requests,
+    /// drops and preload packets and the simulated clients are divided
+    /// between the threads. The thread receives on its own local port
+    /// and does not print intermediate reports.
+    ///
+    /// \param index index of the thread.
+    /// \throw isc::BadValue if the index is out of range.
+    /// \return options of the thread.
+    CommandOptions getThreadOptions(uint32_t index) const;
+
+    /// \brief Returns smallest lease time of the simulated clients.
+    ///
+    /// \return lease time in seconds or 0 if the clients use the
+    /// lease times given by the server.
+    uint32_t getLeaseTimeMin() const { return lease_time_min_; }
+
+    /// \brief Returns largest lease time of the simulated clients.
+    ///
+    /// \return lease time in seconds or 0 if the clients use the
+    /// lease times given by the server.
+    uint32_t getLeaseTimeMax() const { return lease_time_max_; }
+
+    /// \brief Returns percentage of renewals replaced by a client leaving.
+    ///
+    /// \return churn percentage.
+    double getChurn() const { return churn_; }
+
+    /// \brief Returns percentage of renewals replaced by a client reboot.
+    ///
+    /// \return reboot percentage.
+    double getReboot() const { return reboot_; }
+
+    /// \brief Returns percentage of assigned leases which are declined.
+    ///
+    /// \return decline percentage.
+    double getDecline() const { return decline_; }
+
     /// \brief Returns selected scenario.
     ///
     /// \return enum Scenario.
@@ -416,7 +484,7 @@ public:
     ///
     /// \param diag diagnostic flag (a,e,i,s,r,t,T).
     /// \return true if diagnostics flag has been set.
-    bool testDiags(const char diag) {
+    bool testDiags(const char diag) const {
         if (getDiags().find(diag) != std::string::npos) {
             return (true);
         }
@@ -472,6 +540,13 @@ private:
     /// \throw InvalidParameter if lexical cast fails.
     int positiveInteger(const std::string& errmsg) const;
 
+    /// \brief Casts command line argument to percentage.
+    ///
+    /// \param errmsg Error message if lexical cast fails.
+    /// \throw InvalidParameter if lexical cast fails or the value
+    /// is not in the 0..100 range.
+    double percentage(const std::string& errmsg) const;
+
     /// \brief Casts command line argument to non-negative integer.
     ///
     /// \param errmsg Error message if lexical cast fails.
@@ -489,6 +564,15 @@ private:
     /// \throw InvalidParameter if lease type value specified is invalid.
     void initLeaseType();
 
+    /// \brief Set lease times of the simulated clients.
+    ///
+    /// Interprets the getopt() "opt" global variable as a number of
+    /// seconds or a range of seconds given as min-max. This value is
+    /// specified by the "--lease-time" switch.
+    ///
+    /// \throw InvalidParameter if --lease-time<value> is wrong.
+    void initLeaseTime();
+
     /// \brief Set number of clients.
     ///
     /// Interprets the getopt() "opt" global variable as the number of clients
@@ -602,6 +686,12 @@ private:
     /// If clean report is enabled separator for output can be configured.
     std::string clean_report_separator_;
 
+    /// File where latency percentiles are exported in CSV format.
+    std::string latency_csv_file_;
+
+    /// File where latency percentiles are exported in JSON format.
+    std::string latency_json_file_;
+
     /// Number of simulated clients (aka randomization range).
     uint32_t clients_num_;
 
@@ -756,6 +846,30 @@ private:
 
     /// @brief Selected performance scenario. Default is basic.
     Scenario scenario_;
+
+    /// @brief Smallest lease time of the lifecycle scenario clients.
+    uint32_t lease_time_min_;
+
+    /// @brief Largest lease time of the lifecycle scenario clients.
+    uint32_t lease_time_max_;
+
+    /// @brief Percentage of renewals replaced by a client leaving.
+    double churn_;
+
+    /// @brief Percentage of renewals replaced by a client reboot.
+    double reboot_;
+
+    /// @brief Percentage of assigned leases which are declined.
+    double decline_;
+
+    /// @brief Number of sender and receiver thread pairs.
+    uint32_t threads_num_;
+
+    /// @brief Index of the traffic thread using the options.
+    uint32_t thread_index_;
+
+    /// @brief Offset of the first client simulated with the options.
+    uint32_t clients_offset_;
 };
 
 }  // namespace perfdhcp
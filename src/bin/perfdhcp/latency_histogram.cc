@@ -0,0 +1,124 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <perfdhcp/latency_histogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace isc {
+namespace perfdhcp {
+
+const uint64_t LatencyHistogram::SUB_BUCKETS;
+
+namespace {
+
+/// Number of sub-buckets added by each power of two above
+/// \ref LatencyHistogram::SUB_BUCKETS.
+const uint64_t HALF_BUCKETS = LatencyHistogram::SUB_BUCKETS / 2;
+
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(),
+      count_(0),
+      min_(std::numeric_limits<uint64_t>::max()),
+      max_(0) {
+}
+
+size_t
+LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return(value);
+    }
+    // Drop the low order bits until the value fits in the sub-buckets.
+    // Its top bit is then set so it lands in the upper half of them.
+    size_t shift = 0;
+    while ((value >> shift) >= SUB_BUCKETS) {
+        ++shift;
+    }
+    return(shift * HALF_BUCKETS + (value >> shift));
+}
+
+uint64_t
+LatencyHistogram::bucketHighest(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return(index);
+    }
+    size_t shift = index / HALF_BUCKETS - 1;
+    uint64_t top = index - shift * HALF_BUCKETS;
+    return(((top + 1) << shift) - 1);
+}
+
+void
+LatencyHistogram::record(uint64_t value) {
+    size_t index = bucketIndex(value);
+    if (index >= counts_.size()) {
+        counts_.resize(index + 1, 0);
+    }
+    ++counts_[index];
+    ++count_;
+    if (value < min_) {
+        min_ = value;
+    }
+    if (value > max_) {
+        max_ = value;
+    }
+}
+
+void
+LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.counts_.size() > counts_.size()) {
+        counts_.resize(other.counts_.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void
+LatencyHistogram::reset() {
+    // Keep the counters allocated: the histogram is usually reset to
+    // collect the next interval which has similar delays.
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+}
+
+uint64_t
+LatencyHistogram::getPercentile(double percentile) const {
+    if (count_ == 0) {
+        isc_throw(InvalidOperation, "no values recorded");
+    }
+    if ((percentile < 0.) || (percentile > 100.)) {
+        isc_throw(BadValue, "percentile " << percentile
+                  << " is out of range 0..100");
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile * count_ /
+                                                    100.));
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return(std::max(min_, std::min(bucketHighest(i), max_)));
+        }
+    }
+    return(max_);
+}
+
+}  // namespace perfdhcp
+}  // namespace isc
@@ -0,0 +1,104 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+namespace isc {
+namespace perfdhcp {
+
+/// \brief Latency Histogram.
+///
+/// This class records packet delays in microseconds and computes
+/// their percentiles. It follows the High Dynamic Range histogram
+/// layout: the values below \ref SUB_BUCKETS have their own bucket,
+/// larger values are grouped in buckets which width doubles with
+/// each power of two. With 256 sub-buckets the value reported for
+/// any percentile is within 0.8% of the exact one, while the whole
+/// range of delays from 1 microsecond to hours is covered by a few
+/// thousand counters. Recording a value is a constant time operation
+/// which does not depend on the number of values already recorded,
+/// so it can be done for every received packet.
+class LatencyHistogram {
+public:
+
+    /// Number of sub-buckets. The values below it are recorded exactly,
+    /// the larger ones use half of it buckets per power of two.
+    static const uint64_t SUB_BUCKETS = 256;
+
+    /// \brief Constructor.
+    LatencyHistogram();
+
+    /// \brief Record a value.
+    ///
+    /// \param value delay in microseconds.
+    void record(uint64_t value);
+
+    /// \brief Add the values recorded by another histogram.
+    ///
+    /// \param other histogram which values are added.
+    void merge(const LatencyHistogram& other);
+
+    /// \brief Remove all recorded values.
+    void reset();
+
+    /// \brief Return number of recorded values.
+    ///
+    /// \return number of recorded values.
+    uint64_t getCount() const { return(count_); }
+
+    /// \brief Return smallest recorded value.
+    ///
+    /// \return smallest value in microseconds or 0 if no value has
+    /// been recorded.
+    uint64_t getMin() const { return(count_ ? min_ : 0); }
+
+    /// \brief Return largest recorded value.
+    ///
+    /// \return largest value in microseconds.
+    uint64_t getMax() const { return(max_); }
+
+    /// \brief Return value at the given percentile.
+    ///
+    /// The returned value is the highest value equivalent to the
+    /// bucket holding the percentile, bounded by the recorded minimum
+    /// and maximum, so the 0 and 100 percentiles are exact.
+    ///
+    /// \param percentile percentile between 0 and 100.
+    /// \throw isc::InvalidOperation if no value has been recorded.
+    /// \throw isc::BadValue if the percentile is out of range.
+    /// \return value in microseconds.
+    uint64_t getPercentile(double percentile) const;
+
+private:
+
+    /// \brief Return index of the bucket holding a value.
+    ///
+    /// \param value recorded value.
+    /// \return bucket index.
+    static size_t bucketIndex(uint64_t value);
+
+    /// \brief Return highest value held by a bucket.
+    ///
+    /// \param index bucket index.
+    /// \return highest value of the bucket.
+    static uint64_t bucketHighest(size_t index);
+
+    /// Bucket counters, grown as larger values are recorded.
+    std::vector<uint64_t> counts_;
+
+    uint64_t count_;   ///< Number of recorded values.
+    uint64_t min_;     ///< Smallest recorded value.
+    uint64_t max_;     ///< Largest recorded value.
+};
+
+}  // namespace perfdhcp
+}  // namespace isc
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,815 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <perfdhcp/lifecycle_scen.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/option6_ia.h>
+#include <dhcp/option6_iaaddr.h>
+#include <dhcp/option6_status_code.h>
+#include <util/io_utilities.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+using namespace boost::posix_time;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+
+namespace isc {
+namespace perfdhcp {
+
+namespace {
+
+/// Interval in microseconds between two checks when there is nothing to do.
+const useconds_t POLL_INTERVAL = 100;
+
+/// Lease time of the leases which never expire.
+const uint32_t INFINITE_LEASE = 0xffffffff;
+
+/// Time in seconds a DHCPv4 client waits after a decline (RFC 2131).
+const double DECLINE_WAIT = 10.;
+
+/// \brief Return the value of a DHCPv4 option holding a 32-bit integer.
+///
+/// \param pkt the packet.
+/// \param code option code.
+/// \return value or 0 if the option is missing.
+uint32_t
+getOptionUint32(const Pkt4Ptr& pkt, uint16_t code) {
+    OptionPtr option = pkt->getOption(code);
+    if (!option) {
+        return (0);
+    }
+    std::vector<uint8_t> data = option->toBinary();
+    if (data.size() < sizeof(uint32_t)) {
+        return (0);
+    }
+    return (util::readUint32(&data[0], data.size()));
+}
+
+}
+
+LifecycleScen::Client::Client()
+    : state_(ClientState::INIT), id_(0), transid_(0),
+      xchg_(ExchangeType::DO), retries_(0),
+      relay_(IOAddress::IPV4_ZERO_ADDRESS()),
+      address_(IOAddress::IPV4_ZERO_ADDRESS()) {
+}
+
+LifecycleScen::LifecycleScen(CommandOptions& options, BasePerfSocket& socket)
+    : AbstractScen(options, socket),
+      clients_(options.getClientsNum()),
+      now_(microsec_clock::universal_time()),
+      next_id_(options.getClientsNum()) {
+    // The clients keep the relay they joined through, as they would
+    // be attached to a network segment.
+    const std::vector<std::string> relays = options_.getRelayAddrList();
+    const IOAddress zero = options_.getIpVersion() == 4 ?
+        IOAddress::IPV4_ZERO_ADDRESS() : IOAddress::IPV6_ZERO_ADDRESS();
+    for (uint32_t i = 0; i < clients_.size(); ++i) {
+        clients_[i].id_ = i;
+        clients_[i].relay_ = relays.empty() ? zero :
+            IOAddress(relays[i % relays.size()]);
+    }
+
+    StatsMgr& stats_mgr(tc_.getStatsMgr());
+    stats_mgr.addCustomCounter("joined", "Leases acquired");
+    stats_mgr.addCustomCounter("renewed", "Leases renewed");
+    stats_mgr.addCustomCounter("rebinding", "Renewals not answered before T2");
+    stats_mgr.addCustomCounter("rebound", "Leases rebound");
+    stats_mgr.addCustomCounter("expired", "Leases expired");
+    stats_mgr.addCustomCounter("refused", "Leases refused by the server");
+    stats_mgr.addCustomCounter("churned", "Clients replaced");
+    stats_mgr.addCustomCounter("rebooted", "Client reboots");
+    stats_mgr.addCustomCounter("declined", "Leases declined");
+}
+
+double
+LifecycleScen::roll() {
+    return ((random() % 10000) / 100.);
+}
+
+std::vector<uint8_t>
+LifecycleScen::getMacAddress(uint32_t id) const {
+    const CommandOptions::MacAddrsVector& macs = options_.getMacsFromFile();
+    if (!macs.empty()) {
+        return (macs[id % macs.size()]);
+    }
+    std::vector<uint8_t> mac_addr(options_.getMacTemplate());
+    if (mac_addr.size() != TestControl::HW_ETHER_LEN) {
+        isc_throw(BadValue, "invalid MAC address template specified");
+    }
+    // Add the identifier to the template starting from the last octet
+    // as TestControl does with the random values.
+    uint32_t r = id + options_.getClientsOffset();
+    for (auto it = mac_addr.rbegin(); (it != mac_addr.rend()) && (r > 0); ++it) {
+        (*it) += r;
+        r >>= 8;
+    }
+    return (mac_addr);
+}
+
+std::vector<uint8_t>
+LifecycleScen::getDuid(uint32_t id) const {
+    std::vector<uint8_t> mac_addr(getMacAddress(id));
+    if (!options_.getMacsFromFile().empty()) {
+        // DUID-LL made of the MAC address from the file.
+        std::vector<uint8_t> duid = { 0, 3, 0, 1 };
+        duid.insert(duid.end(), mac_addr.begin(), mac_addr.end());
+        return (duid);
+    }
+    std::vector<uint8_t> duid(options_.getDuidTemplate());
+    if (duid.size() < mac_addr.size()) {
+        isc_throw(BadValue, "invalid DUID template specified");
+    }
+    std::copy(mac_addr.begin(), mac_addr.end(),
+              duid.end() - mac_addr.size());
+    return (duid);
+}
+
+ptime
+LifecycleScen::getTimeout(ExchangeType xchg_type) const {
+    const double drop_time =
+        options_.getDropTime()[xchg_type == stage1_xchg_ ? 0 : 1];
+    return (now_ + microseconds(static_cast<int64_t>(drop_time * 1000000)));
+}
+
+void
+LifecycleScen::schedule(uint32_t index, const ptime& deadline) {
+    clients_[index].deadline_ = deadline;
+    if (!deadline.is_not_a_date_time()) {
+        timers_.push(Timer{deadline, index});
+    }
+}
+
+void
+LifecycleScen::forget(uint32_t index) {
+    auto it = transactions_.find(clients_[index].transid_);
+    if ((it != transactions_.end()) && (it->second == index)) {
+        transactions_.erase(it);
+    }
+}
+
+int64_t
+LifecycleScen::takeClient(const PktPtr& pkt) {
+    auto it = transactions_.find(pkt->getTransid());
+    if (it == transactions_.end()) {
+        // The client gave up waiting for this response.
+        return (-1);
+    }
+    uint32_t index = it->second;
+    transactions_.erase(it);
+    tc_.getStatsMgr().passRcvdPacket(clients_[index].xchg_, pkt);
+    return (index);
+}
+
+Pkt4Ptr
+LifecycleScen::createMessage4(uint32_t index, uint8_t msg_type,
+                              uint32_t transid) {
+    Pkt4Ptr pkt(new Pkt4(msg_type, transid));
+    std::vector<uint8_t> mac_addr = getMacAddress(clients_[index].id_);
+    pkt->setHWAddr(HTYPE_ETHER, mac_addr.size(), mac_addr);
+    std::vector<uint8_t> client_id(1, static_cast<uint8_t>(HTYPE_ETHER));
+    client_id.insert(client_id.end(), mac_addr.begin(), mac_addr.end());
+    pkt->addOption(OptionPtr(new Option(Option::V4, DHO_DHCP_CLIENT_IDENTIFIER,
+                                        client_id)));
+    if ((msg_type == DHCPDISCOVER) || (msg_type == DHCPREQUEST)) {
+        pkt->addOption(Option::factory(Option::V4,
+                                       DHO_DHCP_PARAMETER_REQUEST_LIST));
+    }
+    return (pkt);
+}
+
+Pkt6Ptr
+LifecycleScen::createMessage6(uint32_t index, uint8_t msg_type) {
+    Pkt6Ptr pkt(new Pkt6(msg_type, tc_.generateTransid()));
+    pkt->addOption(Option::factory(Option::V6, D6O_ELAPSED_TIME));
+    pkt->addOption(Option::factory(Option::V6, D6O_CLIENTID,
+                                   getDuid(clients_[index].id_)));
+    if ((msg_type != DHCPV6_RELEASE) && (msg_type != DHCPV6_DECLINE)) {
+        pkt->addOption(Option::factory(Option::V6, D6O_ORO));
+    }
+    return (pkt);
+}
+
+void
+LifecycleScen::send(uint32_t index, const PktPtr& pkt, ExchangeType xchg_type,
+                    ClientState state, const ptime& timeout) {
+    Client& client = clients_[index];
+    if (options_.getIpVersion() == 4) {
+        tc_.sendMessage(boost::dynamic_pointer_cast<Pkt4>(pkt), client.relay_);
+    } else {
+        tc_.sendMessage(boost::dynamic_pointer_cast<Pkt6>(pkt), client.relay_);
+    }
+    tc_.getStatsMgr().passSentPacket(xchg_type, pkt);
+
+    forget(index);
+    client.state_ = state;
+    client.transid_ = pkt->getTransid();
+    client.xchg_ = xchg_type;
+    transactions_[client.transid_] = index;
+    schedule(index, timeout);
+}
+
+void
+LifecycleScen::sendDiscover(uint32_t index) {
+    if (options_.getIpVersion() == 4) {
+        Pkt4Ptr pkt = createMessage4(index, DHCPDISCOVER, tc_.generateTransid());
+        send(index, pkt, stage1_xchg_, ClientState::SELECTING,
+             getTimeout(stage1_xchg_));
+        return;
+    }
+    Pkt6Ptr pkt = createMessage6(index, DHCPV6_SOLICIT);
+    if (options_.isRapidCommit()) {
+        pkt->addOption(Option::factory(Option::V6, D6O_RAPID_COMMIT));
+    }
+    if (options_.getLeaseType().includes(CommandOptions::LeaseType::ADDRESS)) {
+        pkt->addOption(Option::factory(Option::V6, D6O_IA_NA));
+    }
+    if (options_.getLeaseType().includes(CommandOptions::LeaseType::PREFIX)) {
+        pkt->addOption(Option::factory(Option::V6, D6O_IA_PD));
+    }
+    send(index, pkt, stage1_xchg_, ClientState::SELECTING,
+         getTimeout(stage1_xchg_));
+}
+
+void
+LifecycleScen::sendRequest(uint32_t index, const PktPtr& offer) {
+    Client& client = clients_[index];
+    if (options_.getIpVersion() == 4) {
+        Pkt4Ptr offer4 = boost::dynamic_pointer_cast<Pkt4>(offer);
+        client.server_id_ = offer4->getOption(DHO_DHCP_SERVER_IDENTIFIER);
+        if (!client.server_id_) {
+            retry(index);
+            return;
+        }
+        client.address_ = offer4->getYiaddr();
+        // Use the same transaction id as the one used in the discovery packet.
+        Pkt4Ptr pkt = createMessage4(index, DHCPREQUEST, offer4->getTransid());
+        pkt->addOption(client.server_id_);
+        OptionPtr requested_address(new Option(Option::V4,
+                                               DHO_DHCP_REQUESTED_ADDRESS,
+                                               OptionBuffer()));
+        requested_address->setUint32(client.address_.toUint32());
+        pkt->addOption(requested_address);
+        send(index, pkt, stage2_xchg_, ClientState::REQUESTING,
+             getTimeout(stage2_xchg_));
+        return;
+    }
+
+    client.server_id_ = offer->getOption(D6O_SERVERID);
+    if (!client.server_id_) {
+        retry(index);
+        return;
+    }
+    Pkt6Ptr pkt = createMessage6(index, DHCPV6_REQUEST);
+    pkt->addOption(client.server_id_);
+    for (uint16_t type : { D6O_IA_NA, D6O_IA_PD }) {
+        OptionPtr ia = offer->getOption(type);
+        if (ia) {
+            pkt->addOption(ia);
+        }
+    }
+    send(index, pkt, stage2_xchg_, ClientState::REQUESTING,
+         getTimeout(stage2_xchg_));
+}
+
+void
+LifecycleScen::sendRenew(uint32_t index, bool rebind) {
+    Client& client = clients_[index];
+    const ClientState state = rebind ? ClientState::REBINDING :
+        ClientState::RENEWING;
+    // The client waits for the response until it has to move to
+    // the next state.
+    const ptime& timeout = rebind ? client.expire_time_ : client.rebind_time_;
+    if (options_.getIpVersion() == 4) {
+        Pkt4Ptr pkt = createMessage4(index, DHCPREQUEST, tc_.generateTransid());
+        pkt->setCiaddr(client.address_);
+        send(index, pkt, rebind ? ExchangeType::RBA : ExchangeType::RNA,
+             state, timeout);
+        return;
+    }
+    Pkt6Ptr pkt = createMessage6(index, rebind ? DHCPV6_REBIND : DHCPV6_RENEW);
+    if (!rebind) {
+        pkt->addOption(client.server_id_);
+    }
+    for (auto const& ia : client.ias_) {
+        pkt->addOption(ia.second);
+    }
+    send(index, pkt, rebind ? ExchangeType::RB : ExchangeType::RN,
+         state, timeout);
+}
+
+void
+LifecycleScen::sendReboot(uint32_t index) {
+    Client& client = clients_[index];
+    if (options_.getIpVersion() == 4) {
+        // INIT-REBOOT: the client asks for its previous address without
+        // knowing which server gave it.
+        Pkt4Ptr pkt = createMessage4(index, DHCPREQUEST, tc_.generateTransid());
+        OptionPtr requested_address(new Option(Option::V4,
+                                               DHO_DHCP_REQUESTED_ADDRESS,
+                                               OptionBuffer()));
+        requested_address->setUint32(client.address_.toUint32());
+        pkt->addOption(requested_address);
+        send(index, pkt, ExchangeType::IRA, ClientState::REBOOTING,
+             getTimeout(ExchangeType::IRA));
+        return;
+    }
+    // Confirm only applies to addresses: clients with delegated prefixes
+    // rebind (RFC 8415 section 18.2.12).
+    const bool confirm =
+        !options_.getLeaseType().includes(CommandOptions::LeaseType::PREFIX);
+    Pkt6Ptr pkt = createMessage6(index, confirm ? DHCPV6_CONFIRM : DHCPV6_REBIND);
+    for (auto const& ia : client.ias_) {
+        pkt->addOption(ia.second);
+    }
+    const ExchangeType xchg_type = confirm ? ExchangeType::CR : ExchangeType::RB;
+    send(index, pkt, xchg_type, ClientState::REBOOTING, getTimeout(xchg_type));
+}
+
+void
+LifecycleScen::sendDecline(uint32_t index) {
+    Client& client = clients_[index];
+    tc_.getStatsMgr().incrementCounter("declined");
+    if (options_.getIpVersion() == 4) {
+        // There is no response to a DHCPDECLINE.
+        Pkt4Ptr pkt = createMessage4(index, DHCPDECLINE, tc_.generateTransid());
+        pkt->addOption(client.server_id_);
+        OptionPtr requested_address(new Option(Option::V4,
+                                               DHO_DHCP_REQUESTED_ADDRESS,
+                                               OptionBuffer()));
+        requested_address->setUint32(client.address_.toUint32());
+        pkt->addOption(requested_address);
+        tc_.sendMessage(pkt, client.relay_);
+        restart(index, DECLINE_WAIT);
+        return;
+    }
+    Pkt6Ptr pkt = createMessage6(index, DHCPV6_DECLINE);
+    pkt->addOption(client.server_id_);
+    auto ia = client.ias_.find(D6O_IA_NA);
+    if (ia != client.ias_.end()) {
+        pkt->addOption(ia->second);
+    }
+    send(index, pkt, ExchangeType::DR, ClientState::DECLINING,
+         getTimeout(ExchangeType::DR));
+}
+
+void
+LifecycleScen::sendRelease(uint32_t index) {
+    Client& client = clients_[index];
+    if (options_.getIpVersion() == 4) {
+        // There is no response to a DHCPRELEASE: the client is replaced
+        // at once.
+        Pkt4Ptr pkt = createMessage4(index, DHCPRELEASE, tc_.generateTransid());
+        pkt->setCiaddr(client.address_);
+        pkt->addOption(client.server_id_);
+        tc_.sendMessage(pkt, client.relay_);
+        tc_.getStatsMgr().passSentPacket(ExchangeType::RLA, pkt);
+        replace(index);
+        return;
+    }
+    Pkt6Ptr pkt = createMessage6(index, DHCPV6_RELEASE);
+    pkt->addOption(client.server_id_);
+    for (auto const& ia : client.ias_) {
+        pkt->addOption(ia.second);
+    }
+    send(index, pkt, ExchangeType::RL, ClientState::RELEASING,
+         getTimeout(ExchangeType::RL));
+}
+
+void
+LifecycleScen::restart(uint32_t index, double delay) {
+    Client& client = clients_[index];
+    forget(index);
+    client.state_ = ClientState::INIT;
+    client.address_ = options_.getIpVersion() == 4 ?
+        IOAddress::IPV4_ZERO_ADDRESS() : IOAddress::IPV6_ZERO_ADDRESS();
+    client.server_id_.reset();
+    client.ias_.clear();
+    client.renew_time_ = ptime(not_a_date_time);
+    client.rebind_time_ = ptime(not_a_date_time);
+    client.expire_time_ = ptime(not_a_date_time);
+    schedule(index, now_ + microseconds(static_cast<int64_t>(delay * 1000000)));
+}
+
+void
+LifecycleScen::retry(uint32_t index) {
+    Client& client = clients_[index];
+    // Back off 1, 2, 4 ... 64 (max) seconds adjusted by a random value
+    // in the -1..1 second range as the avalanche scenario does.
+    uint32_t delay = 1 << std::min(client.retries_, 6u);
+    ++client.retries_;
+    restart(index, delay + (random() % 2000 - 1000) / 1000.);
+}
+
+void
+LifecycleScen::replace(uint32_t index) {
+    clients_[index].id_ = next_id_++;
+    clients_[index].retries_ = 0;
+    restart(index, 0.);
+}
+
+void
+LifecycleScen::bind(uint32_t index, uint32_t lease_time, uint32_t t1,
+                    uint32_t t2) {
+    Client& client = clients_[index];
+    if (options_.getLeaseTimeMax() != 0) {
+        const uint32_t range = options_.getLeaseTimeMax() -
+            options_.getLeaseTimeMin();
+        lease_time = options_.getLeaseTimeMin() +
+            (range ? random() % (static_cast<uint64_t>(range) + 1) : 0);
+        t1 = 0;
+        t2 = 0;
+    }
+    client.state_ = ClientState::BOUND;
+    client.retries_ = 0;
+    if (lease_time == INFINITE_LEASE) {
+        client.renew_time_ = ptime(not_a_date_time);
+        client.rebind_time_ = ptime(not_a_date_time);
+        client.expire_time_ = ptime(not_a_date_time);
+        schedule(index, ptime(not_a_date_time));
+        return;
+    }
+    // Use the RFC 2131 defaults when the server does not give usable
+    // timers. They are computed in microseconds so short lease times
+    // given with --lease-time keep distinct timers.
+    const int64_t lease_us = lease_time * 1000000LL;
+    int64_t t1_us = t1 * 1000000LL;
+    int64_t t2_us = t2 * 1000000LL;
+    if ((t1_us == 0) || (t1_us > lease_us)) {
+        t1_us = lease_us / 2;
+    }
+    if ((t2_us == 0) || (t2_us < t1_us) || (t2_us > lease_us)) {
+        t2_us = std::max(t1_us, lease_us * 7 / 8);
+    }
+    client.renew_time_ = now_ + microseconds(t1_us);
+    client.rebind_time_ = now_ + microseconds(t2_us);
+    client.expire_time_ = now_ + microseconds(lease_us);
+    schedule(index, client.renew_time_);
+}
+
+void
+LifecycleScen::renewalTime(uint32_t index) {
+    const double value = roll();
+    if (value < options_.getChurn()) {
+        tc_.getStatsMgr().incrementCounter("churned");
+        sendRelease(index);
+    } else if (value < options_.getChurn() + options_.getReboot()) {
+        tc_.getStatsMgr().incrementCounter("rebooted");
+        sendReboot(index);
+    } else {
+        sendRenew(index, false);
+    }
+}
+
+void
+LifecycleScen::acquired(uint32_t index, ClientState state) {
+    StatsMgr& stats_mgr(tc_.getStatsMgr());
+    switch (state) {
+    case ClientState::SELECTING:
+    case ClientState::REQUESTING:
+        stats_mgr.incrementCounter("joined");
+        // Only addresses can be declined.
+        if (((options_.getIpVersion() == 4) ||
+             options_.getLeaseType().includes(CommandOptions::LeaseType::ADDRESS)) &&
+            (roll() < options_.getDecline())) {
+            sendDecline(index);
+        }
+        break;
+    case ClientState::RENEWING:
+        stats_mgr.incrementCounter("renewed");
+        break;
+    case ClientState::REBINDING:
+        stats_mgr.incrementCounter("rebound");
+        break;
+    default:
+        break;
+    }
+}
+
+void
+LifecycleScen::processPacket4(const Pkt4Ptr& pkt) {
+    int64_t index = takeClient(pkt);
+    if (index < 0) {
+        return;
+    }
+    Client& client = clients_[index];
+    const ClientState state = client.state_;
+    switch (state) {
+    case ClientState::SELECTING:
+        if (pkt->getType() == DHCPOFFER) {
+            sendRequest(index, pkt);
+        } else {
+            retry(index);
+        }
+        break;
+
+    case ClientState::REQUESTING:
+    case ClientState::RENEWING:
+    case ClientState::REBINDING:
+    case ClientState::REBOOTING: {
+        const uint32_t lease_time = getOptionUint32(pkt, DHO_DHCP_LEASE_TIME);
+        if ((pkt->getType() != DHCPACK) || (lease_time == 0)) {
+            tc_.getStatsMgr().incrementCounter("refused");
+            restart(index, 0.);
+            break;
+        }
+        client.address_ = pkt->getYiaddr();
+        OptionPtr server_id = pkt->getOption(DHO_DHCP_SERVER_IDENTIFIER);
+        if (server_id) {
+            client.server_id_ = server_id;
+        }
+        bind(index, lease_time, getOptionUint32(pkt, DHO_DHCP_RENEWAL_TIME),
+             getOptionUint32(pkt, DHO_DHCP_REBINDING_TIME));
+        acquired(index, state);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+bool
+LifecycleScen::getLease6(const Pkt6Ptr& pkt, uint32_t& lease_time,
+                         uint32_t& t1, uint32_t& t2,
+                         OptionCollection& ias) const {
+    lease_time = INFINITE_LEASE;
+    t1 = 0;
+    t2 = 0;
+    for (uint16_t type : { D6O_IA_NA, D6O_IA_PD }) {
+        if (!options_.getLeaseType().includes(type == D6O_IA_NA ?
+                CommandOptions::LeaseType::ADDRESS :
+                CommandOptions::LeaseType::PREFIX)) {
+            continue;
+        }
+        Option6IAPtr ia = boost::dynamic_pointer_cast<Option6IA>(pkt->getOption(type));
+        if (!ia) {
+            return (false);
+        }
+        // Option6IAPrefix derives from Option6IAAddr.
+        Option6IAAddrPtr lease = boost::dynamic_pointer_cast<Option6IAAddr>(
+            ia->getOption(type == D6O_IA_NA ? D6O_IAADDR : D6O_IAPREFIX));
+        if (!lease || (lease->getValid() == 0)) {
+            return (false);
+        }
+        lease_time = std::min(lease_time, lease->getValid());
+        if (ias.empty()) {
+            t1 = ia->getT1();
+            t2 = ia->getT2();
+        }
+        ias.insert(make_pair(type, ia));
+    }
+    return (true);
+}
+
+void
+LifecycleScen::processPacket6(const Pkt6Ptr& pkt) {
+    int64_t index = takeClient(pkt);
+    if (index < 0) {
+        return;
+    }
+    Client& client = clients_[index];
+    const ClientState state = client.state_;
+    if ((state == ClientState::SELECTING) &&
+        (pkt->getType() == DHCPV6_ADVERTISE)) {
+        sendRequest(index, pkt);
+        return;
+    }
+    if (pkt->getType() != DHCPV6_REPLY) {
+        retry(index);
+        return;
+    }
+
+    switch (state) {
+    case ClientState::SELECTING:
+        // The server answered with rapid commit.
+        client.server_id_ = pkt->getOption(D6O_SERVERID);
+        // falls through
+    case ClientState::REQUESTING:
+    case ClientState::RENEWING:
+    case ClientState::REBINDING:
+    case ClientState::REBOOTING: {
+        if (client.xchg_ == ExchangeType::CR) {
+            OptionPtr status = pkt->getOption(D6O_STATUS_CODE);
+            Option6StatusCodePtr status_code =
+                boost::dynamic_pointer_cast<Option6StatusCode>(status);
+            if (status && (!status_code ||
+                           (status_code->getStatusCode() != STATUS_Success))) {
+                tc_.getStatsMgr().incrementCounter("refused");
+                restart(index, 0.);
+            } else {
+                // The lease is still on link: it is renewed as the client
+                // missed its renewal time while rebooting.
+                sendRenew(index, false);
+            }
+            break;
+        }
+        uint32_t lease_time = 0;
+        uint32_t t1 = 0;
+        uint32_t t2 = 0;
+        OptionCollection ias;
+        if (!getLease6(pkt, lease_time, t1, t2, ias)) {
+            tc_.getStatsMgr().incrementCounter("refused");
+            restart(index, 0.);
+            break;
+        }
+        OptionPtr server_id = pkt->getOption(D6O_SERVERID);
+        if (server_id) {
+            client.server_id_ = server_id;
+        }
+        if (!client.server_id_) {
+            retry(index);
+            break;
+        }
+        client.ias_ = ias;
+        bind(index, lease_time, t1, t2);
+        acquired(index, state);
+        break;
+    }
+
+    case ClientState::DECLINING:
+        restart(index, 0.);
+        break;
+
+    case ClientState::RELEASING:
+        replace(index);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void
+LifecycleScen::handleTimer(uint32_t index) {
+    switch (clients_[index].state_) {
+    case ClientState::INIT:
+        sendDiscover(index);
+        break;
+
+    case ClientState::SELECTING:
+    case ClientState::REQUESTING:
+    case ClientState::REBOOTING:
+        retry(index);
+        break;
+
+    case ClientState::BOUND:
+        renewalTime(index);
+        break;
+
+    case ClientState::RENEWING:
+        tc_.getStatsMgr().incrementCounter("rebinding");
+        sendRenew(index, true);
+        break;
+
+    case ClientState::REBINDING:
+        tc_.getStatsMgr().incrementCounter("expired");
+        restart(index, 0.);
+        break;
+
+    case ClientState::DECLINING:
+        restart(index, 0.);
+        break;
+
+    case ClientState::RELEASING:
+        replace(index);
+        break;
+    }
+}
+
+unsigned int
+LifecycleScen::handleTimers() {
+    unsigned int handled = 0;
+    while (!timers_.empty() && (timers_.top().time_ <= now_)) {
+        const Timer timer = timers_.top();
+        timers_.pop();
+        Client& client = clients_[timer.client_];
+        if (client.deadline_ != timer.time_) {
+            // The client has moved to another state since.
+            continue;
+        }
+        client.deadline_ = ptime(not_a_date_time);
+        handleTimer(timer.client_);
+        ++handled;
+    }
+    return (handled);
+}
+
+bool
+LifecycleScen::checkExitConditions() {
+    if (tc_.interrupted()) {
+        return (true);
+    }
+    if (options_.getPeriod() != 0) {
+        time_period period(tc_.getStatsMgr().getTestPeriod());
+        if (period.length().total_seconds() >= options_.getPeriod()) {
+            if (options_.testDiags('e')) {
+                std::cout << "reached test-period." << std::endl;
+            }
+            return (true);
+        }
+    }
+    return (false);
+}
+
+void
+LifecycleScen::runLoop() {
+    // The clients join at the requested rate, or all at once.
+    const int rate = options_.getRate();
+    now_ = microsec_clock::universal_time();
+    for (uint32_t i = 0; i < clients_.size(); ++i) {
+        schedule(i, rate > 0 ? now_ + microseconds(1000000LL * i / rate) : now_);
+    }
+
+    while (!checkExitConditions()) {
+        unsigned int work = 0;
+        for (PktPtr pkt = tc_.getReceivedPacket(); pkt;
+             pkt = tc_.getReceivedPacket()) {
+            now_ = microsec_clock::universal_time();
+            if (options_.getIpVersion() == 4) {
+                processPacket4(boost::dynamic_pointer_cast<Pkt4>(pkt));
+            } else {
+                processPacket6(boost::dynamic_pointer_cast<Pkt6>(pkt));
+            }
+            ++work;
+        }
+
+        now_ = microsec_clock::universal_time();
+        work += handleTimers();
+
+        if (options_.getReportDelay() > 0) {
+            tc_.printIntermediateStats();
+        }
+
+        if (work == 0) {
+            usleep(POLL_INTERVAL);
+        }
+    }
+}
+
+int
+LifecycleScen::run() {
+    StatsMgr& stats_mgr(tc_.getStatsMgr());
+
+    // Fork and run command specified with -w<wrapped-command>
+    if (!options_.getWrapped().empty()) {
+        tc_.runWrapped();
+    }
+
+    tc_.start();
+
+    runLoop();
+
+    tc_.stop();
+
+    tc_.printStats();
+
+    // The client events are printed with the other custom counters
+    // when -xi is given.
+    if (!options_.testDiags('i')) {
+        stats_mgr.printCustomCounters();
+    }
+
+    if (!options_.getWrapped().empty()) {
+        // true means that we execute wrapped command with 'stop' argument.
+        tc_.runWrapped(true);
+    }
+
+    // Print packet timestamps
+    if (options_.testDiags('t')) {
+        stats_mgr.printTimestamps();
+    }
+
+    // Print server id.
+    if (options_.testDiags('s') && tc_.serverIdReceived()) {
+        std::cout << "Server id: " << tc_.getServerId() << std::endl;
+    }
+
+    // Diagnostics flag 'e' means show exit reason.
+    if (options_.testDiags('e')) {
+        std::cout << "Interrupted" << std::endl;
+    }
+
+    // Print any received leases.
+    if (options_.testDiags('l')) {
+        stats_mgr.printLeases();
+    }
+
+    // Check if any packet drops occurred.
+    return (stats_mgr.droppedPackets() ? 3 : 0);
+}
+
+}  // namespace perfdhcp
+}  // namespace isc
@@ -0,0 +1,339 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LIFECYCLE_SCEN_H
+#define LIFECYCLE_SCEN_H
+
+#include <config.h>
+
+#include <perfdhcp/abstract_scen.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/option.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace perfdhcp {
+
+/// \brief Lifecycle Scenario class.
+///
+/// This class simulates a population of DHCP clients which keep their
+/// leases over a long period of time. The clients join at the rate
+/// given with -r and then follow the lease timers: they renew at T1,
+/// rebind at T2 when the renewal is not answered and start again when
+/// their lease expires or when the server refuses it. At each renewal
+/// a client may instead leave and be replaced by a new one (--churn)
+/// or reboot (--reboot). A client may also decline an assigned lease
+/// (--decline). The lease times are given by the server or chosen
+/// with --lease-time. The clients keep the relay address chosen from
+/// the -J list when they join.
+///
+/// The delays and drops of each message type are tracked in their own
+/// exchange and the client events in custom counters.
+class LifecycleScen : public AbstractScen {
+public:
+    /// \brief State of a simulated client.
+    enum class ClientState {
+        INIT,        ///< Waiting to send a Discover or Solicit.
+        SELECTING,   ///< Waiting for an Offer or Advertise.
+        REQUESTING,  ///< Waiting for the response to a Request.
+        BOUND,       ///< Holding a lease, waiting for T1.
+        RENEWING,    ///< Waiting for the response to a renewal.
+        REBINDING,   ///< Waiting for the response to a rebinding.
+        REBOOTING,   ///< Waiting for the response to an init-reboot
+                     ///< Request or a Confirm.
+        DECLINING,   ///< Waiting for the response to a Decline.
+        RELEASING    ///< Waiting for the response to a Release.
+    };
+
+    /// \brief Default and the only constructor of LifecycleScen.
+    ///
+    /// \param options reference to command options,
+    /// \param socket reference to a socket.
+    LifecycleScen(CommandOptions& options, BasePerfSocket& socket);
+
+    /// \brief Run performance test.
+    ///
+    /// Method runs the simulation until the end of the test period
+    /// or until it is interrupted and prints the statistics.
+    ///
+    /// \return execution status.
+    int run() override;
+
+protected:
+    /// \brief A simulated client.
+    struct Client {
+        /// \brief Constructor.
+        Client();
+
+        /// Current state.
+        ClientState state_;
+
+        /// Identifier number used to build the MAC address and DUID.
+        /// It changes when the client is replaced.
+        uint32_t id_;
+
+        /// Transaction id of the message waiting for a response.
+        uint32_t transid_;
+
+        /// Exchange of the message waiting for a response.
+        ExchangeType xchg_;
+
+        /// Number of successive failed attempts to get a lease.
+        uint32_t retries_;
+
+        /// Time of the next event of the client.
+        boost::posix_time::ptime deadline_;
+
+        /// Time of the renewal (T1).
+        boost::posix_time::ptime renew_time_;
+
+        /// Time of the rebinding (T2).
+        boost::posix_time::ptime rebind_time_;
+
+        /// Time of the lease expiration.
+        boost::posix_time::ptime expire_time_;
+
+        /// Relay address or zero address to use the default.
+        asiolink::IOAddress relay_;
+
+        /// Leased DHCPv4 address.
+        asiolink::IOAddress address_;
+
+        /// Server identifier of the lease.
+        dhcp::OptionPtr server_id_;
+
+        /// DHCPv6 IA options of the lease.
+        dhcp::OptionCollection ias_;
+    };
+
+    /// \brief Pending event of a client.
+    struct Timer {
+        /// Time of the event.
+        boost::posix_time::ptime time_;
+
+        /// Index of the client.
+        uint32_t client_;
+
+        /// \brief Order the timers by time.
+        bool operator>(const Timer& other) const {
+            return (time_ > other.time_);
+        }
+    };
+
+    /// \brief Set the time of the next event of a client.
+    ///
+    /// \param index index of the client.
+    /// \param deadline time of the event.
+    void schedule(uint32_t index, const boost::posix_time::ptime& deadline);
+
+    /// \brief Handle the expired events.
+    ///
+    /// \return number of handled events.
+    unsigned int handleTimers();
+
+    /// \brief Handle the event of a client.
+    ///
+    /// \param index index of the client.
+    void handleTimer(uint32_t index);
+
+    /// \brief Check if the test should stop.
+    ///
+    /// \return true if the test period passed or the test was
+    /// interrupted.
+    bool checkExitConditions();
+
+    /// \brief Run the simulation until an exit condition is fulfilled.
+    void runLoop();
+
+    /// \brief Handle a received DHCPv4 packet.
+    ///
+    /// \param pkt the packet.
+    void processPacket4(const dhcp::Pkt4Ptr& pkt);
+
+    /// \brief Handle a received DHCPv6 packet.
+    ///
+    /// \param pkt the packet.
+    void processPacket6(const dhcp::Pkt6Ptr& pkt);
+
+    /// \brief Take the client waiting for a response.
+    ///
+    /// The client is no longer waiting and the response is passed to
+    /// the statistics of the exchange.
+    ///
+    /// \param pkt the response.
+    /// \return index of the client or -1 if no client waits for it.
+    int64_t takeClient(const dhcp::PktPtr& pkt);
+
+    /// \brief Stop waiting for the response to the last message of a client.
+    ///
+    /// \param index index of the client.
+    void forget(uint32_t index);
+
+    /// \brief Get the lease given in a DHCPv6 Reply.
+    ///
+    /// \param pkt the Reply.
+    /// \param [out] lease_time shortest valid lifetime of the leases.
+    /// \param [out] t1 renewal time of the first IA.
+    /// \param [out] t2 rebinding time of the first IA.
+    /// \param [out] ias IA options holding the leases.
+    /// \return false if one of the requested leases is missing.
+    bool getLease6(const dhcp::Pkt6Ptr& pkt, uint32_t& lease_time,
+                   uint32_t& t1, uint32_t& t2,
+                   dhcp::OptionCollection& ias) const;
+
+    /// \brief Handle a lease assigned or extended by the server.
+    ///
+    /// \param index index of the client.
+    /// \param lease_time valid lifetime given by the server.
+    /// \param t1 renewal time given by the server or 0.
+    /// \param t2 rebinding time given by the server or 0.
+    void bind(uint32_t index, uint32_t lease_time, uint32_t t1, uint32_t t2);
+
+    /// \brief Account a lease bound by a client.
+    ///
+    /// A new lease may be declined.
+    ///
+    /// \param index index of the client.
+    /// \param state state of the client when it received the lease.
+    void acquired(uint32_t index, ClientState state);
+
+    /// \brief Restart the configuration of a client.
+    ///
+    /// \param index index of the client.
+    /// \param delay delay in seconds before the new Discover or Solicit.
+    void restart(uint32_t index, double delay);
+
+    /// \brief Restart the configuration of a client after a failure.
+    ///
+    /// The delay grows with the number of successive failures.
+    ///
+    /// \param index index of the client.
+    void retry(uint32_t index);
+
+    /// \brief Handle the renewal time of a client.
+    ///
+    /// The client renews, leaves or reboots.
+    ///
+    /// \param index index of the client.
+    void renewalTime(uint32_t index);
+
+    /// \brief Replace a client which left by a new one.
+    ///
+    /// \param index index of the client.
+    void replace(uint32_t index);
+
+    /// \brief Send a Discover or Solicit.
+    ///
+    /// \param index index of the client.
+    void sendDiscover(uint32_t index);
+
+    /// \brief Send a Request in response to an Offer or Advertise.
+    ///
+    /// \param index index of the client.
+    /// \param offer the Offer or Advertise.
+    void sendRequest(uint32_t index, const dhcp::PktPtr& offer);
+
+    /// \brief Send a renewal or a rebinding.
+    ///
+    /// \param index index of the client.
+    /// \param rebind send a rebinding when true.
+    void sendRenew(uint32_t index, bool rebind);
+
+    /// \brief Send an init-reboot Request, a Confirm or a Rebind.
+    ///
+    /// \param index index of the client.
+    void sendReboot(uint32_t index);
+
+    /// \brief Send a Decline for the lease of a client.
+    ///
+    /// \param index index of the client.
+    void sendDecline(uint32_t index);
+
+    /// \brief Send a Release for the lease of a client.
+    ///
+    /// \param index index of the client.
+    void sendRelease(uint32_t index);
+
+    /// \brief Create a DHCPv4 message of a client.
+    ///
+    /// \param index index of the client.
+    /// \param msg_type message type.
+    /// \param transid transaction id.
+    /// \return the message with the client identifiers.
+    dhcp::Pkt4Ptr createMessage4(uint32_t index, uint8_t msg_type,
+                                 uint32_t transid);
+
+    /// \brief Create a DHCPv6 message of a client.
+    ///
+    /// \param index index of the client.
+    /// \param msg_type message type.
+    /// \return the message with the client identifier.
+    dhcp::Pkt6Ptr createMessage6(uint32_t index, uint8_t msg_type);
+
+    /// \brief Send a message of a client and wait for the response.
+    ///
+    /// \param index index of the client.
+    /// \param pkt the message.
+    /// \param xchg_type exchange of the message.
+    /// \param state state of the client waiting for the response.
+    /// \param timeout time of the end of the wait.
+    void send(uint32_t index, const dhcp::PktPtr& pkt, ExchangeType xchg_type,
+              ClientState state, const boost::posix_time::ptime& timeout);
+
+    /// \brief Return MAC address of a client.
+    ///
+    /// \param id identifier number of the client.
+    /// \return MAC address.
+    std::vector<uint8_t> getMacAddress(uint32_t id) const;
+
+    /// \brief Return DUID of a client.
+    ///
+    /// \param id identifier number of the client.
+    /// \return DUID.
+    std::vector<uint8_t> getDuid(uint32_t id) const;
+
+    /// \brief Return the time after which a request is dropped.
+    ///
+    /// \param xchg_type exchange of the request.
+    /// \return time of the end of the wait for the response.
+    boost::posix_time::ptime getTimeout(ExchangeType xchg_type) const;
+
+    /// \brief Return a random percentage.
+    ///
+    /// An event of a given percentage happens when it is greater than
+    /// the returned value.
+    ///
+    /// \return random value in the 0..100 range.
+    static double roll();
+
+    /// The simulated clients.
+    std::vector<Client> clients_;
+
+    /// Pending events of the clients. An event is ignored when its time
+    /// is not the deadline of the client anymore.
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer> > timers_;
+
+    /// Clients waiting for a response by transaction id.
+    std::unordered_map<uint32_t, uint32_t> transactions_;
+
+    /// Current time of the simulation.
+    boost::posix_time::ptime now_;
+
+    /// Number of identifiers given to the clients.
+    uint32_t next_id_;
+};
+
+}
+}
+
+#endif // LIFECYCLE_SCEN_H
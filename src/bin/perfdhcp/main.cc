@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,8 @@
 #include <perfdhcp/avalanche_scen.h>
 #include <perfdhcp/basic_scen.h>
 #include <perfdhcp/command_options.h>
+#include <perfdhcp/lifecycle_scen.h>
+#include <perfdhcp/parallel_scen.h>
 
 #include <exceptions/exceptions.h>
 
@@ -36,6 +38,11 @@ main(int argc, char* argv[]) {
             return (ret_code);
         }
         parser_error = false;
+        // With several traffic threads each thread opens its own socket.
+        if (command_options.getThreadsNum() > 1) {
+            ParallelScen scen(command_options);
+            return (scen.run());
+        }
         auto scenario = command_options.getScenario();
         PerfSocket socket(command_options);
         if (scenario == Scenario::BASIC) {
@@ -44,6 +51,9 @@ main(int argc, char* argv[]) {
         } else if (scenario == Scenario::AVALANCHE) {
             AvalancheScen scen(command_options, socket);
             ret_code = scen.run();
+        } else if (scenario == Scenario::LIFECYCLE) {
+            LifecycleScen scen(command_options, socket);
+            ret_code = scen.run();
         }
     } catch (const std::exception& e) {
         ret_code = 1;
@@ -0,0 +1,186 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <perfdhcp/parallel_scen.h>
+
+#include <util/multi_threading_mgr.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <iostream>
+
+using namespace std;
+using namespace boost::posix_time;
+using namespace isc;
+using namespace isc::util;
+
+
+namespace isc {
+namespace perfdhcp {
+
+namespace {
+
+/// Interval in microseconds between two checks of the traffic threads.
+const useconds_t POLL_INTERVAL = 1000;
+
+/// \brief Enables the multi-threading mode of the libraries in a scope.
+///
+/// The libraries then protect the state shared by the traffic threads,
+/// e.g. the interface cache of the Interface Manager.
+class MultiThreadingScope {
+public:
+    /// \brief Constructor.
+    MultiThreadingScope() {
+        MultiThreadingMgr::instance().setMode(true);
+    }
+
+    /// \brief Destructor.
+    ~MultiThreadingScope() {
+        MultiThreadingMgr::instance().setMode(false);
+    }
+};
+
+}
+
+ParallelScen::ParallelScen(CommandOptions& options)
+    : options_(options), stats_mgr_(options), running_(0) {
+}
+
+ParallelScen::~ParallelScen() {
+    join();
+}
+
+std::unique_ptr<BasePerfSocket>
+ParallelScen::createSocket(CommandOptions& options) {
+    return (std::unique_ptr<BasePerfSocket>(new PerfSocket(options)));
+}
+
+void
+ParallelScen::join() {
+    for (auto const& traffic : traffic_) {
+        if (traffic->thread_.joinable()) {
+            traffic->thread_.join();
+        }
+    }
+}
+
+void
+ParallelScen::aggregateStats() {
+    stats_mgr_.resetExchanges();
+    for (auto const& traffic : traffic_) {
+        traffic->scen_->mergeStats(stats_mgr_);
+    }
+}
+
+int
+ParallelScen::run() {
+    MultiThreadingScope mt_scope;
+
+    // Each traffic thread has its own options, socket and test control.
+    for (uint32_t i = 0; i < options_.getThreadsNum(); ++i) {
+        std::unique_ptr<Traffic> traffic(new Traffic(options_.getThreadOptions(i)));
+        traffic->socket_ = createSocket(traffic->options_);
+        traffic->scen_.reset(new BasicScen(traffic->options_, *traffic->socket_));
+        traffic_.push_back(std::move(traffic));
+    }
+    TestControl& first_tc = traffic_.front()->scen_->getTestControl();
+
+    // Fork and run command specified with -w<wrapped-command>
+    if (!options_.getWrapped().empty()) {
+        first_tc.runWrapped();
+    }
+
+    running_ = traffic_.size();
+    for (auto const& traffic : traffic_) {
+        Traffic* thread_traffic = traffic.get();
+        traffic->thread_ = std::thread([this, thread_traffic]() {
+            try {
+                thread_traffic->scen_->runThread();
+            } catch (...) {
+                thread_traffic->error_ = std::current_exception();
+                // Stop the other threads too.
+                TestControl::interrupt();
+            }
+            --running_;
+        });
+    }
+
+    // Report delay means that user requested printing number
+    // of sent/received/dropped packets repeatedly.
+    ptime last_report = microsec_clock::universal_time();
+    while (running_ > 0) {
+        usleep(POLL_INTERVAL);
+        if (options_.getReportDelay() > 0) {
+            ptime now = microsec_clock::universal_time();
+            time_period time_since_report(last_report, now);
+            if (time_since_report.length().total_seconds() >=
+                options_.getReportDelay()) {
+                aggregateStats();
+                stats_mgr_.printIntermediateStats(options_.getCleanReport(),
+                                                  options_.getCleanReportSeparator());
+                last_report = now;
+            }
+        }
+    }
+    join();
+
+    for (auto const& traffic : traffic_) {
+        if (traffic->error_) {
+            std::rethrow_exception(traffic->error_);
+        }
+    }
+
+    aggregateStats();
+    TestControl::printStats(options_, stats_mgr_);
+
+    if (!options_.getWrapped().empty()) {
+        // true means that we execute wrapped command with 'stop' argument.
+        first_tc.runWrapped(true);
+    }
+
+    // The packets are kept by the statistics of the traffic threads.
+    if (options_.testDiags('t')) {
+        for (auto const& traffic : traffic_) {
+            traffic->scen_->getTestControl().getStatsMgr().printTimestamps();
+        }
+    }
+
+    // Print server id.
+    if (options_.testDiags('s')) {
+        for (auto const& traffic : traffic_) {
+            TestControl& tc = traffic->scen_->getTestControl();
+            if (tc.serverIdReceived()) {
+                std::cout << "Server id: " << tc.getServerId() << std::endl;
+                break;
+            }
+        }
+    }
+
+    // Diagnostics flag 'e' means show exit reason.
+    if (options_.testDiags('e')) {
+        std::cout << "Interrupted" << std::endl;
+    }
+
+    // Print packet templates.
+    if (options_.testDiags('T')) {
+        first_tc.printTemplates();
+    }
+
+    // Print any received leases.
+    if (options_.testDiags('l')) {
+        for (auto const& traffic : traffic_) {
+            traffic->scen_->getTestControl().getStatsMgr().printLeases();
+        }
+    }
+
+    // Check if any packet drops occurred.
+    return (stats_mgr_.droppedPackets() ? 3 : 0);
+}
+
+}  // namespace perfdhcp
+}  // namespace isc
@@ -0,0 +1,122 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PARALLEL_SCEN_H
+#define PARALLEL_SCEN_H
+
+#include <config.h>
+
+#include <perfdhcp/basic_scen.h>
+#include <perfdhcp/command_options.h>
+#include <perfdhcp/perf_socket.h>
+#include <perfdhcp/stats_mgr.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace isc {
+namespace perfdhcp {
+
+
+/// \brief Parallel Scenario class.
+///
+/// This class runs the basic scenario with several pairs of sender
+/// and receiver threads, their number is given with --threads. Each
+/// traffic thread has its own socket, range of simulated clients,
+/// share of the rates and limits and statistics. The main thread
+/// aggregates the statistics of the traffic threads and prints the
+/// reports.
+class ParallelScen : public boost::noncopyable {
+public:
+    /// \brief Default and the only constructor of ParallelScen.
+    ///
+    /// \param options reference to command options.
+    ParallelScen(CommandOptions& options);
+
+    /// \brief Destructor.
+    ///
+    /// Waits for the traffic threads which are still running.
+    virtual ~ParallelScen();
+
+    /// \brief Run performance test.
+    ///
+    /// Method opens the sockets, starts the traffic threads, prints
+    /// the intermediate reports until all threads have finished and
+    /// then prints the final report.
+    ///
+    /// \throw isc::Unexpected if internal Test Controller error occurred.
+    /// \return execution status.
+    int run();
+
+    /// \brief Return the statistics aggregated from the traffic threads.
+    ///
+    /// \return the statistics manager.
+    const StatsMgr& getStatsMgr() const { return (stats_mgr_); }
+
+protected:
+    /// \brief Traffic thread.
+    struct Traffic {
+        /// \brief Constructor.
+        ///
+        /// \param options command options of the traffic thread.
+        Traffic(const CommandOptions& options) : options_(options) {
+        }
+
+        /// Command options of the traffic thread.
+        CommandOptions options_;
+
+        /// Socket of the traffic thread.
+        std::unique_ptr<BasePerfSocket> socket_;
+
+        /// Scenario run by the traffic thread.
+        std::unique_ptr<BasicScen> scen_;
+
+        /// The thread.
+        std::thread thread_;
+
+        /// Error which stopped the thread.
+        std::exception_ptr error_;
+    };
+
+    /// \brief Open the socket of a traffic thread.
+    ///
+    /// \param options command options of the traffic thread.
+    /// \return the socket.
+    virtual std::unique_ptr<BasePerfSocket>
+    createSocket(CommandOptions& options);
+
+    /// \brief The traffic threads.
+    std::vector<std::unique_ptr<Traffic> > traffic_;
+
+private:
+    /// \brief Aggregate the statistics of the traffic threads.
+    ///
+    /// The statistics of the threads are added together in the
+    /// statistics manager of the test and their report interval is
+    /// restarted.
+    void aggregateStats();
+
+    /// \brief Wait for the end of the traffic threads.
+    void join();
+
+    CommandOptions& options_; ///< Reference to commandline options.
+
+    /// Statistics aggregated from the traffic threads.
+    StatsMgr stats_mgr_;
+
+    /// Number of traffic threads still running.
+    std::atomic<uint32_t> running_;
+};
+
+}
+}
+
+#endif // PARALLEL_SCEN_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,13 +14,18 @@
 #include <dhcp/iface_mgr.h>
 #include <asiolink/io_address.h>
 
+#include <cerrno>
+#include <cstring>
+#include <sys/select.h>
+
 using namespace isc::dhcp;
 using namespace isc::asiolink;
 
 namespace isc {
 namespace perfdhcp {
 
-PerfSocket::PerfSocket(CommandOptions& options) {
+PerfSocket::PerfSocket(CommandOptions& options)
+    : direct_(options.getThreadsNum() > 1) {
     sockfd_ = openSocket(options);
     initSocketData();
 }
@@ -56,6 +61,8 @@ PerfSocket::openSocket(CommandOptions& options) const {
             port = 67; /// @todo: find out why port 68 is wrong here.
         }
     }
+    // Traffic threads use consecutive ports.
+    port += options.getThreadIndex();
 
     // Local name is specified along with '-l' option.
     // It may point to interface name or local address.
@@ -126,9 +133,8 @@ PerfSocket::openSocket(CommandOptions& options) const {
 }
 
 PerfSocket::~PerfSocket() {
-    IfacePtr iface = IfaceMgr::instance().getIface(ifindex_);
-    if (iface) {
-        iface->delSocket(sockfd_);
+    if (iface_) {
+        iface_->delSocket(sockfd_);
     }
 }
 
@@ -137,6 +143,7 @@ PerfSocket::initSocketData() {
     for (IfacePtr iface : IfaceMgr::instance().getIfaces()) {
         for (SocketInfo s : iface->getSockets()) {
             if (s.sockfd_ == sockfd_) {
+                iface_ = iface;
                 ifindex_ = iface->getIndex();
                 addr_ = s.addr_;
                 return;
@@ -146,9 +153,36 @@ PerfSocket::initSocketData() {
     isc_throw(BadValue, "interface for specified socket descriptor not found");
 }
 
+bool
+PerfSocket::waitForData(uint32_t timeout_sec, uint32_t timeout_usec) const {
+    fd_set sockets;
+    FD_ZERO(&sockets);
+    FD_SET(sockfd_, &sockets);
+
+    struct timeval select_timeout;
+    select_timeout.tv_sec = timeout_sec;
+    select_timeout.tv_usec = timeout_usec;
+
+    int result = select(sockfd_ + 1, &sockets, 0, 0, &select_timeout);
+    if (result < 0) {
+        // The wait is interrupted when the test is stopped.
+        if (errno == EINTR) {
+            return (false);
+        }
+        isc_throw(SocketReadError, "failed to wait on socket " << sockfd_
+                  << ": " << strerror(errno));
+    }
+    return (result > 0);
+}
+
 Pkt4Ptr
 PerfSocket::receive4(uint32_t timeout_sec, uint32_t timeout_usec) {
-    Pkt4Ptr pkt = IfaceMgr::instance().receive4(timeout_sec, timeout_usec);
+    Pkt4Ptr pkt;
+    if (!direct_) {
+        pkt = IfaceMgr::instance().receive4(timeout_sec, timeout_usec);
+    } else if (waitForData(timeout_sec, timeout_usec)) {
+        pkt = packet_filter4_.receive(*iface_, *this);
+    }
     if (pkt) {
         try {
             pkt->unpack();
@@ -163,7 +197,12 @@ PerfSocket::receive4(uint32_t timeout_sec, uint32_t timeout_usec) {
 
 Pkt6Ptr
 PerfSocket::receive6(uint32_t timeout_sec, uint32_t timeout_usec) {
-    Pkt6Ptr pkt = IfaceMgr::instance().receive6(timeout_sec, timeout_usec);
+    Pkt6Ptr pkt;
+    if (!direct_) {
+        pkt = IfaceMgr::instance().receive6(timeout_sec, timeout_usec);
+    } else if (waitForData(timeout_sec, timeout_usec)) {
+        pkt = packet_filter6_.receive(*this);
+    }
     if (pkt) {
         try {
             pkt->unpack();
@@ -178,17 +217,23 @@ PerfSocket::receive6(uint32_t timeout_sec, uint32_t timeout_usec) {
 
 bool
 PerfSocket::send(const Pkt4Ptr& pkt) {
+    if (direct_) {
+        return (packet_filter4_.send(*iface_, sockfd_, pkt) == 0);
+    }
     return IfaceMgr::instance().send(pkt);
 }
 
 bool
 PerfSocket::send(const Pkt6Ptr& pkt) {
+    if (direct_) {
+        return (packet_filter6_.send(*iface_, sockfd_, pkt) == 0);
+    }
     return IfaceMgr::instance().send(pkt);
 }
 
 IfacePtr
 PerfSocket::getIface() {
-    return (IfaceMgr::instance().getIface(ifindex_));
+    return (iface_);
 }
 
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,8 @@
 #include <dhcp/pkt6.h>
 #include <dhcp/socket_info.h>
 #include <dhcp/iface_mgr.h>
+#include <dhcp/pkt_filter_inet.h>
+#include <dhcp/pkt_filter_inet6.h>
 
 namespace isc {
 namespace perfdhcp {
@@ -61,13 +63,18 @@ public:
 /// when exception occurs). This structure extends parent
 /// structure with new field ifindex_ that holds interface
 /// index where socket is bound to.
+///
+/// When the traffic is generated by several threads each of them
+/// has its own socket which is read and written directly, not
+/// through the Interface Manager which waits on all open sockets.
 class PerfSocket : public BasePerfSocket {
 public:
     /// \brief Constructor of socket wrapper class.
     ///
     /// This constructor uses provided socket descriptor to
     /// find the name of the interface where socket has been
-    /// bound to.
+    /// bound to. The socket of a traffic thread is bound to
+    /// the local port plus the index of the thread.
     PerfSocket(CommandOptions& options);
 
     /// \brief Destructor of the socket wrapper class.
@@ -101,7 +108,9 @@ public:
     /// \return true if operation succeeded
     virtual bool send(const dhcp::Pkt6Ptr& pkt) override;
 
-    /// \brief Get interface from IfaceMgr.
+    /// \brief Get interface of the socket.
+    ///
+    /// The interface is found in IfaceMgr when the socket is opened.
     ///
     /// \return shared pointer to Iface.
     virtual dhcp::IfacePtr getIface() override;
@@ -135,6 +144,26 @@ protected:
     /// \throw isc::Unexpected if internal unexpected error occurred.
     /// \return socket descriptor.
     int openSocket(CommandOptions& options) const;
+
+    /// \brief Wait for a packet on the socket.
+    ///
+    /// \param timeout_sec number of seconds for waiting for a packet,
+    /// \param timeout_usec number of microseconds for waiting for a packet,
+    /// \throw isc::dhcp::SocketReadError if the socket can't be polled.
+    /// \return true if a packet can be read.
+    bool waitForData(uint32_t timeout_sec, uint32_t timeout_usec) const;
+
+    /// \brief Interface where the socket is bound to.
+    dhcp::IfacePtr iface_;
+
+    /// \brief Read and write the socket directly.
+    bool direct_;
+
+    /// \brief Packet filter used to read and write DHCPv4 packets directly.
+    dhcp::PktFilterInet packet_filter4_;
+
+    /// \brief Packet filter used to read and write DHCPv6 packets directly.
+    dhcp::PktFilterInet6 packet_filter6_;
 };
 
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 #include <dhcp/iface_mgr.h>
 
 #include <functional>
+#include <vector>
 
 using namespace std;
 using namespace isc::dhcp;
@@ -19,6 +20,12 @@ using namespace isc::dhcp;
 namespace isc {
 namespace perfdhcp {
 
+namespace {
+
+/// Maximum number of packets pushed at once to the queue.
+const size_t RECEIVE_BATCH = 64;
+
+}
 
 void
 Receiver::start() {
@@ -61,16 +68,20 @@ Receiver::getPkt() {
         return readPktFromSocket();
     } else {
         // In multi thread mode read packet from the queue which is feed by Receiver thread.
-        std::lock_guard<std::mutex> lock(pkt_queue_mutex_);
-        if (pkt_queue_.empty()) {
+        // All queued packets are taken at once.
+        if (consumer_queue_.empty()) {
+            std::lock_guard<std::mutex> lock(pkt_queue_mutex_);
+            pkt_queue_.swap(consumer_queue_);
+        }
+        if (consumer_queue_.empty()) {
             if (ip_version_ == 4) {
                 return Pkt4Ptr();
             } else {
                 return Pkt6Ptr();
             }
         }
-        auto pkt = pkt_queue_.front();
-        pkt_queue_.pop();
+        auto pkt = consumer_queue_.front();
+        consumer_queue_.pop();
         return pkt;
     }
 }
@@ -98,12 +109,13 @@ Receiver::run() {
 }
 
 PktPtr
-Receiver::readPktFromSocket() {
+Receiver::readPktFromSocket(bool wait) {
     PktPtr pkt;
     uint32_t timeout;
-    if (single_threaded_) {
+    if (single_threaded_ || !wait) {
         // In case of single thread just check socket and if empty exit immediately
-        // to not slow down sending part.
+        // to not slow down sending part. The same is done when a batch
+        // of packets is being read.
         timeout = 0;
     } else {
         // In case of multi thread wait for packets a little bit (1ms) as it is run
@@ -125,18 +137,35 @@ Receiver::readPktFromSocket() {
 
 void
 Receiver::receivePackets() {
+    std::vector<PktPtr> batch;
+    batch.reserve(RECEIVE_BATCH);
+    bool wait = true;
     while (true) {
-        PktPtr pkt = readPktFromSocket();
-        if (!pkt) {
-            break;
+        // Wait only for the first packet, the following ones are read
+        // while they are available.
+        PktPtr pkt = readPktFromSocket(wait);
+        wait = false;
+        if (pkt) {
+            // Drop the packet if not supported. Do not bother main thread about it.
+            if (pkt->getType() == DHCPOFFER || pkt->getType() == DHCPACK ||
+                pkt->getType() == DHCPV6_ADVERTISE || pkt->getType() == DHCPV6_REPLY) {
+                batch.push_back(pkt);
+            }
+            if (batch.size() < RECEIVE_BATCH) {
+                continue;
+            }
         }
 
-        // Drop the packet if not supported. Do not bother main thread about it.
-        if (pkt->getType() == DHCPOFFER || pkt->getType() == DHCPACK ||
-            pkt->getType() == DHCPV6_ADVERTISE || pkt->getType() == DHCPV6_REPLY) {
-            // Otherwise push the packet to the queue, to main thread.
+        // Otherwise push the packets to the queue, to main thread.
+        if (!batch.empty()) {
             std::lock_guard<std::mutex> lock(pkt_queue_mutex_);
-            pkt_queue_.push(pkt);
+            for (auto const& rcvd : batch) {
+                pkt_queue_.push(rcvd);
+            }
+        }
+        batch.clear();
+        if (!pkt) {
+            break;
         }
     }
 }
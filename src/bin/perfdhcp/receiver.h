@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -42,6 +42,12 @@ private:
     /// \brief Queue for passing packets from receiver thread to main thread.
     std::queue<dhcp::PktPtr> pkt_queue_;
 
+    /// \brief Packets taken at once from the queue by the main thread.
+    ///
+    /// The main thread swaps it with the queue when it is empty so
+    /// the mutex is not locked for every packet.
+    std::queue<dhcp::PktPtr> consumer_queue_;
+
     /// \brief Mutex for controlling access to the queue.
     std::mutex pkt_queue_mutex_;
 
@@ -90,11 +96,14 @@ private:
 
     /// \brief Receive packets from sockets and pushes them to the queue.
     ///
-    /// It runs in a loop until socket is empty.
+    /// It runs in a loop until socket is empty. The packets are pushed
+    /// to the queue in batches.
     void receivePackets();
 
     /// \brief Read a packet directly from the socket.
-    dhcp::PktPtr readPktFromSocket();
+    ///
+    /// \param wait wait a little for a packet in multi-thread mode.
+    dhcp::PktPtr readPktFromSocket(bool wait = true);
 };
 
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,6 +6,7 @@
 
 #include <config.h>
 
+#include <cc/data.h>
 #include <dhcp/dhcp4.h>
 #include <dhcp/dhcp6.h>
 #include <dhcp/duid.h>
@@ -15,6 +16,11 @@
 #include <perfdhcp/stats_mgr.h>
 #include <perfdhcp/test_control.h>
 
+#include <iomanip>
+#include <sstream>
+
+using isc::data::Element;
+using isc::data::ElementPtr;
 using isc::dhcp::DHO_DHCP_CLIENT_IDENTIFIER;
 using isc::dhcp::DUID;
 using isc::dhcp::Option6IAAddr;
@@ -35,11 +41,16 @@ int dhcpVersion(ExchangeType const exchange_type) {
     case ExchangeType::RA:
     case ExchangeType::RNA:
     case ExchangeType::RLA:
+    case ExchangeType::RBA:
+    case ExchangeType::IRA:
         return 4;
     case ExchangeType::SA:
     case ExchangeType::RR:
     case ExchangeType::RN:
     case ExchangeType::RL:
+    case ExchangeType::RB:
+    case ExchangeType::CR:
+    case ExchangeType::DR:
         return 6;
     default:
         isc_throw(BadValue,
@@ -58,6 +69,10 @@ std::ostream& operator<<(std::ostream& os, ExchangeType xchg_type)
         return(os << "REQUEST-ACK (renewal)");
     case ExchangeType::RLA:
         return(os << "RELEASE");
+    case ExchangeType::RBA:
+        return(os << "REQUEST-ACK (rebinding)");
+    case ExchangeType::IRA:
+        return(os << "REQUEST-ACK (init-reboot)");
     case ExchangeType::SA:
         return(os << "SOLICIT-ADVERTISE");
     case ExchangeType::RR:
@@ -66,12 +81,33 @@ std::ostream& operator<<(std::ostream& os, ExchangeType xchg_type)
         return(os << "RENEW-REPLY");
     case ExchangeType::RL:
         return(os << "RELEASE-REPLY");
+    case ExchangeType::RB:
+        return(os << "REBIND-REPLY");
+    case ExchangeType::CR:
+        return(os << "CONFIRM-REPLY");
+    case ExchangeType::DR:
+        return(os << "DECLINE-REPLY");
     default:
         return(os << "Unknown exchange type");
     }
 }
 
 
+LatencySummary::LatencySummary(const double time,
+                               const ExchangeType xchg_type,
+                               const LatencyHistogram& histogram)
+    : time_(time), xchg_type_(xchg_type), count_(histogram.getCount()),
+      min_(0), p50_(0), p90_(0), p99_(0), p999_(0), max_(0) {
+    if (count_ > 0) {
+        min_ = histogram.getMin();
+        p50_ = histogram.getPercentile(50);
+        p90_ = histogram.getPercentile(90);
+        p99_ = histogram.getPercentile(99);
+        p999_ = histogram.getPercentile(99.9);
+        max_ = histogram.getMax();
+    }
+}
+
 ExchangeStats::ExchangeStats(const ExchangeType xchg_type,
                              const double drop_time,
                              const bool archive_enabled,
@@ -86,6 +122,8 @@ ExchangeStats::ExchangeStats(const ExchangeType xchg_type,
       max_delay_(0.),
       sum_delay_(0.),
       sum_delay_squared_(0.),
+      latency_(),
+      interval_latency_(),
       orphans_(0),
       collected_(0),
       unordered_lookup_size_sum_(0),
@@ -149,6 +187,13 @@ ExchangeStats::updateDelays(const PktPtr& sent_packet,
     // mean delays.
     sum_delay_ += delta;
     sum_delay_squared_ += delta * delta;
+
+    // Record the delay in microseconds in the histograms which are
+    // used to calculate the percentiles.
+    uint64_t usecs =
+        static_cast<uint64_t>(period.length().total_microseconds());
+    latency_.record(usecs);
+    interval_latency_.record(usecs);
 }
 
 PktPtr
@@ -386,11 +431,65 @@ StatsMgr::StatsMgr(CommandOptions& options) :
             addExchangeStats(ExchangeType::RL);
         }
     }
+    if (options.getScenario() == Scenario::LIFECYCLE) {
+        addLifecycleExchanges(options);
+    }
     if (options.testDiags('i')) {
         addCustomCounter("shortwait", "Short waits for packets");
     }
 }
 
+void
+StatsMgr::addLifecycleExchanges(const CommandOptions& options) {
+    // The simulated clients renew and rebind their leases. The other
+    // exchanges depend on the behavior selected by the user.
+    const double drop_time = options.getDropTime()[1];
+    if (options.getIpVersion() == 4) {
+        addExchangeStats(ExchangeType::RNA, drop_time);
+        addExchangeStats(ExchangeType::RBA, drop_time);
+        if (options.getReboot() > 0.) {
+            addExchangeStats(ExchangeType::IRA, drop_time);
+        }
+        if (options.getChurn() > 0.) {
+            addExchangeStats(ExchangeType::RLA, drop_time);
+        }
+    } else {
+        addExchangeStats(ExchangeType::RN, drop_time);
+        addExchangeStats(ExchangeType::RB, drop_time);
+        // Clients with delegated prefixes rebind when they reboot.
+        if ((options.getReboot() > 0.) &&
+            !options.getLeaseType().includes(CommandOptions::LeaseType::PREFIX)) {
+            addExchangeStats(ExchangeType::CR, drop_time);
+        }
+        if (options.getChurn() > 0.) {
+            addExchangeStats(ExchangeType::RL, drop_time);
+        }
+        if ((options.getDecline() > 0.) &&
+            options.getLeaseType().includes(CommandOptions::LeaseType::ADDRESS)) {
+            addExchangeStats(ExchangeType::DR, drop_time);
+        }
+    }
+}
+
+void
+ExchangeStats::merge(const ExchangeStats& other) {
+    min_delay_ = std::min(min_delay_, other.min_delay_);
+    max_delay_ = std::max(max_delay_, other.max_delay_);
+    sum_delay_ += other.sum_delay_;
+    sum_delay_squared_ += other.sum_delay_squared_;
+    latency_.merge(other.latency_);
+    interval_latency_.merge(other.interval_latency_);
+    orphans_ += other.orphans_;
+    collected_ += other.collected_;
+    unordered_lookup_size_sum_ += other.unordered_lookup_size_sum_;
+    unordered_lookups_ += other.unordered_lookups_;
+    ordered_lookups_ += other.ordered_lookups_;
+    sent_packets_num_ += other.sent_packets_num_;
+    rcvd_packets_num_ += other.rcvd_packets_num_;
+    non_unique_addr_num_ += other.non_unique_addr_num_;
+    rejected_leases_num_ += other.rejected_leases_num_;
+}
+
 std::string
 ExchangeStats::receivedLeases() const {
     // Get DHCP version.
@@ -467,7 +566,185 @@ void StatsMgr::printLeases() const {
     }
 }
 
-int ExchangeStats::malformed_pkts_{0};
+void
+StatsMgr::printIntermediateStats(bool clean_report, std::string clean_sep) {
+    std::ostringstream stream_sent;
+    std::ostringstream stream_rcvd;
+    std::ostringstream stream_drops;
+    std::ostringstream stream_reject;
+    std::ostringstream stream_p99;
+    std::string sep("");
+    double time =
+        getTestPeriod().length().total_microseconds() / 1e6;
+    for (ExchangesMapIterator it = exchanges_.begin();
+         it != exchanges_.end(); ++it) {
+
+        if (it != exchanges_.begin()) {
+            if (clean_report) {
+                sep = clean_sep;
+            } else {
+                sep = "/";
+            }
+        }
+        stream_sent << sep << it->second->getSentPacketsNum();
+        stream_rcvd << sep << it->second->getRcvdPacketsNum();
+        stream_drops << sep << it->second->getDroppedPacketsNum();
+        stream_reject << sep << it->second->getRejLeasesNum();
+
+        const LatencyHistogram& latency = it->second->getIntervalLatency();
+        stream_p99 << sep;
+        if (latency.getCount() > 0) {
+            stream_p99 << std::fixed << std::setprecision(3)
+                       << latency.getPercentile(99) / 1e3;
+        } else {
+            stream_p99 << "n/a";
+        }
+        latency_intervals_.push_back(LatencySummary(time, it->first,
+                                                    latency));
+        it->second->resetIntervalLatency();
+    }
+
+    if (clean_report) {
+        std::cout << stream_sent.str()
+                  << clean_sep << stream_rcvd.str()
+                  << clean_sep << stream_drops.str()
+                  << clean_sep << stream_reject.str()
+                  << std::endl;
+
+    } else {
+        std::cout << "sent: " << stream_sent.str()
+                  << "; received: " << stream_rcvd.str()
+                  << "; drops: " << stream_drops.str()
+                  << "; rejected: " << stream_reject.str()
+                  << "; p99 delay: " << stream_p99.str() << " ms"
+                  << std::endl;
+    }
+}
+
+void
+StatsMgr::merge(const StatsMgr& other) {
+    for (auto const& exchange : other.exchanges_) {
+        ExchangesMap::iterator it = exchanges_.find(exchange.first);
+        if (it != exchanges_.end()) {
+            it->second->merge(*exchange.second);
+        }
+    }
+    for (auto const& counter : other.custom_counters_) {
+        CustomCountersMapIterator it = custom_counters_.find(counter.first);
+        if (it != custom_counters_.end()) {
+            *it->second += counter.second->getValue();
+        }
+    }
+}
+
+void
+StatsMgr::resetExchanges() {
+    for (auto& exchange : exchanges_) {
+        exchange.second.reset(new ExchangeStats(exchange.first,
+                                                exchange.second->getDropTime(),
+                                                archive_enabled_,
+                                                boot_time_));
+    }
+    for (auto& counter : custom_counters_) {
+        counter.second.reset(new CustomCounter(counter.second->getName()));
+    }
+}
+
+void
+StatsMgr::resetIntervalLatency() {
+    for (auto const& exchange : exchanges_) {
+        exchange.second->resetIntervalLatency();
+    }
+}
+
+std::vector<LatencySummary>
+StatsMgr::getLatencyTotals() const {
+    double time =
+        getTestPeriod().length().total_microseconds() / 1e6;
+    std::vector<LatencySummary> totals;
+    for (auto const& exchange : exchanges_) {
+        totals.push_back(LatencySummary(time, exchange.first,
+                                        exchange.second->getLatency()));
+    }
+    return (totals);
+}
+
+namespace {
+
+/// \brief Print a latency summary as a CSV line.
+///
+/// \param os output stream.
+/// \param type "interval" or "total".
+/// \param summary latency summary.
+void
+printSummaryCsv(std::ostream& os, const std::string& type,
+                const LatencySummary& summary) {
+    os << type << ','
+       << std::fixed << std::setprecision(3) << summary.time_ << ','
+       << summary.xchg_type_ << ','
+       << summary.count_ << ','
+       << summary.min_ << ','
+       << summary.p50_ << ','
+       << summary.p90_ << ','
+       << summary.p99_ << ','
+       << summary.p999_ << ','
+       << summary.max_ << std::endl;
+}
+
+/// \brief Convert a latency summary to a JSON map.
+///
+/// \param summary latency summary.
+/// \return map holding the summary.
+ElementPtr
+summaryToElement(const LatencySummary& summary) {
+    std::ostringstream name;
+    name << summary.xchg_type_;
+    ElementPtr map = Element::createMap();
+    map->set("time", Element::create(summary.time_));
+    map->set("exchange", Element::create(name.str()));
+    map->set("count", Element::create(static_cast<long long int>(summary.count_)));
+    map->set("min", Element::create(static_cast<long long int>(summary.min_)));
+    map->set("p50", Element::create(static_cast<long long int>(summary.p50_)));
+    map->set("p90", Element::create(static_cast<long long int>(summary.p90_)));
+    map->set("p99", Element::create(static_cast<long long int>(summary.p99_)));
+    map->set("p99.9", Element::create(static_cast<long long int>(summary.p999_)));
+    map->set("max", Element::create(static_cast<long long int>(summary.max_)));
+    return (map);
+}
+
+}
+
+void
+StatsMgr::printLatencyCsv(std::ostream& os) const {
+    os << "type,time,exchange,count,min_us,p50_us,p90_us,p99_us,"
+       << "p99.9_us,max_us" << std::endl;
+    for (auto const& summary : latency_intervals_) {
+        printSummaryCsv(os, "interval", summary);
+    }
+    for (auto const& summary : getLatencyTotals()) {
+        printSummaryCsv(os, "total", summary);
+    }
+}
+
+void
+StatsMgr::printLatencyJson(std::ostream& os) const {
+    ElementPtr intervals = Element::createList();
+    for (auto const& summary : latency_intervals_) {
+        intervals->add(summaryToElement(summary));
+    }
+    ElementPtr totals = Element::createList();
+    for (auto const& summary : getLatencyTotals()) {
+        totals->add(summaryToElement(summary));
+    }
+    ElementPtr report = Element::createMap();
+    report->set("unit", Element::create("us"));
+    report->set("intervals", intervals);
+    report->set("totals", totals);
+    isc::data::prettyPrint(report, os);
+    os << std::endl;
+}
+
+std::atomic<int> ExchangeStats::malformed_pkts_{0};
 
 }  // namespace perfdhcp
 }  // namespace isc
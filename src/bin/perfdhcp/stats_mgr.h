@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,7 @@
 #include <dhcp/pkt.h>
 #include <exceptions/exceptions.h>
 #include <perfdhcp/command_options.h>
+#include <perfdhcp/latency_histogram.h>
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
@@ -20,9 +21,11 @@
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <queue>
+#include <vector>
 
 
 namespace isc {
@@ -34,10 +37,15 @@ enum class ExchangeType {
     RA,  ///< DHCPv4 REQUEST-ACK
     RNA, ///< DHCPv4 REQUEST-ACK (renewal)
     RLA, ///< DHCPv4 RELEASE
+    RBA, ///< DHCPv4 REQUEST-ACK (rebinding)
+    IRA, ///< DHCPv4 REQUEST-ACK (init-reboot)
     SA,  ///< DHCPv6 SOLICIT-ADVERTISE
     RR,  ///< DHCPv6 REQUEST-REPLY
     RN,  ///< DHCPv6 RENEW-REPLY
-    RL   ///< DHCPv6 RELEASE-REPLY
+    RL,  ///< DHCPv6 RELEASE-REPLY
+    RB,  ///< DHCPv6 REBIND-REPLY
+    CR,  ///< DHCPv6 CONFIRM-REPLY
+    DR   ///< DHCPv6 DECLINE-REPLY
 };
 
 /// \brief Get the DHCP version that fits the exchange type.
@@ -133,6 +141,33 @@ typedef typename std::map<std::string, CustomCounterPtr> CustomCountersMap;
 /// Iterator for \ref CustomCountersMap.
 typedef typename CustomCountersMap::const_iterator CustomCountersMapIterator;
 
+/// \brief Latency Summary.
+///
+/// This structure holds the percentiles of the packet delays of one
+/// exchange type over a report interval or over the whole test. The
+/// values are in microseconds. They are used to export the latency
+/// statistics in CSV or JSON format.
+struct LatencySummary {
+    /// \brief Constructor.
+    ///
+    /// \param time time since the start of the test in seconds.
+    /// \param xchg_type exchange type.
+    /// \param histogram histogram of the delays. All values are
+    /// zero when it is empty.
+    LatencySummary(const double time, const ExchangeType xchg_type,
+                   const LatencyHistogram& histogram);
+
+    double time_;             ///< Time since the start of the test.
+    ExchangeType xchg_type_;  ///< Exchange type.
+    uint64_t count_;          ///< Number of delays.
+    uint64_t min_;            ///< Minimum delay.
+    uint64_t p50_;            ///< 50th percentile of the delays.
+    uint64_t p90_;            ///< 90th percentile of the delays.
+    uint64_t p99_;            ///< 99th percentile of the delays.
+    uint64_t p999_;           ///< 99.9th percentile of the delays.
+    uint64_t max_;            ///< Maximum delay.
+};
+
 
 /// \brief Exchange Statistics.
 ///
@@ -315,7 +350,9 @@ public:
     ///  \brief Update delay counters.
     ///
     /// Method updates delay counters based on timestamps of
-    /// sent and received packets.
+    /// sent and received packets. The delay is also recorded in
+    /// the latency histograms of the whole test and of the current
+    /// report interval.
     ///
     /// \param sent_packet sent packet
     /// \param rcvd_packet received packet
@@ -389,6 +426,51 @@ public:
                     getAvgDelay() * getAvgDelay()));
     }
 
+    /// \brief Return packet delay at the given percentile.
+    ///
+    /// Method returns the packet delay below which the given
+    /// percentage of the delays fall, e.g. 99 for the p99 delay.
+    ///
+    /// \param percentile percentile between 0 and 100.
+    /// \throw isc::InvalidOperation if no packets for this exchange
+    /// have been received yet.
+    /// \return packet delay.
+    double getPercentileDelay(const double percentile) const {
+        return(static_cast<double>(latency_.getPercentile(percentile)) / 1e6);
+    }
+
+    /// \brief Return histogram of the packet delays.
+    ///
+    /// \return histogram of all the delays since the test start.
+    const LatencyHistogram& getLatency() const { return(latency_); }
+
+    /// \brief Return histogram of the packet delays of the interval.
+    ///
+    /// \return histogram of the delays since the last call to
+    /// \ref resetIntervalLatency.
+    const LatencyHistogram& getIntervalLatency() const {
+        return(interval_latency_);
+    }
+
+    /// \brief Start a new report interval.
+    ///
+    /// Method clears the histogram of the delays of the interval.
+    void resetIntervalLatency() { interval_latency_.reset(); }
+
+    /// \brief Return drop time.
+    ///
+    /// \return time in seconds after which a sent packet is dropped.
+    double getDropTime() const { return(drop_time_); }
+
+    /// \brief Add the statistics of another exchange.
+    ///
+    /// Method adds the counters, the delays and the delay histograms
+    /// of the other exchange to these ones. The lists of packets are
+    /// not merged.
+    ///
+    /// \param other statistics of the other exchange.
+    void merge(const ExchangeStats& other);
+
     /// \brief Return number of orphan packets.
     ///
     /// Method returns number of received packets that had no matching
@@ -530,8 +612,9 @@ public:
     ///
     /// Method prints round trip time packets statistics. Statistics
     /// includes minimum packet delay, maximum packet delay, average
-    /// packet delay and standard deviation of delays. Packet delay
-    /// is a duration between sending a packet to server and receiving
+    /// packet delay, standard deviation of delays and the 50th, 90th,
+    /// 99th and 99.9th percentiles of delays. Packet delay is a
+    /// duration between sending a packet to server and receiving
     /// response from server.
     void printRTTStats() const {
         using namespace std;
@@ -542,6 +625,14 @@ public:
                  << "max delay: " << getMaxDelay() * 1e3 << " ms" << endl
                  << "std deviation: " << getStdDevDelay() * 1e3 << " ms"
                  << endl
+                 << "p50 delay: " << getPercentileDelay(50) * 1e3 << " ms"
+                 << endl
+                 << "p90 delay: " << getPercentileDelay(90) * 1e3 << " ms"
+                 << endl
+                 << "p99 delay: " << getPercentileDelay(99) * 1e3 << " ms"
+                 << endl
+                 << "p99.9 delay: " << getPercentileDelay(99.9) * 1e3
+                 << " ms" << endl
                  << "collected packets: " << getCollectedNum() << endl;
         } catch (const Exception&) {
             // repeated output for easier automated parsing
@@ -549,6 +640,10 @@ public:
                  << "avg delay: n/a" << endl
                  << "max delay: n/a" << endl
                  << "std deviation: n/a" << endl
+                 << "p50 delay: n/a" << endl
+                 << "p90 delay: n/a" << endl
+                 << "p99 delay: n/a" << endl
+                 << "p99.9 delay: n/a" << endl
                  << "collected packets: 0" << endl;
         }
     }
@@ -582,7 +677,7 @@ public:
     /// \brief Print the list of received leases.
     void printLeases() const;
 
-    static int malformed_pkts_;
+    static std::atomic<int> malformed_pkts_;
 
 // Private stuff of ExchangeStats class
 private:
@@ -656,6 +751,10 @@ private:
     double sum_delay_squared_;     ///< Squared sum of delays between
                                    ///< sent and received packets.
 
+    LatencyHistogram latency_;          ///< Histogram of all delays.
+    LatencyHistogram interval_latency_; ///< Histogram of the delays of
+                                        ///< the report interval.
+
     uint64_t orphans_;   ///< Number of orphan received packets.
 
     uint64_t collected_; ///< Number of garbage collected packets.
@@ -910,6 +1009,22 @@ public:
         return(xchg_stats->getStdDevDelay());
     }
 
+    /// \brief Return packet delay at the given percentile.
+    ///
+    /// Method returns the packet delay at the given percentile
+    /// for specified exchange type.
+    ///
+    /// \param xchg_type exchange type.
+    /// \param percentile percentile between 0 and 100.
+    /// \throw isc::BadValue if invalid exchange type specified.
+    /// \throw isc::InvalidOperation if no packets have been received.
+    /// \return packet delay at the percentile.
+    double getPercentileDelay(const ExchangeType xchg_type,
+                              const double percentile) const {
+        ExchangeStatsPtr xchg_stats = getExchangeStats(xchg_type);
+        return(xchg_stats->getPercentileDelay(percentile));
+    }
+
     /// \brief Return number of orphan packets.
     ///
     /// Method returns number of orphan packets for specified
@@ -1115,49 +1230,68 @@ public:
     ///
     /// Method prints intermediate statistics for all exchanges.
     /// Statistics includes sent, received and dropped packets
-    /// counters.
+    /// counters and the 99th percentile of the packet delays of
+    /// the interval since the previous report. The latency
+    /// percentiles of the interval are kept for the export and the
+    /// next interval is started.
     ///
     /// \param clean_report value to generate easy to parse report.
     /// \param clean_sep string used as separator if clean_report enabled..
-    void
-    printIntermediateStats(bool clean_report, std::string clean_sep) const {
-        std::ostringstream stream_sent;
-        std::ostringstream stream_rcvd;
-        std::ostringstream stream_drops;
-        std::ostringstream stream_reject;
-        std::string sep("");
-        for (ExchangesMapIterator it = exchanges_.begin();
-             it != exchanges_.end(); ++it) {
-
-            if (it != exchanges_.begin()) {
-                if (clean_report) {
-                    sep = clean_sep;
-                } else {
-                    sep = "/";
-                }
-            }
-            stream_sent << sep << it->second->getSentPacketsNum();
-            stream_rcvd << sep << it->second->getRcvdPacketsNum();
-            stream_drops << sep << it->second->getDroppedPacketsNum();
-            stream_reject << sep << it->second->getRejLeasesNum();
-        }
+    void printIntermediateStats(bool clean_report, std::string clean_sep);
 
-        if (clean_report) {
-        std::cout << stream_sent.str()
-                  << clean_sep << stream_rcvd.str()
-                  << clean_sep << stream_drops.str()
-                  << clean_sep << stream_reject.str()
-                  << std::endl;
-
-        } else {
-        std::cout << "sent: " << stream_sent.str()
-                  << "; received: " << stream_rcvd.str()
-                  << "; drops: " << stream_drops.str()
-                  << "; rejected: " << stream_reject.str()
-                  << std::endl;
-        }
+    /// \brief Add the statistics of another manager.
+    ///
+    /// Method is used to aggregate the statistics collected by the
+    /// traffic threads. The statistics of the exchanges and the custom
+    /// counters of the other manager are added to the ones of this
+    /// manager, these which are not tracked here are ignored.
+    ///
+    /// \param other the other statistics manager.
+    void merge(const StatsMgr& other);
+
+    /// \brief Reset the statistics of the exchanges.
+    ///
+    /// Method clears the statistics of all exchanges and the custom
+    /// counters so the statistics of the traffic threads can be
+    /// merged again. The test start time and the latency percentiles
+    /// of the past report intervals are kept.
+    void resetExchanges();
+
+    /// \brief Start a new report interval.
+    ///
+    /// Method clears the histograms of the delays of the interval
+    /// of all exchanges.
+    void resetIntervalLatency();
+
+    /// \brief Return latency percentiles of the report intervals.
+    ///
+    /// \return latency summaries of all exchanges for each interval
+    /// reported by \ref printIntermediateStats.
+    const std::vector<LatencySummary>& getLatencyIntervals() const {
+        return(latency_intervals_);
     }
 
+    /// \brief Print latency percentiles in CSV format.
+    ///
+    /// Method prints a header line followed by one line per exchange
+    /// for each report interval and one line per exchange for the
+    /// whole test. The first column is either "interval" or "total",
+    /// the second one the time since the start of the test in
+    /// seconds. The delays are in microseconds.
+    ///
+    /// \param os output stream.
+    void printLatencyCsv(std::ostream& os) const;
+
+    /// \brief Print latency percentiles in JSON format.
+    ///
+    /// Method prints a map with an "intervals" list holding the
+    /// latency percentiles of all exchanges for each report interval
+    /// and a "totals" list holding them for the whole test. The
+    /// delays are in microseconds.
+    ///
+    /// \param os output stream.
+    void printLatencyJson(std::ostream& os) const;
+
     /// \brief Print timestamps of all packets.
     ///
     /// Method prints timestamps of all sent and received
@@ -1232,9 +1366,23 @@ private:
         return(xchg_stats);
     }
 
+    /// \brief Add the exchanges of the lifecycle scenario.
+    ///
+    /// \param options command options selecting the behavior of the
+    /// simulated clients.
+    void addLifecycleExchanges(const CommandOptions& options);
+
+    /// \brief Return latency percentiles of the whole test.
+    ///
+    /// \return latency summaries of all exchanges.
+    std::vector<LatencySummary> getLatencyTotals() const;
+
     ExchangesMap exchanges_;            ///< Map of exchange types.
     CustomCountersMap custom_counters_; ///< Map with custom counters.
 
+    /// Latency percentiles of the report intervals.
+    std::vector<LatencySummary> latency_intervals_;
+
     /// Indicates that packets from list of sent packets should be
     /// archived (moved to list of archived packets) once they are
     /// matched with received packets. This is required when it has
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -42,7 +42,7 @@ using namespace isc::asiolink;
 namespace isc {
 namespace perfdhcp {
 
-bool TestControl::interrupted_ = false;
+std::atomic<bool> TestControl::interrupted_(false);
 
 bool
 TestControl::waitToExit() {
@@ -100,11 +100,8 @@ TestControl::cleanCachedPackets() {
         return;
     }
 
-    static boost::posix_time::ptime last_clean =
-        microsec_clock::universal_time();
-
     // Check how much time has passed since last cleanup.
-    time_period time_since_clean(last_clean,
+    time_period time_since_clean(last_clean_,
                                  microsec_clock::universal_time());
     // Cleanup every 1 second.
     if (time_since_clean.length().total_seconds() >= 1) {
@@ -119,7 +116,7 @@ TestControl::cleanCachedPackets() {
         }
         // Remember when we performed a cleanup for the last time.
         // We want to do the next cleanup not earlier than in one second.
-        last_clean = microsec_clock::universal_time();
+        last_clean_ = microsec_clock::universal_time();
     }
 }
 
@@ -370,7 +367,7 @@ TestControl::generateMacAddress(uint8_t& randomized) {
     } else {
       // ... otherwise use the standard behavior
       uint32_t clients_num = options_.getClientsNum();
-      if (clients_num < 2) {
+      if ((clients_num < 2) && (options_.getClientsOffset() == 0)) {
           return (options_.getMacTemplate());
       }
       // Get the base MAC address. We are going to randomize part of it.
@@ -378,7 +375,8 @@ TestControl::generateMacAddress(uint8_t& randomized) {
       if (mac_addr.size() != HW_ETHER_LEN) {
           isc_throw(BadValue, "invalid MAC address template specified");
       }
-      uint32_t r = macaddr_gen_->generate();
+      // The traffic threads simulate distinct ranges of clients.
+      uint32_t r = macaddr_gen_->generate() + options_.getClientsOffset();
       randomized = 0;
       // Randomize MAC address octets.
       for (std::vector<uint8_t>::iterator it = mac_addr.end() - 1;
@@ -444,7 +442,8 @@ TestControl::generateDuid(uint8_t& randomized) {
       return (duid);
     } else {
       uint32_t clients_num = options_.getClientsNum();
-      if ((clients_num == 0) || (clients_num == 1)) {
+      if (((clients_num == 0) || (clients_num == 1)) &&
+          (options_.getClientsOffset() == 0)) {
           return (options_.getDuidTemplate());
       }
       // Get the base DUID. We are going to randomize part of it.
@@ -689,33 +688,39 @@ TestControl::printTemplates() const {
 
 void
 TestControl::printRate() const {
+    printRate(options_, stats_mgr_);
+}
+
+void
+TestControl::printRate(const CommandOptions& options,
+                       const StatsMgr& stats_mgr) {
     double rate = 0;
     std::string exchange_name = "4-way exchanges";
     ExchangeType xchg_type = ExchangeType::DO;
-    if (options_.getIpVersion() == 4) {
+    if (options.getIpVersion() == 4) {
         xchg_type =
-            options_.getExchangeMode() == CommandOptions::DO_SA ?
+            options.getExchangeMode() == CommandOptions::DO_SA ?
             ExchangeType::DO : ExchangeType::RA;
         if (xchg_type == ExchangeType::DO) {
             exchange_name = "DISCOVER-OFFER";
         }
-    } else if (options_.getIpVersion() == 6) {
+    } else if (options.getIpVersion() == 6) {
         xchg_type =
-            options_.getExchangeMode() == CommandOptions::DO_SA ?
+            options.getExchangeMode() == CommandOptions::DO_SA ?
             ExchangeType::SA : ExchangeType::RR;
         if (xchg_type == ExchangeType::SA) {
-            exchange_name = options_.isRapidCommit() ? "Solicit-Reply" :
+            exchange_name = options.isRapidCommit() ? "Solicit-Reply" :
                 "Solicit-Advertise";
         }
     }
     double duration =
-        stats_mgr_.getTestPeriod().length().total_nanoseconds() / 1e9;
-    rate = stats_mgr_.getRcvdPacketsNum(xchg_type) / duration;
+        stats_mgr.getTestPeriod().length().total_nanoseconds() / 1e9;
+    rate = stats_mgr.getRcvdPacketsNum(xchg_type) / duration;
     std::ostringstream s;
     s << "***Rate statistics***" << std::endl;
     s << "Rate: " << rate << " " << exchange_name << "/second";
-    if (options_.getRate() > 0) {
-        s << ", expected rate: " << options_.getRate() << std::endl;
+    if (options.getRate() > 0) {
+        s << ", expected rate: " << options.getRate() << std::endl;
     }
 
     std::cout << s.str() << std::endl;
@@ -739,10 +744,32 @@ TestControl::printIntermediateStats() {
 
 void
 TestControl::printStats() const {
-    printRate();
-    stats_mgr_.printStats();
-    if (options_.testDiags('i')) {
-        stats_mgr_.printCustomCounters();
+    printStats(options_, stats_mgr_);
+}
+
+void
+TestControl::printStats(const CommandOptions& options,
+                        const StatsMgr& stats_mgr) {
+    printRate(options, stats_mgr);
+    stats_mgr.printStats();
+    if (options.testDiags('i')) {
+        stats_mgr.printCustomCounters();
+    }
+    std::string file_name = options.getLatencyCsvFile();
+    if (!file_name.empty()) {
+        std::ofstream csv_file(file_name.c_str());
+        if (!csv_file.is_open()) {
+            isc_throw(BadValue, "unable to open latency file " << file_name);
+        }
+        stats_mgr.printLatencyCsv(csv_file);
+    }
+    file_name = options.getLatencyJsonFile();
+    if (!file_name.empty()) {
+        std::ofstream json_file(file_name.c_str());
+        if (!json_file.is_open()) {
+            isc_throw(BadValue, "unable to open latency file " << file_name);
+        }
+        stats_mgr.printLatencyJson(json_file);
     }
 }
 
@@ -1097,6 +1124,7 @@ void
 TestControl::reset() {
     transid_gen_.reset();
     last_report_ = microsec_clock::universal_time();
+    last_clean_ = last_report_;
     // Actual generators will have to be set later on because we need to
     // get command line parameters first.
     setTransidGenerator(NumberGeneratorPtr());
@@ -1137,8 +1165,11 @@ TestControl::TestControl(CommandOptions& options, BasePerfSocket &socket) :
         1 : options_.getClientsNum();
     setMacAddrGenerator(NumberGeneratorPtr(new SequentialGenerator(clients_num)));
 
-    // Diagnostics are command line options mainly.
-    printDiagnostics();
+    // Diagnostics are command line options mainly. They are printed
+    // once when the traffic is generated by several threads.
+    if (options_.getThreadIndex() == 0) {
+        printDiagnostics();
+    }
     // Option factories have to be registered.
     registerOptionFactories();
     // Initialize packet templates.
@@ -1367,6 +1398,28 @@ TestControl::sendMessageFromReply(const uint16_t msg_type) {
     return (true);
 }
 
+void
+TestControl::sendMessage(const Pkt4Ptr& pkt, const IOAddress& relay) {
+    setDefaults4(pkt);
+    if (!relay.isV4Zero()) {
+        pkt->setGiaddr(relay);
+    }
+    addExtraOpts(pkt);
+    pkt->pack();
+    socket_.send(pkt);
+}
+
+void
+TestControl::sendMessage(const Pkt6Ptr& pkt, const IOAddress& relay) {
+    setDefaults6(pkt);
+    if (!relay.isV6Zero() && !pkt->relay_info_.empty()) {
+        pkt->relay_info_[0].linkaddr_ = relay;
+    }
+    addExtraOpts(pkt);
+    pkt->pack();
+    socket_.send(pkt);
+}
+
 void
 TestControl::sendRequest4(const dhcp::Pkt4Ptr& discover_pkt4,
                           const dhcp::Pkt4Ptr& offer_pkt4) {
@@ -1842,6 +1895,14 @@ TestControl::setDefaults4(const Pkt4Ptr& pkt) {
     }
     // Pretend that we have one relay (which is us).
     pkt->setHops(1);
+    // Each traffic thread receives on its own port so the server is
+    // asked to answer to the source port of the query (RFC 8357).
+    if (options_.getThreadsNum() > 1) {
+        OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+        rai->addOption(OptionPtr(new Option(Option::V4,
+                                            RAI_OPTION_RELAY_PORT)));
+        pkt->addOption(rai);
+    }
 }
 
 void
@@ -1880,6 +1941,13 @@ TestControl::setDefaults6(const Pkt6Ptr& pkt) {
           relay_info.linkaddr_ = IOAddress(socket_.addr_);
       }
       relay_info.peeraddr_ = IOAddress(socket_.addr_);
+      // Each traffic thread receives on its own port so the server is
+      // asked to answer to the source port of the query (RFC 8357).
+      if (options_.getThreadsNum() > 1) {
+          OptionPtr port(new OptionInt<uint16_t>(Option::V6,
+                                                 D6O_RELAY_SOURCE_PORT, 0));
+          relay_info.options_.insert(make_pair(D6O_RELAY_SOURCE_PORT, port));
+      }
       pkt->addRelayInfo(relay_info);
     }
 }
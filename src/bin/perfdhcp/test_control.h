@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -224,9 +225,54 @@ public:
     /// \brief Get interrupted flag.
     bool interrupted() const { return interrupted_; }
 
+    /// \brief Stop the running tests as if the program was interrupted.
+    static void interrupt() { interrupted_ = true; }
+
     /// \brief Get stats manager.
     StatsMgr& getStatsMgr() { return stats_mgr_; };
 
+    /// \brief generate transaction id.
+    ///
+    /// Generate transaction id value (32-bit for DHCPv4,
+    /// 24-bit for DHCPv6).
+    ///
+    /// \return generated transaction id.
+    uint32_t generateTransid() {
+        return (transid_gen_->generate());
+    }
+
+    /// \brief Get next received packet.
+    ///
+    /// Used by the scenarios which process the server responses
+    /// themselves instead of \ref consumeReceivedPackets.
+    ///
+    /// \return received packet or null if there is none.
+    dhcp::PktPtr getReceivedPacket() { return (receiver_.getPkt()); }
+
+    /// \brief Send DHCPv4 message built by a scenario.
+    ///
+    /// Method sets the default ports and addresses of the message,
+    /// adds the extra options specified by the user, packs and sends it.
+    /// The message is not passed to the statistics manager.
+    ///
+    /// \param pkt the message to send.
+    /// \param relay relay address (GIADDR) or the zero address to use
+    /// the default one.
+    void sendMessage(const dhcp::Pkt4Ptr& pkt,
+                     const asiolink::IOAddress& relay);
+
+    /// \brief Send DHCPv6 message built by a scenario.
+    ///
+    /// Method sets the default ports and addresses of the message,
+    /// adds the extra options specified by the user, packs and sends it.
+    /// The message is not passed to the statistics manager.
+    ///
+    /// \param pkt the message to send.
+    /// \param relay link address of the relay or the zero address to use
+    /// the default one. It is ignored when the message is not relayed.
+    void sendMessage(const dhcp::Pkt6Ptr& pkt,
+                     const asiolink::IOAddress& relay);
+
     /// \brief Start receiver.
     void start() { receiver_.start(); }
 
@@ -300,11 +346,27 @@ public:
 
     /// \brief Print performance statistics.
     ///
-    /// Method prints performance statistics.
+    /// Method prints performance statistics and exports the latency
+    /// percentiles to the files given with --latency-csv and
+    /// --latency-json.
     /// \throws isc::InvalidOperation if Statistics Manager was
     /// not initialized.
+    /// \throws isc::BadValue if a latency file can't be opened.
     void printStats() const;
 
+    /// \brief Print performance statistics of a statistics manager.
+    ///
+    /// Method is used by \ref printStats and to print the statistics
+    /// aggregated from the traffic threads.
+    ///
+    /// \param options command line options.
+    /// \param stats_mgr statistics manager.
+    /// \throws isc::InvalidOperation if Statistics Manager was
+    /// not initialized.
+    /// \throws isc::BadValue if a latency file can't be opened.
+    static void printStats(const CommandOptions& options,
+                           const StatsMgr& stats_mgr);
+
     /// \brief Print templates information.
     ///
     /// Method prints information about data offsets
@@ -529,16 +591,6 @@ protected:
     /// \return generated MAC address.
     std::vector<uint8_t> generateMacAddress(uint8_t& randomized);
 
-    /// \brief generate transaction id.
-    ///
-    /// Generate transaction id value (32-bit for DHCPv4,
-    /// 24-bit for DHCPv6).
-    ///
-    /// \return generated transaction id.
-    uint32_t generateTransid() {
-        return (transid_gen_->generate());
-    }
-
     /// \brief Return template buffer.
     ///
     /// Method returns template buffer at specified index.
@@ -565,6 +617,13 @@ protected:
     /// Method print packet exchange rate statistics.
     void printRate() const;
 
+    /// \brief Print rate statistics of a statistics manager.
+    ///
+    /// \param options command line options.
+    /// \param stats_mgr statistics manager.
+    static void printRate(const CommandOptions& options,
+                          const StatsMgr& stats_mgr);
+
     /// \brief Process received DHCPv4 packet.
     ///
     /// Method performs processing of the received DHCPv4 packet,
@@ -1073,6 +1132,9 @@ protected:
     /// \brief Last intermediate report time.
     boost::posix_time::ptime last_report_;
 
+    /// \brief Last cleanup time of the cached Reply packets.
+    boost::posix_time::ptime last_clean_;
+
     /// \brief Statistics Manager.
     StatsMgr stats_mgr_;
 
@@ -1104,7 +1166,7 @@ protected:
     std::map<uint8_t, dhcp::Pkt6Ptr> template_packets_v6_;
 
     /// \brief Program interrupted flag.
-    static bool interrupted_;
+    static std::atomic<bool> interrupted_;
 
     /// \brief Command options.
     CommandOptions& options_;
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 
 #include "command_options_helper.h"
 #include "../basic_scen.h"
+#include "../parallel_scen.h"
 
 #include <asiolink/io_address.h>
 #include <exceptions/exceptions.h>
@@ -25,6 +26,7 @@
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <thread>
 #include <gtest/gtest.h>
 
 using namespace std;
@@ -188,6 +190,24 @@ public:
 };
 
 
+/// \brief NakedParallelScen class.
+///
+/// It exposes ParallelScen internals for UT and uses fake sockets.
+class NakedParallelScen: public ParallelScen {
+public:
+    using ParallelScen::traffic_;
+
+    NakedParallelScen(CommandOptions &opt) : ParallelScen(opt) {};
+
+protected:
+    /// \brief Give a fake socket to the traffic threads.
+    virtual std::unique_ptr<BasePerfSocket>
+    createSocket(CommandOptions& options) override {
+        return (std::unique_ptr<BasePerfSocket>(new FakeScenPerfSocket(options)));
+    }
+};
+
+
 /// \brief Test Fixture Class
 ///
 /// This test fixture class is used to perform
@@ -362,3 +382,60 @@ TEST_F(BasicScenTest, Packet6ExchangeMaxDrop3Pkt) {
     EXPECT_GE(bs.tc_.getStatsMgr().getRcvdPacketsNum(ExchangeType::RR), 1);
     EXPECT_LE(bs.tc_.getStatsMgr().getRcvdPacketsNum(ExchangeType::RR), 15);
 }
+
+TEST_F(BasicScenTest, Packet4ExchangeThreads) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -r 100 -n 10 -R 20 --threads 2"
+                   " 127.0.0.1");
+    NakedParallelScen ps(opt);
+    ps.run();
+    ASSERT_EQ(2, ps.traffic_.size());
+
+    // Each thread does its share of the 10 exchanges with its own clients.
+    // The replies to the last requests may be received after the end of
+    // the test as the threads receive packets asynchronously.
+    uint64_t sent_do = 0;
+    uint64_t rcvd_do = 0;
+    uint64_t sent_ra = 0;
+    for (auto const& traffic : ps.traffic_) {
+        StatsMgr& stats_mgr = traffic->scen_->getTestControl().getStatsMgr();
+        EXPECT_GE(stats_mgr.getSentPacketsNum(ExchangeType::DO), 5);
+        EXPECT_GE(stats_mgr.getRcvdPacketsNum(ExchangeType::DO), 1);
+        EXPECT_EQ(10, traffic->options_.getClientsNum());
+        sent_do += stats_mgr.getSentPacketsNum(ExchangeType::DO);
+        rcvd_do += stats_mgr.getRcvdPacketsNum(ExchangeType::DO);
+        sent_ra += stats_mgr.getSentPacketsNum(ExchangeType::RA);
+    }
+    EXPECT_EQ(10, ps.traffic_[1]->options_.getClientsOffset());
+
+    // The statistics of the threads are added together.
+    EXPECT_EQ(sent_do, ps.getStatsMgr().getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(rcvd_do, ps.getStatsMgr().getRcvdPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(sent_ra, ps.getStatsMgr().getSentPacketsNum(ExchangeType::RA));
+}
+
+// This test verifies that the statistics can be read while the main loop
+// is running at a rate at which it never sleeps.
+TEST_F(BasicScenTest, mergeStatsWhileRunning) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -r 100000 -p 2 127.0.0.1");
+    NakedBasicScen bs(opt);
+    std::thread thread([&bs]() { bs.runThread(); });
+
+    // Give the main loop the time to start.
+    usleep(100000);
+
+    // Each read must only wait for the end of an iteration of the
+    // main loop, not for the end of the test.
+    StatsMgr stats_mgr(opt);
+    for (int i = 0; i < 5; ++i) {
+        ptime start = microsec_clock::universal_time();
+        stats_mgr.resetExchanges();
+        bs.mergeStats(stats_mgr);
+        time_duration elapsed = microsec_clock::universal_time() - start;
+        EXPECT_LT(elapsed.total_milliseconds(), 500);
+    }
+    EXPECT_GT(stats_mgr.getSentPacketsNum(ExchangeType::DO), 0);
+
+    thread.join();
+}
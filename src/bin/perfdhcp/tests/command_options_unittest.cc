@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -285,6 +285,18 @@ TEST_F(CommandOptionsTest, UseCleanOutput) {
     EXPECT_EQ(",", opt.getCleanReportSeparator());
 }
 
+TEST_F(CommandOptionsTest, LatencyExport) {
+    CommandOptions opt;
+    EXPECT_NO_THROW(process(opt, "perfdhcp -6 -l ethx all"));
+    EXPECT_TRUE(opt.getLatencyCsvFile().empty());
+    EXPECT_TRUE(opt.getLatencyJsonFile().empty());
+
+    EXPECT_NO_THROW(process(opt, "perfdhcp -6 --latency-csv lat.csv"
+                            " --latency-json lat.json -l ethx all"));
+    EXPECT_EQ("lat.csv", opt.getLatencyCsvFile());
+    EXPECT_EQ("lat.json", opt.getLatencyJsonFile());
+}
+
 TEST_F(CommandOptionsTest, UseRelayV6) {
     CommandOptions opt;
     EXPECT_NO_THROW(process(opt, "perfdhcp -6 -A1 -l ethx all"));
@@ -898,3 +910,108 @@ TEST_F(CommandOptionsTest, ElapsedTime) {
     EXPECT_EQ(3, opt.getIncreaseElapsedTime());
     EXPECT_EQ(10, opt.getWaitForElapsedTime());
 }
+
+TEST_F(CommandOptionsTest, Threads) {
+    CommandOptions opt;
+    EXPECT_NO_THROW(process(opt, "perfdhcp -r 10 -f 3 -n 11 -D 3 -P 5"
+                            " -R 21 -L 2000 -t 2 --threads 2 192.168.0.1"));
+    EXPECT_EQ(2, opt.getThreadsNum());
+    EXPECT_EQ(0, opt.getThreadIndex());
+    EXPECT_EQ(0, opt.getClientsOffset());
+
+    // The first thread gets the remainders of the divisions.
+    CommandOptions first = opt.getThreadOptions(0);
+    EXPECT_EQ(0, first.getThreadIndex());
+    EXPECT_EQ(5, first.getRate());
+    EXPECT_EQ(2, first.getRenewRate());
+    ASSERT_EQ(1, first.getNumRequests().size());
+    EXPECT_EQ(6, first.getNumRequests()[0]);
+    ASSERT_EQ(1, first.getMaxDrop().size());
+    EXPECT_EQ(2, first.getMaxDrop()[0]);
+    EXPECT_EQ(3, first.getPreload());
+    EXPECT_EQ(11, first.getClientsNum());
+    EXPECT_EQ(0, first.getClientsOffset());
+    EXPECT_EQ(0, first.getReportDelay());
+    EXPECT_FALSE(first.isSingleThreaded());
+
+    CommandOptions second = opt.getThreadOptions(1);
+    EXPECT_EQ(1, second.getThreadIndex());
+    EXPECT_EQ(5, second.getRate());
+    EXPECT_EQ(1, second.getRenewRate());
+    ASSERT_EQ(1, second.getNumRequests().size());
+    EXPECT_EQ(5, second.getNumRequests()[0]);
+    ASSERT_EQ(1, second.getMaxDrop().size());
+    EXPECT_EQ(1, second.getMaxDrop()[0]);
+    EXPECT_EQ(2, second.getPreload());
+    EXPECT_EQ(10, second.getClientsNum());
+    EXPECT_EQ(11, second.getClientsOffset());
+
+    EXPECT_THROW(opt.getThreadOptions(2), isc::BadValue);
+
+    // Invalid number of threads.
+    EXPECT_THROW(process(opt, "perfdhcp --threads 0 all"),
+                 isc::InvalidParameter);
+    // Only the basic scenario is supported.
+    EXPECT_THROW(process(opt, "perfdhcp --threads 2 --scenario avalanche"
+                         " -R 10 all"), isc::InvalidParameter);
+    // DHCPv6 traffic must be relayed.
+    EXPECT_THROW(process(opt, "perfdhcp -6 --threads 2 all"),
+                 isc::InvalidParameter);
+    EXPECT_NO_THROW(process(opt, "perfdhcp -6 -A 1 --threads 2 all"));
+    // The rate must be shared by all threads.
+    EXPECT_THROW(process(opt, "perfdhcp -r 1 --threads 2 all"),
+                 isc::InvalidParameter);
+    // The clients must be shared by all threads.
+    EXPECT_THROW(process(opt, "perfdhcp -R 2 --threads 3 all"),
+                 isc::InvalidParameter);
+    // The ports of the threads must be valid.
+    EXPECT_THROW(process(opt, "perfdhcp -L 65535 --threads 2 all"),
+                 isc::InvalidParameter);
+}
+
+TEST_F(CommandOptionsTest, Lifecycle) {
+    CommandOptions opt;
+    EXPECT_NO_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                            " --lease-time 60-120 --churn 5 --reboot 2.5"
+                            " --decline 1 all"));
+    EXPECT_EQ(Scenario::LIFECYCLE, opt.getScenario());
+    EXPECT_EQ(60, opt.getLeaseTimeMin());
+    EXPECT_EQ(120, opt.getLeaseTimeMax());
+    EXPECT_DOUBLE_EQ(5., opt.getChurn());
+    EXPECT_DOUBLE_EQ(2.5, opt.getReboot());
+    EXPECT_DOUBLE_EQ(1., opt.getDecline());
+
+    // A single lease time.
+    EXPECT_NO_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                            " --lease-time 30 all"));
+    EXPECT_EQ(30, opt.getLeaseTimeMin());
+    EXPECT_EQ(30, opt.getLeaseTimeMax());
+    EXPECT_DOUBLE_EQ(0., opt.getChurn());
+
+    // Invalid lease times.
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                         " --lease-time 0 all"), isc::InvalidParameter);
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                         " --lease-time 20-10 all"), isc::InvalidParameter);
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                         " --lease-time ten all"), isc::InvalidParameter);
+    // Invalid percentages.
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                         " --churn 101 all"), isc::InvalidParameter);
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                         " --decline -1 all"), isc::InvalidParameter);
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100"
+                         " --churn 60 --reboot 50 all"), isc::InvalidParameter);
+    // The number of clients is required.
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle all"),
+                 isc::InvalidParameter);
+    // The clients get their leases.
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100 -i all"),
+                 isc::InvalidParameter);
+    // The renewals and releases follow the clients.
+    EXPECT_THROW(process(opt, "perfdhcp --scenario lifecycle -R 100 -r 10"
+                         " -f 5 all"), isc::InvalidParameter);
+    // The lifecycle options are not used by the other scenarios.
+    EXPECT_THROW(process(opt, "perfdhcp --churn 5 all"),
+                 isc::InvalidParameter);
+}
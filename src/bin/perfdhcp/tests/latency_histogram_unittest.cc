@@ -0,0 +1,99 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <perfdhcp/latency_histogram.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace isc;
+using namespace isc::perfdhcp;
+
+namespace {
+
+// Test that an empty histogram has no percentiles.
+TEST(LatencyHistogramTest, empty) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.getCount());
+    EXPECT_EQ(0, histogram.getMin());
+    EXPECT_EQ(0, histogram.getMax());
+    EXPECT_THROW(histogram.getPercentile(50), isc::InvalidOperation);
+
+    histogram.record(10);
+    EXPECT_THROW(histogram.getPercentile(-1), isc::BadValue);
+    EXPECT_THROW(histogram.getPercentile(100.1), isc::BadValue);
+}
+
+// Test that small values are recorded exactly.
+TEST(LatencyHistogramTest, smallValues) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(100, histogram.getCount());
+    EXPECT_EQ(1, histogram.getMin());
+    EXPECT_EQ(100, histogram.getMax());
+    EXPECT_EQ(1, histogram.getPercentile(0));
+    EXPECT_EQ(50, histogram.getPercentile(50));
+    EXPECT_EQ(90, histogram.getPercentile(90));
+    EXPECT_EQ(99, histogram.getPercentile(99));
+    EXPECT_EQ(100, histogram.getPercentile(99.9));
+    EXPECT_EQ(100, histogram.getPercentile(100));
+}
+
+// Test that the percentiles of large values are within the precision.
+TEST(LatencyHistogramTest, largeValues) {
+    LatencyHistogram histogram;
+    // Delays from 1ms to 10s.
+    for (uint64_t value = 1000; value <= 10000000; value += 1000) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(10000, histogram.getCount());
+    EXPECT_EQ(1000, histogram.getMin());
+    EXPECT_EQ(10000000, histogram.getMax());
+    const double percentiles[] = { 10, 50, 90, 99, 99.9 };
+    for (auto const percentile : percentiles) {
+        double exact = percentile * 100000;
+        double value = histogram.getPercentile(percentile);
+        EXPECT_LE(exact, value) << "percentile " << percentile;
+        EXPECT_GE(exact * 1.008, value) << "percentile " << percentile;
+    }
+
+    // A huge value does not overflow.
+    histogram.record(UINT64_MAX);
+    EXPECT_EQ(UINT64_MAX, histogram.getMax());
+    EXPECT_EQ(UINT64_MAX, histogram.getPercentile(100));
+}
+
+// Test that histograms are merged and reset.
+TEST(LatencyHistogramTest, mergeReset) {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    for (uint64_t value = 1; value <= 50; ++value) {
+        first.record(value);
+        second.record(value + 50000);
+    }
+    first.merge(second);
+    EXPECT_EQ(100, first.getCount());
+    EXPECT_EQ(1, first.getMin());
+    EXPECT_EQ(50050, first.getMax());
+    EXPECT_EQ(50, first.getPercentile(50));
+    EXPECT_LE(50001, first.getPercentile(51));
+
+    first.reset();
+    EXPECT_EQ(0, first.getCount());
+    EXPECT_EQ(0, first.getMax());
+    EXPECT_THROW(first.getPercentile(50), isc::InvalidOperation);
+    first.record(7);
+    EXPECT_EQ(7, first.getMin());
+    EXPECT_EQ(7, first.getPercentile(50));
+}
+
+}
@@ -0,0 +1,297 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include "command_options_helper.h"
+#include "../lifecycle_scen.h"
+
+#include <asiolink/io_address.h>
+#include <exceptions/exceptions.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/iface_mgr.h>
+#include <dhcp/option6_ia.h>
+#include <dhcp/option6_iaaddr.h>
+#include <dhcp/option6_iaprefix.h>
+
+#include <list>
+#include <map>
+#include <tuple>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::perfdhcp;
+
+/// \brief FakeLifecycleScenPerfSocket class that mocks PerfSocket.
+///
+/// It simulates a DHCP server answering all the messages sent by
+/// the clients of the lifecycle scenario.
+class FakeLifecycleScenPerfSocket: public BasePerfSocket {
+public:
+    /// \brief Default constructor for FakeLifecycleScenPerfSocket.
+    FakeLifecycleScenPerfSocket(CommandOptions &opt) :
+        opt_(opt),
+        iface_(boost::make_shared<Iface>("fake", 0)),
+        drop_type_(0) {};
+
+    CommandOptions &opt_;
+
+    IfacePtr iface_;  ///< Local fake interface.
+
+    /// Number of sent packets by message type.
+    std::map<uint8_t, int> sent_;
+
+    /// Type of the messages which are not answered.
+    uint8_t drop_type_;
+
+    /// List of pairs <msg_type, trans_id> containing responses
+    /// planned to send to perfdhcp.
+    std::list<std::tuple<uint8_t, uint32_t>> planned_responses_;
+
+    /// \brief Simulate receiving DHCPv4 packet.
+    virtual dhcp::Pkt4Ptr receive4(uint32_t, uint32_t) override {
+        if (planned_responses_.empty()) {
+            return (Pkt4Ptr());
+        }
+        auto msg = planned_responses_.front();
+        planned_responses_.pop_front();
+        Pkt4Ptr pkt(new Pkt4(std::get<0>(msg), std::get<1>(msg)));
+        pkt->setYiaddr(asiolink::IOAddress("192.0.2.1"));
+        pkt->addOption(Option::factory(Option::V4, DHO_DHCP_SERVER_IDENTIFIER,
+                                       OptionBuffer(4, 1)));
+        // One hour lease.
+        pkt->addOption(OptionPtr(new Option(Option::V4, DHO_DHCP_LEASE_TIME,
+                                            OptionBuffer({ 0, 0, 0x0e, 0x10 }))));
+        pkt->updateTimestamp();
+        return (pkt);
+    };
+
+    /// \brief Simulate receiving DHCPv6 packet.
+    virtual dhcp::Pkt6Ptr receive6(uint32_t, uint32_t) override {
+        if (planned_responses_.empty()) {
+            return (Pkt6Ptr());
+        }
+        auto msg = planned_responses_.front();
+        planned_responses_.pop_front();
+        Pkt6Ptr pkt(new Pkt6(std::get<0>(msg), std::get<1>(msg)));
+        if (opt_.getLeaseType().includes(CommandOptions::LeaseType::ADDRESS)) {
+            Option6IAPtr ia_na(new Option6IA(D6O_IA_NA, 1));
+            ia_na->addOption(OptionPtr(new Option6IAAddr(D6O_IAADDR,
+                asiolink::IOAddress("2001:db8::1"), 300, 500)));
+            pkt->addOption(ia_na);
+        }
+        if (opt_.getLeaseType().includes(CommandOptions::LeaseType::PREFIX)) {
+            Option6IAPtr ia_pd(new Option6IA(D6O_IA_PD, 1));
+            ia_pd->addOption(OptionPtr(new Option6IAPrefix(D6O_IAPREFIX,
+                asiolink::IOAddress("2001:db8:1::"), 64, 300, 500)));
+            pkt->addOption(ia_pd);
+        }
+        pkt->addOption(OptionPtr(new Option(Option::V6, D6O_SERVERID,
+                                            OptionBuffer(8, 1))));
+        pkt->updateTimestamp();
+        return (pkt);
+    };
+
+    /// \brief Simulate sending DHCPv4 packet.
+    virtual bool send(const dhcp::Pkt4Ptr& pkt) override {
+        ++sent_[pkt->getType()];
+        pkt->updateTimestamp();
+        if (pkt->getType() == drop_type_) {
+            return (true);
+        }
+        if (pkt->getType() == DHCPDISCOVER) {
+            planned_responses_.push_back(std::make_tuple(DHCPOFFER, pkt->getTransid()));
+        } else if (pkt->getType() == DHCPREQUEST) {
+            planned_responses_.push_back(std::make_tuple(DHCPACK, pkt->getTransid()));
+        }
+        return (true);
+    };
+
+    /// \brief Simulate sending DHCPv6 packet.
+    virtual bool send(const dhcp::Pkt6Ptr& pkt) override {
+        ++sent_[pkt->getType()];
+        pkt->updateTimestamp();
+        if (pkt->getType() == drop_type_) {
+            return (true);
+        }
+        if (pkt->getType() == DHCPV6_SOLICIT) {
+            planned_responses_.push_back(std::make_tuple(DHCPV6_ADVERTISE, pkt->getTransid()));
+        } else {
+            planned_responses_.push_back(std::make_tuple(DHCPV6_REPLY, pkt->getTransid()));
+        }
+        return (true);
+    };
+
+    /// \brief Override getting interface.
+    virtual IfacePtr getIface() override { return iface_; }
+};
+
+
+/// \brief NakedLifecycleScen class.
+///
+/// It exposes LifecycleScen internals for UT.
+class NakedLifecycleScen: public LifecycleScen {
+public:
+    using LifecycleScen::tc_;
+    using LifecycleScen::getMacAddress;
+
+    FakeLifecycleScenPerfSocket fake_sock_;
+
+    NakedLifecycleScen(CommandOptions &opt) : LifecycleScen(opt, fake_sock_), fake_sock_(opt) {};
+
+    /// \brief Return the value of a client event counter.
+    ///
+    /// \param name counter name.
+    /// \return counter value.
+    uint64_t getCounter(const std::string& name) {
+        return (tc_.getStatsMgr().getCounter(name)->getValue());
+    }
+};
+
+
+/// \brief Test Fixture Class
+///
+/// This test fixture class is used to perform
+/// unit tests on perfdhcp LifecycleScen class.
+class LifecycleScenTest : public virtual ::testing::Test
+{
+public:
+    LifecycleScenTest() { }
+
+    /// \brief Parse command line string with CommandOptions.
+    ///
+    /// \param cmdline command line string to be parsed.
+    /// \throw isc::Unexpected if unexpected error occurred.
+    /// \throw isc::InvalidParameter if command line is invalid.
+    void processCmdLine(CommandOptions &opt, const std::string& cmdline) const {
+        CommandOptionsHelper::process(opt, cmdline);
+    }
+};
+
+
+// Check that the clients get their leases and renew them.
+TEST_F(LifecycleScenTest, Packet4Renewals) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -4 -R 10 --scenario lifecycle"
+                   " --lease-time 1 -p 1 -g single 127.0.0.1");
+    NakedLifecycleScen ls(opt);
+
+    EXPECT_EQ(0, ls.run());
+
+    StatsMgr& stats_mgr = ls.tc_.getStatsMgr();
+    EXPECT_EQ(10, stats_mgr.getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RA));
+    EXPECT_EQ(10, ls.getCounter("joined"));
+    // Each client renews at half of the lease time.
+    EXPECT_LE(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RNA));
+    EXPECT_EQ(stats_mgr.getRcvdPacketsNum(ExchangeType::RNA),
+              ls.getCounter("renewed"));
+    EXPECT_EQ(0, ls.getCounter("rebinding"));
+    EXPECT_EQ(0, ls.getCounter("expired"));
+}
+
+// Check that the leaving clients release their leases and are replaced.
+TEST_F(LifecycleScenTest, Packet4Churn) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -4 -R 10 --scenario lifecycle"
+                   " --lease-time 1 --churn 100 -p 1 -g single 127.0.0.1");
+    NakedLifecycleScen ls(opt);
+
+    ls.run();
+
+    StatsMgr& stats_mgr = ls.tc_.getStatsMgr();
+    EXPECT_LE(10, ls.getCounter("churned"));
+    EXPECT_EQ(ls.getCounter("churned"),
+              stats_mgr.getSentPacketsNum(ExchangeType::RLA));
+    EXPECT_EQ(0, ls.getCounter("renewed"));
+    // The new clients join at once.
+    EXPECT_EQ(10 + ls.getCounter("churned"),
+              stats_mgr.getSentPacketsNum(ExchangeType::DO));
+
+    // The replaced clients use other MAC addresses.
+    EXPECT_NE(ls.getMacAddress(0), ls.getMacAddress(10));
+}
+
+// Check the INIT-REBOOT of the DHCPv4 clients.
+TEST_F(LifecycleScenTest, Packet4Reboot) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -4 -R 10 --scenario lifecycle"
+                   " --lease-time 1 --reboot 100 -p 1 -g single 127.0.0.1");
+    NakedLifecycleScen ls(opt);
+
+    ls.run();
+
+    StatsMgr& stats_mgr = ls.tc_.getStatsMgr();
+    EXPECT_LE(10, ls.getCounter("rebooted"));
+    EXPECT_EQ(ls.getCounter("rebooted"),
+              stats_mgr.getSentPacketsNum(ExchangeType::IRA));
+    EXPECT_EQ(0, stats_mgr.getSentPacketsNum(ExchangeType::RNA));
+}
+
+// Check that unanswered renewals are followed by rebinding.
+TEST_F(LifecycleScenTest, Packet6Rebinding) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -6 -R 10 --scenario lifecycle"
+                   " --lease-time 1 -p 1 -g single ::1");
+    NakedLifecycleScen ls(opt);
+    ls.fake_sock_.drop_type_ = DHCPV6_RENEW;
+
+    ls.run();
+
+    StatsMgr& stats_mgr = ls.tc_.getStatsMgr();
+    EXPECT_EQ(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RR));
+    EXPECT_LE(10, stats_mgr.getSentPacketsNum(ExchangeType::RN));
+    EXPECT_EQ(0, stats_mgr.getRcvdPacketsNum(ExchangeType::RN));
+    EXPECT_LE(10, ls.getCounter("rebinding"));
+    EXPECT_LE(10, stats_mgr.getRcvdPacketsNum(ExchangeType::RB));
+    EXPECT_EQ(stats_mgr.getRcvdPacketsNum(ExchangeType::RB),
+              ls.getCounter("rebound"));
+}
+
+// Check the DHCPv6 reboots and declines.
+TEST_F(LifecycleScenTest, Packet6RebootDecline) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -6 -R 10 --scenario lifecycle"
+                   " --lease-time 1 --reboot 100 --decline 50 -p 1"
+                   " -g single ::1");
+    NakedLifecycleScen ls(opt);
+
+    ls.run();
+
+    StatsMgr& stats_mgr = ls.tc_.getStatsMgr();
+    // The declined leases are requested again.
+    EXPECT_EQ(stats_mgr.getSentPacketsNum(ExchangeType::DR),
+              ls.getCounter("declined"));
+    EXPECT_EQ(10 + ls.getCounter("declined"),
+              stats_mgr.getSentPacketsNum(ExchangeType::SA));
+    // The confirmed leases are renewed.
+    EXPECT_LE(1, ls.getCounter("rebooted"));
+    EXPECT_EQ(ls.getCounter("rebooted"),
+              stats_mgr.getRcvdPacketsNum(ExchangeType::CR));
+    EXPECT_EQ(ls.getCounter("rebooted"),
+              stats_mgr.getSentPacketsNum(ExchangeType::RN));
+}
+
+// Check the DHCPv6 clients with delegated prefixes rebind when they reboot.
+TEST_F(LifecycleScenTest, Packet6PrefixReboot) {
+    CommandOptions opt;
+    processCmdLine(opt, "perfdhcp -l fake -6 -R 10 --scenario lifecycle"
+                   " -e prefix-only --lease-time 1 --reboot 100 -p 1"
+                   " -g single ::1");
+    NakedLifecycleScen ls(opt);
+
+    ls.run();
+
+    StatsMgr& stats_mgr = ls.tc_.getStatsMgr();
+    EXPECT_FALSE(stats_mgr.hasExchangeStats(ExchangeType::CR));
+    EXPECT_LE(10, ls.getCounter("rebooted"));
+    EXPECT_EQ(ls.getCounter("rebooted"),
+              stats_mgr.getSentPacketsNum(ExchangeType::RB));
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,7 @@
 
 #include <perfdhcp/stats_mgr.h>
 
+#include <cc/data.h>
 #include <exceptions/exceptions.h>
 #include <dhcp/dhcp4.h>
 #include <dhcp/dhcp6.h>
@@ -22,8 +23,12 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <iostream>
+#include <sstream>
+
 using namespace std;
 using namespace isc;
+using namespace isc::data;
 using namespace isc::dhcp;
 using namespace isc::perfdhcp;
 
@@ -491,6 +496,137 @@ TEST_F(StatsMgrTest, Delays) {
     EXPECT_GT(stats_mgr->getStdDevDelay(ExchangeType::DO), 0);
 }
 
+TEST_F(StatsMgrTest, PercentileDelays) {
+    CommandOptions opt;
+    boost::shared_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
+    stats_mgr->addExchangeStats(ExchangeType::DO, 5);
+
+    // There are no percentiles until a packet is received.
+    EXPECT_THROW(stats_mgr->getPercentileDelay(ExchangeType::DO, 50),
+                 isc::InvalidOperation);
+
+    // Simulate 98 exchanges with a delay of 1s and 2 with a delay of 3s.
+    for (uint32_t i = 0; i < 100; ++i) {
+        passDOPacketsWithDelay(stats_mgr, (i < 98 ? 1 : 3),
+                               common_transid + i);
+    }
+
+    // The median is the short delay and the 99th percentile the long one.
+    // The histogram precision is better than 1%.
+    EXPECT_GE(stats_mgr->getPercentileDelay(ExchangeType::DO, 50), 1);
+    EXPECT_LT(stats_mgr->getPercentileDelay(ExchangeType::DO, 50), 1.1);
+    EXPECT_GE(stats_mgr->getPercentileDelay(ExchangeType::DO, 99), 3);
+    EXPECT_LT(stats_mgr->getPercentileDelay(ExchangeType::DO, 99), 3.1);
+    EXPECT_DOUBLE_EQ(stats_mgr->getMaxDelay(ExchangeType::DO),
+                     stats_mgr->getPercentileDelay(ExchangeType::DO, 100));
+}
+
+TEST_F(StatsMgrTest, LatencyIntervals) {
+    CommandOptions opt;
+    boost::shared_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
+    stats_mgr->addExchangeStats(ExchangeType::DO, 5);
+    stats_mgr->addExchangeStats(ExchangeType::RA, 5);
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        passDOPacketsWithDelay(stats_mgr, 1, common_transid + i);
+    }
+
+    // The first report covers the 10 exchanges.
+    stats_mgr->printIntermediateStats(false, "");
+    ASSERT_EQ(2, stats_mgr->getLatencyIntervals().size());
+    const LatencySummary first = stats_mgr->getLatencyIntervals()[0];
+    EXPECT_EQ(ExchangeType::DO, first.xchg_type_);
+    EXPECT_EQ(10, first.count_);
+    EXPECT_LE(1000000, first.min_);
+    EXPECT_LE(first.min_, first.p50_);
+    EXPECT_LE(first.p50_, first.p99_);
+    EXPECT_LE(first.p99_, first.max_);
+    EXPECT_EQ(0, stats_mgr->getLatencyIntervals()[1].count_);
+
+    // The second report has no exchange. The easy parsable report keeps
+    // its format: the percentiles are only printed in the other one.
+    std::ostringstream clean_report;
+    std::streambuf* cout_buf = std::cout.rdbuf(clean_report.rdbuf());
+    stats_mgr->printIntermediateStats(true, ",");
+    std::cout.rdbuf(cout_buf);
+    EXPECT_EQ("10,0,10,0,0,0,0,0\n", clean_report.str());
+    ASSERT_EQ(4, stats_mgr->getLatencyIntervals().size());
+    EXPECT_EQ(0, stats_mgr->getLatencyIntervals()[2].count_);
+
+    // The CSV export has a header, the 4 interval lines and the 2 totals.
+    std::ostringstream csv;
+    stats_mgr->printLatencyCsv(csv);
+    std::istringstream lines(csv.str());
+    std::string line;
+    std::vector<std::string> csv_lines;
+    while (std::getline(lines, line)) {
+        csv_lines.push_back(line);
+    }
+    ASSERT_EQ(7, csv_lines.size());
+    EXPECT_EQ(0, csv_lines[0].find("type,time,exchange,count,"));
+    EXPECT_EQ(0, csv_lines[1].find("interval,"));
+    EXPECT_NE(std::string::npos,
+              csv_lines[1].find(",DISCOVER-OFFER,10,"));
+    EXPECT_EQ(0, csv_lines[5].find("total,"));
+    EXPECT_NE(std::string::npos,
+              csv_lines[5].find(",DISCOVER-OFFER,10,"));
+
+    // The JSON export holds the same data.
+    std::ostringstream json;
+    stats_mgr->printLatencyJson(json);
+    ConstElementPtr report;
+    ASSERT_NO_THROW(report = Element::fromJSON(json.str()));
+    ASSERT_TRUE(report);
+    ASSERT_TRUE(report->get("intervals"));
+    EXPECT_EQ(4, report->get("intervals")->size());
+    ConstElementPtr totals = report->get("totals");
+    ASSERT_TRUE(totals);
+    ASSERT_EQ(2, totals->size());
+    EXPECT_EQ("DISCOVER-OFFER", totals->get(0)->get("exchange")->stringValue());
+    EXPECT_EQ(10, totals->get(0)->get("count")->intValue());
+    EXPECT_EQ(first.p99_,
+              totals->get(0)->get("p99")->intValue());
+    EXPECT_EQ(0, totals->get(1)->get("count")->intValue());
+}
+
+TEST_F(StatsMgrTest, Merge) {
+    CommandOptions opt;
+    boost::shared_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
+    stats_mgr->addExchangeStats(ExchangeType::DO, 5);
+    boost::shared_ptr<StatsMgr> first(new StatsMgr(opt));
+    first->addExchangeStats(ExchangeType::DO, 5);
+    boost::shared_ptr<StatsMgr> second(new StatsMgr(opt));
+    second->addExchangeStats(ExchangeType::DO, 5);
+    second->addExchangeStats(ExchangeType::RA, 5);
+
+    passDOPacketsWithDelay(first, 1, common_transid);
+    passDOPacketsWithDelay(second, 3, common_transid);
+    passDOPacketsWithDelay(second, 2, common_transid + 1);
+    // A DISCOVER which is not answered.
+    boost::shared_ptr<Pkt4> discover(createPacket4(DHCPDISCOVER, common_transid + 2));
+    ASSERT_NO_THROW(second->passSentPacket(ExchangeType::DO, discover));
+
+    // The statistics of both managers are added together, the exchange
+    // which is not tracked by this manager is ignored.
+    stats_mgr->merge(*first);
+    stats_mgr->merge(*second);
+    EXPECT_EQ(4, stats_mgr->getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(3, stats_mgr->getRcvdPacketsNum(ExchangeType::DO));
+    EXPECT_NEAR(1., stats_mgr->getMinDelay(ExchangeType::DO), 0.1);
+    EXPECT_NEAR(3., stats_mgr->getMaxDelay(ExchangeType::DO), 0.1);
+    EXPECT_NEAR(2., stats_mgr->getAvgDelay(ExchangeType::DO), 0.1);
+    EXPECT_NEAR(3., stats_mgr->getPercentileDelay(ExchangeType::DO, 100.), 0.1);
+    EXPECT_THROW(stats_mgr->getSentPacketsNum(ExchangeType::RA), BadValue);
+
+    // The statistics can be merged again after a reset.
+    stats_mgr->resetExchanges();
+    EXPECT_EQ(0, stats_mgr->getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(0, stats_mgr->getRcvdPacketsNum(ExchangeType::DO));
+    stats_mgr->merge(*first);
+    EXPECT_EQ(1, stats_mgr->getSentPacketsNum(ExchangeType::DO));
+    EXPECT_EQ(1, stats_mgr->getRcvdPacketsNum(ExchangeType::DO));
+}
+
 TEST_F(StatsMgrTest, CustomCounters) {
     CommandOptions opt;
     boost::scoped_ptr<StatsMgr> stats_mgr(new StatsMgr(opt));
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,12 +11,17 @@
 #include <util/strutil.h>
 #include <cc/simple_parser.h>
 #include <dhcp/dhcp4.h>
+#include <dhcp/dhcp6.h>
 #include <dhcp/libdhcp++.h>
 #include <dhcp/option_definition.h>
 #include <dhcp/option_space.h>
 #include <dhcp/option_vendor.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/pkt6.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <eval/eval_context.h>
+#include <eval/token.h>
+#include <set>
 
 using namespace isc;
 using namespace isc::data;
@@ -29,6 +34,90 @@ using namespace std;
 
 namespace {
 
+/// @brief Check if an expression does not depend on the packet.
+///
+/// Only the tokens known to not depend on the packet are accepted.
+///
+/// @param expr The expression.
+/// @return true if the expression evaluates to the same value for all
+/// packets.
+bool
+isConstantExpression(const Expression& expr) {
+    for (auto const& token : expr) {
+        const Token* tok = token.get();
+        if (!dynamic_cast<const TokenString*>(tok) &&
+            !dynamic_cast<const TokenHexString*>(tok) &&
+            !dynamic_cast<const TokenIpAddress*>(tok) &&
+            !dynamic_cast<const TokenIpAddressToText*>(tok) &&
+            !dynamic_cast<const TokenInt8ToText*>(tok) &&
+            !dynamic_cast<const TokenInt16ToText*>(tok) &&
+            !dynamic_cast<const TokenInt32ToText*>(tok) &&
+            !dynamic_cast<const TokenUInt8ToText*>(tok) &&
+            !dynamic_cast<const TokenUInt16ToText*>(tok) &&
+            !dynamic_cast<const TokenUInt32ToText*>(tok) &&
+            !dynamic_cast<const TokenEqual*>(tok) &&
+            !dynamic_cast<const TokenSubstring*>(tok) &&
+            !dynamic_cast<const TokenSplit*>(tok) &&
+            !dynamic_cast<const TokenConcat*>(tok) &&
+            !dynamic_cast<const TokenIfElse*>(tok) &&
+            !dynamic_cast<const TokenToHexString*>(tok) &&
+            !dynamic_cast<const TokenNot*>(tok) &&
+            !dynamic_cast<const TokenAnd*>(tok) &&
+            !dynamic_cast<const TokenOr*>(tok)) {
+            return (false);
+        }
+    }
+    return (true);
+}
+
+/// @brief Precompute the value of a constant expression.
+///
+/// When the expression does not depend on the packet, it is evaluated once
+/// and for add and supersede actions the option is built once too.
+///
+/// @param opt_cfg The option configuration.
+/// @param universe The universe.
+void
+precompute(FlexOptionImpl::OptionConfigPtr opt_cfg, Option::Universe universe) {
+    if (!isConstantExpression(*opt_cfg->getExpr())) {
+        return;
+    }
+    PktPtr pkt;
+    if (universe == Option::V4) {
+        pkt.reset(new Pkt4(DHCPDISCOVER, 0));
+    } else {
+        pkt.reset(new Pkt6(DHCPV6_SOLICIT, 0));
+    }
+    string value;
+    try {
+        if (opt_cfg->getAction() == FlexOptionImpl::REMOVE) {
+            value = evaluateBool(*opt_cfg->getExpr(), *pkt) ? "true" : "";
+        } else {
+            value = evaluateString(*opt_cfg->getExpr(), *pkt);
+        }
+    } catch (const std::exception&) {
+        // Keep the evaluation at runtime to get the same behavior.
+        return;
+    }
+    OptionPtr opt;
+    if (!value.empty() && (opt_cfg->getAction() != FlexOptionImpl::REMOVE)) {
+        try {
+            OptionDefinitionPtr def = opt_cfg->getOptionDef();
+            if (def) {
+                vector<string> split_vec = str::tokens(value, ",", true);
+                opt = def->optionFactory(universe, opt_cfg->getCode(), split_vec);
+            } else {
+                OptionBuffer buffer(value.begin(), value.end());
+                opt.reset(new Option(universe, opt_cfg->getCode(), buffer));
+            }
+        } catch (const std::exception&) {
+            // Keep building the option at runtime to get the same behavior.
+            return;
+        }
+    }
+    opt_cfg->setConstant(value, opt);
+}
+
 /// @brief Parse an action.
 ///
 /// @note Shared code for option and sub-option.
@@ -66,6 +155,7 @@ parseAction(ConstElementPtr option,
             isc_throw(BadValue, "can't parse " << name << " expression ["
                       << expr_text << "] error: " << ex.what());
         }
+        precompute(opt_cfg, universe);
     }
 }
 
@@ -103,7 +193,8 @@ const SimpleKeywords FlexOptionImpl::SUB_OPTION_PARAMETERS = {
 
 FlexOptionImpl::OptionConfig::OptionConfig(uint16_t code,
                                            OptionDefinitionPtr def)
-    : code_(code), def_(def), action_(NONE), class_("") {
+    : code_(code), def_(def), action_(NONE), class_(""), constant_(false),
+      value_(), option_(), shared_(false) {
 }
 
 FlexOptionImpl::OptionConfig::~OptionConfig() {
@@ -144,6 +235,36 @@ FlexOptionImpl::configure(ConstElementPtr options) {
     for (auto option : options->listValue()) {
         parseOptionConfig(option);
     }
+    markSharedExpressions();
+}
+
+void
+FlexOptionImpl::markSharedExpressions() {
+    // Collect the configurations evaluating an expression at runtime
+    // indexed by expression kind and text.
+    map<pair<bool, string>, vector<OptionConfigPtr> > uses;
+    auto collect = [&uses](const OptionConfigPtr& cfg) {
+        if ((cfg->getAction() != NONE) && !cfg->isConstant()) {
+            uses[make_pair(cfg->getAction() == REMOVE, cfg->getText())].push_back(cfg);
+        }
+    };
+    for (auto const& pair : option_config_map_) {
+        for (auto const& opt_cfg : pair.second) {
+            collect(opt_cfg);
+        }
+    }
+    for (auto const& pair : sub_option_config_map_) {
+        for (auto const& sub_pair : pair.second) {
+            collect(sub_pair.second);
+        }
+    }
+    for (auto const& use : uses) {
+        if (use.second.size() > 1) {
+            for (auto const& cfg : use.second) {
+                cfg->setShared(true);
+            }
+        }
+    }
 }
 
 void
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -134,6 +134,54 @@ public:
             return (class_);
         }
 
+        /// @brief Set the precomputed value of a constant expression.
+        ///
+        /// @param value the value ("true" or "" for remove).
+        /// @param option the option built from the value or null.
+        void setConstant(const std::string& value,
+                         const isc::dhcp::OptionPtr& option) {
+            constant_ = true;
+            value_ = value;
+            option_ = option;
+        }
+
+        /// @brief Check if the expression is constant.
+        ///
+        /// @return true if the expression does not depend on the packet.
+        bool isConstant() const {
+            return (constant_);
+        }
+
+        /// @brief Get the precomputed value of a constant expression.
+        ///
+        /// @return the value.
+        const std::string& getConstantValue() const {
+            return (value_);
+        }
+
+        /// @brief Get the option precomputed from a constant expression.
+        ///
+        /// @return the option to be cloned or null.
+        const isc::dhcp::OptionPtr& getConstantOption() const {
+            return (option_);
+        }
+
+        /// @brief Set the shared flag.
+        ///
+        /// @param shared true if another configuration uses the same
+        /// expression.
+        void setShared(bool shared) {
+            shared_ = shared;
+        }
+
+        /// @brief Get the shared flag.
+        ///
+        /// @return true if the result of the expression is cached during
+        /// the processing of a packet.
+        bool isShared() const {
+            return (shared_);
+        }
+
     private:
         /// @brief The code.
         uint16_t code_;
@@ -153,6 +201,18 @@ public:
 
         /// @brief The client class aka guard name.
         isc::dhcp::ClientClass class_;
+
+        /// @brief The constant flag.
+        bool constant_;
+
+        /// @brief The precomputed value of the constant expression.
+        std::string value_;
+
+        /// @brief The precomputed option of the constant expression.
+        isc::dhcp::OptionPtr option_;
+
+        /// @brief The shared expression flag.
+        bool shared_;
     };
 
     /// @brief The type of shared pointers to option config.
@@ -277,8 +337,76 @@ public:
     /// @throw BadValue and similar exceptions on error.
     void configure(isc::data::ConstElementPtr options);
 
+    /// @brief Results of the shared expressions for a query.
+    ///
+    /// The expressions used by more than one configuration are evaluated
+    /// once per query. The string and boolean results are indexed by the
+    /// textual expression.
+    struct EvalCache {
+        /// @brief Results of the string expressions.
+        std::map<std::string, std::string> strings_;
+
+        /// @brief Results of the boolean expressions.
+        std::map<std::string, bool> bools_;
+    };
+
+    /// @brief Evaluate a string expression.
+    ///
+    /// @tparam PktType The type of pointers to packets: Pkt4Ptr or Pkt6Ptr.
+    /// @param cfg The option configuration.
+    /// @param query The query packet.
+    /// @param cache The results of the shared expressions for the query.
+    /// @return The value of the expression.
+    template <typename PktType>
+    static std::string evaluateString(const OptionConfigPtr& cfg,
+                                      PktType query, EvalCache& cache) {
+        if (cfg->isConstant()) {
+            return (cfg->getConstantValue());
+        }
+        if (!cfg->isShared()) {
+            return (isc::dhcp::evaluateString(*cfg->getExpr(), *query));
+        }
+        auto it = cache.strings_.find(cfg->getText());
+        if (it != cache.strings_.end()) {
+            return (it->second);
+        }
+        std::string value = isc::dhcp::evaluateString(*cfg->getExpr(), *query);
+        cache.strings_[cfg->getText()] = value;
+        return (value);
+    }
+
+    /// @brief Evaluate a boolean expression.
+    ///
+    /// @tparam PktType The type of pointers to packets: Pkt4Ptr or Pkt6Ptr.
+    /// @param cfg The option configuration.
+    /// @param query The query packet.
+    /// @param cache The results of the shared expressions for the query.
+    /// @return The value of the expression.
+    template <typename PktType>
+    static bool evaluateBool(const OptionConfigPtr& cfg,
+                             PktType query, EvalCache& cache) {
+        if (cfg->isConstant()) {
+            return (!cfg->getConstantValue().empty());
+        }
+        if (!cfg->isShared()) {
+            return (isc::dhcp::evaluateBool(*cfg->getExpr(), *query));
+        }
+        auto it = cache.bools_.find(cfg->getText());
+        if (it != cache.bools_.end()) {
+            return (it->second);
+        }
+        bool value = isc::dhcp::evaluateBool(*cfg->getExpr(), *query);
+        cache.bools_[cfg->getText()] = value;
+        return (value);
+    }
+
     /// @brief Process a query / response pair.
     ///
+    /// The constant expressions are not evaluated and their options are
+    /// cloned from the options built at configuration time. The results
+    /// of the expressions used by several configurations are cached
+    /// during the call.
+    ///
     /// @tparam PktType The type of pointers to packets: Pkt4Ptr or Pkt6Ptr.
     /// @param universe The option universe: Option::V4 or Option::V6.
     /// @param query The query packet.
@@ -286,6 +414,7 @@ public:
     template <typename PktType>
     void process(isc::dhcp::Option::Universe universe,
                  PktType query, PktType response) {
+        EvalCache cache;
         for (auto pair : getOptionConfigMap()) {
             for (const OptionConfigPtr& opt_cfg : pair.second) {
                 const isc::dhcp::ClientClass& client_class =
@@ -310,13 +439,14 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*opt_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(opt_cfg, query, cache);
                     if (value.empty()) {
                         break;
                     }
                     // Set the value.
-                    if (def) {
+                    if (opt_cfg->getConstantOption()) {
+                        opt = opt_cfg->getConstantOption()->clone();
+                    } else if (def) {
                         std::vector<std::string> split_vec =
                             isc::util::str::tokens(value, ",", true);
                         opt = def->optionFactory(universe, code, split_vec);
@@ -331,13 +461,14 @@ public:
                     break;
                 case SUPERSEDE:
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*opt_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(opt_cfg, query, cache);
                     if (value.empty()) {
                         break;
                     }
                     // Set the value.
-                    if (def) {
+                    if (opt_cfg->getConstantOption()) {
+                        opt = opt_cfg->getConstantOption()->clone();
+                    } else if (def) {
                         std::vector<std::string> split_vec =
                             isc::util::str::tokens(value, ",", true);
                         opt = def->optionFactory(universe, code,
@@ -362,7 +493,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to false.
-                    if (!isc::dhcp::evaluateBool(*opt_cfg->getExpr(), *query)) {
+                    if (!evaluateBool(opt_cfg, query, cache)) {
                         break;
                     }
                     // Remove the option.
@@ -410,8 +541,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*sub_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(sub_cfg, query, cache);
                     if (value.empty()) {
                         break;
                     }
@@ -424,7 +554,9 @@ public:
                         break;
                     }
                     // Set the value.
-                    if (def) {
+                    if (sub_cfg->getConstantOption()) {
+                        sub = sub_cfg->getConstantOption()->clone();
+                    } else if (def) {
                         std::vector<std::string> split_vec =
                             isc::util::str::tokens(value, ",", true);
                         sub = def->optionFactory(universe, sub_code,
@@ -460,8 +592,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to empty.
-                    value = isc::dhcp::evaluateString(*sub_cfg->getExpr(),
-                                                      *query);
+                    value = evaluateString(sub_cfg, query, cache);
                     if (value.empty()) {
                         break;
                     }
@@ -470,7 +601,9 @@ public:
                         break;
                     }
                     // Set the value.
-                    if (def) {
+                    if (sub_cfg->getConstantOption()) {
+                        sub = sub_cfg->getConstantOption()->clone();
+                    } else if (def) {
                         std::vector<std::string> split_vec =
                             isc::util::str::tokens(value, ",", true);
                         sub = def->optionFactory(universe, sub_code,
@@ -517,7 +650,7 @@ public:
                         break;
                     }
                     // Do nothing is the expression evaluates to false.
-                    if (!isc::dhcp::evaluateBool(*sub_cfg->getExpr(), *query)) {
+                    if (!evaluateBool(sub_cfg, query, cache)) {
                         break;
                     }
                     // Check vendor id mismatch.
@@ -616,6 +749,12 @@ private:
     /// @brief The sub-option config map of maps.
     SubOptionConfigMapMap sub_option_config_map_;
 
+    /// @brief Mark the configurations using the same expression.
+    ///
+    /// The results of these expressions are cached during the processing
+    /// of a query.
+    void markSharedExpressions();
+
     /// @brief Parse an option config.
     ///
     /// @param option The element with option config.
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2019-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1583,4 +1583,111 @@ TEST_F(FlexOptionTest, optionConfigGuardMatch) {
     EXPECT_FALSE(response->getOption(D6O_BOOTFILE_URL));
 }
 
+// Verify that constant expressions are precomputed and that expressions
+// used more than once are marked as shared.
+TEST_F(FlexOptionTest, optionConfigConstantShared) {
+    ElementPtr options = Element::createList();
+    ElementPtr option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_HOST_NAME));
+    option->set("add", Element::create(string("concat('a', 'bc')")));
+
+    option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_ROOT_PATH));
+    option->set("supersede", Element::create(string("option[12].hex")));
+
+    option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_BOOT_FILE_NAME));
+    option->set("add", Element::create(string("option[12].hex")));
+
+    option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_TFTP_SERVER_NAME));
+    option->set("remove", Element::create(string("not ('a' == 'b')")));
+
+    EXPECT_NO_THROW(impl_->testConfigure(options));
+    EXPECT_TRUE(impl_->getErrMsg().empty()) << impl_->getErrMsg();
+
+    auto map = impl_->getOptionConfigMap();
+    ASSERT_EQ(1, map.count(DHO_HOST_NAME));
+    FlexOptionImpl::OptionConfigPtr opt_cfg = map[DHO_HOST_NAME].front();
+    EXPECT_TRUE(opt_cfg->isConstant());
+    EXPECT_FALSE(opt_cfg->isShared());
+    EXPECT_EQ("abc", opt_cfg->getConstantValue());
+    ASSERT_TRUE(opt_cfg->getConstantOption());
+    EXPECT_EQ(DHO_HOST_NAME, opt_cfg->getConstantOption()->getType());
+
+    ASSERT_EQ(1, map.count(DHO_ROOT_PATH));
+    opt_cfg = map[DHO_ROOT_PATH].front();
+    EXPECT_FALSE(opt_cfg->isConstant());
+    EXPECT_TRUE(opt_cfg->isShared());
+
+    ASSERT_EQ(1, map.count(DHO_BOOT_FILE_NAME));
+    opt_cfg = map[DHO_BOOT_FILE_NAME].front();
+    EXPECT_FALSE(opt_cfg->isConstant());
+    EXPECT_TRUE(opt_cfg->isShared());
+
+    ASSERT_EQ(1, map.count(DHO_TFTP_SERVER_NAME));
+    opt_cfg = map[DHO_TFTP_SERVER_NAME].front();
+    EXPECT_TRUE(opt_cfg->isConstant());
+    EXPECT_EQ("true", opt_cfg->getConstantValue());
+    EXPECT_FALSE(opt_cfg->getConstantOption());
+}
+
+// Verify that the options built from a constant expression are not shared
+// between responses and that shared expressions give the right values.
+TEST_F(FlexOptionTest, processConstantShared) {
+    ElementPtr options = Element::createList();
+    ElementPtr option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_HOST_NAME));
+    option->set("add", Element::create(string("'abc'")));
+
+    option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_ROOT_PATH));
+    option->set("add", Element::create(string("option[60].hex")));
+
+    option = Element::createMap();
+    options->add(option);
+    option->set("code", Element::create(DHO_BOOT_FILE_NAME));
+    option->set("add", Element::create(string("option[60].hex")));
+
+    EXPECT_NO_THROW(impl_->testConfigure(options));
+    EXPECT_TRUE(impl_->getErrMsg().empty()) << impl_->getErrMsg();
+
+    OptionPtr opt1;
+    for (auto const& vendor : { "foo", "bar" }) {
+        Pkt4Ptr query(new Pkt4(DHCPDISCOVER, 12345));
+        OptionStringPtr str(new OptionString(Option::V4,
+                                             DHO_VENDOR_CLASS_IDENTIFIER,
+                                             vendor));
+        query->addOption(str);
+        Pkt4Ptr response(new Pkt4(DHCPOFFER, 12345));
+
+        EXPECT_NO_THROW(impl_->process<Pkt4Ptr>(Option::V4, query, response));
+
+        OptionPtr opt = response->getOption(DHO_HOST_NAME);
+        ASSERT_TRUE(opt);
+        const OptionBuffer& buffer = opt->getData();
+        ASSERT_EQ(3, buffer.size());
+        EXPECT_EQ(0, memcmp(&buffer[0], "abc", 3));
+        if (!opt1) {
+            opt1 = opt;
+        } else {
+            EXPECT_NE(opt1.get(), opt.get());
+        }
+
+        for (auto code : { DHO_ROOT_PATH, DHO_BOOT_FILE_NAME }) {
+            opt = response->getOption(code);
+            ASSERT_TRUE(opt);
+            const OptionBuffer& buf = opt->getData();
+            ASSERT_EQ(3, buf.size());
+            EXPECT_EQ(0, memcmp(&buf[0], vendor, 3));
+        }
+    }
+}
+
 } // end of anonymous namespace
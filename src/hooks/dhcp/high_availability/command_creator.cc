@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -156,16 +156,18 @@ CommandCreator::createLease6BulkApply(const Lease6CollectionPtr& leases,
 }
 
 ConstElementPtr
-CommandCreator::createLease6BulkApply(LeaseUpdateBacklog& leases) {
+CommandCreator::createLease6BulkApply(LeaseUpdateBacklog& leases,
+                                      const size_t max_leases) {
     ElementPtr deleted_leases_list = Element::createList();
     ElementPtr leases_list = Element::createList();
 
-    LeaseUpdateBacklog::OpType op_type;
-    Lease6Ptr lease;
-    while ((lease = boost::dynamic_pointer_cast<Lease6>(leases.pop(op_type)))) {
-        ElementPtr lease_as_json = lease->toElement();
+    // Take the leases at once to not lock the backlog for each lease.
+    std::vector<std::pair<LeaseUpdateBacklog::OpType, LeasePtr> > updates;
+    leases.pop(updates, max_leases);
+    for (auto const& update : updates) {
+        ElementPtr lease_as_json = update.second->toElement();
         insertLeaseExpireTime(lease_as_json);
-        if (op_type == LeaseUpdateBacklog::DELETE) {
+        if (update.first == LeaseUpdateBacklog::DELETE) {
             deleted_leases_list->add(lease_as_json);
         } else {
             leases_list->add(lease_as_json);
@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -109,12 +109,16 @@ public:
     /// @brief Creates lease6-bulk-apply command.
     ///
     /// This command pops the leases from the backlog. As a result, the
-    /// backlog is empty after calling this function.
+    /// backlog is empty after calling this function unless the number
+    /// of leases is limited.
     ///
     /// @param leases Reference to the collection of DHCPv6 leases backlog.
+    /// @param max_leases Maximum number of leases to include in the command.
+    /// The value of 0 means that all leases from the backlog are included.
     /// @return Pointer to the JSON representation of the command.
     static data::ConstElementPtr
-    createLease6BulkApply(LeaseUpdateBacklog& leases);
+    createLease6BulkApply(LeaseUpdateBacklog& leases,
+                          const size_t max_leases = 0);
 
     /// @brief Creates lease6-update command.
     ///
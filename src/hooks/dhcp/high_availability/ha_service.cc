@@ -27,6 +27,7 @@
 #include <boost/pointer_cast.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/weak_ptr.hpp>
+#include <algorithm>
 #include <functional>
 #include <sstream>
 
@@ -56,6 +57,10 @@ public:
         CtrlChannelError(file, line, what) {}
 };
 
+/// @brief Maximum number of leases in a lease6-bulk-apply command sent
+/// from the backlog.
+const size_t BACKLOG_LEASE6_BATCH_SIZE = 1000;
+
 }
 
 namespace isc {
@@ -2383,27 +2388,96 @@ HAService::synchronize(std::string& status_message, const std::string& server_na
     return (CONTROL_RESULT_SUCCESS);
 }
 
+/// @brief State of the lease updates being sent from the backlog.
+struct HAService::BacklogSendState {
+    /// @brief Constructor.
+    ///
+    /// @param post_request_action callback to be invoked when the operation
+    /// completes.
+    explicit BacklogSendState(PostRequestCallback post_request_action)
+        : in_flight_(1), rcode_(CONTROL_RESULT_SUCCESS), error_message_(),
+          post_request_action_(post_request_action), mutex_() {
+    }
+
+    /// @brief Records the completion of a command or of the initial sends.
+    ///
+    /// The callback is invoked when the last one completes.
+    void complete() {
+        std::string error_message;
+        int rcode;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--in_flight_ > 0) {
+                return;
+            }
+            error_message = error_message_;
+            rcode = rcode_;
+        }
+        post_request_action_(error_message.empty(), error_message, rcode);
+    }
+
+    /// @brief Number of commands in flight. It also counts the initial
+    /// sends so the callback isn't invoked before all clients were used.
+    size_t in_flight_;
+
+    /// @brief Control result of the first failed command.
+    int rcode_;
+
+    /// @brief Error message of the first failed command.
+    std::string error_message_;
+
+    /// @brief Callback to be invoked when the operation completes.
+    PostRequestCallback post_request_action_;
+
+    /// @brief Mutex to protect the state.
+    std::mutex mutex_;
+};
+
 void
-HAService::asyncSendLeaseUpdatesFromBacklog(HttpClient& http_client,
+HAService::asyncSendLeaseUpdatesFromBacklog(const std::vector<HttpClientPtr>& http_clients,
                                             const HAConfig::PeerConfigPtr& config,
                                             PostRequestCallback post_request_action) {
-    if (lease_update_backlog_.size() == 0) {
-        post_request_action(true, "", CONTROL_RESULT_SUCCESS);
-        return;
+    auto state = boost::make_shared<BacklogSendState>(post_request_action);
+    for (auto const& http_client : http_clients) {
+        if (!asyncSendLeaseUpdateFromBacklog(*http_client, config, state)) {
+            break;
+        }
     }
+    state->complete();
+}
 
+bool
+HAService::asyncSendLeaseUpdateFromBacklog(HttpClient& http_client,
+                                           const HAConfig::PeerConfigPtr& config,
+                                           const BacklogSendStatePtr& state) {
     ConstElementPtr command;
-    if (server_type_ == HAServerType::DHCPv4) {
-        LeaseUpdateBacklog::OpType op_type;
-        Lease4Ptr lease = boost::dynamic_pointer_cast<Lease4>(lease_update_backlog_.pop(op_type));
-        if (op_type == LeaseUpdateBacklog::ADD) {
-            command = CommandCreator::createLease4Update(*lease);
-        } else {
-            command = CommandCreator::createLease4Delete(*lease);
+    {
+        std::lock_guard<std::mutex> lock(state->mutex_);
+        // Stop sending after an error.
+        if (!state->error_message_.empty()) {
+            return (false);
         }
 
-    } else {
-        command = CommandCreator::createLease6BulkApply(lease_update_backlog_);
+        if (server_type_ == HAServerType::DHCPv4) {
+            LeaseUpdateBacklog::OpType op_type;
+            Lease4Ptr lease = boost::dynamic_pointer_cast<Lease4>(lease_update_backlog_.pop(op_type));
+            if (!lease) {
+                return (false);
+            }
+            if (op_type == LeaseUpdateBacklog::ADD) {
+                command = CommandCreator::createLease4Update(*lease);
+            } else {
+                command = CommandCreator::createLease4Delete(*lease);
+            }
+
+        } else {
+            if (lease_update_backlog_.size() == 0) {
+                return (false);
+            }
+            command = CommandCreator::createLease6BulkApply(lease_update_backlog_,
+                                                            BACKLOG_LEASE6_BATCH_SIZE);
+        }
+        ++state->in_flight_;
     }
 
     // Create HTTP/1.1 request including our command.
@@ -2420,7 +2494,7 @@ HAService::asyncSendLeaseUpdatesFromBacklog(HttpClient& http_client,
 
     http_client.asyncSendRequest(config->getUrl(), config->getTlsContext(),
                                  request, response,
-        [this, &http_client, config, post_request_action]
+        [this, &http_client, config, state]
             (const boost::system::error_code& ec,
              const HttpResponsePtr& response,
              const std::string& error_str) {
@@ -2446,17 +2520,21 @@ HAService::asyncSendLeaseUpdatesFromBacklog(HttpClient& http_client,
                  }
              }
 
-             // Recursively send all outstanding lease updates or break when an
-             // error occurs. In DHCPv6, this is a single iteration because we use
-             // lease6-bulk-apply, which combines many lease updates in a single
-             // transaction. In the case of DHCPv4, each update is sent in its own
-             // transaction.
-             if (error_message.empty()) {
-                 asyncSendLeaseUpdatesFromBacklog(http_client, config, post_request_action);
-             } else {
-                 post_request_action(error_message.empty(), error_message, rcode);
+             // Remember the first error. It stops sending the lease updates.
+             if (!error_message.empty()) {
+                 std::lock_guard<std::mutex> lock(state->mutex_);
+                 if (state->error_message_.empty()) {
+                     state->error_message_ = error_message;
+                     state->rcode_ = rcode;
+                 }
              }
+
+             // Send the next lease update over this client, if any, and
+             // account for the completion of this one.
+             asyncSendLeaseUpdateFromBacklog(http_client, config, state);
+             state->complete();
    });
+    return (true);
 }
 
 bool
@@ -2468,7 +2546,17 @@ HAService::sendLeaseUpdatesFromBacklog() {
     }
 
     IOService io_service;
-    HttpClient client(io_service, false);
+    // In multi-threaded mode the partner serves concurrent connections, so
+    // use several clients, each having its own connection. All clients run
+    // on this thread.
+    size_t num_clients = 1;
+    if (config_->getEnableMultiThreading()) {
+        num_clients = std::max(config_->getHttpClientThreads(), static_cast<uint32_t>(1));
+    }
+    std::vector<HttpClientPtr> clients;
+    for (size_t i = 0; i < num_clients; ++i) {
+        clients.push_back(boost::make_shared<HttpClient>(io_service, false));
+    }
     auto remote_config = config_->getFailoverPeerConfig();
     bool updates_successful = true;
 
@@ -2476,7 +2564,7 @@ HAService::sendLeaseUpdatesFromBacklog() {
         .arg(num_updates)
         .arg(remote_config->getName());
 
-    asyncSendLeaseUpdatesFromBacklog(client, remote_config,
+    asyncSendLeaseUpdatesFromBacklog(clients, remote_config,
                                      [&](const bool success, const std::string&, const int) {
         io_service.stop();
         updates_successful = success;
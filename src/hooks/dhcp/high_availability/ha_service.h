@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -890,24 +890,53 @@ protected:
     ///
     /// This method checks if there are any outstanding DHCPv4 or DHCPv6 leases
     /// in the backlog and schedules asynchronous sends of these leases. In
-    /// DHCPv6 case it sends a single lease6-bulk-apply command with all
-    /// outstanding leases. In DHCPv4 case, it sends lease4-update or lease4-delete
-    /// commands recursively (when one lease update completes successfully it
-    /// schedules sending next lease update).
+    /// DHCPv6 case it sends lease6-bulk-apply commands, each holding a batch
+    /// of outstanding leases. In DHCPv4 case, it sends lease4-update or
+    /// lease4-delete commands.
     ///
-    /// If there are no lease updates in the backlog it calls @c post_request_action
-    /// callback.
+    /// The backlog holds at most one lease update per address, so the order
+    /// of the updates doesn't matter. Each HTTP client sends one command at
+    /// a time and sends the next command when the previous one completes
+    /// successfully, so the commands are sent over as many connections as
+    /// there are clients. No new commands are sent after an error.
+    ///
+    /// The @c post_request_action callback is invoked once, when there are
+    /// no more lease updates in the backlog or after an error, when all
+    /// commands in flight complete.
     ///
     /// This method is called from @c sendLeaseUpdatesFromBacklog.
     ///
-    /// @param http_client reference to the HTTP client to be used for communication.
+    /// @param http_clients HTTP clients to be used for communication. The
+    /// clients must not be empty.
     /// @param remote_config pointer to the remote server's configuration.
     /// @param post_request_action callback to be invoked when the operation
     /// completes. It can be used for handling errors.
-    void asyncSendLeaseUpdatesFromBacklog(http::HttpClient& http_client,
+    void asyncSendLeaseUpdatesFromBacklog(const std::vector<http::HttpClientPtr>& http_clients,
                                           const HAConfig::PeerConfigPtr& remote_config,
                                           PostRequestCallback post_request_action);
 
+    /// @brief State of the lease updates being sent from the backlog.
+    struct BacklogSendState;
+
+    /// @brief Pointer to the state of the lease updates being sent from the
+    /// backlog.
+    typedef boost::shared_ptr<BacklogSendState> BacklogSendStatePtr;
+
+    /// @brief Sends the next lease update from backlog to partner asynchronously.
+    ///
+    /// In DHCPv6 case, the update is a batch of lease updates. When the
+    /// command completes successfully, the next update is sent using the same
+    /// HTTP client.
+    ///
+    /// @param http_client reference to the HTTP client to be used for communication.
+    /// @param remote_config pointer to the remote server's configuration.
+    /// @param state pointer to the state of the lease updates being sent.
+    /// @return true if a command was sent, false if the backlog is empty or
+    /// a previous command failed.
+    bool asyncSendLeaseUpdateFromBacklog(http::HttpClient& http_client,
+                                         const HAConfig::PeerConfigPtr& remote_config,
+                                         const BacklogSendStatePtr& state);
+
     /// @brief Attempts to send all lease updates from the backlog synchronously.
     ///
     /// This method is called upon exiting communication-recovery state and before
@@ -917,7 +946,9 @@ protected:
     /// between new allocations and outstanding updates this method is synchronous.
     ///
     /// This method creates its own instances of the HttpClient and IOService and
-    /// invokes IOService::run().
+    /// invokes IOService::run(). When multi-threading is enabled, it creates
+    /// as many single-threaded HTTP clients as the configured number of HTTP
+    /// client threads to send the lease updates over concurrent connections.
     ///
     /// @return boolean value indicating that the lease updates were delivered
     /// successfully (when true) or unsuccessfully (when false).
@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -36,6 +36,16 @@ LeaseUpdateBacklog::pop(LeaseUpdateBacklog::OpType& op_type) {
     return (popInternal(op_type));
 }
 
+size_t
+LeaseUpdateBacklog::pop(std::vector<std::pair<OpType, LeasePtr> >& updates,
+                        const size_t max_updates) {
+    if (util::MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (popInternal(updates, max_updates));
+    }
+    return (popInternal(updates, max_updates));
+}
+
 bool
 LeaseUpdateBacklog::wasOverflown() {
     if (util::MultiThreadingMgr::instance().getMode()) {
@@ -51,6 +61,7 @@ LeaseUpdateBacklog::clear() {
         std::lock_guard<std::mutex> lock(mutex_);
         outstanding_updates_.clear();
         overflown_ = false;
+        return;
     }
     outstanding_updates_.clear();
     overflown_ = false;
@@ -67,11 +78,21 @@ LeaseUpdateBacklog::size() {
 
 bool
 LeaseUpdateBacklog::pushInternal(const LeaseUpdateBacklog::OpType op_type, const LeasePtr& lease) {
+    // Replace the update for the same address, if any.
+    auto& index = outstanding_updates_.get<1>();
+    auto existing = index.find(boost::make_tuple(lease->addr_, lease->getType()));
+    if (existing != index.end()) {
+        index.modify(existing, [op_type, &lease](LeaseUpdate& update) {
+            update.op_type_ = op_type;
+            update.lease_ = lease;
+        });
+        return (true);
+    }
     if (outstanding_updates_.size() >= limit_) {
         overflown_ = true;
         return (false);
     }
-    outstanding_updates_.push_back(std::make_pair(op_type, lease));
+    outstanding_updates_.push_back(LeaseUpdate(op_type, lease));
     return (true);
 }
 
@@ -80,10 +101,24 @@ LeaseUpdateBacklog::popInternal(LeaseUpdateBacklog::OpType& op_type) {
     if (outstanding_updates_.empty()) {
         return (LeasePtr());
     }
-    auto item = outstanding_updates_.front();
+    auto lease = outstanding_updates_.front().lease_;
+    op_type = outstanding_updates_.front().op_type_;
     outstanding_updates_.pop_front();
-    op_type = item.first;
-    return (item.second);
+    return (lease);
+}
+
+size_t
+LeaseUpdateBacklog::popInternal(std::vector<std::pair<OpType, LeasePtr> >& updates,
+                                const size_t max_updates) {
+    size_t count = 0;
+    while (!outstanding_updates_.empty() &&
+           ((max_updates == 0) || (count < max_updates))) {
+        auto const& update = outstanding_updates_.front();
+        updates.push_back(std::make_pair(update.op_type_, update.lease_));
+        outstanding_updates_.pop_front();
+        ++count;
+    }
+    return (count);
 }
 
 } // end of namespace isc::ha
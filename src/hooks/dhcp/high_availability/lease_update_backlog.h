@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,10 +7,17 @@
 #ifndef HA_LEASE_BACKLOG_H
 #define HA_LEASE_BACKLOG_H
 
+#include <asiolink/io_address.h>
 #include <dhcpsrv/lease.h>
-#include <deque>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/indexed_by.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 #include <mutex>
 #include <utility>
+#include <vector>
 
 namespace isc {
 namespace ha {
@@ -32,16 +39,14 @@ namespace ha {
 /// There are two types of lease updates: "Add" and "Delete". The type
 /// is specified when the lease is appended to the queue.
 ///
-/// The backlog queue holds both "Add" and "Delete" lease updates in a
-/// single std::deque container, which allows for ordering them
-/// chronologically and using this ordering for queue optimizations in
-/// the future. For example, if the queue contains consecutive "Delete"
-/// updates for a particular IP address, the server could only delete
-/// the lease once. If the queue contains multiple "Delete" lease updates
-/// followed by an "Add" update, the server could skip sending "Delete"
-/// updates.
-///
-/// Queue optimizations will be subject to future work!
+/// The queue holds at most one lease update per leased address. Only
+/// the final state of the lease matters to the partner, so a new update
+/// for an address already in the queue replaces the previous one, which
+/// keeps its position. For example, several "Delete" updates for an
+/// address result in a single "Delete", and "Delete" updates followed by
+/// an "Add" update result in the "Add" update only. A replaced update
+/// doesn't count against the queue size limit, so the repeated updates
+/// for the same clients during a long outage don't overflow the queue.
 class LeaseUpdateBacklog {
 public:
 
@@ -59,6 +64,9 @@ public:
 
     /// @brief Appends lease update to the queue.
     ///
+    /// If the queue already holds an update for the lease address, this
+    /// update replaces it.
+    ///
     /// @param op_type type of the lease update (operation type).
     /// @param lease pointer to the lease being added, or deleted.
     /// @return boolean value indicating whether the lease was successfully
@@ -72,6 +80,17 @@ public:
     /// when the queue is empty.
     dhcp::LeasePtr pop(OpType& op_type);
 
+    /// @brief Returns the next lease updates and removes them from the queue.
+    ///
+    /// @param [out] updates reference to the container receiving the lease
+    /// updates and their types, in the queue order. The container is not
+    /// cleared by this method.
+    /// @param max_updates maximum number of lease updates to return. The
+    /// value of 0 means that all lease updates are returned.
+    /// @return number of lease updates returned.
+    size_t pop(std::vector<std::pair<OpType, dhcp::LeasePtr> >& updates,
+               const size_t max_updates = 0);
+
     /// @brief Checks if the queue was overflown.
     ///
     /// This method returns true if the number of lease updates exceeded
@@ -112,6 +131,75 @@ private:
     /// when the queue is empty.
     dhcp::LeasePtr popInternal(OpType& op_type);
 
+    /// @brief Returns the next lease updates and removes them from the queue
+    /// (thread unsafe).
+    ///
+    /// @param [out] updates reference to the container receiving the lease
+    /// updates and their types.
+    /// @param max_updates maximum number of lease updates to return or 0.
+    /// @return number of lease updates returned.
+    size_t popInternal(std::vector<std::pair<OpType, dhcp::LeasePtr> >& updates,
+                       const size_t max_updates);
+
+    /// @brief Structure holding a lease update.
+    ///
+    /// The update is indexed by the address and type of its lease, so it
+    /// holds no copy of them. The whole lease is kept because the commands
+    /// sending the update to the partner carry all of its fields.
+    struct LeaseUpdate {
+        /// @brief Constructor.
+        ///
+        /// @param op_type type of the lease update (operation type).
+        /// @param lease pointer to the lease being added, or deleted.
+        LeaseUpdate(const OpType op_type, const dhcp::LeasePtr& lease)
+            : op_type_(op_type), lease_(lease) {
+        }
+
+        /// @brief Returns the leased address or delegated prefix.
+        ///
+        /// @return the address of the lease.
+        const asiolink::IOAddress& getAddress() const {
+            return (lease_->addr_);
+        }
+
+        /// @brief Returns the lease type.
+        ///
+        /// It distinguishes the delegated prefixes from the addresses.
+        ///
+        /// @return the type of the lease.
+        dhcp::Lease::Type getLeaseType() const {
+            return (lease_->getType());
+        }
+
+        /// @brief Type of the lease update (operation type).
+        OpType op_type_;
+
+        /// @brief Pointer to the lease being added, or deleted.
+        dhcp::LeasePtr lease_;
+    };
+
+    /// @brief Multi index container holding lease updates.
+    typedef boost::multi_index_container<
+        LeaseUpdate,
+        boost::multi_index::indexed_by<
+            // First index keeps the lease updates in the order of their
+            // insertion.
+            boost::multi_index::sequenced<>,
+            // Second index allows for finding the lease update for a given
+            // address.
+            boost::multi_index::hashed_unique<
+                boost::multi_index::composite_key<
+                    LeaseUpdate,
+                    boost::multi_index::const_mem_fun<LeaseUpdate,
+                                                      const asiolink::IOAddress&,
+                                                      &LeaseUpdate::getAddress>,
+                    boost::multi_index::const_mem_fun<LeaseUpdate, dhcp::Lease::Type,
+                                                      &LeaseUpdate::getLeaseType>
+                >
+            >
+        >
+    > LeaseUpdates;
+
     /// @brief Holds the queue size limit.
     size_t limit_;
 
@@ -119,7 +207,7 @@ private:
     bool overflown_;
 
     /// @brief Actual queue of lease updates and their types.
-    std::deque<std::pair<OpType, dhcp::LeasePtr> > outstanding_updates_;
+    LeaseUpdates outstanding_updates_;
 
     /// @brief Mutex to protect internal state.
     std::mutex mutex_;
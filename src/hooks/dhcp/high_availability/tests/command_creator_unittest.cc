@@ -1,4 +1,4 @@
-// Copyright (C) 2018-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2018-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -386,6 +386,7 @@ TEST(CommandCreatorTest, createLease6BulkApply) {
 TEST(CommandCreatorTest, createLease6BulkApplyFromBacklog) {
     Lease6Ptr lease = createLease6();
     Lease6Ptr deleted_lease = createLease6();
+    deleted_lease->addr_ = IOAddress("2001:db8:1::beef");
 
     LeaseUpdateBacklog backlog(100);
     backlog.push(LeaseUpdateBacklog::ADD, lease);
@@ -402,7 +403,7 @@ TEST(CommandCreatorTest, createLease6BulkApplyFromBacklog) {
     ASSERT_EQ(Element::list, deleted_leases_json->getType());
     ASSERT_EQ(1, deleted_leases_json->size());
     auto lease_as_json = deleted_leases_json->get(0);
-    EXPECT_EQ(leaseAsJson(createLease6())->str(), lease_as_json->str());
+    EXPECT_EQ(leaseAsJson(deleted_lease)->str(), lease_as_json->str());
 
     // Verify leases.
     auto leases_json = arguments->get("leases");
@@ -416,6 +417,42 @@ TEST(CommandCreatorTest, createLease6BulkApplyFromBacklog) {
     EXPECT_EQ(0, backlog.size());
 }
 
+// This test verifies that the lease6-bulk-apply command can be created
+// from a part of the DHCPv6 leases backlog.
+TEST(CommandCreatorTest, createLease6BulkApplyFromBacklogLimited) {
+    LeaseUpdateBacklog backlog(100);
+    for (auto i = 0; i < 5; ++i) {
+        Lease6Ptr lease = createLease6();
+        lease->addr_ = IOAddress("2001:db8:1::" + std::to_string(i + 1));
+        backlog.push(i % 2 ? LeaseUpdateBacklog::ADD : LeaseUpdateBacklog::DELETE, lease);
+    }
+
+    // Take the first 3 leases.
+    ConstElementPtr command = CommandCreator::createLease6BulkApply(backlog, 3);
+    ConstElementPtr arguments;
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease6-bulk-apply",
+                                              "dhcp6", arguments));
+    auto deleted_leases_json = arguments->get("deleted-leases");
+    ASSERT_TRUE(deleted_leases_json);
+    ASSERT_EQ(2, deleted_leases_json->size());
+    auto leases_json = arguments->get("leases");
+    ASSERT_TRUE(leases_json);
+    ASSERT_EQ(1, leases_json->size());
+    EXPECT_EQ(2, backlog.size());
+
+    // Take the remaining leases.
+    command = CommandCreator::createLease6BulkApply(backlog, 3);
+    ASSERT_NO_FATAL_FAILURE(testCommandBasics(command, "lease6-bulk-apply",
+                                              "dhcp6", arguments));
+    deleted_leases_json = arguments->get("deleted-leases");
+    ASSERT_TRUE(deleted_leases_json);
+    ASSERT_EQ(1, deleted_leases_json->size());
+    leases_json = arguments->get("leases");
+    ASSERT_TRUE(leases_json);
+    ASSERT_EQ(1, leases_json->size());
+    EXPECT_EQ(0, backlog.size());
+}
+
 // This test verifies that the lease6-get-all command is correct.
 TEST(CommandCreatorTest, createLease6GetAll) {
     ConstElementPtr command = CommandCreator::createLease6GetAll();
@@ -41,6 +41,7 @@
 #include <testutils/gtest_utils.h>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/pointer_cast.hpp>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
@@ -196,6 +197,7 @@ public:
     }
 
     using HAService::asyncSendHeartbeat;
+    using HAService::asyncSendLeaseUpdatesFromBacklog;
     using HAService::asyncSyncLeases;
     using HAService::postNextEvent;
     using HAService::transition;
@@ -204,6 +206,7 @@ public:
     using HAService::shouldQueueLeaseUpdates;
     using HAService::pendingRequestSize;
     using HAService::getPendingRequest;
+    using HAService::sendLeaseUpdatesFromBacklog;
     using HAService::network_state_;
     using HAService::config_;
     using HAService::communication_state_;
@@ -1686,6 +1689,173 @@ public:
         EXPECT_EQ(0, service_->lease_update_backlog_.size());
     }
 
+    /// @brief Creates the service with lease updates in the backlog.
+    ///
+    /// @param server_type server type, i.e. DHCPv4 or DHCPv6.
+    /// @param num_leases number of lease updates in the backlog.
+    /// @param http_client_threads number of HTTP client threads. When it
+    /// is greater than 0, multi-threading is enabled.
+    void createServiceWithBacklog(const HAServerType& server_type,
+                                  const size_t num_leases,
+                                  const uint32_t http_client_threads) {
+        HAConfigPtr config_storage = createValidConfiguration();
+        config_storage->setDelayedUpdatesLimit(num_leases);
+        createSTService(network_state_, config_storage, server_type);
+
+        // The backlog is sent over the connections of the single-threaded
+        // clients created for this purpose, so the multi-threading can be
+        // enabled after the creation of the service.
+        if (http_client_threads > 0) {
+            MultiThreadingMgr::instance().setMode(true);
+            service_->config_->setEnableMultiThreading(true);
+            service_->config_->setHttpClientThreads(http_client_threads);
+        }
+
+        IOAddress address(server_type == HAServerType::DHCPv4 ?
+                          "192.0.2.1" : "2001:db8:1::1");
+        for (size_t i = 0; i < num_leases; ++i) {
+            LeasePtr lease;
+            if (server_type == HAServerType::DHCPv4) {
+                std::vector<uint8_t> hwaddr(6, 1);
+                hwaddr[4] = static_cast<uint8_t>(i >> 8);
+                hwaddr[5] = static_cast<uint8_t>(i);
+                lease.reset(new Lease4(address,
+                                       HWAddrPtr(new HWAddr(hwaddr, HTYPE_ETHER)),
+                                       ClientIdPtr(), 60, 1000, SubnetID(1)));
+            } else {
+                DuidPtr duid(new DUID(std::vector<uint8_t>(8, 2)));
+                lease.reset(new Lease6(Lease::TYPE_NA, address, duid, 1234,
+                                       50, 60, SubnetID(1)));
+            }
+            ASSERT_TRUE(service_->lease_update_backlog_.push(LeaseUpdateBacklog::ADD,
+                                                             lease));
+            address = IOAddress::increase(address);
+        }
+        ASSERT_EQ(num_leases, service_->lease_update_backlog_.size());
+    }
+
+    /// @brief Returns the numbers of leases in the lease6-bulk-apply commands
+    /// received by the partner.
+    ///
+    /// @return the numbers of leases in the order of the commands.
+    std::vector<size_t> getBulkApplySizes() {
+        std::vector<size_t> sizes;
+        auto requests = factory2_->getResponseCreator()->getReceivedRequests();
+        for (auto const& request : requests) {
+            ConstElementPtr body = request->getBodyAsJson();
+            if (!body || (body->get("command")->stringValue() != "lease6-bulk-apply")) {
+                continue;
+            }
+            ConstElementPtr args = body->get("arguments");
+            sizes.push_back(args->get("leases")->size() +
+                            args->get("deleted-leases")->size());
+        }
+        return (sizes);
+    }
+
+    /// @brief Tests sending the lease updates from the backlog over several
+    /// connections when multi-threading is enabled.
+    ///
+    /// The DHCPv6 backlog is sent in lease6-bulk-apply commands of at most
+    /// 1000 leases, one command being in flight over each connection.
+    void testSendLeaseUpdatesFromBacklog6MultiThreading() {
+        ASSERT_NO_FATAL_FAILURE(createServiceWithBacklog(HAServerType::DHCPv6,
+                                                         2500, 2));
+        ASSERT_NO_THROW(listener2_->start());
+
+        bool success = false;
+        testSynchronousCommands([this, &success]() {
+            success = service_->sendLeaseUpdatesFromBacklog();
+        });
+        EXPECT_TRUE(success);
+        EXPECT_EQ(0, service_->lease_update_backlog_.size());
+
+        // The batches are sent in the order of the backlog.
+        std::vector<size_t> sizes = getBulkApplySizes();
+        ASSERT_EQ(3, sizes.size());
+        EXPECT_EQ(1000, sizes[0]);
+        EXPECT_EQ(1000, sizes[1]);
+        EXPECT_EQ(500, sizes[2]);
+    }
+
+    /// @brief Tests that no lease update from the backlog is sent after an
+    /// error.
+    ///
+    /// @param http_client_threads number of HTTP client threads. When it
+    /// is greater than 0, multi-threading is enabled.
+    /// @param expected_requests number of commands expected to be received
+    /// by the partner, i.e. the number of commands sent before the first
+    /// response.
+    void testSendLeaseUpdatesFromBacklog4Failed(const uint32_t http_client_threads,
+                                                const size_t expected_requests) {
+        factory2_->getResponseCreator()->setControlResult("lease4-update",
+                                                          CONTROL_RESULT_ERROR);
+        ASSERT_NO_FATAL_FAILURE(createServiceWithBacklog(HAServerType::DHCPv4,
+                                                         20, http_client_threads));
+        ASSERT_NO_THROW(listener2_->start());
+
+        bool success = true;
+        testSynchronousCommands([this, &success]() {
+            success = service_->sendLeaseUpdatesFromBacklog();
+        });
+        EXPECT_FALSE(success);
+
+        // Each client had a command in flight when the first error was
+        // received and none was sent after it.
+        EXPECT_EQ(expected_requests,
+                  factory2_->getResponseCreator()->getReceivedRequests().size());
+        EXPECT_EQ(20 - expected_requests, service_->lease_update_backlog_.size());
+    }
+
+    /// @brief Tests that the callback of the asynchronous send of the lease
+    /// updates from the backlog is invoked once.
+    ///
+    /// @param control_result control result returned by the partner.
+    void testAsyncSendLeaseUpdatesFromBacklogCallback(const int control_result) {
+        factory2_->getResponseCreator()->setControlResult(control_result);
+        ASSERT_NO_FATAL_FAILURE(createServiceWithBacklog(HAServerType::DHCPv4,
+                                                         20, 4));
+        ASSERT_NO_THROW(listener2_->start());
+
+        IOService io_service;
+        std::vector<HttpClientPtr> clients;
+        for (int i = 0; i < 4; ++i) {
+            clients.push_back(boost::make_shared<HttpClient>(io_service, false));
+        }
+
+        int callback_count = 0;
+        bool success = false;
+        testSynchronousCommands([&]() {
+            service_->asyncSendLeaseUpdatesFromBacklog(clients,
+                                                       service_->config_->getFailoverPeerConfig(),
+                [&](const bool result, const std::string&, const int) {
+                ++callback_count;
+                success = result;
+                io_service.stop();
+            });
+            io_service.run();
+
+            // Run the handlers which are still ready: none of them may
+            // invoke the callback again.
+            io_service.get_io_service().reset();
+            io_service.poll();
+        });
+
+        EXPECT_EQ(1, callback_count);
+        if (control_result == CONTROL_RESULT_SUCCESS) {
+            EXPECT_TRUE(success);
+            EXPECT_EQ(20, factory2_->getResponseCreator()->getReceivedRequests().size());
+            EXPECT_EQ(0, service_->lease_update_backlog_.size());
+        } else {
+            EXPECT_FALSE(success);
+            EXPECT_EQ(4, factory2_->getResponseCreator()->getReceivedRequests().size());
+        }
+
+        for (auto const& client : clients) {
+            client->stop();
+        }
+    }
+
     /// @brief Tests scenarios when lease updates are not sent to the failover peer.
     void testSendUpdatesPartnerDown6() {
         // Start HTTP servers.
@@ -2577,6 +2747,36 @@ TEST_F(HAServiceTest, communicationRecovery6FailedPartnerReadyMultiThreading) {
                                                CONTROL_RESULT_SUCCESS, true);
 }
 
+// Test that the DHCPv6 lease updates from the backlog are sent in batches
+// over several connections when multi-threading is enabled.
+TEST_F(HAServiceTest, sendLeaseUpdatesFromBacklog6MultiThreading) {
+    testSendLeaseUpdatesFromBacklog6MultiThreading();
+}
+
+// Test that only one lease update from the backlog is sent before the first
+// error when multi-threading is disabled.
+TEST_F(HAServiceTest, sendLeaseUpdatesFromBacklog4Failed) {
+    testSendLeaseUpdatesFromBacklog4Failed(0, 1);
+}
+
+// Test that one lease update from the backlog per connection is sent before
+// the first error when multi-threading is enabled.
+TEST_F(HAServiceTest, sendLeaseUpdatesFromBacklog4FailedMultiThreading) {
+    testSendLeaseUpdatesFromBacklog4Failed(4, 4);
+}
+
+// Test that the callback of the asynchronous send of the lease updates from
+// the backlog is invoked once when all updates are successful.
+TEST_F(HAServiceTest, asyncSendLeaseUpdatesFromBacklogCallback) {
+    testAsyncSendLeaseUpdatesFromBacklogCallback(CONTROL_RESULT_SUCCESS);
+}
+
+// Test that the callback of the asynchronous send of the lease updates from
+// the backlog is invoked once when the updates fail.
+TEST_F(HAServiceTest, asyncSendLeaseUpdatesFromBacklogCallbackFailed) {
+    testAsyncSendLeaseUpdatesFromBacklogCallback(CONTROL_RESULT_ERROR);
+}
+
 // Test scenario when all lease updates are sent successfully.
 TEST_F(HAServiceTest, sendSuccessfulUpdates6Authorized) {
     // Update config to provide authentication.
@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2020-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -88,4 +88,100 @@ TEST(LeaseUpdateBacklogTest, clear) {
     EXPECT_EQ(0, backlog.size());
 }
 
+// This test verifies that a lease update replaces the queued update for
+// the same address.
+TEST(LeaseUpdateBacklogTest, replace) {
+    // Create the queue with limit of 2 lease updates.
+    LeaseUpdateBacklog backlog(2);
+
+    HWAddrPtr hwaddr = boost::make_shared<HWAddr>(std::vector<uint8_t>(6, 1), HTYPE_ETHER);
+    Lease4Ptr lease1 = boost::make_shared<Lease4>(IOAddress("192.0.2.1"), hwaddr,
+                                                  ClientIdPtr(), 60, 0, 1);
+    Lease4Ptr lease2 = boost::make_shared<Lease4>(IOAddress("192.0.2.2"), hwaddr,
+                                                  ClientIdPtr(), 60, 0, 1);
+    Lease4Ptr lease3 = boost::make_shared<Lease4>(IOAddress("192.0.2.1"), hwaddr,
+                                                  ClientIdPtr(), 120, 0, 1);
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease1));
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease2));
+
+    // The queue is full but the updates for the queued addresses are
+    // still accepted.
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::DELETE, lease1));
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease3));
+    EXPECT_FALSE(backlog.wasOverflown());
+    EXPECT_EQ(2, backlog.size());
+
+    // The last update for the first address keeps its position.
+    LeaseUpdateBacklog::OpType op_type;
+    auto lease = backlog.pop(op_type);
+    EXPECT_EQ(LeaseUpdateBacklog::ADD, op_type);
+    EXPECT_TRUE(lease == lease3);
+
+    lease = backlog.pop(op_type);
+    EXPECT_EQ(LeaseUpdateBacklog::ADD, op_type);
+    EXPECT_TRUE(lease == lease2);
+
+    EXPECT_FALSE(backlog.pop(op_type));
+}
+
+// This test verifies that the updates of an address and a prefix with
+// the same value are both kept.
+TEST(LeaseUpdateBacklogTest, replacePrefix) {
+    LeaseUpdateBacklog backlog(10);
+
+    DuidPtr duid = boost::make_shared<DUID>(std::vector<uint8_t>(8, 2));
+    Lease6Ptr lease = boost::make_shared<Lease6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"),
+                                                 duid, 1234, 50, 60, 1);
+    Lease6Ptr prefix = boost::make_shared<Lease6>(Lease::TYPE_PD, IOAddress("2001:db8:1::"),
+                                                  duid, 1234, 50, 60, 1, HWAddrPtr(), 64);
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::ADD, lease));
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::DELETE, prefix));
+    EXPECT_EQ(2, backlog.size());
+
+    ASSERT_TRUE(backlog.push(LeaseUpdateBacklog::DELETE, lease));
+    EXPECT_EQ(2, backlog.size());
+
+    LeaseUpdateBacklog::OpType op_type;
+    EXPECT_TRUE(backlog.pop(op_type) == lease);
+    EXPECT_EQ(LeaseUpdateBacklog::DELETE, op_type);
+    EXPECT_TRUE(backlog.pop(op_type) == prefix);
+    EXPECT_EQ(LeaseUpdateBacklog::DELETE, op_type);
+}
+
+// This test verifies that lease updates can be retrieved in batches.
+TEST(LeaseUpdateBacklogTest, popBatch) {
+    LeaseUpdateBacklog backlog(10);
+
+    // Add 5 lease updates.
+    for (auto i = 0; i < 5; ++i) {
+        IOAddress address(i + 1);
+        HWAddrPtr hwaddr = boost::make_shared<HWAddr>(std::vector<uint8_t>(6, static_cast<uint8_t>(i)),
+                                                      HTYPE_ETHER);
+        Lease4Ptr lease = boost::make_shared<Lease4>(address, hwaddr, ClientIdPtr(), 60, 0, 1);
+        ASSERT_TRUE(backlog.push(i % 2 ? LeaseUpdateBacklog::ADD : LeaseUpdateBacklog::DELETE, lease));
+    }
+
+    // Get the first 3 lease updates.
+    std::vector<std::pair<LeaseUpdateBacklog::OpType, LeasePtr> > updates;
+    ASSERT_EQ(3, backlog.pop(updates, 3));
+    ASSERT_EQ(3, updates.size());
+    for (auto i = 0; i < 3; ++i) {
+        EXPECT_EQ(i % 2 ? LeaseUpdateBacklog::ADD : LeaseUpdateBacklog::DELETE, updates[i].first);
+        EXPECT_EQ(IOAddress(i + 1), updates[i].second->addr_);
+    }
+    EXPECT_EQ(2, backlog.size());
+
+    // Get the remaining lease updates.
+    updates.clear();
+    ASSERT_EQ(2, backlog.pop(updates));
+    ASSERT_EQ(2, updates.size());
+    EXPECT_EQ(IOAddress(5), updates[1].second->addr_);
+    EXPECT_EQ(0, backlog.size());
+
+    // The queue is empty.
+    updates.clear();
+    EXPECT_EQ(0, backlog.pop(updates));
+    EXPECT_TRUE(updates.empty());
+}
+
 } // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -20,7 +20,9 @@ namespace run_script {
 
 IOServicePtr RunScriptImpl::io_service_;
 
-RunScriptImpl::RunScriptImpl() : name_(), sync_(false) {
+RunScriptImpl::RunScriptImpl()
+    : name_(), sync_(false), helper_(false),
+      helper_queue_size_(ScriptHelper::DEFAULT_QUEUE_SIZE), script_helper_() {
 }
 
 void
@@ -45,10 +47,38 @@ RunScriptImpl::configure(LibraryHandle& handle) {
         }
         setSync(sync->boolValue());
     }
+    ConstElementPtr helper = handle.getParameter("helper");
+    if (helper) {
+        if (helper->getType() != Element::boolean) {
+            isc_throw(InvalidParameter, "The 'helper' parameter must be a boolean");
+        }
+        setHelper(helper->boolValue());
+    }
+    ConstElementPtr queue_size = handle.getParameter("helper-queue-size");
+    if (queue_size) {
+        if ((queue_size->getType() != Element::integer) ||
+            (queue_size->intValue() <= 0)) {
+            isc_throw(InvalidParameter, "The 'helper-queue-size' parameter"
+                      " must be a positive integer");
+        }
+        setHelperQueueSize(queue_size->intValue());
+    }
+}
+
+void
+RunScriptImpl::startHelper() {
+    if (helper_ && !script_helper_) {
+        script_helper_.reset(new ScriptHelper(name_, helper_queue_size_));
+        script_helper_->start(getIOService());
+    }
 }
 
 void
 RunScriptImpl::runScript(const ProcessArgs& args, const ProcessEnvVars& vars) {
+    if (script_helper_) {
+        script_helper_->push(args, vars);
+        return;
+    }
     ProcessSpawn process(getIOService(), name_, args, vars);
     process.spawn(true);
 }
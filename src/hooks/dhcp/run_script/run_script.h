@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -16,6 +16,7 @@
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/subnet.h>
 #include <hooks/library_handle.h>
+#include <run_script_helper.h>
 #include <string>
 
 namespace isc {
@@ -219,6 +220,9 @@ public:
 
     /// @brief Run Script with specified arguments and environment parameters.
     ///
+    /// In the helper mode the event is queued for the helper process,
+    /// otherwise a new process is spawned.
+    ///
     /// @param args The arguments for the target script.
     /// @param vars The environment variables made available for the target
     /// script.
@@ -253,6 +257,40 @@ public:
         return (sync_);
     }
 
+    /// @brief Set the helper mode for the target script.
+    ///
+    /// @param helper The helper mode for the target script.
+    void setHelper(const bool helper) {
+        helper_ = helper;
+    }
+
+    /// @brief Get the helper mode for the target script.
+    ///
+    /// @return The helper mode for the target script.
+    bool getHelper() const {
+        return (helper_);
+    }
+
+    /// @brief Set the maximum number of events queued for the helper.
+    ///
+    /// @param queue_size The maximum number of queued events.
+    void setHelperQueueSize(const size_t queue_size) {
+        helper_queue_size_ = queue_size;
+    }
+
+    /// @brief Get the maximum number of events queued for the helper.
+    ///
+    /// @return The maximum number of queued events.
+    size_t getHelperQueueSize() const {
+        return (helper_queue_size_);
+    }
+
+    /// @brief Starts the helper process in the helper mode.
+    ///
+    /// It must be called after the IO service has been set. It is a no-op
+    /// when the helper mode is disabled or the helper is already started.
+    void startHelper();
+
     /// @brief This function parses and applies configuration parameters.
     void configure(isc::hooks::LibraryHandle& handle);
 
@@ -267,6 +305,18 @@ private:
     /// started.
     bool sync_;
 
+    /// @brief Helper flag
+    ///
+    /// When set to true, the script is started once and the events are
+    /// delivered to it through its standard input, see @ref ScriptHelper.
+    bool helper_;
+
+    /// @brief Maximum number of events queued for the helper.
+    size_t helper_queue_size_;
+
+    /// @brief The helper delivering the events in the helper mode.
+    ScriptHelperPtr script_helper_;
+
     /// @brief The IOService object, used for all ASIO operations.
     static isc::asiolink::IOServicePtr io_service_;
 };
@@ -101,6 +101,7 @@ int dhcp4_srv_configured(CalloutHandle& handle) {
             return (1);
         }
         RunScriptImpl::setIOService(io_service);
+        impl->startHelper();
 
     } catch (const exception& ex) {
         LOG_ERROR(run_script_logger, RUN_SCRIPT_LOAD_ERROR)
@@ -126,6 +127,7 @@ int dhcp6_srv_configured(CalloutHandle& handle) {
             return (1);
         }
         RunScriptImpl::setIOService(io_service);
+        impl->startHelper();
 
     } catch (const exception& ex) {
         LOG_ERROR(run_script_logger, RUN_SCRIPT_LOAD_ERROR)
@@ -0,0 +1,248 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <run_script_helper.h>
+#include <run_script_log.h>
+#include <stats/stats_mgr.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace isc::asiolink;
+using namespace isc::stats;
+using namespace std;
+
+namespace isc {
+namespace run_script {
+
+const size_t ScriptHelper::DEFAULT_QUEUE_SIZE = 1024;
+
+const string ScriptHelper::DROPPED_STAT = "run-script-dropped-events";
+
+ScriptHelper::ScriptHelper(const string& name, size_t queue_size)
+    : name_(name), queue_size_(queue_size), io_service_(), fd_(-1),
+      last_spawn_(), mutex_(), cv_(), queue_(), stopping_(false),
+      full_(false), dropped_(0), thread_() {
+}
+
+ScriptHelper::~ScriptHelper() {
+    stop();
+}
+
+void
+ScriptHelper::start(const IOServicePtr& io_service) {
+    if (thread_) {
+        return;
+    }
+    io_service_ = io_service;
+    StatsMgr::instance().setValue(DROPPED_STAT, static_cast<int64_t>(0));
+    spawn();
+    stopping_ = false;
+    thread_.reset(new thread(&ScriptHelper::run, this));
+}
+
+void
+ScriptHelper::stop() {
+    if (!thread_) {
+        return;
+    }
+    {
+        lock_guard<mutex> lk(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_->join();
+    thread_.reset();
+    closeSocket();
+}
+
+bool
+ScriptHelper::push(const ProcessArgs& args, const ProcessEnvVars& vars) {
+    string record = serialize(args, vars);
+    {
+        lock_guard<mutex> lk(mutex_);
+        if (queue_.size() < queue_size_) {
+            queue_.push_back(record);
+            full_ = false;
+            record.clear();
+        } else if (!full_) {
+            full_ = true;
+            LOG_WARN(run_script_logger, RUN_SCRIPT_HELPER_QUEUE_FULL)
+                .arg(queue_size_);
+        }
+    }
+    if (!record.empty()) {
+        drop(1);
+        return (false);
+    }
+    cv_.notify_one();
+    return (true);
+}
+
+uint64_t
+ScriptHelper::getDropped() const {
+    lock_guard<mutex> lk(mutex_);
+    return (dropped_);
+}
+
+string
+ScriptHelper::serialize(const ProcessArgs& args, const ProcessEnvVars& vars) {
+    string record;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (i > 0) {
+            record += ' ';
+        }
+        record += args[i];
+    }
+    record += '\n';
+    for (auto const& var : vars) {
+        for (auto c : var) {
+            if (c == '\\') {
+                record += "\\\\";
+            } else if (c == '\n') {
+                record += "\\n";
+            } else {
+                record += c;
+            }
+        }
+        record += '\n';
+    }
+    record += '\n';
+    return (record);
+}
+
+void
+ScriptHelper::run() {
+    for (;;) {
+        deque<string> batch;
+        {
+            unique_lock<mutex> lk(mutex_);
+            cv_.wait(lk, [this]() { return (stopping_ || !queue_.empty()); });
+            if (queue_.empty()) {
+                break;
+            }
+            batch.swap(queue_);
+        }
+
+        // The helper exited: restart it, but not too often to not burn
+        // the CPU if it can't run.
+        if ((fd_ < 0) &&
+            (chrono::steady_clock::now() - last_spawn_ >= chrono::seconds(1))) {
+            spawn();
+        }
+        if (fd_ < 0) {
+            drop(batch.size());
+            continue;
+        }
+
+        string data;
+        for (auto const& record : batch) {
+            data += record;
+        }
+        string error = send(data);
+        if (!error.empty()) {
+            LOG_WARN(run_script_logger, RUN_SCRIPT_HELPER_WRITE_FAILED)
+                .arg(error);
+            closeSocket();
+            drop(batch.size());
+        }
+    }
+}
+
+void
+ScriptHelper::spawn() {
+    last_spawn_ = chrono::steady_clock::now();
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        LOG_ERROR(run_script_logger, RUN_SCRIPT_HELPER_START_FAILED)
+            .arg(name_).arg(strerror(errno));
+        return;
+    }
+    // The sockets must not leak to the other spawned processes: the
+    // helper would not get the end of file when the socket is closed.
+    // The standard input of the helper is a duplicate which does not
+    // inherit this flag.
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    // A timeout allows to give up writing to a stuck helper on shutdown.
+    struct timeval tv;
+    tv.tv_sec = 1;
+    tv.tv_usec = 0;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    try {
+        ProcessSpawn process(io_service_, name_);
+        pid_t pid = process.spawn(true, fds[1]);
+        LOG_INFO(run_script_logger, RUN_SCRIPT_HELPER_STARTED)
+            .arg(name_).arg(pid);
+    } catch (const exception& ex) {
+        LOG_ERROR(run_script_logger, RUN_SCRIPT_HELPER_START_FAILED)
+            .arg(name_).arg(ex.what());
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+    close(fds[1]);
+    fd_ = fds[0];
+}
+
+string
+ScriptHelper::send(const string& data) {
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags = MSG_NOSIGNAL;
+#endif
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t ret = ::send(fd_, data.data() + offset, data.size() - offset,
+                             flags);
+        if (ret < 0) {
+            int error = errno;
+            if (error == EINTR) {
+                continue;
+            }
+            if ((error == EAGAIN) || (error == EWOULDBLOCK)) {
+                // The helper is slow. Keep waiting unless shutting down.
+                lock_guard<mutex> lk(mutex_);
+                if (!stopping_) {
+                    continue;
+                }
+            }
+            return (strerror(error));
+        }
+        offset += ret;
+    }
+    return ("");
+}
+
+void
+ScriptHelper::closeSocket() {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+void
+ScriptHelper::drop(size_t count) {
+    {
+        lock_guard<mutex> lk(mutex_);
+        dropped_ += count;
+    }
+    StatsMgr::instance().addValue(DROPPED_STAT, static_cast<int64_t>(count));
+}
+
+} // namespace run_script
+} // namespace isc
@@ -0,0 +1,160 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef RUN_SCRIPT_HELPER_H
+#define RUN_SCRIPT_HELPER_H
+
+#include <asiolink/io_service.h>
+#include <asiolink/process_spawn.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace isc {
+namespace run_script {
+
+/// @brief Delivers the events to a long-lived helper process.
+///
+/// Spawning the target script for each event is expensive when the
+/// server process is large. In the helper mode the script is started
+/// once, without arguments, and the events are written to its standard
+/// input, which is connected to a unix socket.
+///
+/// Each event is a record made of a line holding the arguments of the
+/// script (the name of the hook point), followed by a line per environment
+/// variable in the NAME=value form, and terminated by an empty line.
+/// The backslash and newline characters in the values are escaped as
+/// "\\" and "\n".
+///
+/// The records are queued by the callouts and written by a dedicated
+/// thread, so the packet processing never waits for the helper. When the
+/// queue is full the events are dropped and counted in the
+/// run-script-dropped-events statistic. When the helper exits, it is
+/// restarted, at most once per second.
+class ScriptHelper : public boost::noncopyable {
+public:
+
+    /// @brief Default maximum number of queued events.
+    static const size_t DEFAULT_QUEUE_SIZE;
+
+    /// @brief Name of the statistic counting the dropped events.
+    static const std::string DROPPED_STAT;
+
+    /// @brief Constructor.
+    ///
+    /// @param name The name of the helper script.
+    /// @param queue_size The maximum number of queued events.
+    ScriptHelper(const std::string& name, size_t queue_size);
+
+    /// @brief Destructor.
+    ///
+    /// Stops the helper.
+    ~ScriptHelper();
+
+    /// @brief Starts the helper process and the writer thread.
+    ///
+    /// It is a no-op when the helper is already started.
+    ///
+    /// @param io_service The IOService handling the SIGCHLD signal.
+    void start(const isc::asiolink::IOServicePtr& io_service);
+
+    /// @brief Writes the queued events and stops the writer thread.
+    ///
+    /// The helper process gets the end of file on its standard input.
+    void stop();
+
+    /// @brief Queues an event.
+    ///
+    /// @param args The arguments for the target script.
+    /// @param vars The environment variables for the target script.
+    /// @return true if the event was queued, false if it was dropped.
+    bool push(const isc::asiolink::ProcessArgs& args,
+              const isc::asiolink::ProcessEnvVars& vars);
+
+    /// @brief Returns the number of dropped events.
+    uint64_t getDropped() const;
+
+    /// @brief Builds the record of an event.
+    ///
+    /// @param args The arguments for the target script.
+    /// @param vars The environment variables for the target script.
+    /// @return The record.
+    static std::string serialize(const isc::asiolink::ProcessArgs& args,
+                                 const isc::asiolink::ProcessEnvVars& vars);
+
+private:
+
+    /// @brief The writer thread function.
+    void run();
+
+    /// @brief Spawns the helper process connected to a new socket.
+    ///
+    /// Failures are logged and leave the socket closed.
+    void spawn();
+
+    /// @brief Writes data to the helper process.
+    ///
+    /// @param data The data.
+    /// @return error description or an empty string on success.
+    std::string send(const std::string& data);
+
+    /// @brief Closes the socket connected to the helper process.
+    void closeSocket();
+
+    /// @brief Counts dropped events.
+    ///
+    /// @param count The number of dropped events.
+    void drop(size_t count);
+
+    /// @brief The name of the helper script.
+    std::string name_;
+
+    /// @brief The maximum number of queued events.
+    size_t queue_size_;
+
+    /// @brief The IOService handling the SIGCHLD signal.
+    isc::asiolink::IOServicePtr io_service_;
+
+    /// @brief The socket connected to the helper process, -1 when closed.
+    int fd_;
+
+    /// @brief The time of the last attempt to spawn the helper process.
+    std::chrono::steady_clock::time_point last_spawn_;
+
+    /// @brief Mutex protecting the members below.
+    mutable std::mutex mutex_;
+
+    /// @brief Condition variable waking up the writer thread.
+    std::condition_variable cv_;
+
+    /// @brief The queued records.
+    std::deque<std::string> queue_;
+
+    /// @brief Flag instructing the writer thread to terminate.
+    bool stopping_;
+
+    /// @brief Flag set when the queue is full, used to log only once.
+    bool full_;
+
+    /// @brief The number of dropped events.
+    uint64_t dropped_;
+
+    /// @brief The writer thread.
+    boost::shared_ptr<std::thread> thread_;
+};
+
+/// @brief The type of shared pointers to script helpers.
+typedef boost::shared_ptr<ScriptHelper> ScriptHelperPtr;
+
+} // namespace run_script
+} // namespace isc
+
+#endif // RUN_SCRIPT_HELPER_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -20,6 +20,8 @@
 #include <hooks/hooks_manager.h>
 
 #include <cstdio>
+#include <ctime>
+#include <sys/stat.h>
 #include <fstream>
 
 #include <gtest/gtest.h>
@@ -782,6 +784,18 @@ TEST(RunScript, extractPkt6) {
     EXPECT_EQ(expected, join(vars));
 }
 
+/// @brief Check that the helper records are built properly.
+TEST(RunScript, helperSerialize) {
+    ProcessArgs args;
+    args.push_back("lease4_renew");
+    ProcessEnvVars vars;
+    vars.push_back("A=1");
+    vars.push_back("B=x\\y\nz");
+    EXPECT_EQ("lease4_renew\nA=1\nB=x\\\\y\\nz\n\n",
+              ScriptHelper::serialize(args, vars));
+    EXPECT_EQ("\n\n", ScriptHelper::serialize(ProcessArgs(), ProcessEnvVars()));
+}
+
 class RunScriptTest : public ::testing::Test {
 public:
 
@@ -1040,4 +1054,53 @@ TEST_F(RunScriptTest, lease6Decline) {
     checkScriptResult();
 }
 
+/// @brief Check that the events are delivered to the helper process.
+TEST_F(RunScriptTest, helper) {
+    // The helper copies its input to the log file when it ends.
+    string script = string(TEST_LOG_FILE) + ".helper.sh";
+    {
+        ofstream fs(script.c_str());
+        fs << "#!/bin/sh\n"
+           << "cat > " << TEST_LOG_FILE << ".tmp\n"
+           << "mv " << TEST_LOG_FILE << ".tmp " << TEST_LOG_FILE << "\n";
+    }
+    ASSERT_EQ(0, chmod(script.c_str(), S_IRWXU));
+
+    ProcessArgs args;
+    args.push_back("lease4_renew");
+    ProcessEnvVars vars;
+    vars.push_back("LEASE4_ADDRESS=192.0.2.1");
+    {
+        ScriptHelper helper(script, 1);
+        helper.start(RunScriptImpl::getIOService());
+        EXPECT_TRUE(helper.push(args, vars));
+        // The queue size is 1 so one of the following events may be dropped.
+        helper.push(args, vars);
+        helper.push(args, vars);
+        EXPECT_GE(2, helper.getDropped());
+        helper.stop();
+
+        size_t expected_count = 3 - helper.getDropped();
+        string expected;
+        for (size_t i = 0; i < expected_count; ++i) {
+            expected += "lease4_renew\nLEASE4_ADDRESS=192.0.2.1\n\n";
+        }
+
+        string content;
+        time_t now(time(NULL));
+        for (;;) {
+            ifstream fs(TEST_LOG_FILE);
+            if (!fs.fail()) {
+                content.assign(istreambuf_iterator<char>(fs),
+                               istreambuf_iterator<char>());
+                break;
+            }
+            ASSERT_LT(time(NULL), now + 3) << "timeout";
+            usleep(100000);
+        }
+        EXPECT_EQ(expected, content);
+    }
+    static_cast<void>(::remove(script.c_str()));
+}
+
 } // end of anonymous namespace
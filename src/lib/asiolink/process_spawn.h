@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -42,10 +42,10 @@ typedef std::vector<std::string> ProcessEnvVars;
 
 /// @brief Utility class for spawning new processes.
 ///
-/// This class is used to spawn new process by Kea. It forks the current
-/// process and then uses the @c execve function to execute the specified
-/// binary with parameters. The @c ProcessSpawn installs the handler for
-/// the SIGCHLD signal, which is executed when the child process ends.
+/// This class is used to spawn new process by Kea. It uses the
+/// @c posix_spawn function to execute the specified binary with
+/// parameters. The @c ProcessSpawn installs the handler for the SIGCHLD
+/// signal, which is executed when the child process ends.
 /// The handler checks the exit code returned by the process and records
 /// it. The exit code can be retrieved by the caller using the
 /// @c ProcessSpawn::getExitStatus method.
@@ -80,18 +80,20 @@ public:
 
     /// @brief Spawn the new process.
     ///
-    /// This method forks the current process and executes the specified
-    /// binary with arguments within the child process.
+    /// This method executes the specified binary with arguments within
+    /// a child process created with @c posix_spawn.
     ///
-    /// The child process will return EXIT_FAILURE if the method was unable
-    /// to start the executable, e.g. as a result of insufficient permissions
-    /// or when the executable does not exist. If the process ends successfully
-    /// the EXIT_SUCCESS is returned.
+    /// If the executable can't be started, e.g. as a result of insufficient
+    /// permissions, either an exception is thrown or the child process
+    /// returns the exit status 127, depending on the system. If the process
+    /// ends successfully the EXIT_SUCCESS is returned.
     ///
     /// @param dismiss The flag which indicated if the process status can be
     /// disregarded.
-    /// @throw ProcessSpawnError if forking a current process failed.
-    pid_t spawn(bool dismiss = false);
+    /// @param input_fd The file descriptor used as the standard input of the
+    /// child process or -1 (the default) to inherit the standard input.
+    /// @throw ProcessSpawnError if spawning the process failed.
+    pid_t spawn(bool dismiss = false, int input_fd = -1);
 
     /// @brief Checks if the process is still running.
     ///
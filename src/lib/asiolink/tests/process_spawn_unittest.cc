@@ -164,6 +164,41 @@ TEST_F(ProcessSpawnTest, spawnWithArgsAndEnvVars) {
     EXPECT_EQ(32, process.getExitStatus(pid));
 }
 
+// This test verifies that the standard input of the external application
+// can be redirected.
+TEST_F(ProcessSpawnTest, spawnWithInput) {
+    vector<string> args;
+    args.push_back("-i");
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(3, write(fds[1], "48\n", 3));
+    close(fds[1]);
+
+    ProcessSpawn process(io_service_, TEST_SCRIPT_SH, args);
+    pid_t pid = 0;
+    ASSERT_NO_THROW(pid = process.spawn(false, fds[0]));
+    close(fds[0]);
+
+    // Set test fail safe.
+    setTestTime(1000);
+
+    // The next handler executed is IOSignal's handler.
+    io_service_->run_one();
+
+    // The first handler executed is the IOSignal's internal timer expire
+    // callback.
+    io_service_->run_one();
+
+    // Polling once to be sure.
+    io_service_->poll();
+
+    ASSERT_EQ(1, processed_signals_.size());
+    ASSERT_EQ(SIGCHLD, processed_signals_[0]);
+
+    EXPECT_EQ(48, process.getExitStatus(pid));
+}
+
 // This test verifies that the single ProcessSpawn object can be used
 // to start two processes and that their status codes can be gathered.
 // It also checks that it is possible to clear the status of the
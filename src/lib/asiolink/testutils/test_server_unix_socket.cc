@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -32,7 +32,8 @@ typedef std::function<void()> SentResponseCallback;
 
 /// @brief Connection to the server over unix domain socket.
 ///
-/// It reads the data over the socket, sends responses and closes a socket.
+/// It reads the data over the socket and sends responses until the client
+/// closes the socket.
 class Connection : public boost::enable_shared_from_this<Connection> {
 public:
 
@@ -75,9 +76,10 @@ public:
     /// This is the handler invoked when the data have been received over the
     /// socket. If custom response has been specified, this response is sent
     /// back to the client. Otherwise, the handler echoes back the request
-    /// and prepends the word "received ". Finally, it calls a custom
+    /// and prepends the word "received ". Then, it calls a custom
     /// callback function (specified in the constructor) to notify that the
-    /// response has been sent over the socket.
+    /// response has been sent over the socket. Finally, it starts reading
+    /// the next request sent over the same connection.
     ///
     /// @param bytes_transferred Number of bytes received.
     void
@@ -102,14 +104,16 @@ public:
         }
 
         /// @todo We're taking simplistic approach and send a response right away
-        /// after receiving data over the socket. Therefore, after responding we
-        /// do not schedule another read. We could extend this logic slightly to
-        /// parse the received data and see when we've got enough data before we
-        /// send a response. However, the current unit tests don't really require
-        /// that.
+        /// after receiving data over the socket. We could extend this logic
+        /// slightly to parse the received data and see when we've got enough
+        /// data before we send a response. However, the current unit tests
+        /// don't really require that.
 
         // Invoke callback function to notify that the response has been sent.
         sent_response_callback_();
+
+        // Receive the next request over this connection.
+        start();
     }
 
 private:
@@ -144,7 +148,7 @@ public:
     /// @param io_service Reference to the IO service.
     ConnectionPool(IOService& io_service)
         : io_service_(io_service), connections_(), next_socket_(),
-          response_num_(0) {
+          response_num_(0), connection_num_(0) {
     }
 
     /// @brief Destructor.
@@ -181,6 +185,7 @@ public:
 
         connections_.insert(conn);
         next_socket_.reset();
+        ++connection_num_;
     }
 
     /// @brief Stops the given connection.
@@ -205,6 +210,11 @@ public:
         return (response_num_);
     }
 
+    /// @brief Returns number of connections accepted so far.
+    size_t getConnectionNum() const {
+        return (connection_num_);
+    }
+
 private:
 
     /// @brief Reference to the IO service.
@@ -220,6 +230,9 @@ private:
 
     /// @brief Holds the number of sent responses.
     size_t response_num_;
+
+    /// @brief Holds the number of accepted connections.
+    size_t connection_num_;
 };
 
 
@@ -326,6 +339,11 @@ TestServerUnixSocket::getResponseNum() const {
     return (connection_pool_->getResponseNum());
 }
 
+size_t
+TestServerUnixSocket::getConnectionNum() const {
+    return (connection_pool_->getConnectionNum());
+}
+
 } // end of namespace isc::asiolink::test
 } // end of namespace isc::asiolink
 } // end of namespace isc
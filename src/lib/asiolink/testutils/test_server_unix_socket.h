@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -35,7 +35,8 @@ class ConnectionPool;
 /// instead of echoing back the request.
 ///
 /// It is possible to make multiple connections to the server side
-/// socket simultaneously.
+/// socket simultaneously. A connection is kept open after the response
+/// so the client may send more requests over it.
 ///
 /// The test should perform IOService::run_one until it finds that
 /// the number of responses sent by the server is greater than
@@ -96,6 +97,9 @@ public:
     /// @brief Return number of responses sent so far to the clients.
     size_t getResponseNum() const;
 
+    /// @brief Return number of connections accepted so far.
+    size_t getConnectionNum() const;
+
     /// @brief Indicates if the server has been stopped.
     bool isStopped() {
         return (stopped_);
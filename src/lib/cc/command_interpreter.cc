@@ -28,6 +28,7 @@ const char *CONTROL_TEXT = "text";
 const char *CONTROL_ARGUMENTS = "arguments";
 const char *CONTROL_SERVICE = "service";
 const char *CONTROL_REMOTE_ADDRESS = "remote-address";
+const char *CONTROL_KEEP_ALIVE = "keep-alive";
 
 // Full version, with status, text and arguments
 ConstElementPtr
@@ -189,7 +190,8 @@ parseCommand(ConstElementPtr& arg, ConstElementPtr command) {
         if ((param.first != CONTROL_COMMAND) &&
             (param.first != CONTROL_ARGUMENTS) &&
             (param.first != CONTROL_SERVICE) &&
-            (param.first != CONTROL_REMOTE_ADDRESS)) {
+            (param.first != CONTROL_REMOTE_ADDRESS) &&
+            (param.first != CONTROL_KEEP_ALIVE)) {
             isc_throw(CtrlChannelError,
                       "invalid command: unsupported parameter '" << param.first << "'");
         }
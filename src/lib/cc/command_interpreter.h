@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2009-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -38,6 +38,9 @@ extern const char *CONTROL_SERVICE;
 /// @brief String used for remote address ("remote-address")
 extern const char *CONTROL_REMOTE_ADDRESS;
 
+/// @brief String used to keep the control connection open ("keep-alive")
+extern const char *CONTROL_KEEP_ALIVE;
+
 /// @brief Status code indicating a successful operation
 const int CONTROL_RESULT_SUCCESS = 0;
 
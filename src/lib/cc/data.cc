@@ -827,11 +827,12 @@ DoubleElement::toJSON(std::ostream& ss) const {
     // for whole number values.  When reparsed this will create
     // IntElements not DoubleElements.  Rather than used a fixed
     // precision, we'll just tack on an ".0" when the decimal point
-    // is missing.
+    // is missing. Values written with an exponent are already parsed
+    // as doubles.
     ostringstream val_ss;
     val_ss << doubleValue();
     ss << val_ss.str();
-    if (val_ss.str().find_first_of('.') == string::npos) {
+    if (val_ss.str().find_first_of(".eE") == string::npos) {
         ss << ".0";
     }
 }
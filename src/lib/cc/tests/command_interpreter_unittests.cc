@@ -235,6 +235,12 @@ TEST(CommandInterpreterTest, parseCommandWithArgs) {
                                                  "  \"arguments\": { \"arg1\": \"value1\" } }"))
     );
 
+    // The "keep-alive" parameter should be allowed.
+    EXPECT_NO_THROW(parseCommandWithArgs(arg, el("{ \"command\": \"my_command\", "
+                                                 "  \"keep-alive\": true, "
+                                                 "  \"arguments\": { \"arg1\": \"value1\" } }"))
+    );
+
 }
 
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -27,7 +27,9 @@ public:
     /// @brief Constructor.
     ///
     /// @param io_service Reference to the IO service.
-    explicit ClientConnectionImpl(IOService& io_service);
+    /// @param keep_alive Boolean flag indicating if the connection is kept
+    /// open after a successful transaction.
+    ClientConnectionImpl(IOService& io_service, const bool keep_alive);
 
     /// @brief This method schedules timer or reschedules existing timer.
     ///
@@ -55,6 +57,13 @@ public:
     /// @brief Closes the socket.
     void stop();
 
+    /// @brief Checks if the connection was kept open by the last transaction.
+    ///
+    /// @return true if the connection is open, false otherwise.
+    bool isOpen() const {
+        return (open_);
+    }
+
     /// @brief Starts asynchronous send.
     ///
     /// This method may be called multiple times internally when the command
@@ -78,9 +87,12 @@ public:
     /// @param handler User supplied callback.
     void doReceive(ClientConnection::Handler handler);
 
-    /// @brief Terminates the connection and invokes a user callback indicating
+    /// @brief Terminates the transaction and invokes a user callback indicating
     /// an error.
     ///
+    /// The connection is closed unless it is kept alive and the transaction
+    /// was successful.
+    ///
     /// @param ec Error code.
     /// @param handler User callback.
     void terminate(const boost::system::error_code& ec,
@@ -113,11 +125,22 @@ private:
 
     /// @brief Timeout value used for the timer.
     long timeout_;
+
+    /// @brief Boolean flag indicating if the connection is kept open after
+    /// a successful transaction.
+    bool keep_alive_;
+
+    /// @brief Boolean flag indicating if the connection is open.
+    bool open_;
+
+    /// @brief Path to the socket the connection is open to.
+    std::string socket_path_;
 };
 
-ClientConnectionImpl::ClientConnectionImpl(IOService& io_service)
+ClientConnectionImpl::ClientConnectionImpl(IOService& io_service,
+                                           const bool keep_alive)
     : socket_(io_service), feed_(), current_command_(), timer_(io_service),
-      timeout_(0) {
+      timeout_(0), keep_alive_(keep_alive), open_(false), socket_path_() {
 }
 
 void
@@ -142,6 +165,21 @@ ClientConnectionImpl::start(const ClientConnection::SocketPath& socket_path,
     // the entire time.
     current_command_.assign(command.control_command_);
 
+    // The response to the previous command must not be reused.
+    feed_.reset();
+
+    // Send the command over the connection kept open to the same socket.
+    if (open_) {
+        if (socket_path_ == socket_path.socket_path_) {
+            doSend(current_command_.c_str(), current_command_.length(),
+                   handler);
+            return;
+        }
+        socket_.close();
+        open_ = false;
+    }
+    socket_path_ = socket_path.socket_path_;
+
     // Pass self to lambda to make sure that the instance of this class
     // lives as long as the lambda is held for async connect.
     auto self(shared_from_this());
@@ -155,6 +193,7 @@ ClientConnectionImpl::start(const ClientConnection::SocketPath& socket_path,
             terminate(ec, handler);
 
         } else {
+            open_ = true;
             // Connection successful. Transmit the command to the remote
             // endpoint asynchronously.
             doSend(current_command_.c_str(), current_command_.length(),
@@ -249,7 +288,10 @@ ClientConnectionImpl::terminate(const boost::system::error_code& ec,
                                 ClientConnection::Handler handler) {
     try {
         timer_.cancel();
-        socket_.close();
+        if (ec || !keep_alive_) {
+            open_ = false;
+            socket_.close();
+        }
         current_command_.clear();
         handler(ec, feed_);
 
@@ -268,8 +310,9 @@ ClientConnectionImpl::timeoutCallback(ClientConnection::Handler handler) {
     terminate(boost::asio::error::timed_out, handler);
 }
 
-ClientConnection::ClientConnection(asiolink::IOService& io_service)
-    : impl_(new ClientConnectionImpl(io_service)) {
+ClientConnection::ClientConnection(asiolink::IOService& io_service,
+                                   const bool keep_alive)
+    : impl_(new ClientConnectionImpl(io_service, keep_alive)) {
 }
 
 void
@@ -280,6 +323,11 @@ ClientConnection::start(const ClientConnection::SocketPath& socket_path,
     impl_->start(socket_path, command, handler, timeout);
 }
 
+bool
+ClientConnection::isOpen() const {
+    return (impl_->isOpen());
+}
+
 
 } // end of namespace config
 } // end of namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -67,6 +67,12 @@ class ClientConnectionImpl;
 /// }
 /// @endcode
 ///
+/// A connection created with the keep alive flag is not closed after a
+/// successful transaction, so the next @ref ClientConnection::start with
+/// the same socket path sends the command over the open connection. The
+/// server closes the connection after the response unless the command
+/// contains the "keep-alive" parameter set to true.
+///
 class ClientConnection {
 public:
 
@@ -108,7 +114,10 @@ public:
     /// @brief Constructor.
     ///
     /// @param io_service Reference to the IO service.
-    explicit ClientConnection(asiolink::IOService& io_service);
+    /// @param keep_alive Boolean flag indicating if the connection is kept
+    /// open after a successful transaction.
+    explicit ClientConnection(asiolink::IOService& io_service,
+                              const bool keep_alive = false);
 
     /// @brief Starts asynchronous transaction with a remote endpoint.
     ///
@@ -143,6 +152,14 @@ public:
     void start(const SocketPath& socket_path, const ControlCommand& command,
                Handler handler, const Timeout& timeout = Timeout(5000));
 
+    /// @brief Checks if the connection was kept open by the last transaction.
+    ///
+    /// The server may have closed its end of the connection meanwhile, in
+    /// which case the next transaction fails.
+    ///
+    /// @return true if the connection is open, false otherwise.
+    bool isOpen() const;
+
 private:
 
     /// @brief Pointer to the implementation.
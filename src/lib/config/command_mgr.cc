@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -68,8 +68,9 @@ public:
                ConnectionPool& connection_pool,
                const long timeout)
         : socket_(socket), timeout_timer_(*io_service), timeout_(timeout),
-          buf_(), response_(), connection_pool_(connection_pool), feed_(),
-          response_in_progress_(false), watch_socket_(new util::WatchSocket()) {
+          buf_(), response_(), connection_pool_(connection_pool),
+          feed_(new JSONFeed()), response_in_progress_(false),
+          keep_alive_(false), watch_socket_(new util::WatchSocket()) {
 
         LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_CONNECTION_OPENED)
             .arg(socket_->getNative());
@@ -80,7 +81,7 @@ public:
         isc::dhcp::IfaceMgr::instance().addExternalSocket(socket_->getNative(), 0);
 
         // Initialize state model for receiving and preparsing commands.
-        feed_.initModel();
+        feed_->initModel();
 
         // Start timer for detecting timeouts.
         scheduleTimer();
@@ -186,7 +187,9 @@ public:
     ///
     /// If there are still data to be sent, another asynchronous send is
     /// scheduled. When the entire command is sent, the connection is shutdown
-    /// and closed.
+    /// and closed, unless the client asked to keep it open with the
+    /// "keep-alive" parameter of the command. In this case the next command
+    /// is received over the connection.
     ///
     /// @param ec Error code.
     /// @param bytes_transferred Number of bytes sent.
@@ -196,7 +199,8 @@ public:
     /// @brief Handler invoked when timeout has occurred.
     ///
     /// Asynchronously sends a response to the client indicating that the
-    /// timeout has occurred.
+    /// timeout has occurred. A connection kept open which is idle, i.e.
+    /// which didn't receive a part of a new command, is simply closed.
     void timeoutHandler();
 
 private:
@@ -221,12 +225,16 @@ private:
 
     /// @brief State model used to receive data over the connection and detect
     /// when the command ends.
-    JSONFeed feed_;
+    JSONFeedPtr feed_;
 
     /// @brief Boolean flag indicating if the request to stop connection is a
     /// result of server reconfiguration.
     bool response_in_progress_;
 
+    /// @brief Boolean flag indicating if the connection is kept open after
+    /// the response to the last command is sent.
+    bool keep_alive_;
+
     /// @brief Pointer to watch socket instance used to signal that the socket
     /// is ready for read or write.
     util::WatchSocketPtr watch_socket_;
@@ -293,11 +301,11 @@ Connection::receiveHandler(const boost::system::error_code& ec,
     if (ec) {
         if (ec.value() == boost::asio::error::eof) {
             std::stringstream os;
-            if (feed_.getProcessedText().empty()) {
+            if (feed_->getProcessedText().empty()) {
                os << "no input data to discard";
             } else {
                os << "discarding partial command of "
-                  << feed_.getProcessedText().size() << " bytes";
+                  << feed_->getProcessedText().size() << " bytes";
             }
 
             // Foreign host has closed the connection. We should remove it from the
@@ -330,19 +338,29 @@ Connection::receiveHandler(const boost::system::error_code& ec,
     try {
         // Received some data over the socket. Append them to the JSON feed
         // to see if we have reached the end of command.
-        feed_.postBuffer(&buf_[0], bytes_transferred);
-        feed_.poll();
+        feed_->postBuffer(&buf_[0], bytes_transferred);
+        feed_->poll();
         // If we haven't yet received the full command, continue receiving.
-        if (feed_.needData()) {
+        if (feed_->needData()) {
             doReceive();
             return;
         }
 
         // Received entire command. Parse the command into JSON.
-        if (feed_.feedOk()) {
-            cmd = feed_.toElement();
+        if (feed_->feedOk()) {
+            cmd = feed_->toElement();
             response_in_progress_ = true;
 
+            // The client may ask to keep the connection open to send
+            // the next commands over it.
+            ConstElementPtr keep_alive;
+            if (cmd->getType() == Element::map) {
+                keep_alive = cmd->get(CONTROL_KEEP_ALIVE);
+            }
+            keep_alive_ = (keep_alive &&
+                           (keep_alive->getType() == Element::boolean) &&
+                           keep_alive->boolValue());
+
             // Cancel the timer to make sure that long lasting command
             // processing doesn't cause the timeout.
             timeout_timer_.cancel();
@@ -356,7 +374,7 @@ Connection::receiveHandler(const boost::system::error_code& ec,
             // Failed to parse command as JSON or process the received command.
             // This exception will be caught below and the error response will
             // be sent.
-            isc_throw(BadValue, feed_.getErrorMessage());
+            isc_throw(BadValue, feed_->getErrorMessage());
         }
 
     } catch (const Exception& ex) {
@@ -429,6 +447,15 @@ Connection::sendHandler(const boost::system::error_code& ec,
             return;
         }
 
+        // Receive the next command if the client asked to keep the
+        // connection open.
+        if (keep_alive_) {
+            feed_.reset(new JSONFeed());
+            feed_->initModel();
+            doReceive();
+            return;
+        }
+
         // Gracefully shutdown the connection and close the socket if
         // we have sent the whole response.
         terminate();
@@ -440,6 +467,20 @@ Connection::sendHandler(const boost::system::error_code& ec,
 
 void
 Connection::timeoutHandler() {
+    // An idle connection kept open is closed without a response: the
+    // receive handler stops the connection when the receive is cancelled.
+    if (keep_alive_ && feed_->getProcessedText().empty()) {
+        try {
+            socket_->cancel();
+
+        } catch (const std::exception& ex) {
+            LOG_ERROR(command_logger, COMMAND_SOCKET_CONNECTION_CANCEL_FAIL)
+                .arg(socket_->getNative())
+                .arg(ex.what());
+        }
+        return;
+    }
+
     LOG_INFO(command_logger, COMMAND_SOCKET_CONNECTION_TIMEOUT)
         .arg(socket_->getNative());
 
@@ -454,9 +495,9 @@ Connection::timeoutHandler() {
 
     std::stringstream os;
     os << "Connection over control channel timed out";
-    if (!feed_.getProcessedText().empty()) {
+    if (!feed_->getProcessedText().empty()) {
         os << ", discarded partial command of "
-           << feed_.getProcessedText().size() << " bytes";
+           << feed_->getProcessedText().size() << " bytes";
     }
 
     ConstElementPtr rsp = createAnswer(CONTROL_RESULT_ERROR, os.str());
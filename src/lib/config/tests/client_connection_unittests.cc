@@ -1,4 +1,4 @@
-// Copyright (C) 2017-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2017-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -120,6 +120,46 @@ TEST_F(ClientConnectionTest, success) {
     }
 }
 
+// Tests that a connection kept alive sends the next command over the
+// same connection.
+TEST_F(ClientConnectionTest, keepAlive) {
+    // Start timer protecting against test timeouts.
+    test_socket_->startTimer(TEST_TIMEOUT);
+
+    // Start the server.
+    test_socket_->bindServerSocket();
+    test_socket_->generateCustomResponse(2048);
+
+    // Create some valid command.
+    std::string command = "{ \"command\": \"list-commands\", \"keep-alive\": true }";
+
+    ClientConnection conn(io_service_, true);
+    EXPECT_FALSE(conn.isOpen());
+
+    for (size_t i = 0; i < 2; ++i) {
+        bool handler_invoked = false;
+        conn.start(ClientConnection::SocketPath(unixSocketFilePath()),
+                   ClientConnection::ControlCommand(command),
+            [&handler_invoked](const boost::system::error_code& ec,
+                               const ConstJSONFeedPtr& feed) {
+            handler_invoked = true;
+            ASSERT_FALSE(ec);
+            ASSERT_TRUE(feed);
+            EXPECT_TRUE(feed->feedOk()) << feed->getErrorMessage();
+        });
+        while (!handler_invoked && !test_socket_->isStopped()) {
+            io_service_.run_one();
+        }
+
+        // The connection is still open.
+        EXPECT_TRUE(conn.isOpen());
+    }
+
+    // Both commands were sent over the same connection.
+    EXPECT_EQ(2, test_socket_->getResponseNum());
+    EXPECT_EQ(1, test_socket_->getConnectionNum());
+}
+
 // This test checks that a timeout is signalled when the communication
 // takes too long.
 TEST_F(ClientConnectionTest, timeout) {
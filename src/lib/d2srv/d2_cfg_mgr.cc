@@ -84,6 +84,29 @@ D2CfgContext::toElement() const {
     const dhcp_ddns::NameChangeFormat& ncr_format = d2_params_->getNcrFormat();
     d2->set("ncr-format",
             Element::create(dhcp_ddns::ncrFormatToString(ncr_format)));
+    // Set max-transactions
+    size_t max_transactions = d2_params_->getMaxTransactions();
+    d2->set("max-transactions",
+            Element::create(static_cast<int64_t>(max_transactions)));
+    // Set thread-pool-size
+    size_t thread_pool_size = d2_params_->getThreadPoolSize();
+    d2->set("thread-pool-size",
+            Element::create(static_cast<int64_t>(thread_pool_size)));
+    // Set update-batch-size
+    size_t update_batch_size = d2_params_->getUpdateBatchSize();
+    d2->set("update-batch-size",
+            Element::create(static_cast<int64_t>(update_batch_size)));
+    // Set update-batch-delay
+    size_t update_batch_delay = d2_params_->getUpdateBatchDelay();
+    d2->set("update-batch-delay",
+            Element::create(static_cast<int64_t>(update_batch_delay)));
+    // Set dns-protocol
+    d2->set("dns-protocol",
+            Element::create(std::string(d2_params_->getDnsProtocol() ==
+                                        DNSClient::TCP ? "TCP" : "UDP")));
+    // Set dns-persistent-connections
+    d2->set("dns-persistent-connections",
+            Element::create(d2_params_->getDnsPersistentConnections()));
     // Set forward-ddns
     ElementPtr forward_ddns = Element::createMap();
     forward_ddns->set("ddns-domains", forward_mgr_->toElement());
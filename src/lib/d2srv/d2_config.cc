@@ -27,16 +27,30 @@ namespace d2 {
 
 // *********************** D2Params  *************************
 
+const size_t D2Params::MAX_THREAD_POOL_SIZE;
+
 D2Params::D2Params(const isc::asiolink::IOAddress& ip_address,
                    const size_t port,
                    const size_t dns_server_timeout,
                    const dhcp_ddns::NameChangeProtocol& ncr_protocol,
-                   const dhcp_ddns::NameChangeFormat& ncr_format)
+                   const dhcp_ddns::NameChangeFormat& ncr_format,
+                   const size_t max_transactions,
+                   const size_t thread_pool_size,
+                   const size_t update_batch_size,
+                   const size_t update_batch_delay,
+                   const DNSClient::Protocol dns_protocol,
+                   const bool dns_persistent_connections)
     : ip_address_(ip_address),
     port_(port),
     dns_server_timeout_(dns_server_timeout),
     ncr_protocol_(ncr_protocol),
-    ncr_format_(ncr_format) {
+    ncr_format_(ncr_format),
+    max_transactions_(max_transactions),
+    thread_pool_size_(thread_pool_size),
+    update_batch_size_(update_batch_size),
+    update_batch_delay_(update_batch_delay),
+    dns_protocol_(dns_protocol),
+    dns_persistent_connections_(dns_persistent_connections) {
     validateContents();
 }
 
@@ -44,7 +58,10 @@ D2Params::D2Params()
     : ip_address_(isc::asiolink::IOAddress("127.0.0.1")),
      port_(53001), dns_server_timeout_(500),
      ncr_protocol_(dhcp_ddns::NCR_UDP),
-     ncr_format_(dhcp_ddns::FMT_JSON) {
+     ncr_format_(dhcp_ddns::FMT_JSON),
+     max_transactions_(32), thread_pool_size_(0),
+     update_batch_size_(1), update_batch_delay_(0),
+     dns_protocol_(DNSClient::UDP), dns_persistent_connections_(false) {
     validateContents();
 }
 
@@ -66,7 +83,8 @@ D2Params::validateContents() {
                   "D2Params: DNS server timeout must be larger than 0");
     }
 
-    if (ncr_format_ != dhcp_ddns::FMT_JSON) {
+    if ((ncr_format_ != dhcp_ddns::FMT_JSON) &&
+        (ncr_format_ != dhcp_ddns::FMT_BINARY)) {
         isc_throw(D2CfgError, "D2Params: NCR Format:"
                   << dhcp_ddns::ncrFormatToString(ncr_format_)
                   << " is not yet supported");
@@ -77,6 +95,22 @@ D2Params::validateContents() {
                   << dhcp_ddns::ncrProtocolToString(ncr_protocol_)
                   << " is not yet supported");
     }
+
+    if (max_transactions_ < 1) {
+        isc_throw(D2CfgError,
+                  "D2Params: max transactions must be larger than 0");
+    }
+
+    if (thread_pool_size_ > MAX_THREAD_POOL_SIZE) {
+        isc_throw(D2CfgError,
+                  "D2Params: thread pool size must not be larger than "
+                  << MAX_THREAD_POOL_SIZE);
+    }
+
+    if (update_batch_size_ < 1) {
+        isc_throw(D2CfgError,
+                  "D2Params: update batch size must be larger than 0");
+    }
 }
 
 std::string
@@ -93,7 +127,14 @@ D2Params::operator == (const D2Params& other) const {
             (port_ == other.port_) &&
             (dns_server_timeout_ == other.dns_server_timeout_) &&
             (ncr_protocol_ == other.ncr_protocol_) &&
-            (ncr_format_ == other.ncr_format_));
+            (ncr_format_ == other.ncr_format_) &&
+            (max_transactions_ == other.max_transactions_) &&
+            (thread_pool_size_ == other.thread_pool_size_) &&
+            (update_batch_size_ == other.update_batch_size_) &&
+            (update_batch_delay_ == other.update_batch_delay_) &&
+            (dns_protocol_ == other.dns_protocol_) &&
+            (dns_persistent_connections_ ==
+             other.dns_persistent_connections_));
 }
 
 bool
@@ -111,7 +152,15 @@ D2Params::toText() const {
            << ", ncr-protocol: "
            << dhcp_ddns::ncrProtocolToString(ncr_protocol_)
            << ", ncr-format: " << ncr_format_
-           << dhcp_ddns::ncrFormatToString(ncr_format_);
+           << dhcp_ddns::ncrFormatToString(ncr_format_)
+           << ", max-transactions: " << max_transactions_
+           << ", thread-pool-size: " << thread_pool_size_
+           << ", update-batch-size: " << update_batch_size_
+           << ", update-batch-delay: " << update_batch_delay_
+           << ", dns-protocol: "
+           << (dns_protocol_ == DNSClient::TCP ? "TCP" : "UDP")
+           << ", dns-persistent-connections: "
+           << (dns_persistent_connections_ ? "true" : "false");
 
     return (stream.str());
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,7 @@
 #include <cc/cfg_to_element.h>
 #include <cc/user_context.h>
 #include <d2srv/d2_tsig_key.h>
+#include <d2srv/dns_client.h>
 #include <dhcpsrv/parsers/dhcp_parsers.h>
 #include <exceptions/exceptions.h>
 #include <process/d_cfg_mgr.h>
@@ -142,6 +143,9 @@ public:
 /// @brief Acts as a storage vault for D2 global scalar parameters
 class D2Params {
 public:
+    /// @brief Maximum number of threads carrying out update transactions.
+    static const size_t MAX_THREAD_POOL_SIZE = 256;
+
     /// @brief Constructor
     ///
     /// @param ip_address IP address at which D2 should listen for NCRs
@@ -150,6 +154,17 @@ public:
     /// wait for a response to a single DNS update request.
     /// @param ncr_protocol socket protocol D2 should use to receive NCRS
     /// @param ncr_format packet format of the inbound NCRs
+    /// @param max_transactions maximum number of concurrent update
+    /// transactions
+    /// @param thread_pool_size number of threads carrying out update
+    /// transactions, 0 means transactions are run by the main thread
+    /// @param update_batch_size maximum number of updates for the same
+    /// zone and server combined in a single DNS update, 1 disables batching
+    /// @param update_batch_delay maximum time in milliseconds an update
+    /// waits for others to be combined with
+    /// @param dns_protocol transport protocol used to send DNS updates
+    /// @param dns_persistent_connections if true DNS updates are sent over
+    /// persistent connections to the DNS servers
     ///
     /// @throw D2CfgError if:
     /// -# ip_address is 0.0.0.0 or ::
@@ -157,11 +172,20 @@ public:
     /// -# dns_server_timeout is < 1
     /// -# ncr_protocol is invalid, currently only NCR_UDP is supported
     /// -# ncr_format is invalid, currently only FMT_JSON is supported
+    /// -# max_transactions is < 1
+    /// -# thread_pool_size is > MAX_THREAD_POOL_SIZE
+    /// -# update_batch_size is < 1
     D2Params(const isc::asiolink::IOAddress& ip_address,
                    const size_t port,
                    const size_t dns_server_timeout,
                    const dhcp_ddns::NameChangeProtocol& ncr_protocol,
-                   const dhcp_ddns::NameChangeFormat& ncr_format);
+                   const dhcp_ddns::NameChangeFormat& ncr_format,
+                   const size_t max_transactions = 32,
+                   const size_t thread_pool_size = 0,
+                   const size_t update_batch_size = 1,
+                   const size_t update_batch_delay = 0,
+                   const DNSClient::Protocol dns_protocol = DNSClient::UDP,
+                   const bool dns_persistent_connections = false);
 
     /// @brief Default constructor
     /// The default constructor creates an instance that has updates disabled.
@@ -195,6 +219,43 @@ public:
         return(ncr_format_);
     }
 
+    /// @brief Return the maximum number of concurrent update transactions.
+    size_t getMaxTransactions() const {
+        return(max_transactions_);
+    }
+
+    /// @brief Return the number of threads carrying out update transactions.
+    ///
+    /// A value of 0 means that transactions are run by the main thread.
+    size_t getThreadPoolSize() const {
+        return(thread_pool_size_);
+    }
+
+    /// @brief Return the maximum number of updates combined in a single
+    /// DNS update.
+    ///
+    /// A value of 1 means that updates are not combined.
+    size_t getUpdateBatchSize() const {
+        return(update_batch_size_);
+    }
+
+    /// @brief Return the maximum time in milliseconds an update waits for
+    /// others to be combined with.
+    size_t getUpdateBatchDelay() const {
+        return(update_batch_delay_);
+    }
+
+    /// @brief Return the transport protocol used to send DNS updates.
+    DNSClient::Protocol getDnsProtocol() const {
+        return(dns_protocol_);
+    }
+
+    /// @brief Return true if DNS updates are sent over persistent
+    /// connections to the DNS servers.
+    bool getDnsPersistentConnections() const {
+        return(dns_persistent_connections_);
+    }
+
     /// @brief Return summary of the configuration used by D2.
     ///
     /// The returned summary of the configuration is meant to be appended to
@@ -223,6 +284,8 @@ protected:
     /// -# dns_server_timeout is 0
     /// -# ncr_protocol is UDP
     /// -# ncr_format is JSON
+    /// -# max_transactions is not 0
+    /// -# update_batch_size is not 0
     ///
     /// @throw D2CfgError if contents are invalid
     virtual void validateContents();
@@ -244,6 +307,24 @@ private:
     /// @brief Format of the inbound requests (NCRs).
     /// Currently only JSON format is supported.
     dhcp_ddns::NameChangeFormat ncr_format_;
+
+    /// @brief Maximum number of concurrent update transactions.
+    size_t max_transactions_;
+
+    /// @brief Number of threads carrying out update transactions.
+    size_t thread_pool_size_;
+
+    /// @brief Maximum number of updates combined in a single DNS update.
+    size_t update_batch_size_;
+
+    /// @brief Maximum time in milliseconds an update waits to be combined.
+    size_t update_batch_delay_;
+
+    /// @brief Transport protocol used to send DNS updates.
+    DNSClient::Protocol dns_protocol_;
+
+    /// @brief True if DNS updates are sent over persistent connections.
+    bool dns_persistent_connections_;
 };
 
 /// @brief Dumps the contents of a D2Params as text to an output stream
@@ -84,7 +84,13 @@ const SimpleDefaults D2SimpleParser::D2_GLOBAL_DEFAULTS = {
     { "port",               Element::integer, "53001" },
     { "dns-server-timeout", Element::integer, "500" }, // in milliseconds
     { "ncr-protocol",       Element::string, "UDP" },
-    { "ncr-format",         Element::string, "JSON" }
+    { "ncr-format",         Element::string, "JSON" },
+    { "max-transactions",   Element::integer, "32" },
+    { "thread-pool-size",   Element::integer, "0" },
+    { "update-batch-size",  Element::integer, "1" },
+    { "update-batch-delay", Element::integer, "0" }, // in milliseconds
+    { "dns-protocol",       Element::string, "UDP" },
+    { "dns-persistent-connections", Element::boolean, "false" }
 };
 
 /// Supplies defaults for ddns-domains list elements (i.e. DdnsDomains)
@@ -235,6 +241,12 @@ void D2SimpleParser::parse(const D2CfgContextPtr& ctx,
     uint32_t dns_server_timeout = 0;
     dhcp_ddns::NameChangeProtocol ncr_protocol = dhcp_ddns::NCR_UDP;
     dhcp_ddns::NameChangeFormat ncr_format = dhcp_ddns::FMT_JSON;
+    uint32_t max_transactions = 0;
+    uint32_t thread_pool_size = 0;
+    uint32_t update_batch_size = 0;
+    uint32_t update_batch_delay = 0;
+    DNSClient::Protocol dns_protocol = DNSClient::UDP;
+    bool dns_persistent_connections = false;
 
     ip_address = SimpleParser::getAddress(config, "ip-address");
 
@@ -258,13 +270,51 @@ void D2SimpleParser::parse(const D2CfgContextPtr& ctx,
     }
 
     ncr_format = getFormat(config, "ncr-format");
-    if (ncr_format != dhcp_ddns::FMT_JSON) {
+    if ((ncr_format != dhcp_ddns::FMT_JSON) &&
+        (ncr_format != dhcp_ddns::FMT_BINARY)) {
         isc_throw(D2CfgError, "NCR Format:"
                   << dhcp_ddns::ncrFormatToString(ncr_format)
                   << " is not yet supported"
                   << " (" << config->get("ncr-format")->getPosition() << ")");
     }
 
+    max_transactions = SimpleParser::getUint32(config, "max-transactions");
+    if (max_transactions == 0) {
+        isc_throw(D2CfgError, "max-transactions must be greater than zero"
+                  << " (" << config->get("max-transactions")->getPosition()
+                  << ")");
+    }
+
+    thread_pool_size = SimpleParser::getUint32(config, "thread-pool-size");
+    if (thread_pool_size > D2Params::MAX_THREAD_POOL_SIZE) {
+        isc_throw(D2CfgError, "thread-pool-size must not be larger than "
+                  << D2Params::MAX_THREAD_POOL_SIZE
+                  << " (" << config->get("thread-pool-size")->getPosition()
+                  << ")");
+    }
+
+    update_batch_size = SimpleParser::getUint32(config, "update-batch-size");
+    if (update_batch_size == 0) {
+        isc_throw(D2CfgError, "update-batch-size must be greater than zero"
+                  << " (" << config->get("update-batch-size")->getPosition()
+                  << ")");
+    }
+
+    update_batch_delay = SimpleParser::getUint32(config, "update-batch-delay");
+
+    std::string dns_protocol_str = SimpleParser::getString(config,
+                                                           "dns-protocol");
+    if (dns_protocol_str == "TCP") {
+        dns_protocol = DNSClient::TCP;
+    } else if (dns_protocol_str != "UDP") {
+        isc_throw(D2CfgError, "dns-protocol : " << dns_protocol_str
+                  << " is not supported, expected UDP or TCP ("
+                  << config->get("dns-protocol")->getPosition() << ")");
+    }
+
+    dns_persistent_connections =
+        SimpleParser::getBoolean(config, "dns-persistent-connections");
+
     ConstElementPtr user = config->get("user-context");
     if (user) {
         ctx->setContext(user);
@@ -292,7 +342,11 @@ void D2SimpleParser::parse(const D2CfgContextPtr& ctx,
     // Attempt to create the new client config. This ought to fly as
     // we already validated everything.
     D2ParamsPtr params(new D2Params(ip_address, port, dns_server_timeout,
-                                    ncr_protocol, ncr_format));
+                                    ncr_protocol, ncr_format,
+                                    max_transactions, thread_pool_size,
+                                    update_batch_size, update_batch_delay,
+                                    dns_protocol,
+                                    dns_persistent_connections));
 
     ctx->getD2Params() = params;
 
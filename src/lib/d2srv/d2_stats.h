@@ -1,4 +1,4 @@
-// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2021-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,6 +21,10 @@ public:
     /// - ncr-received
     /// - ncr-invalid
     /// - ncr-error
+    /// - ncr-queue-wait-time
+    /// - ncr-queue-wait-count
+    /// - ncr-transaction-time
+    /// - ncr-transaction-count
     static const std::list<std::string> ncr;
 
     /// @brief Global DNS update statistics names.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,8 @@
 #include <d2srv/dns_client.h>
 #include <dns/messagerenderer.h>
 #include <stats/stats_mgr.h>
+
+#include <chrono>
 #include <limits>
 
 namespace isc {
@@ -66,6 +68,18 @@ public:
     /// @brief TSIG key name for stats.
     std::string tsig_key_name_;
 
+    /// @brief Pool of persistent connections (may be null).
+    DNSConnectionPoolPtr pool_;
+
+    /// @brief The exchange in progress over the pool (if any).
+    DNSExchangePtr exchange_;
+
+    /// @brief Address of the server of the exchange in progress for stats.
+    std::string server_;
+
+    /// @brief Time the update in progress was sent.
+    std::chrono::steady_clock::time_point start_time_;
+
     /// @brief Constructor.
     ///
     /// @param response_placeholder Message object pointer which will be updated
@@ -75,9 +89,11 @@ public:
     /// if an error occurs. NULL value disables callback invocation.
     /// @param proto caller's preference regarding Transport layer protocol to
     /// be used by DNS Client to communicate with a server.
+    /// @param pool Pool of persistent connections used to send the updates.
     DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
                   DNSClient::Callback* callback,
-                  const DNSClient::Protocol proto);
+                  const DNSClient::Protocol proto,
+                  const DNSConnectionPoolPtr& pool);
 
     /// @brief Destructor.
     virtual ~DNSClientImpl();
@@ -88,6 +104,19 @@ public:
     /// D2UpdateMessage type, representing a response from the server is set.
     virtual void operator()(asiodns::IOFetch::Result result);
 
+    /// @brief Handles the completion of an exchange over the pool.
+    ///
+    /// @param result The result of the exchange.
+    /// @param response The response, if any.
+    void exchangeHandler(DNSExchange::Result result,
+                         const util::OutputBufferPtr& response);
+
+    /// @brief Parses the response held in the input buffer, updates the
+    /// statistics and invokes the external callback.
+    ///
+    /// @param status The status of the exchange.
+    void processResponse(DNSClient::Status status);
+
     /// @brief Starts asynchronous DNS Update using TSIG.
     ///
     /// @param io_service IO service to be used to run the message exchange.
@@ -100,7 +129,7 @@ public:
     /// @param tsig_key A pointer to an @c D2TsigKeyPtr object that will
     /// (if not null) be used to sign the DNS Update message and verify the
     /// response.
-    void doUpdate(asiolink::IOService& io_service,
+    void doUpdate(const asiolink::IOServicePtr& io_service,
                   const asiolink::IOAddress& ns_addr,
                   const uint16_t ns_port,
                   D2UpdateMessage& update,
@@ -123,9 +152,11 @@ public:
 
 DNSClientImpl::DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
                              DNSClient::Callback* callback,
-                             const DNSClient::Protocol proto)
+                             const DNSClient::Protocol proto,
+                             const DNSConnectionPoolPtr& pool)
     : in_buf_(new OutputBuffer(DEFAULT_BUFFER_SIZE)),
-      response_(response_placeholder), callback_(callback), proto_(proto) {
+      response_(response_placeholder), callback_(callback), proto_(proto),
+      pool_(pool) {
 
     // Response should be an empty pointer. It gets populated by the
     // operator() method.
@@ -133,17 +164,6 @@ DNSClientImpl::DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
         isc_throw(isc::BadValue, "Response buffer pointer should be null");
     }
 
-    // @todo Currently we only support UDP. The support for TCP is planned for
-    // the future release.
-    if (proto_ == DNSClient::TCP) {
-        isc_throw(isc::NotImplemented, "TCP is currently not supported as a"
-                  << " Transport protocol for DNS Updates; please use UDP");
-    }
-
-    // Given that we already eliminated the possibility that TCP is used, it
-    // would be sufficient  to check that (proto != DNSClient::UDP). But, once
-    // support TCP is added the check above will disappear and the extra check
-    // will be needed here anyway.
     // Note that cascaded check is used here instead of:
     //   if (proto_ != DNSClient::TCP && proto_ != DNSClient::UDP)..
     // because some versions of GCC compiler complain that check above would
@@ -156,17 +176,65 @@ DNSClientImpl::DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
                       << proto_ << "' specified for DNS Updates");
         }
     }
+
+    if (pool_ && ((pool_->getProtocol() == DNSConnectionPool::TCP) !=
+                  (proto_ == DNSClient::TCP))) {
+        isc_throw(isc::BadValue, "the transport protocol of the connection"
+                  " pool does not match the transport protocol for DNS"
+                  " Updates");
+    }
 }
 
 DNSClientImpl::~DNSClientImpl() {
+    // The pool must not call back a destroyed client.
+    if (exchange_) {
+        exchange_->cancel();
+    }
 }
 
 void
 DNSClientImpl::operator()(asiodns::IOFetch::Result result) {
     // Get the status from IO. If no success, we just call user's callback
     // and pass the status code.
-    DNSClient::Status status = getStatus(result);
+    processResponse(getStatus(result));
+}
+
+void
+DNSClientImpl::exchangeHandler(DNSExchange::Result result,
+                               const OutputBufferPtr& response) {
+    exchange_.reset();
+    DNSClient::Status status = DNSClient::OTHER;
+    switch (result) {
+    case DNSExchange::SUCCESS:
+        in_buf_ = response;
+        status = DNSClient::SUCCESS;
+        break;
+
+    case DNSExchange::TIMEOUT:
+        status = DNSClient::TIMEOUT;
+        break;
+
+    default:
+        ;
+    }
+
+    processResponse(status);
+}
+
+void
+DNSClientImpl::processResponse(DNSClient::Status status) {
     if (status == DNSClient::SUCCESS) {
+        // Accumulate the round trip time to the server: the average latency
+        // is the total time divided by the number of responses.
+        auto latency = std::chrono::duration_cast<std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - start_time_);
+        StatsMgr::instance().addValue(StatsMgr::generateName("server", server_,
+                                                             "update-latency"),
+                                      static_cast<int64_t>(latency.count()));
+        StatsMgr::instance().addValue(StatsMgr::generateName("server", server_,
+                                                             "update-latency-count"),
+                                      static_cast<int64_t>(1));
+
         // Allocate a new response message. (Note that Message::fromWire
         // may only be run once per message, so we need to start fresh
         // each time.)
@@ -222,7 +290,7 @@ DNSClientImpl::getStatus(const asiodns::IOFetch::Result result) {
 }
 
 void
-DNSClientImpl::doUpdate(asiolink::IOService& io_service,
+DNSClientImpl::doUpdate(const asiolink::IOServicePtr& io_service,
                         const IOAddress& ns_addr,
                         const uint16_t ns_port,
                         D2UpdateMessage& update,
@@ -262,20 +330,52 @@ DNSClientImpl::doUpdate(asiolink::IOService& io_service,
     // invalid message object is given.
     update.toWire(renderer, tsig_context_.get());
 
-    // IOFetch has all the mechanisms that we need to perform asynchronous
-    // communication with the DNS server. The last but one argument points to
-    // this object as a completion callback for the message exchange. As a
-    // result operator()(Status) will be called.
+    server_ = ns_addr.toText();
+    start_time_ = std::chrono::steady_clock::now();
 
-    // Timeout value is explicitly cast to the int type to avoid warnings about
-    // overflows when doing implicit cast. It should have been checked by the
-    // caller that the unsigned timeout value will fit into int.
-    IOFetch io_fetch(IOFetch::UDP, io_service, msg_buf, ns_addr, ns_port,
-                     in_buf_, this, static_cast<int>(wait));
+    // A previous exchange over the pool should have completed: make sure
+    // it can't call back.
+    if (exchange_) {
+        exchange_->cancel();
+        exchange_.reset();
+    }
 
-    // Post the task to the task queue in the IO service. Caller will actually
-    // run these tasks by executing IOService::run.
-    io_service.post(io_fetch);
+    // Send over the persistent connection to the server when there is one.
+    // The pool declines the update when its query ID is in use, and a
+    // connection failure is reported as an error by the pool: in both
+    // cases the update is sent using a new socket.
+    if (pool_) {
+        try {
+            in_buf_.reset(new OutputBuffer(DEFAULT_BUFFER_SIZE));
+            exchange_ = pool_->send(io_service, ns_addr, ns_port, msg_buf, wait,
+                                    [this](DNSExchange::Result result,
+                                           const OutputBufferPtr& response) {
+                                        exchangeHandler(result, response);
+                                    });
+        } catch (const isc::Exception& ex) {
+            LOG_DEBUG(d2_to_dns_logger, isc::log::DBGLVL_TRACE_DETAIL,
+                      DHCP_DDNS_CONNECTION_POOL_ERROR).arg(ex.what());
+        }
+    }
+
+    if (!exchange_) {
+        // IOFetch has all the mechanisms that we need to perform asynchronous
+        // communication with the DNS server. The last but one argument points
+        // to this object as a completion callback for the message exchange.
+        // As a result operator()(Status) will be called.
+
+        // Timeout value is explicitly cast to the int type to avoid warnings
+        // about overflows when doing implicit cast. It should have been
+        // checked by the caller that the unsigned timeout value will fit into
+        // int.
+        IOFetch io_fetch(proto_ == DNSClient::TCP ? IOFetch::TCP : IOFetch::UDP,
+                         *io_service, msg_buf, ns_addr, ns_port, in_buf_, this,
+                         static_cast<int>(wait));
+
+        // Post the task to the task queue in the IO service. Caller will
+        // actually run these tasks by executing IOService::run.
+        io_service->post(io_fetch);
+    }
 
     // Update sent statistics.
     incrStats("update-sent");
@@ -297,8 +397,9 @@ DNSClientImpl::incrStats(const std::string& stat, bool update_key) {
 }
 
 DNSClient::DNSClient(D2UpdateMessagePtr& response_placeholder,
-                     Callback* callback, const DNSClient::Protocol proto)
-    : impl_(new DNSClientImpl(response_placeholder, callback, proto)) {
+                     Callback* callback, const DNSClient::Protocol proto,
+                     const DNSConnectionPoolPtr& pool)
+    : impl_(new DNSClientImpl(response_placeholder, callback, proto, pool)) {
 }
 
 DNSClient::~DNSClient() {
@@ -311,7 +412,7 @@ DNSClient::getMaxTimeout() {
 }
 
 void
-DNSClient::doUpdate(asiolink::IOService& io_service,
+DNSClient::doUpdate(const asiolink::IOServicePtr& io_service,
                     const IOAddress& ns_addr,
                     const uint16_t ns_port,
                     D2UpdateMessage& update,
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,7 @@
 #include <asiodns/io_fetch.h>
 #include <d2srv/d2_tsig_key.h>
 #include <d2srv/d2_update_message.h>
+#include <d2srv/dns_connection_pool.h>
 #include <util/buffer.h>
 
 namespace isc {
@@ -37,13 +38,18 @@ class DNSClientImpl;
 /// encapsulate DNS response, through class constructor. An exception will be
 /// thrown if the pointer is not initialized by the caller.
 ///
-/// @todo Ultimately, this class will support both TCP and UDP Transport.
-/// Currently only UDP is supported and can be specified as a preferred
-/// protocol. @c DNSClient constructor will throw an exception if TCP is
-/// specified. Once both protocols are supported, the @c DNSClient logic will
-/// try to obey caller's preference. However, it may use the other protocol if
-/// on its own discretion, when there is a legitimate reason to do so. For
-/// example, if communication with the server using preferred protocol fails.
+/// Both UDP and TCP transports are supported. By default each DNS Update is
+/// sent using a new socket. When a @c DNSConnectionPool is supplied, the
+/// updates are sent over the persistent connections of the pool instead:
+/// a UDP socket shared by all exchanges with a server or a pipelined TCP
+/// connection, responses being matched to requests using the query ID.
+/// If the query ID of an update is already used by an exchange in progress
+/// with the same server, this update is sent using its own socket.
+///
+/// The time between sending an update and receiving the response is
+/// added to the "server[address].update-latency" statistic, in
+/// milliseconds, and the "server[address].update-latency-count" statistic
+/// counts the responses so the average latency can be computed.
 class DNSClient {
 public:
 
@@ -90,8 +96,12 @@ public:
     /// if an error occurs. NULL value disables callback invocation.
     /// @param proto caller's preference regarding Transport layer protocol to
     /// be used by DNS Client to communicate with a server.
+    /// @param pool Pool of persistent connections used to send the updates.
+    /// NULL value means that each update is sent using a new socket. The
+    /// protocol of the pool must match the transport protocol.
     DNSClient(D2UpdateMessagePtr& response_placeholder, Callback* callback,
-              const Protocol proto = UDP);
+              const Protocol proto = UDP,
+              const DNSConnectionPoolPtr& pool = DNSConnectionPoolPtr());
 
     /// @brief Virtual destructor, does nothing.
     ~DNSClient();
@@ -139,7 +149,7 @@ public:
     /// @param tsig_key A pointer to an @c D2TsigKeyPtr object that will
     /// (if not null) be used to sign the DNS Update message and verify the
     /// response.
-    void doUpdate(asiolink::IOService& io_service,
+    void doUpdate(const asiolink::IOServicePtr& io_service,
                   const asiolink::IOAddress& ns_addr,
                   const uint16_t ns_port,
                   D2UpdateMessage& update,
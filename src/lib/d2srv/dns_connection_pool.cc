@@ -0,0 +1,689 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/asio_wrapper.h>
+#include <d2srv/dns_connection_pool.h>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/make_shared.hpp>
+
+#include <cctype>
+#include <deque>
+#include <set>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+namespace ip = boost::asio::ip;
+
+namespace isc {
+namespace d2 {
+
+namespace {
+
+/// @brief Size of the read buffer: the maximum size of a DNS message.
+const size_t READ_BUFFER_SIZE = 65535;
+
+/// @brief Reads a 16 bit integer in network order.
+///
+/// Used to get the query ID of a DNS message and the length of a message
+/// received over TCP.
+///
+/// @param data the data to read
+uint16_t
+readUint16(const uint8_t* data) {
+    return ((static_cast<uint16_t>(data[0]) << 8) | data[1]);
+}
+
+/// @brief Size of the header of a DNS message.
+const size_t HEADER_SIZE = 12;
+
+/// @brief Returns the opcode of a DNS message.
+///
+/// @param data the DNS message, at least @c HEADER_SIZE long
+uint8_t
+getOpcode(const uint8_t* data) {
+    return ((data[2] >> 3) & 0x0f);
+}
+
+/// @brief Returns the first entry of the zone (question) section of a
+/// DNS message.
+///
+/// The name is lower cased so entries can be compared as bytes.
+///
+/// @param data the DNS message
+/// @param length the length of the DNS message
+///
+/// @return the name, type and class of the entry in wire format, or an
+/// empty vector if the section is empty or malformed.
+std::vector<uint8_t>
+getZone(const uint8_t* data, const size_t length) {
+    std::vector<uint8_t> zone;
+    if ((length < HEADER_SIZE) || (readUint16(data + 4) == 0)) {
+        return (zone);
+    }
+
+    size_t offset = HEADER_SIZE;
+    while (offset < length) {
+        uint8_t label_length = data[offset];
+        // The zone section is the first one so its name is not compressed.
+        if ((label_length & 0xc0) != 0) {
+            return (std::vector<uint8_t>());
+        }
+        if (offset + 1 + label_length > length) {
+            return (std::vector<uint8_t>());
+        }
+        zone.push_back(label_length);
+        for (size_t i = offset + 1; i < offset + 1 + label_length; ++i) {
+            zone.push_back(static_cast<uint8_t>(std::tolower(data[i])));
+        }
+        offset += 1 + label_length;
+        if (label_length == 0) {
+            // The type and the class follow the name.
+            if (offset + 4 > length) {
+                return (std::vector<uint8_t>());
+            }
+            zone.insert(zone.end(), data + offset, data + offset + 4);
+            return (zone);
+        }
+    }
+
+    return (std::vector<uint8_t>());
+}
+
+}
+
+/// @brief A connection (or UDP socket) to a DNS server.
+///
+/// The connection is driven by a single IOService: all of its methods must
+/// be called by the thread running it.
+class DNSConnection : public boost::enable_shared_from_this<DNSConnection>,
+                      public boost::noncopyable {
+public:
+    /// @brief Constructor
+    ///
+    /// @param io_service the IOService driving the connection
+    /// @param ns_addr the address of the DNS server
+    /// @param ns_port the port of the DNS server
+    /// @param protocol the transport protocol
+    DNSConnection(IOService& io_service, const IOAddress& ns_addr,
+                  const uint16_t ns_port,
+                  const DNSConnectionPool::Protocol protocol)
+        : service_(io_service), io_service_(io_service.get_io_service()),
+          address_(ip::address::from_string(ns_addr.toText())), port_(ns_port), protocol_(protocol),
+          udp_socket_(), udp_sockets_(), tcp_socket_(io_service_),
+          state_(CLOSED), pending_(), write_queue_(), writing_(false),
+          read_buf_(), tcp_data_() {
+    }
+
+    /// @brief Destructor
+    ~DNSConnection() {
+        closeSockets();
+    }
+
+    /// @brief Sends a DNS message.
+    ///
+    /// @param exchange the exchange of the message
+    /// @param request the DNS message in wire format
+    /// @param wait the timeout (in milliseconds) of the exchange
+    ///
+    /// @return false if the query ID is used by an exchange in progress.
+    bool send(const DNSExchangePtr& exchange, const OutputBufferPtr& request,
+              const unsigned int wait) {
+        if (pending_.count(exchange->getQid())) {
+            return (false);
+        }
+
+        if (protocol_ == DNSConnectionPool::UDP) {
+            if (!udp_socket_ || (udp_socket_->exchanges_ >=
+                                 DNSConnectionPool::MAX_UDP_SOCKET_EXCHANGES)) {
+                openUdp();
+            }
+        } else if (state_ == CLOSED) {
+            openTcp();
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(request->getData());
+        auto timer = boost::make_shared<boost::asio::deadline_timer>(
+            io_service_, boost::posix_time::milliseconds(wait));
+        Pending pending{ exchange, timer, udp_socket_, 0, std::vector<uint8_t>() };
+        if (request->getLength() >= HEADER_SIZE) {
+            pending.opcode_ = getOpcode(data);
+            pending.zone_ = getZone(data, request->getLength());
+        }
+        pending_[exchange->getQid()] = pending;
+        boost::weak_ptr<DNSConnection> weak_self(shared_from_this());
+        timer->async_wait([weak_self, exchange]
+                          (const boost::system::error_code& ec) {
+            DNSConnectionPtr self = weak_self.lock();
+            if (!ec && self) {
+                self->timeout(exchange);
+            }
+        });
+
+        if (protocol_ == DNSConnectionPool::UDP) {
+            ++udp_socket_->exchanges_;
+            ++udp_socket_->pending_;
+            sendUdp(udp_socket_, exchange, request);
+        } else {
+            // Messages over TCP are preceded by their length.
+            OutputBufferPtr framed(new OutputBuffer(request->getLength() + 2));
+            framed->writeUint16(static_cast<uint16_t>(request->getLength()));
+            framed->writeData(request->getData(), request->getLength());
+            write_queue_.push_back(framed);
+            writeNext();
+        }
+
+        return (true);
+    }
+
+    /// @brief Returns the IOService driving the connection.
+    IOService& getIOService() {
+        return (service_);
+    }
+
+    /// @brief Closes the connection.
+    ///
+    /// The exchanges in progress fail.
+    void close() {
+        closeSockets();
+        fail();
+    }
+
+private:
+    /// @brief State of the connection.
+    enum State {
+        CLOSED,
+        CONNECTING,
+        OPEN
+    };
+
+    /// @brief A UDP socket with its read buffer.
+    struct UdpSocket {
+        /// @brief Constructor
+        ///
+        /// @param io_service the IO service driving the socket
+        UdpSocket(boost::asio::io_service& io_service)
+            : socket_(io_service), read_buf_(READ_BUFFER_SIZE), exchanges_(0),
+              pending_(0) {
+        }
+
+        /// @brief The socket.
+        ip::udp::socket socket_;
+
+        /// @brief The read buffer.
+        std::vector<uint8_t> read_buf_;
+
+        /// @brief Number of exchanges sent over the socket.
+        size_t exchanges_;
+
+        /// @brief Number of exchanges waiting for a response on the socket.
+        size_t pending_;
+    };
+
+    /// @brief Defines a pointer to a UdpSocket instance.
+    typedef boost::shared_ptr<UdpSocket> UdpSocketPtr;
+
+    /// @brief An exchange waiting for its response.
+    struct Pending {
+        /// @brief The exchange.
+        DNSExchangePtr exchange_;
+
+        /// @brief The timer of the exchange.
+        boost::shared_ptr<boost::asio::deadline_timer> timer_;
+
+        /// @brief The UDP socket the request was sent from (null over TCP).
+        UdpSocketPtr socket_;
+
+        /// @brief The opcode of the request.
+        uint8_t opcode_;
+
+        /// @brief The zone section entry of the request, see @c getZone.
+        std::vector<uint8_t> zone_;
+    };
+
+    /// @brief Opens a new UDP socket for the next exchanges.
+    ///
+    /// The previous socket is closed once it has no exchange waiting for a
+    /// response.
+    void openUdp() {
+        ip::udp::endpoint endpoint(address_, port_);
+        UdpSocketPtr socket(new UdpSocket(io_service_));
+        socket->socket_.open(endpoint.protocol());
+        socket->socket_.connect(endpoint);
+        UdpSocketPtr previous = udp_socket_;
+        udp_socket_ = socket;
+        udp_sockets_.insert(socket);
+        readUdp(socket);
+        if (previous) {
+            releaseUdp(previous);
+        }
+    }
+
+    /// @brief Closes a UDP socket which is no longer needed.
+    ///
+    /// A socket is no longer needed when it has been replaced and has no
+    /// exchange waiting for a response.
+    ///
+    /// @param socket the socket
+    void releaseUdp(const UdpSocketPtr& socket) {
+        if ((socket == udp_socket_) || (socket->pending_ > 0)) {
+            return;
+        }
+
+        boost::system::error_code ec;
+        socket->socket_.close(ec);
+        udp_sockets_.erase(socket);
+    }
+
+    /// @brief Forgets an exchange waiting for its response.
+    ///
+    /// @param pos the position of the exchange
+    void erasePending(std::map<uint16_t, Pending>::iterator pos) {
+        UdpSocketPtr socket = pos->second.socket_;
+        pending_.erase(pos);
+        if (socket) {
+            --socket->pending_;
+            releaseUdp(socket);
+        }
+    }
+
+    /// @brief Starts connecting over TCP.
+    void openTcp() {
+        DNSConnectionPtr self = shared_from_this();
+        if (read_buf_.empty()) {
+            read_buf_.resize(READ_BUFFER_SIZE);
+        }
+        ip::tcp::endpoint endpoint(address_, port_);
+        tcp_socket_.open(endpoint.protocol());
+        state_ = CONNECTING;
+        tcp_socket_.async_connect(endpoint,
+                                  [self](const boost::system::error_code& ec) {
+            self->connected(ec);
+        });
+    }
+
+    /// @brief Closes the sockets and forgets the messages to write.
+    void closeSockets() {
+        boost::system::error_code ec;
+        for (auto const& socket : udp_sockets_) {
+            socket->socket_.close(ec);
+        }
+        udp_sockets_.clear();
+        udp_socket_.reset();
+        if (tcp_socket_.is_open()) {
+            tcp_socket_.close(ec);
+        }
+        state_ = CLOSED;
+        write_queue_.clear();
+        writing_ = false;
+        tcp_data_.clear();
+    }
+
+    /// @brief Fails all the exchanges in progress.
+    void fail() {
+        std::map<uint16_t, Pending> pending;
+        pending.swap(pending_);
+        for (auto const& it : pending) {
+            boost::system::error_code ec;
+            it.second.timer_->cancel(ec);
+            it.second.exchange_->complete(DNSExchange::FAILED,
+                                          OutputBufferPtr());
+        }
+    }
+
+    /// @brief Handles the timeout of an exchange.
+    ///
+    /// @param exchange the exchange
+    void timeout(const DNSExchangePtr& exchange) {
+        auto pos = pending_.find(exchange->getQid());
+        if ((pos == pending_.end()) || (pos->second.exchange_ != exchange)) {
+            return;
+        }
+
+        erasePending(pos);
+        exchange->complete(DNSExchange::TIMEOUT, OutputBufferPtr());
+    }
+
+    /// @brief Delivers a response to its exchange.
+    ///
+    /// A response is delivered to the exchange with the same query ID when
+    /// it was received on the socket the request was sent from, it is a
+    /// response with the opcode of the request and its zone section, when
+    /// not empty, is the one of the request.  Other responses (e.g. late or
+    /// spoofed responses) are dropped.
+    ///
+    /// @param data the response
+    /// @param length the length of the response
+    /// @param socket the UDP socket the response was received on (null
+    /// over TCP)
+    void deliver(const uint8_t* data, const size_t length,
+                 const UdpSocketPtr& socket) {
+        if (length < HEADER_SIZE) {
+            return;
+        }
+
+        auto pos = pending_.find(readUint16(data));
+        if ((pos == pending_.end()) || (pos->second.socket_ != socket) ||
+            ((data[2] & 0x80) == 0) ||
+            (getOpcode(data) != pos->second.opcode_)) {
+            return;
+        }
+
+        // Error responses may have an empty zone section.
+        if ((readUint16(data + 4) != 0) &&
+            (getZone(data, length) != pos->second.zone_)) {
+            return;
+        }
+
+        Pending pending = pos->second;
+        erasePending(pos);
+        boost::system::error_code ec;
+        pending.timer_->cancel(ec);
+        OutputBufferPtr response(new OutputBuffer(length));
+        response->writeData(data, length);
+        pending.exchange_->complete(DNSExchange::SUCCESS, response);
+    }
+
+    /// @brief Sends a message over UDP.
+    ///
+    /// @param socket the socket to send the message from
+    /// @param exchange the exchange of the message
+    /// @param request the DNS message in wire format
+    void sendUdp(const UdpSocketPtr& socket, const DNSExchangePtr& exchange,
+                 const OutputBufferPtr& request) {
+        DNSConnectionPtr self = shared_from_this();
+        socket->socket_.async_send(boost::asio::buffer(request->getData(),
+                                                       request->getLength()),
+                                   [self, exchange, request]
+                                   (const boost::system::error_code& ec,
+                                    size_t) {
+            if (ec && (ec != boost::asio::error::operation_aborted)) {
+                self->timeout(exchange);
+            }
+        });
+    }
+
+    /// @brief Receives the next UDP datagram.
+    ///
+    /// @param socket the socket to receive from
+    void readUdp(const UdpSocketPtr& socket) {
+        DNSConnectionPtr self = shared_from_this();
+        socket->socket_.async_receive(boost::asio::buffer(socket->read_buf_),
+                                      [self, socket]
+                                      (const boost::system::error_code& ec,
+                                       size_t length) {
+            self->udpReceived(socket, ec, length);
+        });
+    }
+
+    /// @brief Handles a received UDP datagram.
+    ///
+    /// @param socket the socket the datagram was received on
+    /// @param ec the error code
+    /// @param length the length of the datagram
+    void udpReceived(const UdpSocketPtr& socket,
+                     const boost::system::error_code& ec, size_t length) {
+        if ((ec == boost::asio::error::operation_aborted) ||
+            !socket->socket_.is_open()) {
+            return;
+        }
+
+        // Errors such as an ICMP port unreachable do not close the socket:
+        // the exchanges will time out.
+        if (!ec) {
+            std::vector<uint8_t> datagram(socket->read_buf_.begin(),
+                                          socket->read_buf_.begin() + length);
+            readUdp(socket);
+            if (!datagram.empty()) {
+                deliver(&datagram[0], datagram.size(), socket);
+            }
+        } else {
+            readUdp(socket);
+        }
+    }
+
+    /// @brief Handles the completion of a TCP connect.
+    ///
+    /// @param ec the error code
+    void connected(const boost::system::error_code& ec) {
+        if ((ec == boost::asio::error::operation_aborted) ||
+            (state_ != CONNECTING)) {
+            return;
+        }
+
+        if (ec) {
+            close();
+            return;
+        }
+
+        state_ = OPEN;
+        readTcp();
+        writeNext();
+    }
+
+    /// @brief Writes the next message over TCP.
+    void writeNext() {
+        if ((state_ != OPEN) || writing_ || write_queue_.empty()) {
+            return;
+        }
+
+        writing_ = true;
+        DNSConnectionPtr self = shared_from_this();
+        OutputBufferPtr message = write_queue_.front();
+        boost::asio::async_write(tcp_socket_,
+                                 boost::asio::buffer(message->getData(),
+                                                     message->getLength()),
+                                 [self, message]
+                                 (const boost::system::error_code& ec, size_t) {
+            self->written(ec);
+        });
+    }
+
+    /// @brief Handles the completion of a TCP write.
+    ///
+    /// @param ec the error code
+    void written(const boost::system::error_code& ec) {
+        if ((ec == boost::asio::error::operation_aborted) || !writing_) {
+            return;
+        }
+
+        writing_ = false;
+        if (ec) {
+            close();
+            return;
+        }
+
+        write_queue_.pop_front();
+        writeNext();
+    }
+
+    /// @brief Reads more data over TCP.
+    void readTcp() {
+        DNSConnectionPtr self = shared_from_this();
+        tcp_socket_.async_read_some(boost::asio::buffer(read_buf_),
+                                    [self](const boost::system::error_code& ec,
+                                           size_t length) {
+            self->tcpReceived(ec, length);
+        });
+    }
+
+    /// @brief Handles data received over TCP.
+    ///
+    /// Extracts the complete messages and delivers them.
+    ///
+    /// @param ec the error code
+    /// @param length the length of the data
+    void tcpReceived(const boost::system::error_code& ec, size_t length) {
+        if ((ec == boost::asio::error::operation_aborted) || (state_ != OPEN)) {
+            return;
+        }
+
+        if (ec) {
+            // Includes the server closing the connection.
+            close();
+            return;
+        }
+
+        tcp_data_.insert(tcp_data_.end(), read_buf_.begin(),
+                         read_buf_.begin() + length);
+        std::vector<std::vector<uint8_t> > messages;
+        size_t offset = 0;
+        while (tcp_data_.size() - offset >= 2) {
+            size_t msg_length = readUint16(&tcp_data_[offset]);
+            if (tcp_data_.size() - offset - 2 < msg_length) {
+                break;
+            }
+            messages.push_back(std::vector<uint8_t>(
+                tcp_data_.begin() + offset + 2,
+                tcp_data_.begin() + offset + 2 + msg_length));
+            offset += 2 + msg_length;
+        }
+        tcp_data_.erase(tcp_data_.begin(), tcp_data_.begin() + offset);
+
+        readTcp();
+        for (auto const& message : messages) {
+            if (!message.empty()) {
+                deliver(&message[0], message.size(), UdpSocketPtr());
+            }
+        }
+    }
+
+    /// @brief The IOService driving the connection.
+    IOService& service_;
+
+    /// @brief The IO service driving the connection.
+    boost::asio::io_service& io_service_;
+
+    /// @brief The address of the DNS server.
+    ip::address address_;
+
+    /// @brief The port of the DNS server.
+    uint16_t port_;
+
+    /// @brief The transport protocol.
+    DNSConnectionPool::Protocol protocol_;
+
+    /// @brief The UDP socket used by new exchanges.
+    UdpSocketPtr udp_socket_;
+
+    /// @brief The open UDP sockets: the current one and the replaced ones
+    /// with exchanges waiting for a response.
+    std::set<UdpSocketPtr> udp_sockets_;
+
+    /// @brief The TCP socket.
+    ip::tcp::socket tcp_socket_;
+
+    /// @brief The state of the connection.
+    State state_;
+
+    /// @brief The exchanges waiting for their response by query ID.
+    std::map<uint16_t, Pending> pending_;
+
+    /// @brief The messages to write over TCP.
+    std::deque<OutputBufferPtr> write_queue_;
+
+    /// @brief True when a TCP write is in progress.
+    bool writing_;
+
+    /// @brief The TCP read buffer.
+    std::vector<uint8_t> read_buf_;
+
+    /// @brief The TCP data received but not yet delivered.
+    std::vector<uint8_t> tcp_data_;
+};
+
+const size_t DNSConnectionPool::MAX_UDP_SOCKET_EXCHANGES;
+
+DNSConnectionPool::DNSConnectionPool(const Protocol protocol)
+    : protocol_(protocol), connections_(), mutex_() {
+}
+
+DNSConnectionPool::~DNSConnectionPool() {
+    clear();
+}
+
+DNSExchangePtr
+DNSConnectionPool::send(const IOServicePtr& io_service,
+                        const IOAddress& ns_addr, const uint16_t ns_port,
+                        const OutputBufferPtr& request,
+                        const unsigned int wait,
+                        const DNSExchange::Handler& handler) {
+    if (!io_service) {
+        isc_throw(BadValue, "DNSConnectionPool: null IOService");
+    }
+    if (!request || (request->getLength() < 2)) {
+        isc_throw(BadValue, "DNSConnectionPool: invalid DNS message");
+    }
+
+    DNSConnectionPtr connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Key key(io_service, ns_addr.toText(), ns_port);
+        auto pos = connections_.find(key);
+        if (pos == connections_.end()) {
+            connection.reset(new DNSConnection(*io_service, ns_addr, ns_port,
+                                               protocol_));
+            connections_[key] = connection;
+        } else {
+            connection = pos->second;
+        }
+    }
+
+    DNSExchangePtr exchange(new DNSExchange(readUint16(static_cast<const uint8_t*>(request->getData())),
+                                            handler));
+    try {
+        if (!connection->send(exchange, request, wait)) {
+            return (DNSExchangePtr());
+        }
+    } catch (const boost::system::system_error& ex) {
+        connection->close();
+        isc_throw(Unexpected, "DNSConnectionPool: failed to connect to "
+                  << ns_addr.toText() << " port " << ns_port << ": "
+                  << ex.what());
+    }
+
+    return (exchange);
+}
+
+void
+DNSConnectionPool::clear() {
+    std::map<Key, DNSConnectionPtr> connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections.swap(connections_);
+    }
+
+    // Connections are only used by the thread running their IOService:
+    // when it is stopped no thread does, and a posted close could never
+    // run before the IOService is destroyed.
+    for (auto const& it : connections) {
+        DNSConnectionPtr connection = it.second;
+        IOService& io_service = connection->getIOService();
+        if (io_service.get_io_service().stopped()) {
+            connection->close();
+        } else {
+            io_service.post([connection]() {
+                connection->close();
+            });
+        }
+    }
+}
+
+size_t
+DNSConnectionPool::getConnectionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (connections_.size());
+}
+
+} // namespace isc::d2
+} // namespace isc
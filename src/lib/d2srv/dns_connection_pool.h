@@ -0,0 +1,199 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef DNS_CONNECTION_POOL_H
+#define DNS_CONNECTION_POOL_H
+
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
+#include <exceptions/exceptions.h>
+#include <util/buffer.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace isc {
+namespace d2 {
+
+/// @brief A connection (or UDP socket) to a DNS server (implementation in
+/// the source file).
+class DNSConnection;
+
+/// @brief Defines a pointer to a DNSConnection instance.
+typedef boost::shared_ptr<DNSConnection> DNSConnectionPtr;
+
+/// @brief A DNS message exchange in progress over a pooled connection.
+///
+/// The exchange is returned by @ref DNSConnectionPool::send so the sender
+/// may cancel it, e.g. when it is destroyed before the response arrives.
+class DNSExchange {
+public:
+    /// @brief Outcome of an exchange.
+    enum Result {
+        SUCCESS,    ///< A response was received.
+        TIMEOUT,    ///< No response was received in time.
+        FAILED      ///< The connection failed or was closed.
+    };
+
+    /// @brief Handler invoked when the exchange completes.
+    ///
+    /// The buffer holds the response when the result is @c SUCCESS.
+    typedef std::function<void(Result, const util::OutputBufferPtr&)> Handler;
+
+    /// @brief Constructor
+    ///
+    /// @param qid the query ID of the request
+    /// @param handler the handler invoked when the exchange completes
+    DNSExchange(const uint16_t qid, const Handler& handler)
+        : qid_(qid), handler_(handler) {
+    }
+
+    /// @brief Returns the query ID of the request.
+    uint16_t getQid() const {
+        return (qid_);
+    }
+
+    /// @brief Cancels the exchange: the handler will not be invoked.
+    void cancel() {
+        handler_ = Handler();
+    }
+
+    /// @brief Completes the exchange.
+    ///
+    /// Invokes the handler, if not cancelled. The handler is invoked
+    /// at most once.
+    ///
+    /// @param result the outcome of the exchange
+    /// @param response the response (if any)
+    void complete(Result result, const util::OutputBufferPtr& response) {
+        Handler handler;
+        handler.swap(handler_);
+        if (handler) {
+            handler(result, response);
+        }
+    }
+
+private:
+    /// @brief Query ID of the request.
+    uint16_t qid_;
+
+    /// @brief Handler invoked when the exchange completes.
+    Handler handler_;
+};
+
+/// @brief Defines a pointer to a DNSExchange instance.
+typedef boost::shared_ptr<DNSExchange> DNSExchangePtr;
+
+/// @brief Pool of persistent connections to DNS servers.
+///
+/// Instead of opening a new socket for every DNS update, the @c DNSClient
+/// may send its updates through this pool.  The pool keeps one connection
+/// per IOService and DNS server:
+///
+/// - over UDP the connection is a socket kept open and shared by all the
+/// exchanges with the server.  To make spoofed responses harder to inject
+/// the socket is replaced, and so gets a new ephemeral source port, after
+/// @ref MAX_UDP_SOCKET_EXCHANGES exchanges, and a response is matched to
+/// its request using the socket it was received on, the query ID, the
+/// opcode and the zone section.
+/// - over TCP the connection is kept established and requests are
+/// pipelined: they are written as soon as they are sent, and the
+/// responses, which may arrive in any order, are matched using the query
+/// ID, opcode and zone section.  A failed connection is reopened on the
+/// next send.
+///
+/// Connections are only used by the thread running their IOService, the
+/// pool itself is thread safe.
+class DNSConnectionPool : public boost::noncopyable {
+public:
+    /// @brief Transport protocol of the connections.
+    enum Protocol {
+        UDP,
+        TCP
+    };
+
+    /// @brief Number of exchanges after which a UDP socket is replaced.
+    static const size_t MAX_UDP_SOCKET_EXCHANGES = 100;
+
+    /// @brief Constructor
+    ///
+    /// @param protocol the transport protocol of the connections.
+    explicit DNSConnectionPool(const Protocol protocol);
+
+    /// @brief Destructor
+    ///
+    /// Closes all the connections, see @ref clear.
+    ~DNSConnectionPool();
+
+    /// @brief Returns the transport protocol of the connections.
+    Protocol getProtocol() const {
+        return (protocol_);
+    }
+
+    /// @brief Sends a DNS message.
+    ///
+    /// @param io_service the IOService running the exchange, held by the
+    /// pool until its connections are discarded
+    /// @param ns_addr the address of the DNS server
+    /// @param ns_port the port of the DNS server
+    /// @param request the DNS message in wire format
+    /// @param wait the timeout (in milliseconds) of the exchange
+    /// @param handler the handler invoked when the exchange completes
+    ///
+    /// @return the exchange, or an empty pointer if the query ID of the
+    /// request is already used by an exchange in progress with the server,
+    /// in which case the request must be sent by other means.
+    DNSExchangePtr send(const asiolink::IOServicePtr& io_service,
+                        const asiolink::IOAddress& ns_addr,
+                        const uint16_t ns_port,
+                        const util::OutputBufferPtr& request,
+                        const unsigned int wait,
+                        const DNSExchange::Handler& handler);
+
+    /// @brief Closes and discards all the connections.
+    ///
+    /// The connections are closed by the IOService driving them, the
+    /// exchanges in progress failing.  The connections of a stopped
+    /// IOService are closed at once, so this must not be called while a
+    /// thread still runs its handlers.  Otherwise the connections are
+    /// closed when the IOService runs or is destroyed.
+    void clear();
+
+    /// @brief Returns the number of connections in the pool.
+    size_t getConnectionCount() const;
+
+private:
+    /// @brief Transport protocol of the connections.
+    Protocol protocol_;
+
+    /// @brief Key of a connection: IOService, server address and port.
+    ///
+    /// The key holds the IOService so it can't be destroyed, and its
+    /// address reused by another IOService, while it has connections in
+    /// the pool.
+    typedef std::tuple<asiolink::IOServicePtr, std::string, uint16_t> Key;
+
+    /// @brief Connections by IOService and server.
+    std::map<Key, DNSConnectionPtr> connections_;
+
+    /// @brief Mutex protecting the connections.
+    mutable std::mutex mutex_;
+};
+
+/// @brief Defines a pointer to a DNSConnectionPool instance.
+typedef boost::shared_ptr<DNSConnectionPool> DNSConnectionPoolPtr;
+
+} // namespace isc::d2
+} // namespace isc
+
+#endif // DNS_CONNECTION_POOL_H
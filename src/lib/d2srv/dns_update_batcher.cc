@@ -0,0 +1,407 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/asio_wrapper.h>
+#include <d2srv/d2_log.h>
+#include <d2srv/dns_update_batcher.h>
+#include <dns/messagerenderer.h>
+#include <dns/qid_gen.h>
+#include <dns/rcode.h>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/make_shared.hpp>
+
+#include <sstream>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::dns;
+
+namespace isc {
+namespace d2 {
+
+/// @brief An update waiting for the response to its batch.
+struct BatchedUpdate {
+    /// @brief IOService of the sender, used to invoke the handler.
+    IOServicePtr io_service_;
+
+    /// @brief The DNS update.
+    D2UpdateMessagePtr request_;
+
+    /// @brief The handler of the sender.
+    DNSUpdateBatcher::UpdateHandler handler_;
+};
+
+/// @brief A batch of DNS updates sent in a single message.
+///
+/// A batch lives from the reception of its first update until the response
+/// to its message has been delivered to all of its updates.
+class DNSUpdateBatch : public DNSClient::Callback,
+                       public boost::enable_shared_from_this<DNSUpdateBatch> {
+public:
+    /// @brief Constructor
+    ///
+    /// @param io_service IOService used to send the message
+    /// @param ns_addr the address of the DNS server
+    /// @param ns_port the port of the DNS server
+    /// @param wait the timeout of the exchange
+    /// @param tsig_key the TSIG key used to sign the message
+    /// @param proto the transport protocol
+    /// @param pool the pool of persistent connections (may be null)
+    /// @param wire_size the size of the message without update section
+    DNSUpdateBatch(const IOServicePtr& io_service, const IOAddress& ns_addr,
+                   const uint16_t ns_port, const unsigned int wait,
+                   const D2TsigKeyPtr& tsig_key,
+                   const DNSClient::Protocol proto,
+                   const DNSConnectionPoolPtr& pool,
+                   const size_t wire_size = 0)
+        : io_service_(io_service), ns_addr_(ns_addr), ns_port_(ns_port),
+          wait_(wait), tsig_key_(tsig_key), proto_(proto), pool_(pool),
+          wire_size_(wire_size), updates_(), response_(), dns_client_(),
+          self_() {
+    }
+
+    /// @brief Destructor
+    virtual ~DNSUpdateBatch() {
+    }
+
+    /// @brief Sends the batch.
+    ///
+    /// Merges the update sections of the updates in a new message, unless
+    /// there is only one, and sends it.  The batch keeps itself alive until
+    /// the exchange completes.
+    void send() {
+        D2UpdateMessagePtr request;
+        try {
+            if (updates_.size() == 1) {
+                request = updates_[0].request_;
+            } else {
+                request.reset(new D2UpdateMessage(D2UpdateMessage::OUTBOUND));
+                request->setId(QidGenerator::getInstance().generateQid());
+                D2ZonePtr zone = updates_[0].request_->getZone();
+                request->setZone(zone->getName(), zone->getClass());
+                for (auto const& update : updates_) {
+                    for (auto it = update.request_->beginSection(
+                             D2UpdateMessage::SECTION_UPDATE);
+                         it != update.request_->endSection(
+                             D2UpdateMessage::SECTION_UPDATE); ++it) {
+                        request->addRRset(D2UpdateMessage::SECTION_UPDATE, *it);
+                    }
+                }
+            }
+
+            self_ = shared_from_this();
+            dns_client_.reset(new DNSClient(response_, this, proto_, pool_));
+            dns_client_->doUpdate(io_service_, ns_addr_, ns_port_, *request,
+                                  wait_, tsig_key_);
+            if (updates_.size() > 1) {
+                LOG_DEBUG(d2_to_dns_logger, isc::log::DBGLVL_TRACE_DETAIL,
+                          DHCP_DDNS_UPDATE_BATCH_SENT)
+                    .arg(updates_.size())
+                    .arg(request->getZone()->getName().toText())
+                    .arg(ns_addr_.toText()).arg(ns_port_);
+            }
+        } catch (const std::exception& ex) {
+            LOG_ERROR(d2_to_dns_logger, DHCP_DDNS_UPDATE_BATCH_SEND_ERROR)
+                .arg(updates_.size()).arg(ex.what());
+            self_.reset();
+            response_.reset();
+            complete(DNSClient::OTHER);
+        }
+    }
+
+    /// @brief DNSClient completion handler.
+    ///
+    /// If the server rejected a batch of several updates, each update is
+    /// resent on its own, otherwise the status and the response are
+    /// delivered to all updates.
+    ///
+    /// @param status the status of the exchange
+    virtual void operator()(DNSClient::Status status) {
+        if ((status == DNSClient::SUCCESS) && (updates_.size() > 1) &&
+            response_ && (response_->getRcode() != Rcode::NOERROR())) {
+            LOG_DEBUG(d2_to_dns_logger, isc::log::DBGLVL_TRACE_DETAIL,
+                      DHCP_DDNS_UPDATE_BATCH_REJECTED)
+                .arg(updates_.size()).arg(ns_addr_.toText()).arg(ns_port_)
+                .arg(response_->getRcode().toText());
+            for (auto const& update : updates_) {
+                DNSUpdateBatchPtr single(new DNSUpdateBatch(update.io_service_,
+                                                            ns_addr_, ns_port_,
+                                                            wait_, tsig_key_,
+                                                            proto_, pool_));
+                single->addUpdate(update);
+                update.io_service_->post([single]() { single->send(); });
+            }
+        } else {
+            complete(status);
+        }
+
+        // The DNSClient is still on the call stack so release the batch
+        // once the handler has returned.
+        DNSUpdateBatchPtr self = self_;
+        self_.reset();
+        io_service_->post([self]() {});
+    }
+
+    /// @brief Adds an update to the batch.
+    ///
+    /// @param update the update to add
+    /// @param update_size the size of the update section of the update
+    void addUpdate(const BatchedUpdate& update, const size_t update_size = 0) {
+        updates_.push_back(update);
+        wire_size_ += update_size;
+    }
+
+    /// @brief Returns the size of the message of the batch.
+    size_t getWireSize() const {
+        return (wire_size_);
+    }
+
+    /// @brief Returns the number of updates in the batch.
+    size_t getUpdateCount() const {
+        return (updates_.size());
+    }
+
+    /// @brief Returns the IOService used to send the batch.
+    const IOServicePtr& getIOService() const {
+        return (io_service_);
+    }
+
+private:
+    /// @brief Delivers the status and the response to all updates.
+    ///
+    /// @param status the status of the exchange
+    void complete(DNSClient::Status status) {
+        D2UpdateMessagePtr response = response_;
+        for (auto const& update : updates_) {
+            DNSUpdateBatcher::UpdateHandler handler = update.handler_;
+            update.io_service_->post([handler, status, response]() {
+                handler(status, response);
+            });
+        }
+    }
+
+    /// @brief IOService used to send the message.
+    IOServicePtr io_service_;
+
+    /// @brief The address of the DNS server.
+    IOAddress ns_addr_;
+
+    /// @brief The port of the DNS server.
+    uint16_t ns_port_;
+
+    /// @brief The timeout of the exchange.
+    unsigned int wait_;
+
+    /// @brief The TSIG key used to sign the message.
+    D2TsigKeyPtr tsig_key_;
+
+    /// @brief The transport protocol.
+    DNSClient::Protocol proto_;
+
+    /// @brief The pool of persistent connections (may be null).
+    DNSConnectionPoolPtr pool_;
+
+    /// @brief The size of the message of the batch.
+    size_t wire_size_;
+
+    /// @brief The updates of the batch.
+    std::vector<BatchedUpdate> updates_;
+
+    /// @brief The response from the server.
+    D2UpdateMessagePtr response_;
+
+    /// @brief The DNS client sending the message.
+    DNSClientPtr dns_client_;
+
+    /// @brief Keeps the batch alive while the exchange is in progress.
+    DNSUpdateBatchPtr self_;
+};
+
+const size_t DNSUpdateBatcher::MAX_UDP_MESSAGE_SIZE;
+const size_t DNSUpdateBatcher::MAX_TCP_MESSAGE_SIZE;
+
+DNSUpdateBatcher::DNSUpdateBatcher(const size_t max_batch_size,
+                                   const long delay,
+                                   const DNSClient::Protocol proto,
+                                   const DNSConnectionPoolPtr& pool)
+    : max_batch_size_(max_batch_size), delay_(delay), proto_(proto),
+      max_message_size_(proto == DNSClient::TCP ? MAX_TCP_MESSAGE_SIZE :
+                        MAX_UDP_MESSAGE_SIZE),
+      pool_(pool), pending_(), mutex_() {
+    if (max_batch_size_ < 2) {
+        isc_throw(BadValue, "DNSUpdateBatcher: maximum batch size must be"
+                  " larger than 1");
+    }
+
+    if (delay_ < 0) {
+        isc_throw(BadValue, "DNSUpdateBatcher: delay cannot be negative");
+    }
+}
+
+DNSUpdateBatcher::~DNSUpdateBatcher() {
+}
+
+bool
+DNSUpdateBatcher::canBatch(const D2UpdateMessage& request) {
+    // The RR counts can't be used: prerequisites such as "name is not in
+    // use" are RRsets without RDATA which are not counted.
+    return (request.getZone() &&
+            (request.beginSection(D2UpdateMessage::SECTION_PREREQUISITE) ==
+             request.endSection(D2UpdateMessage::SECTION_PREREQUISITE)) &&
+            (request.beginSection(D2UpdateMessage::SECTION_ADDITIONAL) ==
+             request.endSection(D2UpdateMessage::SECTION_ADDITIONAL)));
+}
+
+size_t
+DNSUpdateBatcher::getUpdateSize(const D2UpdateMessage& request) {
+    MessageRenderer renderer;
+    renderer.setLengthLimit(MAX_TCP_MESSAGE_SIZE);
+    for (auto it = request.beginSection(D2UpdateMessage::SECTION_UPDATE);
+         it != request.endSection(D2UpdateMessage::SECTION_UPDATE); ++it) {
+        (*it)->toWire(renderer);
+    }
+
+    return (renderer.getLength());
+}
+
+void
+DNSUpdateBatcher::doUpdate(const IOServicePtr& io_service,
+                           const IOAddress& ns_addr,
+                           const uint16_t ns_port,
+                           const D2UpdateMessagePtr& request,
+                           const unsigned int wait,
+                           const D2TsigKeyPtr& tsig_key,
+                           const UpdateHandler& handler) {
+    if (!request || !canBatch(*request)) {
+        isc_throw(BadValue, "DNSUpdateBatcher: the DNS update cannot be"
+                  " batched");
+    }
+
+    // Updates can be merged when they go to the same server, for the same
+    // zone and with the same key.
+    std::ostringstream key;
+    key << ns_addr.toText() << "#" << ns_port << "#"
+        << request->getZone()->getName().toText() << "#"
+        << (tsig_key ? tsig_key->getKeyName().toText() : "");
+
+    BatchedUpdate update = { io_service, request, handler };
+    size_t update_size = getUpdateSize(*request);
+    DNSUpdateBatchPtr batch;
+    DNSUpdateBatchPtr previous;
+    bool full = false;
+    bool created = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto pos = pending_.find(key.str());
+        if ((pos != pending_.end()) &&
+            (pos->second->getWireSize() + update_size > max_message_size_)) {
+            // The update does not fit in the message of the open batch:
+            // send the batch and start a new one.
+            previous = pos->second;
+            pending_.erase(pos);
+            pos = pending_.end();
+        }
+
+        if (pos == pending_.end()) {
+            batch.reset(new DNSUpdateBatch(io_service, ns_addr, ns_port, wait,
+                                           tsig_key, proto_, pool_,
+                                           getBaseSize(*request, tsig_key)));
+            pending_[key.str()] = batch;
+            created = true;
+        } else {
+            batch = pos->second;
+        }
+
+        batch->addUpdate(update, update_size);
+        if (batch->getUpdateCount() >= max_batch_size_) {
+            pending_.erase(key.str());
+            full = true;
+        }
+    }
+
+    if (previous) {
+        previous->getIOService()->post([previous]() { previous->send(); });
+    }
+
+    if (full) {
+        batch->getIOService()->post([batch]() { batch->send(); });
+        return;
+    }
+
+    if (!created) {
+        return;
+    }
+
+    // Arm the flush of the new batch.  The batcher may be destroyed before
+    // the batch is sent, in which case the batch is still sent.
+    boost::weak_ptr<DNSUpdateBatcher> weak_batcher(shared_from_this());
+    std::string batch_key = key.str();
+    auto flush_batch = [weak_batcher, batch_key, batch]() {
+        DNSUpdateBatcherPtr batcher = weak_batcher.lock();
+        if (batcher) {
+            batcher->flush(batch_key, batch);
+        } else {
+            batch->send();
+        }
+    };
+
+    if (delay_ == 0) {
+        io_service->post(flush_batch);
+        return;
+    }
+
+    // The handler holds the timer until it expires.
+    auto timer = boost::make_shared<boost::asio::deadline_timer>(
+        io_service->get_io_service(), boost::posix_time::milliseconds(delay_));
+    timer->async_wait([timer, flush_batch](const boost::system::error_code&) {
+        flush_batch();
+    });
+}
+
+size_t
+DNSUpdateBatcher::getBaseSize(const D2UpdateMessage& request,
+                              const D2TsigKeyPtr& tsig_key) {
+    // Header, zone section and TSIG record if any.
+    size_t size = 12 + request.getZone()->getName().getLength() + 4;
+    if (tsig_key) {
+        size += tsig_key->createContext()->getTSIGLength();
+    }
+
+    return (size);
+}
+
+void
+DNSUpdateBatcher::flush(const std::string& key, const DNSUpdateBatchPtr& batch) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto pos = pending_.find(key);
+        if ((pos == pending_.end()) || (pos->second != batch)) {
+            // Already sent because it became full.
+            return;
+        }
+
+        pending_.erase(pos);
+    }
+
+    batch->send();
+}
+
+size_t
+DNSUpdateBatcher::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto const& it : pending_) {
+        count += it.second->getUpdateCount();
+    }
+
+    return (count);
+}
+
+} // namespace isc::d2
+} // namespace isc
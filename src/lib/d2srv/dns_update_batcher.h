@@ -0,0 +1,213 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef DNS_UPDATE_BATCHER_H
+#define DNS_UPDATE_BATCHER_H
+
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
+#include <d2srv/d2_tsig_key.h>
+#include <d2srv/d2_update_message.h>
+#include <d2srv/dns_client.h>
+
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace isc {
+namespace d2 {
+
+class DNSUpdateBatcher;
+
+/// @brief Defines a pointer to a DNSUpdateBatcher instance.
+typedef boost::shared_ptr<DNSUpdateBatcher> DNSUpdateBatcherPtr;
+
+/// @brief A batch of DNS updates sent in a single message (implementation
+/// in the source file).
+class DNSUpdateBatch;
+
+/// @brief Defines a pointer to a DNSUpdateBatch instance.
+typedef boost::shared_ptr<DNSUpdateBatch> DNSUpdateBatchPtr;
+
+/// @brief Coalesces DNS updates sent to the same zone and server.
+///
+/// Instead of sending its DNS update directly with its own @c DNSClient, a
+/// transaction may hand it over to the batcher. Updates destined to the same
+/// server, for the same zone and protected by the same TSIG key are gathered
+/// into a batch which is sent as a single DNS UPDATE message carrying the
+/// RRsets of all the update sections.  The response (or error status) is
+/// then delivered to each of the original senders.
+///
+/// A batch is sent when it holds the maximum number of updates, when the
+/// next update would make its message larger than the transport allows
+/// (512 bytes over UDP as D2 does not use EDNS0, 65535 bytes over TCP) or
+/// once the batching delay, counted from the first update of the batch, has
+/// elapsed.
+/// With a delay of zero the batch is sent as soon as the IOService which
+/// received its first update runs ready handlers, which coalesces the updates
+/// produced by a single pass of the update manager.
+///
+/// Only updates without prerequisites are batched: per RFC 2136 the
+/// prerequisites of a message apply to the whole of it, so an update which
+/// depends on them must be sent on its own.  When a batch is rejected by the
+/// server, its updates are resent individually so a single faulty update
+/// does not cause the others to fail.
+///
+/// The batcher is thread safe: updates may be submitted by transactions run
+/// by different IOServices, the handler of each update being invoked by the
+/// IOService which submitted it.
+class DNSUpdateBatcher : public boost::enable_shared_from_this<DNSUpdateBatcher>,
+                         public boost::noncopyable {
+public:
+    /// @brief Maximum size of a DNS message sent over UDP without EDNS0.
+    static const size_t MAX_UDP_MESSAGE_SIZE = 512;
+
+    /// @brief Maximum size of a DNS message sent over TCP.
+    static const size_t MAX_TCP_MESSAGE_SIZE = 65535;
+
+    /// @brief Handler invoked when an update exchange completes.
+    ///
+    /// The first argument is the status of the exchange, the second is the
+    /// response received from the server (empty unless the status is
+    /// @c DNSClient::SUCCESS).
+    typedef std::function<void(DNSClient::Status,
+                               const D2UpdateMessagePtr&)> UpdateHandler;
+
+    /// @brief Constructor
+    ///
+    /// @param max_batch_size the maximum number of updates sent in a single
+    /// message.
+    /// @param delay the maximum time in milliseconds an update waits for
+    /// others to join its batch.
+    /// @param proto the transport protocol used to send the batches.
+    /// @param pool the pool of persistent connections used to send the
+    /// batches (may be null).
+    ///
+    /// @throw BadValue if the maximum batch size is less than 2.
+    DNSUpdateBatcher(const size_t max_batch_size, const long delay,
+                     const DNSClient::Protocol proto = DNSClient::UDP,
+                     const DNSConnectionPoolPtr& pool = DNSConnectionPoolPtr());
+
+    /// @brief Destructor
+    ~DNSUpdateBatcher();
+
+    /// @brief Checks if a DNS update may be batched.
+    ///
+    /// @param request the DNS update to check
+    ///
+    /// @return true if the update has a zone, no prerequisites and no
+    /// additional data.
+    static bool canBatch(const D2UpdateMessage& request);
+
+    /// @brief Returns the wire size of the update section of a DNS update.
+    ///
+    /// Names are not compressed across updates, so the size of the update
+    /// sections of a batch is at most the sum of the sizes of its updates.
+    ///
+    /// @param request the DNS update
+    ///
+    /// @return the size in bytes of the update section once rendered.
+    static size_t getUpdateSize(const D2UpdateMessage& request);
+
+    /// @brief Queues a DNS update for sending.
+    ///
+    /// @param io_service IOService of the caller which will invoke the
+    /// handler
+    /// @param ns_addr the address of the DNS server
+    /// @param ns_port the port of the DNS server
+    /// @param request the DNS update, see @ref canBatch
+    /// @param wait the timeout (in milliseconds) of the exchange
+    /// @param tsig_key the TSIG key used to sign the update (may be empty)
+    /// @param handler the handler invoked when the exchange completes
+    ///
+    /// @throw BadValue if the update cannot be batched.
+    void doUpdate(const asiolink::IOServicePtr& io_service,
+                  const asiolink::IOAddress& ns_addr,
+                  const uint16_t ns_port,
+                  const D2UpdateMessagePtr& request,
+                  const unsigned int wait,
+                  const D2TsigKeyPtr& tsig_key,
+                  const UpdateHandler& handler);
+
+    /// @brief Returns the maximum number of updates sent in a single message.
+    size_t getMaxBatchSize() const {
+        return (max_batch_size_);
+    }
+
+    /// @brief Returns the batching delay in milliseconds.
+    long getDelay() const {
+        return (delay_);
+    }
+
+    /// @brief Returns the transport protocol used to send the batches.
+    DNSClient::Protocol getProtocol() const {
+        return (proto_);
+    }
+
+    /// @brief Returns the pool of persistent connections (may be null).
+    const DNSConnectionPoolPtr& getConnectionPool() const {
+        return (pool_);
+    }
+
+    /// @brief Returns the maximum size of the message of a batch.
+    size_t getMaxMessageSize() const {
+        return (max_message_size_);
+    }
+
+    /// @brief Returns the number of updates waiting in open batches.
+    size_t getPendingCount() const;
+
+private:
+    /// @brief Returns the size of the message of a batch without update
+    /// section.
+    ///
+    /// @param request the first DNS update of the batch
+    /// @param tsig_key the TSIG key used to sign the message (may be empty)
+    ///
+    /// @return the size in bytes of the header, of the zone section and
+    /// of the TSIG record.
+    static size_t getBaseSize(const D2UpdateMessage& request,
+                              const D2TsigKeyPtr& tsig_key);
+
+    /// @brief Sends a batch if it is still open.
+    ///
+    /// Invoked when the batching delay of the batch has elapsed.
+    ///
+    /// @param key the key of the batch
+    /// @param batch the batch to send
+    void flush(const std::string& key, const DNSUpdateBatchPtr& batch);
+
+    /// @brief Maximum number of updates sent in a single message.
+    size_t max_batch_size_;
+
+    /// @brief Batching delay in milliseconds.
+    long delay_;
+
+    /// @brief Transport protocol used to send the batches.
+    DNSClient::Protocol proto_;
+
+    /// @brief Maximum size of the message of a batch.
+    size_t max_message_size_;
+
+    /// @brief Pool of persistent connections (may be null).
+    DNSConnectionPoolPtr pool_;
+
+    /// @brief Open batches by server, zone and TSIG key.
+    std::map<std::string, DNSUpdateBatchPtr> pending_;
+
+    /// @brief Mutex protecting the open batches.
+    mutable std::mutex mutex_;
+};
+
+} // namespace isc::d2
+} // namespace isc
+
+#endif // DNS_UPDATE_BATCHER_H
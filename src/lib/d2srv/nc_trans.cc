@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,10 +12,12 @@
 #include <dns/rdata.h>
 #include <hooks/hooks.h>
 #include <hooks/hooks_manager.h>
+#include <stats/stats_mgr.h>
 
 #include <sstream>
 
 using namespace isc::hooks;
+using namespace isc::stats;
 using namespace isc::util;
 
 namespace {
@@ -75,7 +77,9 @@ NameChangeTransaction(asiolink::IOServicePtr& io_service,
      dns_update_status_(DNSClient::OTHER), dns_update_response_(),
      forward_change_completed_(false), reverse_change_completed_(false),
      current_server_list_(), current_server_(), next_server_pos_(0),
-     update_attempts_(0), cfg_mgr_(cfg_mgr), tsig_key_() {
+     update_attempts_(0), cfg_mgr_(cfg_mgr), tsig_key_(), start_time_(),
+     completion_handler_(), update_batcher_(), dns_protocol_(DNSClient::UDP),
+     connection_pool_() {
     /// @todo if io_service is NULL we are multi-threading and should
     /// instantiate our own
     if (!io_service_) {
@@ -113,7 +117,9 @@ NameChangeTransaction::startTransaction() {
               .arg(getRequestId());
 
     setNcrStatus(dhcp_ddns::ST_PENDING);
+    start_time_ = std::chrono::steady_clock::now();
     startModel(READY_ST);
+    checkTransactionDone();
 }
 
 void
@@ -130,6 +136,26 @@ NameChangeTransaction::operator()(DNSClient::Status status) {
               .arg(responseString());
 
     runModel(IO_COMPLETED_EVT);
+    checkTransactionDone();
+}
+
+void
+NameChangeTransaction::checkTransactionDone() {
+    if (!isModelDone()) {
+        return;
+    }
+
+    // Record how long it took to carry out the request.
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now() - start_time_);
+    StatsMgr::instance().addValue("ncr-transaction-time",
+                                  static_cast<int64_t>(elapsed.count()));
+    StatsMgr::instance().addValue("ncr-transaction-count",
+                                  static_cast<int64_t>(1));
+
+    if (completion_handler_) {
+        completion_handler_();
+    }
 }
 
 std::string
@@ -197,9 +223,31 @@ NameChangeTransaction::sendUpdate(const std::string& comment) {
         // for the current server.  If not we would need to add that.
 
         D2ParamsPtr d2_params = cfg_mgr_->getD2Params();
-        dns_client_->doUpdate(*io_service_, current_server_->getIpAddress(),
-                              current_server_->getPort(), *dns_update_request_,
-                              d2_params->getDnsServerTimeout(), tsig_key_);
+        if (update_batcher_ &&
+            DNSUpdateBatcher::canBatch(*dns_update_request_)) {
+            // The batcher delivers the response through the same path as
+            // the DNSClient does, unless the transaction is gone.
+            boost::weak_ptr<NameChangeTransaction> weak_trans(shared_from_this());
+            update_batcher_->doUpdate(io_service_,
+                                      current_server_->getIpAddress(),
+                                      current_server_->getPort(),
+                                      dns_update_request_,
+                                      d2_params->getDnsServerTimeout(),
+                                      tsig_key_,
+                [weak_trans](DNSClient::Status status,
+                             const D2UpdateMessagePtr& response) {
+                    NameChangeTransactionPtr trans = weak_trans.lock();
+                    if (trans) {
+                        trans->dns_update_response_ = response;
+                        (*trans)(status);
+                    }
+                });
+        } else {
+            dns_client_->doUpdate(io_service_, current_server_->getIpAddress(),
+                                  current_server_->getPort(),
+                                  *dns_update_request_,
+                                  d2_params->getDnsServerTimeout(), tsig_key_);
+        }
         // Message is on its way, so the next event should be NOP_EVT.
         postNextEvent(NOP_EVT);
         LOG_DEBUG(d2_to_dns_logger, isc::log::DBGLVL_TRACE_DETAIL,
@@ -478,12 +526,9 @@ NameChangeTransaction::selectNextServer() {
                 continue;
             }
 
-            // @todo Protocol is set on DNSClient constructor. We need
-            // to propagate a configuration value downward, probably starting
-            // at global, then domain, finishing by server.
-            // Once that is supported we need to add it here.
+            // The protocol is a global setting, see setDnsTransport.
             dns_client_.reset(new DNSClient(dns_update_response_, this,
-                                            DNSClient::UDP));
+                                            dns_protocol_, connection_pool_));
             ++next_server_pos_;
             return (true);
         }
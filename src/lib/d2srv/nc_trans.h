@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,13 +11,17 @@
 
 #include <asiolink/io_service.h>
 #include <d2srv/dns_client.h>
+#include <d2srv/dns_update_batcher.h>
 #include <d2srv/d2_cfg_mgr.h>
 #include <d2srv/d2_tsig_key.h>
 #include <dhcp_ddns/ncr_msg.h>
 #include <exceptions/exceptions.h>
 #include <util/state_model.h>
 
+#include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
+#include <chrono>
+#include <functional>
 #include <map>
 
 namespace isc {
@@ -74,7 +78,13 @@ typedef isc::dhcp_ddns::D2Dhcid TransactionKey;
 /// as needed, but it must support the common set.  NameChangeTransaction
 /// does not supply any state handlers.  These are the sole responsibility of
 /// derivations.
-class NameChangeTransaction : public DNSClient::Callback, public util::StateModel {
+///
+/// Transactions must be owned by a @c NameChangeTransactionPtr: the handler
+/// given to the update batcher refers to the transaction through a weak
+/// pointer, so a transaction destroyed before its batch is answered is not
+/// called back.
+class NameChangeTransaction : public DNSClient::Callback, public util::StateModel,
+    public boost::enable_shared_from_this<NameChangeTransaction> {
 public:
 
     //@{ States common to all transactions.
@@ -172,6 +182,10 @@ public:
                           DdnsDomainPtr& reverse_domain,
                           D2CfgMgrPtr& cfg_mgr);
 
+    /// @brief Defines the type of the handler invoked when the transaction
+    /// completes.
+    typedef std::function<void()> CompletionHandler;
+
     /// @brief Destructor
     virtual ~NameChangeTransaction();
 
@@ -182,6 +196,45 @@ public:
     /// with the state handler for READY_ST.
     void startTransaction();
 
+    /// @brief Sets the handler invoked when the transaction completes.
+    ///
+    /// The handler is invoked by the thread running the transaction's
+    /// IOService, once the state model has reached its end.  It allows
+    /// the owner of a transaction run by another thread to learn that the
+    /// transaction can be discarded.
+    ///
+    /// @param handler the handler to invoke, an empty handler disables
+    /// the notification.
+    void setCompletionHandler(const CompletionHandler& handler) {
+        completion_handler_ = handler;
+    }
+
+    /// @brief Sets the batcher used to send DNS updates.
+    ///
+    /// When set, DNS updates which have no prerequisites are sent through
+    /// the batcher, which may combine them with the updates of other
+    /// transactions for the same zone and server.
+    ///
+    /// @param batcher the batcher to use, an empty pointer makes each
+    /// update be sent on its own.
+    void setUpdateBatcher(const DNSUpdateBatcherPtr& batcher) {
+        update_batcher_ = batcher;
+    }
+
+    /// @brief Sets the transport used to send DNS updates.
+    ///
+    /// Takes effect for the DNSClient created when selecting the next
+    /// server.
+    ///
+    /// @param proto the transport protocol
+    /// @param pool the pool of persistent connections to use, an empty
+    /// pointer makes each update be sent using a new socket.
+    void setDnsTransport(const DNSClient::Protocol proto,
+                         const DNSConnectionPoolPtr& pool) {
+        dns_protocol_ = proto;
+        connection_pool_ = pool;
+    }
+
     /// @brief Serves as the DNSClient IO completion event handler.
     ///
     /// This is the implementation of the method inherited by our derivation
@@ -534,6 +587,13 @@ public:
     const dns::RRType& getAddressRRType() const;
 
 private:
+    /// @brief Performs the completion steps once the model has ended.
+    ///
+    /// If the state model is done, the time taken to carry out the request
+    /// is added to the ncr-transaction-time statistic, ncr-transaction-count
+    /// is incremented and the completion handler (if any) is invoked.  Otherwise this method does nothing.
+    void checkTransactionDone();
+
     /// @brief The IOService which should be used to for IO processing.
     asiolink::IOServicePtr io_service_;
 
@@ -592,6 +652,21 @@ private:
 
     /// @brief Pointer to the TSIG key which should be used (if any).
     D2TsigKeyPtr tsig_key_;
+
+    /// @brief Time at which the transaction was started.
+    std::chrono::steady_clock::time_point start_time_;
+
+    /// @brief Handler invoked when the transaction completes.
+    CompletionHandler completion_handler_;
+
+    /// @brief Batcher used to send DNS updates (if any).
+    DNSUpdateBatcherPtr update_batcher_;
+
+    /// @brief Transport protocol used to send DNS updates.
+    DNSClient::Protocol dns_protocol_;
+
+    /// @brief Pool of persistent connections to the DNS servers (if any).
+    DNSConnectionPoolPtr connection_pool_;
 };
 
 /// @brief Defines a pointer to a NameChangeTransaction.
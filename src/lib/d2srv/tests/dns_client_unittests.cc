@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -60,7 +60,7 @@ class DNSClientTest : public ::testing::Test, DNSClient::Callback,
                       public D2StatTest {
 public:
     /// @brief The IOService which handles IO operations.
-    IOService service_;
+    IOServicePtr service_;
 
     /// @brief The UDP socket.
     std::unique_ptr<udp::socket> socket_;
@@ -107,9 +107,9 @@ public:
     /// waiting for a response. Some of the tests are checking DNSClient behavior
     /// in case when response from the server is not received. Tests output would
     /// become messy if such errors were logged.
-    DNSClientTest() : service_(), socket_(), endpoint_(),
+    DNSClientTest() : service_(new IOService()), socket_(), endpoint_(),
                       status_(DNSClient::SUCCESS), corrupt_response_(false),
-                      expect_response_(true), test_timer_(service_),
+                      expect_response_(true), test_timer_(*service_),
                       received_(0), expected_(0), go_on_(false) {
         asiodns::logger.setSeverity(isc::log::INFO);
         response_.reset();
@@ -127,6 +127,14 @@ public:
         asiodns::logger.setSeverity(isc::log::DEBUG);
     };
 
+    /// @brief Makes the DNS client send its updates over persistent
+    /// connections.
+    ///
+    /// @param pool the pool of persistent connections
+    void setConnectionPool(const DNSConnectionPoolPtr& pool) {
+        dns_client_.reset(new DNSClient(response_, this, DNSClient::UDP, pool));
+    }
+
     /// @brief Exchange completion callback
     ///
     /// This callback is called when the exchange with the DNS server is
@@ -136,7 +144,7 @@ public:
     virtual void operator()(DNSClient::Status status) {
         status_ = status;
         if (!expected_ || (expected_ == ++received_)) {
-            service_.stop();
+            service_->stop();
         }
 
         if (expect_response_) {
@@ -168,7 +176,7 @@ public:
     ///
     /// This callback stops all running (hanging) tasks on IO service.
     void testTimeoutHandler() {
-        service_.stop();
+        service_->stop();
         FAIL() << "Test timeout hit.";
     }
 
@@ -300,12 +308,13 @@ public:
     /// callback object is NULL.
     void runConstructorTest() {
         EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::UDP));
+        EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::TCP));
 
-        // The TCP Transport is not supported right now. So, we return exception
-        // if caller specified TCP as a preferred protocol. This test will be
-        // removed once TCP is supported.
-        EXPECT_THROW(DNSClient(response_, NULL, DNSClient::TCP),
-                     isc::NotImplemented);
+        // The protocol of the connection pool must match.
+        DNSConnectionPoolPtr pool(new DNSConnectionPool(DNSConnectionPool::UDP));
+        EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::UDP, pool));
+        EXPECT_THROW(DNSClient(response_, NULL, DNSClient::TCP, pool),
+                     isc::BadValue);
     }
 
     /// @brief This test verifies that it accepted timeout values belong to the
@@ -368,7 +377,7 @@ public:
 
         // This starts the execution of tasks posted to IOService. run() blocks
         // until stop() is called in the completion callback function.
-        service_.run();
+        service_->run();
 
     }
 
@@ -393,7 +402,7 @@ public:
         // responses. The reuse address option is set so as both sockets can
         // use the same address. This new socket is bound to the test address
         // and port, where requests will be sent.
-        socket_.reset(new udp::socket(service_.get_io_service(),
+        socket_.reset(new udp::socket(service_->get_io_service(),
                                       boost::asio::ip::udp::v4()));
         socket_->set_option(socket_base::reuse_address(true));
         socket_->bind(udp::endpoint(address::from_string(TEST_ADDRESS),
@@ -438,14 +447,14 @@ public:
 
         // Kick of the message exchange by actually running the scheduled
         // "send" and "receive" operations.
-        service_.run();
+        service_->run();
 
         socket_->close();
 
         // Since the callback, operator(), calls stop() on the io_service,
         // we must reset it in order for subsequent calls to run() or
         // run_one() to work.
-        service_.get_io_service().reset();
+        service_->get_io_service().reset();
     }
 
     /// @brief Performs a single request-response exchange with or without TSIG.
@@ -466,7 +475,7 @@ public:
         ASSERT_NO_THROW(message.setZone(Name("example.com"), RRClass::IN()));
 
         // Setup our "loopback" server.
-        udp::socket udp_socket(service_.get_io_service(), boost::asio::ip::udp::v4());
+        udp::socket udp_socket(service_->get_io_service(), boost::asio::ip::udp::v4());
         udp_socket.set_option(socket_base::reuse_address(true));
         udp_socket.bind(udp::endpoint(address::from_string(TEST_ADDRESS),
                                       TEST_PORT));
@@ -490,14 +499,14 @@ public:
 
         // Kick of the message exchange by actually running the scheduled
         // "send" and "receive" operations.
-        service_.run();
+        service_->run();
 
         udp_socket.close();
 
         // Since the callback, operator(), calls stop() on the io_service,
         // we must reset it in order for subsequent calls to run() or
         // run_one() to work.
-        service_.get_io_service().reset();
+        service_->get_io_service().reset();
     }
 };
 
@@ -675,4 +684,32 @@ TEST_F(DNSClientTest, concurrentSendReceive) {
     checkStats(stats_upd);
 }
 
+// Verify that the DNSClient can send its updates over a persistent
+// connection and that the latency to the server is recorded.
+TEST_F(DNSClientTest, sendReceivePersistent) {
+    DNSConnectionPoolPtr pool(new DNSConnectionPool(DNSConnectionPool::UDP));
+    setConnectionPool(pool);
+    runSendReceiveTest(false, false);
+    runSendReceiveTest(false, false);
+    EXPECT_EQ(2, received_);
+    EXPECT_EQ(DNSClient::SUCCESS, status_);
+
+    // Both updates were sent over the same socket.
+    EXPECT_EQ(1, pool->getConnectionCount());
+    StatMap stats_upd = {
+        { "update-sent", 2},
+        { "update-unsigned", 2},
+        { "update-success", 2},
+        { "update-timeout", 0},
+        { "update-error", 0}
+    };
+    checkStats(stats_upd);
+    EXPECT_TRUE(StatsMgr::instance().getObservation(
+                    "server[127.0.0.1].update-latency"));
+    ObservationPtr count = StatsMgr::instance().getObservation(
+        "server[127.0.0.1].update-latency-count");
+    ASSERT_TRUE(count);
+    EXPECT_EQ(2, count->getInteger().first);
+}
+
 } // End of anonymous namespace
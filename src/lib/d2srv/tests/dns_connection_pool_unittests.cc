@@ -0,0 +1,405 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/asio_wrapper.h>
+#include <asiolink/io_address.h>
+#include <d2srv/d2_update_message.h>
+#include <d2srv/dns_connection_pool.h>
+#include <d2srv/testutils/nc_test_utils.h>
+#include <dns/messagerenderer.h>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::d2;
+using namespace isc::dns;
+using namespace isc::util;
+namespace ip = boost::asio::ip;
+
+namespace {
+
+/// @brief Address of the test DNS server.
+const char* TEST_ADDRESS = "127.0.0.1";
+
+/// @brief Port of the test DNS server.
+const uint16_t TEST_PORT = 5383;
+
+/// @brief Minimal DNS server over UDP echoing the messages it receives.
+///
+/// Sends back each message with the QR bit set, so the responses carry the
+/// query ID and the zone of the requests, and records the ports the
+/// messages were sent from.
+class UdpEchoServer {
+public:
+    /// @brief Constructor
+    ///
+    /// @param io_service IOService running the server
+    UdpEchoServer(IOService& io_service)
+        : socket_(io_service.get_io_service(),
+                  ip::udp::endpoint(ip::address::from_string(TEST_ADDRESS),
+                                    TEST_PORT)),
+          remote_(), message_(65535), ports_(), other_zone_(false) {
+        receive();
+    }
+
+    /// @brief Receives a message and echoes it.
+    void receive() {
+        socket_.async_receive_from(boost::asio::buffer(message_), remote_,
+                                   [this](const boost::system::error_code& ec,
+                                          size_t length) {
+            if (ec) {
+                return;
+            }
+            ports_.insert(remote_.port());
+            std::vector<uint8_t> response(message_.begin(),
+                                          message_.begin() + length);
+            // Set the QR bit.
+            response[2] |= 0x80;
+            if (other_zone_) {
+                // Changes the first letter of the zone name.
+                ++response[13];
+            }
+            socket_.send_to(boost::asio::buffer(response), remote_);
+            receive();
+        });
+    }
+
+    /// @brief The socket.
+    ip::udp::socket socket_;
+
+    /// @brief The sender of the current message.
+    ip::udp::endpoint remote_;
+
+    /// @brief The current message.
+    std::vector<uint8_t> message_;
+
+    /// @brief The ports the messages were sent from.
+    std::set<uint16_t> ports_;
+
+    /// @brief When true the responses are for another zone.
+    bool other_zone_;
+};
+
+/// @brief Minimal DNS server over TCP echoing the messages it receives.
+///
+/// Accepts a single connection and sends back each message with the QR bit
+/// set as soon as it has been received, so the responses carry the query ID
+/// and the zone of the requests.
+class TcpEchoServer {
+public:
+    /// @brief Constructor
+    ///
+    /// @param io_service IOService running the server
+    TcpEchoServer(IOService& io_service)
+        : acceptor_(io_service.get_io_service(),
+                    ip::tcp::endpoint(ip::address::from_string(TEST_ADDRESS),
+                                      TEST_PORT)),
+          socket_(io_service.get_io_service()), accepted_(0), length_(),
+          message_() {
+        acceptor_.async_accept(socket_,
+                               [this](const boost::system::error_code& ec) {
+            if (!ec) {
+                ++accepted_;
+                readLength();
+            }
+        });
+    }
+
+    /// @brief Reads the length of the next message.
+    void readLength() {
+        boost::asio::async_read(socket_, boost::asio::buffer(length_),
+                                [this](const boost::system::error_code& ec,
+                                       size_t) {
+            if (!ec) {
+                message_.resize((length_[0] << 8) | length_[1]);
+                readMessage();
+            }
+        });
+    }
+
+    /// @brief Reads a message and echoes it.
+    void readMessage() {
+        boost::asio::async_read(socket_, boost::asio::buffer(message_),
+                                [this](const boost::system::error_code& ec,
+                                       size_t) {
+            if (ec) {
+                return;
+            }
+            std::vector<uint8_t> response(length_, length_ + 2);
+            response.insert(response.end(), message_.begin(), message_.end());
+            // Set the QR bit.
+            response[4] |= 0x80;
+            boost::asio::write(socket_, boost::asio::buffer(response));
+            readLength();
+        });
+    }
+
+    /// @brief The acceptor.
+    ip::tcp::acceptor acceptor_;
+
+    /// @brief The accepted connection.
+    ip::tcp::socket socket_;
+
+    /// @brief Number of accepted connections.
+    size_t accepted_;
+
+    /// @brief The length of the current message.
+    uint8_t length_[2];
+
+    /// @brief The current message.
+    std::vector<uint8_t> message_;
+};
+
+/// @brief Test fixture for testing DNSConnectionPool.
+class DNSConnectionPoolTest : public TimedIO, public ::testing::Test {
+public:
+    /// @brief Constructor
+    DNSConnectionPoolTest()
+        : server_address_(TEST_ADDRESS), results_(), responses_() {
+    }
+
+    /// @brief Creates a DNS update in wire format.
+    ///
+    /// @param qid the query ID of the update
+    ///
+    /// @return the DNS update.
+    OutputBufferPtr makeRequest(const uint16_t qid) {
+        D2UpdateMessage request(D2UpdateMessage::OUTBOUND);
+        request.setId(qid);
+        request.setZone(Name("example.com."), RRClass::IN());
+        MessageRenderer renderer;
+        OutputBufferPtr buffer(new OutputBuffer(128));
+        renderer.setBuffer(buffer.get());
+        request.toWire(renderer);
+        renderer.setBuffer(NULL);
+        return (buffer);
+    }
+
+    /// @brief Returns a handler recording the exchange outcome.
+    DNSExchange::Handler makeHandler() {
+        return ([this](DNSExchange::Result result,
+                       const OutputBufferPtr& response) {
+            results_.push_back(result);
+            responses_.push_back(response);
+        });
+    }
+
+    /// @brief Runs IO until the given number of handlers were invoked.
+    ///
+    /// @param count the number of handlers to wait for
+    void runUntil(size_t count) {
+        size_t passes = 0;
+        while ((results_.size() < count) && (++passes < 100)) {
+            if (runTimedIO(1000) == 0) {
+                io_service_->restart();
+            }
+        }
+
+        ASSERT_EQ(count, results_.size());
+    }
+
+    /// @brief Returns the query ID of a response.
+    ///
+    /// @param response the response in wire format
+    uint16_t getQid(const OutputBufferPtr& response) {
+        return (((*response)[0] << 8) | (*response)[1]);
+    }
+
+    /// @brief The address of the test server.
+    IOAddress server_address_;
+
+    /// @brief The results received by the handlers.
+    std::vector<DNSExchange::Result> results_;
+
+    /// @brief The responses received by the handlers.
+    std::vector<OutputBufferPtr> responses_;
+};
+
+// Verifies that exchanges with a server over UDP share a single socket and
+// that the responses are delivered to the right exchange.
+TEST_F(DNSConnectionPoolTest, udp) {
+    FauxServer server(*io_service_, server_address_, TEST_PORT);
+    server.receive(FauxServer::USE_RCODE, Rcode::NOERROR());
+
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    EXPECT_EQ(DNSConnectionPool::UDP, pool.getProtocol());
+    DNSExchangePtr first = pool.send(io_service_, server_address_, TEST_PORT,
+                                     makeRequest(1), 1000, makeHandler());
+    ASSERT_TRUE(first);
+    DNSExchangePtr second = pool.send(io_service_, server_address_,
+                                      TEST_PORT, makeRequest(2), 1000,
+                                      makeHandler());
+    ASSERT_TRUE(second);
+
+    // The query ID of an exchange in progress can't be reused.
+    EXPECT_FALSE(pool.send(io_service_, server_address_, TEST_PORT,
+                           makeRequest(2), 1000, makeHandler()));
+    EXPECT_EQ(1, pool.getConnectionCount());
+
+    runUntil(2);
+    for (size_t i = 0; i < 2; ++i) {
+        EXPECT_EQ(DNSExchange::SUCCESS, results_[i]);
+        ASSERT_TRUE(responses_[i]);
+        EXPECT_EQ(i + 1, getQid(responses_[i]));
+    }
+
+    // The socket is kept for the next exchanges.
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(2), 1000, makeHandler()));
+    runUntil(3);
+    EXPECT_EQ(DNSExchange::SUCCESS, results_[2]);
+    EXPECT_EQ(1, pool.getConnectionCount());
+}
+
+// Verifies that the UDP socket is replaced after a number of exchanges, so
+// the requests are sent from another port.
+TEST_F(DNSConnectionPoolTest, udpRotation) {
+    UdpEchoServer server(*io_service_);
+
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    const size_t count = DNSConnectionPool::MAX_UDP_SOCKET_EXCHANGES + 1;
+    for (size_t qid = 1; qid <= count; ++qid) {
+        ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                              makeRequest(qid), 1000, makeHandler()));
+    }
+
+    // The exchanges in progress on the replaced socket still get their
+    // responses.
+    runUntil(count);
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(DNSExchange::SUCCESS, results_[i]);
+    }
+    EXPECT_EQ(2, server.ports_.size());
+    EXPECT_EQ(1, pool.getConnectionCount());
+}
+
+// Verifies that responses which do not match the request are dropped.
+TEST_F(DNSConnectionPoolTest, udpMismatch) {
+    UdpEchoServer server(*io_service_);
+    server.other_zone_ = true;
+
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(1), 100, makeHandler()));
+    runUntil(1);
+    EXPECT_EQ(DNSExchange::TIMEOUT, results_[0]);
+
+    // Responses for the zone of the request are delivered.
+    server.other_zone_ = false;
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(2), 1000, makeHandler()));
+    runUntil(2);
+    EXPECT_EQ(DNSExchange::SUCCESS, results_[1]);
+}
+
+// Verifies that an exchange times out when there is no response and that
+// a cancelled exchange does not invoke its handler.
+TEST_F(DNSConnectionPoolTest, timeout) {
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(1), 10, makeHandler()));
+    DNSExchangePtr cancelled = pool.send(io_service_, server_address_,
+                                         TEST_PORT, makeRequest(2), 10,
+                                         makeHandler());
+    ASSERT_TRUE(cancelled);
+    cancelled->cancel();
+
+    runUntil(1);
+    EXPECT_EQ(DNSExchange::TIMEOUT, results_[0]);
+    EXPECT_FALSE(responses_[0]);
+
+    // Give the cancelled exchange the time to expire.
+    runTimedIO(50);
+    EXPECT_EQ(1, results_.size());
+}
+
+// Verifies that exchanges in progress fail when the pool is cleared.
+TEST_F(DNSConnectionPoolTest, clear) {
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(1), 1000, makeHandler()));
+    pool.clear();
+    EXPECT_EQ(0, pool.getConnectionCount());
+
+    runUntil(1);
+    EXPECT_EQ(DNSExchange::FAILED, results_[0]);
+}
+
+// Verifies that the connections of a stopped IOService are closed at once
+// when the pool is cleared.
+TEST_F(DNSConnectionPoolTest, clearStopped) {
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(1), 1000, makeHandler()));
+    io_service_->stop();
+    pool.clear();
+    ASSERT_EQ(1, results_.size());
+    EXPECT_EQ(DNSExchange::FAILED, results_[0]);
+    io_service_->get_io_service().reset();
+}
+
+// Verifies that the pool holds the IOService of its connections until
+// they are discarded.
+TEST_F(DNSConnectionPoolTest, holdIOService) {
+    DNSConnectionPool pool(DNSConnectionPool::UDP);
+    IOServicePtr io_service(new IOService());
+    boost::weak_ptr<IOService> weak_io_service(io_service);
+    ASSERT_TRUE(pool.send(io_service, server_address_, TEST_PORT,
+                          makeRequest(1), 1000, makeHandler()));
+    io_service.reset();
+    EXPECT_FALSE(weak_io_service.expired());
+
+    // Another IOService gets its own connection.
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(1), 1000, makeHandler()));
+    EXPECT_EQ(2, pool.getConnectionCount());
+
+    pool.clear();
+    EXPECT_TRUE(weak_io_service.expired());
+    runUntil(1);
+    EXPECT_EQ(DNSExchange::FAILED, results_[0]);
+}
+
+// Verifies that requests over TCP are pipelined on a single connection.
+TEST_F(DNSConnectionPoolTest, tcp) {
+    TcpEchoServer server(*io_service_);
+
+    DNSConnectionPool pool(DNSConnectionPool::TCP);
+    for (uint16_t qid = 1; qid <= 3; ++qid) {
+        ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                              makeRequest(qid), 1000, makeHandler()));
+    }
+
+    runUntil(3);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(DNSExchange::SUCCESS, results_[i]);
+        ASSERT_TRUE(responses_[i]);
+        EXPECT_EQ(i + 1, getQid(responses_[i]));
+    }
+
+    // The connection is reused.
+    ASSERT_TRUE(pool.send(io_service_, server_address_, TEST_PORT,
+                          makeRequest(4), 1000, makeHandler()));
+    runUntil(4);
+    EXPECT_EQ(DNSExchange::SUCCESS, results_[3]);
+    EXPECT_EQ(1, server.accepted_);
+    EXPECT_EQ(1, pool.getConnectionCount());
+}
+
+}
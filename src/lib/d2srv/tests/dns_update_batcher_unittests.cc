@@ -0,0 +1,287 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <d2srv/dns_update_batcher.h>
+#include <d2srv/testutils/nc_test_utils.h>
+#include <d2srv/testutils/stats_test_utils.h>
+#include <dns/rcode.h>
+#include <dns/rdataclass.h>
+#include <dns/rrset.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::d2;
+using namespace isc::d2::test;
+using namespace isc::dns;
+
+namespace {
+
+/// @brief Address of the test DNS server.
+const char* TEST_ADDRESS = "127.0.0.1";
+
+/// @brief Port of the test DNS server.
+const uint16_t TEST_PORT = 5382;
+
+/// @brief Test fixture for testing DNSUpdateBatcher.
+class DNSUpdateBatcherTest : public TimedIO, public D2StatTest,
+                             public ::testing::Test {
+public:
+    /// @brief Constructor
+    DNSUpdateBatcherTest()
+        : server_address_(TEST_ADDRESS), statuses_(), responses_() {
+    }
+
+    /// @brief Creates a DNS update adding an A record.
+    ///
+    /// @param zone name of the zone
+    /// @param fqdn name to which the record is added
+    /// @param address the address of the record
+    ///
+    /// @return the DNS update.
+    D2UpdateMessagePtr makeUpdate(const std::string& zone,
+                                  const std::string& fqdn,
+                                  const std::string& address) {
+        D2UpdateMessagePtr request(new D2UpdateMessage(D2UpdateMessage::
+                                                       OUTBOUND));
+        request->setId(1234);
+        request->setZone(Name(zone), RRClass::IN());
+        RRsetPtr update(new RRset(Name(fqdn), RRClass::IN(), RRType::A(),
+                                  RRTTL(0)));
+        update->addRdata(rdata::ConstRdataPtr(new rdata::in::A(address)));
+        request->addRRset(D2UpdateMessage::SECTION_UPDATE, update);
+        return (request);
+    }
+
+    /// @brief Returns a handler recording the exchange outcome.
+    DNSUpdateBatcher::UpdateHandler makeHandler() {
+        return ([this](DNSClient::Status status,
+                       const D2UpdateMessagePtr& response) {
+            statuses_.push_back(status);
+            responses_.push_back(response);
+        });
+    }
+
+    /// @brief Runs IO until the given number of handlers were invoked.
+    ///
+    /// @param count the number of handlers to wait for
+    void runUntil(size_t count) {
+        size_t passes = 0;
+        while ((statuses_.size() < count) && (++passes < 100)) {
+            if (runTimedIO(1000) == 0) {
+                io_service_->restart();
+            }
+        }
+
+        ASSERT_EQ(count, statuses_.size());
+    }
+
+    /// @brief The address of the test server.
+    IOAddress server_address_;
+
+    /// @brief The statuses received by the handlers.
+    std::vector<DNSClient::Status> statuses_;
+
+    /// @brief The responses received by the handlers.
+    std::vector<D2UpdateMessagePtr> responses_;
+};
+
+// Verifies the construction parameters are checked.
+TEST_F(DNSUpdateBatcherTest, construction) {
+    DNSUpdateBatcherPtr batcher;
+    EXPECT_THROW(batcher.reset(new DNSUpdateBatcher(0, 0)), BadValue);
+    EXPECT_THROW(batcher.reset(new DNSUpdateBatcher(1, 0)), BadValue);
+    EXPECT_THROW(batcher.reset(new DNSUpdateBatcher(2, -1)), BadValue);
+    ASSERT_NO_THROW(batcher.reset(new DNSUpdateBatcher(8, 5)));
+    EXPECT_EQ(8, batcher->getMaxBatchSize());
+    EXPECT_EQ(5, batcher->getDelay());
+    EXPECT_EQ(0, batcher->getPendingCount());
+}
+
+// Verifies that only updates without prerequisites can be batched.
+TEST_F(DNSUpdateBatcherTest, canBatch) {
+    D2UpdateMessagePtr request = makeUpdate("example.com.",
+                                            "one.example.com.", "192.0.2.1");
+    EXPECT_TRUE(DNSUpdateBatcher::canBatch(*request));
+
+    // Add a prerequisite: name is not in use.
+    RRsetPtr prereq(new RRset(Name("one.example.com."), RRClass::NONE(),
+                              RRType::ANY(), RRTTL(0)));
+    request->addRRset(D2UpdateMessage::SECTION_PREREQUISITE, prereq);
+    EXPECT_FALSE(DNSUpdateBatcher::canBatch(*request));
+
+    DNSUpdateBatcherPtr batcher(new DNSUpdateBatcher(4, 0));
+    EXPECT_THROW(batcher->doUpdate(io_service_, server_address_, TEST_PORT,
+                                   request, 100, D2TsigKeyPtr(),
+                                   makeHandler()),
+                 BadValue);
+}
+
+// Verifies that updates for the same zone are sent in a single message
+// once the batch is full.
+TEST_F(DNSUpdateBatcherTest, fullBatch) {
+    FauxServer server(*io_service_, server_address_, TEST_PORT);
+    server.receive(FauxServer::USE_RCODE, Rcode::NOERROR());
+
+    DNSUpdateBatcherPtr batcher(new DNSUpdateBatcher(3, 10000));
+    const char* names[] = { "one.example.com.", "two.example.com.",
+                            "three.example.com." };
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_,
+                                          TEST_PORT,
+                                          makeUpdate("example.com.", names[i],
+                                                     "192.0.2.1"),
+                                          1000, D2TsigKeyPtr(),
+                                          makeHandler()));
+    }
+
+    // The batch is full so it is no longer pending.
+    EXPECT_EQ(0, batcher->getPendingCount());
+    runUntil(3);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(DNSClient::SUCCESS, statuses_[i]);
+        ASSERT_TRUE(responses_[i]);
+        EXPECT_EQ(Rcode::NOERROR(), responses_[i]->getRcode());
+    }
+
+    StatMap stats_upd = {
+        { "update-sent", 1},
+        { "update-success", 1}
+    };
+    checkStats(stats_upd);
+}
+
+// Verifies that updates for different zones are not combined and that
+// a batch is sent when the IOService runs with a delay of zero.
+TEST_F(DNSUpdateBatcherTest, zeroDelay) {
+    FauxServer server(*io_service_, server_address_, TEST_PORT);
+    server.receive(FauxServer::USE_RCODE, Rcode::NOERROR());
+
+    DNSUpdateBatcherPtr batcher(new DNSUpdateBatcher(10, 0));
+    ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_, TEST_PORT,
+                                      makeUpdate("example.com.",
+                                                 "one.example.com.",
+                                                 "192.0.2.1"),
+                                      1000, D2TsigKeyPtr(), makeHandler()));
+    ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_, TEST_PORT,
+                                      makeUpdate("example.com.",
+                                                 "two.example.com.",
+                                                 "192.0.2.2"),
+                                      1000, D2TsigKeyPtr(), makeHandler()));
+    ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_, TEST_PORT,
+                                      makeUpdate("example.org.",
+                                                 "one.example.org.",
+                                                 "192.0.2.3"),
+                                      1000, D2TsigKeyPtr(), makeHandler()));
+    EXPECT_EQ(3, batcher->getPendingCount());
+
+    runUntil(3);
+    EXPECT_EQ(0, batcher->getPendingCount());
+    for (auto const& status : statuses_) {
+        EXPECT_EQ(DNSClient::SUCCESS, status);
+    }
+
+    // One message per zone.
+    StatMap stats_upd = {
+        { "update-sent", 2},
+        { "update-success", 2}
+    };
+    checkStats(stats_upd);
+}
+
+// Verifies that a batch is sent before its message becomes larger than
+// a UDP message.
+TEST_F(DNSUpdateBatcherTest, messageSizeLimit) {
+    FauxServer server(*io_service_, server_address_, TEST_PORT);
+    server.receive(FauxServer::USE_RCODE, Rcode::NOERROR());
+
+    DNSUpdateBatcherPtr batcher(new DNSUpdateBatcher(100, 10000));
+    EXPECT_EQ(DNSUpdateBatcher::MAX_UDP_MESSAGE_SIZE,
+              batcher->getMaxMessageSize());
+
+    // Each update adds a name with a 60 character label.
+    const std::string label(60, 'a');
+    size_t update_size = 0;
+    size_t fit = 0;
+    for (size_t i = 0; ; ++i) {
+        std::ostringstream fqdn;
+        fqdn << label << i << ".example.com.";
+        D2UpdateMessagePtr request = makeUpdate("example.com.", fqdn.str(),
+                                                "192.0.2.1");
+        update_size = DNSUpdateBatcher::getUpdateSize(*request);
+        ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_,
+                                          TEST_PORT, request, 1000,
+                                          D2TsigKeyPtr(), makeHandler()));
+        if (batcher->getPendingCount() <= i) {
+            fit = i;
+            break;
+        }
+        ASSERT_LT(i, 100);
+    }
+
+    // The updates which fit in 512 bytes with the header and the zone
+    // section were sent, the last one waits in a new batch.
+    EXPECT_EQ(1, batcher->getPendingCount());
+    size_t base_size = 12 + Name("example.com.").getLength() + 4;
+    EXPECT_LE(base_size + fit * update_size,
+              DNSUpdateBatcher::MAX_UDP_MESSAGE_SIZE);
+    EXPECT_GT(base_size + (fit + 1) * update_size,
+              DNSUpdateBatcher::MAX_UDP_MESSAGE_SIZE);
+
+    runUntil(fit);
+    for (auto const& status : statuses_) {
+        EXPECT_EQ(DNSClient::SUCCESS, status);
+    }
+
+    StatMap stats_upd = {
+        { "update-sent", 1},
+        { "update-success", 1}
+    };
+    checkStats(stats_upd);
+}
+
+// Verifies that the updates of a rejected batch are resent individually.
+TEST_F(DNSUpdateBatcherTest, rejectedBatch) {
+    FauxServer server(*io_service_, server_address_, TEST_PORT);
+    server.receive(FauxServer::USE_RCODE, Rcode::REFUSED());
+
+    DNSUpdateBatcherPtr batcher(new DNSUpdateBatcher(2, 0));
+    ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_, TEST_PORT,
+                                      makeUpdate("example.com.",
+                                                 "one.example.com.",
+                                                 "192.0.2.1"),
+                                      1000, D2TsigKeyPtr(), makeHandler()));
+    ASSERT_NO_THROW(batcher->doUpdate(io_service_, server_address_, TEST_PORT,
+                                      makeUpdate("example.com.",
+                                                 "two.example.com.",
+                                                 "192.0.2.2"),
+                                      1000, D2TsigKeyPtr(), makeHandler()));
+
+    runUntil(2);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(DNSClient::SUCCESS, statuses_[i]);
+        ASSERT_TRUE(responses_[i]);
+        EXPECT_EQ(Rcode::REFUSED(), responses_[i]->getRcode());
+    }
+
+    // The batch and then each update on its own.
+    StatMap stats_upd = {
+        { "update-sent", 3},
+        { "update-success", 3}
+    };
+    checkStats(stats_upd);
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1038,7 +1038,7 @@ TEST_F(NameChangeTransactionTest, sendUpdate) {
     ASSERT_EQ(dns::Rcode::NOERROR().getCode(), response->getRcode().getCode());
     D2ZonePtr zone = response->getZone();
     EXPECT_TRUE(zone);
-    EXPECT_EQ("response.example.com.", zone->getName().toText());
+    EXPECT_EQ("request.example.com.", zone->getName().toText());
 }
 
 /// @brief Tests that an unsigned response to a signed request is an error
@@ -1130,7 +1130,7 @@ TEST_F(NameChangeTransactionTest, tsigUnexpectedSignedResponse) {
     ASSERT_EQ(dns::Rcode::NOERROR().getCode(), response->getRcode().getCode());
     D2ZonePtr zone = response->getZone();
     EXPECT_TRUE(zone);
-    EXPECT_EQ("response.example.com.", zone->getName().toText());
+    EXPECT_EQ("request.example.com.", zone->getName().toText());
 }
 
 /// @brief Tests that a TSIG update succeeds when client and server both use
@@ -1178,7 +1178,7 @@ TEST_F(NameChangeTransactionTest, tsigAllValid) {
                   response->getRcode().getCode());
         D2ZonePtr zone = response->getZone();
         EXPECT_TRUE(zone);
-        EXPECT_EQ("response.example.com.", zone->getName().toText());
+        EXPECT_EQ("request.example.com.", zone->getName().toText());
     }
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2021 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -153,12 +153,13 @@ FauxServer::requestHandler(const boost::system::error_code& error,
     // The request parsed OK, so let's build a response.
     // We must use the QID we received in the response or IOFetch will
     // toss the response out, resulting in eventual timeout.
-    // We fill in the zone with data we know is from the "server".
+    // As DNS servers do, we fill in the zone with the zone of the request:
+    // persistent connections drop responses for another zone.
     dns::Message response(dns::Message::RENDER);
     response.setQid(request.getQid());
-    dns::Question question(dns::Name("response.example.com"),
-                           dns::RRClass::ANY(), dns::RRType::SOA());
-    response.addQuestion(question);
+    if (request.getRRCount(dns::Message::SECTION_QUESTION) > 0) {
+        response.addQuestion(*request.beginQuestion());
+    }
     response.setOpcode(dns::Opcode(dns::Opcode::UPDATE_CODE));
     response.setHeaderFlag(dns::Message::HEADERFLAG_QR, true);
 
@@ -224,6 +224,7 @@ DatabaseConnection::toElement(const ParameterMap& params) {
         std::string value = param.second;
 
         if ((keyword == "lfc-interval") ||
+            (keyword == "write-behind-interval") ||
             (keyword == "connect-timeout") ||
             (keyword == "read-timeout") ||
             (keyword == "write-timeout") ||
@@ -242,7 +243,9 @@ DatabaseConnection::toElement(const ParameterMap& params) {
                     .arg(keyword).arg(value);
             }
         } else if ((keyword == "persist") ||
-                   (keyword == "readonly")) {
+                   (keyword == "readonly") ||
+                   (keyword == "write-behind") ||
+                   (keyword == "write-behind-sync")) {
             if (value == "true") {
                 result->set(keyword, isc::data::Element::create(true));
             } else if (value == "false") {
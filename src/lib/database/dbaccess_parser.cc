@@ -48,6 +48,7 @@ DbAccessParser::parse(std::string& access_string,
     DatabaseConnection::ParameterMap values_copy = values_;
 
     int64_t lfc_interval = 0;
+    int64_t write_behind_interval = 0;
     int64_t connect_timeout = 0;
     int64_t read_timeout = 0;
     int64_t write_timeout = 0;
@@ -61,7 +62,9 @@ DbAccessParser::parse(std::string& access_string,
     for (std::pair<std::string, ConstElementPtr> param : database_config->mapValue()) {
         try {
             if ((param.first == "persist") ||
-                (param.first == "readonly")) {
+                (param.first == "readonly") ||
+                (param.first == "write-behind") ||
+                (param.first == "write-behind-sync")) {
                 values_copy[param.first] = (param.second->boolValue() ?
                                             "true" : "false");
 
@@ -70,6 +73,11 @@ DbAccessParser::parse(std::string& access_string,
                 values_copy[param.first] =
                     boost::lexical_cast<std::string>(lfc_interval);
 
+            } else if (param.first == "write-behind-interval") {
+                write_behind_interval = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_behind_interval);
+
             } else if (param.first == "connect-timeout") {
                 connect_timeout = param.second->intValue();
                 values_copy[param.first] =
@@ -166,6 +174,17 @@ DbAccessParser::parse(std::string& access_string,
                   << " (" << value->getPosition() << ")");
     }
 
+    // Likewise, check the write-behind-interval.
+    if ((write_behind_interval < 0) ||
+        (write_behind_interval > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-behind-interval");
+        isc_throw(DbConfigError, "write-behind-interval value: "
+                  << write_behind_interval
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
     // d. Check that the timeouts are within a reasonable range.
     if ((connect_timeout < 0) ||
         (connect_timeout > std::numeric_limits<uint32_t>::max())) {
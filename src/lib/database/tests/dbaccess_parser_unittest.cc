@@ -172,7 +172,10 @@ private:
                  (parameter != "tcp-user-timeout") &&
                  (parameter != "port") &&
                  (parameter != "max-row-errors") &&
-                 (parameter != "readonly"));
+                 (parameter != "readonly") &&
+                 (parameter != "write-behind") &&
+                 (parameter != "write-behind-interval") &&
+                 (parameter != "write-behind-sync"));
     }
 
 };
@@ -356,6 +359,42 @@ TEST_F(DbAccessParserTest, largeLFCInterval) {
     EXPECT_THROW(parser.parse(json_elements), DbConfigError);
 }
 
+// This test checks that the parser accepts the write-behind parameters.
+TEST_F(DbAccessParserTest, validWriteBehind) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "write-behind", "true",
+                            "write-behind-interval", "100",
+                            "write-behind-sync", "false",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid write-behind", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects out of range values of the
+// write-behind-interval parameter.
+TEST_F(DbAccessParserTest, invalidWriteBehindInterval) {
+    const char* negative[] = {"type", "memfile",
+                              "write-behind-interval", "-1",
+                              NULL};
+    TestDbAccessParser parser;
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(negative))),
+                 DbConfigError);
+
+    const char* large[] = {"type", "memfile",
+                           "write-behind-interval", "4294967296",
+                           NULL};
+    EXPECT_THROW(parser.parse(Element::fromJSON(toJson(large))),
+                 DbConfigError);
+}
+
 // This test checks that the parser accepts the valid value of the
 // connect-timeout parameter.
 TEST_F(DbAccessParserTest, validConnectTimeout) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -22,8 +22,71 @@ namespace dhcp {
 
 using namespace isc::data;
 
+ClientClassRegistry::ClientClassRegistry()
+    : snapshot_(new Snapshot()), mutex_() {
+}
+
+ClientClassRegistry&
+ClientClassRegistry::instance() {
+    static ClientClassRegistry registry;
+    return (registry);
+}
+
+ClientClassId
+ClientClassRegistry::intern(const ClientClass& class_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SnapshotPtr current = getSnapshot();
+    ClientClassId id;
+    if (current->lookup(class_name, id)) {
+        return (id);
+    }
+    // Copy on write: the current snapshot may be in use.
+    boost::shared_ptr<Snapshot> snapshot(new Snapshot(*current));
+    id = static_cast<ClientClassId>(snapshot->names_.size());
+    snapshot->ids_.insert(std::make_pair(class_name, id));
+    snapshot->names_.push_back(class_name);
+    boost::atomic_store(&snapshot_, SnapshotPtr(snapshot));
+    return (id);
+}
+
+bool
+ClientClassRegistry::lookup(const ClientClass& class_name,
+                            ClientClassId& id) const {
+    return (getSnapshot()->lookup(class_name, id));
+}
+
+ClientClass
+ClientClassRegistry::getName(ClientClassId id) const {
+    SnapshotPtr snapshot = getSnapshot();
+    if (id >= snapshot->names_.size()) {
+        return (ClientClass());
+    }
+    return (snapshot->names_[id]);
+}
+
+size_t
+ClientClassRegistry::size() const {
+    return (getSnapshot()->names_.size());
+}
+
+ClientClassRegistry::SnapshotPtr
+ClientClassRegistry::getSnapshot() const {
+    return (boost::atomic_load(&snapshot_));
+}
+
+bool
+ClientClassRegistry::Snapshot::lookup(const ClientClass& class_name,
+                                      ClientClassId& id) const {
+    auto it = ids_.find(class_name);
+    if (it == ids_.end()) {
+        return (false);
+    }
+    id = it->second;
+    return (true);
+}
+
 ClientClasses::ClientClasses(const std::string& class_names)
-    : container_() {
+    : container_(), bits_(), resolved_(0) {
     std::vector<std::string> split_text;
     boost::split(split_text, class_names, boost::is_any_of(","),
                  boost::algorithm::token_compress_off);
@@ -36,12 +99,38 @@ ClientClasses::ClientClasses(const std::string& class_names)
     }
 }
 
+void
+ClientClasses::insert(const ClientClass& class_name) {
+    ClientClassRegistry::SnapshotPtr snapshot =
+        ClientClassRegistry::instance().getSnapshot();
+    if (container_.empty()) {
+        // Later snapshots hold the same lower identifiers.
+        resolved_ = snapshot->names_.size();
+    }
+    if (!container_.push_back(class_name).second) {
+        return;
+    }
+    ClientClassId id;
+    if (snapshot->lookup(class_name, id)) {
+        size_t word = id / 64;
+        if (word >= bits_.size()) {
+            bits_.resize(word + 1, 0);
+        }
+        bits_[word] |= (static_cast<uint64_t>(1) << (id % 64));
+    }
+}
+
 void
 ClientClasses::erase(const ClientClass& class_name) {
     auto& idx = container_.get<ClassNameTag>();
     auto it = idx.find(class_name);
     if (it != idx.end()) {
         static_cast<void>(idx.erase(it));
+        ClientClassId id;
+        if (ClientClassRegistry::instance().lookup(class_name, id) &&
+            (id / 64 < bits_.size())) {
+            bits_[id / 64] &= ~(static_cast<uint64_t>(1) << (id % 64));
+        }
     }
 }
 
@@ -51,6 +140,20 @@ ClientClasses::contains(const ClientClass& x) const {
     return (idx.count(x) != 0);
 }
 
+bool
+ClientClasses::contains(ClientClassId id) const {
+    if (container_.empty()) {
+        return (false);
+    }
+    if (id < resolved_) {
+        return ((id / 64 < bits_.size()) &&
+                ((bits_[id / 64] >> (id % 64)) & 1));
+    }
+    // The class was interned after the first insertion: it may have
+    // been inserted without its bit.
+    return (contains(ClientClassRegistry::instance().getName(id)));
+}
+
 std::string
 ClientClasses::toText(const std::string& separator) const {
     std::stringstream s;
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,8 +15,14 @@
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 /// @file   classify.h
 ///
@@ -41,6 +47,89 @@ namespace dhcp {
     /// @brief Defines a single class name.
     typedef std::string ClientClass;
 
+    /// @brief Defines an interned class name identifier.
+    typedef uint32_t ClientClassId;
+
+    /// @brief Registry of interned client class names.
+    ///
+    /// The registry assigns dense integer identifiers to the class names
+    /// used in the configuration (e.g. in client class guards of pools
+    /// and networks or in member expressions) so membership tests can
+    /// be done using a bit of the @c ClientClasses of a packet instead
+    /// of hashing the name.
+    ///
+    /// Identifiers are never reused or removed: the registry grows with
+    /// the number of distinct configured class names. Names which are
+    /// only known at runtime (e.g. spawned subclasses) are not interned.
+    ///
+    /// Names are interned when the configuration is parsed: each new name
+    /// publishes an immutable snapshot of the registry which is atomically
+    /// swapped, so the lookups done when processing packets take no lock.
+    class ClientClassRegistry : public boost::noncopyable {
+    public:
+        /// @brief Returns the sole instance of the registry.
+        static ClientClassRegistry& instance();
+
+        /// @brief Interns a class name.
+        ///
+        /// @param class_name The name of the class.
+        /// @return The identifier of the class, assigned when the name
+        /// was not yet interned.
+        ClientClassId intern(const ClientClass& class_name);
+
+        /// @brief Looks up the identifier of an interned class name.
+        ///
+        /// @param class_name The name of the class.
+        /// @param[out] id The identifier of the class when found.
+        /// @return true if the name is interned, false otherwise.
+        bool lookup(const ClientClass& class_name, ClientClassId& id) const;
+
+        /// @brief Returns the name of an interned class.
+        ///
+        /// @param id The identifier of the class.
+        /// @return The name of the class or an empty string.
+        ClientClass getName(ClientClassId id) const;
+
+        /// @brief Returns the number of interned class names.
+        ///
+        /// All identifiers are lower than this number.
+        size_t size() const;
+
+        /// @brief Immutable snapshot of the registry.
+        struct Snapshot {
+            /// @brief The identifiers by name.
+            std::unordered_map<ClientClass, ClientClassId> ids_;
+
+            /// @brief The names by identifier.
+            std::vector<ClientClass> names_;
+
+            /// @brief Looks up the identifier of a class name.
+            ///
+            /// @param class_name The name of the class.
+            /// @param[out] id The identifier of the class when found.
+            /// @return true if the name is interned, false otherwise.
+            bool lookup(const ClientClass& class_name, ClientClassId& id) const;
+        };
+
+        /// @brief Pointer to a snapshot of the registry.
+        typedef boost::shared_ptr<const Snapshot> SnapshotPtr;
+
+        /// @brief Returns the current snapshot of the registry.
+        ///
+        /// It holds all the names interned before the call.
+        SnapshotPtr getSnapshot() const;
+
+    private:
+        /// @brief Constructor.
+        ClientClassRegistry();
+
+        /// @brief The current snapshot, atomically swapped.
+        SnapshotPtr snapshot_;
+
+        /// @brief The mutex serializing the interning of names.
+        std::mutex mutex_;
+    };
+
     /// @brief Tag for the sequence index.
     struct ClassSequenceTag { };
 
@@ -104,7 +193,9 @@ namespace dhcp {
     /// @brief Container for storing client class names
     ///
     /// Both a list to iterate on it in insert order and unordered
-    /// set of names for existence.
+    /// set of names for existence. The classes which are interned in
+    /// the @c ClientClassRegistry are also tracked in a bitset indexed
+    /// by their identifiers.
     class ClientClasses {
     public:
 
@@ -113,7 +204,7 @@ namespace dhcp {
         typedef ClientClassContainer::iterator iterator;
 
         /// @brief Default constructor.
-        ClientClasses() : container_() {
+        ClientClasses() : container_(), bits_(), resolved_(0) {
         }
 
         /// @brief Constructor from comma separated values.
@@ -125,9 +216,7 @@ namespace dhcp {
         /// @brief Insert an element.
         ///
         /// @param class_name The name of the class to insert
-        void insert(const ClientClass& class_name) {
-            static_cast<void>(container_.push_back(class_name));
-        }
+        void insert(const ClientClass& class_name);
 
         /// @brief Erase element by name.
         ///
@@ -179,9 +268,20 @@ namespace dhcp {
         /// @return true if x belongs to the classes
         bool contains(const ClientClass& x) const;
 
+        /// @brief returns if an interned class belongs to the defined classes
+        ///
+        /// This is a bit test unless the class was interned after the
+        /// first class was inserted, in which case the name is checked.
+        ///
+        /// @param id identifier of the client class to be checked
+        /// @return true if the class belongs to the classes
+        bool contains(ClientClassId id) const;
+
         /// @brief Clears containers.
         void clear() {
             container_.clear();
+            bits_.clear();
+            resolved_ = 0;
         }
 
         /// @brief Returns all class names as text
@@ -201,6 +301,13 @@ namespace dhcp {
     private:
         /// @brief container part
         ClientClassContainer container_;
+
+        /// @brief bitset of the interned classes, indexed by identifier
+        std::vector<uint64_t> bits_;
+
+        /// @brief number of interned classes when the first class was
+        /// inserted: the bitset is exact for lower identifiers
+        size_t resolved_;
     };
 }
 }
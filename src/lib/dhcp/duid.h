@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define DUID_H
 
 #include <asiolink/io_address.h>
+#include <util/encode/hex.h>
 #include <util/strutil.h>
 #include <boost/shared_ptr.hpp>
 #include <vector>
@@ -82,17 +83,9 @@ public:
     ///
     /// @return textual representation of the identifier (e.g. 00:01:02:03:ff)
     std::string toText() const {
-        std::stringstream tmp;
-        tmp << std::hex;
-        bool delim = false;
-        for (auto const data : data_) {
-            if (delim) {
-                tmp << ":";
-            }
-            tmp << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(data);
-            delim = true;
-        }
-        return (tmp.str());
+        std::string text;
+        util::encode::appendHex(data_.data(), data_.size(), text, ':', false);
+        return (text);
     }
 
     /// @brief This static function parses an Identifier specified in the
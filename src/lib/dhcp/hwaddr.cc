@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,9 +9,8 @@
 #include <dhcp/hwaddr.h>
 #include <dhcp/dhcp4.h>
 #include <exceptions/exceptions.h>
+#include <util/encode/hex.h>
 #include <util/strutil.h>
-#include <iomanip>
-#include <sstream>
 #include <vector>
 #include <string.h>
 
@@ -49,21 +48,13 @@ HWAddr::HWAddr(const std::vector<uint8_t>& hwaddr, uint16_t htype)
 }
 
 std::string HWAddr::toText(bool include_htype) const {
-    std::stringstream tmp;
+    std::string text;
     if (include_htype) {
-        tmp << "hwtype=" << static_cast<unsigned int>(htype_) << " ";
+        text = "hwtype=" + std::to_string(static_cast<unsigned int>(htype_)) + " ";
     }
-    tmp << std::hex;
-    bool delim = false;
-    for (std::vector<uint8_t>::const_iterator it = hwaddr_.begin();
-         it != hwaddr_.end(); ++it) {
-        if (delim) {
-            tmp << ":";
-        }
-        tmp << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(*it);
-        delim = true;
-    }
-    return (tmp.str());
+    text.reserve(text.size() + hwaddr_.size() * 3);
+    util::encode::appendHex(hwaddr_.data(), hwaddr_.size(), text, ':', false);
+    return (text);
 }
 
 HWAddr
@@ -21,8 +21,10 @@
 #include <exceptions/exceptions.h>
 #include <exceptions/isc_assert.h>
 #include <util/buffer.h>
+#include <util/memory_pool.h>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -306,12 +308,13 @@ LibDHCP::optionFactory(Option::Universe u,
 }
 
 size_t
-LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
+LibDHCP::unpackOptions6(OptionBufferConstIter begin, OptionBufferConstIter end,
+                        const string& option_space,
                         OptionCollection& options,
                         size_t* relay_msg_offset /* = 0 */,
                         size_t* relay_msg_len /* = 0 */) {
     size_t offset = 0;
-    size_t length = buf.size();
+    size_t length = std::distance(begin, end);
     size_t last_offset = 0;
 
     // Get the list of standard option definitions.
@@ -342,10 +345,10 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
         }
 
         // Parse the option header
-        uint16_t opt_type = readUint16(&buf[offset], 2);
+        uint16_t opt_type = readUint16(&begin[offset], 2);
         offset += 2;
 
-        uint16_t opt_len = readUint16(&buf[offset], 2);
+        uint16_t opt_len = readUint16(&begin[offset], 2);
         offset += 2;
 
         if (offset + opt_len > length) {
@@ -379,8 +382,8 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
             }
 
             // Parse this as vendor option
-            OptionPtr vendor_opt(new OptionVendor(Option::V6, buf.begin() + offset,
-                                                  buf.begin() + offset + opt_len));
+            OptionPtr vendor_opt(new OptionVendor(Option::V6, begin + offset,
+                                                  begin + offset + opt_len));
             options.insert(std::make_pair(opt_type, vendor_opt));
 
             offset += opt_len;
@@ -424,9 +427,9 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
             // now. In the future we will initialize definitions for
             // all options and we will remove this elseif. For now,
             // return generic option.
-            opt = OptionPtr(new Option(Option::V6, opt_type,
-                                       buf.begin() + offset,
-                                       buf.begin() + offset + opt_len));
+            opt = util::makePooled<Option>(Option::V6, opt_type,
+                                           begin + offset,
+                                           begin + offset + opt_len);
         } else {
             try {
                 // The option definition has been found. Use it to create
@@ -434,8 +437,8 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
                 const OptionDefinitionPtr& def = *(range.first);
                 isc_throw_assert(def);
                 opt = def->optionFactory(Option::V6, opt_type,
-                                         buf.begin() + offset,
-                                         buf.begin() + offset + opt_len);
+                                         begin + offset,
+                                         begin + offset + opt_len);
             } catch (const SkipThisOptionError&)  {
                 opt.reset();
             }
@@ -454,10 +457,12 @@ LibDHCP::unpackOptions6(const OptionBuffer& buf, const string& option_space,
 }
 
 size_t
-LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
+LibDHCP::unpackOptions4(OptionBufferConstIter begin, OptionBufferConstIter end,
+                        const string& option_space,
                         OptionCollection& options, list<uint16_t>& deferred,
                         bool check) {
     size_t offset = 0;
+    size_t length = std::distance(begin, end);
     size_t last_offset = 0;
 
     // Special case when option_space is dhcp4.
@@ -480,12 +485,12 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
 
     // The buffer being read comprises a set of options, each starting with
     // a one-byte type code and a one-byte length field.
-    while (offset < buf.size()) {
+    while (offset < length) {
         // Save the current offset for backtracking
         last_offset = offset;
 
         // Get the option type
-        uint8_t opt_type = buf[offset++];
+        uint8_t opt_type = begin[offset++];
 
         // DHO_END is a special, one octet long option
         // Valid in dhcp4 space or when check is true and
@@ -505,7 +510,7 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
             continue;
         }
 
-        if (offset + 1 > buf.size()) {
+        if (offset + 1 > length) {
             // We peeked at the option header of the next option, but
             // discovered that it would end up beyond buffer end, so
             // the option is truncated. Hence we can't parse
@@ -516,8 +521,8 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
             return (last_offset);
         }
 
-        uint8_t opt_len =  buf[offset++];
-        if (offset + opt_len > buf.size()) {
+        uint8_t opt_len =  begin[offset++];
+        if (offset + opt_len > length) {
             // We peeked at the option header of the next option, but
             // discovered that it would end up beyond buffer end, so
             // the option is truncated. Hence we can't parse
@@ -590,9 +595,9 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
                       " This will be supported once support for option spaces"
                       " is implemented");
         } else if (num_defs == 0) {
-            opt = OptionPtr(new Option(Option::V4, opt_type,
-                                       buf.begin() + offset,
-                                       buf.begin() + offset + opt_len));
+            opt = util::makePooled<Option>(Option::V4, opt_type,
+                                           begin + offset,
+                                           begin + offset + opt_len);
             opt->setEncapsulatedSpace(DHCP4_OPTION_SPACE);
         } else {
             try {
@@ -601,8 +606,8 @@ LibDHCP::unpackOptions4(const OptionBuffer& buf, const string& option_space,
                 const OptionDefinitionPtr& def = *(range.first);
                 isc_throw_assert(def);
                 opt = def->optionFactory(Option::V4, opt_type,
-                                         buf.begin() + offset,
-                                         buf.begin() + offset + opt_len);
+                                         begin + offset,
+                                         begin + offset + opt_len);
             } catch (const SkipThisOptionError&)  {
                 opt.reset();
             }
@@ -885,9 +890,9 @@ LibDHCP::unpackVendorOptions6(const uint32_t vendor_id, const OptionBuffer& buf,
         //    not defined
 
         if (!opt) {
-            opt = OptionPtr(new Option(Option::V6, opt_type,
-                                       buf.begin() + offset,
-                                       buf.begin() + offset + opt_len));
+            opt = util::makePooled<Option>(Option::V6, opt_type,
+                                           buf.begin() + offset,
+                                           buf.begin() + offset + opt_len);
         }
 
         // add option to options
@@ -991,9 +996,9 @@ LibDHCP::unpackVendorOptions4(const uint32_t vendor_id, const OptionBuffer& buf,
             }
 
             if (!opt) {
-                opt = OptionPtr(new Option(Option::V4, opt_type,
-                                           buf.begin() + offset,
-                                           buf.begin() + offset + opt_len));
+                opt = util::makePooled<Option>(Option::V4, opt_type,
+                                               buf.begin() + offset,
+                                               buf.begin() + offset + opt_len);
             }
 
             options.insert(std::make_pair(opt_type, opt));
@@ -286,6 +286,36 @@ public:
     /// Partial parsing does not throw: it is the responsibility of the
     /// caller to handle this condition.
     static size_t unpackOptions6(const OptionBuffer& buf,
+                                 const std::string& option_space,
+                                 isc::dhcp::OptionCollection& options,
+                                 size_t* relay_msg_offset = 0,
+                                 size_t* relay_msg_len = 0) {
+        return (unpackOptions6(buf.begin(), buf.end(), option_space, options,
+                               relay_msg_offset, relay_msg_len));
+    }
+
+    /// @brief Parses a range of a buffer as DHCPv6 options and creates
+    /// Option objects.
+    ///
+    /// Same as @c unpackOptions6(const OptionBuffer&, ...) but parses the
+    /// options in place, e.g. directly from the packet data, so no copy
+    /// of the range is made. The offsets are relative to the beginning
+    /// of the range.
+    ///
+    /// @param begin Iterator pointing to the beginning of the range.
+    /// @param end Iterator pointing to the end of the range.
+    /// @param option_space A name of the option space which holds definitions
+    ///        to be used to parse options in the packets.
+    /// @param options Reference to option container. Options will be
+    ///        put here.
+    /// @param relay_msg_offset reference to a size_t structure. If specified,
+    ///        offset to beginning of relay_msg option will be stored in it.
+    /// @param relay_msg_len reference to a size_t structure. If specified,
+    ///        length of the relay_msg option will be stored in it.
+    /// @return offset to the first byte after the last successfully
+    /// parsed option
+    static size_t unpackOptions6(OptionBufferConstIter begin,
+                                 OptionBufferConstIter end,
                                  const std::string& option_space,
                                  isc::dhcp::OptionCollection& options,
                                  size_t* relay_msg_offset = 0,
@@ -326,6 +356,36 @@ public:
     ///
     /// The unpackOptions6 note applies too.
     static size_t unpackOptions4(const OptionBuffer& buf,
+                                 const std::string& option_space,
+                                 isc::dhcp::OptionCollection& options,
+                                 std::list<uint16_t>& deferred,
+                                 bool flexible_pad_end = false) {
+        return (unpackOptions4(buf.begin(), buf.end(), option_space, options,
+                               deferred, flexible_pad_end));
+    }
+
+    /// @brief Parses a range of a buffer as DHCPv4 options and creates
+    /// Option objects.
+    ///
+    /// Same as @c unpackOptions4(const OptionBuffer&, ...) but parses the
+    /// options in place, e.g. directly from the packet data, so no copy
+    /// of the range is made. The offsets are relative to the beginning
+    /// of the range.
+    ///
+    /// @param begin Iterator pointing to the beginning of the range.
+    /// @param end Iterator pointing to the end of the range.
+    /// @param option_space A name of the option space which holds definitions
+    ///        to be used to parse options in the packets.
+    /// @param options Reference to option container. Options will be
+    ///        put here.
+    /// @param deferred Reference to an option code list. Options which
+    ///        processing is deferred will be put here.
+    /// @param flexible_pad_end Parse options 0 and 255 as PAD and END
+    ///        when they are not defined in the option space.
+    /// @return offset to the first byte after the last successfully
+    /// parsed option or the offset of the DHO_END option type.
+    static size_t unpackOptions4(OptionBufferConstIter begin,
+                                 OptionBufferConstIter end,
                                  const std::string& option_space,
                                  isc::dhcp::OptionCollection& options,
                                  std::list<uint16_t>& deferred,
@@ -12,6 +12,7 @@
 #include <exceptions/exceptions.h>
 #include <util/encode/hex.h>
 #include <util/io_utilities.h>
+#include <util/memory_pool.h>
 
 #include <boost/make_shared.hpp>
 
@@ -48,7 +49,11 @@ Option::Option(Universe u, uint16_t type, const OptionBuffer& data)
 
 Option::Option(Universe u, uint16_t type, OptionBufferConstIter first,
                OptionBufferConstIter last)
-    : universe_(u), type_(type), data_(first, last) {
+    : universe_(u), type_(type), data_() {
+    // This is the constructor used when parsing the received packets:
+    // reuse the storage of the options of a previous packet.
+    util::BufferPool::acquire(data_, std::distance(first, last));
+    data_.assign(first, last);
     check();
 }
 
@@ -153,15 +158,20 @@ void Option::unpack(OptionBufferConstIter begin,
 
 void
 Option::unpackOptions(const OptionBuffer& buf) {
+    unpackOptions(buf.begin(), buf.end());
+}
+
+void
+Option::unpackOptions(OptionBufferConstIter begin, OptionBufferConstIter end) {
     list<uint16_t> deferred;
     switch (universe_) {
     case V4:
-        LibDHCP::unpackOptions4(buf, getEncapsulatedSpace(),
+        LibDHCP::unpackOptions4(begin, end, getEncapsulatedSpace(),
                                 options_, deferred,
                                 getType() == DHO_VENDOR_ENCAPSULATED_OPTIONS);
         return;
     case V6:
-        LibDHCP::unpackOptions6(buf, getEncapsulatedSpace(), options_);
+        LibDHCP::unpackOptions6(begin, end, getEncapsulatedSpace(), options_);
         return;
     default:
         isc_throw(isc::BadValue, "Invalid universe type " << universe_);
@@ -381,6 +391,7 @@ bool Option::equals(const Option& other) const {
 }
 
 Option::~Option() {
+    util::BufferPool::release(data_);
 }
 
 bool Option::lenient_parsing_;
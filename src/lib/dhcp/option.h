@@ -549,6 +549,15 @@ protected:
     /// those into one exception which can be documented here.
     void unpackOptions(const OptionBuffer& buf);
 
+    /// @brief Builds a collection of sub options from a range of a buffer.
+    ///
+    /// Same as @c unpackOptions(const OptionBuffer&) but parses the
+    /// sub options in place, without copying the range first.
+    ///
+    /// @param begin iterator pointing to the beginning of the range.
+    /// @param end iterator pointing to the end of the range.
+    void unpackOptions(OptionBufferConstIter begin, OptionBufferConstIter end);
+
     /// @brief Returns option header in the textual format.
     ///
     /// This protected method should be called by the derived classes in
@@ -79,7 +79,7 @@ void Option6IA::unpack(OptionBufferConstIter begin,
     t2_ = readUint32(&(*begin), distance(begin, end));
     begin += sizeof(uint32_t);
 
-    unpackOptions(OptionBuffer(begin, end));
+    unpackOptions(begin, end);
 }
 
 std::string Option6IA::toText(int indent) const {
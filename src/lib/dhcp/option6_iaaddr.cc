@@ -84,7 +84,7 @@ void Option6IAAddr::unpack(OptionBuffer::const_iterator begin,
     valid_ = readUint32(&(*begin), distance(begin, end));
     begin += sizeof(uint32_t);
 
-    unpackOptions(OptionBuffer(begin, end));
+    unpackOptions(begin, end);
 }
 
 std::string Option6IAAddr::toText(int indent) const {
@@ -93,7 +93,7 @@ void Option6IAPrefix::unpack(OptionBuffer::const_iterator begin,
     begin += V6ADDRESS_LEN;
 
     // unpack encapsulated options (the only defined so far is PD_EXCLUDE)
-    unpackOptions(OptionBuffer(begin, end));
+    unpackOptions(begin, end);
 }
 
 std::string Option6IAPrefix::toText(int indent) const {
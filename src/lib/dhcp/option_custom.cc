@@ -325,7 +325,7 @@ OptionCustom::createBuffers(const OptionBuffer& data_buf) {
 
         // Unpack suboptions if any.
         else if (data != data_buf.end() && !getEncapsulatedSpace().empty()) {
-            unpackOptions(OptionBuffer(data, data_buf.end()));
+            unpackOptions(data, data_buf.end());
         }
 
     } else if (data_type != OPT_EMPTY_TYPE) {
@@ -379,13 +379,13 @@ OptionCustom::createBuffers(const OptionBuffer& data_buf) {
 
             // Unpack suboptions if any.
             if (data != data_buf.end() && !getEncapsulatedSpace().empty()) {
-                unpackOptions(OptionBuffer(data, data_buf.end()));
+                unpackOptions(data, data_buf.end());
             }
         }
     } else {
         // Unpack suboptions if any.
         if (data != data_buf.end() && !getEncapsulatedSpace().empty()) {
-            unpackOptions(OptionBuffer(data, data_buf.end()));
+            unpackOptions(data, data_buf.end());
         }
     }
     // If everything went ok we can replace old buffer set with new ones.
@@ -177,7 +177,7 @@ public:
         // of clang complain about unresolved reference to
         // OptionDataTypeTraits structure during linking.
         begin += data_size_len;
-        unpackOptions(OptionBuffer(begin, end));
+        unpackOptions(begin, end);
     }
 
     /// @brief Set option value.
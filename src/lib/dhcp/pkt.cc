@@ -9,6 +9,7 @@
 #include <dhcp/pkt.h>
 #include <dhcp/iface_mgr.h>
 #include <dhcp/hwaddr.h>
+#include <util/memory_pool.h>
 #include <vector>
 
 namespace isc {
@@ -32,11 +33,17 @@ Pkt::Pkt(const uint8_t* buf, uint32_t len, const isc::asiolink::IOAddress& local
         if (buf == NULL) {
             isc_throw(InvalidParameter, "data buffer passed to Pkt is NULL");
         }
+        util::BufferPool::acquire(data_, len);
         data_.resize(len);
         memcpy(&data_[0], buf, len);
     }
 }
 
+Pkt::~Pkt() {
+    util::BufferPool::release(data_);
+    util::BufferPool::release(buffer_out_);
+}
+
 void
 Pkt::addOption(const OptionPtr& opt) {
     options_.insert(std::pair<int, OptionPtr>(opt->getType(), opt));
@@ -283,6 +283,14 @@ public:
     /// @return true if belongs
     bool inClass(const isc::dhcp::ClientClass& client_class);
 
+    /// @brief Checks whether a client belongs to a given interned class.
+    ///
+    /// @param client_class_id identifier of the class
+    /// @return true if belongs
+    bool inClass(isc::dhcp::ClientClassId client_class_id) const {
+        return (classes_.contains(client_class_id));
+    }
+
     /// @brief Adds a specified class to the packet.
     ///
     /// A class can be added to the same packet repeatedly. Any additional
@@ -635,11 +643,8 @@ public:
 
     /// @brief Virtual destructor.
     ///
-    /// There is nothing to clean up here, but since there are virtual methods,
-    /// we define virtual destructor to ensure that derived classes will have
-    /// a virtual one, too.
-    virtual ~Pkt() {
-    }
+    /// Gives the storage of the buffers back to the @c BufferPool.
+    virtual ~Pkt();
 
     /// @brief Classes this packet belongs to.
     ///
@@ -11,6 +11,7 @@
 #include <dhcp/option_int.h>
 #include <dhcp/pkt4.h>
 #include <exceptions/exceptions.h>
+#include <util/memory_pool.h>
 
 #include <algorithm>
 #include <iostream>
@@ -77,6 +78,10 @@ Pkt4::pack() {
     // Clear the output buffer to make sure that consecutive calls to pack()
     // will not result in concatenation of multiple packet copies.
     buffer_out_.clear();
+    if (buffer_out_.getCapacity() == 0) {
+        // Reuse the storage of a previous packet.
+        util::BufferPool::acquire(buffer_out_);
+    }
 
     try {
         size_t hw_len = hwaddr_->hwaddr_.size();
@@ -193,14 +198,11 @@ Pkt4::unpack() {
         isc_throw(Unexpected, "Invalid or missing DHCP magic cookie");
     }
 
-    size_t opts_len = buffer_in.getLength() - buffer_in.getPosition();
-    vector<uint8_t> opts_buffer;
-
-    // Use readVector because a function which parses option requires
-    // a vector as an input.
-    buffer_in.readVector(opts_buffer, opts_len);
-
-    size_t offset = LibDHCP::unpackOptions4(opts_buffer, DHCP4_OPTION_SPACE, options_, deferred_options_, false);
+    // Parse the options in place: they are the remaining of the packet data
+    // so there is no need to copy them.
+    size_t offset = LibDHCP::unpackOptions4(data_.begin() + buffer_in.getPosition(),
+                                            data_.end(), DHCP4_OPTION_SPACE,
+                                            options_, deferred_options_, false);
 
     // If offset is not equal to the size and there is no DHO_END,
     // then something is wrong here. We either parsed past input
@@ -213,7 +215,7 @@ Pkt4::unpack() {
     // bytes. We also need to quell compiler warning about unused offset
     // variable.
     //
-    // if ((offset != size) && (opts_buffer[offset] != DHO_END)) {
+    // if ((offset != size) && (data_[offset] != DHO_END)) {
     //        isc_throw(BadValue, "Received DHCPv6 buffer of size " << size
     //                  << ", were able to parse " << offset << " bytes.");
     // }
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,7 @@
 #include <dhcp/pkt6.h>
 #include <dhcp/docsis3_option_defs.h>
 #include <util/io_utilities.h>
+#include <util/memory_pool.h>
 #include <exceptions/exceptions.h>
 #include <dhcp/duid.h>
 #include <dhcp/iface_mgr.h>
@@ -395,6 +396,10 @@ Pkt6::packUDP() {
     try {
         // Make sure that the buffer is empty before we start writing to it.
         buffer_out_.clear();
+        if (buffer_out_.getCapacity() == 0) {
+            // Reuse the storage of a previous packet.
+            util::BufferPool::acquire(buffer_out_);
+        }
 
         // is this a relayed packet?
         if (!relay_info_.empty()) {
@@ -523,11 +528,8 @@ Pkt6::unpackMsg(OptionBuffer::const_iterator begin,
     // perhaps for stats gathering we can uncomment this.
     //    size -= sizeof(uint32_t); // We just parsed 4 bytes header
 
-    OptionBuffer opt_buffer(begin, end);
-
-    // If custom option parsing function has been set, use this function
-    // to parse options. Otherwise, use standard function from libdhcp.
-    size_t offset = LibDHCP::unpackOptions6(opt_buffer, DHCP6_OPTION_SPACE, options_);
+    // Parse the options in place, without copying them.
+    size_t offset = LibDHCP::unpackOptions6(begin, end, DHCP6_OPTION_SPACE, options_);
 
     // If offset is not equal to the size, then something is wrong here. We
     // either parsed past input buffer (bug in our code) or we haven't parsed
@@ -572,12 +574,10 @@ Pkt6::unpackRelayMsg() {
         offset += isc::asiolink::V6ADDRESS_LEN;
         bufsize -= DHCPV6_RELAY_HDR_LEN; // 34 bytes (1+1+16+16)
 
-        // parse the rest as options
-        OptionBuffer opt_buffer(&data_[offset], &data_[offset] + bufsize);
-
-        // If custom option parsing function has been set, use this function
-        // to parse options. Otherwise, use standard function from libdhcp.
-        LibDHCP::unpackOptions6(opt_buffer, DHCP6_OPTION_SPACE, relay.options_,
+        // parse the rest as options, in place
+        LibDHCP::unpackOptions6(data_.begin() + offset,
+                                data_.begin() + offset + bufsize,
+                                DHCP6_OPTION_SPACE, relay.options_,
                                 &relay_msg_offset, &relay_msg_len);
 
         /// @todo: check that each option appears at most once
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,7 @@
 #include <dhcp/pkt_filter_bpf.h>
 #include <dhcp/protocol_util.h>
 #include <exceptions/exceptions.h>
+#include <util/memory_pool.h>
 #include <algorithm>
 #include <net/bpf.h>
 #include <netinet/if_ether.h>
@@ -524,7 +525,7 @@ PktFilterBPF::receive(Iface& iface, const SocketInfo& socket_info) {
     buf.readVector(dhcp_buf, buf.getLength() - buf.getPosition());
 
     // Decode DHCP data into the Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(&dhcp_buf[0], dhcp_buf.size()));
+    Pkt4Ptr pkt = util::makePooled<Pkt4>(&dhcp_buf[0], dhcp_buf.size());
 
     // Set the appropriate packet members using data collected from
     // the decoded headers.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #include <dhcp/iface_mgr.h>
 #include <dhcp/pkt4.h>
 #include <dhcp/pkt_filter_inet.h>
+#include <util/memory_pool.h>
 #include <errno.h>
 #include <cstring>
 #include <fcntl.h>
@@ -141,7 +142,7 @@ PktFilterInet::receive(Iface& iface, const SocketInfo& socket_info) {
     }
 
     // We have all data let's create Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(buf, result));
+    Pkt4Ptr pkt = util::makePooled<Pkt4>(buf, result);
 
     pkt->updateTimestamp();
 
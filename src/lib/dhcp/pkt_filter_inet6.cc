@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,7 @@
 #include <dhcp/pkt6.h>
 #include <dhcp/pkt_filter_inet6.h>
 #include <exceptions/isc_assert.h>
+#include <util/memory_pool.h>
 #include <util/io/pktinfo_utilities.h>
 
 #include <fcntl.h>
@@ -227,7 +228,7 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     // Let's create a packet.
     Pkt6Ptr pkt;
     try {
-        pkt = Pkt6Ptr(new Pkt6(buf, result));
+        pkt = util::makePooled<Pkt6>(buf, result);
     } catch (const std::exception& ex) {
         isc_throw(SocketReadError, "failed to create new packet");
     }
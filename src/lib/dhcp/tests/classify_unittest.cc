@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -169,3 +169,96 @@ TEST(ClassifyTest, Erase) {
     EXPECT_FALSE(classes.contains("alpha"));
     EXPECT_FALSE(classes.contains("beta"));
 }
+
+// Check that class names are interned once.
+TEST(ClassifyTest, Registry) {
+    ClientClassRegistry& registry = ClientClassRegistry::instance();
+
+    ClientClassId id = registry.intern("registry-alpha");
+    EXPECT_LT(id, registry.size());
+    EXPECT_EQ(id, registry.intern("registry-alpha"));
+    EXPECT_EQ("registry-alpha", registry.getName(id));
+
+    ClientClassId other = registry.intern("registry-beta");
+    EXPECT_NE(id, other);
+
+    ClientClassId found = 0;
+    EXPECT_TRUE(registry.lookup("registry-beta", found));
+    EXPECT_EQ(other, found);
+    EXPECT_FALSE(registry.lookup("registry-not-interned", found));
+    EXPECT_EQ("", registry.getName(registry.size()));
+}
+
+// Check that interning a name publishes a new snapshot and leaves the
+// previous ones unchanged.
+TEST(ClassifyTest, RegistrySnapshot) {
+    ClientClassRegistry& registry = ClientClassRegistry::instance();
+    ClientClassId id = registry.intern("snapshot-alpha");
+    ClientClassRegistry::SnapshotPtr before = registry.getSnapshot();
+    ASSERT_TRUE(before);
+
+    // Interning a known name does not publish a new snapshot.
+    registry.intern("snapshot-alpha");
+    EXPECT_EQ(before, registry.getSnapshot());
+
+    ClientClassId other = registry.intern("snapshot-beta");
+    ClientClassRegistry::SnapshotPtr after = registry.getSnapshot();
+    ASSERT_TRUE(after);
+    EXPECT_NE(before, after);
+
+    ClientClassId found = 0;
+    EXPECT_TRUE(before->lookup("snapshot-alpha", found));
+    EXPECT_EQ(id, found);
+    EXPECT_FALSE(before->lookup("snapshot-beta", found));
+    EXPECT_TRUE(after->lookup("snapshot-alpha", found));
+    EXPECT_EQ(id, found);
+    EXPECT_TRUE(after->lookup("snapshot-beta", found));
+    EXPECT_EQ(other, found);
+    EXPECT_EQ(after->names_.size(), registry.size());
+}
+
+// Check membership tests of interned classes.
+TEST(ClassifyTest, ContainsInterned) {
+    ClientClassRegistry& registry = ClientClassRegistry::instance();
+    ClientClassId alpha = registry.intern("interned-alpha");
+    ClientClassId beta = registry.intern("interned-beta");
+    ClientClassId gamma = registry.intern("interned-gamma");
+
+    ClientClasses classes;
+    EXPECT_FALSE(classes.contains(alpha));
+
+    classes.insert("interned-alpha");
+    classes.insert("not-interned");
+    classes.insert("interned-gamma");
+    EXPECT_TRUE(classes.contains(alpha));
+    EXPECT_FALSE(classes.contains(beta));
+    EXPECT_TRUE(classes.contains(gamma));
+
+    classes.erase("interned-gamma");
+    EXPECT_FALSE(classes.contains(gamma));
+
+    // Copies keep the membership.
+    ClientClasses copy(classes);
+    EXPECT_TRUE(copy.contains(alpha));
+    EXPECT_FALSE(copy.contains(gamma));
+
+    classes.clear();
+    EXPECT_FALSE(classes.contains(alpha));
+}
+
+// Check that classes interned after classes were inserted are found.
+TEST(ClassifyTest, ContainsInternedLater) {
+    ClientClasses classes;
+    classes.insert("later-alpha");
+    classes.insert("later-beta");
+
+    ClientClassRegistry& registry = ClientClassRegistry::instance();
+    ClientClassId alpha = registry.intern("later-alpha");
+    ClientClassId gamma = registry.intern("later-gamma");
+    EXPECT_TRUE(classes.contains(alpha));
+    EXPECT_FALSE(classes.contains(gamma));
+
+    // Insertion after interning works too.
+    classes.insert("later-gamma");
+    EXPECT_TRUE(classes.contains(gamma));
+}
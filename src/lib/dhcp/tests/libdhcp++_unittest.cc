@@ -577,6 +577,42 @@ TEST_F(LibDhcpTest, unpackEmptyOption6) {
     EXPECT_EQ(4, option_empty->len());
 }
 
+// Check parsing of DHCPv6 options from a range of a buffer.
+TEST_F(LibDhcpTest, unpackOptions6Range) {
+    // The options are surrounded by bytes which must not be parsed.
+    OptionBuffer buf = {
+      0xFF, 0xFF,                // header not parsed
+      0x00, 0x08,                // option code = 8 (elapsed time)
+      0x00, 0x02,                // option length = 2
+      0x01, 0x02,                // elapsed time
+      0x7F, 0x00,                // option code = 32512
+      0x00, 0x01,                // option length = 1
+      0x05,                      // data
+      0x00, 0x0C, 0x00, 0x00     // trailer not parsed
+    };
+
+    // Parse options.
+    OptionCollection options;
+    size_t offset = 0;
+    ASSERT_NO_THROW(offset = LibDHCP::unpackOptions6(buf.begin() + 2,
+                                                     buf.end() - 4,
+                                                     DHCP6_OPTION_SPACE,
+                                                     options));
+    // The offset is relative to the beginning of the range.
+    EXPECT_EQ(11, offset);
+
+    ASSERT_EQ(2, options.size());
+    OptionPtr elapsed = options.find(D6O_ELAPSED_TIME)->second;
+    ASSERT_TRUE(elapsed);
+    OptionUint16Ptr elapsed16 = boost::dynamic_pointer_cast<OptionUint16>(elapsed);
+    ASSERT_TRUE(elapsed16);
+    EXPECT_EQ(0x0102, elapsed16->getValue());
+    OptionPtr generic = options.find(32512)->second;
+    ASSERT_TRUE(generic);
+    ASSERT_EQ(1, generic->getData().size());
+    EXPECT_EQ(5, generic->getData()[0]);
+}
+
 // This test verifies that the following option structure can be parsed:
 // - option (option space 'foobar')
 //   - sub option (option space 'foo')
@@ -1508,6 +1544,43 @@ TEST_F(LibDhcpTest, unpackEmptyOption4) {
     EXPECT_EQ(2, option_empty->len());
 }
 
+// Check parsing of DHCPv4 options from a range of a buffer.
+TEST_F(LibDhcpTest, unpackOptions4Range) {
+    // The options are surrounded by bytes which must not be parsed.
+    OptionBuffer buf = {
+      0x0C, 0x05,               // header not parsed
+      0x0C, 0x03,               // option code = 12 (host name), length = 3
+      0x66, 0x6F, 0x6F,         // "foo"
+      0xFE, 0x01,               // option code = 254, length = 1
+      0x07,                     // data
+      0xFF,                     // end
+      0x0F, 0x01, 0x00          // trailer not parsed
+    };
+
+    // Parse options.
+    OptionCollection options;
+    list<uint16_t> deferred;
+    size_t offset = 0;
+    ASSERT_NO_THROW(offset = LibDHCP::unpackOptions4(buf.begin() + 2,
+                                                     buf.end() - 3,
+                                                     DHCP4_OPTION_SPACE,
+                                                     options, deferred,
+                                                     false));
+    // The offset of the end option is relative to the beginning of the range.
+    EXPECT_EQ(8, offset);
+
+    ASSERT_EQ(2, options.size());
+    OptionStringPtr host_name =
+        boost::dynamic_pointer_cast<OptionString>(options.find(DHO_HOST_NAME)->second);
+    ASSERT_TRUE(host_name);
+    EXPECT_EQ("foo", host_name->getValue());
+    OptionPtr generic = options.find(254)->second;
+    ASSERT_TRUE(generic);
+    ASSERT_EQ(1, generic->getData().size());
+    EXPECT_EQ(7, generic->getData()[0]);
+    EXPECT_EQ(0, options.count(DHO_DOMAIN_NAME));
+}
+
 // This test verifies that the following option structure can be parsed:
 // - option (option space 'foobar')
 //   - sub option (option space 'foo')
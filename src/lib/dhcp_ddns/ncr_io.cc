@@ -155,12 +155,35 @@ NameChangeListener::invokeRecvHandler(const Result result,
     }
 }
 
+void
+NameChangeListener::invokeRecvHandler(std::vector<NameChangeRequestPtr>& ncrs) {
+    // Hand off all but the last request, the last one going through the
+    // single request path which starts the next receive.
+    for (size_t i = 0; i + 1 < ncrs.size(); ++i) {
+        try {
+            io_pending_ = false;
+            recv_handler_(SUCCESS, ncrs[i]);
+        } catch (const std::exception& ex) {
+            LOG_ERROR(dhcp_ddns_logger, DHCP_DDNS_UNCAUGHT_NCR_RECV_HANDLER_ERROR)
+                      .arg(ex.what());
+        }
+
+        // The handler stopped the listener, drop the rest.
+        if (!amListening()) {
+            return;
+        }
+    }
+
+    invokeRecvHandler(SUCCESS, ncrs.back());
+}
+
 //************************* NameChangeSender ******************************
 
 NameChangeSender::NameChangeSender(RequestSendHandler& send_handler,
                                    size_t send_queue_max)
     : sending_(false), send_handler_(send_handler),
-      send_queue_max_(send_queue_max), io_service_(NULL), mutex_(new mutex) {
+      send_queue_max_(send_queue_max), batch_size_(1), io_service_(NULL),
+      mutex_(new mutex) {
 
     // Queue size must be big enough to hold at least 1 entry.
     setQueueMaxSize(send_queue_max);
@@ -281,6 +304,7 @@ NameChangeSender::sendNext() {
     // it on the front of the queue until we successfully send it.
     if (!send_queue_.empty()) {
         ncr_to_send_ = send_queue_.front();
+        batch_size_ = 1;
 
        // @todo start defense timer
        // If a send were to hang and we timed it out, then timeout
@@ -304,21 +328,35 @@ NameChangeSender::invokeSendHandler(const NameChangeSender::Result result) {
 void
 NameChangeSender::invokeSendHandlerInternal(const NameChangeSender::Result result) {
     // @todo reset defense timer
-    if (result == SUCCESS) {
-        // It shipped so pull it off the queue.
-        send_queue_.pop_front();
-    }
+    // On failure only the first request is reported, the whole batch being
+    // left on the queue to be retried.
+    size_t count = (result == SUCCESS ? batch_size_ : 1);
+    batch_size_ = 1;
+    for (size_t i = 0; i < count; ++i) {
+        NameChangeRequestPtr ncr = ncr_to_send_;
+        if (result == SUCCESS) {
+            if (send_queue_.empty()) {
+                break;
+            }
 
-    // Invoke the completion handler passing in the result and a pointer
-    // the request involved.
-    // Surround the invocation with a try-catch. The invoked handler is
-    // not supposed to throw, but in the event it does we will at least
-    // report it.
-    try {
-        send_handler_(result, ncr_to_send_);
-    } catch (const std::exception& ex) {
-        LOG_ERROR(dhcp_ddns_logger, DHCP_DDNS_UNCAUGHT_NCR_SEND_HANDLER_ERROR)
-                  .arg(ex.what());
+            // It shipped so pull it off the queue.
+            if (i > 0) {
+                ncr = send_queue_.front();
+            }
+            send_queue_.pop_front();
+        }
+
+        // Invoke the completion handler passing in the result and a pointer
+        // the request involved.
+        // Surround the invocation with a try-catch. The invoked handler is
+        // not supposed to throw, but in the event it does we will at least
+        // report it.
+        try {
+            send_handler_(result, ncr);
+        } catch (const std::exception& ex) {
+            LOG_ERROR(dhcp_ddns_logger, DHCP_DDNS_UNCAUGHT_NCR_SEND_HANDLER_ERROR)
+                      .arg(ex.what());
+        }
     }
 
     // Clear the pending ncr pointer.
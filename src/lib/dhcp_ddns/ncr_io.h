@@ -56,6 +56,7 @@
 
 #include <deque>
 #include <mutex>
+#include <vector>
 
 namespace isc {
 namespace dhcp_ddns {
@@ -269,6 +270,19 @@ protected:
     /// wise.
     void invokeRecvHandler(const Result result, NameChangeRequestPtr& ncr);
 
+    /// @brief Calls the NCR receive handler for each request received
+    /// at once.
+    ///
+    /// This is the counterpart of the above method for derivations which
+    /// receive several requests in a single IO, e.g. a datagram holding
+    /// a batch of requests.  The handler is invoked with a success status
+    /// for each request in turn and the next receive is initiated after the
+    /// last one.  If the handler stops the listener the remaining requests
+    /// are discarded.
+    ///
+    /// @param ncrs is the list of received requests. It must not be empty.
+    void invokeRecvHandler(std::vector<NameChangeRequestPtr>& ncrs);
+
     /// @brief Abstract method which opens the IO source for reception.
     ///
     /// The derivation uses this method to perform the steps needed to
@@ -668,6 +682,21 @@ protected:
     /// @param result contains that send outcome status.
     void invokeSendHandler(const NameChangeSender::Result result);
 
+    /// @brief Sets the number of requests carried by the send in progress.
+    ///
+    /// A derivation which packs the requests following the one given to
+    /// doSend into the same IO calls this method from doSend. When the send
+    /// succeeds, this number of entries is removed from the front of the
+    /// queue and the send completion handler is invoked for each of them.
+    /// When it fails, only the first request is reported and all of them
+    /// are left in the queue to be retried.
+    ///
+    /// @param batch_size the number of requests, at least one and no more
+    /// than the queue size.
+    void setBatchSize(const size_t batch_size) {
+        batch_size_ = batch_size;
+    }
+
     /// @brief Abstract method which opens the IO sink for transmission.
     ///
     /// The derivation uses this method to perform the steps needed to
@@ -834,6 +863,9 @@ private:
     /// @brief Pointer to the request which is in the process of being sent.
     NameChangeRequestPtr ncr_to_send_;
 
+    /// @brief Number of requests carried by the send in progress.
+    size_t batch_size_;
+
     /// @brief Pointer to the IOService currently being used by the sender.
     /// @note We need to remember the io_service but we receive it by
     /// reference.  Use a raw pointer to store it.  This value should never be
@@ -26,6 +26,8 @@ namespace dhcp_ddns {
 NameChangeFormat stringToNcrFormat(const std::string& fmt_str) {
     if (boost::iequals(fmt_str, "JSON")) {
         return FMT_JSON;
+    } else if (boost::iequals(fmt_str, "BINARY")) {
+        return FMT_BINARY;
     }
 
     isc_throw(BadValue, "Invalid NameChangeRequest format: " << fmt_str);
@@ -35,6 +37,8 @@ NameChangeFormat stringToNcrFormat(const std::string& fmt_str) {
 std::string ncrFormatToString(NameChangeFormat format) {
     if (format == FMT_JSON) {
         return ("JSON");
+    } else if (format == FMT_BINARY) {
+        return ("BINARY");
     }
 
     std::ostringstream stream;
@@ -222,6 +226,21 @@ operator<<(std::ostream& os, const D2Dhcid& dhcid) {
 
 /**************************** NameChangeRequest ******************************/
 
+namespace {
+
+///
+/// @name Flags of the binary format
+//@{
+/// The request is a forward change.
+const uint8_t NCR_FLAG_FORWARD  = 0x01;
+/// The request is a reverse change.
+const uint8_t NCR_FLAG_REVERSE  = 0x02;
+/// The request uses conflict resolution.
+const uint8_t NCR_FLAG_CONFLICT = 0x04;
+//@}
+
+}
+
 NameChangeRequest::NameChangeRequest()
     : change_type_(CHG_ADD), forward_change_(false),
     reverse_change_(false), fqdn_(""), ip_io_address_("0.0.0.0"),
@@ -282,6 +301,64 @@ NameChangeRequest::fromFormat(const NameChangeFormat format,
                       << ex.what());
         }
 
+        break;
+        }
+    case FMT_BINARY: {
+        try {
+            // Get the record, the length covers it entirely so the next
+            // record starts right after it whatever its content.
+            size_t len = buffer.readUint16();
+            std::vector<uint8_t> vec;
+            buffer.readVector(vec, len);
+            isc::util::InputBuffer record(vec.data(), vec.size());
+
+            ncr.reset(new NameChangeRequest());
+            uint8_t change_type = record.readUint8();
+            if (change_type > CHG_REMOVE) {
+                isc_throw(NcrMessageError, "Invalid data value for change_type: "
+                          << static_cast<int>(change_type));
+            }
+            ncr->setChangeType(static_cast<NameChangeType>(change_type));
+
+            uint8_t flags = record.readUint8();
+            ncr->setForwardChange(flags & NCR_FLAG_FORWARD);
+            ncr->setReverseChange(flags & NCR_FLAG_REVERSE);
+            ncr->setConflictResolution(flags & NCR_FLAG_CONFLICT);
+
+            uint8_t addr_len = record.readUint8();
+            if ((addr_len != 4) && (addr_len != 16)) {
+                isc_throw(NcrMessageError, "Invalid ip address length: "
+                          << static_cast<int>(addr_len));
+            }
+            std::vector<uint8_t> addr;
+            record.readVector(addr, addr_len);
+            ncr->ip_io_address_ = isc::asiolink::IOAddress::
+                fromBytes(addr_len == 4 ? AF_INET : AF_INET6, addr.data());
+
+            ncr->setFqdn(dns::Name(record).toText());
+
+            std::vector<uint8_t> dhcid;
+            record.readVector(dhcid, record.readUint16());
+            ncr->dhcid_.fromBytes(dhcid);
+
+            uint64_t expires_on = record.readUint32();
+            expires_on = (expires_on << 32) | record.readUint32();
+            ncr->lease_expires_on_ = expires_on;
+            ncr->setLeaseLength(record.readUint32());
+
+            ncr->validateContent();
+        } catch (const isc::util::InvalidBufferPosition& ex) {
+            // Read error accessing data in InputBuffer.
+            isc_throw(NcrMessageError, "fromFormat: buffer read error: "
+                      << ex.what());
+        } catch (const NcrMessageError&) {
+            throw;
+        } catch (const isc::Exception& ex) {
+            // Malformed FQDN.
+            isc_throw(NcrMessageError, "fromFormat: invalid FQDN: "
+                      << ex.what());
+        }
+
         break;
         }
     default:
@@ -310,6 +387,33 @@ NameChangeRequest::toFormat(const NameChangeFormat format,
         buffer.writeData(json.c_str(), length);
         break;
         }
+    case FMT_BINARY: {
+        // Reserve the length of the record, filled once it is written.
+        size_t start = buffer.getLength();
+        buffer.writeUint16(0);
+
+        buffer.writeUint8(static_cast<uint8_t>(change_type_));
+        buffer.writeUint8((forward_change_ ? NCR_FLAG_FORWARD : 0) |
+                          (reverse_change_ ? NCR_FLAG_REVERSE : 0) |
+                          (conflict_resolution_ ? NCR_FLAG_CONFLICT : 0));
+
+        std::vector<uint8_t> addr = ip_io_address_.toBytes();
+        buffer.writeUint8(addr.size());
+        buffer.writeData(addr.data(), addr.size());
+
+        dns::Name(fqdn_).toWire(buffer);
+
+        const std::vector<uint8_t>& dhcid = dhcid_.getBytes();
+        buffer.writeUint16(dhcid.size());
+        buffer.writeData(dhcid.data(), dhcid.size());
+
+        buffer.writeUint64(lease_expires_on_);
+        buffer.writeUint32(lease_length_);
+
+        buffer.writeUint16At(buffer.getLength() - start - sizeof(uint16_t),
+                             start);
+        break;
+        }
     default:
         // Programmatic error, shouldn't happen.
         isc_throw(NcrMessageError, "toFormat - invalid format");
@@ -58,13 +58,14 @@ enum NameChangeStatus  {
 
 /// @brief Defines the list of data wire formats supported.
 enum NameChangeFormat {
-  FMT_JSON
+  FMT_JSON,
+  FMT_BINARY
 };
 
 /// @brief Function which converts labels to  NameChangeFormat enum values.
 ///
 /// @param fmt_str text to convert to an enum.
-/// Valid string values: "JSON"
+/// Valid string values: "JSON", "BINARY"
 ///
 /// @return NameChangeFormat value which maps to the given string.
 ///
@@ -163,6 +164,13 @@ public:
     void fromHWAddr(const isc::dhcp::HWAddrPtr& hwaddr,
                     const std::vector<uint8_t>& wire_fqdn);
 
+    /// @brief Sets the DHCID value from its raw bytes.
+    ///
+    /// @param data The DHCID in unsigned bytes.
+    void fromBytes(const std::vector<uint8_t>& data) {
+        bytes_ = data;
+    }
+
     /// @brief Returns a reference to the DHCID byte vector.
     ///
     /// @return a reference to the vector.
@@ -220,8 +228,9 @@ typedef std::map<std::string, isc::data::ConstElementPtr> ElementMap;
 /// This class is used by DHCP-DDNS clients (e.g. DHCP4, DHCP6) to
 /// request DNS updates.  Each message contains a single DNS change (either an
 /// add/update or a remove) for a single FQDN.  It provides marshalling services
-/// for moving instances to and from the wire.  Currently, the only format
-/// supported is JSON detailed here isc::dhcp_ddns::NameChangeRequest::fromJSON
+/// for moving instances to and from the wire.  The formats supported are JSON
+/// detailed here isc::dhcp_ddns::NameChangeRequest::fromJSON and a compact
+/// binary format detailed here isc::dhcp_ddns::NameChangeRequest::toFormat.
 /// The class provides an interface such that other formats can be readily
 /// supported.
 class NameChangeRequest {
@@ -275,7 +284,10 @@ public:
     /// is than treated as JSON which is then parsed into the data needed
     /// to create a request instance.
     ///
-    /// (NOTE currently only JSON is supported.)
+    /// BINARY: The buffer is expected to contain a two byte unsigned integer
+    /// which specifies the length of the record; followed by the record
+    /// itself as described in @ref toFormat.  Exactly "length" bytes are
+    /// consumed so several records may be read from the same buffer.
     ///
     /// @param format indicates the data format to use
     /// @param buffer is the input buffer containing the marshalled request
@@ -300,7 +312,22 @@ public:
     /// is identical that described under
     /// isc::dhcp_ddns::NameChangeRequest::fromJSON
     ///
-    /// (NOTE currently only JSON is supported.)
+    /// BINARY: Upon completion, the buffer will contain a two byte unsigned
+    /// integer which specifies the length of the record; followed by the
+    /// record itself, which is made of (multi-byte integers are in network
+    /// order):
+    ///
+    /// - the change type (one byte)
+    /// - the flags (one byte): forward change (0x01), reverse change (0x02)
+    /// and use conflict resolution (0x04)
+    /// - the length of the IP address (one byte, 4 or 16) and the address
+    /// - the FQDN in DNS wire format
+    /// - the length of the DHCID (two bytes) and the DHCID
+    /// - the lease expiration time (eight bytes)
+    /// - the lease length (four bytes)
+    ///
+    /// The record being much smaller than the JSON text and cheaper to
+    /// marshal, many records may be packed in the same datagram.
     ///
     /// @param format indicates the data format to use
     /// @param buffer is the output buffer to which the request should be
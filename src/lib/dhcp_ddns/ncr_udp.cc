@@ -160,21 +160,35 @@ NameChangeUDPListener::receiveCompletionHandler(const bool successful,
         isc::util::InputBuffer input_buffer(callback->getData(),
                                             callback->getBytesTransferred());
 
-        try {
-            ncr = NameChangeRequest::fromFormat(format_, input_buffer);
-            isc::stats::StatsMgr::instance().addValue("ncr-received",
-                                                      static_cast<int64_t>(1));
-        } catch (const NcrMessageError& ex) {
-            // log it and go back to listening
-            LOG_ERROR(dhcp_ddns_logger, DHCP_DDNS_INVALID_NCR).arg(ex.what());
-            isc::stats::StatsMgr::instance().addValue("ncr-invalid",
-                                                      static_cast<int64_t>(1));
+        // A datagram may carry several requests, read them all.  An invalid
+        // request makes the rest of the datagram unreadable.
+        std::vector<NameChangeRequestPtr> ncrs;
+        do {
+            try {
+                ncrs.push_back(NameChangeRequest::fromFormat(format_,
+                                                             input_buffer));
+                isc::stats::StatsMgr::instance().addValue("ncr-received",
+                                                          static_cast<int64_t>(1));
+            } catch (const NcrMessageError& ex) {
+                // log it and go back to listening
+                LOG_ERROR(dhcp_ddns_logger, DHCP_DDNS_INVALID_NCR).arg(ex.what());
+                isc::stats::StatsMgr::instance().addValue("ncr-invalid",
+                                                          static_cast<int64_t>(1));
+                break;
+            }
+        } while (input_buffer.getPosition() < input_buffer.getLength());
 
+        if (ncrs.empty()) {
             // Queue up the next receive.
             // NOTE: We must call the base class, NEVER doReceive
             receiveNext();
             return;
         }
+
+        // Call the application's registered request receive handler
+        // for each request.
+        invokeRecvHandler(ncrs);
+        return;
     } else {
         boost::system::error_code error_code = callback->getErrorCode();
         if (error_code.value() == boost::asio::error::operation_aborted) {
@@ -296,6 +310,24 @@ NameChangeUDPSender::doSend(NameChangeRequestPtr& ncr) {
     isc::util::OutputBuffer ncr_buffer(SEND_BUF_MAX);
     ncr->toFormat(format_, ncr_buffer);
 
+    // In binary format pack the requests queued behind this one in the
+    // same datagram, as many as fit.  Note the first one is the request
+    // given to us.
+    if (format_ == FMT_BINARY) {
+        const SendQueue& queue = getSendQueue();
+        size_t batch_size = 1;
+        for (; batch_size < queue.size(); ++batch_size) {
+            size_t length = ncr_buffer.getLength();
+            queue[batch_size]->toFormat(format_, ncr_buffer);
+            if (ncr_buffer.getLength() > SEND_BUF_MAX) {
+                ncr_buffer.trim(ncr_buffer.getLength() - length);
+                break;
+            }
+        }
+
+        setBatchSize(batch_size);
+    }
+
     // Copy the wire-ized request to callback.  This way we know after
     // send completes what we sent (or attempted to send).
     send_callback_->putData(static_cast<const uint8_t*>(ncr_buffer.getData()),
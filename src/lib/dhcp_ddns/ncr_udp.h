@@ -326,8 +326,8 @@ public:
     ///
     /// @param ip_address is the network address on which to listen
     /// @param port is the UDP port on which to listen
-    /// @param format is the wire format of the inbound requests. Currently
-    /// only JSON is supported
+    /// @param format is the wire format of the inbound requests. A datagram
+    /// may hold several requests one after the other.
     /// @param ncr_recv_handler the receive handler object to notify when
     /// a receive completes.
     /// @param reuse_address enables IP address sharing when true
@@ -378,13 +378,13 @@ public:
     /// passing in the boolean success indicator and pointer to itself.
     ///
     /// If the indicator denotes success, then the method will attempt to
-    /// to construct a NameChangeRequest from the received data.  If the
-    /// construction was successful, it will send the new NCR to the
-    /// application layer by calling invokeRecvHandler() with a success
-    /// status and a pointer to the new NCR.
+    /// to construct NameChangeRequests from the received data, until its
+    /// end.  It will send the new NCRs to the application layer by calling
+    /// invokeRecvHandler() with the list of the new NCRs.
     ///
     /// If the buffer contains invalid data such that construction fails,
-    /// the method will log the failure and then call doReceive() to start a
+    /// the method will log the failure and ignore the rest of the data. If
+    /// no NCR could be constructed, it then calls doReceive() to start a
     /// initiate the next receive.
     ///
     /// If the indicator denotes failure the method will log the failure and
@@ -497,6 +497,11 @@ public:
     /// asyncSend() method is called, passing in send_callback_ member's
     /// transfer buffer as the send buffer and the send_callback_ itself
     /// as the callback object.
+    ///
+    /// In binary format, the requests queued behind the given one are
+    /// packed into the same datagram, as long as they fit in it, so a
+    /// single send carries them all.
+    ///
     /// @param ncr NameChangeRequest to send.
     virtual void doSend(NameChangeRequestPtr& ncr);
 
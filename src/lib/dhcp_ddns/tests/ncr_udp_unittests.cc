@@ -997,6 +997,19 @@ public:
         received_ncrs_.clear();
     }
 
+    /// @brief Recreates the listener and the sender with the given format.
+    ///
+    /// @param format the wire format of the requests
+    void setFormat(const NameChangeFormat format) {
+        isc::asiolink::IOAddress addr(TEST_ADDRESS);
+        listener_.reset(
+            new NameChangeUDPListener(addr, LISTENER_PORT, format,
+                                      *this, true));
+        sender_.reset(
+            new NameChangeUDPSender(addr, SENDER_PORT, addr, LISTENER_PORT,
+                                    format, *this, 100, true));
+    }
+
     /// @brief Implements the receive completion handler.
     virtual void operator ()(const NameChangeListener::Result result,
                              NameChangeRequestPtr& ncr) {
@@ -1177,6 +1190,53 @@ TEST_F(NameChangeUDPTest, roundTripTestMultiThreading) {
     EXPECT_FALSE(sender_->amSending());
 }
 
+/// @brief Uses a sender and listener to test UDP-based NCR delivery in
+/// binary format.
+/// Conducts a "round-trip" test using a sender to transmit a set of valid
+/// NCRs to a listener.  The test verifies that the requests queued while
+/// a send is in progress are sent together and that what was sent matches
+/// what was received both in quantity and in content.
+TEST_F(NameChangeUDPTest, roundTripBinaryTest) {
+    setFormat(FMT_BINARY);
+
+    // Place the listener and the sender into their states.
+    ASSERT_NO_THROW(listener_->startListening(io_service_));
+    ASSERT_NO_THROW(sender_->startSending(io_service_));
+
+    // Get the number of messages in the list of test messages.
+    int num_msgs = sizeof(valid_msgs)/sizeof(char*);
+    for (int i = 0; i < num_msgs; i++) {
+        NameChangeRequestPtr ncr;
+        ASSERT_NO_THROW(ncr = NameChangeRequest::fromJSON(valid_msgs[i]));
+        sender_->sendRequest(ncr);
+    }
+
+    // Execute callbacks until we have sent and received all of messages,
+    // keeping track of the largest number of requests sent at once.
+    size_t max_batch = 0;
+    while (sender_->getQueueSize() > 0 || (received_ncrs_.size() < num_msgs)) {
+        size_t sent = sent_ncrs_.size();
+        EXPECT_NO_THROW(io_service_.run_one());
+        max_batch = std::max(max_batch, sent_ncrs_.size() - sent);
+    }
+
+    // The first request went alone, the others together.
+    EXPECT_EQ(num_msgs - 1, max_batch);
+
+    // We should have the same number of sends and receives as we do messages.
+    ASSERT_EQ(num_msgs, sent_ncrs_.size());
+    ASSERT_EQ(num_msgs, received_ncrs_.size());
+    EXPECT_EQ(NameChangeSender::SUCCESS, send_result_);
+    EXPECT_EQ(NameChangeListener::SUCCESS, recv_result_);
+
+    // Check if the payload was received, ignoring the order if necessary.
+    checkUnordered(num_msgs, sent_ncrs_, received_ncrs_);
+
+    EXPECT_NO_THROW(listener_->stopListening());
+    EXPECT_NO_THROW(io_service_.run_one());
+    EXPECT_NO_THROW(sender_->stopSending());
+}
+
 // Tests error handling of a failure to mark the watch socket ready, when
 // sendRequest() is called.
 TEST_F(NameChangeUDPSenderBasicTest, watchClosedBeforeSendRequest) {
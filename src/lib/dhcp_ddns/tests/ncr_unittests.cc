@@ -667,6 +667,48 @@ TEST(NameChangeRequestTest, toFromBufferTest) {
     ASSERT_EQ(final_str, msg_str);
 }
 
+/// @brief Tests converting to and from the binary format via isc::util
+/// buffer classes.
+/// This test verifies that:
+/// 1. Several NameChangeRequests can be rendered in binary format one after
+/// the other in the same OutputBuffer, each in fewer bytes than in JSON
+/// 2. The requests can be read back from an InputBuffer, unchanged
+/// 3. A truncated binary rendition is rejected.
+TEST(NameChangeRequestTest, toFromBinaryBufferTest) {
+    std::vector<NameChangeRequestPtr> ncrs;
+    isc::util::OutputBuffer output_buffer(1024);
+    int num_msgs = sizeof(valid_msgs)/sizeof(char*);
+    for (int i = 0; i < num_msgs; ++i) {
+        NameChangeRequestPtr ncr;
+        ASSERT_NO_THROW(ncr = NameChangeRequest::fromJSON(valid_msgs[i]));
+        ncrs.push_back(ncr);
+
+        size_t length = output_buffer.getLength();
+        ASSERT_NO_THROW(ncr->toFormat(FMT_BINARY, output_buffer));
+        EXPECT_LT(output_buffer.getLength() - length,
+                  ncr->toJSON().size() + sizeof(uint16_t));
+    }
+
+    // Read the requests back.
+    isc::util::InputBuffer input_buffer(output_buffer.getData(),
+                                        output_buffer.getLength());
+    for (int i = 0; i < num_msgs; ++i) {
+        NameChangeRequestPtr ncr;
+        ASSERT_NO_THROW(ncr = NameChangeRequest::fromFormat(FMT_BINARY,
+                                                            input_buffer));
+        ASSERT_TRUE(ncr);
+        EXPECT_EQ(ncrs[i]->toJSON(), ncr->toJSON());
+    }
+    EXPECT_EQ(input_buffer.getLength(), input_buffer.getPosition());
+
+    // A truncated request must be rejected: keep the length of the first
+    // record but not its last byte.
+    size_t length = (output_buffer[0] << 8) | output_buffer[1];
+    isc::util::InputBuffer truncated(output_buffer.getData(), length + 1);
+    EXPECT_THROW(NameChangeRequest::fromFormat(FMT_BINARY, truncated),
+                 NcrMessageError);
+}
+
 /// @brief Tests ip address modification and validation
 TEST(NameChangeRequestTest, ipAddresses) {
     NameChangeRequest ncr;
@@ -693,9 +735,12 @@ TEST(NameChangeRequestTest, ipAddresses) {
 TEST(NameChangeFormatTest, formatEnumConversion){
     ASSERT_EQ(stringToNcrFormat("JSON"), dhcp_ddns::FMT_JSON);
     ASSERT_EQ(stringToNcrFormat("jSoN"), dhcp_ddns::FMT_JSON);
+    ASSERT_EQ(stringToNcrFormat("BINARY"), dhcp_ddns::FMT_BINARY);
+    ASSERT_EQ(stringToNcrFormat("binary"), dhcp_ddns::FMT_BINARY);
     ASSERT_THROW(stringToNcrFormat("bogus"), isc::BadValue);
 
     ASSERT_EQ(ncrFormatToString(dhcp_ddns::FMT_JSON), "JSON");
+    ASSERT_EQ(ncrFormatToString(dhcp_ddns::FMT_BINARY), "BINARY");
 }
 
 /// @brief Tests conversion of NameChangeProtocol between enum and strings.
@@ -400,17 +400,13 @@ AllocEngine::findReservation(ClientContext6& ctx) {
                     ctx.hosts_[subnet->getID()] = host_map[subnet->getID()];
                 }
             } else {
-                for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-                    // Attempt to find a host using a specified identifier.
-                    ConstHostPtr host = HostMgr::instance().get6(subnet->getID(),
-                                                                 id_pair.first,
-                                                                 &id_pair.second[0],
-                                                                 id_pair.second.size());
-                    // If we found matching host for this subnet.
-                    if (host) {
-                        ctx.hosts_[subnet->getID()] = host;
-                        break;
-                    }
+                // Look for all the identifiers at once: the host manager
+                // returns the host using the first one with a reservation.
+                ConstHostPtr host = HostMgr::instance().get6(subnet->getID(),
+                                                             ctx.host_identifiers_);
+                // If we found matching host for this subnet.
+                if (host) {
+                    ctx.hosts_[subnet->getID()] = host;
                 }
             }
         }
@@ -424,19 +420,9 @@ AllocEngine::findReservation(ClientContext6& ctx) {
 
 ConstHostPtr
 AllocEngine::findGlobalReservation(ClientContext6& ctx) {
-    ConstHostPtr host;
-    for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-        // Attempt to find a host using a specified identifier.
-        host = HostMgr::instance().get6(SUBNET_ID_GLOBAL, id_pair.first,
-                                        &id_pair.second[0], id_pair.second.size());
-
-        // If we found matching global host we're done.
-        if (host) {
-            break;
-        }
-    }
-
-    return (host);
+    // Attempt to find a host using the specified identifiers in the
+    // order of preference.
+    return (HostMgr::instance().get6(SUBNET_ID_GLOBAL, ctx.host_identifiers_));
 }
 
 Lease6Collection
@@ -3522,17 +3508,13 @@ AllocEngine::findReservation(ClientContext4& ctx) {
                     ctx.hosts_[subnet->getID()] = host_map[subnet->getID()];
                 }
             } else {
-                for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-                    // Attempt to find a host using a specified identifier.
-                    ConstHostPtr host = HostMgr::instance().get4(subnet->getID(),
-                                                                 id_pair.first,
-                                                                 &id_pair.second[0],
-                                                                 id_pair.second.size());
-                    // If we found matching host for this subnet.
-                    if (host) {
-                        ctx.hosts_[subnet->getID()] = host;
-                        break;
-                    }
+                // Look for all the identifiers at once: the host manager
+                // returns the host using the first one with a reservation.
+                ConstHostPtr host = HostMgr::instance().get4(subnet->getID(),
+                                                             ctx.host_identifiers_);
+                // If we found matching host for this subnet.
+                if (host) {
+                    ctx.hosts_[subnet->getID()] = host;
                 }
             }
         }
@@ -3546,19 +3528,9 @@ AllocEngine::findReservation(ClientContext4& ctx) {
 
 ConstHostPtr
 AllocEngine::findGlobalReservation(ClientContext4& ctx) {
-    ConstHostPtr host;
-    for (const IdentifierPair& id_pair : ctx.host_identifiers_) {
-        // Attempt to find a host using a specified identifier.
-        host = HostMgr::instance().get4(SUBNET_ID_GLOBAL, id_pair.first,
-                                        &id_pair.second[0], id_pair.second.size());
-
-        // If we found matching global host we're done.
-        if (host) {
-            break;
-        }
-    }
-
-    return (host);
+    // Attempt to find a host using the specified identifiers in the
+    // order of preference.
+    return (HostMgr::instance().get4(SUBNET_ID_GLOBAL, ctx.host_identifiers_));
 }
 
 Lease4Ptr
@@ -17,6 +17,7 @@
 #include <dhcp/option6_iaaddr.h>
 #include <dhcp/option6_iaprefix.h>
 #include <dhcpsrv/allocator.h>
+#include <dhcpsrv/base_host_data_source.h>
 #include <dhcpsrv/d2_client_cfg.h>
 #include <dhcpsrv/host.h>
 #include <dhcpsrv/subnet.h>
@@ -188,10 +189,10 @@ public:
     typedef std::set<Resource, ResourceCompare> ResourceContainer;
 
     /// @brief A tuple holding host identifier type and value.
-    typedef std::pair<Host::IdentifierType, std::vector<uint8_t> > IdentifierPair;
+    typedef HostIdentifierPair IdentifierPair;
 
     /// @brief Map holding values to be used as host identifiers.
-    typedef std::list<IdentifierPair> IdentifierList;
+    typedef HostIdentifierList IdentifierList;
 
     /// @brief Context information for the DHCPv6 leases allocation.
     ///
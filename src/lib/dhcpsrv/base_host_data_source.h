@@ -14,6 +14,8 @@
 #include <boost/shared_ptr.hpp>
 
 #include <limits>
+#include <list>
+#include <utility>
 #include <vector>
 
 namespace isc {
@@ -71,6 +73,12 @@ public:
     const size_t page_size_; ///< Holds page size.
 };
 
+/// @brief A tuple holding host identifier type and value.
+typedef std::pair<Host::IdentifierType, std::vector<uint8_t> > HostIdentifierPair;
+
+/// @brief List of host identifiers in the order of preference.
+typedef std::list<HostIdentifierPair> HostIdentifierList;
+
 /// @brief Base interface for the classes implementing simple data source
 /// for host reservations.
 ///
@@ -408,6 +416,60 @@ public:
     getAll6(const SubnetID& subnet_id,
             const asiolink::IOAddress& address) const = 0;
 
+    /// @brief Returns the hosts connected to the IPv4 subnet and using
+    /// any of the specified identifiers.
+    ///
+    /// This allows for retrieving in one lookup the reservations of a
+    /// client which presents several identifiers (e.g. HW address,
+    /// client identifier and circuit id). The default implementation
+    /// calls @c get4 for each identifier: backends with costly lookups,
+    /// e.g. SQL databases, should override it with a single query.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects, at most one per
+    /// identifier, in no particular order.
+    virtual ConstHostCollection
+    getAllbyIdentifiers4(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const {
+        ConstHostCollection hosts;
+        for (auto const& id_pair : identifiers) {
+            ConstHostPtr host = get4(subnet_id, id_pair.first,
+                                     id_pair.second.data(),
+                                     id_pair.second.size());
+            if (host) {
+                hosts.push_back(host);
+            }
+        }
+        return (hosts);
+    }
+
+    /// @brief Returns the hosts connected to the IPv6 subnet and using
+    /// any of the specified identifiers.
+    ///
+    /// The default implementation calls @c get6 for each identifier.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects, at most one per
+    /// identifier, in no particular order.
+    virtual ConstHostCollection
+    getAllbyIdentifiers6(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const {
+        ConstHostCollection hosts;
+        for (auto const& id_pair : identifiers) {
+            ConstHostPtr host = get6(subnet_id, id_pair.first,
+                                     id_pair.second.data(),
+                                     id_pair.second.size());
+            if (host) {
+                hosts.push_back(host);
+            }
+        }
+        return (hosts);
+    }
+
     /// @brief Adds a new host to the collection.
     ///
     /// The implementations of this method should guard against duplicate
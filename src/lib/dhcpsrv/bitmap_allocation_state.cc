@@ -0,0 +1,259 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <exceptions/exceptions.h>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+
+using namespace isc::asiolink;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Returns the index of the lowest set bit of a non-zero word.
+///
+/// It uses a De Bruijn sequence to remain portable.
+///
+/// @param word non-zero word.
+/// @return index of the lowest set bit.
+unsigned
+lowestBit(uint64_t word) {
+    static const unsigned table[64] = {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+    };
+    return (table[((word & (~word + 1)) * 0x03f79d71b4cb0a89ULL) >> 58]);
+}
+
+/// @brief Converts an address to a number.
+///
+/// @param address IPv4 or IPv6 address.
+/// @return address as a number.
+uint128_t
+toNumber(const IOAddress& address) {
+    if (address.isV4()) {
+        return (address.toUint32());
+    }
+    uint128_t value = 0;
+    for (auto byte : address.toBytes()) {
+        value = (value << 8) | byte;
+    }
+    return (value);
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const uint64_t PoolBitmapAllocationState::MAX_CAPACITY = 1ULL << 24;
+
+bool
+PoolBitmapAllocationState::isSupported(const PoolPtr& pool) {
+    return (pool->getCapacity() <= MAX_CAPACITY);
+}
+
+PoolBitmapAllocationStatePtr
+PoolBitmapAllocationState::create(const PoolPtr& pool) {
+    uint8_t prefix_len = 128;
+    if (pool->getType() == Lease::TYPE_PD) {
+        auto pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+        if (pool6) {
+            prefix_len = pool6->getLength();
+        }
+    }
+    return (boost::make_shared<PoolBitmapAllocationState>(pool->getType(),
+                                                          pool->getFirstAddress(),
+                                                          pool->getLastAddress(),
+                                                          prefix_len));
+}
+
+PoolBitmapAllocationState::PoolBitmapAllocationState(Lease::Type type,
+                                                     const IOAddress& first,
+                                                     const IOAddress& last,
+                                                     uint8_t prefix_len)
+    : AllocationState(), type_(type), first_(toNumber(first)), shift_(0),
+      capacity_(0), free_count_(0), cursor_(0), levels_() {
+    if ((type == Lease::TYPE_PD) && (prefix_len < 128)) {
+        shift_ = 128 - prefix_len;
+    }
+    uint128_t last_value = toNumber(last);
+    if ((first.getFamily() != last.getFamily()) || (last_value < first_)) {
+        isc_throw(BadValue, "invalid pool range " << first << " - " << last);
+    }
+    uint128_t capacity = ((last_value - first_) >> shift_) + 1;
+    if (capacity > MAX_CAPACITY) {
+        isc_throw(BadValue, "pool " << first << " - " << last << " is too large"
+                  " for the bitmap allocator: it holds " << capacity
+                  << " leases, maximum is " << MAX_CAPACITY);
+    }
+    capacity_ = static_cast<uint64_t>(capacity);
+
+    // Allocate the levels until a level fits in one word.
+    uint64_t bits = capacity_;
+    do {
+        bits = (bits + 63) / 64;
+        levels_.push_back(std::vector<uint64_t>(bits, 0));
+    } while (bits > 1);
+}
+
+void
+PoolBitmapAllocationState::addAllFreeLeases() {
+    // Set all bits of the lowest level except the padding of the last word.
+    auto& leaves = levels_[0];
+    std::fill(leaves.begin(), leaves.end(), ~0ULL);
+    if (capacity_ % 64) {
+        leaves.back() = (1ULL << (capacity_ % 64)) - 1;
+    }
+    // Rebuild the summary levels.
+    for (size_t level = 1; level < levels_.size(); ++level) {
+        auto& lower = levels_[level - 1];
+        auto& upper = levels_[level];
+        std::fill(upper.begin(), upper.end(), 0);
+        for (uint64_t word = 0; word < lower.size(); ++word) {
+            if (lower[word]) {
+                upper[word >> 6] |= 1ULL << (word & 63);
+            }
+        }
+    }
+    free_count_ = capacity_;
+}
+
+void
+PoolBitmapAllocationState::addFreeLease(const IOAddress& address) {
+    uint64_t index;
+    if (toIndex(address, index) && setBit(index)) {
+        ++free_count_;
+    }
+}
+
+void
+PoolBitmapAllocationState::deleteFreeLease(const IOAddress& address) {
+    uint64_t index;
+    if (toIndex(address, index) && clearBit(index)) {
+        --free_count_;
+    }
+}
+
+IOAddress
+PoolBitmapAllocationState::offerFreeLease() {
+    if (free_count_ == 0) {
+        return (type_ == Lease::TYPE_V4 ? IOAddress::IPV4_ZERO_ADDRESS() :
+                IOAddress::IPV6_ZERO_ADDRESS());
+    }
+    uint64_t index = findNext(cursor_);
+    if (index >= capacity_) {
+        // Wrap around.
+        index = findNext(0);
+    }
+    cursor_ = index + 1;
+    if (cursor_ >= capacity_) {
+        cursor_ = 0;
+    }
+    return (toAddress(index));
+}
+
+bool
+PoolBitmapAllocationState::toIndex(const IOAddress& address, uint64_t& index) const {
+    if (address.isV4() != (type_ == Lease::TYPE_V4)) {
+        return (false);
+    }
+    uint128_t value = toNumber(address);
+    if (value < first_) {
+        return (false);
+    }
+    value = (value - first_) >> shift_;
+    if (value >= capacity_) {
+        return (false);
+    }
+    index = static_cast<uint64_t>(value);
+    return (true);
+}
+
+IOAddress
+PoolBitmapAllocationState::toAddress(uint64_t index) const {
+    uint128_t value = first_ + (uint128_t(index) << shift_);
+    if (type_ == Lease::TYPE_V4) {
+        return (IOAddress(static_cast<uint32_t>(value)));
+    }
+    uint8_t bytes[V6ADDRESS_LEN];
+    for (int i = V6ADDRESS_LEN - 1; i >= 0; --i) {
+        bytes[i] = static_cast<uint8_t>(value & 0xff);
+        value >>= 8;
+    }
+    return (IOAddress::fromBytes(AF_INET6, bytes));
+}
+
+bool
+PoolBitmapAllocationState::setBit(uint64_t index) {
+    if (levels_[0][index >> 6] & (1ULL << (index & 63))) {
+        return (false);
+    }
+    for (auto& level : levels_) {
+        uint64_t& word = level[index >> 6];
+        bool was_zero = (word == 0);
+        word |= 1ULL << (index & 63);
+        if (!was_zero) {
+            // The upper levels already flag this word.
+            break;
+        }
+        index >>= 6;
+    }
+    return (true);
+}
+
+bool
+PoolBitmapAllocationState::clearBit(uint64_t index) {
+    if (!(levels_[0][index >> 6] & (1ULL << (index & 63)))) {
+        return (false);
+    }
+    for (auto& level : levels_) {
+        uint64_t& word = level[index >> 6];
+        word &= ~(1ULL << (index & 63));
+        if (word) {
+            // Other bits remain set so the upper levels are unchanged.
+            break;
+        }
+        index >>= 6;
+    }
+    return (true);
+}
+
+uint64_t
+PoolBitmapAllocationState::findNext(uint64_t index) const {
+    // Go up until a word holds a set bit at or after the index.
+    size_t level = 0;
+    for (;;) {
+        if (level >= levels_.size()) {
+            return (capacity_);
+        }
+        uint64_t word = index >> 6;
+        if (word >= levels_[level].size()) {
+            return (capacity_);
+        }
+        uint64_t bits = levels_[level][word] & (~0ULL << (index & 63));
+        if (bits) {
+            index = (word << 6) + lowestBit(bits);
+            break;
+        }
+        // Continue with the next word, i.e. the next bit of the upper level.
+        index = word + 1;
+        ++level;
+    }
+    // Go down following the lowest set bits.
+    while (level > 0) {
+        --level;
+        index = (index << 6) + lowestBit(levels_[level][index]);
+    }
+    return (index);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
@@ -0,0 +1,183 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BITMAP_ALLOCATION_STATE_H
+#define BITMAP_ALLOCATION_STATE_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/pool.h>
+#include <util/bigints.h>
+#include <boost/shared_ptr.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Forward declaration of the @c PoolBitmapAllocationState.
+class PoolBitmapAllocationState;
+
+/// @brief Type of the pointer to the @c PoolBitmapAllocationState.
+typedef boost::shared_ptr<PoolBitmapAllocationState> PoolBitmapAllocationStatePtr;
+
+/// @brief Pool allocation state used by the bitmap allocator.
+///
+/// The state holds one bit per address or delegated prefix of the pool.
+/// A set bit denotes a free lease. The bitmap is hierarchical: a bit of
+/// the summary level @c n+1 is set when the corresponding 64-bit word of
+/// the level @c n is not zero. Looking for the next free lease walks up
+/// and down these levels, i.e., it checks at most two words per level
+/// regardless of the number of allocated leases. The bitmap is allocated
+/// with the state so the pools are limited to @c MAX_CAPACITY leases,
+/// which use four levels and a little more than 2MB.
+///
+/// Free leases are offered in the ascending order, starting after the
+/// last offered lease and wrapping around at the end of the pool.
+class PoolBitmapAllocationState : public AllocationState {
+public:
+
+    /// @brief Maximum number of leases in a pool (2^24).
+    static const uint64_t MAX_CAPACITY;
+
+    /// @brief Checks if a pool is small enough for a bitmap.
+    ///
+    /// The subnets fall back to the iterative allocator when a pool is
+    /// too large.
+    ///
+    /// @param pool pool to check.
+    /// @return true if the pool holds at most @c MAX_CAPACITY leases.
+    static bool isSupported(const PoolPtr& pool);
+
+    /// @brief Factory function creating the state instance from a pool.
+    ///
+    /// @param pool instance of the pool for which the allocation state
+    /// should be instantiated.
+    /// @return new allocation state instance.
+    /// @throw BadValue if the pool is too large.
+    static PoolBitmapAllocationStatePtr create(const PoolPtr& pool);
+
+    /// @brief Constructor.
+    ///
+    /// Instantiates the allocation state for a range of addresses or
+    /// delegated prefixes. All leases are initially allocated.
+    ///
+    /// @param type lease type.
+    /// @param first first address or prefix in the pool.
+    /// @param last last address in the pool.
+    /// @param prefix_len length of the delegated prefixes. It is ignored
+    /// for the address pools.
+    /// @throw BadValue if the pool is too large.
+    PoolBitmapAllocationState(Lease::Type type,
+                              const asiolink::IOAddress& first,
+                              const asiolink::IOAddress& last,
+                              uint8_t prefix_len = 128);
+
+    /// @brief Checks if the pool has run out of free leases.
+    ///
+    /// @return true if the pool has no free leases, false otherwise.
+    bool exhausted() const {
+        return (free_count_ == 0);
+    }
+
+    /// @brief Marks all leases of the pool as free.
+    void addAllFreeLeases();
+
+    /// @brief Marks a lease as free.
+    ///
+    /// Addresses out of the pool are ignored.
+    ///
+    /// @param address lease address.
+    void addFreeLease(const asiolink::IOAddress& address);
+
+    /// @brief Marks a lease as allocated.
+    ///
+    /// Addresses out of the pool are ignored.
+    ///
+    /// @param address lease address.
+    void deleteFreeLease(const asiolink::IOAddress& address);
+
+    /// @brief Returns next available lease.
+    ///
+    /// @return next free lease address or IPv4/IPv6 zero address when
+    /// there are no free leases.
+    asiolink::IOAddress offerFreeLease();
+
+    /// @brief Returns the current number of free leases.
+    ///
+    /// @return the number of free leases.
+    uint64_t getFreeLeaseCount() const {
+        return (free_count_);
+    }
+
+    /// @brief Returns the number of leases in the pool.
+    ///
+    /// @return the pool capacity.
+    uint64_t getCapacity() const {
+        return (capacity_);
+    }
+
+private:
+
+    /// @brief Converts an address to a lease index.
+    ///
+    /// @param address lease address.
+    /// @param [out] index lease index in the pool.
+    /// @return false if the address is out of the pool.
+    bool toIndex(const asiolink::IOAddress& address, uint64_t& index) const;
+
+    /// @brief Converts a lease index to an address.
+    ///
+    /// @param index lease index in the pool.
+    /// @return lease address.
+    asiolink::IOAddress toAddress(uint64_t index) const;
+
+    /// @brief Sets a bit of the lowest level and updates the summary levels.
+    ///
+    /// @param index lease index.
+    /// @return false if the bit was already set.
+    bool setBit(uint64_t index);
+
+    /// @brief Clears a bit of the lowest level and updates the summary levels.
+    ///
+    /// @param index lease index.
+    /// @return false if the bit was already cleared.
+    bool clearBit(uint64_t index);
+
+    /// @brief Finds the first set bit at or after an index.
+    ///
+    /// @param index lease index to start from.
+    /// @return index of the set bit or the capacity if there is none.
+    uint64_t findNext(uint64_t index) const;
+
+    /// @brief Lease type.
+    Lease::Type type_;
+
+    /// @brief First address of the pool as a number.
+    util::uint128_t first_;
+
+    /// @brief Number of bits between two delegated prefixes (0 for
+    /// addresses).
+    unsigned shift_;
+
+    /// @brief Number of leases in the pool.
+    uint64_t capacity_;
+
+    /// @brief Number of free leases.
+    uint64_t free_count_;
+
+    /// @brief Index of the next lease to look at when offering a lease.
+    uint64_t cursor_;
+
+    /// @brief Bitmap levels from the lease bits to a single summary word.
+    std::vector<std::vector<uint64_t>> levels_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // BITMAP_ALLOCATION_STATE_H
@@ -0,0 +1,188 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BITMAP_ALLOCATOR_H
+#define BITMAP_ALLOCATOR_H
+
+#include <dhcpsrv/allocator.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <cstdint>
+#include <random>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief An allocator maintaining a bitmap of free leases in each pool.
+///
+/// This allocator works like the @c FreeLeaseQueueAllocator: it tracks the
+/// free leases during the initialization and installs the callbacks in the
+/// @c LeaseMgr to follow the subsequent lease changes, so it offers leases
+/// which are very likely free. However, it uses a hierarchical bitmap
+/// holding one bit per lease instead of a queue of free leases, which
+/// makes it suitable for much larger pools: a /10 IPv4 pool takes 512kB.
+/// The initialization marks all leases free at once and then walks over
+/// the existing leases only.
+///
+/// The pools are limited to 2^24 leases, so this allocator is not suitable
+/// for a typical IPv6 address pool (e.g., /64): the subnets with a larger
+/// pool use the iterative allocator instead.
+///
+/// Free leases are offered in the ascending order within a pool, the pool
+/// being selected randomly among the available ones.
+class BitmapAllocator : public Allocator {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param type specifies the type of allocated leases.
+    /// @param subnet weak pointer to the subnet owning the allocator.
+    BitmapAllocator(Lease::Type type, const WeakSubnetPtr& subnet);
+
+    /// @brief Returns the allocator type string.
+    ///
+    /// @return bitmap string.
+    virtual std::string getType() const {
+        return ("bitmap");
+    }
+
+private:
+
+    /// @brief Performs allocator initialization after server's reconfiguration.
+    ///
+    /// The allocator marks the free leases in the pool bitmaps and installs
+    /// the callbacks in the lease manager to keep track of the lease
+    /// allocations.
+    virtual void initAfterConfigureInternal();
+
+    /// @brief Marks the free leases in the pool bitmaps.
+    ///
+    /// All leases are first marked free, then the valid leases in the
+    /// database are marked allocated.
+    ///
+    /// @param leases collection of leases in the database for a subnet.
+    /// @param pools collection of pools in the subnet.
+    /// @tparam LeaseCollectionType Type of the lease collection returned from the
+    /// database (i.e., @c Lease4Collection or @c Lease6Collection).
+    template<typename LeaseCollectionType>
+    void populateFreeLeases(const LeaseCollectionType& leases, const PoolCollection& pools);
+
+    /// @brief Returns next available address from a pool bitmap.
+    ///
+    /// Internal thread-unsafe implementation of the @c pickAddress.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    /// @param duid client DUID (ignored).
+    /// @param hint client hint (ignored).
+    ///
+    /// @return next offered address.
+    virtual asiolink::IOAddress pickAddressInternal(const ClientClasses& client_classes,
+                                                    const IdentifierBaseTypePtr& duid,
+                                                    const asiolink::IOAddress& hint);
+
+    /// @brief Returns next available delegated prefix from a pool bitmap.
+    ///
+    /// Internal thread-unsafe implementation of the @c pickPrefix.
+    ///
+    /// @param client_classes list of classes client belongs to.
+    /// @param pool the selected pool satisfying all required conditions.
+    /// @param duid Client's DUID.
+    /// @param prefix_length_match type which indicates the selection criteria
+    ///        for the pools relative to the provided hint prefix length
+    /// @param hint Client's hint.
+    /// @param hint_prefix_length the hint prefix length that the client
+    ///        provided. The 0 value means that there is no hint and that any
+    ///        pool will suffice.
+    ///
+    /// @return the next prefix.
+    virtual isc::asiolink::IOAddress
+    pickPrefixInternal(const ClientClasses& client_classes,
+                       Pool6Ptr& pool,
+                       const IdentifierBaseTypePtr& duid,
+                       PrefixLenMatchType prefix_length_match,
+                       const isc::asiolink::IOAddress& hint,
+                       uint8_t hint_prefix_length);
+
+    /// @brief Convenience function returning pool allocation state instance.
+    ///
+    /// It creates a new pool state instance and assigns it to the pool
+    /// if it hasn't been initialized.
+    ///
+    /// @param pool pool instance.
+    /// @return allocation state instance for the pool.
+    PoolBitmapAllocationStatePtr getPoolState(const PoolPtr& pool) const;
+
+    /// @brief Returns a pool in the subnet the lease belongs to.
+    ///
+    /// @param lease lease instance for which the pool should be returned.
+    /// @return A pool found for a lease or null pointer if such a pool does
+    /// not exist.
+    PoolPtr getLeasePool(const LeasePtr& lease) const;
+
+    /// @brief Thread safe callback for adding a lease.
+    ///
+    /// Marks the lease allocated.
+    ///
+    /// @param lease added lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void addLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread unsafe callback for adding a lease.
+    ///
+    /// Marks the lease allocated.
+    ///
+    /// @param lease added lease.
+    void addLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Thread safe callback for updating a lease.
+    ///
+    /// If the lease is reclaimed in this update it is marked free,
+    /// otherwise it is marked allocated.
+    ///
+    /// @param lease updated lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void updateLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread unsafe callback for updating a lease.
+    ///
+    /// If the lease is reclaimed in this update it is marked free,
+    /// otherwise it is marked allocated.
+    ///
+    /// @param lease updated lease.
+    void updateLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Thread safe callback for deleting a lease.
+    ///
+    /// Marks the lease free.
+    ///
+    /// @param lease deleted lease.
+    /// @param mt_safe a boolean flag indicating if the callback
+    /// has been invoked in the MT-safe context.
+    void deleteLeaseCallback(LeasePtr lease, bool mt_safe);
+
+    /// @brief Thread unsafe callback for deleting a lease.
+    ///
+    /// Marks the lease free.
+    ///
+    /// @param lease deleted lease.
+    void deleteLeaseCallbackInternal(LeasePtr lease);
+
+    /// @brief Convenience function returning a random number.
+    ///
+    /// @param limit upper bound of the range.
+    /// @returns random number between 0 and limit.
+    uint64_t getRandomNumber(uint64_t limit);
+
+    /// @brief Random generator used by this class.
+    std::mt19937 generator_;
+};
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // BITMAP_ALLOCATOR_H
@@ -10,6 +10,7 @@
 #include <dhcpsrv/host_data_source_factory.h>
 #include <dhcpsrv/host_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/mem_host_cache.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
@@ -24,7 +25,8 @@ namespace dhcp {
 CfgDbAccess::CfgDbAccess()
     : appended_parameters_(), lease_db_access_("type=memfile"),
       host_db_access_(), ip_reservations_unique_(true),
-      extended_info_tables_enabled_(false) {
+      extended_info_tables_enabled_(false), host_cache_max_entries_(0),
+      host_cache_ttl_(MemHostCache::DEFAULT_TTL) {
 }
 
 std::string
@@ -61,13 +63,22 @@ CfgDbAccess::createManagers() const {
     // Recreate host data source.
     HostMgr::create();
 
+    std::list<std::string> host_db_access_list = getHostDbAccessStringList();
+
     // Restore the host cache.
     if (HostDataSourceFactory::registeredFactory("cache")) {
         HostMgr::addBackend("type=cache");
+    } else if ((host_cache_max_entries_ > 0) && !host_db_access_list.empty()) {
+        // Use the built-in host cache with negative caching.
+        std::ostringstream s;
+        s << "type=" << MemHostCache::TYPE
+          << " max-entries=" << host_cache_max_entries_
+          << " ttl=" << host_cache_ttl_;
+        HostMgr::addBackend(s.str());
+        HostMgr::instance().setNegativeCaching(true);
     }
 
     // Add database backends.
-    std::list<std::string> host_db_access_list = getHostDbAccessStringList();
     for (std::string& hds : host_db_access_list) {
         HostMgr::addBackend(hds);
     }
@@ -117,6 +117,43 @@ public:
         return (extended_info_tables_enabled_);
     }
 
+    /// @brief Sets the maximum number of entries of the built-in host
+    /// cache.
+    ///
+    /// When not 0 and host databases are configured, the @c createManagers
+    /// function puts the built-in host cache in front of them, unless
+    /// a host cache library is loaded.
+    ///
+    /// @param max_entries The maximum number of entries, 0 disables
+    /// the built-in host cache.
+    void setHostCacheMaxEntries(const size_t max_entries) {
+        host_cache_max_entries_ = max_entries;
+    }
+
+    /// @brief Returns the maximum number of entries of the built-in host
+    /// cache.
+    ///
+    /// @return The maximum number of entries, 0 when disabled.
+    size_t getHostCacheMaxEntries() const {
+        return (host_cache_max_entries_);
+    }
+
+    /// @brief Sets the time to live of the entries of the built-in host
+    /// cache.
+    ///
+    /// @param ttl The time to live in seconds, 0 means no expiration.
+    void setHostCacheTtl(const uint32_t ttl) {
+        host_cache_ttl_ = ttl;
+    }
+
+    /// @brief Returns the time to live of the entries of the built-in
+    /// host cache.
+    ///
+    /// @return The time to live in seconds.
+    uint32_t getHostCacheTtl() const {
+        return (host_cache_ttl_);
+    }
+
     /// @brief Creates instance of lease manager and host data sources
     /// according to the configuration specified.
     void createManagers() const;
@@ -145,6 +182,14 @@ protected:
     /// @brief Holds the setting whether the lease extended info tables
     /// are enabled or disabled. The default is disabled.
     bool extended_info_tables_enabled_;
+
+    /// @brief Holds the maximum number of entries of the built-in host
+    /// cache. The default is 0 (disabled).
+    size_t host_cache_max_entries_;
+
+    /// @brief Holds the time to live of the entries of the built-in host
+    /// cache in seconds.
+    uint32_t host_cache_ttl_;
 };
 
 /// @brief A pointer to the @c CfgDbAccess.
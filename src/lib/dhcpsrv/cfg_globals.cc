@@ -52,6 +52,8 @@ CfgGlobals::nameToIndex = {
     { "parked-packet-limit", PARKED_PACKET_LIMIT },
     { "allocator", ALLOCATOR },
     { "ddns-ttl-percent", DDNS_TTL_PERCENT },
+    { "host-cache-max-entries", HOST_CACHE_MAX_ENTRIES },
+    { "host-cache-ttl", HOST_CACHE_TTL },
 
     // DHCPv4 specific parameters.
     { "echo-client-id", ECHO_CLIENT_ID },
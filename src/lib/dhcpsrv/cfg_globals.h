@@ -75,6 +75,8 @@ public:
         PARKED_PACKET_LIMIT,
         ALLOCATOR,
         DDNS_TTL_PERCENT,
+        HOST_CACHE_MAX_ENTRIES,
+        HOST_CACHE_TTL,
 
         // DHCPv4 specific parameters.
         ECHO_CLIENT_ID,
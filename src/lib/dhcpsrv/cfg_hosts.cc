@@ -745,6 +745,18 @@ CfgHosts::get6(const SubnetID& subnet_id,
                             identifier_len));
 }
 
+ConstHostCollection
+CfgHosts::getAllbyIdentifiers4(const SubnetID& subnet_id,
+                               const HostIdentifierList& identifiers) const {
+    return (getAllbyIdentifiersInternal(subnet_id, false, identifiers));
+}
+
+ConstHostCollection
+CfgHosts::getAllbyIdentifiers6(const SubnetID& subnet_id,
+                               const HostIdentifierList& identifiers) const {
+    return (getAllbyIdentifiersInternal(subnet_id, true, identifiers));
+}
+
 ConstHostPtr
 CfgHosts::get6(const IOAddress& prefix, const uint8_t prefix_len) const {
     return (getHostInternal6<ConstHostPtr>(prefix, prefix_len));
@@ -949,6 +961,50 @@ CfgHosts::getHostInternal(const SubnetID& subnet_id, const bool subnet6,
     return (host);
 }
 
+ConstHostCollection
+CfgHosts::getAllbyIdentifiersInternal(const SubnetID& subnet_id,
+                                      const bool subnet6,
+                                      const HostIdentifierList& identifiers) const {
+    ConstHostCollection hosts;
+    const HostContainerIndex0& idx = hosts_.get<0>();
+    for (auto const& id_pair : identifiers) {
+        // Use the identifier and identifier type as a composite key.
+        HostContainerIndex0Range range =
+            idx.equal_range(boost::make_tuple(id_pair.second, id_pair.first));
+        ConstHostPtr host;
+        for (auto it = range.first; it != range.second; ++it) {
+            SubnetID host_subnet_id = subnet6 ? (*it)->getIPv6SubnetID() :
+                (*it)->getIPv4SubnetID();
+            if (host_subnet_id != subnet_id) {
+                continue;
+            }
+            // Same as in getHostInternal.
+            if (host) {
+                isc_throw(DuplicateHost,  "more than one reservation found"
+                          " for the host belonging to the subnet with id '"
+                          << subnet_id << "' and using the identifier '"
+                          << Host::getIdentifierAsText(id_pair.first,
+                                                       &id_pair.second[0],
+                                                       id_pair.second.size())
+                          << "'");
+            }
+            host = *it;
+        }
+        if (host) {
+            hosts.push_back(host);
+        }
+    }
+
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS,
+              HOSTS_CFG_GET_ALL_SUBNET_ID_IDENTIFIERS_COUNT)
+        .arg(subnet6 ? "IPv6" : "IPv4")
+        .arg(subnet_id)
+        .arg(identifiers.size())
+        .arg(hosts.size());
+
+    return (hosts);
+}
+
 void
 CfgHosts::add(const HostPtr& host) {
     LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE, HOSTS_CFG_ADD_HOST)
@@ -501,6 +501,32 @@ public:
     virtual HostPtr
     get6(const SubnetID& subnet_id, const asiolink::IOAddress& address);
 
+    /// @brief Returns the hosts connected to the IPv4 subnet and using
+    /// any of the specified identifiers.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects.
+    /// @throw isc::dhcp::DuplicateHost if more than one host is found
+    /// for an identifier.
+    virtual ConstHostCollection
+    getAllbyIdentifiers4(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
+    /// @brief Returns the hosts connected to the IPv6 subnet and using
+    /// any of the specified identifiers.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects.
+    /// @throw isc::dhcp::DuplicateHost if more than one host is found
+    /// for an identifier.
+    virtual ConstHostCollection
+    getAllbyIdentifiers6(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
     /// @brief Returns all hosts connected to the IPv6 subnet and having
     /// a reservation for a specified address or delegated prefix (lease).
     ///
@@ -853,6 +879,26 @@ private:
                     const uint8_t* identifier,
                     const size_t identifier_len) const;
 
+    /// @brief Returns the hosts using any of the specified identifiers
+    /// and connected to an IPv4 or IPv6 subnet.
+    ///
+    /// This private method is called by the @c getAllbyIdentifiers4 and
+    /// @c getAllbyIdentifiers6 methods. It probes the identifier index
+    /// once per identifier without copying the hosts using the
+    /// identifier in other subnets.
+    ///
+    /// @param subnet_id IPv4 or IPv6 subnet identifier.
+    /// @param subnet6 A boolean flag which indicates if the subnet identifier
+    /// points to a IPv4 (if false) or IPv6 subnet (if true).
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects.
+    /// @throw isc::dhcp::DuplicateHost if more than one host is found
+    /// for an identifier.
+    ConstHostCollection
+    getAllbyIdentifiersInternal(const SubnetID& subnet_id, const bool subnet6,
+                                const HostIdentifierList& identifiers) const;
+
     /// @brief Returns the @c Host object holding reservation for the IPv6
     /// address and connected to the specific subnet.
     ///
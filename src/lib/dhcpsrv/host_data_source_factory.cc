@@ -9,6 +9,7 @@
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/host_data_source_factory.h>
 #include <dhcpsrv/hosts_log.h>
+#include <dhcpsrv/mem_host_cache.h>
 #include <log/logger_support.h>
 
 #ifdef HAVE_MYSQL
@@ -235,4 +236,25 @@ struct PgSqlHostDataSourceInit {
 PgSqlHostDataSourceInit pgsql_init_;
 #endif
 
+struct MemHostCacheInit {
+    // Constructor registers
+    MemHostCacheInit() {
+        HostDataSourceFactory::registerFactory("memory-cache", factory, true);
+    }
+
+    // Destructor deregisters
+    ~MemHostCacheInit() {
+        HostDataSourceFactory::deregisterFactory("memory-cache", true);
+    }
+
+    // Factory class method
+    static HostDataSourcePtr
+    factory(const DatabaseConnection::ParameterMap& parameters) {
+        return (HostDataSourcePtr(new MemHostCache(parameters)));
+    }
+};
+
+// Built-in host cache will be registered at object initialization
+MemHostCacheInit mem_host_cache_init_;
+
 } // end of anonymous namespace
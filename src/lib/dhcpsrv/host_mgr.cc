@@ -11,6 +11,9 @@
 #include <dhcpsrv/hosts_log.h>
 #include <dhcpsrv/host_data_source_factory.h>
 
+#include <sstream>
+#include <vector>
+
 namespace {
 
 /// @brief Convenience function returning a pointer to the hosts configuration.
@@ -380,6 +383,132 @@ HostMgr::get4(const SubnetID& subnet_id,
     return (host);
 }
 
+ConstHostPtr
+HostMgr::get4(const SubnetID& subnet_id,
+              const HostIdentifierList& identifiers) const {
+    return (getByIdentifiers(subnet_id, false, identifiers));
+}
+
+ConstHostPtr
+HostMgr::getByIdentifiers(const SubnetID& subnet_id, const bool subnet6,
+                          const HostIdentifierList& identifiers) const {
+    std::vector<const HostIdentifierPair*> ids;
+    for (auto const& id_pair : identifiers) {
+        ids.push_back(&id_pair);
+    }
+    // Returns the position of the host identifier in the list.
+    auto index_of = [&ids](const ConstHostPtr& host) -> size_t {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if ((host->getIdentifierType() == ids[i]->first) &&
+                (host->getIdentifier() == ids[i]->second)) {
+                return (i);
+            }
+        }
+        return (ids.size());
+    };
+
+    // The hosts found for each identifier, the identifiers which are
+    // negatively cached and the position of the best match.
+    std::vector<ConstHostPtr> found(ids.size());
+    std::vector<bool> negative(ids.size(), false);
+    size_t best = ids.size();
+    HostDataSourcePtr best_source;
+
+    ConstHostCollection hosts = subnet6 ?
+        getCfgHosts()->getAllbyIdentifiers6(subnet_id, identifiers) :
+        getCfgHosts()->getAllbyIdentifiers4(subnet_id, identifiers);
+    for (auto const& host : hosts) {
+        size_t i = index_of(host);
+        if (i < best) {
+            found[i] = host;
+            best = i;
+        }
+    }
+
+    // Only the identifiers preceding the best match can change the result.
+    std::ostringstream text;
+    if ((best > 0) && !alternate_sources_.empty()) {
+        for (size_t i = 0; i < best; ++i) {
+            text << (i > 0 ? ", " : "")
+                 << Host::getIdentifierAsText(ids[i]->first,
+                                              ids[i]->second.data(),
+                                              ids[i]->second.size());
+        }
+        LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE,
+                  subnet6 ? HOSTS_MGR_ALTERNATE_GET6_SUBNET_ID_IDENTIFIER :
+                  HOSTS_MGR_ALTERNATE_GET4_SUBNET_ID_IDENTIFIER)
+            .arg(subnet_id)
+            .arg(text.str());
+
+        for (auto const& source : alternate_sources_) {
+            HostIdentifierList remaining;
+            for (size_t i = 0; i < best; ++i) {
+                if (!negative[i]) {
+                    remaining.push_back(*ids[i]);
+                }
+            }
+            if (remaining.empty()) {
+                break;
+            }
+            hosts = subnet6 ?
+                source->getAllbyIdentifiers6(subnet_id, remaining) :
+                source->getAllbyIdentifiers4(subnet_id, remaining);
+            for (auto const& host : hosts) {
+                size_t i = index_of(host);
+                if ((i >= best) || negative[i]) {
+                    continue;
+                }
+                if (host->getNegative()) {
+                    negative[i] = true;
+                    continue;
+                }
+                found[i] = host;
+                best = i;
+                best_source = source;
+            }
+        }
+    }
+
+    // Cache the negative answers for the identifiers preceding the best
+    // match: they were looked up without success.
+    if (negative_caching_) {
+        for (size_t i = 0; i < best; ++i) {
+            if (!negative[i]) {
+                cacheNegative(subnet6 ? SubnetID(SUBNET_ID_UNUSED) : subnet_id,
+                              subnet6 ? subnet_id : SubnetID(SUBNET_ID_UNUSED),
+                              ids[i]->first, ids[i]->second.data(),
+                              ids[i]->second.size());
+            }
+        }
+    }
+
+    if (best == ids.size()) {
+        if (!ids.empty() && !alternate_sources_.empty()) {
+            LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS,
+                      subnet6 ? HOSTS_MGR_ALTERNATE_GET6_SUBNET_ID_IDENTIFIER_NULL :
+                      HOSTS_MGR_ALTERNATE_GET4_SUBNET_ID_IDENTIFIER_NULL)
+                .arg(subnet_id)
+                .arg(text.str());
+        }
+        return (ConstHostPtr());
+    }
+    if (best_source) {
+        LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS,
+                  subnet6 ? HOSTS_MGR_ALTERNATE_GET6_SUBNET_ID_IDENTIFIER_HOST :
+                  HOSTS_MGR_ALTERNATE_GET4_SUBNET_ID_IDENTIFIER_HOST)
+            .arg(subnet_id)
+            .arg(Host::getIdentifierAsText(ids[best]->first,
+                                           ids[best]->second.data(),
+                                           ids[best]->second.size()))
+            .arg(best_source->getType())
+            .arg(found[best]->toText());
+        if (best_source != cache_ptr_) {
+            cache(found[best]);
+        }
+    }
+    return (found[best]);
+}
+
 ConstHostPtr
 HostMgr::get4(const SubnetID& subnet_id,
               const asiolink::IOAddress& address) const {
@@ -510,6 +639,12 @@ HostMgr::get6(const SubnetID& subnet_id,
     return (host);
 }
 
+ConstHostPtr
+HostMgr::get6(const SubnetID& subnet_id,
+              const HostIdentifierList& identifiers) const {
+    return (getByIdentifiers(subnet_id, true, identifiers));
+}
+
 ConstHostPtr
 HostMgr::get6(const SubnetID& subnet_id,
               const asiolink::IOAddress& addr) const {
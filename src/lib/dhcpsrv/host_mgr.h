@@ -378,6 +378,22 @@ public:
     get4(const SubnetID& subnet_id, const Host::IdentifierType& identifier_type,
          const uint8_t* identifier_begin, const size_t identifier_len) const;
 
+    /// @brief Returns a host connected to the IPv4 subnet using the first
+    /// matching identifier in the order of preference.
+    ///
+    /// This method returns the same host as calling @c get4 for each
+    /// identifier in turn until a host is found, but it issues at most one
+    /// lookup per data source (e.g. one query per database) using the
+    /// @c BaseHostDataSource::getAllbyIdentifiers4 method.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers in the order of preference.
+    ///
+    /// @return Const @c Host object for which reservation has been made using
+    /// the first of the specified identifiers which has one.
+    ConstHostPtr
+    get4(const SubnetID& subnet_id, const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host connected to the IPv4 subnet and having
     /// a reservation for a specified IPv4 address.
     ///
@@ -457,6 +473,20 @@ public:
     get6(const SubnetID& subnet_id, const Host::IdentifierType& identifier_type,
          const uint8_t* identifier_begin, const size_t identifier_len) const;
 
+    /// @brief Returns a host connected to the IPv6 subnet using the first
+    /// matching identifier in the order of preference.
+    ///
+    /// This is the IPv6 counterpart of the @c get4 method taking a list of
+    /// identifiers.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers in the order of preference.
+    ///
+    /// @return Const @c Host object for which reservation has been made using
+    /// the first of the specified identifiers which has one.
+    ConstHostPtr
+    get6(const SubnetID& subnet_id, const HostIdentifierList& identifiers) const;
+
     /// @brief Returns a host using the specified IPv6 prefix.
     ///
     /// This method returns a host using specified IPv6 prefix, as described
@@ -687,6 +717,25 @@ protected:
 
 private:
 
+    /// @brief Returns a host connected to an IPv4 or IPv6 subnet using the
+    /// first matching identifier in the order of preference.
+    ///
+    /// This private method is called by the @c get4 and @c get6 methods
+    /// taking a list of identifiers. The configuration file is searched
+    /// first, then each alternate source is searched for the identifiers
+    /// which precede the best match found so far and which are not known
+    /// to have no reservation (negative cache entries).
+    ///
+    /// @param subnet_id IPv4 or IPv6 subnet identifier.
+    /// @param subnet6 A boolean flag which indicates if the subnet identifier
+    /// points to a IPv4 (if false) or IPv6 subnet (if true).
+    /// @param identifiers Host identifiers in the order of preference.
+    ///
+    /// @return Const @c Host object or null.
+    ConstHostPtr
+    getByIdentifiers(const SubnetID& subnet_id, const bool subnet6,
+                     const HostIdentifierList& identifiers) const;
+
     /// @brief Indicates if backends are running in the mode in which IP
     /// reservations must be unique (true) or non-unique (false).
     ///
@@ -0,0 +1,403 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/mem_host_cache.h>
+#include <exceptions/exceptions.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <functional>
+
+using namespace isc::asiolink;
+using namespace isc::db;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+const string MemHostCache::TYPE = "memory-cache";
+const size_t MemHostCache::SHARDS;
+const size_t MemHostCache::DEFAULT_MAX_ENTRIES;
+const uint32_t MemHostCache::DEFAULT_TTL;
+
+MemHostCache::MemHostCache(size_t max_entries, uint32_t ttl)
+    : parameters_(), max_entries_(max_entries), shard_capacity_(0),
+      ttl_(ttl), shards_(SHARDS), hits_(0), misses_(0) {
+    parameters_["type"] = TYPE;
+    parameters_["max-entries"] = boost::lexical_cast<string>(max_entries);
+    parameters_["ttl"] = boost::lexical_cast<string>(ttl);
+    init();
+}
+
+MemHostCache::MemHostCache(const DatabaseConnection::ParameterMap& parameters)
+    : parameters_(parameters), max_entries_(DEFAULT_MAX_ENTRIES),
+      shard_capacity_(0), ttl_(DEFAULT_TTL), shards_(SHARDS), hits_(0),
+      misses_(0) {
+    auto it = parameters.find("max-entries");
+    if (it != parameters.end()) {
+        try {
+            max_entries_ = boost::lexical_cast<size_t>(it->second);
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(BadValue, "invalid max-entries parameter of the "
+                      << TYPE << " host backend: " << it->second);
+        }
+    }
+    it = parameters.find("ttl");
+    if (it != parameters.end()) {
+        try {
+            ttl_ = boost::lexical_cast<uint32_t>(it->second);
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(BadValue, "invalid ttl parameter of the "
+                      << TYPE << " host backend: " << it->second);
+        }
+    }
+    init();
+}
+
+void
+MemHostCache::init() {
+    if (max_entries_ == 0) {
+        isc_throw(BadValue, "the maximum number of entries of the "
+                  << TYPE << " host backend must be greater than 0");
+    }
+    shard_capacity_ = (max_entries_ + SHARDS - 1) / SHARDS;
+}
+
+string
+MemHostCache::makeKey(bool v6, const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len) {
+    string key;
+    key.reserve(6 + identifier_len);
+    key.push_back(v6 ? '6' : '4');
+    key.push_back(static_cast<char>(identifier_type));
+    key.push_back(static_cast<char>((subnet_id >> 24) & 0xff));
+    key.push_back(static_cast<char>((subnet_id >> 16) & 0xff));
+    key.push_back(static_cast<char>((subnet_id >> 8) & 0xff));
+    key.push_back(static_cast<char>(subnet_id & 0xff));
+    key.append(reinterpret_cast<const char*>(identifier_begin), identifier_len);
+    return (key);
+}
+
+MemHostCache::Shard&
+MemHostCache::getShard(const string& key) const {
+    return (shards_[hash<string>()(key) % SHARDS]);
+}
+
+ConstHostPtr
+MemHostCache::get(const string& key) const {
+    Shard& shard = getShard(key);
+    lock_guard<mutex> lock(shard.mutex_);
+    auto it = shard.entries_.find(key);
+    if (it == shard.entries_.end()) {
+        ++misses_;
+        return (ConstHostPtr());
+    }
+    if ((ttl_ != 0) && (it->second.expire_ <= Clock::now())) {
+        shard.lru_.erase(it->second.lru_);
+        shard.entries_.erase(it);
+        ++misses_;
+        return (ConstHostPtr());
+    }
+    // Move to the front of the least recently used list.
+    shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second.lru_);
+    ++hits_;
+    return (it->second.host_);
+}
+
+void
+MemHostCache::erase(const string& key) {
+    Shard& shard = getShard(key);
+    lock_guard<mutex> lock(shard.mutex_);
+    auto it = shard.entries_.find(key);
+    if (it != shard.entries_.end()) {
+        shard.lru_.erase(it->second.lru_);
+        shard.entries_.erase(it);
+    }
+}
+
+template <typename Pred>
+void
+MemHostCache::eraseIf(Pred pred) {
+    for (auto& shard : shards_) {
+        lock_guard<mutex> lock(shard.mutex_);
+        for (auto it = shard.entries_.begin(); it != shard.entries_.end(); ) {
+            if (pred(it->second.host_)) {
+                shard.lru_.erase(it->second.lru_);
+                it = shard.entries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+ConstHostCollection
+MemHostCache::getAll(const Host::IdentifierType&, const uint8_t*,
+                     const size_t) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getAll4(const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getAll6(const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getAllbyHostname(const string&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getAllbyHostname4(const string&, const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getAllbyHostname6(const string&, const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getPage4(const SubnetID&, size_t&, uint64_t,
+                       const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getPage6(const SubnetID&, size_t&, uint64_t,
+                       const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getPage4(size_t&, uint64_t, const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getPage6(size_t&, uint64_t, const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+MemHostCache::getAll4(const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostPtr
+MemHostCache::get4(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) const {
+    return (get(makeKey(false, subnet_id, identifier_type,
+                        identifier_begin, identifier_len)));
+}
+
+ConstHostPtr
+MemHostCache::get4(const SubnetID&, const IOAddress&) const {
+    return (ConstHostPtr());
+}
+
+ConstHostCollection
+MemHostCache::getAll4(const SubnetID&, const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostPtr
+MemHostCache::get6(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) const {
+    return (get(makeKey(true, subnet_id, identifier_type,
+                        identifier_begin, identifier_len)));
+}
+
+ConstHostPtr
+MemHostCache::get6(const IOAddress&, const uint8_t) const {
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+MemHostCache::get6(const SubnetID&, const IOAddress&) const {
+    return (ConstHostPtr());
+}
+
+ConstHostCollection
+MemHostCache::getAll6(const SubnetID&, const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+void
+MemHostCache::add(const HostPtr&) {
+}
+
+bool
+MemHostCache::del(const SubnetID& subnet_id, const IOAddress& addr) {
+    eraseIf([&subnet_id, &addr](const ConstHostPtr& host) {
+        if (addr.isV4()) {
+            return ((host->getIPv4SubnetID() == subnet_id) &&
+                    (host->getIPv4Reservation() == addr));
+        }
+        return ((host->getIPv6SubnetID() == subnet_id) &&
+                (host->hasReservation(IPv6Resrv(IPv6Resrv::TYPE_NA, addr)) ||
+                 host->hasReservation(IPv6Resrv(IPv6Resrv::TYPE_PD, addr))));
+    });
+    return (false);
+}
+
+bool
+MemHostCache::del4(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) {
+    erase(makeKey(false, subnet_id, identifier_type,
+                  identifier_begin, identifier_len));
+    return (false);
+}
+
+bool
+MemHostCache::del6(const SubnetID& subnet_id,
+                   const Host::IdentifierType& identifier_type,
+                   const uint8_t* identifier_begin,
+                   const size_t identifier_len) {
+    erase(makeKey(true, subnet_id, identifier_type,
+                  identifier_begin, identifier_len));
+    return (false);
+}
+
+void
+MemHostCache::update(HostPtr const& host) {
+    // The subnets of the host may have changed: remove all the entries
+    // with the identifier.
+    Host::IdentifierType identifier_type = host->getIdentifierType();
+    const vector<uint8_t>& identifier = host->getIdentifier();
+    eraseIf([identifier_type, &identifier](const ConstHostPtr& cached) {
+        return ((cached->getIdentifierType() == identifier_type) &&
+                (cached->getIdentifier() == identifier));
+    });
+}
+
+bool
+MemHostCache::setIPReservationsUnique(const bool) {
+    return (true);
+}
+
+size_t
+MemHostCache::insert(const ConstHostPtr& host, bool overwrite) {
+    if (!host) {
+        return (0);
+    }
+    vector<string> keys;
+    const vector<uint8_t>& identifier = host->getIdentifier();
+    const uint8_t* identifier_begin = identifier.empty() ? 0 : &identifier[0];
+    if (host->getIPv4SubnetID() != SUBNET_ID_UNUSED) {
+        keys.push_back(makeKey(false, host->getIPv4SubnetID(),
+                               host->getIdentifierType(),
+                               identifier_begin, identifier.size()));
+    }
+    if (host->getIPv6SubnetID() != SUBNET_ID_UNUSED) {
+        keys.push_back(makeKey(true, host->getIPv6SubnetID(),
+                               host->getIdentifierType(),
+                               identifier_begin, identifier.size()));
+    }
+    Clock::time_point expire = Clock::now() + chrono::seconds(ttl_);
+    size_t conflicts = 0;
+    for (auto const& key : keys) {
+        Shard& shard = getShard(key);
+        lock_guard<mutex> lock(shard.mutex_);
+        auto it = shard.entries_.find(key);
+        if (it != shard.entries_.end()) {
+            ++conflicts;
+            if (overwrite) {
+                it->second.host_ = host;
+                it->second.expire_ = expire;
+                shard.lru_.splice(shard.lru_.begin(), shard.lru_,
+                                  it->second.lru_);
+            }
+            continue;
+        }
+        // Evict the least recently used entry when the shard is full.
+        if (shard.entries_.size() >= shard_capacity_) {
+            shard.entries_.erase(shard.lru_.back());
+            shard.lru_.pop_back();
+        }
+        shard.lru_.push_front(key);
+        Entry entry;
+        entry.host_ = host;
+        entry.expire_ = expire;
+        entry.lru_ = shard.lru_.begin();
+        shard.entries_.insert(make_pair(key, entry));
+    }
+    if (!overwrite && (conflicts > 1)) {
+        conflicts = 1;
+    }
+    return (conflicts);
+}
+
+bool
+MemHostCache::remove(const HostPtr& host) {
+    bool found = false;
+    eraseIf([&host, &found](const ConstHostPtr& cached) {
+        if (cached.get() == host.get()) {
+            found = true;
+            return (true);
+        }
+        return (false);
+    });
+    return (found);
+}
+
+void
+MemHostCache::flush(size_t count) {
+    if (count == 0) {
+        for (auto& shard : shards_) {
+            lock_guard<mutex> lock(shard.mutex_);
+            shard.entries_.clear();
+            shard.lru_.clear();
+        }
+        return;
+    }
+    // Remove the least recently used entries of each shard in turn.
+    bool removed = true;
+    while ((count > 0) && removed) {
+        removed = false;
+        for (auto& shard : shards_) {
+            if (count == 0) {
+                break;
+            }
+            lock_guard<mutex> lock(shard.mutex_);
+            if (shard.lru_.empty()) {
+                continue;
+            }
+            shard.entries_.erase(shard.lru_.back());
+            shard.lru_.pop_back();
+            removed = true;
+            --count;
+        }
+    }
+}
+
+size_t
+MemHostCache::size() const {
+    size_t count = 0;
+    for (auto& shard : shards_) {
+        lock_guard<mutex> lock(shard.mutex_);
+        count += shard.entries_.size();
+    }
+    return (count);
+}
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
@@ -0,0 +1,412 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MEM_HOST_CACHE_H
+#define MEM_HOST_CACHE_H
+
+#include <database/database_connection.h>
+#include <dhcpsrv/cache_host_data_source.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Built-in in-memory host cache.
+///
+/// This host data source caches the hosts retrieved by identifier from
+/// the host databases (e.g. MySQL or PostgreSQL) which follow it in the
+/// @c HostMgr list of alternate sources. The @c HostMgr fills the cache
+/// with the hosts found in the databases and, when negative caching is
+/// enabled, with negative entries for identifiers without reservation.
+///
+/// Only the lookups by subnet and identifier (@c get4 and @c get6), which
+/// are the ones done for each client by the allocation engine, are served
+/// by the cache: other lookups return nothing so the @c HostMgr falls
+/// through to the databases.
+///
+/// The cache is split in shards, each protected by its own mutex, so
+/// concurrent lookups for different clients rarely contend. Each shard
+/// is bounded and evicts its least recently used entry when full.
+/// Entries expire after a configurable time to live.
+///
+/// The deletion methods (used e.g. by the reservation-del command) and
+/// the update method remove the matching entries but report that nothing
+/// was deleted so the @c HostMgr still deletes or updates the hosts in
+/// the databases.
+class MemHostCache : public CacheHostDataSource {
+public:
+    /// @brief Backend type.
+    static const std::string TYPE;
+
+    /// @brief Number of shards.
+    static const size_t SHARDS = 16;
+
+    /// @brief Default maximum number of entries.
+    static const size_t DEFAULT_MAX_ENTRIES = 65536;
+
+    /// @brief Default time to live of entries in seconds.
+    static const uint32_t DEFAULT_TTL = 60;
+
+    /// @brief Constructor.
+    ///
+    /// @param max_entries The maximum number of entries (must not be 0).
+    /// @param ttl The time to live of entries in seconds, 0 means
+    /// that entries do not expire.
+    /// @throw BadValue if max_entries is 0.
+    MemHostCache(size_t max_entries = DEFAULT_MAX_ENTRIES,
+                 uint32_t ttl = DEFAULT_TTL);
+
+    /// @brief Constructor from database access parameters.
+    ///
+    /// Uses the "max-entries" and "ttl" parameters.
+    ///
+    /// @param parameters The access parameters.
+    /// @throw BadValue if a parameter has an invalid value.
+    explicit MemHostCache(const db::DatabaseConnection::ParameterMap& parameters);
+
+    /// @brief Destructor.
+    virtual ~MemHostCache() { }
+
+    /// @brief Returns all hosts for the identifier: not cached.
+    virtual ConstHostCollection
+    getAll(const Host::IdentifierType& identifier_type,
+           const uint8_t* identifier_begin,
+           const size_t identifier_len) const;
+
+    /// @brief Returns all hosts of a subnet: not cached.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id) const;
+
+    /// @brief Returns all hosts of a subnet: not cached.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id) const;
+
+    /// @brief Returns all hosts with a hostname: not cached.
+    virtual ConstHostCollection
+    getAllbyHostname(const std::string& hostname) const;
+
+    /// @brief Returns all hosts with a hostname: not cached.
+    virtual ConstHostCollection
+    getAllbyHostname4(const std::string& hostname,
+                      const SubnetID& subnet_id) const;
+
+    /// @brief Returns all hosts with a hostname: not cached.
+    virtual ConstHostCollection
+    getAllbyHostname6(const std::string& hostname,
+                      const SubnetID& subnet_id) const;
+
+    /// @brief Returns a page of hosts: not cached.
+    virtual ConstHostCollection
+    getPage4(const SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns a page of hosts: not cached.
+    virtual ConstHostCollection
+    getPage6(const SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns a page of hosts: not cached.
+    virtual ConstHostCollection
+    getPage4(size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns a page of hosts: not cached.
+    virtual ConstHostCollection
+    getPage6(size_t& source_index,
+             uint64_t lower_host_id,
+             const HostPageSize& page_size) const;
+
+    /// @brief Returns all hosts with an address: not cached.
+    virtual ConstHostCollection
+    getAll4(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a cached host by subnet and identifier.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to the beginning of a buffer
+    /// containing an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return The cached host, which may be a negative entry, or null.
+    virtual ConstHostPtr
+    get4(const SubnetID& subnet_id,
+         const Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns a host by subnet and address: not cached.
+    virtual ConstHostPtr
+    get4(const SubnetID& subnet_id,
+         const asiolink::IOAddress& address) const;
+
+    /// @brief Returns all hosts by subnet and address: not cached.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a cached host by subnet and identifier.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to the beginning of a buffer
+    /// containing an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return The cached host, which may be a negative entry, or null.
+    virtual ConstHostPtr
+    get6(const SubnetID& subnet_id,
+         const Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns a host by prefix: not cached.
+    virtual ConstHostPtr
+    get6(const asiolink::IOAddress& prefix, const uint8_t prefix_len) const;
+
+    /// @brief Returns a host by subnet and address: not cached.
+    virtual ConstHostPtr
+    get6(const SubnetID& subnet_id, const asiolink::IOAddress& address) const;
+
+    /// @brief Returns all hosts by subnet and address: not cached.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Adds a host: does nothing as the @c HostMgr inserts the
+    /// added host into the cache.
+    ///
+    /// @param host Pointer to the new @c Host object being added.
+    virtual void add(const HostPtr& host);
+
+    /// @brief Removes the entries of the hosts with an address.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param addr specified address.
+    /// @return false so the host is deleted from the databases too.
+    virtual bool del(const SubnetID& subnet_id,
+                     const asiolink::IOAddress& addr);
+
+    /// @brief Removes the entry of a host by subnet and identifier.
+    ///
+    /// @param subnet_id IPv4 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin pointer to the beginning of a buffer
+    /// containing an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return false so the host is deleted from the databases too.
+    virtual bool del4(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Removes the entry of a host by subnet and identifier.
+    ///
+    /// @param subnet_id IPv6 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin pointer to the beginning of a buffer
+    /// containing an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return false so the host is deleted from the databases too.
+    virtual bool del6(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Removes the entries with the identifier of an updated host.
+    ///
+    /// The @c HostMgr inserts the updated host into the cache.
+    ///
+    /// @param host the host up to date with the requested changes
+    virtual void update(HostPtr const& host);
+
+    /// @brief Return backend type.
+    ///
+    /// @return Type of the backend.
+    virtual std::string getType() const {
+        return (TYPE);
+    }
+
+    /// @brief Return backend parameters.
+    ///
+    /// @return The parameters given to the constructor.
+    virtual db::DatabaseConnection::ParameterMap getParameters() const {
+        return (parameters_);
+    }
+
+    /// @brief Controls whether IP reservations are unique or non-unique.
+    ///
+    /// The cache stores what the databases return so both are supported.
+    ///
+    /// @param unique boolean flag indicating if the IP reservations must be
+    /// unique or can be non-unique.
+    /// @return always true.
+    virtual bool setIPReservationsUnique(const bool unique);
+
+    /// @brief Inserts a host into the cache.
+    ///
+    /// The host is inserted by IPv4 subnet when it has one and by IPv6
+    /// subnet when it has one.
+    ///
+    /// @param host Pointer to the host being inserted.
+    /// @param overwrite false if doing nothing in case of conflicts
+    /// (and returning 1), true if replacing conflicting entries
+    /// (and returning their number).
+    /// @return number of conflicts limited to one if overwrite is false.
+    virtual size_t insert(const ConstHostPtr& host, bool overwrite);
+
+    /// @brief Removes a host from the cache.
+    ///
+    /// @param host Pointer to the cached host being removed.
+    /// @return true when found and removed.
+    virtual bool remove(const HostPtr& host);
+
+    /// @brief Flushes entries.
+    ///
+    /// @param count number of entries to remove, 0 means all.
+    virtual void flush(size_t count);
+
+    /// @brief Returns the number of entries.
+    ///
+    /// @return the current number of entries, including the expired
+    /// entries which were not yet removed.
+    virtual size_t size() const;
+
+    /// @brief Returns the maximum number of entries.
+    ///
+    /// @return the maximum number of entries.
+    virtual size_t capacity() const {
+        return (max_entries_);
+    }
+
+    /// @brief Returns the time to live of entries.
+    ///
+    /// @return the time to live in seconds, 0 means no expiration.
+    uint32_t getTtl() const {
+        return (ttl_);
+    }
+
+    /// @brief Returns the number of lookups served by the cache.
+    uint64_t getHits() const {
+        return (hits_);
+    }
+
+    /// @brief Returns the number of lookups not served by the cache.
+    uint64_t getMisses() const {
+        return (misses_);
+    }
+
+private:
+    /// @brief Clock type.
+    typedef std::chrono::steady_clock Clock;
+
+    /// @brief Cache entry.
+    struct Entry {
+        /// @brief The cached host.
+        ConstHostPtr host_;
+
+        /// @brief The expiration time.
+        Clock::time_point expire_;
+
+        /// @brief The position in the least recently used list.
+        std::list<std::string>::iterator lru_;
+    };
+
+    /// @brief Cache shard.
+    struct Shard {
+        /// @brief The mutex protecting the shard.
+        std::mutex mutex_;
+
+        /// @brief The entries by key.
+        std::unordered_map<std::string, Entry> entries_;
+
+        /// @brief The keys, most recently used first.
+        std::list<std::string> lru_;
+    };
+
+    /// @brief Initializes the cache once the parameters are known.
+    ///
+    /// @throw BadValue if max_entries_ is 0.
+    void init();
+
+    /// @brief Builds the key of an entry.
+    ///
+    /// @param v6 true for an IPv6 subnet, false for an IPv4 subnet.
+    /// @param subnet_id The subnet identifier.
+    /// @param identifier_type The identifier type.
+    /// @param identifier_begin Pointer to the identifier.
+    /// @param identifier_len Identifier length.
+    /// @return The key.
+    static std::string makeKey(bool v6, const SubnetID& subnet_id,
+                               const Host::IdentifierType& identifier_type,
+                               const uint8_t* identifier_begin,
+                               const size_t identifier_len);
+
+    /// @brief Returns the shard of a key.
+    ///
+    /// @param key The key.
+    /// @return The shard.
+    Shard& getShard(const std::string& key) const;
+
+    /// @brief Looks up an entry.
+    ///
+    /// @param key The key.
+    /// @return The cached host or null.
+    ConstHostPtr get(const std::string& key) const;
+
+    /// @brief Removes an entry.
+    ///
+    /// @param key The key.
+    void erase(const std::string& key);
+
+    /// @brief Removes the entries matching a predicate.
+    ///
+    /// @param pred The predicate.
+    template <typename Pred>
+    void eraseIf(Pred pred);
+
+    /// @brief The access parameters.
+    db::DatabaseConnection::ParameterMap parameters_;
+
+    /// @brief The maximum number of entries.
+    size_t max_entries_;
+
+    /// @brief The maximum number of entries of a shard.
+    size_t shard_capacity_;
+
+    /// @brief The time to live of entries in seconds.
+    uint32_t ttl_;
+
+    /// @brief The shards.
+    mutable std::vector<Shard> shards_;
+
+    /// @brief The number of lookups served by the cache.
+    mutable std::atomic<uint64_t> hits_;
+
+    /// @brief The number of lookups not served by the cache.
+    mutable std::atomic<uint64_t> misses_;
+};
+
+/// @brief Pointer to the built-in host cache.
+typedef boost::shared_ptr<MemHostCache> MemHostCachePtr;
+
+} // end of namespace isc::dhcp
+} // end of namespace isc
+
+#endif // MEM_HOST_CACHE_H
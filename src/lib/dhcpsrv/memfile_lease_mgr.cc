@@ -262,32 +262,76 @@ LFCSetup::getExitStatus() const {
 /// This class provides the functionality such as results storage and row
 /// fetching common to fulfilling the statistical lease data query.
 ///
+/// The result set is built from the lease counts maintained by the lease
+/// manager as leases are added, updated and deleted, so its cost depends
+/// on the number of subnets and not on the number of leases.
 class MemfileLeaseStatsQuery : public LeaseStatsQuery {
 public:
     /// @brief Constructor for all subnets query
     ///
-    MemfileLeaseStatsQuery()
-        : rows_(0), next_pos_(rows_.end()) {
+    /// @param counter The lease counts
+    /// @param v6 true for DHCPv6 leases, false for DHCPv4 leases
+    MemfileLeaseStatsQuery(const LeaseStatsCounter& counter, bool v6)
+        : counter_(counter), v6_(v6), rows_(0), next_pos_(rows_.end()) {
     };
 
     /// @brief Constructor for single subnet query
     ///
+    /// @param counter The lease counts
+    /// @param v6 true for DHCPv6 leases, false for DHCPv4 leases
     /// @param subnet_id ID of the desired subnet
-    MemfileLeaseStatsQuery(const SubnetID& subnet_id)
-        : LeaseStatsQuery(subnet_id), rows_(0), next_pos_(rows_.end()) {
+    MemfileLeaseStatsQuery(const LeaseStatsCounter& counter, bool v6,
+                           const SubnetID& subnet_id)
+        : LeaseStatsQuery(subnet_id), counter_(counter), v6_(v6), rows_(0),
+          next_pos_(rows_.end()) {
     };
 
     /// @brief Constructor for subnet range query
     ///
+    /// @param counter The lease counts
+    /// @param v6 true for DHCPv6 leases, false for DHCPv4 leases
     /// @param first_subnet_id ID of the first subnet in the desired range
     /// @param last_subnet_id ID of the last subnet in the desired range
-    MemfileLeaseStatsQuery(const SubnetID& first_subnet_id, const SubnetID& last_subnet_id)
-        : LeaseStatsQuery(first_subnet_id, last_subnet_id), rows_(0), next_pos_(rows_.end()) {
+    MemfileLeaseStatsQuery(const LeaseStatsCounter& counter, bool v6,
+                           const SubnetID& first_subnet_id,
+                           const SubnetID& last_subnet_id)
+        : LeaseStatsQuery(first_subnet_id, last_subnet_id), counter_(counter),
+          v6_(v6), rows_(0), next_pos_(rows_.end()) {
     };
 
     /// @brief Destructor
     virtual ~MemfileLeaseStatsQuery() {};
 
+    /// @brief Creates the lease statistical data result set
+    ///
+    /// The result set is populated from the lease counts of the selected
+    /// subnets in ascending order by subnet id. The process results in a
+    /// vector containing one entry per state per lease type per subnet,
+    /// omitting zero counts.
+    ///
+    /// Currently the states counted are:
+    ///
+    /// - Lease::STATE_DEFAULT (i.e. assigned)
+    /// - Lease::STATE_DECLINED
+    virtual void start() {
+        switch (getSelectMode()) {
+        case ALL_SUBNETS:
+            counter_.getRows(0, std::numeric_limits<SubnetID>::max(), v6_, rows_);
+            break;
+
+        case SINGLE_SUBNET:
+            counter_.getRows(getFirstSubnetID(), getFirstSubnetID(), v6_, rows_);
+            break;
+
+        case SUBNET_RANGE:
+            counter_.getRows(getFirstSubnetID(), getLastSubnetID(), v6_, rows_);
+            break;
+        }
+
+        // Reset the next row position back to the beginning of the rows.
+        next_pos_ = rows_.begin();
+    }
+
     /// @brief Fetches the next row in the result set
     ///
     /// Once the internal result set has been populated by invoking the
@@ -314,6 +358,12 @@ public:
     }
 
 protected:
+    /// @brief The lease counts to report
+    const LeaseStatsCounter& counter_;
+
+    /// @brief The universe of the leases to report
+    bool v6_;
+
     /// @brief A vector containing the "result set"
     std::vector<LeaseStatsRow> rows_;
 
@@ -323,310 +373,76 @@ protected:
 
 /// @brief Memfile derivation of the IPv4 statistical lease data query
 ///
-/// This class is used to recalculate IPv4 lease statistics for Memfile
-/// lease storage.  It does so by iterating over the given storage,
-/// accumulating counts of leases in each of the monitored lease states
-/// for each subnet and storing these counts in an internal collection.
 /// The populated result set will contain one entry per monitored state
 /// per subnet.
-///
 class MemfileLeaseStatsQuery4 : public MemfileLeaseStatsQuery {
 public:
     /// @brief Constructor for an all subnets query
     ///
-    /// @param storage4 A pointer to the v4 lease storage to be counted
-    MemfileLeaseStatsQuery4(Lease4Storage& storage4)
-        : MemfileLeaseStatsQuery(), storage4_(storage4) {
+    /// @param counter The lease counts
+    MemfileLeaseStatsQuery4(const LeaseStatsCounter& counter)
+        : MemfileLeaseStatsQuery(counter, false) {
     };
 
     /// @brief Constructor for a single subnet query
     ///
-    /// @param storage4 A pointer to the v4 lease storage to be counted
+    /// @param counter The lease counts
     /// @param subnet_id ID of the desired subnet
-    MemfileLeaseStatsQuery4(Lease4Storage& storage4, const SubnetID& subnet_id)
-        : MemfileLeaseStatsQuery(subnet_id), storage4_(storage4) {
+    MemfileLeaseStatsQuery4(const LeaseStatsCounter& counter,
+                            const SubnetID& subnet_id)
+        : MemfileLeaseStatsQuery(counter, false, subnet_id) {
     };
 
     /// @brief Constructor for a subnet range query
     ///
-    /// @param storage4 A pointer to the v4 lease storage to be counted
+    /// @param counter The lease counts
     /// @param first_subnet_id ID of the first subnet in the desired range
     /// @param last_subnet_id ID of the last subnet in the desired range
-    MemfileLeaseStatsQuery4(Lease4Storage& storage4, const SubnetID& first_subnet_id,
+    MemfileLeaseStatsQuery4(const LeaseStatsCounter& counter,
+                            const SubnetID& first_subnet_id,
                             const SubnetID& last_subnet_id)
-        : MemfileLeaseStatsQuery(first_subnet_id, last_subnet_id), storage4_(storage4) {
+        : MemfileLeaseStatsQuery(counter, false, first_subnet_id, last_subnet_id) {
     };
 
     /// @brief Destructor
     virtual ~MemfileLeaseStatsQuery4() {};
-
-    /// @brief Creates the IPv4 lease statistical data result set
-    ///
-    /// The result set is populated by iterating over the IPv4 leases in
-    /// storage, in ascending order by address, accumulating the lease state
-    /// counts per subnet.
-    /// At the completion of all entries for a given subnet, the counts are
-    /// used to create LeaseStatsRow instances which are appended to an
-    /// internal vector.  The process results in a vector containing one entry
-    /// per state per subnet.
-    ///
-    /// Currently the states counted are:
-    ///
-    /// - Lease::STATE_DEFAULT (i.e. assigned)
-    /// - Lease::STATE_DECLINED
-    void start() {
-        const Lease4StorageSubnetIdIndex& idx
-            = storage4_.get<SubnetIdIndexTag>();
-
-        // Set lower and upper bounds based on select mode
-        Lease4StorageSubnetIdIndex::const_iterator lower;
-        Lease4StorageSubnetIdIndex::const_iterator upper;
-        switch (getSelectMode()) {
-        case ALL_SUBNETS:
-            lower = idx.begin();
-            upper = idx.end();
-            break;
-
-        case SINGLE_SUBNET:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getFirstSubnetID());
-            break;
-
-        case SUBNET_RANGE:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getLastSubnetID());
-            break;
-        }
-
-        // Return an empty set if there are no rows.
-        if (lower == upper) {
-            return;
-        }
-
-        // Iterate over the leases in order by subnet, accumulating per
-        // subnet counts for each state of interest.  As we finish each
-        // subnet, add the appropriate rows to our result set.
-        SubnetID cur_id = 0;
-        int64_t assigned = 0;
-        int64_t declined = 0;
-        for (Lease4StorageSubnetIdIndex::const_iterator lease = lower;
-             lease != upper; ++lease) {
-            // If we've hit the next subnet, add rows for the current subnet
-            // and wipe the accumulators
-            if ((*lease)->subnet_id_ != cur_id) {
-                if (cur_id > 0) {
-                    if (assigned > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id,
-                                                      Lease::STATE_DEFAULT,
-                                                      assigned));
-                        assigned = 0;
-                    }
-
-                    if (declined > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id,
-                                                      Lease::STATE_DECLINED,
-                                                      declined));
-                        declined = 0;
-                    }
-                }
-
-                // Update current subnet id
-                cur_id = (*lease)->subnet_id_;
-            }
-
-            // Bump the appropriate accumulator
-            if ((*lease)->state_ == Lease::STATE_DEFAULT) {
-                ++assigned;
-            } else if ((*lease)->state_ == Lease::STATE_DECLINED) {
-                ++declined;
-            }
-        }
-
-        // Make the rows for last subnet
-        if (assigned > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::STATE_DEFAULT,
-                                          assigned));
-        }
-
-        if (declined > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::STATE_DECLINED,
-                                          declined));
-        }
-
-        // Reset the next row position back to the beginning of the rows.
-        next_pos_ = rows_.begin();
-    }
-
-private:
-    /// @brief The Memfile storage containing the IPv4 leases to analyze
-    Lease4Storage& storage4_;
 };
 
-
 /// @brief Memfile derivation of the IPv6 statistical lease data query
 ///
-/// This class is used to recalculate IPv6 lease statistics for Memfile
-/// lease storage.  It does so by iterating over the given storage,
-/// accumulating counts of leases in each of the monitored lease states
-/// for each subnet and storing these counts in an internal collection.
 /// The populated result set will contain one entry per monitored state
-/// per subnet.
-///
+/// per lease type per subnet.
 class MemfileLeaseStatsQuery6 : public MemfileLeaseStatsQuery {
 public:
     /// @brief Constructor
     ///
-    /// @param storage6 A pointer to the v6 lease storage to be counted
-    MemfileLeaseStatsQuery6(Lease6Storage& storage6)
-        : MemfileLeaseStatsQuery(), storage6_(storage6) {
+    /// @param counter The lease counts
+    MemfileLeaseStatsQuery6(const LeaseStatsCounter& counter)
+        : MemfileLeaseStatsQuery(counter, true) {
     };
 
     /// @brief Constructor for a single subnet query
     ///
-    /// @param storage6 A pointer to the v6 lease storage to be counted
+    /// @param counter The lease counts
     /// @param subnet_id ID of the desired subnet
-    MemfileLeaseStatsQuery6(Lease6Storage& storage6, const SubnetID& subnet_id)
-        : MemfileLeaseStatsQuery(subnet_id), storage6_(storage6) {
+    MemfileLeaseStatsQuery6(const LeaseStatsCounter& counter,
+                            const SubnetID& subnet_id)
+        : MemfileLeaseStatsQuery(counter, true, subnet_id) {
     };
 
     /// @brief Constructor for a subnet range query
     ///
-    /// @param storage6 A pointer to the v6 lease storage to be counted
+    /// @param counter The lease counts
     /// @param first_subnet_id ID of the first subnet in the desired range
     /// @param last_subnet_id ID of the last subnet in the desired range
-    MemfileLeaseStatsQuery6(Lease6Storage& storage6, const SubnetID& first_subnet_id,
+    MemfileLeaseStatsQuery6(const LeaseStatsCounter& counter,
+                            const SubnetID& first_subnet_id,
                             const SubnetID& last_subnet_id)
-        : MemfileLeaseStatsQuery(first_subnet_id, last_subnet_id), storage6_(storage6) {
+        : MemfileLeaseStatsQuery(counter, true, first_subnet_id, last_subnet_id) {
     };
 
     /// @brief Destructor
     virtual ~MemfileLeaseStatsQuery6() {};
-
-    /// @brief Creates the IPv6 lease statistical data result set
-    ///
-    /// The result set is populated by iterating over the IPv6 leases in
-    /// storage, in ascending order by subnet id, accumulating the lease state
-    /// counts per subnet. At the completion of all entries for a given subnet,
-    /// the counts are used to create LeaseStatsRow instances which are appended
-    /// to an internal vector.  The process results in a vector containing one
-    /// entry per state per lease type per subnet.
-    ///
-    /// Currently the states counted are:
-    ///
-    /// - Lease::STATE_DEFAULT (i.e. assigned)
-    /// - Lease::STATE_DECLINED
-    virtual void start() {
-        // Get the subnet_id index
-        const Lease6StorageSubnetIdIndex& idx
-            = storage6_.get<SubnetIdIndexTag>();
-
-        // Set lower and upper bounds based on select mode
-        Lease6StorageSubnetIdIndex::const_iterator lower;
-        Lease6StorageSubnetIdIndex::const_iterator upper;
-        switch (getSelectMode()) {
-        case ALL_SUBNETS:
-            lower = idx.begin();
-            upper = idx.end();
-            break;
-
-        case SINGLE_SUBNET:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getFirstSubnetID());
-            break;
-
-        case SUBNET_RANGE:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getLastSubnetID());
-            break;
-        }
-
-        // Return an empty set if there are no rows.
-        if (lower == upper) {
-            return;
-        }
-
-        // Iterate over the leases in order by subnet, accumulating per
-        // subnet counts for each state of interest.  As we finish each
-        // subnet, add the appropriate rows to our result set.
-        SubnetID cur_id = 0;
-        int64_t assigned = 0;
-        int64_t declined = 0;
-        int64_t assigned_pds = 0;
-        for (Lease6StorageSubnetIdIndex::const_iterator lease = lower;
-             lease != upper; ++lease) {
-            // If we've hit the next subnet, add rows for the current subnet
-            // and wipe the accumulators
-            if ((*lease)->subnet_id_ != cur_id) {
-                if (cur_id > 0) {
-                    if (assigned > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                                      Lease::STATE_DEFAULT,
-                                                      assigned));
-                        assigned = 0;
-                    }
-
-                    if (declined > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                                      Lease::STATE_DECLINED,
-                                                      declined));
-                        declined = 0;
-                    }
-
-                    if (assigned_pds > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_PD,
-                                                      Lease::STATE_DEFAULT,
-                                                      assigned_pds));
-                        assigned_pds = 0;
-                    }
-                }
-
-                // Update current subnet id
-                cur_id = (*lease)->subnet_id_;
-            }
-
-            // Bump the appropriate accumulator
-            if ((*lease)->state_ == Lease::STATE_DEFAULT) {
-                switch((*lease)->type_) {
-                case Lease::TYPE_NA:
-                    ++assigned;
-                    break;
-                case Lease::TYPE_PD:
-                    ++assigned_pds;
-                    break;
-                default:
-                    break;
-                }
-            } else if ((*lease)->state_ == Lease::STATE_DECLINED) {
-                // In theory only NAs can be declined
-                if (((*lease)->type_) == Lease::TYPE_NA) {
-                    ++declined;
-                }
-            }
-        }
-
-        // Make the rows for last subnet, unless there were no rows
-        if (assigned > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                          Lease::STATE_DEFAULT, assigned));
-        }
-
-        if (declined > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                          Lease::STATE_DECLINED, declined));
-        }
-
-        if (assigned_pds > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_PD,
-                                          Lease::STATE_DEFAULT, assigned_pds));
-        }
-
-        // Set the next row position to the beginning of the rows.
-        next_pos_ = rows_.begin();
-    }
-
-private:
-    /// @brief The Memfile storage containing the IPv6 leases to analyze
-    Lease6Storage& storage6_;
 };
 
 // Explicit definition of class static constants.  Values are given in the
@@ -652,6 +468,9 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
                                                  CSVLeaseFile4>(file4,
                                                                 lease_file4_,
                                                                 storage4_);
+            for (auto const& lease : storage4_) {
+                lease_stats_counter_.addLease(lease);
+            }
             static_cast<void>(extractExtendedInfo4(false, false));
         }
     } else {
@@ -661,6 +480,9 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
                                                  CSVLeaseFile6>(file6,
                                                                 lease_file6_,
                                                                 storage6_);
+            for (auto const& lease : storage6_) {
+                lease_stats_counter_.addLease(lease);
+            }
             static_cast<void>(buildExtendedInfoTables6Internal(false, false));
         }
     }
@@ -677,6 +499,7 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
             LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES)
                     .arg(version.first).arg(version.second);
         }
+        writeBehindSetup();
         lfcSetup(conversion_needed);
     }
 }
@@ -727,6 +550,9 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease4Ptr& lease) {
     // Increment class lease counters.
     class_lease_counter_.addLease(lease);
 
+    // Increment lease statistics counters.
+    lease_stats_counter_.addLease(lease);
+
     // Run installed callbacks.
     if (hasCallbacks()) {
         trackAddLease(lease, true);
@@ -772,6 +598,9 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease6Ptr& lease) {
     // Increment class lease counters.
     class_lease_counter_.addLease(lease);
 
+    // Increment lease statistics counters.
+    lease_stats_counter_.addLease(lease);
+
     if (getExtendedInfoTablesEnabled()) {
         static_cast<void>(addExtendedInfo6(lease));
     }
@@ -1462,6 +1291,9 @@ Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     // Adjust class lease counters.
     class_lease_counter_.updateLease(lease, old_lease);
 
+    // Adjust lease statistics counters.
+    lease_stats_counter_.updateLease(lease, old_lease);
+
     // Run installed callbacks.
     if (hasCallbacks()) {
         trackUpdateLease(lease, true);
@@ -1525,6 +1357,9 @@ Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     // Adjust class lease counters.
     class_lease_counter_.updateLease(lease, old_lease);
 
+    // Adjust lease statistics counters.
+    lease_stats_counter_.updateLease(lease, old_lease);
+
     // Update extended info tables.
     if (getExtendedInfoTablesEnabled()) {
         switch (recorded_action) {
@@ -1586,6 +1421,10 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
             }
         }
 
+        // Decrement lease statistics counters using the stored lease
+        // as the state of the given one can be different.
+        lease_stats_counter_.removeLease(*l);
+
         storage4_.erase(l);
 
         // Decrement class lease counters.
@@ -1640,6 +1479,10 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease6Ptr& lease) {
             }
         }
 
+        // Decrement lease statistics counters using the stored lease
+        // as the state of the given one can be different.
+        lease_stats_counter_.removeLease(*l);
+
         storage6_.erase(l);
 
         // Decrement class lease counters.
@@ -1774,6 +1617,12 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
             }
         }
 
+        // Decrement lease statistics counters.
+        for (typename IndexType::const_iterator lease = lower_limit;
+             lease != upper_limit; ++lease) {
+            lease_stats_counter_.removeLease(*lease);
+        }
+
         // Erase leases from memory.
         index.erase(lower_limit, upper_limit);
 
@@ -2023,6 +1872,58 @@ Memfile_LeaseMgr::lfcSetup(bool conversion_needed) {
     }
 }
 
+void
+Memfile_LeaseMgr::writeBehindSetup() {
+    std::string write_behind_str = "false";
+    try {
+        write_behind_str = conn_.getParameter("write-behind");
+    } catch (const std::exception&) {
+        // Ignore and default to false.
+    }
+    if (write_behind_str == "false") {
+        return;
+    } else if (write_behind_str != "true") {
+        isc_throw(isc::BadValue, "invalid value 'write-behind="
+                  << write_behind_str << "'");
+    }
+
+    std::string interval_str = "100";
+    try {
+        interval_str = conn_.getParameter("write-behind-interval");
+    } catch (const std::exception&) {
+        // Ignore and default to 100.
+    }
+    uint32_t interval = 0;
+    try {
+        interval = boost::lexical_cast<uint32_t>(interval_str);
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(isc::BadValue, "invalid value of the write-behind-interval "
+                  << interval_str << " specified");
+    }
+
+    std::string sync_str = "false";
+    try {
+        sync_str = conn_.getParameter("write-behind-sync");
+    } catch (const std::exception&) {
+        // Ignore and default to false.
+    }
+    if ((sync_str != "true") && (sync_str != "false")) {
+        isc_throw(isc::BadValue, "invalid value 'write-behind-sync="
+                  << sync_str << "'");
+    }
+    bool sync = (sync_str == "true");
+
+    if (lease_file4_) {
+        lease_file4_->setWriteBehind(true, interval, sync);
+    }
+    if (lease_file6_) {
+        lease_file6_->setWriteBehind(true, interval, sync);
+    }
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_BEHIND)
+        .arg(interval)
+        .arg(sync ? "enabled" : "disabled");
+}
+
 template<typename LeaseFileType>
 void
 Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
@@ -2086,7 +1987,7 @@ Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startLeaseStatsQuery4() {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_));
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(lease_stats_counter_));
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         query->start();
@@ -2099,7 +2000,7 @@ Memfile_LeaseMgr::startLeaseStatsQuery4() {
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_, subnet_id));
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(lease_stats_counter_, subnet_id));
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         query->start();
@@ -2113,7 +2014,7 @@ Memfile_LeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
                                                    const SubnetID& last_subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_, first_subnet_id,
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(lease_stats_counter_, first_subnet_id,
                                                          last_subnet_id));
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
@@ -2127,7 +2028,7 @@ Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startLeaseStatsQuery6() {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_));
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(lease_stats_counter_));
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         query->start();
@@ -2140,7 +2041,7 @@ Memfile_LeaseMgr::startLeaseStatsQuery6() {
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_, subnet_id));
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(lease_stats_counter_, subnet_id));
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
         query->start();
@@ -2154,7 +2055,7 @@ Memfile_LeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
                                                    const SubnetID& last_subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_, first_subnet_id,
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(lease_stats_counter_, first_subnet_id,
                                                          last_subnet_id));
     if (MultiThreadingMgr::instance().getMode()) {
         std::lock_guard<std::mutex> lock(*mutex_);
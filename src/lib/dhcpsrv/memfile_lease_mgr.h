@@ -14,6 +14,7 @@
 #include <dhcpsrv/csv_lease_file4.h>
 #include <dhcpsrv/csv_lease_file6.h>
 #include <dhcpsrv/memfile_lease_limits.h>
+#include <dhcpsrv/memfile_lease_stats.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/tracking_lease_mgr.h>
 
@@ -1210,6 +1211,19 @@ private:
     /// run_once_now parameter.
     void lfcSetup(bool conversion_needed = false);
 
+    /// @brief Setup the write-behind mode of the lease files.
+    ///
+    /// This method checks if the @c write-behind configuration parameter
+    /// is set to true and enables the write-behind mode of the lease file,
+    /// using the @c write-behind-interval (in milliseconds, 100 by default)
+    /// and @c write-behind-sync (false by default) parameters. In this
+    /// mode the lease updates are appended to the lease file by a
+    /// dedicated thread, so the file I/O is not performed while the
+    /// backend mutex is held.
+    ///
+    /// @throw BadValue if a parameter has an invalid value.
+    void writeBehindSetup();
+
     /// @brief Performs a lease file cleanup for DHCPv4 or DHCPv6.
     ///
     /// This method performs all the actions necessary to prepare for the
@@ -1252,6 +1266,12 @@ private:
     /// @brief Class lease counts container
     ClassLeaseCounter class_lease_counter_;
 
+    /// @brief Lease statistics counts container
+    ///
+    /// Maintained on each lease change so the lease stats queries
+    /// do not have to iterate over the leases.
+    LeaseStatsCounter lease_stats_counter_;
+
 public:
     /// @brief Returns the class lease count for a given class and lease type.
     ///
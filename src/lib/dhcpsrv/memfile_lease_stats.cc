@@ -0,0 +1,114 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/memfile_lease_stats.h>
+
+#include <limits>
+
+namespace isc {
+namespace dhcp {
+
+int64_t
+LeaseStatsCounter::getCount(const SubnetID& subnet_id,
+                            const Lease::Type& ltype,
+                            const uint32_t state) const {
+    auto it = counts_.find(CountKey(subnet_id, ltype, state));
+    if (it == counts_.end()) {
+        return (0);
+    }
+    return (it->second);
+}
+
+void
+LeaseStatsCounter::addLease(const LeasePtr& lease) {
+    if (lease && isCounted(*lease)) {
+        adjustCount(*lease, 1);
+    }
+}
+
+void
+LeaseStatsCounter::updateLease(const LeasePtr& new_lease,
+                               const LeasePtr& old_lease) {
+    // Nothing to do when the key did not change.
+    if (new_lease && old_lease &&
+        (new_lease->subnet_id_ == old_lease->subnet_id_) &&
+        (new_lease->getType() == old_lease->getType()) &&
+        (new_lease->state_ == old_lease->state_)) {
+        return;
+    }
+
+    removeLease(old_lease);
+    addLease(new_lease);
+}
+
+void
+LeaseStatsCounter::removeLease(const LeasePtr& lease) {
+    if (lease && isCounted(*lease)) {
+        adjustCount(*lease, -1);
+    }
+}
+
+void
+LeaseStatsCounter::getRows(const SubnetID& first_subnet_id,
+                           const SubnetID& last_subnet_id, bool v6,
+                           std::vector<LeaseStatsRow>& rows) const {
+    if (first_subnet_id > last_subnet_id) {
+        return;
+    }
+
+    // Lease types are ordered as NA, TA, PD, V4 so the range of a subnet
+    // starts with NA and ends with V4.
+    auto lower = counts_.lower_bound(CountKey(first_subnet_id,
+                                              Lease::TYPE_NA, 0));
+    auto upper = counts_.upper_bound(CountKey(last_subnet_id, Lease::TYPE_V4,
+                                              std::numeric_limits<uint32_t>::max()));
+    for (auto it = lower; it != upper; ++it) {
+        const SubnetID& subnet_id = std::get<0>(it->first);
+        const Lease::Type& ltype = std::get<1>(it->first);
+        const uint32_t state = std::get<2>(it->first);
+        if (ltype == Lease::TYPE_V4) {
+            if (!v6) {
+                rows.push_back(LeaseStatsRow(subnet_id, state, it->second));
+            }
+        } else if (v6) {
+            rows.push_back(LeaseStatsRow(subnet_id, ltype, state, it->second));
+        }
+    }
+}
+
+bool
+LeaseStatsCounter::isCounted(const Lease& lease) {
+    if (lease.state_ == Lease::STATE_DEFAULT) {
+        return (lease.getType() != Lease::TYPE_TA);
+    } else if (lease.state_ == Lease::STATE_DECLINED) {
+        // In theory only addresses can be declined.
+        return ((lease.getType() == Lease::TYPE_V4) ||
+                (lease.getType() == Lease::TYPE_NA));
+    }
+    return (false);
+}
+
+void
+LeaseStatsCounter::adjustCount(const Lease& lease, int64_t offset) {
+    CountKey key(lease.subnet_id_, lease.getType(), lease.state_);
+    auto it = counts_.find(key);
+    if (it == counts_.end()) {
+        if (offset > 0) {
+            counts_.insert(std::make_pair(key, offset));
+        }
+        return;
+    }
+
+    it->second += offset;
+    if (it->second <= 0) {
+        counts_.erase(it);
+    }
+}
+
+}  // namespace dhcp
+}  // namespace isc
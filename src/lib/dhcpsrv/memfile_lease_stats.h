@@ -0,0 +1,137 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MEMFILE_LEASE_STATS_H
+#define MEMFILE_LEASE_STATS_H
+
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/subnet_id.h>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Container that maintains counts of leases per subnet, lease type
+/// and lease state.
+///
+/// The Memfile lease manager updates the counts each time a lease is added,
+/// updated or deleted so the statistical lease data queries only have to
+/// walk the counts of the requested subnets instead of all their leases.
+///
+/// The counted leases are the same as the ones the SQL backends count
+/// in their lease statistics tables:
+///
+/// - Lease::STATE_DEFAULT (i.e. assigned) addresses and prefixes
+/// - Lease::STATE_DECLINED addresses
+///
+/// The container is not thread safe: it is expected to be used under the
+/// protection of the lease manager mutex.
+class LeaseStatsCounter {
+public:
+    /// @brief Key of a count: subnet identifier, lease type and state.
+    typedef std::tuple<SubnetID, Lease::Type, uint32_t> CountKey;
+
+    /// @brief Defines CountMap as an ordered map of counts.
+    ///
+    /// Ordering by subnet identifier allows to return the counts of a
+    /// range of subnets.
+    typedef std::map<CountKey, int64_t> CountMap;
+
+    /// @brief Constructor
+    LeaseStatsCounter() = default;
+
+    /// @brief Destructor
+    ~LeaseStatsCounter() = default;
+
+    /// @brief Fetches the count for the given subnet, lease type and state.
+    ///
+    /// @param subnet_id subnet for which the count is desired
+    /// @param ltype lease type for which the count is desired
+    /// @param state lease state for which the count is desired
+    ///
+    /// @return Number of leases. If there is no entry found a value of
+    /// zero is returned.
+    int64_t getCount(const SubnetID& subnet_id, const Lease::Type& ltype,
+                     const uint32_t state) const;
+
+    /// @brief Increment the count of a lease by one
+    ///
+    /// Function is intended to be used whenever a new lease is being added.
+    ///
+    /// @param lease lease to count
+    void addLease(const LeasePtr& lease);
+
+    /// @brief Adjust counts given a new and old version of a lease
+    ///
+    /// Function is intended to be used whenever an existing lease is being
+    /// updated. Counts are changed only when the subnet, the type or the
+    /// state of the lease changed.
+    ///
+    /// @param new_lease new version of the lease
+    /// @param old_lease old version of the lease
+    void updateLease(const LeasePtr& new_lease, const LeasePtr& old_lease);
+
+    /// @brief Decrement the count of a lease by one
+    ///
+    /// Function is intended to be used whenever an existing lease is being
+    /// deleted.
+    ///
+    /// @param lease lease to uncount
+    void removeLease(const LeasePtr& lease);
+
+    /// @brief Remove all entries.
+    void clear() {
+        counts_.clear();
+    }
+
+    /// @brief Get the number of non zero counts.
+    size_t size() const {
+        return (counts_.size());
+    }
+
+    /// @brief Appends statistical lease data rows for a range of subnets.
+    ///
+    /// One row per non zero count is appended, ordered by subnet identifier,
+    /// lease type and lease state. DHCPv4 rows are built with the
+    /// constructor which does not take a lease type so they are identical
+    /// to the rows returned by the other backends.
+    ///
+    /// @param first_subnet_id first subnet in the range
+    /// @param last_subnet_id last subnet in the range
+    /// @param v6 true for DHCPv6 leases, false for DHCPv4 leases
+    /// @param[out] rows vector the rows are appended to
+    void getRows(const SubnetID& first_subnet_id,
+                 const SubnetID& last_subnet_id, bool v6,
+                 std::vector<LeaseStatsRow>& rows) const;
+
+private:
+    /// @brief Checks if a lease is counted.
+    ///
+    /// @param lease lease to check
+    /// @return true if the lease type and state are counted
+    static bool isCounted(const Lease& lease);
+
+    /// @brief Adjust the count of a lease by a signed offset.
+    ///
+    /// The entry is created when missing and removed when the count
+    /// drops to zero.
+    ///
+    /// @param lease lease to count
+    /// @param offset signed amount to add to the current count
+    void adjustCount(const Lease& lease, int64_t offset);
+
+    /// @brief Counts of leases.
+    CountMap counts_;
+};
+
+}  // namespace dhcp
+}  // namespace isc
+
+#endif // MEMFILE_LEASE_STATS_H
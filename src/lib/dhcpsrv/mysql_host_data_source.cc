@@ -2053,6 +2053,8 @@ public:
         GET_HOST_SUBID6_PAGE,      // Gets hosts by IPv6 SubnetID beginning by HID
         GET_HOST_PAGE4,            // Gets v4 hosts beginning by HID
         GET_HOST_PAGE6,            // Gets v6 hosts beginning by HID
+        GET_HOST_SUBID4_DHCPIDS,   // Gets hosts by IPv4 SubnetID and identifiers
+        GET_HOST_SUBID6_DHCPIDS,   // Gets hosts by IPv6 SubnetID and identifiers
         INSERT_HOST_NON_UNIQUE_IP, // Insert new host to collection with allowing IP duplicates
         INSERT_HOST_UNIQUE_IP,     // Insert new host to collection with checking for IP duplicates
         INSERT_V6_RESRV_NON_UNIQUE,// Insert v6 reservation without checking that it is unique
@@ -2257,6 +2259,36 @@ public:
                          StatementIndex stindex,
                          boost::shared_ptr<MySqlHostExchange> exchange) const;
 
+    /// @brief Maximum number of identifiers of a query by subnet and
+    /// identifiers: one for each identifier type.
+    static const size_t MAX_IDENTIFIERS = Host::LAST_IDENTIFIER_TYPE + 1;
+
+    // The GET_HOST_SUBID4_DHCPIDS and GET_HOST_SUBID6_DHCPIDS statements
+    // hard code one (type, identifier) pair per identifier type: they
+    // must be updated when an identifier type is added.
+    static_assert(MAX_IDENTIFIERS == 5,
+                  "update the statements retrieving hosts by identifiers");
+
+    /// @brief Retrieves the hosts using a subnet identifier and any of
+    /// the specified identifiers.
+    ///
+    /// One query is issued for each @c MAX_IDENTIFIERS identifiers, so
+    /// only one query is issued unless an identifier type is repeated.
+    ///
+    /// @param ctx Context
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    /// @param stindex Statement index.
+    /// @param exchange Pointer to the exchange object used for the
+    /// particular query.
+    ///
+    /// @return Collection of const @c Host objects.
+    ConstHostCollection getHosts(MySqlHostContextPtr& ctx,
+                                 const SubnetID& subnet_id,
+                                 const HostIdentifierList& identifiers,
+                                 StatementIndex stindex,
+                                 boost::shared_ptr<MySqlHostExchange> exchange) const;
+
     /// @brief Throws exception if database is read only.
     ///
     /// This method should be called by the methods which write to the
@@ -2650,6 +2682,55 @@ TaggedStatementArray tagged_statements = { {
                 "ON h.host_id = r.host_id "
             "ORDER BY h.host_id, o.option_id, r.reservation_id"},
 
+    // Retrieves host information and DHCPv4 options using subnet identifier
+    // and up to one client's identifier of each type. Unused identifier
+    // parameters repeat a used one.
+    {MySqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS,
+            "SELECT h.host_id, h.dhcp_identifier, h.dhcp_identifier_type, "
+                "h.dhcp4_subnet_id, h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+                "h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+                "h.dhcp4_next_server, h.dhcp4_server_hostname, "
+                "h.dhcp4_boot_file_name, h.auth_key, "
+                "o.option_id, o.code, o.value, o.formatted_value, o.space, "
+                "o.persistent, o.cancelled, o.user_context "
+            "FROM hosts AS h "
+            "LEFT JOIN dhcp4_options AS o "
+                "ON h.host_id = o.host_id "
+            "WHERE h.dhcp4_subnet_id = ? AND ("
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?)) "
+            "ORDER BY h.host_id, o.option_id"},
+
+    // Retrieves host information, IPv6 reservations and DHCPv6 options
+    // using subnet identifier and up to one client's identifier of each
+    // type. Unused identifier parameters repeat a used one.
+    {MySqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS,
+            "SELECT h.host_id, h.dhcp_identifier, "
+                "h.dhcp_identifier_type, h.dhcp4_subnet_id, "
+                "h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+                "h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+                "h.dhcp4_next_server, h.dhcp4_server_hostname, "
+                "h.dhcp4_boot_file_name, h.auth_key, "
+                "o.option_id, o.code, o.value, o.formatted_value, o.space, "
+                "o.persistent, o.cancelled, o.user_context, "
+                "r.reservation_id, r.address, r.prefix_len, r.type, "
+                "r.dhcp6_iaid "
+            "FROM hosts AS h "
+            "LEFT JOIN dhcp6_options AS o "
+                "ON h.host_id = o.host_id "
+            "LEFT JOIN ipv6_reservations AS r "
+                "ON h.host_id = r.host_id "
+            "WHERE h.dhcp6_subnet_id = ? AND ("
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?) OR "
+                "(h.dhcp_identifier_type = ? AND h.dhcp_identifier = ?)) "
+            "ORDER BY h.host_id, o.option_id, r.reservation_id"},
+
     // Inserts a host into the 'hosts' table without checking that there is
     // a reservation for the IP address.
     {MySqlHostDataSourceImpl::INSERT_HOST_NON_UNIQUE_IP,
@@ -3172,6 +3253,60 @@ MySqlHostDataSourceImpl::getHost(MySqlHostContextPtr& ctx,
     return (result);
 }
 
+ConstHostCollection
+MySqlHostDataSourceImpl::getHosts(MySqlHostContextPtr& ctx,
+                                  const SubnetID& subnet_id,
+                                  const HostIdentifierList& identifiers,
+                                  StatementIndex stindex,
+                                  boost::shared_ptr<MySqlHostExchange> exchange) const {
+    ConstHostCollection result;
+    auto it = identifiers.begin();
+    while (it != identifiers.end()) {
+        std::vector<const HostIdentifierPair*> chunk;
+        for (; (it != identifiers.end()) && (chunk.size() < MAX_IDENTIFIERS); ++it) {
+            chunk.push_back(&(*it));
+        }
+
+        // Set up the WHERE clause value
+        MYSQL_BIND inbind[1 + 2 * MAX_IDENTIFIERS];
+        memset(inbind, 0, sizeof(inbind));
+
+        uint32_t subnet_buffer = static_cast<uint32_t>(subnet_id);
+        inbind[0].buffer_type = MYSQL_TYPE_LONG;
+        inbind[0].buffer = reinterpret_cast<char*>(&subnet_buffer);
+        inbind[0].is_unsigned = MLM_TRUE;
+
+        char identifier_types[MAX_IDENTIFIERS];
+        std::vector<char> identifier_vecs[MAX_IDENTIFIERS];
+        unsigned long lengths[MAX_IDENTIFIERS];
+        for (size_t i = 0; i < MAX_IDENTIFIERS; ++i) {
+            // Unused parameters repeat the last identifier.
+            const HostIdentifierPair& id_pair =
+                *chunk[std::min(i, chunk.size() - 1)];
+
+            // Identifier type.
+            identifier_types[i] = static_cast<char>(id_pair.first);
+            inbind[1 + 2 * i].buffer_type = MYSQL_TYPE_TINY;
+            inbind[1 + 2 * i].buffer = &identifier_types[i];
+            inbind[1 + 2 * i].is_unsigned = MLM_TRUE;
+
+            // Identifier value.
+            identifier_vecs[i].assign(id_pair.second.begin(), id_pair.second.end());
+            lengths[i] = identifier_vecs[i].size();
+            inbind[2 + 2 * i].buffer_type = MYSQL_TYPE_BLOB;
+            inbind[2 + 2 * i].buffer = identifier_vecs[i].data();
+            inbind[2 + 2 * i].buffer_length = lengths[i];
+            inbind[2 + 2 * i].length = &lengths[i];
+        }
+
+        ConstHostCollection collection;
+        getHostCollection(ctx, stindex, inbind, exchange, collection, false);
+        result.insert(result.end(), collection.begin(), collection.end());
+    }
+
+    return (result);
+}
+
 void
 MySqlHostDataSourceImpl::checkReadOnly(MySqlHostContextPtr& ctx) const {
     if (ctx->is_readonly_) {
@@ -3716,6 +3851,18 @@ MySqlHostDataSource::get4(const SubnetID& subnet_id,
                            ctx->host_ipv4_exchange_));
 }
 
+ConstHostCollection
+MySqlHostDataSource::getAllbyIdentifiers4(const SubnetID& subnet_id,
+                                          const HostIdentifierList& identifiers) const {
+    // Get a context
+    MySqlHostContextAlloc get_context(*impl_);
+    MySqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHosts(ctx, subnet_id, identifiers,
+                            MySqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS,
+                            ctx->host_ipv4_exchange_));
+}
+
 ConstHostPtr
 MySqlHostDataSource::get4(const SubnetID& subnet_id,
                           const asiolink::IOAddress& address) const {
@@ -3799,6 +3946,18 @@ MySqlHostDataSource::get6(const SubnetID& subnet_id,
                            ctx->host_ipv6_exchange_));
 }
 
+ConstHostCollection
+MySqlHostDataSource::getAllbyIdentifiers6(const SubnetID& subnet_id,
+                                          const HostIdentifierList& identifiers) const {
+    // Get a context
+    MySqlHostContextAlloc get_context(*impl_);
+    MySqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHosts(ctx, subnet_id, identifiers,
+                            MySqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS,
+                            ctx->host_ipv6_exchange_));
+}
+
 ConstHostPtr
 MySqlHostDataSource::get6(const asiolink::IOAddress& prefix,
                           const uint8_t prefix_len) const {
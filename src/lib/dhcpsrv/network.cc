@@ -73,12 +73,13 @@ Network::clientSupported(const isc::dhcp::ClientClasses& classes) const {
         return (true);
     }
 
-    return (classes.contains(client_class_));
+    return (classes.contains(client_class_id_));
 }
 
 void
 Network::allowClientClass(const isc::dhcp::ClientClass& class_name) {
     client_class_ = class_name;
+    client_class_id_ = ClientClassRegistry::instance().intern(class_name);
 }
 
 void
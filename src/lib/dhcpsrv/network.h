@@ -211,7 +211,7 @@ public:
 
     /// @brief Constructor.
     Network()
-        : iface_name_(), client_class_(), t1_(), t2_(), valid_(),
+        : iface_name_(), client_class_(), client_class_id_(0), t1_(), t2_(), valid_(),
           reservations_global_(false, true), reservations_in_subnet_(true, true),
           reservations_out_of_pool_(false, true), cfg_option_(new CfgOption()),
           calculate_tee_times_(), t1_percent_(), t2_percent_(),
@@ -1146,6 +1146,12 @@ protected:
     /// which means that any client is allowed, regardless of its class.
     util::Optional<ClientClass> client_class_;
 
+    /// @brief Interned identifier of the client class
+    ///
+    /// Set with the client class so the client class check does not
+    /// have to hash the class name.
+    ClientClassId client_class_id_;
+
     /// @brief Required classes
     ///
     /// If the network is selected these classes will be added to the
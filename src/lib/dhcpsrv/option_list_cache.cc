@@ -0,0 +1,78 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/option_list_cache.h>
+#include <exceptions/exceptions.h>
+#include <util/multi_threading_mgr.h>
+
+using namespace isc::util;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+
+OptionListCache::OptionListCache(size_t max_entries)
+    : max_entries_(max_entries), entries_(), mutex_() {
+    if (max_entries == 0) {
+        isc_throw(BadValue, "option list cache size must be greater than 0");
+    }
+}
+
+ConstResolvedOptionsPtr
+OptionListCache::get(SubnetID subnet_id, const Pool* pool,
+                     const ClientClasses& classes,
+                     const vector<uint16_t>& requested) {
+    KeyRef key = { subnet_id, pool, classes, requested };
+    MultiThreadingLock lock(mutex_);
+    auto& idx = entries_.get<1>();
+    auto it = idx.find(key, KeyLess());
+    if (it == idx.end()) {
+        return (ConstResolvedOptionsPtr());
+    }
+    // Move the entry to the front of the eviction order.
+    entries_.relocate(entries_.begin(), entries_.project<0>(it));
+    return (it->resolved_);
+}
+
+void
+OptionListCache::put(SubnetID subnet_id, const Pool* pool,
+                     const ClientClasses& classes,
+                     const vector<uint16_t>& requested,
+                     const ConstResolvedOptionsPtr& resolved) {
+    Entry entry = { { subnet_id, pool,
+                      vector<ClientClass>(classes.cbegin(), classes.cend()),
+                      requested },
+                    resolved };
+    MultiThreadingLock lock(mutex_);
+    auto& idx = entries_.get<1>();
+    auto it = idx.find(entry.key_);
+    if (it != idx.end()) {
+        idx.replace(it, entry);
+        entries_.relocate(entries_.begin(), entries_.project<0>(it));
+        return;
+    }
+    if (entries_.size() >= max_entries_) {
+        entries_.pop_back();
+    }
+    entries_.push_front(entry);
+}
+
+void
+OptionListCache::clear() {
+    MultiThreadingLock lock(mutex_);
+    entries_.clear();
+}
+
+size_t
+OptionListCache::size() const {
+    MultiThreadingLock lock(mutex_);
+    return (entries_.size());
+}
+
+} // namespace dhcp
+} // namespace isc
@@ -0,0 +1,213 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OPTION_LIST_CACHE_H
+#define OPTION_LIST_CACHE_H
+
+#include <dhcp/classify.h>
+#include <dhcp/option.h>
+#include <dhcpsrv/cfg_option.h>
+#include <dhcpsrv/subnet_id.h>
+
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+class Pool;
+
+/// @brief Options resolved for a given list of option configurations and
+/// a given list of requested option codes.
+///
+/// This is the outcome of walking the option configurations (pool, subnet,
+/// shared network, client classes and globals) for each requested code:
+/// it can be appended to a response as is.
+struct ResolvedOptions {
+    /// @brief The option configurations the options were resolved from,
+    /// in order of precedence.
+    CfgOptionList cfg_option_list_;
+
+    /// @brief The options to append to the response, one per code, in
+    /// increasing code order.
+    std::vector<OptionPtr> options_;
+
+    /// @brief The requested option codes, including the persistent options.
+    std::set<uint16_t> requested_;
+
+    /// @brief The cancelled option codes.
+    std::set<uint16_t> cancelled_;
+};
+
+/// @brief Pointer to resolved options.
+typedef boost::shared_ptr<const ResolvedOptions> ConstResolvedOptionsPtr;
+
+/// @brief Cache of resolved options.
+///
+/// Clients on the same subnet and pool, in the same classes and asking
+/// for the same options get the same options: the cache keeps the option
+/// configurations and the resolved options by subnet, pool, list of client
+/// classes and list of requested codes, so the common case gets them with
+/// a single lookup instead of walking the configuration.
+///
+/// The cached entries are valid for a server configuration: each server
+/// configuration owns a cache, which is flushed when another configuration
+/// is merged into it, so the pools used as keys outlive their entries.
+/// The cache is bounded in size and evicts the least recently used entry
+/// when full.  Options of host reservations are not expected to be cached
+/// as they are specific to a client.
+///
+/// The cache is thread safe: it is locked only when multi-threading is
+/// enabled.
+class OptionListCache : public boost::noncopyable {
+public:
+    /// @brief Default maximum number of entries.
+    static const size_t DEFAULT_MAX_ENTRIES = 1024;
+
+    /// @brief Constructor.
+    ///
+    /// @param max_entries The maximum number of entries.
+    explicit OptionListCache(size_t max_entries = DEFAULT_MAX_ENTRIES);
+
+    /// @brief Returns the resolved options.
+    ///
+    /// @param subnet_id The identifier of the subnet.
+    /// @param pool The pool when it has options, null otherwise.
+    /// @param classes The client classes of the query.
+    /// @param requested The list of requested option codes as sent by the
+    /// client.
+    /// @return The resolved options or null when not cached.
+    ConstResolvedOptionsPtr get(SubnetID subnet_id, const Pool* pool,
+                                const ClientClasses& classes,
+                                const std::vector<uint16_t>& requested);
+
+    /// @brief Adds resolved options.
+    ///
+    /// @param subnet_id The identifier of the subnet.
+    /// @param pool The pool when it has options, null otherwise.
+    /// @param classes The client classes of the query.
+    /// @param requested The list of requested option codes as sent by the
+    /// client.
+    /// @param resolved The resolved options.
+    void put(SubnetID subnet_id, const Pool* pool,
+             const ClientClasses& classes,
+             const std::vector<uint16_t>& requested,
+             const ConstResolvedOptionsPtr& resolved);
+
+    /// @brief Removes all entries.
+    void clear();
+
+    /// @brief Returns the number of entries.
+    size_t size() const;
+
+private:
+    /// @brief Key of an entry.
+    struct Key {
+        /// @brief The identifier of the subnet.
+        SubnetID subnet_id_;
+
+        /// @brief The pool, null when it has no options.
+        const Pool* pool_;
+
+        /// @brief The names of the client classes, in packet order.
+        std::vector<ClientClass> classes_;
+
+        /// @brief The requested option codes.
+        std::vector<uint16_t> requested_;
+    };
+
+    /// @brief Key of a lookup, referring to the query to not copy it.
+    struct KeyRef {
+        /// @brief The identifier of the subnet.
+        SubnetID subnet_id_;
+
+        /// @brief The pool, null when it has no options.
+        const Pool* pool_;
+
+        /// @brief The client classes.
+        const ClientClasses& classes_;
+
+        /// @brief The requested option codes.
+        const std::vector<uint16_t>& requested_;
+    };
+
+    /// @brief Orders the keys, and the lookup keys with the keys.
+    struct KeyLess {
+        /// @brief Compares two keys.
+        ///
+        /// @tparam KeyA The type of the first key.
+        /// @tparam KeyB The type of the second key.
+        /// @param a The first key.
+        /// @param b The second key.
+        /// @return true if a is lower than b.
+        template<typename KeyA, typename KeyB>
+        bool operator()(const KeyA& a, const KeyB& b) const {
+            if (a.subnet_id_ != b.subnet_id_) {
+                return (a.subnet_id_ < b.subnet_id_);
+            }
+            if (a.pool_ != b.pool_) {
+                return (std::less<const Pool*>()(a.pool_, b.pool_));
+            }
+            if (a.requested_ != b.requested_) {
+                return (a.requested_ < b.requested_);
+            }
+            return (std::lexicographical_compare(a.classes_.cbegin(),
+                                                 a.classes_.cend(),
+                                                 b.classes_.cbegin(),
+                                                 b.classes_.cend()));
+        }
+    };
+
+    /// @brief An entry of the cache.
+    struct Entry {
+        /// @brief The key.
+        Key key_;
+
+        /// @brief The resolved options.
+        ConstResolvedOptionsPtr resolved_;
+    };
+
+    /// @brief The entries, from the most to the least recently used, and
+    /// by key.
+    typedef boost::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::ordered_unique<
+                boost::multi_index::member<Entry, Key, &Entry::key_>,
+                KeyLess
+            >
+        >
+    > EntryContainer;
+
+    /// @brief The maximum number of entries.
+    size_t max_entries_;
+
+    /// @brief The entries.
+    EntryContainer entries_;
+
+    /// @brief The mutex protecting the cache.
+    mutable std::mutex mutex_;
+};
+
+/// @brief Pointer to an option list cache.
+typedef boost::shared_ptr<OptionListCache> OptionListCachePtr;
+
+} // namespace dhcp
+} // namespace isc
+
+#endif // OPTION_LIST_CACHE_H
@@ -1572,7 +1572,8 @@ D2ClientConfigParser::parse(isc::data::ConstElementPtr client_config) {
     // Now we check for logical errors. This repeats what is done in
     // D2ClientConfig::validate(), but doing it here permits us to
     // emit meaningful parameter position info in the error.
-    if (ncr_format != dhcp_ddns::FMT_JSON) {
+    if ((ncr_format != dhcp_ddns::FMT_JSON) &&
+        (ncr_format != dhcp_ddns::FMT_BINARY)) {
         isc_throw(D2ClientError, "D2ClientConfig error: NCR Format: "
                   << dhcp_ddns::ncrFormatToString(ncr_format)
                   << " is not supported. ("
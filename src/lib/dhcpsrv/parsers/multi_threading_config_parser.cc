@@ -66,6 +66,11 @@ MultiThreadingConfigParser::parse(SrvConfig& srv_cfg,
         }
     }
 
+    // client-affinity is not mandatory
+    if (value->get("client-affinity")) {
+        getBoolean(value, "client-affinity");
+    }
+
     srv_cfg.setDHCPMultiThreading(value);
 }
 
@@ -102,6 +102,8 @@ const SimpleKeywords SimpleParser4::GLOBAL4_PARAMETERS = {
     { "allocator",                        Element::string },
     { "offer-lifetime",                   Element::integer },
     { "ddns-ttl-percent",                 Element::real },
+    { "host-cache-max-entries",           Element::integer },
+    { "host-cache-ttl",                   Element::integer },
 };
 
 /// @brief This table defines default global values for DHCPv4
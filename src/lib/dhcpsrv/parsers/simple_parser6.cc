@@ -103,6 +103,8 @@ const SimpleKeywords SimpleParser6::GLOBAL6_PARAMETERS = {
     { "allocator",                        Element::string },
     { "pd-allocator",                     Element::string },
     { "ddns-ttl-percent",                 Element::real },
+    { "host-cache-max-entries",           Element::integer },
+    { "host-cache-ttl",                   Element::integer },
 };
 
 /// @brief This table defines default global values for DHCPv6
@@ -1412,6 +1412,8 @@ public:
         GET_HOST_SUBID6_PAGE,      // Gets hosts by IPv6 SubnetID beginning by HID
         GET_HOST_PAGE4,            // Gets v4 hosts beginning by HID
         GET_HOST_PAGE6,            // Gets v6 hosts beginning by HID
+        GET_HOST_SUBID4_DHCPIDS,   // Gets hosts by IPv4 SubnetID and identifiers
+        GET_HOST_SUBID6_DHCPIDS,   // Gets hosts by IPv6 SubnetID and identifiers
         INSERT_HOST_NON_UNIQUE_IP, // Insert new host to collection with allowing IP duplicates
         INSERT_HOST_UNIQUE_IP,     // Insert new host to collection with checking for IP duplicates
         INSERT_V6_RESRV_NON_UNIQUE,// Insert v6 reservation without checking that it is unique
@@ -1596,6 +1598,36 @@ public:
                          StatementIndex stindex,
                          boost::shared_ptr<PgSqlHostExchange> exchange) const;
 
+    /// @brief Maximum number of identifiers of a query by subnet and
+    /// identifiers: one for each identifier type.
+    static const size_t MAX_IDENTIFIERS = Host::LAST_IDENTIFIER_TYPE + 1;
+
+    // The GET_HOST_SUBID4_DHCPIDS and GET_HOST_SUBID6_DHCPIDS statements
+    // hard code one (type, identifier) pair per identifier type: they
+    // must be updated when an identifier type is added.
+    static_assert(MAX_IDENTIFIERS == 5,
+                  "update the statements retrieving hosts by identifiers");
+
+    /// @brief Retrieves the hosts using a subnet identifier and any of
+    /// the specified identifiers.
+    ///
+    /// One query is issued for each @c MAX_IDENTIFIERS identifiers, so
+    /// only one query is issued unless an identifier type is repeated.
+    ///
+    /// @param ctx Context
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    /// @param stindex Statement index.
+    /// @param exchange Pointer to the exchange object used for the
+    /// particular query.
+    ///
+    /// @return Collection of const @c Host objects.
+    ConstHostCollection getHosts(PgSqlHostContextPtr& ctx,
+                                 const SubnetID& subnet_id,
+                                 const HostIdentifierList& identifiers,
+                                 StatementIndex stindex,
+                                 boost::shared_ptr<PgSqlHostExchange> exchange) const;
+
     /// @brief Throws exception if database is read only.
     ///
     /// This method should be called by the methods which write to the
@@ -2041,6 +2073,63 @@ TaggedStatementArray tagged_statements = { {
      "ORDER BY h.host_id, o.option_id, r.reservation_id"
     },
 
+    // PgSqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS
+    // Retrieves host information and DHCPv4 options using subnet identifier
+    // and up to one client's identifier of each type. Unused identifier
+    // parameters repeat a used one.
+    {11,
+     { OID_INT8,
+       OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA,
+       OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA },
+     "get_host_subid4_dhcpids",
+     "SELECT h.host_id, h.dhcp_identifier, h.dhcp_identifier_type, "
+     "  h.dhcp4_subnet_id, h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+     "  h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+     "  h.dhcp4_next_server, h.dhcp4_server_hostname, "
+     "  h.dhcp4_boot_file_name, h.auth_key, "
+     "  o.option_id, o.code, o.value, o.formatted_value, o.space, "
+     "  o.persistent, o.cancelled, o.user_context "
+     "FROM hosts AS h "
+     "LEFT JOIN dhcp4_options AS o ON h.host_id = o.host_id "
+     "WHERE h.dhcp4_subnet_id = $1 AND ( "
+     "  (h.dhcp_identifier_type = $2 AND h.dhcp_identifier = $3) OR "
+     "  (h.dhcp_identifier_type = $4 AND h.dhcp_identifier = $5) OR "
+     "  (h.dhcp_identifier_type = $6 AND h.dhcp_identifier = $7) OR "
+     "  (h.dhcp_identifier_type = $8 AND h.dhcp_identifier = $9) OR "
+     "  (h.dhcp_identifier_type = $10 AND h.dhcp_identifier = $11)) "
+     "ORDER BY h.host_id, o.option_id"
+    },
+
+    // PgSqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS
+    // Retrieves host information, IPv6 reservations and DHCPv6 options
+    // using subnet identifier and up to one client's identifier of each
+    // type. Unused identifier parameters repeat a used one.
+    {11,
+     { OID_INT8,
+       OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA,
+       OID_INT2, OID_BYTEA, OID_INT2, OID_BYTEA },
+     "get_host_subid6_dhcpids",
+     "SELECT h.host_id, h.dhcp_identifier, "
+     "  h.dhcp_identifier_type, h.dhcp4_subnet_id, "
+     "  h.dhcp6_subnet_id, h.ipv4_address, h.hostname, "
+     "  h.dhcp4_client_classes, h.dhcp6_client_classes, h.user_context, "
+     "  h.dhcp4_next_server, h.dhcp4_server_hostname, "
+     "  h.dhcp4_boot_file_name, h.auth_key, "
+     "  o.option_id, o.code, o.value, o.formatted_value, o.space, "
+     "  o.persistent, o.cancelled, o.user_context, "
+     "  r.reservation_id, r.address, r.prefix_len, r.type, r.dhcp6_iaid "
+     "FROM hosts AS h "
+     "LEFT JOIN dhcp6_options AS o ON h.host_id = o.host_id "
+     "LEFT JOIN ipv6_reservations AS r ON h.host_id = r.host_id "
+     "WHERE h.dhcp6_subnet_id = $1 AND ( "
+     "  (h.dhcp_identifier_type = $2 AND h.dhcp_identifier = $3) OR "
+     "  (h.dhcp_identifier_type = $4 AND h.dhcp_identifier = $5) OR "
+     "  (h.dhcp_identifier_type = $6 AND h.dhcp_identifier = $7) OR "
+     "  (h.dhcp_identifier_type = $8 AND h.dhcp_identifier = $9) OR "
+     "  (h.dhcp_identifier_type = $10 AND h.dhcp_identifier = $11)) "
+     "ORDER BY h.host_id, o.option_id, r.reservation_id"
+    },
+
     // PgSqlHostDataSourceImpl::INSERT_HOST_NON_UNIQUE_IP
     // Inserts a host into the 'hosts' table without checking that there is
     // a reservation for the IP address.
@@ -2579,6 +2668,46 @@ PgSqlHostDataSourceImpl::getHost(PgSqlHostContextPtr& ctx,
     return (result);
 }
 
+ConstHostCollection
+PgSqlHostDataSourceImpl::getHosts(PgSqlHostContextPtr& ctx,
+                                  const SubnetID& subnet_id,
+                                  const HostIdentifierList& identifiers,
+                                  StatementIndex stindex,
+                                  boost::shared_ptr<PgSqlHostExchange> exchange) const {
+    ConstHostCollection result;
+    auto it = identifiers.begin();
+    while (it != identifiers.end()) {
+        std::vector<const HostIdentifierPair*> chunk;
+        for (; (it != identifiers.end()) && (chunk.size() < MAX_IDENTIFIERS); ++it) {
+            chunk.push_back(&(*it));
+        }
+
+        // Set up the WHERE clause value
+        PsqlBindArrayPtr bind_array(new PsqlBindArray());
+
+        // Add the subnet id.
+        bind_array->add(subnet_id);
+
+        for (size_t i = 0; i < MAX_IDENTIFIERS; ++i) {
+            // Unused parameters repeat the last identifier.
+            const HostIdentifierPair& id_pair =
+                *chunk[std::min(i, chunk.size() - 1)];
+
+            // Add the Identifier type.
+            bind_array->add(static_cast<uint8_t>(id_pair.first));
+
+            // Add the identifier value.
+            bind_array->add(id_pair.second);
+        }
+
+        ConstHostCollection collection;
+        getHostCollection(ctx, stindex, bind_array, exchange, collection, false);
+        result.insert(result.end(), collection.begin(), collection.end());
+    }
+
+    return (result);
+}
+
 std::pair<uint32_t, uint32_t>
 PgSqlHostDataSourceImpl::getVersion() const {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
@@ -3019,6 +3148,18 @@ PgSqlHostDataSource::get4(const SubnetID& subnet_id,
                            ctx->host_ipv4_exchange_));
 }
 
+ConstHostCollection
+PgSqlHostDataSource::getAllbyIdentifiers4(const SubnetID& subnet_id,
+                                          const HostIdentifierList& identifiers) const {
+    // Get a context
+    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHosts(ctx, subnet_id, identifiers,
+                            PgSqlHostDataSourceImpl::GET_HOST_SUBID4_DHCPIDS,
+                            ctx->host_ipv4_exchange_));
+}
+
 ConstHostPtr
 PgSqlHostDataSource::get4(const SubnetID& subnet_id,
                           const asiolink::IOAddress& address) const {
@@ -3094,6 +3235,18 @@ PgSqlHostDataSource::get6(const SubnetID& subnet_id,
                            ctx->host_ipv6_exchange_));
 }
 
+ConstHostCollection
+PgSqlHostDataSource::getAllbyIdentifiers6(const SubnetID& subnet_id,
+                                          const HostIdentifierList& identifiers) const {
+    // Get a context
+    PgSqlHostContextAlloc get_context(*impl_);
+    PgSqlHostContextPtr ctx = get_context.ctx_;
+
+    return (impl_->getHosts(ctx, subnet_id, identifiers,
+                            PgSqlHostDataSourceImpl::GET_HOST_SUBID6_DHCPIDS,
+                            ctx->host_ipv6_exchange_));
+}
+
 ConstHostPtr
 PgSqlHostDataSource::get6(const asiolink::IOAddress& prefix,
                           const uint8_t prefix_len) const {
@@ -451,6 +451,34 @@ public:
     getAll6(const SubnetID& subnet_id,
             const asiolink::IOAddress& address) const;
 
+    /// @brief Returns the hosts connected to the IPv4 subnet and using
+    /// any of the specified identifiers.
+    ///
+    /// The lookup is done with a single query for up to one identifier
+    /// of each type.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyIdentifiers4(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
+    /// @brief Returns the hosts connected to the IPv6 subnet and using
+    /// any of the specified identifiers.
+    ///
+    /// The lookup is done with a single query for up to one identifier
+    /// of each type.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifiers Host identifiers.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAllbyIdentifiers6(const SubnetID& subnet_id,
+                         const HostIdentifierList& identifiers) const;
+
     /// @brief Implements @ref BaseHostDataSource::update() for PostgreSQL.
     ///
     /// Attempts to update an existing host entry.
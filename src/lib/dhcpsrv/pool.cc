@@ -22,7 +22,7 @@ Pool::Pool(Lease::Type type, const isc::asiolink::IOAddress& first,
            const isc::asiolink::IOAddress& last)
     : id_(getNextID()), first_(first), last_(last), type_(type),
       capacity_(0), cfg_option_(new CfgOption()), client_class_(""),
-      permutation_() {
+      client_class_id_(0), permutation_() {
 }
 
 bool Pool::inRange(const isc::asiolink::IOAddress& addr) const {
@@ -30,11 +30,12 @@ bool Pool::inRange(const isc::asiolink::IOAddress& addr) const {
 }
 
 bool Pool::clientSupported(const ClientClasses& classes) const {
-    return (client_class_.empty() || classes.contains(client_class_));
+    return (client_class_.empty() || classes.contains(client_class_id_));
 }
 
 void Pool::allowClientClass(const ClientClass& class_name) {
     client_class_ = class_name;
+    client_class_id_ = ClientClassRegistry::instance().intern(class_name);
 }
 
 std::string
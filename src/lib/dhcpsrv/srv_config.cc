@@ -35,6 +35,7 @@ namespace dhcp {
 SrvConfig::SrvConfig()
     : sequence_(0), cfg_iface_(new CfgIface()),
       cfg_option_def_(new CfgOptionDef()), cfg_option_(new CfgOption()),
+      option_list_cache_(new OptionListCache()),
       cfg_subnets4_(new CfgSubnets4()), cfg_subnets6_(new CfgSubnets6()),
       cfg_shared_networks4_(new CfgSharedNetworks4()),
       cfg_shared_networks6_(new CfgSharedNetworks6()),
@@ -55,6 +56,7 @@ SrvConfig::SrvConfig()
 SrvConfig::SrvConfig(const uint32_t sequence)
     : sequence_(sequence), cfg_iface_(new CfgIface()),
       cfg_option_def_(new CfgOptionDef()), cfg_option_(new CfgOption()),
+      option_list_cache_(new OptionListCache()),
       cfg_subnets4_(new CfgSubnets4()), cfg_subnets6_(new CfgSubnets6()),
       cfg_shared_networks4_(new CfgSharedNetworks4()),
       cfg_shared_networks6_(new CfgSharedNetworks6()),
@@ -169,6 +171,10 @@ SrvConfig::equals(const SrvConfig& other) const {
 void
 SrvConfig::merge(ConfigBase& other) {
     ConfigBase::merge(other);
+
+    // The options resolved so far may be changed by the merge.
+    option_list_cache_->clear();
+
     try {
         SrvConfig& other_srv_config = dynamic_cast<SrvConfig&>(other);
         // We merge objects in order of dependency (real or theoretical).
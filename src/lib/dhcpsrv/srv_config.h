@@ -25,6 +25,7 @@
 #include <dhcpsrv/cfg_consistency.h>
 #include <dhcpsrv/client_class_def.h>
 #include <dhcpsrv/d2_client_cfg.h>
+#include <dhcpsrv/option_list_cache.h>
 #include <process/config_base.h>
 #include <hooks/hooks_config.h>
 #include <cc/data.h>
@@ -327,6 +328,17 @@ public:
         return (cfg_option_);
     }
 
+    /// @brief Returns pointer to the cache of resolved options.
+    ///
+    /// The cache holds the options to be returned to the clients, resolved
+    /// from the options configured at the different levels. It is flushed
+    /// when another configuration is merged into this one.
+    ///
+    /// @return Pointer to the cache of resolved options.
+    OptionListCachePtr getOptionListCache() const {
+        return (option_list_cache_);
+    }
+
     /// @brief Returns pointer to non-const object holding subnets configuration
     /// for DHCPv4.
     ///
@@ -1121,6 +1133,9 @@ private:
     /// connected to any subnet.
     CfgOptionPtr cfg_option_;
 
+    /// @brief Pointer to the cache of resolved options.
+    OptionListCachePtr option_list_cache_;
+
     /// @brief Pointer to subnets configuration for IPv4.
     CfgSubnets4Ptr cfg_subnets4_;
 
@@ -9,6 +9,9 @@
 #include <asiolink/io_address.h>
 #include <asiolink/addr_utilities.h>
 #include <dhcp/option_space.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/flq_allocation_state.h>
 #include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/iterative_allocation_state.h>
@@ -57,6 +60,28 @@ comparePoolFirstAddress(const PoolPtr& pool1, const PoolPtr& pool2) {
     return (pool1->getFirstAddress() < pool2->getFirstAddress());
 };
 
+/// @brief Checks if the bitmap allocator supports all pools of a collection.
+///
+/// Logs a warning when it does not.
+///
+/// @param pools Collection of pools.
+/// @param type Type of the leases of the pools.
+/// @param subnet Subnet owning the pools.
+/// @return true if no pool is larger than the bitmap allocator limit.
+bool
+bitmapSupported(const PoolCollection& pools, Lease::Type type,
+                const Subnet& subnet) {
+    if (std::all_of(pools.begin(), pools.end(),
+                    PoolBitmapAllocationState::isSupported)) {
+        return (true);
+    }
+    LOG_WARN(dhcpsrv_logger, DHCPSRV_CFGMGR_BITMAP_POOL_TOO_LARGE)
+        .arg(PoolBitmapAllocationState::MAX_CAPACITY)
+        .arg(Lease::typeToText(type))
+        .arg(subnet.toText());
+    return (false);
+}
+
 }
 
 namespace isc {
@@ -758,6 +783,10 @@ Subnet4::createAllocators() {
     if (allocator_type.empty()) {
         allocator_type = getDefaultAllocatorType();
     }
+    if ((allocator_type == "bitmap") &&
+        !bitmapSupported(pools_, Lease::TYPE_V4, *this)) {
+        allocator_type = "iterative";
+    }
     if (allocator_type == "random") {
         setAllocator(Lease::TYPE_V4,
                      boost::make_shared<RandomAllocator>
@@ -778,6 +807,16 @@ Subnet4::createAllocators() {
             pool->setAllocationState(PoolFreeLeaseQueueAllocationState::create(pool));
         }
 
+    } else if (allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_V4,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_V4, shared_from_this()));
+        setAllocationState(Lease::TYPE_V4, SubnetAllocationStatePtr());
+
+        for (auto pool : pools_) {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
+        }
+
     } else {
         setAllocator(Lease::TYPE_V4,
                      boost::make_shared<IterativeAllocator>
@@ -831,6 +870,11 @@ Subnet6::createAllocators() {
     if (allocator_type.empty()) {
         allocator_type = getDefaultAllocatorType();
     }
+    if ((allocator_type == "bitmap") &&
+        (!bitmapSupported(pools_, Lease::TYPE_NA, *this) ||
+         !bitmapSupported(pools_ta_, Lease::TYPE_TA, *this))) {
+        allocator_type = "iterative";
+    }
     if (allocator_type == "random") {
         setAllocator(Lease::TYPE_NA,
                      boost::make_shared<RandomAllocator>
@@ -844,6 +888,16 @@ Subnet6::createAllocators() {
     } else if (allocator_type == "flq") {
         isc_throw(BadValue, "Free Lease Queue allocator is not supported for IPv6 address pools");
 
+    } else if (allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_NA,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_NA, shared_from_this()));
+        setAllocator(Lease::TYPE_TA,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_TA, shared_from_this()));
+        setAllocationState(Lease::TYPE_NA, SubnetAllocationStatePtr());
+        setAllocationState(Lease::TYPE_TA, SubnetAllocationStatePtr());
+
     } else {
         setAllocator(Lease::TYPE_NA,
                      boost::make_shared<IterativeAllocator>
@@ -856,6 +910,10 @@ Subnet6::createAllocators() {
     if (pd_allocator_type.empty()) {
         pd_allocator_type = getDefaultPdAllocatorType();
     }
+    if ((pd_allocator_type == "bitmap") &&
+        !bitmapSupported(pools_pd_, Lease::TYPE_PD, *this)) {
+        pd_allocator_type = "iterative";
+    }
     // Repeat the same for the delegated prefix allocator.
     if (pd_allocator_type == "random") {
         setAllocator(Lease::TYPE_PD,
@@ -869,6 +927,12 @@ Subnet6::createAllocators() {
                      (Lease::TYPE_PD, shared_from_this()));
         setAllocationState(Lease::TYPE_PD, SubnetAllocationStatePtr());
 
+    } else if (pd_allocator_type == "bitmap") {
+        setAllocator(Lease::TYPE_PD,
+                     boost::make_shared<BitmapAllocator>
+                     (Lease::TYPE_PD, shared_from_this()));
+        setAllocationState(Lease::TYPE_PD, SubnetAllocationStatePtr());
+
     } else {
         setAllocator(Lease::TYPE_PD,
                      boost::make_shared<IterativeAllocator>
@@ -879,6 +943,8 @@ Subnet6::createAllocators() {
     for (auto pool : pools_) {
         if (allocator_type == "random") {
             pool->setAllocationState(PoolRandomAllocationState::create(pool));
+        } else if (allocator_type == "bitmap") {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
         } else {
             pool->setAllocationState(PoolIterativeAllocationState::create(pool));
         }
@@ -887,6 +953,8 @@ Subnet6::createAllocators() {
     for (auto pool : pools_ta_) {
         if (allocator_type == "random") {
             pool->setAllocationState(PoolRandomAllocationState::create(pool));
+        } else if (allocator_type == "bitmap") {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
         } else {
             pool->setAllocationState(PoolIterativeAllocationState::create(pool));
         }
@@ -897,6 +965,8 @@ Subnet6::createAllocators() {
             pool->setAllocationState(PoolRandomAllocationState::create(pool));
         } else if (pd_allocator_type == "flq") {
             pool->setAllocationState(PoolFreeLeaseQueueAllocationState::create(pool));
+        } else if (pd_allocator_type == "bitmap") {
+            pool->setAllocationState(PoolBitmapAllocationState::create(pool));
         } else {
             pool->setAllocationState(PoolIterativeAllocationState::create(pool));
         }
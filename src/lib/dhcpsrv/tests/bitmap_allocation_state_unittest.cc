@@ -0,0 +1,186 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/pool.h>
+#include <exceptions/exceptions.h>
+#include <boost/make_shared.hpp>
+#include <gtest/gtest.h>
+#include <set>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+// Test creating a new bitmap allocation state for an IPv4 address pool.
+TEST(PoolBitmapAllocationState, createV4) {
+    auto pool = boost::make_shared<Pool4>(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    EXPECT_EQ(10, state->getCapacity());
+    // All leases are allocated until the free ones are marked.
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_EQ(0, state->getFreeLeaseCount());
+    EXPECT_EQ("0.0.0.0", state->offerFreeLease().toText());
+
+    state->addAllFreeLeases();
+    EXPECT_FALSE(state->exhausted());
+    EXPECT_EQ(10, state->getFreeLeaseCount());
+}
+
+// Test adding and deleting free IPv4 leases.
+TEST(PoolBitmapAllocationState, addDeleteFreeLeaseV4) {
+    auto pool = boost::make_shared<Pool4>(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+
+    // Add the first free lease. It is always offered.
+    state->addFreeLease(IOAddress("192.0.2.5"));
+    EXPECT_FALSE(state->exhausted());
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+
+    // Adding it again does nothing.
+    state->addFreeLease(IOAddress("192.0.2.5"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+
+    // Addresses out of the pool are ignored.
+    state->addFreeLease(IOAddress("192.0.2.11"));
+    state->addFreeLease(IOAddress("192.0.2.0"));
+    state->addFreeLease(IOAddress("2001:db8:1::1"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+
+    // Leases are offered in the ascending order from the last offered one.
+    state->addFreeLease(IOAddress("192.0.2.1"));
+    state->addFreeLease(IOAddress("192.0.2.10"));
+    EXPECT_EQ(3, state->getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.10", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.1", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.5", state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.10", state->offerFreeLease().toText());
+
+    // Delete the leases.
+    state->deleteFreeLease(IOAddress("192.0.2.10"));
+    EXPECT_EQ(2, state->getFreeLeaseCount());
+    EXPECT_EQ("192.0.2.1", state->offerFreeLease().toText());
+    state->deleteFreeLease(IOAddress("192.0.2.1"));
+    state->deleteFreeLease(IOAddress("192.0.2.1"));
+    EXPECT_EQ(1, state->getFreeLeaseCount());
+    state->deleteFreeLease(IOAddress("192.0.2.5"));
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_EQ("0.0.0.0", state->offerFreeLease().toText());
+}
+
+// Test that all the leases of a large pool are offered once.
+TEST(PoolBitmapAllocationState, largePoolV4) {
+    // 100000 leases use three levels.
+    auto pool = boost::make_shared<Pool4>(IOAddress("10.0.0.0"), IOAddress("10.1.134.159"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    ASSERT_EQ(100000, state->getCapacity());
+    state->addAllFreeLeases();
+
+    // Allocate all leases but a few ones far from each other.
+    std::set<uint32_t> free_leases = { 0x0a000000, 0x0a000041, 0x0a001000,
+                                       0x0a01869f };
+    for (uint32_t address = 0x0a000000; address <= 0x0a01869f; ++address) {
+        if (free_leases.count(address) == 0) {
+            state->deleteFreeLease(IOAddress(address));
+        }
+    }
+    ASSERT_EQ(free_leases.size(), state->getFreeLeaseCount());
+    for (auto address : free_leases) {
+        EXPECT_EQ(IOAddress(address), state->offerFreeLease());
+    }
+    // Wrap around.
+    EXPECT_EQ("10.0.0.0", state->offerFreeLease().toText());
+
+    // Free a lease in the middle.
+    state->addFreeLease(IOAddress("10.0.200.1"));
+    EXPECT_EQ("10.0.0.65", state->offerFreeLease().toText());
+    EXPECT_EQ("10.0.16.0", state->offerFreeLease().toText());
+    EXPECT_EQ("10.0.200.1", state->offerFreeLease().toText());
+    EXPECT_EQ("10.1.134.159", state->offerFreeLease().toText());
+}
+
+// Test that too large pools are rejected.
+TEST(PoolBitmapAllocationState, tooLarge) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"), 64);
+    EXPECT_FALSE(PoolBitmapAllocationState::isSupported(pool));
+    EXPECT_THROW(PoolBitmapAllocationState::create(pool), BadValue);
+    pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"), 103);
+    EXPECT_FALSE(PoolBitmapAllocationState::isSupported(pool));
+    EXPECT_THROW(PoolBitmapAllocationState::create(pool), BadValue);
+    pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::"), 104);
+    EXPECT_TRUE(PoolBitmapAllocationState::isSupported(pool));
+    EXPECT_NO_THROW(PoolBitmapAllocationState::create(pool));
+    pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 32, 57);
+    EXPECT_FALSE(PoolBitmapAllocationState::isSupported(pool));
+    pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 32, 56);
+    EXPECT_TRUE(PoolBitmapAllocationState::isSupported(pool));
+}
+
+// Test adding and deleting free IPv6 leases.
+TEST(PoolBitmapAllocationState, addDeleteFreeLeaseNA) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1::1"),
+                                          IOAddress("2001:db8:1::100"));
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    EXPECT_EQ(256, state->getCapacity());
+    EXPECT_TRUE(state->exhausted());
+    EXPECT_EQ("::", state->offerFreeLease().toText());
+
+    state->addFreeLease(IOAddress("2001:db8:1::100"));
+    state->addFreeLease(IOAddress("2001:db8:1::41"));
+    state->addFreeLease(IOAddress("2001:db8:1::101"));
+    state->addFreeLease(IOAddress("192.0.2.1"));
+    EXPECT_EQ(2, state->getFreeLeaseCount());
+    EXPECT_EQ("2001:db8:1::41", state->offerFreeLease().toText());
+    EXPECT_EQ("2001:db8:1::100", state->offerFreeLease().toText());
+    EXPECT_EQ("2001:db8:1::41", state->offerFreeLease().toText());
+
+    state->deleteFreeLease(IOAddress("2001:db8:1::41"));
+    EXPECT_EQ("2001:db8:1::100", state->offerFreeLease().toText());
+    state->deleteFreeLease(IOAddress("2001:db8:1::100"));
+    EXPECT_TRUE(state->exhausted());
+}
+
+// Test adding and deleting free delegated prefixes.
+TEST(PoolBitmapAllocationState, addDeleteFreeLeasePD) {
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 48, 64);
+    auto state = PoolBitmapAllocationState::create(pool);
+    ASSERT_TRUE(state);
+    EXPECT_EQ(65536, state->getCapacity());
+
+    state->addAllFreeLeases();
+    EXPECT_EQ(65536, state->getFreeLeaseCount());
+    EXPECT_EQ("3000::", state->offerFreeLease().toText());
+    EXPECT_EQ("3000:0:0:1::", state->offerFreeLease().toText());
+
+    state->deleteFreeLease(IOAddress("3000:0:0:2::"));
+    state->deleteFreeLease(IOAddress("3000:0:0:3::"));
+    EXPECT_EQ(65534, state->getFreeLeaseCount());
+    EXPECT_EQ("3000:0:0:4::", state->offerFreeLease().toText());
+
+    state->addFreeLease(IOAddress("3000:0:0:3::"));
+    EXPECT_EQ(65535, state->getFreeLeaseCount());
+
+    // The last prefix of the pool.
+    state->deleteFreeLease(IOAddress("3000:0:0:ffff::"));
+    EXPECT_EQ(65534, state->getFreeLeaseCount());
+    state->addFreeLease(IOAddress("3000:0:0:ffff::"));
+    // Prefixes out of the pool are ignored.
+    state->addFreeLease(IOAddress("3000:0:1::"));
+    EXPECT_EQ(65535, state->getFreeLeaseCount());
+}
+
+} // end of anonymous namespace
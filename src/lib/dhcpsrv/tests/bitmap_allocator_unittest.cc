@@ -0,0 +1,370 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/tests/alloc_engine_utils.h>
+#include <boost/make_shared.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc::asiolink;
+using namespace std;
+
+namespace isc {
+namespace dhcp {
+namespace test {
+
+/// @brief Test fixture class for the DHCPv4 bitmap allocator.
+class BitmapAllocatorTest4 : public AllocEngine4Test {
+public:
+
+    /// @brief Creates a DHCPv4 lease for an address and MAC address.
+    ///
+    /// @param address Lease address.
+    /// @param hw_address_seed a seed from which the hardware address is generated.
+    /// @return Created lease pointer.
+    Lease4Ptr
+    createLease4(const IOAddress& address, uint64_t hw_address_seed) const {
+        vector<uint8_t> hw_address_vec(sizeof(hw_address_seed));
+        for (size_t i = 0; i < sizeof(hw_address_seed); ++i) {
+            hw_address_vec[i] = (hw_address_seed >> i) & 0xFF;
+        }
+        auto hw_address = boost::make_shared<HWAddr>(hw_address_vec, HTYPE_ETHER);
+        auto lease = boost::make_shared<Lease4>(address, hw_address, ClientIdPtr(),
+                                                3600, time(0), subnet_->getID());
+        return (lease);
+    }
+};
+
+// Test that the allocator returns the correct type.
+TEST_F(BitmapAllocatorTest4, getType) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+    EXPECT_EQ("bitmap", alloc.getType());
+}
+
+// Test marking free DHCPv4 leases in the bitmap.
+TEST_F(BitmapAllocatorTest4, populateFreeLeases) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.100"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.102"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.104"), 2))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.106"), 3))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease4(IOAddress("192.0.2.108"), 4))));
+    // An expired lease is free.
+    auto lease = createLease4(IOAddress("192.0.2.101"), 5);
+    lease->cltt_ = time(0) - 7200;
+    lease->current_cltt_ = lease->cltt_;
+    EXPECT_TRUE(lease_mgr.addLease(lease));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool_->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_FALSE(pool_state->exhausted());
+    EXPECT_EQ(5, pool_state->getFreeLeaseCount());
+
+    // Free leases are offered in the ascending order.
+    EXPECT_EQ("192.0.2.101", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.103", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.105", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.107", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.109", pool_state->offerFreeLease().toText());
+    EXPECT_EQ("192.0.2.101", pool_state->offerFreeLease().toText());
+}
+
+// Test allocating IPv4 addresses when a subnet has a single pool.
+TEST_F(BitmapAllocatorTest4, singlePool) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 1000; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        addresses.insert(candidate);
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+    }
+    // The pool comprises 10 addresses. All should be returned.
+    EXPECT_EQ(10, addresses.size());
+}
+
+// Test allocating IPv4 addresses and re-allocating these that are
+// deleted (released).
+TEST_F(BitmapAllocatorTest4, singlePoolWithAllocations) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::map<IOAddress, Lease4Ptr> leases;
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        auto lease = createLease4(candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    // The pool comprises 10 addresses. All should be returned.
+    EXPECT_EQ(10, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    auto i = 0;
+    for (auto address_lease : leases) {
+        if (i % 2) {
+            EXPECT_TRUE(lease_mgr.deleteLease(address_lease.second));
+        }
+        ++i;
+    }
+
+    for (auto i = 0; i < 5; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+        auto lease = createLease4(candidate, i);
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test allocating IPv4 addresses and re-allocating these that are
+// reclaimed.
+TEST_F(BitmapAllocatorTest4, singlePoolWithReclamations) {
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    std::map<IOAddress, Lease4Ptr> leases;
+    for (auto i = 0; i < 10; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        auto lease = createLease4(candidate, i);
+        leases[candidate] = lease;
+        EXPECT_TRUE(lease_mgr.addLease(lease));
+    }
+    EXPECT_EQ(10, leases.size());
+
+    IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+
+    auto i = 0;
+    for (auto address_lease : leases) {
+        if (i % 2) {
+            auto lease = address_lease.second;
+            lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+            EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+        }
+        ++i;
+    }
+    for (auto i = 0; i < 5; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        auto lease = lease_mgr.getLease4(candidate);
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(lease->stateExpiredReclaimed());
+        lease->state_ = Lease::STATE_DEFAULT;
+        EXPECT_NO_THROW(lease_mgr.updateLease4(lease));
+    }
+
+    candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+    EXPECT_TRUE(candidate.isV4Zero());
+}
+
+// Test allocating DHCPv4 leases from a large pool.
+TEST_F(BitmapAllocatorTest4, largePool) {
+    subnet_ = Subnet4::create(IOAddress("10.0.0.0"), 8, 1, 2, 3, SubnetID(10));
+    // A /10 pool takes 512kB.
+    auto pool = boost::make_shared<Pool4>(IOAddress("10.64.0.0"), 10);
+    subnet_->addPool(pool);
+
+    BitmapAllocator alloc(Lease::TYPE_V4, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_EQ(1 << 22, pool_state->getFreeLeaseCount());
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 100; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, clientid_, IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        addresses.insert(candidate);
+        EXPECT_TRUE(lease_mgr.addLease(createLease4(candidate, i)));
+    }
+    EXPECT_EQ(100, addresses.size());
+    EXPECT_EQ((1 << 22) - 100, pool_state->getFreeLeaseCount());
+}
+
+/// @brief Test fixture class for the DHCPv6 bitmap allocator.
+class BitmapAllocatorTest6 : public AllocEngine6Test {
+public:
+
+    /// @brief Creates a DHCPv6 lease for an address and DUID.
+    ///
+    /// @param type lease type.
+    /// @param address Lease address.
+    /// @param duid_seed a seed from which the DUID is generated.
+    /// @return Created lease pointer.
+    Lease6Ptr
+    createLease6(Lease::Type type, const IOAddress& address, uint64_t duid_seed) const {
+        vector<uint8_t> duid_vec(sizeof(duid_seed));
+        for (size_t i = 0; i < sizeof(duid_seed); ++i) {
+            duid_vec[i] = (duid_seed >> i) & 0xFF;
+        }
+        auto duid = boost::make_shared<DUID>(duid_vec);
+        auto lease = boost::make_shared<Lease6>(type, address, duid, 1, 1800,
+                                                3600, subnet_->getID());
+        return (lease);
+    }
+
+};
+
+// Test that the allocator returns the correct type.
+TEST_F(BitmapAllocatorTest6, getType) {
+    BitmapAllocator allocNA(Lease::TYPE_NA, subnet_);
+    EXPECT_EQ("bitmap", allocNA.getType());
+
+    BitmapAllocator allocPD(Lease::TYPE_PD, subnet_);
+    EXPECT_EQ("bitmap", allocPD.getType());
+}
+
+// Test marking free DHCPv6 address leases in the bitmap.
+TEST_F(BitmapAllocatorTest6, populateFreeAddressLeases) {
+    BitmapAllocator alloc(Lease::TYPE_NA, subnet_);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::10"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::12"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::14"), 2))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::16"), 3))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_NA, IOAddress("2001:db8:1::18"), 4))));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool_->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_FALSE(pool_state->exhausted());
+    EXPECT_EQ(12, pool_state->getFreeLeaseCount());
+
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 12; ++i) {
+        auto lease = pool_state->offerFreeLease();
+        ASSERT_FALSE(lease.isV6Zero());
+        addresses.insert(lease);
+    }
+    ASSERT_EQ(12, addresses.size());
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:1::10")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:1::12")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:1::14")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:1::16")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:1::18")));
+}
+
+// Test allocating IPv6 addresses when a subnet has a single pool.
+TEST_F(BitmapAllocatorTest6, singlePool) {
+    BitmapAllocator alloc(Lease::TYPE_NA, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+
+    // Remember returned addresses, so we can verify that unique addresses
+    // are returned.
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 1000; ++i) {
+        IOAddress candidate = alloc.pickAddress(cc_, duid_, IOAddress("::"));
+        EXPECT_FALSE(candidate.isV6Zero());
+        addresses.insert(candidate);
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_NA, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_NA, candidate, cc_));
+    }
+    // The pool comprises 17 addresses. All should be returned.
+    EXPECT_EQ(17, addresses.size());
+}
+
+// Test marking free delegated prefixes in the bitmap.
+TEST_F(BitmapAllocatorTest6, populateFreePrefixDelegationLeases) {
+    subnet_->delPools(Lease::TYPE_PD);
+
+    BitmapAllocator alloc(Lease::TYPE_PD, subnet_);
+
+    auto pool = Pool6::create(Lease::TYPE_PD, IOAddress("2001:db8:2::"), 112, 120);
+    subnet_->addPool(pool);
+
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::"), 0))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::1000"), 1))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::2000"), 2))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::3000"), 3))));
+    EXPECT_TRUE(lease_mgr.addLease((createLease6(Lease::TYPE_PD, IOAddress("2001:db8:2::4000"), 4))));
+
+    EXPECT_NO_THROW(alloc.initAfterConfigure());
+
+    auto pool_state = boost::dynamic_pointer_cast<PoolBitmapAllocationState>(pool->getAllocationState());
+    ASSERT_TRUE(pool_state);
+    EXPECT_FALSE(pool_state->exhausted());
+    EXPECT_EQ(251, pool_state->getFreeLeaseCount());
+
+    std::set<IOAddress> addresses;
+    for (auto i = 0; i < 256; ++i) {
+        auto lease = pool_state->offerFreeLease();
+        ASSERT_FALSE(lease.isV6Zero());
+        addresses.insert(lease);
+    }
+    ASSERT_EQ(251, addresses.size());
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:2::")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:2::1000")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:2::2000")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:2::3000")));
+    EXPECT_EQ(0, addresses.count(IOAddress("2001:db8:2::4000")));
+}
+
+// Test allocating delegated prefixes when a subnet has a single pool.
+TEST_F(BitmapAllocatorTest6, singlePdPool) {
+    BitmapAllocator alloc(Lease::TYPE_PD, subnet_);
+    ASSERT_NO_THROW(alloc.initAfterConfigure());
+    auto& lease_mgr = LeaseMgrFactory::instance();
+
+    Pool6Ptr pool;
+
+    // Remember returned prefixes, so we can verify that unique addresses
+    // are returned.
+    std::set<IOAddress> prefixes;
+    for (auto i = 0; i < 65536; ++i) {
+        IOAddress candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 0);
+        EXPECT_EQ(pd_pool_, pool);
+        EXPECT_TRUE(lease_mgr.addLease(createLease6(Lease::TYPE_PD, candidate, i)));
+        prefixes.insert(candidate);
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_PD, candidate));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_PD, candidate, cc_));
+    }
+    // The pool comprises 65536 prefixes. All should be returned.
+    EXPECT_EQ(65536, prefixes.size());
+
+    // The pool is exhausted.
+    IOAddress candidate = alloc.pickPrefix(cc_, pool, duid_, Allocator::PREFIX_LEN_HIGHER, IOAddress("::"), 0);
+    EXPECT_TRUE(candidate.isV6Zero());
+}
+
+} // end of isc::dhcp::test namespace
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -12,6 +12,8 @@
 #include <dhcpsrv/host_mgr.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/mem_host_cache.h>
+#include <dhcpsrv/testutils/memory_host_data_source.h>
 #include <testutils/test_to_element.h>
 #include <gtest/gtest.h>
 
@@ -25,6 +27,7 @@
 
 using namespace isc;
 using namespace isc::dhcp;
+using namespace isc::dhcp::test;
 using namespace isc::test;
 
 namespace {
@@ -143,6 +146,46 @@ TEST(CfgDbAccessTest, createLeaseMgr) {
     });
 }
 
+// Tests that the built-in host cache is created in front of the host
+// databases when enabled.
+TEST(CfgDbAccessTest, createManagersHostCache) {
+    CfgDbAccess cfg;
+    EXPECT_EQ(0, cfg.getHostCacheMaxEntries());
+    EXPECT_EQ(MemHostCache::DEFAULT_TTL, cfg.getHostCacheTtl());
+    ASSERT_TRUE(HostDataSourceFactory::registerFactory("mem", memFactory));
+    ASSERT_NO_THROW(cfg.setLeaseDbAccessString("type=memfile persist=false universe=4"));
+
+    // Without host databases there is no cache.
+    cfg.setHostCacheMaxEntries(1000);
+    cfg.setHostCacheTtl(10);
+    ASSERT_NO_THROW(cfg.createManagers());
+    EXPECT_FALSE(HostMgr::checkCacheBackend());
+
+    // Disabled.
+    ASSERT_NO_THROW(cfg.setHostDbAccessString("type=mem"));
+    cfg.setHostCacheMaxEntries(0);
+    ASSERT_NO_THROW(cfg.createManagers());
+    EXPECT_FALSE(HostMgr::checkCacheBackend());
+    EXPECT_FALSE(HostMgr::instance().getNegativeCaching());
+
+    // Enabled.
+    cfg.setHostCacheMaxEntries(1000);
+    ASSERT_NO_THROW(cfg.createManagers());
+    EXPECT_TRUE(HostMgr::checkCacheBackend());
+    EXPECT_TRUE(HostMgr::instance().getNegativeCaching());
+    HostDataSourceList& sources = HostMgr::instance().getHostDataSourceList();
+    ASSERT_EQ(2, sources.size());
+    EXPECT_EQ("memory-cache", sources[0]->getType());
+    EXPECT_EQ("mem", sources[1]->getType());
+    auto cache = boost::dynamic_pointer_cast<MemHostCache>(sources[0]);
+    ASSERT_TRUE(cache);
+    EXPECT_EQ(1000, cache->capacity());
+    EXPECT_EQ(10, cache->getTtl());
+
+    HostMgr::create();
+    HostDataSourceFactory::deregisterFactory("mem");
+}
+
 // The following tests require MySQL enabled.
 #if defined HAVE_MYSQL
 
@@ -543,6 +543,71 @@ TEST_F(CfgHostsTest, get4) {
     }
 }
 
+// This test checks that the reservations of any of the identifiers of a
+// host can be retrieved with a single lookup.
+TEST_F(CfgHostsTest, getAllbyIdentifiers) {
+    CfgHosts cfg;
+    // Add hosts identified by HW address to the first subnets and hosts
+    // identified by DUID to the second subnets.
+    for (unsigned i = 0; i < 25; ++i) {
+        cfg.add(HostPtr(new Host(hwaddrs_[i]->toText(false), "hw-address",
+                                 SubnetID(1), SubnetID(11),
+                                 increase(IOAddress("192.0.2.5"), i))));
+        cfg.add(HostPtr(new Host(duids_[i]->toText(), "duid",
+                                 SubnetID(2), SubnetID(12),
+                                 increase(IOAddress("192.0.2.100"), i))));
+    }
+
+    for (unsigned i = 0; i < 25; ++i) {
+        HostIdentifierList identifiers;
+        identifiers.push_back(std::make_pair(Host::IDENT_DUID,
+                                             duids_[i]->getDuid()));
+        identifiers.push_back(std::make_pair(Host::IDENT_HWADDR,
+                                             hwaddrs_[i]->hwaddr_));
+
+        ConstHostCollection hosts = cfg.getAllbyIdentifiers4(SubnetID(1),
+                                                             identifiers);
+        ASSERT_EQ(1, hosts.size());
+        EXPECT_EQ(Host::IDENT_HWADDR, hosts[0]->getIdentifierType());
+        EXPECT_EQ(increase(IOAddress("192.0.2.5"), i),
+                  hosts[0]->getIPv4Reservation());
+
+        hosts = cfg.getAllbyIdentifiers4(SubnetID(2), identifiers);
+        ASSERT_EQ(1, hosts.size());
+        EXPECT_EQ(Host::IDENT_DUID, hosts[0]->getIdentifierType());
+
+        hosts = cfg.getAllbyIdentifiers6(SubnetID(11), identifiers);
+        ASSERT_EQ(1, hosts.size());
+        EXPECT_EQ(Host::IDENT_HWADDR, hosts[0]->getIdentifierType());
+
+        hosts = cfg.getAllbyIdentifiers6(SubnetID(12), identifiers);
+        ASSERT_EQ(1, hosts.size());
+        EXPECT_EQ(Host::IDENT_DUID, hosts[0]->getIdentifierType());
+
+        // Nothing in other subnets.
+        EXPECT_TRUE(cfg.getAllbyIdentifiers4(SubnetID(3), identifiers).empty());
+        EXPECT_TRUE(cfg.getAllbyIdentifiers6(SubnetID(1), identifiers).empty());
+    }
+
+    // Both identifiers of a host have a reservation in the same subnet.
+    cfg.add(HostPtr(new Host(duids_[30]->toText(), "duid",
+                             SubnetID(1), SUBNET_ID_UNUSED,
+                             IOAddress("192.0.2.200"))));
+    cfg.add(HostPtr(new Host(hwaddrs_[30]->toText(false), "hw-address",
+                             SubnetID(1), SUBNET_ID_UNUSED,
+                             IOAddress("192.0.2.201"))));
+    HostIdentifierList identifiers;
+    identifiers.push_back(std::make_pair(Host::IDENT_HWADDR,
+                                         hwaddrs_[30]->hwaddr_));
+    identifiers.push_back(std::make_pair(Host::IDENT_DUID,
+                                         duids_[30]->getDuid()));
+    EXPECT_EQ(2, cfg.getAllbyIdentifiers4(SubnetID(1), identifiers).size());
+
+    // An empty list finds nothing.
+    EXPECT_TRUE(cfg.getAllbyIdentifiers4(SubnetID(1),
+                                         HostIdentifierList()).empty());
+}
+
 // This test checks that the DHCPv4 reservations can be unparsed
 TEST_F(CfgHostsTest, unparsed4) {
     CfgMgr::instance().setFamily(AF_INET);
@@ -112,6 +112,25 @@ TEST_F(CfgMultiThreadingTest, apply) {
     EXPECT_EQ(MultiThreadingMgr::instance().getThreadPoolSize(), 4);
     EXPECT_EQ(MultiThreadingMgr::instance().getPacketQueueSize(), 64);
     EXPECT_EQ(MultiThreadingMgr::instance().getThreadPool().getMaxQueueSize(), 64);
+    EXPECT_FALSE(MultiThreadingMgr::instance().getClientAffinity());
+}
+
+/// @brief Verifies that applying the client affinity setting works
+TEST_F(CfgMultiThreadingTest, applyClientAffinity) {
+    EXPECT_FALSE(MultiThreadingMgr::instance().getClientAffinity());
+    std::string content_json =
+        "{"
+        "    \"enable-multi-threading\": true,\n"
+        "    \"thread-pool-size\": 4,\n"
+        "    \"client-affinity\": true\n"
+        "}";
+    ConstElementPtr param;
+    ASSERT_NO_THROW(param = Element::fromJSON(content_json))
+                            << "invalid context_json, test is broken";
+    CfgMultiThreading::apply(param);
+    EXPECT_TRUE(MultiThreadingMgr::instance().getMode());
+    EXPECT_EQ(MultiThreadingMgr::instance().getThreadPoolSize(), 4);
+    EXPECT_TRUE(MultiThreadingMgr::instance().getClientAffinity());
 }
 
 }  // namespace
@@ -3287,7 +3287,7 @@ TEST_F(ParseConfigTest, invalidSubnetAllocator4) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
@@ -3371,7 +3371,7 @@ TEST_F(ParseConfigTest, invalidSubnetAllocator6) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
@@ -3469,7 +3469,7 @@ TEST_F(ParseConfigTest, invalidSubnetPdAllocator6) {
     ASSERT_EQ(comment->getType(), Element::string);
     EXPECT_EQ(1, rcode);
     std::string expected = "Configuration parsing failed: ";
-    expected += "supported allocators are: iterative, random and flq";
+    expected += "supported allocators are: iterative, random, flq and bitmap";
     EXPECT_EQ(expected, comment->stringValue());
 }
 
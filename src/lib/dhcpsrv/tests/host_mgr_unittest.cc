@@ -153,6 +153,74 @@ TEST_F(HostMgrTest, get6ByPrefix) {
     testGet6ByPrefix(*getCfgHosts(), *getCfgHosts());
 }
 
+// This test verifies that HostMgr returns the reservation of the first
+// identifier of a list which has one for DHCPv4.
+TEST_F(HostMgrTest, get4ByIdentifiers) {
+    HostIdentifierList identifiers;
+    identifiers.push_back(std::make_pair(Host::IDENT_DUID,
+                                         duids_[0]->getDuid()));
+    identifiers.push_back(std::make_pair(Host::IDENT_HWADDR,
+                                         hwaddrs_[0]->hwaddr_));
+
+    // Initially, no host should be present.
+    EXPECT_FALSE(HostMgr::instance().get4(SubnetID(1), identifiers));
+
+    // Add a host identified by the HW address.
+    getCfgHosts()->add(HostPtr(new Host(hwaddrs_[0]->toText(false),
+                                        "hw-address", SubnetID(1),
+                                        SUBNET_ID_UNUSED,
+                                        IOAddress("192.0.2.5"))));
+    CfgMgr::instance().commit();
+
+    ConstHostPtr host = HostMgr::instance().get4(SubnetID(1), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_EQ(Host::IDENT_HWADDR, host->getIdentifierType());
+    EXPECT_EQ("192.0.2.5", host->getIPv4Reservation().toText());
+
+    // Add a host identified by the DUID: it takes precedence.
+    getCfgHosts()->add(HostPtr(new Host(duids_[0]->toText(), "duid",
+                                        SubnetID(1), SUBNET_ID_UNUSED,
+                                        IOAddress("192.0.2.6"))));
+    host = HostMgr::instance().get4(SubnetID(1), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_EQ(Host::IDENT_DUID, host->getIdentifierType());
+    EXPECT_EQ("192.0.2.6", host->getIPv4Reservation().toText());
+
+    // Other subnets have no reservation.
+    EXPECT_FALSE(HostMgr::instance().get4(SubnetID(2), identifiers));
+}
+
+// This test verifies that HostMgr returns the reservation of the first
+// identifier of a list which has one for DHCPv6.
+TEST_F(HostMgrTest, get6ByIdentifiers) {
+    HostIdentifierList identifiers;
+    identifiers.push_back(std::make_pair(Host::IDENT_DUID,
+                                         duids_[0]->getDuid()));
+    identifiers.push_back(std::make_pair(Host::IDENT_HWADDR,
+                                         hwaddrs_[0]->hwaddr_));
+
+    // Initially, no host should be present.
+    EXPECT_FALSE(HostMgr::instance().get6(SubnetID(2), identifiers));
+
+    // Add a host identified by the HW address.
+    HostPtr new_host(new Host(hwaddrs_[0]->toText(false), "hw-address",
+                              SUBNET_ID_UNUSED, SubnetID(2),
+                              IOAddress::IPV4_ZERO_ADDRESS()));
+    new_host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                       IOAddress("2001:db8:1::1")));
+    getCfgHosts()->add(new_host);
+    CfgMgr::instance().commit();
+
+    ConstHostPtr host = HostMgr::instance().get6(SubnetID(2), identifiers);
+    ASSERT_TRUE(host);
+    EXPECT_EQ(Host::IDENT_HWADDR, host->getIdentifierType());
+    EXPECT_TRUE(host->hasReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                               IOAddress("2001:db8:1::1"))));
+
+    // Other subnets have no reservation.
+    EXPECT_FALSE(HostMgr::instance().get6(SubnetID(1), identifiers));
+}
+
 // This test verifies that without a host data source an exception is thrown.
 TEST_F(HostMgrTest, noDataSource) {
     // Remove all configuration.
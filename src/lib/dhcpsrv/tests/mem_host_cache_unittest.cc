@@ -0,0 +1,251 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/mem_host_cache.h>
+#include <exceptions/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::db;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Creates a host identified by a HW address.
+///
+/// @param hwaddr The HW address in textual format.
+/// @param subnet_id4 The IPv4 subnet identifier.
+/// @param subnet_id6 The IPv6 subnet identifier.
+/// @return The host.
+HostPtr
+createHost(const string& hwaddr, SubnetID subnet_id4, SubnetID subnet_id6) {
+    return (HostPtr(new Host(hwaddr, "hw-address", subnet_id4, subnet_id6,
+                             IOAddress::IPV4_ZERO_ADDRESS())));
+}
+
+/// @brief Looks up a host by IPv4 subnet and identifier.
+ConstHostPtr
+get4(const MemHostCache& cache, SubnetID subnet_id, const HostPtr& host) {
+    const vector<uint8_t>& id = host->getIdentifier();
+    return (cache.get4(subnet_id, host->getIdentifierType(), &id[0], id.size()));
+}
+
+/// @brief Looks up a host by IPv6 subnet and identifier.
+ConstHostPtr
+get6(const MemHostCache& cache, SubnetID subnet_id, const HostPtr& host) {
+    const vector<uint8_t>& id = host->getIdentifier();
+    return (cache.get6(subnet_id, host->getIdentifierType(), &id[0], id.size()));
+}
+
+// Verifies the constructors and their parameters.
+TEST(MemHostCacheTest, constructor) {
+    MemHostCache cache;
+    EXPECT_EQ("memory-cache", cache.getType());
+    EXPECT_EQ(MemHostCache::DEFAULT_MAX_ENTRIES, cache.capacity());
+    EXPECT_EQ(MemHostCache::DEFAULT_TTL, cache.getTtl());
+    EXPECT_EQ(0, cache.size());
+
+    DatabaseConnection::ParameterMap params;
+    params["type"] = "memory-cache";
+    params["max-entries"] = "100";
+    params["ttl"] = "0";
+    MemHostCache cache2(params);
+    EXPECT_EQ(100, cache2.capacity());
+    EXPECT_EQ(0, cache2.getTtl());
+
+    EXPECT_THROW(MemHostCache(0), BadValue);
+    params["max-entries"] = "0";
+    EXPECT_THROW(MemHostCache cache3(params), BadValue);
+    params["max-entries"] = "foo";
+    EXPECT_THROW(MemHostCache cache3(params), BadValue);
+    params["max-entries"] = "100";
+    params["ttl"] = "bar";
+    EXPECT_THROW(MemHostCache cache3(params), BadValue);
+}
+
+// Verifies that hosts are cached by subnet and identifier.
+TEST(MemHostCacheTest, insertGet) {
+    MemHostCache cache(100, 0);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, 2);
+    HostPtr other = createHost("01:02:03:04:05:07", 1, 2);
+
+    EXPECT_EQ(0, cache.insert(host, false));
+    // One entry per subnet.
+    EXPECT_EQ(2, cache.size());
+
+    EXPECT_EQ(host, get4(cache, 1, host));
+    EXPECT_EQ(host, get6(cache, 2, host));
+    EXPECT_FALSE(get4(cache, 2, host));
+    EXPECT_FALSE(get6(cache, 1, host));
+    EXPECT_FALSE(get4(cache, 1, other));
+    EXPECT_EQ(2, cache.getHits());
+    EXPECT_EQ(3, cache.getMisses());
+
+    // Other lookups are not served by the cache.
+    const vector<uint8_t>& id = host->getIdentifier();
+    EXPECT_TRUE(cache.getAll(host->getIdentifierType(), &id[0], id.size()).empty());
+    EXPECT_TRUE(cache.getAll4(SubnetID(1)).empty());
+
+    // Inserting again is a conflict.
+    HostPtr copy(new Host(*host));
+    EXPECT_EQ(1, cache.insert(copy, false));
+    EXPECT_EQ(host, get4(cache, 1, host));
+    EXPECT_EQ(2, cache.insert(copy, true));
+    EXPECT_EQ(copy, get4(cache, 1, host));
+    EXPECT_EQ(2, cache.size());
+}
+
+// Verifies that negative entries are cached.
+TEST(MemHostCacheTest, negative) {
+    MemHostCache cache(100, 0);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, SUBNET_ID_UNUSED);
+    host->setNegative(true);
+    EXPECT_EQ(0, cache.insert(host, false));
+    EXPECT_EQ(1, cache.size());
+    ConstHostPtr got = get4(cache, 1, host);
+    ASSERT_TRUE(got);
+    EXPECT_TRUE(got->getNegative());
+}
+
+// Verifies that entries expire.
+TEST(MemHostCacheTest, ttl) {
+    MemHostCache cache(100, 1);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, SUBNET_ID_UNUSED);
+    EXPECT_EQ(0, cache.insert(host, false));
+    EXPECT_TRUE(get4(cache, 1, host));
+    this_thread::sleep_for(chrono::milliseconds(1100));
+    EXPECT_FALSE(get4(cache, 1, host));
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies that the cache is bounded.
+TEST(MemHostCacheTest, bounded) {
+    MemHostCache cache(32, 0);
+    for (unsigned i = 0; i < 256; ++i) {
+        ostringstream s;
+        s << "01:02:03:04:" << hex << (i >> 8) << ":" << (i & 0xff);
+        cache.insert(createHost(s.str(), 1, SUBNET_ID_UNUSED), false);
+        EXPECT_GE(cache.capacity(), cache.size());
+    }
+    EXPECT_LT(0, cache.size());
+}
+
+// Verifies that the least recently used entries are evicted.
+TEST(MemHostCacheTest, lru) {
+    // One entry per shard.
+    MemHostCache cache(MemHostCache::SHARDS, 0);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, SUBNET_ID_UNUSED);
+    HostPtr other = createHost("01:02:03:04:05:06", 2, SUBNET_ID_UNUSED);
+    cache.insert(host, false);
+    cache.insert(other, false);
+    // When both entries are in the same shard only the last remains.
+    if (cache.size() == 1) {
+        EXPECT_FALSE(get4(cache, 1, host));
+        EXPECT_TRUE(get4(cache, 2, other));
+    } else {
+        EXPECT_TRUE(get4(cache, 1, host));
+        EXPECT_TRUE(get4(cache, 2, other));
+    }
+}
+
+// Verifies that deletions remove entries but report nothing was deleted.
+TEST(MemHostCacheTest, del) {
+    MemHostCache cache(100, 0);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, 2);
+    cache.insert(host, false);
+    const vector<uint8_t>& id = host->getIdentifier();
+
+    EXPECT_FALSE(cache.del4(1, host->getIdentifierType(), &id[0], id.size()));
+    EXPECT_FALSE(get4(cache, 1, host));
+    EXPECT_TRUE(get6(cache, 2, host));
+
+    EXPECT_FALSE(cache.del6(2, host->getIdentifierType(), &id[0], id.size()));
+    EXPECT_FALSE(get6(cache, 2, host));
+    EXPECT_EQ(0, cache.size());
+
+    // By address.
+    HostPtr host4(new Host("01:02:03:04:05:07", "hw-address", 1,
+                           SUBNET_ID_UNUSED, IOAddress("192.0.2.1")));
+    cache.insert(host4, false);
+    EXPECT_FALSE(cache.del(1, IOAddress("192.0.2.2")));
+    EXPECT_EQ(1, cache.size());
+    EXPECT_FALSE(cache.del(1, IOAddress("192.0.2.1")));
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies that updates invalidate all the entries of the identifier.
+TEST(MemHostCacheTest, update) {
+    MemHostCache cache(100, 0);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, 2);
+    HostPtr other = createHost("01:02:03:04:05:07", 1, 2);
+    cache.insert(host, false);
+    cache.insert(other, false);
+    EXPECT_EQ(4, cache.size());
+
+    HostPtr updated = createHost("01:02:03:04:05:06", 3, 4);
+    cache.update(updated);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_FALSE(get4(cache, 1, host));
+    EXPECT_TRUE(get4(cache, 1, other));
+}
+
+// Verifies remove and flush.
+TEST(MemHostCacheTest, removeFlush) {
+    MemHostCache cache(100, 0);
+    HostPtr host = createHost("01:02:03:04:05:06", 1, 2);
+    cache.insert(host, false);
+    EXPECT_TRUE(cache.remove(host));
+    EXPECT_FALSE(cache.remove(host));
+    EXPECT_EQ(0, cache.size());
+
+    for (unsigned i = 0; i < 10; ++i) {
+        ostringstream s;
+        s << "01:02:03:04:05:" << hex << i;
+        cache.insert(createHost(s.str(), 1, SUBNET_ID_UNUSED), false);
+    }
+    EXPECT_EQ(10, cache.size());
+    cache.flush(4);
+    EXPECT_EQ(6, cache.size());
+    cache.flush(0);
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies concurrent accesses.
+TEST(MemHostCacheTest, concurrent) {
+    MemHostCache cache(1000, 0);
+    vector<HostPtr> hosts;
+    for (unsigned i = 0; i < 100; ++i) {
+        ostringstream s;
+        s << "01:02:03:04:05:" << hex << i;
+        hosts.push_back(createHost(s.str(), 1, SUBNET_ID_UNUSED));
+    }
+    vector<thread> threads;
+    for (unsigned t = 0; t < 4; ++t) {
+        threads.push_back(thread([&cache, &hosts]() {
+            for (auto const& host : hosts) {
+                cache.insert(host, false);
+                EXPECT_EQ(host, get4(cache, 1, host));
+            }
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(100, cache.size());
+}
+
+} // end of anonymous namespace
@@ -509,6 +509,48 @@ TEST_F(MemfileLeaseMgrTest, persistLeases) {
     EXPECT_FALSE(lease_mgr->persistLeases(Memfile_LeaseMgr::V6));
 }
 
+/// @brief Check that the leases are written to the lease file in the
+/// write-behind mode.
+TEST_F(MemfileLeaseMgrTest, writeBehind) {
+    LeaseFileIO io4(getLeaseFilePath("leasefile4_1.csv"));
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["universe"] = "4";
+    pmap["lfc-interval"] = "0";
+    pmap["name"] = getLeaseFilePath("leasefile4_1.csv");
+    pmap["write-behind"] = "bogus";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr;
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), isc::BadValue);
+
+    pmap["write-behind"] = "true";
+    pmap["write-behind-interval"] = "bogus";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), isc::BadValue);
+
+    pmap["write-behind-interval"] = "10000";
+    pmap["write-behind-sync"] = "bogus";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), isc::BadValue);
+
+    pmap["write-behind-sync"] = "true";
+    ASSERT_NO_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)));
+
+    std::vector<uint8_t> hwaddr_vec(6);
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_vec, HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.45"), hwaddr,
+                               static_cast<const uint8_t*>(0), 0,
+                               100, 0, 1));
+    ASSERT_NO_THROW(lease_mgr->addLease(lease));
+
+    // Destroying the lease manager writes the pending lease.
+    lease_mgr.reset();
+    EXPECT_NE(std::string::npos,
+              io4.readFile().find("192.0.2.45,00:00:00:00:00:00,,100,100,1,0,0,,0,\n"));
+
+    // The lease is loaded from the file.
+    pmap["write-behind"] = "false";
+    ASSERT_NO_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)));
+    EXPECT_TRUE(lease_mgr->getLease4(IOAddress("192.0.2.45")));
+}
+
 /// @brief Check if it is possible to schedule the timer to perform the Lease
 /// File Cleanup periodically.
 TEST_F(MemfileLeaseMgrTest, lfcTimer) {
@@ -0,0 +1,192 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/memfile_lease_stats.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Creates an IPv4 lease.
+///
+/// @param address lease address
+/// @param subnet_id subnet identifier
+/// @param state lease state
+/// @return The lease
+LeasePtr
+createLease4(const string& address, SubnetID subnet_id, uint32_t state) {
+    HWAddrPtr hwaddr(new HWAddr(vector<uint8_t>(6, 1), HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress(address), hwaddr, ClientIdPtr(),
+                               3600, time(0), subnet_id));
+    lease->state_ = state;
+    return (lease);
+}
+
+/// @brief Creates an IPv6 lease.
+///
+/// @param ltype lease type
+/// @param address lease address or prefix
+/// @param subnet_id subnet identifier
+/// @param state lease state
+/// @return The lease
+LeasePtr
+createLease6(Lease::Type ltype, const string& address, SubnetID subnet_id,
+             uint32_t state) {
+    DuidPtr duid(new DUID(vector<uint8_t>(8, 2)));
+    Lease6Ptr lease(new Lease6(ltype, IOAddress(address), duid, 1, 1800,
+                               3600, subnet_id, HWAddrPtr(),
+                               ltype == Lease::TYPE_PD ? 64 : 128));
+    lease->state_ = state;
+    return (lease);
+}
+
+// Verifies that adding and removing leases updates the counts.
+TEST(LeaseStatsCounterTest, addRemove) {
+    LeaseStatsCounter counter;
+    LeasePtr lease1 = createLease4("192.0.2.1", 1, Lease::STATE_DEFAULT);
+    LeasePtr lease2 = createLease4("192.0.2.2", 1, Lease::STATE_DEFAULT);
+    LeasePtr lease3 = createLease4("192.0.2.3", 1, Lease::STATE_DECLINED);
+    LeasePtr lease4 = createLease4("192.0.2.4", 1,
+                                   Lease::STATE_EXPIRED_RECLAIMED);
+
+    counter.addLease(lease1);
+    counter.addLease(lease2);
+    counter.addLease(lease3);
+    counter.addLease(lease4);
+    EXPECT_EQ(2, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+    // Reclaimed leases are not counted.
+    EXPECT_EQ(0, counter.getCount(1, Lease::TYPE_V4,
+                                  Lease::STATE_EXPIRED_RECLAIMED));
+    EXPECT_EQ(2, counter.size());
+
+    counter.removeLease(lease1);
+    counter.removeLease(lease4);
+    EXPECT_EQ(1, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    counter.removeLease(lease2);
+    counter.removeLease(lease3);
+    EXPECT_EQ(0, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(0, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+
+    // Zero counts are removed.
+    EXPECT_EQ(0, counter.size());
+
+    // Removing an uncounted lease does nothing.
+    counter.removeLease(lease1);
+    EXPECT_EQ(0, counter.size());
+}
+
+// Verifies that updating leases moves the counts.
+TEST(LeaseStatsCounterTest, update) {
+    LeaseStatsCounter counter;
+    LeasePtr lease = createLease4("192.0.2.1", 1, Lease::STATE_DEFAULT);
+    counter.addLease(lease);
+
+    // Same subnet and state.
+    LeasePtr renewed = createLease4("192.0.2.1", 1, Lease::STATE_DEFAULT);
+    counter.updateLease(renewed, lease);
+    EXPECT_EQ(1, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+
+    // Declined.
+    LeasePtr declined = createLease4("192.0.2.1", 1, Lease::STATE_DECLINED);
+    counter.updateLease(declined, renewed);
+    EXPECT_EQ(0, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DECLINED));
+
+    // Reclaimed.
+    LeasePtr reclaimed = createLease4("192.0.2.1", 1,
+                                      Lease::STATE_EXPIRED_RECLAIMED);
+    counter.updateLease(reclaimed, declined);
+    EXPECT_EQ(0, counter.size());
+
+    // Reused in another subnet.
+    LeasePtr moved = createLease4("192.0.2.1", 2, Lease::STATE_DEFAULT);
+    counter.updateLease(moved, reclaimed);
+    EXPECT_EQ(0, counter.getCount(1, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+    EXPECT_EQ(1, counter.getCount(2, Lease::TYPE_V4, Lease::STATE_DEFAULT));
+}
+
+// Verifies the rows returned for DHCPv4 and DHCPv6 ranges of subnets.
+TEST(LeaseStatsCounterTest, getRows) {
+    LeaseStatsCounter counter;
+    counter.addLease(createLease4("192.0.2.1", 1, Lease::STATE_DEFAULT));
+    counter.addLease(createLease4("192.0.2.2", 1, Lease::STATE_DECLINED));
+    counter.addLease(createLease4("192.0.3.1", 3, Lease::STATE_DEFAULT));
+    counter.addLease(createLease6(Lease::TYPE_NA, "2001:db8:1::1", 1,
+                                  Lease::STATE_DEFAULT));
+    counter.addLease(createLease6(Lease::TYPE_NA, "2001:db8:1::2", 1,
+                                  Lease::STATE_DECLINED));
+    counter.addLease(createLease6(Lease::TYPE_PD, "3000:1::", 2,
+                                  Lease::STATE_DEFAULT));
+    counter.addLease(createLease6(Lease::TYPE_PD, "3000:2::", 2,
+                                  Lease::STATE_DEFAULT));
+    // Declined prefixes are not counted.
+    counter.addLease(createLease6(Lease::TYPE_PD, "3000:3::", 2,
+                                  Lease::STATE_DECLINED));
+
+    vector<LeaseStatsRow> rows;
+    counter.getRows(0, 100, false, rows);
+    ASSERT_EQ(3, rows.size());
+    EXPECT_EQ(1, rows[0].subnet_id_);
+    EXPECT_EQ(Lease::TYPE_NA, rows[0].lease_type_);
+    EXPECT_EQ(Lease::STATE_DEFAULT, rows[0].lease_state_);
+    EXPECT_EQ(1, rows[0].state_count_);
+    EXPECT_EQ(1, rows[1].subnet_id_);
+    EXPECT_EQ(Lease::STATE_DECLINED, rows[1].lease_state_);
+    EXPECT_EQ(1, rows[1].state_count_);
+    EXPECT_EQ(3, rows[2].subnet_id_);
+    EXPECT_EQ(Lease::STATE_DEFAULT, rows[2].lease_state_);
+    EXPECT_EQ(1, rows[2].state_count_);
+
+    rows.clear();
+    counter.getRows(2, 3, false, rows);
+    ASSERT_EQ(1, rows.size());
+    EXPECT_EQ(3, rows[0].subnet_id_);
+
+    rows.clear();
+    counter.getRows(0, 100, true, rows);
+    ASSERT_EQ(3, rows.size());
+    EXPECT_EQ(1, rows[0].subnet_id_);
+    EXPECT_EQ(Lease::TYPE_NA, rows[0].lease_type_);
+    EXPECT_EQ(Lease::STATE_DEFAULT, rows[0].lease_state_);
+    EXPECT_EQ(1, rows[0].state_count_);
+    EXPECT_EQ(1, rows[1].subnet_id_);
+    EXPECT_EQ(Lease::TYPE_NA, rows[1].lease_type_);
+    EXPECT_EQ(Lease::STATE_DECLINED, rows[1].lease_state_);
+    EXPECT_EQ(1, rows[1].state_count_);
+    EXPECT_EQ(2, rows[2].subnet_id_);
+    EXPECT_EQ(Lease::TYPE_PD, rows[2].lease_type_);
+    EXPECT_EQ(Lease::STATE_DEFAULT, rows[2].lease_state_);
+    EXPECT_EQ(2, rows[2].state_count_);
+
+    rows.clear();
+    counter.getRows(2, 2, true, rows);
+    ASSERT_EQ(1, rows.size());
+    EXPECT_EQ(2, rows[0].subnet_id_);
+
+    // Empty and invalid ranges.
+    rows.clear();
+    counter.getRows(4, 100, true, rows);
+    counter.getRows(3, 1, false, rows);
+    EXPECT_TRUE(rows.empty());
+
+    counter.clear();
+    EXPECT_EQ(0, counter.size());
+}
+
+} // end of anonymous namespace
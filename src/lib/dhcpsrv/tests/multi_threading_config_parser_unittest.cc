@@ -78,6 +78,13 @@ TEST_F(MultiThreadingConfigParserTest, validContent) {
         "   \"thread-pool-size\": 4, \n"
         "   \"packet-queue-size\": 64 \n"
         "} \n"
+        },
+        {
+        "enable-multi-threading, with client-affinity",
+        "{ \n"
+        "   \"enable-multi-threading\": true, \n"
+        "   \"client-affinity\": true \n"
+        "} \n"
         }
     };
 
@@ -166,6 +173,13 @@ TEST_F(MultiThreadingConfigParserTest, invalidContent) {
         "{ \n"
         "   \"packet-queue-size\": 200000 \n"
         "} \n"
+        },
+        {
+        "client-affinity not boolean",
+        "{ \n"
+        "   \"enable-multi-threading\": true, \n"
+        "   \"client-affinity\": 1 \n"
+        "} \n"
         }
     };
 
@@ -754,6 +754,19 @@ TEST_F(MySqlHostDataSourceTest, get4ByClientIdMultiThreading) {
     testGet4ByIdentifier(Host::IDENT_CLIENT_ID);
 }
 
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(MySqlHostDataSourceTest, getAllbyIdentifiers4) {
+    testGetAllbyIdentifiers4();
+}
+
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(MySqlHostDataSourceTest, getAllbyIdentifiers4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testGetAllbyIdentifiers4();
+}
+
 /// @brief Test verifies if hardware address and client identifier are not confused.
 TEST_F(MySqlHostDataSourceTest, hwaddrNotClientId1) {
     testHWAddrNotClientId();
@@ -959,6 +972,19 @@ TEST_F(MySqlHostDataSourceTest, get6ByClientIdMultiThreading) {
     testGet6ByClientId();
 }
 
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(MySqlHostDataSourceTest, getAllbyIdentifiers6) {
+    testGetAllbyIdentifiers6();
+}
+
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(MySqlHostDataSourceTest, getAllbyIdentifiers6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testGetAllbyIdentifiers6();
+}
+
 /// @brief Test verifies if a host reservation can be stored with both IPv6 address and
 /// prefix.
 TEST_F(MySqlHostDataSourceTest, addr6AndPrefix) {
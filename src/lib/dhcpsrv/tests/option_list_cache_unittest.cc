@@ -0,0 +1,152 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option.h>
+#include <dhcpsrv/option_list_cache.h>
+#include <dhcpsrv/pool.h>
+#include <dhcpsrv/srv_config.h>
+#include <testutils/multi_threading_utils.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::test;
+
+namespace {
+
+/// @brief Creates resolved options holding one option.
+///
+/// @param code The code of the option.
+/// @return The resolved options.
+ConstResolvedOptionsPtr
+createResolved(uint16_t code) {
+    boost::shared_ptr<ResolvedOptions> resolved(new ResolvedOptions());
+    resolved->options_.push_back(Option::create(Option::V4, code));
+    resolved->requested_.insert(code);
+    return (resolved);
+}
+
+// This test verifies that resolved options are cached by subnet, pool,
+// client classes and requested codes.
+TEST(OptionListCacheTest, getPut) {
+    OptionListCache cache;
+    Pool4 pool(IOAddress("192.0.2.1"), IOAddress("192.0.2.10"));
+    ClientClasses classes;
+    classes.insert("foo");
+    std::vector<uint16_t> prl = { DHO_ROUTERS, DHO_DOMAIN_NAME_SERVERS };
+
+    EXPECT_FALSE(cache.get(1, 0, classes, prl));
+
+    ConstResolvedOptionsPtr resolved = createResolved(DHO_ROUTERS);
+    cache.put(1, 0, classes, prl, resolved);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(resolved, cache.get(1, 0, classes, prl));
+
+    // Another subnet, pool, classes or requested codes do not match.
+    EXPECT_FALSE(cache.get(2, 0, classes, prl));
+    EXPECT_FALSE(cache.get(1, &pool, classes, prl));
+    ClientClasses other_classes;
+    other_classes.insert("foo");
+    other_classes.insert("bar");
+    EXPECT_FALSE(cache.get(1, 0, other_classes, prl));
+    EXPECT_FALSE(cache.get(1, 0, ClientClasses(), prl));
+    std::vector<uint16_t> other_prl = { DHO_ROUTERS };
+    EXPECT_FALSE(cache.get(1, 0, classes, other_prl));
+
+    // The order of the classes matters as it gives the precedence of
+    // their options.
+    ClientClasses reordered;
+    reordered.insert("bar");
+    reordered.insert("foo");
+    ConstResolvedOptionsPtr other = createResolved(DHO_DOMAIN_NAME);
+    cache.put(1, 0, other_classes, prl, other);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_FALSE(cache.get(1, 0, reordered, prl));
+    EXPECT_EQ(resolved, cache.get(1, 0, classes, prl));
+    EXPECT_EQ(other, cache.get(1, 0, other_classes, prl));
+
+    // An entry is replaced.
+    cache.put(1, 0, classes, prl, other);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(other, cache.get(1, 0, classes, prl));
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_FALSE(cache.get(1, 0, classes, prl));
+}
+
+// This test verifies that the cache is bounded and evicts the least
+// recently used entry.
+TEST(OptionListCacheTest, maxEntries) {
+    EXPECT_THROW(OptionListCache(0), BadValue);
+
+    OptionListCache cache(2);
+    ClientClasses classes;
+    std::vector<uint16_t> prl1 = { 1 };
+    std::vector<uint16_t> prl2 = { 2 };
+    std::vector<uint16_t> prl3 = { 3 };
+    cache.put(1, 0, classes, prl1, createResolved(1));
+    cache.put(1, 0, classes, prl2, createResolved(2));
+
+    // Use the first entry so the second is the least recently used.
+    EXPECT_TRUE(cache.get(1, 0, classes, prl1));
+    cache.put(1, 0, classes, prl3, createResolved(3));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_TRUE(cache.get(1, 0, classes, prl1));
+    EXPECT_FALSE(cache.get(1, 0, classes, prl2));
+    EXPECT_TRUE(cache.get(1, 0, classes, prl3));
+}
+
+// This test verifies that the cache can be used by several threads when
+// multi-threading is enabled.
+TEST(OptionListCacheTest, multiThreading) {
+    MultiThreadingTest mt(true);
+    OptionListCache cache(8);
+    std::vector<std::thread> threads;
+    for (uint16_t code = 1; code <= 4; ++code) {
+        threads.push_back(std::thread([&cache, code]() {
+            ClientClasses classes;
+            for (uint16_t i = 0; i < 1000; ++i) {
+                std::vector<uint16_t> prl = {
+                    code, static_cast<uint16_t>(i % 4)
+                };
+                if (!cache.get(1, 0, classes, prl)) {
+                    cache.put(1, 0, classes, prl, createResolved(code));
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(8, cache.size());
+}
+
+// This test verifies that each server configuration has its own cache
+// and that it is flushed by a merge.
+TEST(OptionListCacheTest, srvConfig) {
+    SrvConfig cfg;
+    SrvConfig other;
+    ASSERT_TRUE(cfg.getOptionListCache());
+    EXPECT_NE(cfg.getOptionListCache(), other.getOptionListCache());
+
+    std::vector<uint16_t> prl = { DHO_ROUTERS };
+    cfg.getOptionListCache()->put(1, 0, ClientClasses(), prl,
+                                  createResolved(DHO_ROUTERS));
+    EXPECT_EQ(1, cfg.getOptionListCache()->size());
+
+    cfg.merge(other);
+    EXPECT_EQ(0, cfg.getOptionListCache()->size());
+}
+
+} // end of anonymous namespace
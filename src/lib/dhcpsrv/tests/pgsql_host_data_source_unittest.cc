@@ -722,6 +722,19 @@ TEST_F(PgSqlHostDataSourceTest, get4ByClientIdMultiThreading) {
     testGet4ByIdentifier(Host::IDENT_CLIENT_ID);
 }
 
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(PgSqlHostDataSourceTest, getAllbyIdentifiers4) {
+    testGetAllbyIdentifiers4();
+}
+
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(PgSqlHostDataSourceTest, getAllbyIdentifiers4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testGetAllbyIdentifiers4();
+}
+
 /// @brief Test verifies if hardware address and client identifier are not confused.
 TEST_F(PgSqlHostDataSourceTest, hwaddrNotClientId1) {
     testHWAddrNotClientId();
@@ -927,6 +940,19 @@ TEST_F(PgSqlHostDataSourceTest, get6ByClientIdMultiThreading) {
     testGet6ByClientId();
 }
 
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(PgSqlHostDataSourceTest, getAllbyIdentifiers6) {
+    testGetAllbyIdentifiers6();
+}
+
+/// @brief Test verifies if host reservations can be retrieved by subnet
+/// and a list of identifiers.
+TEST_F(PgSqlHostDataSourceTest, getAllbyIdentifiers6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testGetAllbyIdentifiers6();
+}
+
 /// @brief Test verifies if a host reservation can be stored with both IPv6 address and
 /// prefix.
 TEST_F(PgSqlHostDataSourceTest, addr6AndPrefix) {
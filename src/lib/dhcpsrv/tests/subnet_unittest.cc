@@ -14,6 +14,8 @@
 #include <dhcp/option_custom.h>
 #include <dhcp/option_definition.h>
 #include <dhcp/option_space.h>
+#include <dhcpsrv/bitmap_allocator.h>
+#include <dhcpsrv/bitmap_allocation_state.h>
 #include <dhcpsrv/flq_allocator.h>
 #include <dhcpsrv/flq_allocation_state.h>
 #include <dhcpsrv/iterative_allocator.h>
@@ -832,6 +834,65 @@ TEST(Subnet4Test, createAllocatorsFreeLeaseQueue) {
                 (pool->getAllocationState()));
 }
 
+// This test verifies that a bitmap allocator and the corresponding
+// states are instantiated for a subnet.
+TEST(Subnet4Test, createAllocatorsBitmap) {
+    // Create a subnet.
+    auto subnet = Subnet4::create(IOAddress("192.2.0.0"), 16, 1, 2, 3);
+    ASSERT_TRUE(subnet);
+    // Create a pool.
+    auto pool = boost::make_shared<Pool4>(IOAddress("192.2.0.0"), 16);
+    subnet->addPool(pool);
+    // Select the bitmap allocator.
+    subnet->setAllocatorType("bitmap");
+    // Instantiate the allocator.
+    ASSERT_NO_THROW(subnet->createAllocators());
+    // Expect bitmap allocator.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<BitmapAllocator>
+                (subnet->getAllocator(Lease::TYPE_V4)));
+    // Expect null subnet allocation state.
+    EXPECT_FALSE(subnet->getAllocationState(Lease::TYPE_V4));
+    // Expect bitmap allocation state for the pool.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<PoolBitmapAllocationState>
+                (pool->getAllocationState()));
+}
+
+// This test verifies that the iterative allocator is used instead of
+// the bitmap allocator when a pool is too large for it.
+TEST(Subnet4Test, createAllocatorsBitmapLargePool) {
+    // Create a subnet.
+    auto subnet = Subnet4::create(IOAddress("10.0.0.0"), 8, 1, 2, 3);
+    ASSERT_TRUE(subnet);
+    // Create a pool of 2^24 addresses and a pool of 2^24 + 1 addresses.
+    auto pool1 = boost::make_shared<Pool4>(IOAddress("10.0.0.0"), 8);
+    subnet->addPool(pool1);
+    auto pool2 = boost::make_shared<Pool4>(IOAddress("11.0.0.0"),
+                                           IOAddress("12.0.0.0"));
+    // Select the bitmap allocator.
+    subnet->setAllocatorType("bitmap");
+    // The first pool is supported.
+    ASSERT_NO_THROW(subnet->createAllocators());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<BitmapAllocator>
+                (subnet->getAllocator(Lease::TYPE_V4)));
+    // The second pool is not: expect iterative allocator and states.
+    subnet = Subnet4::create(IOAddress("8.0.0.0"), 5, 1, 2, 3);
+    ASSERT_TRUE(subnet);
+    subnet->addPool(pool1);
+    subnet->addPool(pool2);
+    subnet->setAllocatorType("bitmap");
+    ASSERT_NO_THROW(subnet->createAllocators());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<IterativeAllocator>
+                (subnet->getAllocator(Lease::TYPE_V4)));
+    EXPECT_TRUE(boost::dynamic_pointer_cast<SubnetIterativeAllocationState>
+                (subnet->getAllocationState(Lease::TYPE_V4)));
+    EXPECT_TRUE(boost::dynamic_pointer_cast<PoolIterativeAllocationState>
+                (pool1->getAllocationState()));
+    EXPECT_TRUE(boost::dynamic_pointer_cast<PoolIterativeAllocationState>
+                (pool2->getAllocationState()));
+    // The configured allocator type is unchanged.
+    EXPECT_EQ("bitmap", subnet->getAllocatorType().get());
+}
+
 // Tests for Subnet6
 
 TEST(Subnet6Test, constructor) {
@@ -1909,6 +1970,42 @@ TEST(Subnet6Test, createAllocatorsFreeLeaseQueue) {
                 (pd_pool->getAllocationState()));
 }
 
+// This test verifies that the iterative allocator is used instead of
+// the bitmap allocator for a /64 address pool, while a small prefix
+// delegation pool gets the bitmap allocator.
+TEST(Subnet6Test, createAllocatorsBitmapLargePool) {
+    auto subnet = Subnet6::create(IOAddress("2001:db8:1::"), 56, 1, 2, 3, 4);
+    ASSERT_TRUE(subnet);
+    // NA pool.
+    auto pool = boost::make_shared<Pool6>(Lease::TYPE_NA, IOAddress("2001:db8:1:1::"), 64);
+    subnet->addPool(pool);
+    // PD pool.
+    auto pd_pool = boost::make_shared<Pool6>(Lease::TYPE_PD, IOAddress("3000::"), 32, 56);
+    subnet->addPool(pd_pool);
+    // Select the bitmap allocator for addresses and prefix delegation.
+    subnet->setAllocatorType("bitmap");
+    subnet->setPdAllocatorType("bitmap");
+    // Instantiate the allocators.
+    ASSERT_NO_THROW(subnet->createAllocators());
+    // Expect iterative allocator for NA.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<IterativeAllocator>
+                (subnet->getAllocator(Lease::TYPE_NA)));
+    // Expect bitmap allocator for PD.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<BitmapAllocator>
+                (subnet->getAllocator(Lease::TYPE_PD)));
+    // Expect iterative subnet allocation state for NA.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<SubnetIterativeAllocationState>
+                (subnet->getAllocationState(Lease::TYPE_NA)));
+    // Expect null subnet allocation state for PD.
+    EXPECT_FALSE(subnet->getAllocationState(Lease::TYPE_PD));
+    // Expect iterative allocation state for the NA pool.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<PoolIterativeAllocationState>
+                (pool->getAllocationState()));
+    // Expect bitmap allocation state for the PD pool.
+    EXPECT_TRUE(boost::dynamic_pointer_cast<PoolBitmapAllocationState>
+                (pd_pool->getAllocationState()));
+}
+
 // Test that it is not allowed to use the FLQ allocator for the address pools.
 TEST(Subnet6Test, createAllocatorsFreeLeaseQueueNotAllowed) {
     auto subnet = Subnet6::create(IOAddress("2001:db8:1::"), 56, 1, 2, 3, 4);
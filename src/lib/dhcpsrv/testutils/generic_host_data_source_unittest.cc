@@ -1336,6 +1336,76 @@ GenericHostDataSourceTest::testGet4ByIdentifier(
     HostDataSourceUtils::compareHosts(host2, from_hds2);
 }
 
+void
+GenericHostDataSourceTest::testGetAllbyIdentifiers4() {
+    // Make sure we have a pointer to the host data source.
+    ASSERT_TRUE(hdsptr_);
+
+    // Create reservations in the same subnet for several identifier types.
+    HostPtr host1 = HostDataSourceUtils::initializeHost4("192.0.2.1", Host::IDENT_HWADDR);
+    HostPtr host2 = HostDataSourceUtils::initializeHost4("192.0.2.2", Host::IDENT_CLIENT_ID);
+    HostPtr host3 = HostDataSourceUtils::initializeHost4("192.0.2.3", Host::IDENT_CIRCUIT_ID);
+    HostPtr host4 = HostDataSourceUtils::initializeHost4("192.0.2.4", Host::IDENT_HWADDR);
+    SubnetID subnet = host1->getIPv4SubnetID();
+    host2->setIPv4SubnetID(subnet);
+    host3->setIPv4SubnetID(subnet);
+    host4->setIPv4SubnetID(subnet);
+
+    // Create a reservation for the identifier of the first host in
+    // another subnet.
+    SubnetID other_subnet = subnet + 1000;
+    HostPtr other(new Host(&host1->getIdentifier()[0],
+                           host1->getIdentifier().size(),
+                           Host::IDENT_HWADDR, other_subnet,
+                           SUBNET_ID_UNUSED, IOAddress("192.0.3.1")));
+
+    ASSERT_NO_THROW(hdsptr_->add(host1));
+    ASSERT_NO_THROW(hdsptr_->add(host2));
+    ASSERT_NO_THROW(hdsptr_->add(host3));
+    ASSERT_NO_THROW(hdsptr_->add(host4));
+    ASSERT_NO_THROW(hdsptr_->add(other));
+
+    // Look for all identifier types, some of them without reservations,
+    // and for more identifiers than identifier types.
+    HostIdentifierList identifiers;
+    identifiers.push_back(make_pair(Host::IDENT_DUID,
+                                    HostDataSourceUtils::generateIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_CIRCUIT_ID,
+                                    host3->getIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_HWADDR,
+                                    host1->getIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_FLEX,
+                                    HostDataSourceUtils::generateIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_CLIENT_ID,
+                                    host2->getIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_HWADDR,
+                                    host4->getIdentifier()));
+
+    // All the hosts of the subnet should be returned.
+    ConstHostCollection from_hds =
+        hdsptr_->getAllbyIdentifiers4(subnet, identifiers);
+    ASSERT_EQ(4, from_hds.size());
+    for (auto const& host : { host1, host2, host3, host4 }) {
+        bool found = false;
+        for (auto const& from : from_hds) {
+            if (from->getIPv4Reservation() == host->getIPv4Reservation()) {
+                HostDataSourceUtils::compareHosts(host, from);
+                found = true;
+            }
+        }
+        EXPECT_TRUE(found) << host->getIPv4Reservation().toText();
+    }
+
+    // Only the reservation of the other subnet should be returned.
+    from_hds = hdsptr_->getAllbyIdentifiers4(other_subnet, identifiers);
+    ASSERT_EQ(1, from_hds.size());
+    HostDataSourceUtils::compareHosts(other, *from_hds.begin());
+
+    // Nothing should be returned for an empty list.
+    EXPECT_TRUE(hdsptr_->getAllbyIdentifiers4(subnet,
+                                              HostIdentifierList()).empty());
+}
+
 void
 GenericHostDataSourceTest::testHWAddrNotClientId() {
     // Make sure we have a pointer to the host data source.
@@ -1619,6 +1689,76 @@ GenericHostDataSourceTest::testGet6ByClientId() {
     HostDataSourceUtils::compareHosts(host2, from_hds2);
 }
 
+void
+GenericHostDataSourceTest::testGetAllbyIdentifiers6() {
+    // Make sure we have a pointer to the host data source.
+    ASSERT_TRUE(hdsptr_);
+
+    // Create reservations in the same subnet for several identifiers.
+    HostPtr host1 = HostDataSourceUtils::initializeHost6("2001:db8::1", Host::IDENT_HWADDR, false);
+    HostPtr host2 = HostDataSourceUtils::initializeHost6("2001:db8::2", Host::IDENT_DUID, false);
+    HostPtr host3 = HostDataSourceUtils::initializeHost6("2001:db8::3", Host::IDENT_DUID, false);
+    SubnetID subnet = host1->getIPv6SubnetID();
+    host2->setIPv6SubnetID(subnet);
+    host3->setIPv6SubnetID(subnet);
+
+    // Create a reservation for the identifier of the first host in
+    // another subnet.
+    SubnetID other_subnet = subnet + 1000;
+    HostPtr other(new Host(&host1->getIdentifier()[0],
+                           host1->getIdentifier().size(),
+                           Host::IDENT_HWADDR, SUBNET_ID_UNUSED,
+                           other_subnet, IOAddress("0.0.0.0")));
+    other->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                    IOAddress("2001:db8:1::1"), 128));
+
+    ASSERT_NO_THROW(hdsptr_->add(host1));
+    ASSERT_NO_THROW(hdsptr_->add(host2));
+    ASSERT_NO_THROW(hdsptr_->add(host3));
+    ASSERT_NO_THROW(hdsptr_->add(other));
+
+    // Look for all identifier types, some of them without reservations,
+    // and for more identifiers than identifier types.
+    HostIdentifierList identifiers;
+    identifiers.push_back(make_pair(Host::IDENT_HWADDR,
+                                    host1->getIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_CLIENT_ID,
+                                    HostDataSourceUtils::generateIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_DUID,
+                                    host2->getIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_CIRCUIT_ID,
+                                    HostDataSourceUtils::generateIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_FLEX,
+                                    HostDataSourceUtils::generateIdentifier()));
+    identifiers.push_back(make_pair(Host::IDENT_DUID,
+                                    host3->getIdentifier()));
+
+    // All the hosts of the subnet should be returned.
+    ConstHostCollection from_hds =
+        hdsptr_->getAllbyIdentifiers6(subnet, identifiers);
+    ASSERT_EQ(3, from_hds.size());
+    for (auto const& host : { host1, host2, host3 }) {
+        bool found = false;
+        for (auto const& from : from_hds) {
+            if ((from->getIdentifierType() == host->getIdentifierType()) &&
+                (from->getIdentifier() == host->getIdentifier())) {
+                HostDataSourceUtils::compareHosts(host, from);
+                found = true;
+            }
+        }
+        EXPECT_TRUE(found) << host->toText();
+    }
+
+    // Only the reservation of the other subnet should be returned.
+    from_hds = hdsptr_->getAllbyIdentifiers6(other_subnet, identifiers);
+    ASSERT_EQ(1, from_hds.size());
+    HostDataSourceUtils::compareHosts(other, *from_hds.begin());
+
+    // Nothing should be returned for an empty list.
+    EXPECT_TRUE(hdsptr_->getAllbyIdentifiers6(subnet,
+                                              HostIdentifierList()).empty());
+}
+
 void
 GenericHostDataSourceTest::testSubnetId6(int subnets, Host::IdentifierType id) {
     // Make sure we have a pointer to the host data source.
@@ -287,6 +287,12 @@ public:
     /// Uses gtest macros to report failures.
     void testGet4ByIdentifier(const Host::IdentifierType& identifier_type);
 
+    /// @brief Test that hosts can be retrieved by subnet and a list of
+    /// identifiers.
+    ///
+    /// Uses gtest macros to report failures.
+    void testGetAllbyIdentifiers4();
+
     /// @brief Test that clients with stored HW address can't be retrieved
     ///        by DUID with the same value.
     ///
@@ -353,6 +359,12 @@ public:
     /// Uses gtest macros to report failures.
     void testGet6ByClientId();
 
+    /// @brief Test that hosts can be retrieved by subnet and a list of
+    /// identifiers.
+    ///
+    /// Uses gtest macros to report failures.
+    void testGetAllbyIdentifiers6();
+
     /// @brief Test verifies if a host reservation can be stored with both
     ///         IPv6 address and prefix.
     /// Uses gtest macros to report failures.
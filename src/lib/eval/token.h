@@ -1017,7 +1017,8 @@ public:
     ///
     /// @param client_class client class name
     TokenMember(const std::string& client_class)
-        :client_class_(client_class){
+        :client_class_(client_class),
+         client_class_id_(ClientClassRegistry::instance().intern(client_class)) {
     }
 
     /// @brief Token evaluation (check if client_class_ was added to
@@ -1040,6 +1041,9 @@ public:
 protected:
     /// @brief The client class name
     ClientClass client_class_;
+
+    /// @brief The interned client class identifier
+    ClientClassId client_class_id_;
 };
 
 /// @brief Token that represents vendor options in DHCPv4 and DHCPv6.
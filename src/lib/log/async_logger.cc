@@ -0,0 +1,405 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <log/async_logger.h>
+#include <log/log_messages.h>
+#include <log/logger.h>
+#include <log/logger_impl.h>
+#include <log/logger_manager.h>
+#include <log/macros.h>
+#include <log/interprocess/interprocess_sync_file.h>
+#include <log/interprocess/interprocess_sync_null.h>
+
+#include <log4cplus/spi/loggingevent.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+
+// Logger used for logging messages within the logging code itself.
+isc::log::Logger logger("log");
+
+// Convert a severity to the log4cplus level used by LoggerImpl::outputRaw.
+log4cplus::LogLevel
+toLogLevel(const isc::log::Severity& severity) {
+    switch (severity) {
+    case isc::log::DEBUG:
+        return (log4cplus::DEBUG_LOG_LEVEL);
+    case isc::log::INFO:
+        return (log4cplus::INFO_LOG_LEVEL);
+    case isc::log::WARN:
+        return (log4cplus::WARN_LOG_LEVEL);
+    case isc::log::ERROR:
+        return (log4cplus::ERROR_LOG_LEVEL);
+    case isc::log::FATAL:
+        return (log4cplus::FATAL_LOG_LEVEL);
+    default:
+        return (log4cplus::OFF_LOG_LEVEL);
+    }
+}
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace log {
+
+const size_t AsyncLogger::DEFAULT_CAPACITY;
+const long AsyncLogger::FLUSH_INTERVAL;
+
+struct AsyncLogger::Record {
+    /// @brief Constructor.
+    ///
+    /// The event records the current time. The thread specific data
+    /// (thread name, NDC and MDC) are recorded by the caller.
+    ///
+    /// @param logger The log4cplus logger to write the message to.
+    /// @param level The log4cplus level of the message.
+    /// @param message Text of the message.
+    Record(const log4cplus::Logger& logger, log4cplus::LogLevel level,
+           const string& message)
+        : logger_(logger),
+          event_(logger.getName(), level, message, __FILE__, __LINE__) {
+    }
+
+    /// @brief The log4cplus logger to write the message to.
+    log4cplus::Logger logger_;
+
+    /// @brief The logging event.
+    log4cplus::spi::InternalLoggingEvent event_;
+};
+
+/// The producer is the thread owning the ring, the consumer is the thread
+/// holding the drain mutex. Indexes are free running: the number of records
+/// in the ring is the difference between the tail and the head.
+class AsyncLogger::Ring {
+public:
+    /// @brief Constructor.
+    ///
+    /// @param capacity The capacity, a power of two.
+    explicit Ring(size_t capacity)
+        : slots_(capacity), mask_(capacity - 1), head_(0), tail_(0),
+          closed_(false) {
+    }
+
+    /// @brief Returns the capacity.
+    size_t capacity() const {
+        return (slots_.size());
+    }
+
+    /// @brief Appends a record (producer side).
+    ///
+    /// @param record The record, moved into the ring on success.
+    /// @param[out] size The number of records in the ring after the push.
+    /// @return false if the ring is full.
+    bool push(unique_ptr<Record>& record, size_t& size) {
+        size_t tail = tail_.load(memory_order_relaxed);
+        size_t head = head_.load(memory_order_acquire);
+        if (tail - head >= slots_.size()) {
+            return (false);
+        }
+        slots_[tail & mask_] = move(record);
+        tail_.store(tail + 1, memory_order_release);
+        size = tail + 1 - head;
+        return (true);
+    }
+
+    /// @brief Moves all records to a batch (consumer side).
+    ///
+    /// @param batch The batch to append the records to.
+    void pop(vector<unique_ptr<Record>>& batch) {
+        size_t head = head_.load(memory_order_relaxed);
+        size_t tail = tail_.load(memory_order_acquire);
+        for (; head != tail; ++head) {
+            batch.push_back(move(slots_[head & mask_]));
+        }
+        head_.store(head, memory_order_release);
+    }
+
+    /// @brief Checks if the ring is empty.
+    bool empty() const {
+        return (head_.load(memory_order_acquire) ==
+                tail_.load(memory_order_acquire));
+    }
+
+    /// @brief Marks the ring as abandoned by its thread.
+    void close() {
+        closed_ = true;
+    }
+
+    /// @brief Checks if the ring was abandoned by its thread.
+    bool isClosed() const {
+        return (closed_);
+    }
+
+private:
+    /// @brief The slots.
+    vector<unique_ptr<Record>> slots_;
+
+    /// @brief The mask to apply to indexes.
+    const size_t mask_;
+
+    /// @brief The consumer index.
+    atomic<size_t> head_;
+
+    /// @brief The producer index.
+    atomic<size_t> tail_;
+
+    /// @brief The abandoned flag.
+    atomic<bool> closed_;
+};
+
+AsyncLogger&
+AsyncLogger::instance() {
+    static AsyncLogger async_logger;
+    return (async_logger);
+}
+
+AsyncLogger::AsyncLogger()
+    : running_(false), producers_(0), dropped_(0), reported_(0),
+      capacity_(DEFAULT_CAPACITY),
+      wakeup_(false), stopping_(false) {
+}
+
+AsyncLogger::~AsyncLogger() {
+    stop();
+}
+
+void
+AsyncLogger::start(size_t capacity) {
+    if (capacity == 0) {
+        isc_throw(BadValue, "the capacity of the asynchronous logging "
+                  "queues must be greater than 0");
+    }
+    if (running_) {
+        return;
+    }
+
+    // Round the capacity up to a power of two.
+    capacity_ = 1;
+    while (capacity_ < capacity) {
+        capacity_ <<= 1;
+    }
+
+    if (lockfileEnabled()) {
+        sync_.reset(new interprocess::InterprocessSyncFile("logger"));
+    } else {
+        sync_.reset(new interprocess::InterprocessSyncNull("logger"));
+    }
+
+    dropped_ = 0;
+    reported_ = 0;
+    {
+        lock_guard<mutex> lk(mutex_);
+        wakeup_ = false;
+        stopping_ = false;
+    }
+    thread_.reset(new thread(&AsyncLogger::run, this));
+    running_ = true;
+}
+
+void
+AsyncLogger::stop() {
+    if (!thread_) {
+        return;
+    }
+
+    // From now on messages are written synchronously. Wait for the
+    // threads which are enqueuing a message so no message is enqueued
+    // after the final drain.
+    running_ = false;
+    while (producers_ > 0) {
+        this_thread::yield();
+    }
+
+    {
+        lock_guard<mutex> lk(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_->join();
+    thread_.reset();
+
+    // Write the messages which were enqueued since the last drain of the
+    // logging thread.
+    {
+        lock_guard<mutex> lk(drain_mutex_);
+        drain();
+    }
+    reportDropped();
+}
+
+bool
+AsyncLogger::enqueue(const log4cplus::Logger& logger, const Severity& severity,
+                     const string& message) {
+    // Register as a producer before checking the running flag: stop()
+    // clears the flag then waits for the registered producers.
+    struct ProducerGuard {
+        explicit ProducerGuard(atomic<size_t>& producers)
+            : producers_(producers) {
+            ++producers_;
+        }
+        ~ProducerGuard() {
+            --producers_;
+        }
+        atomic<size_t>& producers_;
+    } guard(producers_);
+
+    if (!running_) {
+        return (false);
+    }
+
+    log4cplus::LogLevel level = toLogLevel(severity);
+    if (!logger.isEnabledFor(level)) {
+        return (true);
+    }
+
+    unique_ptr<Record> record(new Record(logger, level, message));
+    record->event_.gatherThreadSpecificData();
+
+    Ring& ring = getRing();
+    size_t size = 0;
+    if (!ring.push(record, size)) {
+        if (severity < ERROR) {
+            ++dropped_;
+            return (true);
+        }
+
+        // Never drop errors. Writing the error synchronously would put it
+        // ahead of the older messages of the ring so write them first.
+        {
+            lock_guard<mutex> lk(drain_mutex_);
+            drain();
+        }
+        if (!ring.push(record, size)) {
+            return (false);
+        }
+    }
+
+    // Wake up the logging thread when the ring becomes half full or
+    // for an error so it is written without delay.
+    if ((size == ring.capacity() / 2) || (severity >= ERROR)) {
+        wakeUp();
+    }
+    return (true);
+}
+
+void
+AsyncLogger::flush() {
+    lock_guard<mutex> lk(drain_mutex_);
+    drain();
+}
+
+AsyncLogger::Ring&
+AsyncLogger::getRing() {
+    // Marks the ring as abandoned when the thread exits.
+    struct RingHolder {
+        ~RingHolder() {
+            if (ring_) {
+                ring_->close();
+            }
+        }
+        RingPtr ring_;
+    };
+    static thread_local RingHolder holder;
+
+    if (!holder.ring_) {
+        holder.ring_.reset(new Ring(capacity_));
+        lock_guard<mutex> lk(rings_mutex_);
+        rings_.push_back(holder.ring_);
+    }
+    return (*holder.ring_);
+}
+
+void
+AsyncLogger::run() {
+    for (;;) {
+        bool stopping = false;
+        {
+            unique_lock<mutex> lk(mutex_);
+            cv_.wait_for(lk, chrono::milliseconds(FLUSH_INTERVAL),
+                         [this]() { return (wakeup_ || stopping_); });
+            wakeup_ = false;
+            stopping = stopping_;
+        }
+
+        {
+            lock_guard<mutex> lk(drain_mutex_);
+            drain();
+        }
+
+        if (stopping) {
+            break;
+        }
+        reportDropped();
+    }
+}
+
+void
+AsyncLogger::drain() {
+    vector<RingPtr> rings;
+    {
+        lock_guard<mutex> lk(rings_mutex_);
+        // Forget the abandoned rings once they are empty.
+        rings_.erase(remove_if(rings_.begin(), rings_.end(),
+                               [](const RingPtr& ring) {
+                                   return (ring->isClosed() && ring->empty());
+                               }),
+                     rings_.end());
+        rings = rings_;
+    }
+
+    vector<unique_ptr<Record>> batch;
+    for (auto const& ring : rings) {
+        ring->pop(batch);
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    // Messages of a thread are in order: merge the threads.
+    stable_sort(batch.begin(), batch.end(),
+                [](const unique_ptr<Record>& a, const unique_ptr<Record>& b) {
+                    return (a->event_.getTimestamp() < b->event_.getTimestamp());
+                });
+
+    // Use a mutex locker for mutual exclusion from other threads in
+    // this process, and an interprocess sync locker for mutual exclusion
+    // from other processes, once for the whole batch.
+    lock_guard<mutex> mutex_locker(LoggerManager::getMutex());
+    interprocess::InterprocessSyncLocker locker(*sync_);
+    static_cast<void>(locker.lock());
+    for (auto const& record : batch) {
+        record->logger_.callAppenders(record->event_);
+    }
+    static_cast<void>(locker.unlock());
+}
+
+void
+AsyncLogger::reportDropped() {
+    uint64_t dropped = dropped_;
+    if (dropped > reported_) {
+        LOG_WARN(logger, LOG_ASYNC_MESSAGES_DROPPED).arg(dropped - reported_);
+        reported_ = dropped;
+    }
+}
+
+void
+AsyncLogger::wakeUp() {
+    {
+        lock_guard<mutex> lk(mutex_);
+        wakeup_ = true;
+    }
+    cv_.notify_one();
+}
+
+} // namespace log
+} // namespace isc
@@ -0,0 +1,191 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <log/logger_level.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <log4cplus/logger.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isc {
+namespace log {
+
+namespace interprocess {
+class InterprocessSync;
+}
+
+/// @brief Asynchronous logging backend.
+///
+/// When it is running, @c LoggerImpl::outputRaw does not write the log
+/// messages itself: the formatted message is enqueued into a ring owned
+/// by the calling thread and a dedicated thread writes the messages of
+/// all rings in batches to the configured appenders, taking the logger
+/// mutex and the logger lock file once per batch.
+///
+/// The rings are single producer, single consumer lock-free queues so
+/// logging threads never wait for each other nor for the output. When
+/// the ring of a thread is full the message is dropped and counted,
+/// unless its severity is ERROR or FATAL, in which case the thread
+/// writes the pending messages itself before enqueuing it, so the
+/// messages of a thread are always written in order. The number of
+/// dropped messages is periodically logged.
+///
+/// The time stamp and the thread of the messages are recorded when they
+/// are enqueued so the output is the same as in synchronous mode except
+/// for its delay.
+class AsyncLogger : public boost::noncopyable {
+public:
+    /// @brief Default capacity of the per-thread rings.
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    /// @brief Flush interval in milliseconds.
+    ///
+    /// The logging thread is woken up earlier when a ring gets half full
+    /// or when an ERROR or FATAL message is enqueued.
+    static const long FLUSH_INTERVAL = 100;
+
+    /// @brief Returns the asynchronous logging backend.
+    static AsyncLogger& instance();
+
+    /// @brief Destructor.
+    ///
+    /// Stops the logging thread after it wrote pending messages.
+    ~AsyncLogger();
+
+    /// @brief Starts the logging thread.
+    ///
+    /// Does nothing when it is already running.
+    ///
+    /// @param capacity Capacity of the rings created from now on. It is
+    /// rounded up to a power of two.
+    /// @throw BadValue when the capacity is 0.
+    void start(size_t capacity = DEFAULT_CAPACITY);
+
+    /// @brief Stops the logging thread after it wrote pending messages.
+    ///
+    /// Messages logged once this call has begun are written
+    /// synchronously; the messages enqueued before are all written
+    /// when it returns.
+    void stop();
+
+    /// @brief Checks if the logging thread is running.
+    bool isRunning() const {
+        return (running_);
+    }
+
+    /// @brief Enqueues a message.
+    ///
+    /// @param logger The log4cplus logger to write the message to.
+    /// @param severity Severity of the message.
+    /// @param message Text of the message.
+    /// @return true when the message was handled, i.e. enqueued, dropped
+    /// or filtered out by the logger level, false when the caller must
+    /// write it synchronously.
+    bool enqueue(const log4cplus::Logger& logger, const Severity& severity,
+                 const std::string& message);
+
+    /// @brief Writes all pending messages.
+    ///
+    /// Called when the logging configuration is changed so the pending
+    /// messages are written to the appenders they were logged for.
+    void flush();
+
+    /// @brief Returns the number of dropped messages since start.
+    uint64_t getDropped() const {
+        return (dropped_);
+    }
+
+private:
+    /// @brief A log message waiting to be written.
+    struct Record;
+
+    /// @brief The ring of a logging thread.
+    class Ring;
+
+    /// @brief Type of pointers to rings.
+    typedef boost::shared_ptr<Ring> RingPtr;
+
+    /// @brief Constructor.
+    AsyncLogger();
+
+    /// @brief Returns the ring of the calling thread, creating it if needed.
+    Ring& getRing();
+
+    /// @brief Body of the logging thread.
+    void run();
+
+    /// @brief Writes pending messages of all rings.
+    ///
+    /// Must be called with the drain mutex held.
+    void drain();
+
+    /// @brief Logs the number of messages dropped since the last call.
+    void reportDropped();
+
+    /// @brief Wakes up the logging thread.
+    void wakeUp();
+
+    /// @brief Flag which indicates if the logging thread is running.
+    std::atomic<bool> running_;
+
+    /// @brief Number of threads enqueuing a message.
+    std::atomic<size_t> producers_;
+
+    /// @brief Number of dropped messages.
+    std::atomic<uint64_t> dropped_;
+
+    /// @brief Number of dropped messages already reported.
+    uint64_t reported_;
+
+    /// @brief Capacity of new rings.
+    size_t capacity_;
+
+    /// @brief Protects the ring list.
+    std::mutex rings_mutex_;
+
+    /// @brief The rings of the logging threads.
+    std::vector<RingPtr> rings_;
+
+    /// @brief Serializes the consumers of the rings.
+    std::mutex drain_mutex_;
+
+    /// @brief Protects the logging thread wake up state.
+    std::mutex mutex_;
+
+    /// @brief Condition variable used to wake up the logging thread.
+    std::condition_variable cv_;
+
+    /// @brief Flag which indicates a wake up was requested.
+    bool wakeup_;
+
+    /// @brief Flag which indicates the logging thread must stop.
+    bool stopping_;
+
+    /// @brief The logging thread.
+    boost::scoped_ptr<std::thread> thread_;
+
+    /// @brief Interprocess synchronization used by the logging thread.
+    boost::scoped_ptr<interprocess::InterprocessSync> sync_;
+};
+
+} // namespace log
+} // namespace isc
+
+#endif // ASYNC_LOGGER_H
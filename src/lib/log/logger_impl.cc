@@ -27,6 +27,7 @@
 #include <log4cplus/syslogappender.h>
 #include <log4cplus/version.h>
 
+#include <log/async_logger.h>
 #include <log/logger.h>
 #include <log/logger_impl.h>
 #include <log/logger_level.h>
@@ -154,6 +155,13 @@ LoggerImpl::setInterprocessSync(interprocess::InterprocessSync* sync) {
 
 void
 LoggerImpl::outputRaw(const Severity& severity, const string& message) {
+    // In asynchronous mode the message is written by the logging thread.
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    if (async_logger.isRunning() &&
+        async_logger.enqueue(logger_, severity, message)) {
+        return;
+    }
+
     // Use a mutex locker for mutual exclusion from other threads in
     // this process.
     std::lock_guard<std::mutex> mutex_locker(LoggerManager::getMutex());
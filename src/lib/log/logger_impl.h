@@ -31,6 +31,13 @@
 namespace isc {
 namespace log {
 
+/// \brief detects whether file locking is enabled or disabled
+///
+/// The lockfile is enabled by default. The only way to disable it is to
+/// set KEA_LOCKFILE_DIR variable to 'none'.
+/// \return true if lockfile is enabled, false otherwise
+bool lockfileEnabled();
+
 /// \brief Console Logger Implementation
 ///
 /// The logger uses a "pimpl" idiom for implementation, where the base logger
@@ -7,8 +7,13 @@
 #include <config.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <iostream>
 #include <vector>
 
+#include <boost/lexical_cast.hpp>
+
+#include <log/async_logger.h>
 #include <log/logger.h>
 #include <log/logger_manager.h>
 #include <log/logger_manager_impl.h>
@@ -78,6 +83,8 @@ LoggerManager::~LoggerManager() {
 // Initialize processing
 void
 LoggerManager::processInit() {
+    // Write the pending messages before the appenders are replaced.
+    AsyncLogger::instance().flush();
     impl_->processInit();
 }
 
@@ -134,6 +141,30 @@ LoggerManager::init(const std::string& root, isc::log::Severity severity,
 
     // Ensure that the mutex is constructed and ready at this point.
     (void) getMutex();
+
+    // Start the asynchronous logging when requested.
+    initAsync();
+}
+
+void
+LoggerManager::initAsync() {
+    const char* const env = getenv("KEA_LOGGER_ASYNC");
+    if (!env) {
+        return;
+    }
+    const string value(env);
+    size_t capacity = 0;
+    try {
+        capacity = boost::lexical_cast<size_t>(value);
+    } catch (const boost::bad_lexical_cast&) {
+        // Reject it below.
+    }
+    if ((capacity == 0) || (value.find('-') != string::npos)) {
+        cerr << "**ERROR** value for KEA_LOGGER_ASYNC of " << value
+             << " is not a positive number: logging synchronously" << endl;
+        return;
+    }
+    AsyncLogger::instance().start(capacity);
 }
 
 void
@@ -201,6 +232,7 @@ LoggerManager::readLocalMessageFile(const char* file) {
 // Reset logging to settings passed to init()
 void
 LoggerManager::reset() {
+    AsyncLogger::instance().flush();
     setRootLoggerName(initRootName());
     LoggerManagerImpl::reset(initSeverity(), initDebugLevel());
 }
@@ -121,6 +121,13 @@ public:
     /// hooks library is loaded.
     static void logDuplicatedMessages();
 
+    /// \brief Start asynchronous logging if requested
+    ///
+    /// When the KEA_LOGGER_ASYNC environment variable is set to a positive
+    /// number, starts the asynchronous logging with per-thread queues of
+    /// this capacity. This method is called by the \c init method.
+    static void initAsync();
+
     /// \brief Reset logging
     ///
     /// Resets logging to whatever was set in the call to init(), expect for
@@ -0,0 +1,235 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <log/async_logger.h>
+#include <log/log_messages.h>
+#include <log/logger.h>
+#include <log/logger_manager.h>
+#include <log/logger_specification.h>
+#include <log/macros.h>
+#include <log/output_option.h>
+#include <log/tests/tempdir.h>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::log;
+using namespace std;
+
+namespace {
+
+/// @brief Test fixture for the asynchronous logging.
+///
+/// Sets up the "asynclogger" logger to log to a file.
+class AsyncLoggerTest : public ::testing::Test {
+public:
+    /// @brief Constructor.
+    AsyncLoggerTest() : name_(TEMP_DIR + "/kea_async_logger_test.log") {
+        static_cast<void>(remove(name_.c_str()));
+
+        OutputOption option;
+        option.destination = OutputOption::DEST_FILE;
+        option.filename = name_;
+
+        LoggerSpecification spec("asynclogger");
+        spec.addOutputOption(option);
+        manager_.process(spec);
+    }
+
+    /// @brief Destructor.
+    ~AsyncLoggerTest() {
+        AsyncLogger::instance().stop();
+        LoggerManager::reset();
+        static_cast<void>(remove(name_.c_str()));
+        static_cast<void>(remove((name_ + ".lock").c_str()));
+    }
+
+    /// @brief Returns the lines of the log file.
+    vector<string> getLines() {
+        vector<string> lines;
+        ifstream infile(name_.c_str());
+        string line;
+        while (getline(infile, line)) {
+            lines.push_back(line);
+        }
+        return (lines);
+    }
+
+    /// @brief The logger manager.
+    LoggerManager manager_;
+
+    /// @brief The name of the log file.
+    string name_;
+};
+
+// Verifies start and stop.
+TEST_F(AsyncLoggerTest, startStop) {
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    EXPECT_FALSE(async_logger.isRunning());
+    EXPECT_THROW(async_logger.start(0), BadValue);
+    EXPECT_FALSE(async_logger.isRunning());
+    async_logger.start(16);
+    EXPECT_TRUE(async_logger.isRunning());
+    // Starting twice is harmless.
+    async_logger.start(16);
+    EXPECT_TRUE(async_logger.isRunning());
+    async_logger.stop();
+    EXPECT_FALSE(async_logger.isRunning());
+    // Stopping twice is harmless.
+    async_logger.stop();
+    EXPECT_FALSE(async_logger.isRunning());
+}
+
+// Verifies that messages are written in order by the logging thread.
+TEST_F(AsyncLoggerTest, write) {
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    async_logger.start(1024);
+
+    Logger logger("asynclogger");
+    LOG_WARN(logger, LOG_DUPLICATE_MESSAGE_ID).arg("first");
+    LOG_WARN(logger, LOG_DUPLICATE_NAMESPACE).arg("second");
+    LOG_WARN(logger, LOG_NO_SUCH_MESSAGE).arg("third");
+    // Debug messages are filtered out by the logger level.
+    LOG_DEBUG(logger, 99, LOG_NO_MESSAGE_ID).arg("fourth");
+
+    async_logger.flush();
+    vector<string> lines = getLines();
+    ASSERT_EQ(3, lines.size());
+    EXPECT_NE(string::npos, lines[0].find("LOG_DUPLICATE_MESSAGE_ID"));
+    EXPECT_NE(string::npos, lines[1].find("LOG_DUPLICATE_NAMESPACE"));
+    EXPECT_NE(string::npos, lines[2].find("LOG_NO_SUCH_MESSAGE"));
+
+    // Messages are written by the logging thread without flush.
+    LOG_WARN(logger, LOG_NO_MESSAGE_ID).arg("fifth");
+    for (unsigned i = 0; (i < 50) && (getLines().size() < 4); ++i) {
+        usleep(10000);
+    }
+    EXPECT_EQ(4, getLines().size());
+    EXPECT_EQ(0, async_logger.getDropped());
+}
+
+// Verifies that messages from several threads are all written or counted
+// as dropped.
+TEST_F(AsyncLoggerTest, threads) {
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    // Use small queues to get some drops.
+    async_logger.start(8);
+
+    const unsigned THREADS = 4;
+    const unsigned MESSAGES = 500;
+    vector<thread> threads;
+    for (unsigned t = 0; t < THREADS; ++t) {
+        threads.push_back(thread([]() {
+            Logger logger("asynclogger");
+            for (unsigned i = 0; i < MESSAGES; ++i) {
+                LOG_WARN(logger, LOG_DUPLICATE_MESSAGE_ID).arg(i);
+            }
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    async_logger.flush();
+    size_t written = getLines().size();
+    EXPECT_EQ(THREADS * MESSAGES, written + async_logger.getDropped());
+
+    // Errors are never dropped.
+    uint64_t dropped = async_logger.getDropped();
+    threads.clear();
+    for (unsigned t = 0; t < THREADS; ++t) {
+        threads.push_back(thread([]() {
+            Logger logger("asynclogger");
+            for (unsigned i = 0; i < MESSAGES; ++i) {
+                LOG_ERROR(logger, LOG_DUPLICATE_MESSAGE_ID).arg(i);
+            }
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    async_logger.flush();
+    EXPECT_EQ(dropped, async_logger.getDropped());
+    EXPECT_LE(written + THREADS * MESSAGES, getLines().size());
+}
+
+// Verifies that an error hitting a full ring is written after the older
+// messages of its thread.
+TEST_F(AsyncLoggerTest, errorOrder) {
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    // Use a small queue so it gets full.
+    async_logger.start(4);
+
+    Logger logger("asynclogger");
+    for (unsigned i = 0; i < 100; ++i) {
+        LOG_WARN(logger, LOG_DUPLICATE_MESSAGE_ID).arg(i);
+    }
+    LOG_ERROR(logger, LOG_NO_MESSAGE_ID).arg("error");
+
+    async_logger.flush();
+    vector<string> lines = getLines();
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(100, lines.size() - 1 + async_logger.getDropped());
+    EXPECT_NE(string::npos, lines.back().find("LOG_NO_MESSAGE_ID"));
+}
+
+// Verifies that stop writes all enqueued messages and that messages
+// logged afterwards are written synchronously.
+TEST_F(AsyncLoggerTest, stopWrites) {
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    async_logger.start(1024);
+
+    Logger logger("asynclogger");
+    for (unsigned i = 0; i < 100; ++i) {
+        LOG_WARN(logger, LOG_DUPLICATE_MESSAGE_ID).arg(i);
+    }
+
+    async_logger.stop();
+    EXPECT_EQ(100, getLines().size());
+
+    LOG_WARN(logger, LOG_NO_MESSAGE_ID).arg("synchronous");
+    vector<string> lines = getLines();
+    ASSERT_EQ(101, lines.size());
+    EXPECT_NE(string::npos, lines.back().find("LOG_NO_MESSAGE_ID"));
+}
+
+// Verifies that no message is lost when the logging is stopped while
+// other threads are logging.
+TEST_F(AsyncLoggerTest, stopThreads) {
+    AsyncLogger& async_logger = AsyncLogger::instance();
+    async_logger.start(1024);
+
+    const unsigned THREADS = 4;
+    const unsigned MESSAGES = 200;
+    vector<thread> threads;
+    for (unsigned t = 0; t < THREADS; ++t) {
+        threads.push_back(thread([]() {
+            Logger logger("asynclogger");
+            for (unsigned i = 0; i < MESSAGES; ++i) {
+                LOG_WARN(logger, LOG_DUPLICATE_MESSAGE_ID).arg(i);
+            }
+        }));
+    }
+    async_logger.stop();
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(THREADS * MESSAGES, getLines().size() + async_logger.getDropped());
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,180 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <testutils/benchmark_utils.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+namespace isc {
+namespace test {
+
+namespace {
+
+/// @brief Converts a duration to microseconds.
+///
+/// @param duration the duration.
+/// @return the duration in microseconds.
+double
+toUsec(const BenchmarkPhase::Clock::duration& duration) {
+    return (chrono::duration<double, micro>(duration).count());
+}
+
+/// @brief Parses an unsigned command line argument.
+///
+/// @param option name of the option for the error message.
+/// @param value value of the option.
+/// @return parsed value.
+/// @throw BadValue if the value is not a valid unsigned number.
+uint32_t
+parseArg(const string& option, const char* value) {
+    try {
+        return (boost::lexical_cast<uint32_t>(value));
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(BadValue, "invalid value '" << value << "' for option "
+                  << option << ", expected an unsigned number");
+    }
+}
+
+}
+
+BenchmarkPhase::BenchmarkPhase(const string& name, size_t count)
+    : name_(name), latencies_(count), start_(), duration_(), sorted_(),
+      counters_() {
+}
+
+void
+BenchmarkPhase::start() {
+    util::MemoryPool::resetCounters();
+    start_ = Clock::now();
+}
+
+void
+BenchmarkPhase::stop() {
+    duration_ = Clock::now() - start_;
+    counters_ = util::MemoryPool::getCounters();
+    sorted_ = latencies_;
+    sort(sorted_.begin(), sorted_.end());
+}
+
+double
+BenchmarkPhase::getThroughput() const {
+    double seconds = chrono::duration<double>(duration_).count();
+    if (seconds <= 0) {
+        return (0);
+    }
+    return (latencies_.size() / seconds);
+}
+
+BenchmarkPhase::Clock::duration
+BenchmarkPhase::getPercentile(double percent) const {
+    if (sorted_.empty()) {
+        return (Clock::duration::zero());
+    }
+    size_t rank = static_cast<size_t>(percent * sorted_.size() / 100);
+    if (rank >= sorted_.size()) {
+        rank = sorted_.size() - 1;
+    }
+    return (sorted_[rank]);
+}
+
+void
+BenchmarkPhase::report(ostream& os) const {
+    os << left << setw(10) << name_ << right
+       << " packets: " << setw(8) << latencies_.size()
+       << fixed << setprecision(1)
+       << "  rate: " << setw(10) << getThroughput() << " pkt/s"
+       << "  latency (us) p50: " << setw(8) << toUsec(getPercentile(50))
+       << " p90: " << setw(8) << toUsec(getPercentile(90))
+       << " p99: " << setw(8) << toUsec(getPercentile(99))
+       << " max: " << setw(8) << toUsec(getPercentile(100))
+       << endl;
+    // The counters are maintained only in the debug builds.
+    if (counters_.requests_ > 0) {
+        os << left << setw(10) << "" << right
+           << " pool requests: " << counters_.requests_
+           << "  heap allocations: " << counters_.heap_allocations_
+           << "  heap releases: " << counters_.heap_releases_
+           << endl;
+    }
+}
+
+bool
+parseBenchmarkParams(const string& program, int argc, char* argv[],
+                     BenchmarkParams& params) {
+    int ch;
+    try {
+        while ((ch = getopt(argc, argv, "s:c:r:l:t:a:")) != -1) {
+            switch (ch) {
+            case 's':
+                params.subnets_ = parseArg("-s", optarg);
+                break;
+            case 'c':
+                params.clients_ = parseArg("-c", optarg);
+                break;
+            case 'r':
+                params.reservations_ = parseArg("-r", optarg);
+                break;
+            case 'l':
+                params.leases_ = parseArg("-l", optarg);
+                break;
+            case 't':
+                params.threads_ = parseArg("-t", optarg);
+                break;
+            case 'a':
+                params.allocator_ = optarg;
+                break;
+            default:
+                isc_throw(BadValue, "unsupported option");
+            }
+        }
+        if (optind < argc) {
+            isc_throw(BadValue, "extraneous argument " << argv[optind]);
+        }
+        if ((params.subnets_ == 0) || (params.clients_ == 0)) {
+            isc_throw(BadValue, "the numbers of subnets and clients must be"
+                      " greater than 0");
+        }
+        if (params.reservations_ > params.clients_) {
+            isc_throw(BadValue, "the number of reservations must not exceed"
+                      " the number of clients");
+        }
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl
+             << "Usage: " << program << " [-s subnets] [-c clients]"
+             << " [-r reservations] [-l leases] [-t threads] [-a allocator]" << endl
+             << "  -s: number of subnets (default 10)" << endl
+             << "  -c: number of clients (default 10000)" << endl
+             << "  -r: number of clients with a reservation (default 0)" << endl
+             << "  -l: number of leases of other clients stored before"
+             << " the run (default 0)" << endl
+             << "  -t: thread pool size, 0 disables multi-threading (default 0)" << endl
+             << "  -a: allocator: iterative, random, flq or bitmap"
+             << " (default iterative)" << endl;
+        return (false);
+    }
+    return (true);
+}
+
+void
+printBenchmarkParams(ostream& os, const BenchmarkParams& params) {
+    os << "subnets: " << params.subnets_
+       << ", clients: " << params.clients_
+       << ", reservations: " << params.reservations_
+       << ", leases: " << params.leases_
+       << ", threads: " << params.threads_
+       << ", allocator: " << params.allocator_ << endl;
+}
+
+} // end of namespace isc::test
+} // end of namespace isc
@@ -0,0 +1,139 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <util/memory_pool.h>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace test {
+
+/// @brief Records the latencies of a benchmark phase and reports them.
+///
+/// A phase processes a fixed number of packets. Each packet latency is
+/// recorded in its own slot so several threads can record latencies of
+/// distinct packets without locking. The phase duration is measured
+/// between the @c start and @c stop calls and gives the throughput.
+/// In the debug builds, the allocation counters of the memory pools are
+/// reported too.
+class BenchmarkPhase {
+public:
+
+    /// @brief Type of the clock used by the benchmarks.
+    typedef std::chrono::steady_clock Clock;
+
+    /// @brief Constructor.
+    ///
+    /// @param name name of the phase, e.g. "DISCOVER".
+    /// @param count number of packets processed in the phase.
+    BenchmarkPhase(const std::string& name, size_t count);
+
+    /// @brief Starts the phase timer.
+    void start();
+
+    /// @brief Stops the phase timer.
+    void stop();
+
+    /// @brief Records the latency of a packet.
+    ///
+    /// @param index index of the packet in the phase.
+    /// @param latency packet processing duration.
+    void record(size_t index, const Clock::duration& latency) {
+        latencies_[index] = latency;
+    }
+
+    /// @brief Returns the number of packets per second.
+    double getThroughput() const;
+
+    /// @brief Returns a latency percentile.
+    ///
+    /// @param percent the percentile between 0 and 100.
+    /// @return the latency under which the given percent of packets were
+    /// processed.
+    Clock::duration getPercentile(double percent) const;
+
+    /// @brief Prints a one line summary of the phase.
+    ///
+    /// @param os the output stream.
+    void report(std::ostream& os) const;
+
+private:
+
+    /// @brief Name of the phase.
+    std::string name_;
+
+    /// @brief Latencies of the packets.
+    std::vector<Clock::duration> latencies_;
+
+    /// @brief Start time of the phase.
+    Clock::time_point start_;
+
+    /// @brief Duration of the phase.
+    Clock::duration duration_;
+
+    /// @brief Sorted latencies, computed when the phase is stopped.
+    std::vector<Clock::duration> sorted_;
+
+    /// @brief Memory pool counters, collected when the phase is stopped.
+    isc::util::MemoryPoolCounters counters_;
+};
+
+/// @brief Parameters of the in-process server benchmarks.
+struct BenchmarkParams {
+    /// @brief Constructor setting the default values.
+    BenchmarkParams()
+        : subnets_(10), clients_(10000), reservations_(0), leases_(0),
+          threads_(0), allocator_("iterative") {
+    }
+
+    /// @brief Number of subnets.
+    uint32_t subnets_;
+
+    /// @brief Number of simulated clients.
+    uint32_t clients_;
+
+    /// @brief Number of clients having a reservation.
+    uint32_t reservations_;
+
+    /// @brief Number of leases of other clients stored before the run.
+    uint32_t leases_;
+
+    /// @brief Thread pool size, 0 disables multi-threading.
+    uint32_t threads_;
+
+    /// @brief Allocator type.
+    std::string allocator_;
+};
+
+/// @brief Parses the benchmark command line.
+///
+/// It prints the usage on the standard error when the command line is
+/// invalid.
+///
+/// @param program name of the benchmark program.
+/// @param argc number of arguments.
+/// @param argv arguments.
+/// @param [out] params parsed parameters.
+/// @return true if the command line is valid, false otherwise.
+bool parseBenchmarkParams(const std::string& program, int argc, char* argv[],
+                          BenchmarkParams& params);
+
+/// @brief Prints the benchmark parameters.
+///
+/// @param os the output stream.
+/// @param params benchmark parameters.
+void printBenchmarkParams(std::ostream& os, const BenchmarkParams& params);
+
+} // end of namespace isc::test
+} // end of namespace isc
+
+#endif // BENCHMARK_UTILS_H
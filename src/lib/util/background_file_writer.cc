@@ -0,0 +1,163 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/background_file_writer.h>
+#include <boost/make_shared.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <unistd.h>
+
+namespace isc {
+namespace util {
+
+const size_t BackgroundFileWriter::BATCH_SIZE = 65536;
+
+BackgroundFileWriter::BackgroundFileWriter(const std::string& filename,
+                                           uint32_t flush_interval,
+                                           bool sync)
+    : filename_(filename), fd_(-1), flush_interval_(flush_interval),
+      sync_(sync), mutex_(), work_cv_(), done_cv_(), pending_(), queued_(0),
+      written_(0), flushing_(0), stopping_(false), error_(), thread_() {
+    fd_ = ::open(filename_.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd_ < 0) {
+        isc_throw(Unexpected, "unable to open '" << filename_
+                  << "' for writing: " << std::strerror(errno));
+    }
+    thread_ = boost::make_shared<std::thread>(&BackgroundFileWriter::run, this);
+}
+
+BackgroundFileWriter::~BackgroundFileWriter() {
+    stop();
+}
+
+void
+BackgroundFileWriter::write(const std::string& data) {
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_.empty()) {
+            // Drop the data until the error has been retrieved.
+            return;
+        }
+        notify = pending_.empty();
+        pending_.append(data);
+        queued_ += data.size();
+        notify = notify || (pending_.size() >= BATCH_SIZE);
+    }
+    if (notify) {
+        work_cv_.notify_one();
+    }
+}
+
+void
+BackgroundFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!thread_ || stopping_) {
+        return;
+    }
+    uint64_t target = queued_;
+    ++flushing_;
+    work_cv_.notify_one();
+    done_cv_.wait(lock, [this, target]() { return (written_ >= target); });
+    --flushing_;
+}
+
+void
+BackgroundFileWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    work_cv_.notify_one();
+    thread_->join();
+    thread_.reset();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+std::string
+BackgroundFileWriter::getError() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string error;
+    error.swap(error_);
+    return (error);
+}
+
+void
+BackgroundFileWriter::run() {
+    std::string batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]() {
+                return (!pending_.empty() || stopping_);
+            });
+            // Give the data some time to accumulate unless a batch is
+            // full, the data is waited for or the writer is stopping.
+            if (flush_interval_ > 0) {
+                work_cv_.wait_for(lock, std::chrono::milliseconds(flush_interval_),
+                                  [this]() {
+                    return (stopping_ || (flushing_ > 0) ||
+                            (pending_.size() >= BATCH_SIZE));
+                });
+            }
+            if (pending_.empty() && stopping_) {
+                return;
+            }
+            batch.swap(pending_);
+        }
+
+        std::string error = writeBatch(batch);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            written_ += batch.size();
+            if (!error.empty() && error_.empty()) {
+                error_ = error;
+            }
+        }
+        done_cv_.notify_all();
+        batch.clear();
+    }
+}
+
+std::string
+BackgroundFileWriter::writeBatch(const std::string& batch) {
+    const char* data = batch.data();
+    size_t left = batch.size();
+    while (left > 0) {
+        ssize_t count = ::write(fd_, data, left);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::ostringstream s;
+            s << "failed to write to '" << filename_ << "': "
+              << std::strerror(errno);
+            return (s.str());
+        }
+        data += count;
+        left -= count;
+    }
+    if (sync_ && (::fsync(fd_) != 0)) {
+        std::ostringstream s;
+        s << "failed to synchronize '" << filename_ << "': "
+          << std::strerror(errno);
+        return (s.str());
+    }
+    return (std::string());
+}
+
+} // end of isc::util namespace
+} // end of isc namespace
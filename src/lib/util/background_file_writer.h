@@ -0,0 +1,140 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BACKGROUND_FILE_WRITER_H
+#define BACKGROUND_FILE_WRITER_H
+
+#include <exceptions/exceptions.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace isc {
+namespace util {
+
+/// @brief Appends data to a file from a dedicated thread.
+///
+/// The data passed to @c write is accumulated in a memory buffer which
+/// the writer thread appends to the file using large @c write calls.
+/// The buffer is written when the flush interval expires or earlier when
+/// it grows over @c BATCH_SIZE, so the callers never wait for the file
+/// system. A flush interval of 0 makes the thread write the data as soon
+/// as it is available, batching what accumulated during the previous write.
+///
+/// When the synchronization is enabled, each batch is followed by an
+/// @c fsync call, which makes the data durable when the batch
+/// completes, at a higher cost.
+///
+/// Write errors can't be reported to the caller of @c write. The first
+/// error is recorded and returned by @c getError, and the subsequent
+/// data is dropped until the error is retrieved.
+class BackgroundFileWriter : public boost::noncopyable {
+public:
+
+    /// @brief Size of the buffered data waking up the writer thread.
+    static const size_t BATCH_SIZE;
+
+    /// @brief Constructor.
+    ///
+    /// Opens the file in the append mode and starts the writer thread.
+    ///
+    /// @param filename name of the file.
+    /// @param flush_interval maximum time in milliseconds the data remains
+    /// in the buffer.
+    /// @param sync synchronize the file after each batch.
+    /// @throw Unexpected if the file can't be opened.
+    BackgroundFileWriter(const std::string& filename, uint32_t flush_interval,
+                         bool sync);
+
+    /// @brief Destructor.
+    ///
+    /// Writes the remaining data and stops the thread.
+    ~BackgroundFileWriter();
+
+    /// @brief Queues data to be appended to the file.
+    ///
+    /// @param data the data.
+    void write(const std::string& data);
+
+    /// @brief Waits until all the queued data has been written.
+    void flush();
+
+    /// @brief Writes the remaining data, stops the thread and closes the
+    /// file.
+    ///
+    /// It is a no-op when the writer is already stopped.
+    void stop();
+
+    /// @brief Returns and clears the first write error.
+    ///
+    /// @return error description or an empty string if there was no error.
+    std::string getError();
+
+private:
+
+    /// @brief The writer thread function.
+    void run();
+
+    /// @brief Appends a batch to the file.
+    ///
+    /// @param batch data to be written.
+    /// @return error description or an empty string on success.
+    std::string writeBatch(const std::string& batch);
+
+    /// @brief Name of the file.
+    std::string filename_;
+
+    /// @brief File descriptor.
+    int fd_;
+
+    /// @brief Flush interval in milliseconds.
+    uint32_t flush_interval_;
+
+    /// @brief Synchronize the file after each batch.
+    bool sync_;
+
+    /// @brief Mutex protecting the members below.
+    std::mutex mutex_;
+
+    /// @brief Condition variable waking up the writer thread.
+    std::condition_variable work_cv_;
+
+    /// @brief Condition variable signaling written batches.
+    std::condition_variable done_cv_;
+
+    /// @brief Data waiting to be written.
+    std::string pending_;
+
+    /// @brief Number of bytes queued since the creation.
+    uint64_t queued_;
+
+    /// @brief Number of bytes written (or dropped) since the creation.
+    uint64_t written_;
+
+    /// @brief Number of threads waiting in @c flush.
+    unsigned flushing_;
+
+    /// @brief Flag instructing the thread to terminate.
+    bool stopping_;
+
+    /// @brief First write error, if any.
+    std::string error_;
+
+    /// @brief The writer thread.
+    boost::shared_ptr<std::thread> thread_;
+};
+
+/// @brief Pointer to the @c BackgroundFileWriter.
+typedef boost::shared_ptr<BackgroundFileWriter> BackgroundFileWriterPtr;
+
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // BACKGROUND_FILE_WRITER_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2009-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,6 +9,7 @@
 
 #include <stdlib.h>
 #include <cstring>
+#include <utility>
 #include <vector>
 
 #include <stdint.h>
@@ -385,6 +386,17 @@ public:
         return (*this);
     }
 
+    /// \brief Exchange the contents with another buffer.
+    ///
+    /// No memory is allocated or copied.
+    ///
+    /// \param other The buffer to exchange the contents with.
+    void swap(OutputBuffer& other) {
+        std::swap(buffer_, other.buffer_);
+        std::swap(size_, other.size_);
+        std::swap(allocated_, other.allocated_);
+    }
+
     ///
     /// \name Getter Methods
     ///
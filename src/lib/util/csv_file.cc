@@ -112,7 +112,8 @@ CSVRow::checkIndex(const size_t at) const {
 }
 
 CSVFile::CSVFile(const std::string& filename)
-    : filename_(filename), fs_(), cols_(0), read_msg_() {
+    : filename_(filename), fs_(), cols_(0), read_msg_(), write_behind_(false),
+      write_behind_interval_(0), write_behind_sync_(false), writer_() {
 }
 
 CSVFile::~CSVFile() {
@@ -121,6 +122,11 @@ CSVFile::~CSVFile() {
 
 void
 CSVFile::close() {
+    // Write the pending rows.
+    if (writer_) {
+        writer_->stop();
+        writer_.reset();
+    }
     // It is allowed to close multiple times. If file has been already closed,
     // this is no-op.
     if (fs_) {
@@ -140,9 +146,25 @@ CSVFile::exists() const {
 void
 CSVFile::flush() const {
     checkStreamStatusAndReset("flush");
+    if (writer_) {
+        writer_->flush();
+    }
     fs_->flush();
 }
 
+void
+CSVFile::setWriteBehind(const bool enabled, const uint32_t flush_interval,
+                        const bool sync) {
+    // The new settings are used by the next writer.
+    if (writer_) {
+        writer_->stop();
+        writer_.reset();
+    }
+    write_behind_ = enabled;
+    write_behind_interval_ = flush_interval;
+    write_behind_sync_ = sync;
+}
+
 void
 CSVFile::addColumn(const std::string& col_name) {
     // It is not allowed to add a new column when file is open.
@@ -173,6 +195,29 @@ CSVFile::append(const CSVRow& row) const {
                   " columns in the CSV file '" << getColumnCount() << "'");
     }
 
+    if (write_behind_) {
+        if (!writer_) {
+            // Make sure the header is written before the rows.
+            fs_->flush();
+            try {
+                writer_.reset(new BackgroundFileWriter(filename_,
+                                                       write_behind_interval_,
+                                                       write_behind_sync_));
+            } catch (const std::exception& ex) {
+                isc_throw(CSVFileError, ex.what());
+            }
+        }
+        // Report the error of a previous write.
+        std::string error = writer_->getError();
+        if (!error.empty()) {
+            isc_throw(CSVFileError, error);
+        }
+        std::string text = row.render();
+        text.push_back('\n');
+        writer_->write(text);
+        return;
+    }
+
     /// @todo Apparently, seekp and seekg are interchangeable. A call to seekp
     /// results in moving the input pointer too. This is ok for now. It means
     /// that when the append() is called, the read pointer is moved to the EOF.
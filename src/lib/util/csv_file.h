@@ -8,6 +8,7 @@
 #define CSV_FILE_H
 
 #include <exceptions/exceptions.h>
+#include <util/background_file_writer.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/shared_ptr.hpp>
 #include <fstream>
@@ -386,6 +387,9 @@ public:
     void append(const CSVRow& row) const;
 
     /// @brief Closes the CSV file.
+    ///
+    /// In the write-behind mode, the rows waiting to be written are
+    /// written before the file is closed.
     void close();
 
     /// @brief Checks if the CSV file exists and can be opened for reading.
@@ -397,6 +401,9 @@ public:
     bool exists() const;
 
     /// @brief Flushes a file.
+    ///
+    /// In the write-behind mode, it waits until the appended rows have
+    /// been written.
     void flush() const;
 
     /// @brief Returns the number of columns in the file.
@@ -487,6 +494,27 @@ public:
         read_msg_ = read_msg;
     }
 
+    /// @brief Configures the write-behind mode.
+    ///
+    /// In the write-behind mode the @c append function only renders the
+    /// row and queues it to a @c BackgroundFileWriter, which appends the
+    /// rows to the file in batches from a dedicated thread. The writer is
+    /// started by the first append after the file has been opened and
+    /// stopped when the file is closed. As the writes are asynchronous,
+    /// a write error is reported by the next call to @c append.
+    ///
+    /// @param enabled enables or disables the write-behind mode.
+    /// @param flush_interval maximum time in milliseconds the rows remain
+    /// in memory.
+    /// @param sync synchronize the file after each batch of rows.
+    void setWriteBehind(const bool enabled, const uint32_t flush_interval = 0,
+                        const bool sync = false);
+
+    /// @brief Checks if the write-behind mode is enabled.
+    bool getWriteBehind() const {
+        return (write_behind_);
+    }
+
     /// @brief Represents empty row.
     static CSVRow EMPTY_ROW() {
         static CSVRow row(0);
@@ -567,6 +595,18 @@ private:
 
     /// @brief Holds last error during row reading or validation.
     std::string read_msg_;
+
+    /// @brief Write-behind mode flag.
+    bool write_behind_;
+
+    /// @brief Write-behind flush interval in milliseconds.
+    uint32_t write_behind_interval_;
+
+    /// @brief Write-behind synchronization flag.
+    bool write_behind_sync_;
+
+    /// @brief The writer used in the write-behind mode.
+    mutable BackgroundFileWriterPtr writer_;
 };
 
 } // namespace isc::util
@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2009-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,6 +7,7 @@
 #ifndef BASE64_H
 #define BASE64_H 1
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -36,6 +37,17 @@ namespace encode {
 /// \return A newly created string that stores base64 encoded value for binary.
 std::string encodeBase64(const std::vector<uint8_t>& binary);
 
+/// \brief Append the base64 encoding of binary data to a string.
+///
+/// This is the table based encoder behind \c encodeBase64, usable on a
+/// raw buffer. The string is grown once, so a caller building a larger
+/// text can reserve it beforehand.
+///
+/// \param data A pointer to the data to be encoded.
+/// \param length The length of the data.
+/// \param output The string the encoded text is appended to.
+void appendBase64(const uint8_t* data, size_t length, std::string& output);
+
 /// \brief Decode a text encoded in the base64 format into the original %data.
 ///
 /// The \c input argument must be a valid string represented in the base64
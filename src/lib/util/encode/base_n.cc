@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 #include <util/encode/binary_from_base16.h>
 #include <util/encode/base32hex.h>
 #include <util/encode/base64.h>
+#include <util/encode/hex.h>
 
 #include <exceptions/exceptions.h>
 #include <exceptions/isc_assert.h>
@@ -27,6 +28,7 @@
 
 #include <stdint.h>
 #include <stdexcept>
+#include <cstring>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -457,16 +459,177 @@ typedef
 transform_width<binary_from_base16<DecodeNormalizer>, 8, 4> base16_decoder;
 typedef BaseNTransformer<4, '0', base16_encoder, base16_decoder>
 Base16Transformer;
+
+// The iterator based transformers above are generic but slow. The base16
+// and base64 codecs, which are used for every lease and identifier, also
+// have table based implementations. The decoders handle the common case
+// of a well formed input without spaces and return false otherwise, so
+// the generic decoder can accept the spaces or report the error.
+const char HEX_UPPER_CHARS[] = "0123456789ABCDEF";
+const char HEX_LOWER_CHARS[] = "0123456789abcdef";
+const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Value returned by the decoding tables for characters out of the alphabet.
+const uint8_t INVALID_CODE = 0xff;
+
+// Maps the characters to their values in the base16 and base64 alphabets.
+struct DecodeTables {
+    DecodeTables() {
+        memset(hex_, INVALID_CODE, sizeof(hex_));
+        memset(base64_, INVALID_CODE, sizeof(base64_));
+        for (uint8_t i = 0; i < 16; ++i) {
+            hex_[static_cast<uint8_t>(HEX_UPPER_CHARS[i])] = i;
+            hex_[static_cast<uint8_t>(HEX_LOWER_CHARS[i])] = i;
+        }
+        for (uint8_t i = 0; i < 64; ++i) {
+            base64_[static_cast<uint8_t>(BASE64_CHARS[i])] = i;
+        }
+    }
+    uint8_t hex_[256];
+    uint8_t base64_[256];
+};
+
+const DecodeTables&
+getDecodeTables() {
+    static const DecodeTables tables;
+    return (tables);
+}
+
+bool
+fastDecodeHex(const string& input, vector<uint8_t>& result) {
+    if ((input.size() % 2) != 0) {
+        return (false);
+    }
+    const uint8_t* const table = getDecodeTables().hex_;
+    const uint8_t* const in = reinterpret_cast<const uint8_t*>(input.data());
+    const size_t len = input.size() / 2;
+    result.resize(len);
+    for (size_t i = 0; i < len; ++i) {
+        const uint8_t high = table[in[2 * i]];
+        const uint8_t low = table[in[2 * i + 1]];
+        if (((high | low) & 0xf0) != 0) {
+            return (false);
+        }
+        result[i] = (high << 4) | low;
+    }
+    return (true);
+}
+
+bool
+fastDecodeBase64(const string& input, vector<uint8_t>& result) {
+    const size_t size = input.size();
+    if ((size % 4) != 0) {
+        return (false);
+    }
+    size_t padchars = 0;
+    if ((size > 0) && (input[size - 1] == BASE_PADDING_CHAR)) {
+        ++padchars;
+        if (input[size - 2] == BASE_PADDING_CHAR) {
+            ++padchars;
+        }
+    }
+    const uint8_t* const table = getDecodeTables().base64_;
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+    result.resize(size / 4 * 3 - padchars);
+    uint8_t* out = result.data();
+    // Full groups.
+    const size_t groups = (size / 4) - (padchars > 0 ? 1 : 0);
+    for (size_t i = 0; i < groups; ++i, in += 4, out += 3) {
+        const uint8_t a = table[in[0]];
+        const uint8_t b = table[in[1]];
+        const uint8_t c = table[in[2]];
+        const uint8_t d = table[in[3]];
+        if (((a | b | c | d) & 0xc0) != 0) {
+            return (false);
+        }
+        out[0] = (a << 2) | (b >> 4);
+        out[1] = (b << 4) | (c >> 2);
+        out[2] = (c << 6) | d;
+    }
+    // Last group with padding: the unused bits must be 0 (canonical form).
+    if (padchars == 1) {
+        const uint8_t a = table[in[0]];
+        const uint8_t b = table[in[1]];
+        const uint8_t c = table[in[2]];
+        if ((((a | b | c) & 0xc0) != 0) || ((c & 0x03) != 0)) {
+            return (false);
+        }
+        out[0] = (a << 2) | (b >> 4);
+        out[1] = (b << 4) | (c >> 2);
+    } else if (padchars == 2) {
+        const uint8_t a = table[in[0]];
+        const uint8_t b = table[in[1]];
+        if ((((a | b) & 0xc0) != 0) || ((b & 0x0f) != 0)) {
+            return (false);
+        }
+        out[0] = (a << 2) | (b >> 4);
+    }
+    return (true);
+}
+}
+
+void
+appendHex(const uint8_t* data, size_t length, string& output,
+          char separator, bool upper) {
+    if (length == 0) {
+        return;
+    }
+    const char* const digits = (upper ? HEX_UPPER_CHARS : HEX_LOWER_CHARS);
+    const size_t step = (separator ? 3 : 2);
+    size_t pos = output.size();
+    output.resize(pos + length * step - (separator ? 1 : 0));
+    char* out = &output[pos];
+    for (size_t i = 0; i < length; ++i) {
+        if (separator && (i > 0)) {
+            *out++ = separator;
+        }
+        *out++ = digits[data[i] >> 4];
+        *out++ = digits[data[i] & 0x0f];
+    }
+}
+
+void
+appendBase64(const uint8_t* data, size_t length, string& output) {
+    size_t pos = output.size();
+    output.resize(pos + ((length + 2) / 3) * 4);
+    char* out = &output[pos];
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        const uint32_t group = (data[i] << 16) | (data[i + 1] << 8) |
+            data[i + 2];
+        *out++ = BASE64_CHARS[(group >> 18) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 12) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 6) & 0x3f];
+        *out++ = BASE64_CHARS[group & 0x3f];
+    }
+    if (i + 1 == length) {
+        const uint32_t group = data[i] << 16;
+        *out++ = BASE64_CHARS[(group >> 18) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 12) & 0x3f];
+        *out++ = BASE_PADDING_CHAR;
+        *out++ = BASE_PADDING_CHAR;
+    } else if (i + 2 == length) {
+        const uint32_t group = (data[i] << 16) | (data[i + 1] << 8);
+        *out++ = BASE64_CHARS[(group >> 18) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 12) & 0x3f];
+        *out++ = BASE64_CHARS[(group >> 6) & 0x3f];
+        *out++ = BASE_PADDING_CHAR;
+    }
 }
 
 string
 encodeBase64(const vector<uint8_t>& binary) {
-    return (Base64Transformer::encode(binary));
+    string result;
+    appendBase64(binary.data(), binary.size(), result);
+    return (result);
 }
 
 void
 decodeBase64(const string& input, vector<uint8_t>& result) {
-    Base64Transformer::decode("base64", input, result);
+    if (!fastDecodeBase64(input, result)) {
+        Base64Transformer::decode("base64", input, result);
+    }
 }
 
 string
@@ -481,12 +644,16 @@ decodeBase32Hex(const string& input, vector<uint8_t>& result) {
 
 string
 encodeHex(const vector<uint8_t>& binary) {
-    return (Base16Transformer::encode(binary));
+    string result;
+    appendHex(binary.data(), binary.size(), result);
+    return (result);
 }
 
 void
 decodeHex(const string& input, vector<uint8_t>& result) {
-    Base16Transformer::decode("base16", input, result);
+    if (!fastDecodeHex(input, result)) {
+        Base16Transformer::decode("base16", input, result);
+    }
 }
 
 } // namespace encode
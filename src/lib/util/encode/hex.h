@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2009-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,6 +7,7 @@
 #ifndef HEX_H
 #define HEX_H 1
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -33,6 +34,21 @@ namespace encode {
 /// binary.
 std::string encodeHex(const std::vector<uint8_t>& binary);
 
+/// \brief Append the base16 ('hex') encoding of binary data to a string.
+///
+/// This is the table based encoder behind \c encodeHex, usable on a raw
+/// buffer and optionally with a separator between the bytes, e.g. for
+/// the 01:02:0a text form of the identifiers. The string is grown once,
+/// so a caller building a larger text can reserve it beforehand.
+///
+/// \param data A pointer to the data to be encoded.
+/// \param length The length of the data.
+/// \param output The string the encoded text is appended to.
+/// \param separator The character inserted between the bytes, none if 0.
+/// \param upper Use upper case digits when true, lower case otherwise.
+void appendHex(const uint8_t* data, size_t length, std::string& output,
+               char separator = 0, bool upper = true);
+
 /// \brief Decode a text encoded in the base16 ('hex') format into the
 /// original %data.
 ///
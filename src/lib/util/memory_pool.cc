@@ -0,0 +1,361 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <util/memory_pool.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <new>
+
+using namespace std;
+
+namespace isc {
+namespace util {
+
+const size_t MemoryPool::ALIGNMENT = 16;
+
+const size_t MemoryPool::MAX_BLOCK_SIZE = 2048;
+
+const size_t BufferPool::MAX_CAPACITY = 65536;
+
+namespace {
+
+/// @brief Number of block size classes.
+const size_t CLASSES = MemoryPool::MAX_BLOCK_SIZE / MemoryPool::ALIGNMENT;
+
+/// @brief Maximum number of items in a thread local list.
+const size_t LOCAL_MAX = 64;
+
+/// @brief Number of items moved at once between a thread local list and
+/// the shared list.
+const size_t BATCH = LOCAL_MAX / 2;
+
+/// @brief Maximum number of items in a shared list.
+const size_t SHARED_MAX = 4096;
+
+/// @brief Capacity of the largest vector in the list of small vectors.
+const size_t SMALL_CAPACITY = 256;
+
+#ifdef ENABLE_DEBUG
+atomic<uint64_t> requests(0);
+atomic<uint64_t> heap_allocations(0);
+atomic<uint64_t> heap_releases(0);
+
+void countRequest() {
+    ++requests;
+}
+
+void countHeapAllocation() {
+    ++heap_allocations;
+}
+
+void countHeapRelease() {
+    ++heap_releases;
+}
+#else
+void countRequest() {
+}
+
+void countHeapAllocation() {
+}
+
+void countHeapRelease() {
+}
+#endif
+
+/// @brief The lists of recycled items.
+///
+/// The output buffers are kept in a deque because they are copied, not
+/// moved, when a vector grows.
+struct Lists {
+    /// @brief Free blocks per size class.
+    vector<void*> blocks_[CLASSES];
+
+    /// @brief Recycled small and large vectors.
+    vector<vector<uint8_t> > vectors_[2];
+
+    /// @brief Recycled output buffers.
+    deque<OutputBuffer> outputs_;
+};
+
+/// @brief The lists shared by all threads.
+struct SharedLists : public Lists {
+    /// @brief Mutex protecting the lists.
+    mutex mutex_;
+};
+
+/// @brief Returns the shared lists.
+///
+/// They are never destroyed as the items can be released by the
+/// destructors of static objects.
+SharedLists&
+getShared() {
+    static SharedLists* shared = new SharedLists();
+    return (*shared);
+}
+
+/// @brief Exchanges two items.
+template <typename Item>
+void swapItems(Item& first, Item& second) {
+    swap(first, second);
+}
+
+/// @brief Exchanges two output buffers.
+void swapItems(OutputBuffer& first, OutputBuffer& second) {
+    first.swap(second);
+}
+
+/// @brief Gives a block back to the heap.
+void dispose(void* ptr) {
+    countHeapRelease();
+    ::operator delete(ptr);
+}
+
+/// @brief Counts the buffers given back to the heap.
+template <typename Item>
+void dispose(const Item&) {
+    countHeapRelease();
+}
+
+/// @brief Moves items from the back of a list to another list.
+///
+/// @param to the destination list.
+/// @param from the source list.
+/// @param count the maximum number of items to move.
+/// @param empty the value of an empty item.
+template <typename List>
+void transfer(List& to, List& from, size_t count,
+              const typename List::value_type& empty) {
+    for (; (count > 0) && !from.empty(); --count) {
+        to.push_back(empty);
+        swapItems(to.back(), from.back());
+        from.pop_back();
+    }
+}
+
+/// @brief Gives the items over the limit of a shared list back to the heap.
+template <typename List>
+void trim(List& list) {
+    while (list.size() > SHARED_MAX) {
+        dispose(list.back());
+        list.pop_back();
+    }
+}
+
+/// @brief The lists of the current thread.
+struct LocalLists : public Lists {
+    /// @brief Destructor.
+    ///
+    /// Gives the items to the shared lists.
+    ~LocalLists();
+};
+
+/// @brief Set when the lists of the current thread have been destroyed.
+thread_local bool local_destroyed = false;
+
+LocalLists::~LocalLists() {
+    SharedLists& shared = getShared();
+    {
+        lock_guard<mutex> lk(shared.mutex_);
+        for (size_t i = 0; i < CLASSES; ++i) {
+            transfer(shared.blocks_[i], blocks_[i], blocks_[i].size(), 0);
+            trim(shared.blocks_[i]);
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            transfer(shared.vectors_[i], vectors_[i], vectors_[i].size(),
+                     vector<uint8_t>());
+            trim(shared.vectors_[i]);
+        }
+        transfer(shared.outputs_, outputs_, outputs_.size(), OutputBuffer(0));
+        trim(shared.outputs_);
+    }
+    local_destroyed = true;
+}
+
+/// @brief Returns the lists of the current thread.
+///
+/// @return the lists or null when the thread is terminating.
+LocalLists*
+getLocal() {
+    if (local_destroyed) {
+        return (0);
+    }
+    static thread_local LocalLists local;
+    return (&local);
+}
+
+/// @brief Takes an item from the lists.
+///
+/// @param local the thread local list or null.
+/// @param shared the shared list.
+/// @param item the item receiving the recycled one.
+/// @param empty the value of an empty item.
+/// @return true if an item was available.
+template <typename List>
+bool take(List* local, List& shared, typename List::value_type& item,
+          const typename List::value_type& empty) {
+    if (!local) {
+        lock_guard<mutex> lk(getShared().mutex_);
+        if (shared.empty()) {
+            return (false);
+        }
+        swapItems(item, shared.back());
+        shared.pop_back();
+        return (true);
+    }
+    if (local->empty()) {
+        lock_guard<mutex> lk(getShared().mutex_);
+        transfer(*local, shared, BATCH, empty);
+        if (local->empty()) {
+            return (false);
+        }
+    }
+    swapItems(item, local->back());
+    local->pop_back();
+    return (true);
+}
+
+/// @brief Gives an item to the lists.
+///
+/// @param local the thread local list or null.
+/// @param shared the shared list.
+/// @param item the recycled item, replaced by an empty one.
+/// @param empty the value of an empty item.
+template <typename List>
+void give(List* local, List& shared, typename List::value_type& item,
+          const typename List::value_type& empty) {
+    if (!local) {
+        lock_guard<mutex> lk(getShared().mutex_);
+        shared.push_back(empty);
+        swapItems(shared.back(), item);
+        trim(shared);
+        return;
+    }
+    local->push_back(empty);
+    swapItems(local->back(), item);
+    if (local->size() > LOCAL_MAX) {
+        lock_guard<mutex> lk(getShared().mutex_);
+        transfer(shared, *local, BATCH, empty);
+        trim(shared);
+    }
+}
+
+}
+
+void*
+MemoryPool::allocate(size_t size) {
+    countRequest();
+    if (size > MAX_BLOCK_SIZE) {
+        countHeapAllocation();
+        return (::operator new(size));
+    }
+    const size_t cls = (size > 0 ? (size - 1) / ALIGNMENT : 0);
+    LocalLists* local = getLocal();
+    void* ptr = 0;
+    if (take(local ? &local->blocks_[cls] : 0, getShared().blocks_[cls],
+             ptr, 0)) {
+        return (ptr);
+    }
+    countHeapAllocation();
+    return (::operator new((cls + 1) * ALIGNMENT));
+}
+
+void
+MemoryPool::deallocate(void* ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+    if (size > MAX_BLOCK_SIZE) {
+        dispose(ptr);
+        return;
+    }
+    const size_t cls = (size > 0 ? (size - 1) / ALIGNMENT : 0);
+    LocalLists* local = getLocal();
+    give(local ? &local->blocks_[cls] : 0, getShared().blocks_[cls], ptr, 0);
+}
+
+MemoryPoolCounters
+MemoryPool::getCounters() {
+    MemoryPoolCounters counters = { 0, 0, 0 };
+#ifdef ENABLE_DEBUG
+    counters.requests_ = requests;
+    counters.heap_allocations_ = heap_allocations;
+    counters.heap_releases_ = heap_releases;
+#endif
+    return (counters);
+}
+
+void
+MemoryPool::resetCounters() {
+#ifdef ENABLE_DEBUG
+    requests = 0;
+    heap_allocations = 0;
+    heap_releases = 0;
+#endif
+}
+
+void
+BufferPool::acquire(vector<uint8_t>& buffer, size_t size) {
+    countRequest();
+    const size_t idx = (size > SMALL_CAPACITY ? 1 : 0);
+    LocalLists* local = getLocal();
+    vector<uint8_t> item;
+    if (take(local ? &local->vectors_[idx] : 0, getShared().vectors_[idx],
+             item, vector<uint8_t>())) {
+        buffer.swap(item);
+        return;
+    }
+    countHeapAllocation();
+}
+
+void
+BufferPool::release(vector<uint8_t>& buffer) {
+    if (buffer.capacity() == 0) {
+        return;
+    }
+    if (buffer.capacity() > MAX_CAPACITY) {
+        dispose(buffer);
+        return;
+    }
+    buffer.clear();
+    const size_t idx = (buffer.capacity() > SMALL_CAPACITY ? 1 : 0);
+    LocalLists* local = getLocal();
+    give(local ? &local->vectors_[idx] : 0, getShared().vectors_[idx], buffer,
+         vector<uint8_t>());
+}
+
+void
+BufferPool::acquire(OutputBuffer& buffer) {
+    countRequest();
+    LocalLists* local = getLocal();
+    OutputBuffer item(0);
+    if (take(local ? &local->outputs_ : 0, getShared().outputs_, item,
+             OutputBuffer(0))) {
+        buffer.swap(item);
+        return;
+    }
+    countHeapAllocation();
+}
+
+void
+BufferPool::release(OutputBuffer& buffer) {
+    if (buffer.getCapacity() == 0) {
+        return;
+    }
+    if (buffer.getCapacity() > MAX_CAPACITY) {
+        dispose(buffer);
+        return;
+    }
+    buffer.clear();
+    LocalLists* local = getLocal();
+    give(local ? &local->outputs_ : 0, getShared().outputs_, buffer,
+         OutputBuffer(0));
+}
+
+} // end of isc::util namespace
+} // end of isc namespace
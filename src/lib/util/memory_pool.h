@@ -0,0 +1,180 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <util/buffer.h>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace util {
+
+/// @brief Allocation counters of the memory pools.
+///
+/// The counters are maintained only when Kea is configured with
+/// --enable-debug, they remain 0 otherwise.
+struct MemoryPoolCounters {
+    /// @brief Number of blocks and buffers requested from the pools.
+    uint64_t requests_;
+
+    /// @brief Number of requests which were served by the heap.
+    uint64_t heap_allocations_;
+
+    /// @brief Number of blocks and buffers given back to the heap.
+    uint64_t heap_releases_;
+};
+
+/// @brief Recycles small memory blocks.
+///
+/// The blocks are grouped in size classes which are multiples of
+/// @c ALIGNMENT up to @c MAX_BLOCK_SIZE; larger requests go directly to
+/// the heap. Each thread keeps the released blocks in a local free list
+/// and exchanges them in batches with a shared depot, so a block
+/// allocated by the thread receiving the packets and released by a
+/// worker thread is reused. The number of blocks kept per size class is
+/// bounded, the excess is given back to the heap.
+class MemoryPool {
+public:
+
+    /// @brief Granularity of the size classes.
+    static const size_t ALIGNMENT;
+
+    /// @brief Size of the largest pooled block.
+    static const size_t MAX_BLOCK_SIZE;
+
+    /// @brief Allocates a block.
+    ///
+    /// @param size size of the block.
+    /// @return the block.
+    /// @throw std::bad_alloc if the memory is exhausted.
+    static void* allocate(size_t size);
+
+    /// @brief Releases a block.
+    ///
+    /// @param ptr the block returned by @c allocate.
+    /// @param size the size given to @c allocate.
+    static void deallocate(void* ptr, size_t size);
+
+    /// @brief Returns the allocation counters of the pools.
+    static MemoryPoolCounters getCounters();
+
+    /// @brief Resets the allocation counters of the pools.
+    static void resetCounters();
+};
+
+/// @brief Standard allocator getting its memory from the @c MemoryPool.
+///
+/// @tparam T type of the allocated objects.
+template <typename T>
+class PoolAllocator {
+public:
+
+    /// @brief Type of the allocated objects.
+    typedef T value_type;
+
+    /// @brief Constructor.
+    PoolAllocator() {
+    }
+
+    /// @brief Converting constructor.
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {
+    }
+
+    /// @brief Allocates memory for objects.
+    ///
+    /// @param n number of objects.
+    /// @return uninitialized memory for the objects.
+    T* allocate(size_t n) {
+        return (static_cast<T*>(MemoryPool::allocate(n * sizeof(T))));
+    }
+
+    /// @brief Releases memory.
+    ///
+    /// @param ptr the memory returned by @c allocate.
+    /// @param n the number of objects given to @c allocate.
+    void deallocate(T* ptr, size_t n) {
+        MemoryPool::deallocate(ptr, n * sizeof(T));
+    }
+};
+
+/// @brief All pool allocators are equal.
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return (true);
+}
+
+/// @brief All pool allocators are equal.
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return (false);
+}
+
+/// @brief Creates an object managed by a shared pointer in the memory pool.
+///
+/// The object and the reference counters share a single pooled block,
+/// which is recycled when the last reference is released.
+///
+/// @tparam T type of the object.
+/// @param args arguments of the constructor.
+/// @return shared pointer to the new object.
+template <typename T, typename... Args>
+boost::shared_ptr<T> makePooled(Args&&... args) {
+    return (boost::allocate_shared<T>(PoolAllocator<T>(),
+                                      std::forward<Args>(args)...));
+}
+
+/// @brief Recycles the storage of the byte buffers.
+///
+/// The packets and the options get the storage of their buffers from
+/// this pool and give it back when they are destroyed, so the buffers
+/// are not reallocated for each packet. The storage is exchanged between
+/// the threads like the blocks of the @c MemoryPool. Buffers larger than
+/// @c MAX_CAPACITY are not kept.
+class BufferPool {
+public:
+
+    /// @brief Capacity of the largest recycled buffer.
+    static const size_t MAX_CAPACITY;
+
+    /// @brief Gives recycled storage to an empty buffer.
+    ///
+    /// The small and large buffers are kept apart so the storage given
+    /// for the expected size is usually large enough. The buffer is left
+    /// unchanged when no storage is available.
+    ///
+    /// @param buffer the empty buffer.
+    /// @param size the expected size of the buffer.
+    static void acquire(std::vector<uint8_t>& buffer, size_t size);
+
+    /// @brief Takes the storage of a buffer for recycling.
+    ///
+    /// @param buffer the buffer which is left empty.
+    static void release(std::vector<uint8_t>& buffer);
+
+    /// @brief Gives recycled storage to an empty output buffer.
+    ///
+    /// The buffer is left unchanged when no storage is available.
+    ///
+    /// @param buffer the empty buffer.
+    static void acquire(OutputBuffer& buffer);
+
+    /// @brief Takes the storage of an output buffer for recycling.
+    ///
+    /// @param buffer the buffer which is left empty.
+    static void release(OutputBuffer& buffer);
+};
+
+} // end of isc::util namespace
+} // end of isc namespace
+
+#endif // MEMORY_POOL_H
@@ -104,13 +104,19 @@ MultiThreadingMgr::setPacketQueueSize(uint32_t size) {
     thread_pool_.setMaxQueueSize(size);
 }
 
+bool
+MultiThreadingMgr::getClientAffinity() const {
+    return (thread_pool_.getAffinity());
+}
+
 uint32_t
 MultiThreadingMgr::detectThreadCount() {
     return (std::thread::hardware_concurrency());
 }
 
 void
-MultiThreadingMgr::apply(bool enabled, uint32_t thread_count, uint32_t queue_size) {
+MultiThreadingMgr::apply(bool enabled, uint32_t thread_count, uint32_t queue_size,
+                         bool client_affinity) {
     // check the enabled flag
     if (enabled) {
         // check for auto scaling (enabled flag true but thread_count 0)
@@ -128,6 +134,7 @@ MultiThreadingMgr::apply(bool enabled, uint32_t thread_count, uint32_t queue_siz
         if (thread_pool_.size()) {
             thread_pool_.stop();
         }
+        thread_pool_.setAffinity(client_affinity);
         setThreadPoolSize(thread_count);
         setPacketQueueSize(queue_size);
         setMode(true);
@@ -137,6 +144,7 @@ MultiThreadingMgr::apply(bool enabled, uint32_t thread_count, uint32_t queue_siz
     } else {
         removeAllCriticalSectionCallbacks();
         thread_pool_.reset();
+        thread_pool_.setAffinity(false);
         setMode(false);
         setThreadPoolSize(thread_count);
         setPacketQueueSize(queue_size);
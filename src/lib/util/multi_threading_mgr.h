@@ -212,6 +212,14 @@ public:
     /// @param size The dhcp packet queue size.
     void setPacketQueueSize(uint32_t size);
 
+    /// @brief Get the client affinity mode of the dhcp thread pool.
+    ///
+    /// In client affinity mode the packets of a client are always
+    /// processed by the same thread of the dhcp thread pool.
+    ///
+    /// @return true if the client affinity mode is enabled, false otherwise.
+    bool getClientAffinity() const;
+
     /// @brief The system current detected hardware concurrency thread count.
     ///
     /// This function will return 0 if the value can not be determined.
@@ -231,7 +239,10 @@ public:
     /// configured, 0 if auto scaling is desired
     /// @param queue_size The desired thread queue size: non 0 if explicitly
     /// configured, 0 for unlimited size
-    void apply(bool enabled, uint32_t thread_count, uint32_t queue_size);
+    /// @param client_affinity The client affinity flag: true if the packets
+    /// of a client must be processed by the same thread, false otherwise.
+    void apply(bool enabled, uint32_t thread_count, uint32_t queue_size,
+               bool client_affinity = false);
 
     /// @brief Adds a set of callbacks to the list of CriticalSection callbacks.
     ///
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2022 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -225,6 +225,7 @@ decodeSeparatedHexString(const std::string& hex_string, const std::string& sep,
                  boost::algorithm::token_compress_off);
 
     std::vector<uint8_t> binary_vec;
+    binary_vec.reserve(split_text.size());
     for (size_t i = 0; i < split_text.size(); ++i) {
 
         // If there are multiple tokens and the current one is empty, it
@@ -240,25 +241,25 @@ decodeSeparatedHexString(const std::string& hex_string, const std::string& sep,
                       << " '" << hex_string << "'");
 
         } else if (!split_text[i].empty()) {
-            std::stringstream s;
-            s << "0x";
-
+            // Convert the one or two hexadecimal digits to a number and
+            // store it in a temporary vector.
+            unsigned int binary_value = 0;
             for (unsigned int j = 0; j < split_text[i].length(); ++j) {
+                const char digit = split_text[i][j];
                 // Check if we're dealing with hexadecimal digit.
-                if (!isxdigit(split_text[i][j])) {
-                    isc_throw(isc::BadValue, "'" << split_text[i][j]
+                if (!isxdigit(digit)) {
+                    isc_throw(isc::BadValue, "'" << digit
                               << "' is not a valid hexadecimal digit in"
                               << " decoded string '" << hex_string << "'");
                 }
-                s << split_text[i][j];
+                binary_value <<= 4;
+                if (isdigit(digit)) {
+                    binary_value |= digit - '0';
+                } else {
+                    binary_value |= tolower(digit) - 'a' + 10;
+                }
             }
 
-            // The stream should now have one or two hexadecimal digits.
-            // Let's convert it to a number and store in a temporary
-            // vector.
-            unsigned int binary_value;
-            s >> std::hex >> binary_value;
-
             binary_vec.push_back(static_cast<uint8_t>(binary_value));
         }
 
@@ -0,0 +1,117 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <util/background_file_writer.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Test fixture class for the @c BackgroundFileWriter.
+class BackgroundFileWriterTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates an empty test file.
+    BackgroundFileWriterTest()
+        : testfile_(std::string(TEST_DATA_BUILDDIR) + "/background.txt") {
+        std::ofstream fs(testfile_.c_str(), std::ofstream::out);
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Removes the test file.
+    virtual ~BackgroundFileWriterTest() {
+        static_cast<void>(remove(testfile_.c_str()));
+    }
+
+    /// @brief Reads the whole test file.
+    ///
+    /// @return Contents of the file.
+    std::string readFile() const {
+        std::ifstream fs(testfile_.c_str());
+        return (std::string((std::istreambuf_iterator<char>(fs)),
+                            std::istreambuf_iterator<char>()));
+    }
+
+    /// @brief Path to the test file.
+    std::string testfile_;
+};
+
+// Test that the data is appended to the file on flush and stop.
+TEST_F(BackgroundFileWriterTest, writeFlushStop) {
+    std::ofstream(testfile_.c_str()) << "header\n";
+    BackgroundFileWriter writer(testfile_, 10000, false);
+    writer.write("first\n");
+    writer.write("second\n");
+    // The flush does not wait for the interval to elapse.
+    writer.flush();
+    EXPECT_EQ("header\nfirst\nsecond\n", readFile());
+
+    writer.write("third\n");
+    writer.stop();
+    EXPECT_EQ("header\nfirst\nsecond\nthird\n", readFile());
+    // Stopping again is a no-op.
+    EXPECT_NO_THROW(writer.stop());
+    EXPECT_TRUE(writer.getError().empty());
+}
+
+// Test that the data is written without a flush after the interval.
+TEST_F(BackgroundFileWriterTest, interval) {
+    BackgroundFileWriter writer(testfile_, 1, true);
+    writer.write("data\n");
+    for (int i = 0; i < 1000; ++i) {
+        if (!readFile().empty()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ("data\n", readFile());
+}
+
+// Test that the data written concurrently is not lost nor interleaved.
+TEST_F(BackgroundFileWriterTest, concurrent) {
+    BackgroundFileWriter writer(testfile_, 0, false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&writer, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                std::ostringstream s;
+                s << t << "," << i << "\n";
+                writer.write(s.str());
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    writer.flush();
+    std::istringstream lines(readFile());
+    std::string line;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        ASSERT_NE(std::string::npos, line.find(','));
+        ++count;
+    }
+    EXPECT_EQ(4000, count);
+}
+
+// Test that a file which can't be opened is reported.
+TEST_F(BackgroundFileWriterTest, openError) {
+    EXPECT_THROW(BackgroundFileWriter("/no/such/dir/file.txt", 0, false),
+                 Unexpected);
+}
+
+} // end of anonymous namespace
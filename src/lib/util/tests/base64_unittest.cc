@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -90,4 +90,32 @@ TEST_F(Base64Test, encode) {
         EXPECT_EQ((*it).second, encodeBase64(decoded_data));
     }
 }
+
+TEST_F(Base64Test, appendBase64) {
+    for (vector<StringPair>::const_iterator it = test_sequence.begin();
+         it != test_sequence.end();
+         ++it) {
+        string text("prefix ");
+        appendBase64(reinterpret_cast<const uint8_t*>((*it).first.data()),
+                     (*it).first.size(), text);
+        EXPECT_EQ("prefix " + (*it).second, text);
+    }
+}
+
+// Check that the data survives the round trip for all lengths and all
+// byte values, with and without white spaces in the encoded text.
+TEST_F(Base64Test, roundTrip) {
+    vector<uint8_t> data;
+    for (size_t len = 0; len < 300; ++len) {
+        data.push_back(static_cast<uint8_t>(len * 7));
+        const string text = encodeBase64(data);
+        ASSERT_EQ((data.size() + 2) / 3 * 4, text.size());
+        decodeBase64(text, decoded_data);
+        EXPECT_TRUE(data == decoded_data);
+
+        string spaced = " " + text + "\n";
+        decodeBase64(spaced, decoded_data);
+        EXPECT_TRUE(data == decoded_data);
+    }
+}
 }
@@ -487,6 +487,56 @@ TEST_F(CSVFileTest, recreate) {
               readFile());
 }
 
+// This test checks that the rows are appended in the write-behind mode and
+// that the file can be closed and reopened.
+TEST_F(CSVFileTest, writeBehind) {
+    boost::scoped_ptr<CSVFile> csv(new CSVFile(testfile_));
+    csv->addColumn("animal");
+    csv->addColumn("color");
+    EXPECT_FALSE(csv->getWriteBehind());
+    csv->setWriteBehind(true, 1000);
+    EXPECT_TRUE(csv->getWriteBehind());
+    ASSERT_NO_THROW(csv->recreate());
+
+    CSVRow row0(2);
+    row0.writeAt(0, "dog");
+    row0.writeAt(1, "grey");
+    ASSERT_NO_THROW(csv->append(row0));
+
+    // The row is written by the flush, before the interval elapses.
+    ASSERT_NO_THROW(csv->flush());
+    EXPECT_EQ("animal,color\n"
+              "dog,grey\n",
+              readFile());
+
+    // The pending rows are written when the file is closed.
+    CSVRow row1(2);
+    row1.writeAt(0, "cat");
+    row1.writeAt(1, "black");
+    ASSERT_NO_THROW(csv->append(row1));
+    csv->close();
+    EXPECT_EQ("animal,color\n"
+              "dog,grey\n"
+              "cat,black\n",
+              readFile());
+
+    // Reopen the file and append more rows, synchronizing each batch.
+    csv->setWriteBehind(true, 0, true);
+    ASSERT_NO_THROW(csv->open(true));
+    CSVRow row2(2);
+    row2.writeAt(0, "lion");
+    row2.writeAt(1, "yellow");
+    ASSERT_NO_THROW(csv->append(row2));
+    // The size of the row is checked before queuing it.
+    EXPECT_THROW(csv->append(CSVRow(3)), CSVFileError);
+    csv->close();
+    EXPECT_EQ("animal,color\n"
+              "dog,grey\n"
+              "cat,black\n"
+              "lion,yellow\n",
+              readFile());
+}
+
 // This test checks that the error is reported when the size of the row being
 // read doesn't match the number of columns of the CSV file.
 TEST_F(CSVFileTest, validate) {
@@ -0,0 +1,131 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file encode_benchmark.cc
+///
+/// Micro-benchmark of the base16 and base64 codecs. Each codec runs over
+/// data of the size of a hardware address, a DUID and a larger blob, and
+/// the identifier text form is compared with the stream based formatting
+/// it replaces. Build and run it with "make benchmark", the optional
+/// argument is the number of iterations.
+
+#include <config.h>
+
+#include <util/encode/base64.h>
+#include <util/encode/hex.h>
+
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace isc::util::encode;
+using namespace std;
+
+namespace {
+
+/// @brief Prevents the compiler from optimizing the results away.
+size_t sink = 0;
+
+/// @brief Runs a function repeatedly and reports the time per call.
+///
+/// @param name name of the measured operation.
+/// @param size size of the data in bytes.
+/// @param iterations number of calls.
+/// @param func the measured function.
+void
+measure(const string& name, size_t size, size_t iterations,
+        const function<void()>& func) {
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        func();
+    }
+    auto elapsed = chrono::steady_clock::now() - start;
+    double ns = chrono::duration<double, nano>(elapsed).count() / iterations;
+    cout << setw(28) << left << name << setw(6) << right << size << " bytes "
+         << setw(10) << fixed << setprecision(1) << ns << " ns/op "
+         << setw(10) << (ns > 0 ? size * 1000.0 / ns : 0.0) << " MB/s"
+         << endl;
+}
+
+/// @brief The stream based identifier formatting used before.
+///
+/// @param data the identifier.
+/// @return colon separated lower case hexadecimal text.
+string
+streamToText(const vector<uint8_t>& data) {
+    stringstream tmp;
+    tmp << hex;
+    bool delim = false;
+    for (auto const byte : data) {
+        if (delim) {
+            tmp << ":";
+        }
+        tmp << setw(2) << setfill('0') << static_cast<unsigned int>(byte);
+        delim = true;
+    }
+    return (tmp.str());
+}
+
+}
+
+int
+main(int argc, char* argv[]) {
+    size_t iterations = 1000000;
+    if (argc > 1) {
+        try {
+            iterations = boost::lexical_cast<size_t>(argv[1]);
+        } catch (const boost::bad_lexical_cast&) {
+            cerr << "usage: " << argv[0] << " [iterations]" << endl;
+            return (EXIT_FAILURE);
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    for (size_t size : { 6, 18, 256 }) {
+        vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+        const string hex_text = encodeHex(data);
+        const string base64_text = encodeBase64(data);
+        vector<uint8_t> result;
+        result.reserve(size);
+        string text;
+        text.reserve(3 * size);
+
+        measure("encodeHex", size, iterations, [&]() {
+            sink += encodeHex(data).size();
+        });
+        measure("decodeHex", size, iterations, [&]() {
+            decodeHex(hex_text, result);
+            sink += result.size();
+        });
+        measure("encodeBase64", size, iterations, [&]() {
+            sink += encodeBase64(data).size();
+        });
+        measure("decodeBase64", size, iterations, [&]() {
+            decodeBase64(base64_text, result);
+            sink += result.size();
+        });
+        measure("identifier text (stream)", size, iterations, [&]() {
+            sink += streamToText(data).size();
+        });
+        measure("identifier text (append)", size, iterations, [&]() {
+            text.clear();
+            appendHex(data.data(), data.size(), text, ':', false);
+            sink += text.size();
+        });
+    }
+    return (sink > 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
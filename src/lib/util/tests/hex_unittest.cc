@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2023 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -111,4 +111,41 @@ TEST_F(HexTest, encodeMap) {
     }
 }
 
+// Check the raw buffer encoder with and without a separator.
+TEST_F(HexTest, appendHex) {
+    const uint8_t data[] = { 0x01, 0xab, 0x0c, 0xff };
+    string text("prefix ");
+    appendHex(data, sizeof(data), text);
+    EXPECT_EQ("prefix 01AB0CFF", text);
+
+    text.clear();
+    appendHex(data, sizeof(data), text, ':', false);
+    EXPECT_EQ("01:ab:0c:ff", text);
+
+    text.clear();
+    appendHex(data, 1, text, ':', false);
+    EXPECT_EQ("01", text);
+
+    text = "empty";
+    appendHex(data, 0, text, ':');
+    EXPECT_EQ("empty", text);
+}
+
+// Check that the data survives the round trip for all lengths and all
+// byte values, with and without white spaces in the encoded text.
+TEST_F(HexTest, roundTrip) {
+    vector<uint8_t> data;
+    for (size_t len = 0; len < 300; ++len) {
+        data.push_back(static_cast<uint8_t>(len * 7));
+        const string text = encodeHex(data);
+        ASSERT_EQ(2 * data.size(), text.size());
+        decodeHex(text, decoded_data);
+        EXPECT_TRUE(data == decoded_data);
+
+        string spaced = " " + text + "\n";
+        decodeHex(spaced, decoded_data);
+        EXPECT_TRUE(data == decoded_data);
+    }
+}
+
 }
@@ -0,0 +1,150 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <util/memory_pool.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace isc::util;
+using namespace std;
+
+namespace {
+
+/// @brief Object counting its instances.
+struct Counted {
+    /// @brief Constructor.
+    Counted(int value, const string& text) : value_(value), text_(text) {
+        ++instances_;
+    }
+
+    /// @brief Destructor.
+    ~Counted() {
+        --instances_;
+    }
+
+    int value_;
+    string text_;
+    static int instances_;
+};
+
+int Counted::instances_ = 0;
+
+// Test that a released block is reused by the next allocation of the
+// same size class.
+TEST(MemoryPoolTest, reuse) {
+    void* first = MemoryPool::allocate(100);
+    ASSERT_TRUE(first);
+    MemoryPool::deallocate(first, 100);
+    void* second = MemoryPool::allocate(97);
+    EXPECT_EQ(first, second);
+    MemoryPool::deallocate(second, 97);
+
+    // Large blocks are not pooled but still work.
+    void* large = MemoryPool::allocate(MemoryPool::MAX_BLOCK_SIZE + 1);
+    ASSERT_TRUE(large);
+    MemoryPool::deallocate(large, MemoryPool::MAX_BLOCK_SIZE + 1);
+
+    // Null pointers are ignored.
+    EXPECT_NO_THROW(MemoryPool::deallocate(0, 100));
+}
+
+// Test that the objects created by makePooled are constructed, destroyed
+// and their memory recycled.
+TEST(MemoryPoolTest, makePooled) {
+    const void* address = 0;
+    {
+        boost::shared_ptr<Counted> obj = makePooled<Counted>(5, "foo");
+        ASSERT_TRUE(obj);
+        EXPECT_EQ(5, obj->value_);
+        EXPECT_EQ("foo", obj->text_);
+        EXPECT_EQ(1, Counted::instances_);
+        address = obj.get();
+    }
+    EXPECT_EQ(0, Counted::instances_);
+    boost::shared_ptr<Counted> obj = makePooled<Counted>(6, "bar");
+    EXPECT_EQ(address, obj.get());
+}
+
+// Test that the blocks released by a thread are used by other threads.
+TEST(MemoryPoolTest, crossThread) {
+    vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(MemoryPool::allocate(200));
+    }
+    thread releaser([&blocks]() {
+        for (auto const& block : blocks) {
+            MemoryPool::deallocate(block, 200);
+        }
+    });
+    releaser.join();
+    void* block = MemoryPool::allocate(200);
+    bool found = false;
+    for (auto const& released : blocks) {
+        if (released == block) {
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+    MemoryPool::deallocate(block, 200);
+}
+
+// Test that the storage of the buffers is recycled.
+TEST(BufferPoolTest, recycle) {
+    vector<uint8_t> buffer(1000, 1);
+    const uint8_t* data = buffer.data();
+    BufferPool::release(buffer);
+    EXPECT_TRUE(buffer.empty());
+
+    vector<uint8_t> other;
+    BufferPool::acquire(other, 1000);
+    EXPECT_TRUE(other.empty());
+    EXPECT_LE(1000, other.capacity());
+    other.resize(500);
+    EXPECT_EQ(data, other.data());
+
+    OutputBuffer output(0);
+    output.writeUint32(1);
+    const size_t capacity = output.getCapacity();
+    BufferPool::release(output);
+    EXPECT_EQ(0, output.getLength());
+
+    OutputBuffer other_output(0);
+    BufferPool::acquire(other_output);
+    EXPECT_EQ(0, other_output.getLength());
+    EXPECT_EQ(capacity, other_output.getCapacity());
+
+    // Too large buffers are not kept.
+    vector<uint8_t> large(BufferPool::MAX_CAPACITY + 1);
+    BufferPool::release(large);
+    EXPECT_EQ(BufferPool::MAX_CAPACITY + 1, large.size());
+}
+
+#ifdef ENABLE_DEBUG
+// Test the allocation counters.
+TEST(MemoryPoolTest, counters) {
+    void* block = MemoryPool::allocate(300);
+    MemoryPool::deallocate(block, 300);
+    MemoryPool::resetCounters();
+
+    block = MemoryPool::allocate(300);
+    MemoryPoolCounters counters = MemoryPool::getCounters();
+    EXPECT_EQ(1, counters.requests_);
+    EXPECT_EQ(0, counters.heap_allocations_);
+    MemoryPool::deallocate(block, 300);
+
+    block = MemoryPool::allocate(MemoryPool::MAX_BLOCK_SIZE + 1);
+    MemoryPool::deallocate(block, MemoryPool::MAX_BLOCK_SIZE + 1);
+    counters = MemoryPool::getCounters();
+    EXPECT_EQ(2, counters.requests_);
+    EXPECT_EQ(1, counters.heap_allocations_);
+    EXPECT_EQ(1, counters.heap_releases_);
+}
+#endif
+
+} // end of anonymous namespace
@@ -134,6 +134,34 @@ TEST_F(MultiThreadingMgrTest, applyConfig) {
     EXPECT_EQ(thread_pool.size(), 0);
 }
 
+/// @brief Verifies that apply settings works with client affinity.
+TEST_F(MultiThreadingMgrTest, applyClientAffinity) {
+    // get the thread pool
+    auto& thread_pool = MultiThreadingMgr::instance().getThreadPool();
+    // client affinity should be disabled
+    EXPECT_FALSE(MultiThreadingMgr::instance().getClientAffinity());
+    // enable MT with 4 threads, queue size 16 and client affinity
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().apply(true, 4, 16, true));
+    // MT and client affinity should be enabled
+    EXPECT_TRUE(MultiThreadingMgr::instance().getMode());
+    EXPECT_TRUE(MultiThreadingMgr::instance().getClientAffinity());
+    EXPECT_TRUE(thread_pool.getAffinity());
+    // thread pool should be started
+    EXPECT_EQ(thread_pool.size(), 4);
+    // disable client affinity
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().apply(true, 4, 16));
+    EXPECT_FALSE(MultiThreadingMgr::instance().getClientAffinity());
+    EXPECT_EQ(thread_pool.size(), 4);
+    // enable client affinity again then disable MT
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().apply(true, 4, 16, true));
+    EXPECT_NO_THROW(MultiThreadingMgr::instance().apply(false, 4, 16, true));
+    // MT and client affinity should be disabled
+    EXPECT_FALSE(MultiThreadingMgr::instance().getMode());
+    EXPECT_FALSE(MultiThreadingMgr::instance().getClientAffinity());
+    // thread pool should be stopped
+    EXPECT_EQ(thread_pool.size(), 0);
+}
+
 /// @brief Verifies that the critical section flag works.
 TEST_F(MultiThreadingMgrTest, criticalSectionFlag) {
     // get the thread pool
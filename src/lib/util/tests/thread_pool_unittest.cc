@@ -11,6 +11,8 @@
 #include <exceptions/exceptions.h>
 #include <util/thread_pool.h>
 
+#include <algorithm>
+
 #include <signal.h>
 
 using namespace isc;
@@ -22,6 +24,9 @@ namespace {
 /// @brief define CallBack type
 typedef function<void()> CallBack;
 
+/// @brief define work stealing ThreadPool type
+typedef ThreadPool<CallBack, WorkStealingQueue<boost::shared_ptr<CallBack>>> WorkStealingThreadPool;
+
 /// @brief Test Fixture for testing isc::dhcp::ThreadPool
 class ThreadPoolTest : public ::testing::Test {
 public:
@@ -646,6 +651,69 @@ TEST_F(ThreadPoolTest, addFront) {
     EXPECT_EQ(thread_pool.count(), items_count);
 }
 
+/// @brief test ThreadPool affinity mode.
+TEST_F(ThreadPoolTest, affinity) {
+    ThreadPool<CallBack> thread_pool;
+    EXPECT_FALSE(thread_pool.getAffinity());
+    EXPECT_NO_THROW(thread_pool.setAffinity(true));
+    EXPECT_TRUE(thread_pool.getAffinity());
+
+    uint32_t thread_count = 4;
+    uint32_t keys_count = 16;
+    uint32_t items_count = 64;
+
+    // the threads which processed the items of each key
+    std::mutex mutex;
+    map<size_t, set<std::thread::id>> ids;
+    // the items processed for each key, in order
+    map<size_t, list<uint32_t>> history;
+
+    // add items to stopped thread pool: they are redistributed on start
+    for (uint32_t i = 0; i < keys_count; ++i) {
+        bool ret = true;
+        EXPECT_NO_THROW(ret = thread_pool.add(boost::make_shared<CallBack>([]() {})));
+        EXPECT_TRUE(ret);
+    }
+    ASSERT_EQ(thread_pool.count(), keys_count);
+
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    EXPECT_EQ(thread_pool.size(), thread_count);
+    // the affinity mode can't be changed when started
+    EXPECT_THROW(thread_pool.setAffinity(false), InvalidOperation);
+
+    for (uint32_t i = 0; i < items_count; ++i) {
+        size_t key = i % keys_count;
+        auto call_back = [&, key, i]() {
+            lock_guard<std::mutex> lk(mutex);
+            ids[key].insert(this_thread::get_id());
+            history[key].push_back(i);
+        };
+        bool ret = true;
+        EXPECT_NO_THROW(ret = thread_pool.add(boost::make_shared<CallBack>(call_back), key));
+        EXPECT_TRUE(ret);
+    }
+
+    // wait for all items to be processed
+    ASSERT_TRUE(thread_pool.wait(10));
+    EXPECT_EQ(thread_pool.count(), 0);
+    EXPECT_NO_THROW(thread_pool.stop());
+
+    // the items with the same key were processed by the same thread in
+    // the order they were added
+    ASSERT_EQ(ids.size(), keys_count);
+    for (uint32_t key = 0; key < keys_count; ++key) {
+        EXPECT_EQ(ids[key].size(), 1);
+        EXPECT_EQ(history[key].size(), items_count / keys_count);
+        EXPECT_TRUE(is_sorted(history[key].begin(), history[key].end()));
+    }
+
+    // go back to the shared queue
+    EXPECT_NO_THROW(thread_pool.setAffinity(false));
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    EXPECT_NO_THROW(thread_pool.wait());
+    EXPECT_NO_THROW(thread_pool.reset());
+}
+
 /// @brief test ThreadPool get queue statistics.
 TEST_F(ThreadPoolTest, getQueueStat) {
     ThreadPool<CallBack> thread_pool;
@@ -658,4 +726,159 @@ TEST_F(ThreadPoolTest, getQueueStat) {
     EXPECT_NO_THROW(thread_pool.getQueueStat(1000));
 }
 
+/// @brief test work stealing ThreadPool add and count
+TEST_F(ThreadPoolTest, workStealingAddAndCount) {
+    WorkStealingThreadPool thread_pool;
+    // the item count should be 0
+    ASSERT_EQ(thread_pool.count(), 0);
+    // the thread count should be 0
+    ASSERT_EQ(thread_pool.size(), 0);
+
+    uint32_t items_count = 4;
+    CallBack call_back = std::bind(&ThreadPoolTest::run, this);
+
+    // add items to stopped thread pool
+    for (uint32_t i = 0; i < items_count; ++i) {
+        bool ret = true;
+        EXPECT_NO_THROW(ret = thread_pool.add(boost::make_shared<CallBack>(call_back)));
+        EXPECT_TRUE(ret);
+    }
+
+    // the item count should match
+    ASSERT_EQ(thread_pool.count(), items_count);
+
+    // calling reset should clear all threads and should remove all queued items
+    EXPECT_NO_THROW(thread_pool.reset());
+    // the item count should be 0
+    ASSERT_EQ(thread_pool.count(), 0);
+    // the thread count should be 0
+    ASSERT_EQ(thread_pool.size(), 0);
+}
+
+/// @brief test work stealing ThreadPool processing and statistics
+TEST_F(ThreadPoolTest, workStealing) {
+    WorkStealingThreadPool thread_pool;
+    uint32_t thread_count = 4;
+    uint32_t items_count = 64;
+    std::atomic<uint32_t> processed(0);
+    auto call_back = [&processed]() {
+        this_thread::sleep_for(chrono::milliseconds(1));
+        ++processed;
+    };
+
+    // add items to stopped thread pool: they all go to the first queue
+    for (uint32_t i = 0; i < items_count; ++i) {
+        EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    }
+    EXPECT_EQ(thread_pool.getQueueStat(WorkStealingThreadPool::WORKER_DEPTH, 0),
+              items_count);
+    EXPECT_EQ(thread_pool.getQueueStat(WorkStealingThreadPool::STEAL_COUNT), 0);
+
+    // the other threads must steal the items
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    EXPECT_EQ(thread_pool.size(), thread_count);
+    ASSERT_TRUE(thread_pool.wait(10));
+    EXPECT_EQ(processed, items_count);
+    EXPECT_EQ(thread_pool.count(), 0);
+    EXPECT_GT(thread_pool.getQueueStat(WorkStealingThreadPool::STEAL_COUNT), 0);
+    EXPECT_NO_THROW(thread_pool.stop());
+
+    // items are spread over the queues of the threads
+    for (uint32_t i = 0; i < thread_count * 2; ++i) {
+        EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    }
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        EXPECT_EQ(thread_pool.getQueueStat(WorkStealingThreadPool::WORKER_DEPTH, i), 2);
+    }
+
+    // queued items are processed on restart
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    EXPECT_NO_THROW(thread_pool.wait());
+    EXPECT_EQ(processed, items_count + thread_count * 2);
+    EXPECT_NO_THROW(thread_pool.reset());
+}
+
+/// @brief test work stealing ThreadPool with more items than the rings hold
+TEST_F(ThreadPoolTest, workStealingOverflow) {
+    WorkStealingThreadPool thread_pool;
+    uint32_t thread_count = 2;
+    uint32_t items_count = 3 * thread_count *
+        WorkStealingQueue<boost::shared_ptr<CallBack>>::RING_CAPACITY;
+    std::atomic<uint32_t> processed(0);
+    auto call_back = [&processed]() {
+        ++processed;
+    };
+
+    // the queue size is unlimited so no item is dropped
+    uint32_t dropped = 0;
+    for (uint32_t i = 0; i < items_count; ++i) {
+        if (!thread_pool.add(boost::make_shared<CallBack>(call_back))) {
+            ++dropped;
+        }
+    }
+    EXPECT_EQ(dropped, 0);
+    EXPECT_TRUE(thread_pool.addFront(boost::make_shared<CallBack>(call_back)));
+    EXPECT_EQ(thread_pool.count(), items_count + 1);
+
+    // all the items are processed
+    EXPECT_NO_THROW(thread_pool.start(thread_count));
+    ASSERT_TRUE(thread_pool.wait(10));
+    EXPECT_EQ(processed, items_count + 1);
+    EXPECT_EQ(thread_pool.count(), 0);
+
+    // and also when they are added to the running thread pool
+    for (uint32_t i = 0; i < items_count; ++i) {
+        if (!thread_pool.add(boost::make_shared<CallBack>(call_back))) {
+            ++dropped;
+        }
+    }
+    EXPECT_EQ(dropped, 0);
+    ASSERT_TRUE(thread_pool.wait(10));
+    EXPECT_EQ(processed, 2 * items_count + 1);
+    EXPECT_NO_THROW(thread_pool.reset());
+}
+
+/// @brief test work stealing ThreadPool max queue size
+TEST_F(ThreadPoolTest, workStealingMaxQueueSize) {
+    WorkStealingThreadPool thread_pool;
+    uint32_t items_count = 20;
+    CallBack call_back = std::bind(&ThreadPoolTest::run, this);
+
+    // add items to stopped thread pool
+    bool ret = true;
+    for (uint32_t i = 0; i < items_count; ++i) {
+        EXPECT_NO_THROW(ret = thread_pool.add(boost::make_shared<CallBack>(call_back)));
+        EXPECT_TRUE(ret);
+    }
+
+    // change the max count
+    ASSERT_EQ(thread_pool.getMaxQueueSize(), 0);
+    size_t max_queue_size = 10;
+    thread_pool.setMaxQueueSize(max_queue_size);
+    EXPECT_EQ(thread_pool.getMaxQueueSize(), max_queue_size);
+
+    // adding an item should squeeze the queue
+    EXPECT_EQ(thread_pool.count(), items_count);
+    EXPECT_NO_THROW(ret = thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_FALSE(ret);
+    EXPECT_EQ(thread_pool.count(), max_queue_size);
+
+    // adding an item at front should change nothing
+    EXPECT_NO_THROW(ret = thread_pool.addFront(boost::make_shared<CallBack>(call_back)));
+    EXPECT_FALSE(ret);
+    EXPECT_EQ(thread_pool.count(), max_queue_size);
+}
+
+/// @brief test ThreadPool statistics of a shared queue.
+TEST_F(ThreadPoolTest, getQueueStatShared) {
+    ThreadPool<CallBack> thread_pool;
+    CallBack call_back = std::bind(&ThreadPoolTest::run, this);
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_TRUE(thread_pool.add(boost::make_shared<CallBack>(call_back)));
+    EXPECT_EQ(thread_pool.getQueueStat(ThreadPool<CallBack>::STEAL_COUNT), 0);
+    // the depth of the shared queue is returned for any thread
+    EXPECT_EQ(thread_pool.getQueueStat(ThreadPool<CallBack>::WORKER_DEPTH, 0), 2);
+    EXPECT_EQ(thread_pool.getQueueStat(ThreadPool<CallBack>::WORKER_DEPTH, 3), 2);
+}
+
 }  // namespace
@@ -8,6 +8,7 @@
 #define THREAD_POOL_H
 
 #include <exceptions/exceptions.h>
+#include <util/work_stealing_queue.h>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -19,6 +20,7 @@
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include <signal.h>
 
@@ -28,6 +30,10 @@ namespace util {
 /// @brief Defines a thread pool which uses a thread pool queue for managing
 /// work items. Each work item is a 'functor' object.
 ///
+/// The work items are kept in a single queue shared by all threads, unless
+/// the container is a @ref WorkStealingQueue which gives each thread its
+/// own lock-free queue.
+///
 /// @tparam WorkItem a functor
 /// @tparam Container a 'queue like' container
 template <typename WorkItem, typename Container = std::deque<boost::shared_ptr<WorkItem>>>
@@ -44,8 +50,17 @@ struct ThreadPool {
     /// @brief Type of shared pointers to work items.
     typedef typename boost::shared_ptr<WorkItem> WorkItemPtr;
 
+    /// @brief Queue statistics other than the queue length.
+    enum QueueStat {
+        /// @brief Number of work items taken by a thread from the queue of
+        /// another thread.
+        STEAL_COUNT,
+        /// @brief Number of work items in the queue of a thread.
+        WORKER_DEPTH
+    };
+
     /// @brief Constructor
-    ThreadPool() {
+    ThreadPool() : affinity_(false), max_queue_size_(0), next_(0) {
     }
 
     /// @brief Destructor
@@ -60,6 +75,9 @@ struct ThreadPool {
     void reset() {
         stopInternal();
         queue_.clear();
+        for (auto const& queue : affinity_queues_) {
+            queue->clear();
+        }
     }
 
     /// @brief start all the threads
@@ -89,12 +107,61 @@ struct ThreadPool {
         stopInternal();
     }
 
+    /// @brief enable or disable the affinity mode
+    ///
+    /// In affinity mode each thread has its own queue: work items added
+    /// with the same key are always processed by the same thread, in the
+    /// order they were added. Work items added without a key are spread
+    /// over the threads in a round robin fashion.
+    ///
+    /// The work items pending when the thread pool is started in a mode
+    /// or with a thread count different from the previous ones are
+    /// redistributed over the queues.
+    ///
+    /// @param affinity the affinity mode flag
+    ///
+    /// @throw InvalidOperation if thread pool already started
+    void setAffinity(bool affinity) {
+        if (queue_.enabled()) {
+            isc_throw(InvalidOperation, "thread pool already started");
+        }
+        affinity_ = affinity;
+    }
+
+    /// @brief get the affinity mode
+    ///
+    /// @return true if the affinity mode is enabled, false otherwise
+    bool getAffinity() const {
+        return (affinity_);
+    }
+
     /// @brief add a work item to the thread pool
     ///
     /// @param item the 'functor' object to be added to the queue
     /// @return false if the queue was full and oldest item(s) was dropped,
     /// true otherwise.
     bool add(const WorkItemPtr& item) {
+        if (affinity_ && !affinity_queues_.empty()) {
+            return (affinity_queues_[next_++ % affinity_queues_.size()]->pushBack(item));
+        }
+        return (queue_.pushBack(item));
+    }
+
+    /// @brief add a work item to the thread pool with affinity for a key
+    ///
+    /// In affinity mode the work item is added to the queue of the thread
+    /// selected by the key, e.g. a hash of the client identifier, so the
+    /// work items with the same key are processed in sequence by the same
+    /// thread. Otherwise the key is ignored.
+    ///
+    /// @param item the 'functor' object to be added to the queue
+    /// @param key the key selecting the thread
+    /// @return false if the queue was full and oldest item(s) was dropped,
+    /// true otherwise.
+    bool add(const WorkItemPtr& item, size_t key) {
+        if (affinity_ && !affinity_queues_.empty()) {
+            return (affinity_queues_[key % affinity_queues_.size()]->pushBack(item));
+        }
         return (queue_.pushBack(item));
     }
 
@@ -103,6 +170,9 @@ struct ThreadPool {
     /// @param item the 'functor' object to be added to the queue
     /// @return false if the queue was full, true otherwise.
     bool addFront(const WorkItemPtr& item) {
+        if (affinity_ && !affinity_queues_.empty()) {
+            return (affinity_queues_[next_++ % affinity_queues_.size()]->pushFront(item));
+        }
         return (queue_.pushFront(item));
     }
 
@@ -110,7 +180,11 @@ struct ThreadPool {
     ///
     /// @return the number of work items in the queue
     size_t count() {
-        return (queue_.count());
+        size_t count = queue_.count();
+        for (auto const& queue : affinity_queues_) {
+            count += queue->count();
+        }
+        return (count);
     }
 
     /// @brief wait for current items to be processed
@@ -123,6 +197,9 @@ struct ThreadPool {
             isc_throw(MultiThreadingInvalidOperation, "thread pool wait called by worker thread");
         }
         queue_.wait();
+        for (auto const& queue : affinity_queues_) {
+            queue->wait();
+        }
     }
 
     /// @brief wait for items to be processed or return after timeout
@@ -137,14 +214,29 @@ struct ThreadPool {
         if (checkThreadId(id)) {
             isc_throw(MultiThreadingInvalidOperation, "thread pool wait with timeout called by worker thread");
         }
-        return (queue_.wait(seconds));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+        if (!queue_.waitUntil(deadline)) {
+            return (false);
+        }
+        for (auto const& queue : affinity_queues_) {
+            if (!queue->waitUntil(deadline)) {
+                return (false);
+            }
+        }
+        return (true);
     }
 
     /// @brief set maximum number of work items in the queue
     ///
+    /// In affinity mode the maximum applies to the queue of each thread.
+    ///
     /// @param max_queue_size the maximum size (0 means unlimited)
     void setMaxQueueSize(size_t max_queue_size) {
+        max_queue_size_ = max_queue_size;
         queue_.setMaxQueueSize(max_queue_size);
+        for (auto const& queue : affinity_queues_) {
+            queue->setMaxQueueSize(max_queue_size);
+        }
     }
 
     /// @brief get maximum number of work items in the queue
@@ -167,7 +259,40 @@ struct ThreadPool {
     /// @return the queue length statistic
     /// @throw InvalidParameter if which is not 10 and 100 and 1000.
     double getQueueStat(size_t which) {
-        return (queue_.getQueueStat(which));
+        double stat = queue_.getQueueStat(which);
+        for (auto const& queue : affinity_queues_) {
+            stat += queue->getQueueStat(which);
+        }
+        return (stat);
+    }
+
+    /// @brief get queue statistic
+    ///
+    /// The steal count is always 0 unless the container is a
+    /// @ref WorkStealingQueue. When the threads share the queue its depth
+    /// is returned for any thread.
+    ///
+    /// @param which select the statistic
+    /// @param worker the index of the thread for per thread statistics
+    /// @return the queue statistic
+    /// @throw InvalidParameter if which is not a supported statistic.
+    double getQueueStat(QueueStat which, size_t worker = 0) {
+        switch (which) {
+        case STEAL_COUNT: {
+            uint64_t steals = queue_.getStealCount();
+            for (auto const& queue : affinity_queues_) {
+                steals += queue->getStealCount();
+            }
+            return (static_cast<double>(steals));
+        }
+        case WORKER_DEPTH:
+            if (!affinity_queues_.empty()) {
+                return (static_cast<double>(affinity_queues_[worker % affinity_queues_.size()]->count()));
+            }
+            return (static_cast<double>(queue_.getDepth(worker)));
+        default:
+            isc_throw(InvalidParameter, "unsupported queue statistic " << which);
+        }
     }
 
 private:
@@ -185,10 +310,12 @@ private:
         sigaddset(&sset, SIGHUP);
         sigaddset(&sset, SIGTERM);
         pthread_sigmask(SIG_BLOCK, &sset, &osset);
-        queue_.enable(thread_count);
+        prepareQueues(thread_count);
         try {
             for (uint32_t i = 0; i < thread_count; ++i) {
-                threads_.push_back(boost::make_shared<std::thread>(&ThreadPool::run, this));
+                auto queue = affinity_ ? affinity_queues_[i].get() : &queue_;
+                size_t worker = affinity_ ? 0 : i;
+                threads_.push_back(boost::make_shared<std::thread>(&ThreadPool::run, this, queue, worker));
             }
         } catch (...) {
             // Restore signal mask.
@@ -206,6 +333,9 @@ private:
             isc_throw(MultiThreadingInvalidOperation, "thread pool stop called by worker thread");
         }
         queue_.disable();
+        for (auto const& queue : affinity_queues_) {
+            queue->disable();
+        }
         for (auto thread : threads_) {
             thread->join();
         }
@@ -334,8 +464,10 @@ private:
         /// available.
         /// Before a work item is returned statistics are updated.
         ///
+        /// @param worker the index of the calling thread (unused as the
+        /// threads share the queue)
         /// @return the first work item from the queue or an empty element.
-        Item pop() {
+        Item pop(size_t /* worker */) {
             std::unique_lock<std::mutex> lock(mutex_);
             --working_;
             // Wait for push or disable functions.
@@ -391,6 +523,18 @@ private:
             return (ret);
         }
 
+        /// @brief wait for items to be processed or return at deadline
+        ///
+        /// @param deadline the time at which to stop waiting
+        /// @return true if all tasks finished, false on timeout
+        bool waitUntil(std::chrono::steady_clock::time_point deadline) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // Wait for any item or for working threads to finish.
+            bool ret = wait_cv_.wait_until(lock, deadline,
+                                           [&]() {return (working_ == 0 && queue_.empty());});
+            return (ret);
+        }
+
         /// @brief get queue length statistic
         ///
         /// @param which select the statistic (10, 100 or 1000)
@@ -411,6 +555,32 @@ private:
             }
         }
 
+        /// @brief get the number of work items stolen from other threads
+        ///
+        /// @return always 0 as the threads share the queue
+        uint64_t getStealCount() {
+            return (0);
+        }
+
+        /// @brief get the number of work items in the queue of a thread
+        ///
+        /// @return the number of work items in the shared queue
+        size_t getDepth(size_t /* worker */) {
+            return (count());
+        }
+
+        /// @brief take all work items
+        ///
+        /// Removes all queued work items and returns them
+        ///
+        /// @return the work items
+        QueueContainer take() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            QueueContainer items;
+            std::swap(items, queue_);
+            return (items);
+        }
+
         /// @brief clear remove all work items
         ///
         /// Removes all queued work items
@@ -488,10 +658,66 @@ private:
         double stat1000;
     };
 
+    /// @brief Defines a work stealing thread pool queue.
+    ///
+    /// @tparam Item a 'smart pointer' to a functor
+    /// @tparam T the type of the work items in the container type
+    template <typename Item, typename T>
+    struct ThreadPoolQueue<Item, WorkStealingQueue<T>> : public WorkStealingQueue<Item> {
+    };
+
+    /// @brief enable the queues for the threads to be started
+    ///
+    /// In affinity mode creates one queue per thread, when needed moving
+    /// the pending work items to them. Otherwise moves the work items
+    /// pending in per thread queues back to the shared queue.
+    ///
+    /// @param thread_count the number of threads to be started
+    void prepareQueues(uint32_t thread_count) {
+        if (affinity_) {
+            std::vector<WorkItemPtr> pending;
+            for (auto const& item : queue_.take()) {
+                pending.push_back(item);
+            }
+            if (affinity_queues_.size() != thread_count) {
+                for (auto const& queue : affinity_queues_) {
+                    for (auto const& item : queue->take()) {
+                        pending.push_back(item);
+                    }
+                }
+                affinity_queues_.clear();
+                for (uint32_t i = 0; i < thread_count; ++i) {
+                    auto queue = boost::make_shared<ThreadPoolQueue<WorkItemPtr, Container>>();
+                    queue->setMaxQueueSize(max_queue_size_);
+                    affinity_queues_.push_back(queue);
+                }
+            }
+            for (auto const& item : pending) {
+                affinity_queues_[next_++ % thread_count]->pushBack(item);
+            }
+            // The shared queue only holds the state of the thread pool.
+            queue_.enable(0);
+            for (auto const& queue : affinity_queues_) {
+                queue->enable(1);
+            }
+        } else {
+            for (auto const& queue : affinity_queues_) {
+                for (auto const& item : queue->take()) {
+                    queue_.pushBack(item);
+                }
+            }
+            affinity_queues_.clear();
+            queue_.enable(thread_count);
+        }
+    }
+
     /// @brief run function of each thread
-    void run() {
-        while (queue_.enabled()) {
-            WorkItemPtr item = queue_.pop();
+    ///
+    /// @param queue the queue the thread gets work items from
+    /// @param worker the index of the thread in the queue
+    void run(ThreadPoolQueue<WorkItemPtr, Container>* queue, size_t worker) {
+        while (queue->enabled()) {
+            WorkItemPtr item = queue->pop(worker);
             if (item) {
                 try {
                     (*item)();
@@ -506,7 +732,21 @@ private:
     std::vector<boost::shared_ptr<std::thread>> threads_;
 
     /// @brief underlying work items queue
+    ///
+    /// In affinity mode it holds only the state of the thread pool.
     ThreadPoolQueue<WorkItemPtr, Container> queue_;
+
+    /// @brief work items queues of each thread in affinity mode
+    std::vector<boost::shared_ptr<ThreadPoolQueue<WorkItemPtr, Container>>> affinity_queues_;
+
+    /// @brief the affinity mode flag
+    bool affinity_;
+
+    /// @brief maximum number of work items in each queue
+    size_t max_queue_size_;
+
+    /// @brief index of the next queue for work items added without key
+    std::atomic<size_t> next_;
 };
 
 /// Initialize the 10 packet rounding to exp(-.1)
@@ -0,0 +1,632 @@
+// Copyright (C) 2023 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef WORK_STEALING_QUEUE_H
+#define WORK_STEALING_QUEUE_H
+
+#include <exceptions/exceptions.h>
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace isc {
+namespace util {
+
+/// @brief Bounded lock-free multi-producer multi-consumer ring.
+///
+/// This is the classic array based queue where each cell carries a
+/// sequence number telling producers and consumers whether the cell is
+/// free or holds an item for the current lap.
+///
+/// @tparam Item the type of the items
+template <typename Item>
+class WorkStealingRing : public boost::noncopyable {
+public:
+    /// @brief Constructor
+    ///
+    /// @param capacity the capacity of the ring, rounded up to a power of 2
+    explicit WorkStealingRing(size_t capacity)
+        : mask_(0), cells_(), enqueue_pos_(0), dequeue_pos_(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief push an item at the back of the ring
+    ///
+    /// @param item the item
+    /// @return false if the ring is full, true otherwise
+    bool push(const Item& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence_.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return (false);
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item_ = item;
+        cell->sequence_.store(pos + 1, std::memory_order_release);
+        return (true);
+    }
+
+    /// @brief pop the item at the front of the ring
+    ///
+    /// @param item the popped item
+    /// @return false if the ring is empty, true otherwise
+    bool pop(Item& item) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence_.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return (false);
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        item = cell->item_;
+        cell->item_ = Item();
+        cell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+        return (true);
+    }
+
+    /// @brief number of items in the ring
+    ///
+    /// @return the number of items (approximate when the ring is used
+    /// concurrently)
+    size_t size() const {
+        size_t enqueue = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t dequeue = dequeue_pos_.load(std::memory_order_relaxed);
+        return (enqueue > dequeue ? enqueue - dequeue : 0);
+    }
+
+private:
+    /// @brief a cell of the ring
+    struct Cell {
+        /// @brief the sequence number of the cell
+        std::atomic<size_t> sequence_;
+
+        /// @brief the item
+        Item item_;
+    };
+
+    /// @brief the mask to get the cell index from a position
+    size_t mask_;
+
+    /// @brief the cells
+    std::unique_ptr<Cell[]> cells_;
+
+    /// @brief the position of the next push
+    std::atomic<size_t> enqueue_pos_;
+
+    /// @brief the position of the next pop
+    std::atomic<size_t> dequeue_pos_;
+};
+
+/// @brief Defines a work stealing thread pool queue.
+///
+/// Selected by using it as the container of a @ref ThreadPool, e.g.
+/// @code
+/// ThreadPool<CallBack, WorkStealingQueue<boost::shared_ptr<CallBack>>>
+/// @endcode
+///
+/// Each worker thread has its own bounded lock-free ring. Work items are
+/// spread over the rings in a round robin fashion, a worker pops from its
+/// own ring and, when it is empty, steals from the rings of the other
+/// workers. Workers which find no work spin for a while before sleeping,
+/// and producers only take the lock to wake them up when some of them
+/// sleep, so under load adding and popping work items take no lock.
+///
+/// Work items which do not fit in a full ring, and work items pushed at
+/// front, go to a shared overflow queue protected by a mutex. Workers pop
+/// from the overflow queue first when it is not empty, so the number of
+/// work items is only bounded by the maximum queue size and no item is
+/// dropped when it is 0 (unlimited).
+///
+/// It provides the same interface and the same 'enabled' and 'disabled'
+/// states as the default thread pool queue, but work items are processed
+/// in order only per ring.
+///
+/// @tparam Item a 'smart pointer' to a functor
+template <typename Item>
+class WorkStealingQueue : public boost::noncopyable {
+public:
+    /// @brief Maximum number of rings.
+    ///
+    /// Workers beyond this number share the rings.
+    static const size_t MAX_RINGS = 64;
+
+    /// @brief Capacity of each ring.
+    static const size_t RING_CAPACITY = 4096;
+
+    /// @brief Number of unsuccessful tries before a worker sleeps.
+    static const size_t SPIN_COUNT = 64;
+
+    /// @brief Constructor
+    ///
+    /// Creates the queue in 'disabled' state
+    WorkStealingQueue()
+        : rings_(), created_(0), ring_count_(1), next_(0), size_(0),
+          overflow_(), overflow_size_(0), enabled_(false), max_queue_size_(0), working_(0), sleepers_(0),
+          steals_(0), stat10(0.), stat100(0.), stat1000(0.) {
+        createRings(1);
+    }
+
+    /// @brief Destructor
+    ~WorkStealingQueue() {
+        disable();
+        clear();
+    }
+
+    /// @brief set maximum number of work items in the queue
+    ///
+    /// @param max_queue_size the maximum size (0 means unlimited)
+    void setMaxQueueSize(size_t max_queue_size) {
+        max_queue_size_ = max_queue_size;
+    }
+
+    /// @brief get maximum number of work items in the queue
+    ///
+    /// @return the maximum size (0 means unlimited)
+    size_t getMaxQueueSize() {
+        return (max_queue_size_);
+    }
+
+    /// @brief push work item to the queue
+    ///
+    /// When the queue is full oldest items are removed and false is
+    /// returned. When the ring is full the item goes to the overflow
+    /// queue.
+    ///
+    /// @param item the new item to be added to the queue
+    /// @return false if the queue was full and oldest item(s) dropped,
+    /// true otherwise
+    bool pushBack(const Item& item) {
+        bool ret = true;
+        if (!item) {
+            return (ret);
+        }
+        size_t index = next_++ % ring_count_.load();
+        WorkStealingRing<Item>& ring = *rings_[index];
+        size_t max_queue_size = max_queue_size_;
+        if (max_queue_size != 0) {
+            while (size_.load() >= max_queue_size) {
+                if (!dropOne(index)) {
+                    break;
+                }
+                ret = false;
+            }
+        }
+        // The size is incremented first so it is never lower than the
+        // number of items in the rings.
+        ++size_;
+        if (!ring.push(item)) {
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            overflow_.push_back(item);
+            ++overflow_size_;
+        }
+        wakeUp();
+        return (ret);
+    }
+
+    /// @brief push work item to the queue at front.
+    ///
+    /// The rings have no front: the item is pushed at the front of the
+    /// overflow queue.
+    /// When the queue is full the item is not added.
+    ///
+    /// @param item the new item to be added to the queue
+    /// @return false if the queue was full, true otherwise
+    bool pushFront(const Item& item) {
+        if (!item) {
+            return (true);
+        }
+        size_t max_queue_size = max_queue_size_;
+        if ((max_queue_size != 0) && (size_.load() >= max_queue_size)) {
+            return (false);
+        }
+        ++size_;
+        {
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            overflow_.push_front(item);
+            ++overflow_size_;
+        }
+        wakeUp();
+        return (true);
+    }
+
+    /// @brief pop work item from the queue or block waiting
+    ///
+    /// If the queue is 'disabled', this function returns immediately an
+    /// empty element. If the queue is 'enabled', this function returns a
+    /// work item from the ring of the worker or stolen from another ring,
+    /// or blocks the calling thread if there are no work items available.
+    ///
+    /// @param worker the index of the calling worker thread
+    /// @return a work item from the queue or an empty element.
+    Item pop(size_t worker) {
+        size_t spins = 0;
+        for (;;) {
+            if (!enabled_) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                leaveWork();
+                return (Item());
+            }
+            Item item;
+            if (tryPop(worker, item)) {
+                return (item);
+            }
+            if (++spins < SPIN_COUNT) {
+                std::this_thread::yield();
+                continue;
+            }
+            spins = 0;
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++sleepers_;
+            leaveWork();
+            cv_.wait(lock, [&]() {return (!enabled_ || (size_.load() != 0));});
+            --sleepers_;
+            if (!enabled_) {
+                return (Item());
+            }
+            ++working_;
+        }
+    }
+
+    /// @brief count number of work items in the queue
+    ///
+    /// @return the number of work items
+    size_t count() {
+        return (size_.load());
+    }
+
+    /// @brief wait for current items to be processed
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait_cv_.wait(lock, [&]() {return (idle());});
+    }
+
+    /// @brief wait for items to be processed or return after timeout
+    ///
+    /// @param seconds the time in seconds to wait for tasks to finish
+    /// @return true if all tasks finished, false on timeout
+    bool wait(uint32_t seconds) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return (wait_cv_.wait_for(lock, std::chrono::seconds(seconds),
+                                  [&]() {return (idle());}));
+    }
+
+    /// @brief wait for items to be processed or return at deadline
+    ///
+    /// @param deadline the time at which to stop waiting
+    /// @return true if all tasks finished, false on timeout
+    bool waitUntil(std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return (wait_cv_.wait_until(lock, deadline, [&]() {return (idle());}));
+    }
+
+    /// @brief get queue length statistic
+    ///
+    /// @param which select the statistic (10, 100 or 1000)
+    /// @return the queue length statistic
+    /// @throw InvalidParameter if which is not 10 and 100 and 1000.
+    double getQueueStat(size_t which) {
+        switch (which) {
+        case 10:
+            return (stat10.load(std::memory_order_relaxed));
+        case 100:
+            return (stat100.load(std::memory_order_relaxed));
+        case 1000:
+            return (stat1000.load(std::memory_order_relaxed));
+        default:
+            isc_throw(InvalidParameter, "supported statistic for "
+                      << "10/100/1000 only, not " << which);
+        }
+    }
+
+    /// @brief get the number of work items stolen from other workers
+    ///
+    /// @return the steal count
+    uint64_t getStealCount() {
+        return (steals_.load(std::memory_order_relaxed));
+    }
+
+    /// @brief get the number of work items in the ring of a worker
+    ///
+    /// Work items in the overflow queue are not accounted.
+    ///
+    /// @param worker the index of the worker thread
+    /// @return the number of work items
+    size_t getDepth(size_t worker) {
+        return (rings_[worker % ring_count_.load()]->size());
+    }
+
+    /// @brief take all work items
+    ///
+    /// @return the work items
+    std::deque<Item> take() {
+        std::deque<Item> items;
+        Item item;
+        while (popOverflow(item)) {
+            --size_;
+            items.push_back(item);
+        }
+        for (size_t i = 0; i < created_.load(); ++i) {
+            while (rings_[i]->pop(item)) {
+                --size_;
+                items.push_back(item);
+            }
+        }
+        return (items);
+    }
+
+    /// @brief clear remove all work items
+    void clear() {
+        take();
+        std::lock_guard<std::mutex> lock(mutex_);
+        working_ = 0;
+        wait_cv_.notify_all();
+    }
+
+    /// @brief enable the queue
+    ///
+    /// Sets the queue state to 'enabled' with one ring per worker thread.
+    ///
+    /// @param thread_count number of working threads
+    void enable(uint32_t thread_count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t ring_count = std::max(std::min(static_cast<size_t>(thread_count),
+                                              MAX_RINGS),
+                                     static_cast<size_t>(1));
+        createRings(ring_count);
+        ring_count_ = ring_count;
+        enabled_ = true;
+        working_ = thread_count;
+    }
+
+    /// @brief disable the queue
+    void disable() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            enabled_ = false;
+        }
+        cv_.notify_all();
+    }
+
+    /// @brief return the state of the queue
+    ///
+    /// @return the state
+    bool enabled() {
+        return (enabled_);
+    }
+
+private:
+    /// @brief create rings
+    ///
+    /// Rings are never destroyed before the queue so producers may use
+    /// them without lock.
+    ///
+    /// @param count the number of rings needed
+    void createRings(size_t count) {
+        for (size_t i = created_.load(); i < count; ++i) {
+            rings_[i].reset(new WorkStealingRing<Item>(RING_CAPACITY));
+            ++created_;
+        }
+    }
+
+    /// @brief drop the oldest item of a ring, or of the next non empty one,
+    /// or of the overflow queue
+    ///
+    /// @param index the index of the ring
+    /// @return true if an item was dropped, false otherwise
+    bool dropOne(size_t index) {
+        Item dropped;
+        size_t count = created_.load();
+        for (size_t i = 0; i < count; ++i) {
+            if (rings_[(index + i) % count]->pop(dropped)) {
+                --size_;
+                return (true);
+            }
+        }
+        if (popOverflow(dropped)) {
+            --size_;
+            return (true);
+        }
+        return (false);
+    }
+
+    /// @brief pop the item at the front of the overflow queue
+    ///
+    /// The lock is taken only when the overflow queue is not empty.
+    ///
+    /// @param item the popped item
+    /// @return false if the overflow queue is empty, true otherwise
+    bool popOverflow(Item& item) {
+        if (overflow_size_.load() == 0) {
+            return (false);
+        }
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        if (overflow_.empty()) {
+            return (false);
+        }
+        item = overflow_.front();
+        overflow_.pop_front();
+        --overflow_size_;
+        return (true);
+    }
+
+    /// @brief wake up a worker if needed
+    ///
+    /// Workers check the size after registering as sleepers so either a
+    /// sleeping worker is woken up or it sees the pushed item.
+    void wakeUp() {
+        // Taking the lock is needed only when workers sleep.
+        if (sleepers_.load() != 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    /// @brief try to pop a work item from the ring of the worker or from
+    /// the other rings
+    ///
+    /// @param worker the index of the worker thread
+    /// @param item the popped item
+    /// @return true if an item was popped, false otherwise
+    bool tryPop(size_t worker, Item& item) {
+        if (popOverflow(item)) {
+            size_t length = size_.fetch_sub(1);
+            updateStats(length);
+            return (true);
+        }
+        size_t count = created_.load();
+        size_t own = worker % ring_count_.load();
+        for (size_t i = 0; i < count; ++i) {
+            if (rings_[(own + i) % count]->pop(item)) {
+                if (i != 0) {
+                    steals_.fetch_add(1, std::memory_order_relaxed);
+                }
+                size_t length = size_.fetch_sub(1);
+                updateStats(length);
+                return (true);
+            }
+        }
+        return (false);
+    }
+
+    /// @brief update the queue length statistics
+    ///
+    /// Concurrent updates may be lost which is fine for statistics.
+    ///
+    /// @param length the queue length
+    void updateStats(size_t length) {
+        static const double CEXP10 = std::exp(-.1);
+        static const double CEXP100 = std::exp(-.01);
+        static const double CEXP1000 = std::exp(-.001);
+        stat10.store(stat10.load(std::memory_order_relaxed) * CEXP10 +
+                     (1 - CEXP10) * length, std::memory_order_relaxed);
+        stat100.store(stat100.load(std::memory_order_relaxed) * CEXP100 +
+                      (1 - CEXP100) * length, std::memory_order_relaxed);
+        stat1000.store(stat1000.load(std::memory_order_relaxed) * CEXP1000 +
+                       (1 - CEXP1000) * length, std::memory_order_relaxed);
+    }
+
+    /// @brief account a worker which stops working
+    ///
+    /// Must be called with the mutex locked.
+    void leaveWork() {
+        if (working_ != 0) {
+            --working_;
+        }
+        if (idle()) {
+            wait_cv_.notify_all();
+        }
+    }
+
+    /// @brief check if all work items have been processed
+    ///
+    /// Must be called with the mutex locked.
+    ///
+    /// @return true if no worker is working and the queue is empty
+    bool idle() {
+        return ((working_ == 0) && (size_.load() == 0));
+    }
+
+    /// @brief the rings
+    std::array<std::unique_ptr<WorkStealingRing<Item>>, MAX_RINGS> rings_;
+
+    /// @brief number of created rings
+    std::atomic<size_t> created_;
+
+    /// @brief number of rings in use
+    std::atomic<size_t> ring_count_;
+
+    /// @brief index of the ring for the next push
+    std::atomic<size_t> next_;
+
+    /// @brief number of work items in the queue
+    std::atomic<size_t> size_;
+
+    /// @brief work items which did not fit in the rings or pushed at front
+    std::deque<Item> overflow_;
+
+    /// @brief number of work items in the overflow queue
+    std::atomic<size_t> overflow_size_;
+
+    /// @brief mutex protecting the overflow queue
+    std::mutex overflow_mutex_;
+
+    /// @brief mutex used for sleeping and waiting
+    std::mutex mutex_;
+
+    /// @brief condition variable used to wake up sleeping workers
+    std::condition_variable cv_;
+
+    /// @brief condition variable used to wait for all items to be processed
+    std::condition_variable wait_cv_;
+
+    /// @brief the state of the queue
+    std::atomic<bool> enabled_;
+
+    /// @brief maximum number of work items in the queue (0 means unlimited)
+    std::atomic<size_t> max_queue_size_;
+
+    /// @brief number of threads currently doing work
+    uint32_t working_;
+
+    /// @brief number of sleeping workers
+    std::atomic<size_t> sleepers_;
+
+    /// @brief number of stolen work items
+    std::atomic<uint64_t> steals_;
+
+    /// @brief queue length statistic for 10 packets
+    std::atomic<double> stat10;
+
+    /// @brief queue length statistic for 100 packets
+    std::atomic<double> stat100;
+
+    /// @brief queue length statistic for 1000 packets
+    std::atomic<double> stat1000;
+};
+
+}  // namespace util
+}  // namespace isc
+
+#endif  // WORK_STEALING_QUEUE_H